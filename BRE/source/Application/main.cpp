@@ -1,7 +1,9 @@
-﻿#include <memory>              
+﻿#include <cstring>
+#include <memory>              
    
 #include <general/Application.h>                                                                                                        
              
+#include "scenes/HierarchyScene.h"
 #include "scenes/Scene.h"                                
             
 #if defined(DEBUG) || defined(_DEBUG)                                                                                                                                                            
@@ -11,14 +13,20 @@
 #endif    
   
 int 
-WINAPI WinMain(HINSTANCE instance, HINSTANCE /*previousInstance*/, LPSTR /*commandLine*/, int showCommand) {        
+WINAPI WinMain(HINSTANCE instance, HINSTANCE /*previousInstance*/, LPSTR commandLine, int showCommand) {        
 	// Memory leak checking in Visual Studio's Output panel.    
 #if defined(DEBUG) | defined(_DEBUG)   
 	_CrtSetDbgFlag(_CRTDBG_ALLOC_MEM_DF | _CRTDBG_LEAK_CHECK_DF);           
 #endif
 
 	BRE::Application app(instance, showCommand);  
-	app.Add(new Scene());  
+	// "-hierarchy" shows the transform hierarchy example
+	if (commandLine && strcmp(commandLine, "-hierarchy") == 0) {
+		app.Add(new HierarchyScene());
+	}
+	else {
+		app.Add(new Scene());
+	}
 	app.Run();
 	return 0;
 }
\ No newline at end of file
@@ -0,0 +1,34 @@
+#include "HierarchyScene.h"
+
+#include <general/Profiler.h>
+#include <general/TransformHierarchy.h>
+#include <managers/DrawManager.h>
+
+using namespace DirectX;
+
+namespace {
+	// Radians per second around the Y axis
+	const float sSpinRate = XM_PI / 8.0f;
+	const char* sSpinningModelName = "bronzeSphere";
+
+	const char* sSceneModelsFile = "content\\configs\\hierarchy\\models.yml";
+}
+
+HierarchyScene::HierarchyScene()
+	: Scene(sSceneModelsFile)
+	, mSpinningNode(BRE::DrawManager::gInstance->FindNode(sSpinningModelName))
+{
+}
+
+void HierarchyScene::Update(const float elapsedTime) {
+	Scene::Update(elapsedTime);
+	if (mSpinningNode == BRE::TransformHierarchy::sNoNode) {
+		return;
+	}
+	BRE_PROFILE_SCOPE("HierarchyScene::Update");
+	BRE::TransformHierarchy& hierarchy = BRE::DrawManager::gInstance->Hierarchy();
+	BRE::TransformHierarchy::LocalTransform local = hierarchy.Local(mSpinningNode);
+	const XMVECTOR spin = XMQuaternionRotationRollPitchYaw(0.0f, sSpinRate * elapsedTime, 0.0f);
+	XMStoreFloat4(&local.mRotation, XMQuaternionNormalize(XMQuaternionMultiply(XMLoadFloat4(&local.mRotation), spin)));
+	hierarchy.SetLocal(mSpinningNode, local);
+}
\ No newline at end of file
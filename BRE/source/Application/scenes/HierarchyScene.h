@@ -0,0 +1,21 @@
+#pragma once
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Example of the transform hierarchy. A sphere spins and a smaller one,
+// its child in models.yml, orbits with it.
+// Run the application with "-hierarchy" to show it.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include "Scene.h"
+
+class HierarchyScene : public Scene {
+public:
+	HierarchyScene();
+	virtual void Update(const float elapsedTime) override;
+
+private:
+	// TransformHierarchy node. Its children orbit with it.
+	size_t mSpinningNode;
+};
\ No newline at end of file
@@ -1,9 +1,12 @@
 #include "Scene.h"
 
 #include <general/Camera.h>
+#include <general/FramePipeline.h>
+#include <general/Profiler.h>
 #include <input/Keyboard.h> 
 #include <managers/DrawManager.h>
 #include <managers/MaterialManager.h>   
+#include <managers/VirtualFileSystem.h>
 #include <rendering/GlobalResources.h> 
 #include <rendering/shaders/lightPasses/DirLightPsData.h>      
 #include <utils/Assert.h>
@@ -14,35 +17,41 @@ using namespace DirectX;
 namespace { 
 	const XMFLOAT2 sLightRotationRate(XM_PI / 4.0f, XM_PI / 4.0f); 
 
-	const unsigned int sMaxShaderPointLights = 512;
-	const unsigned int sNumPointLightShaders = 1; 
-
 	const char* sMaterialsFile = "content\\configs\\materials.yml";   
+	// Written by ContentTools cookMaterials. sMaterialsFile is used when it does not exist.
+	const char* sCookedMaterialsFile = "content\\configs\\cookedMaterials.yml";
 	const char* sSceneModelsFile = "content\\configs\\fullyDeferred\\models.yml";     
+	const char* sScenePointLightsFile = "content\\configs\\fullyDeferred\\lights.yml";
+}
+
+Scene::Scene()
+	: Scene(sSceneModelsFile)
+{
 }
 
-Scene::Scene() {  
+Scene::Scene(const char* modelsFilepath) {  
+	BRE_ASSERT(modelsFilepath);
 	InitDirectionalLights();    
 	InitPointLights(); 
 
-	BRE::MaterialManager::gInstance->LoadMaterials(sMaterialsFile);        
-	BRE::DrawManager::gInstance->LoadModels(sSceneModelsFile);    
+	const bool cookedMaterials = BRE::VirtualFileSystem::gInstance->Exists(sCookedMaterialsFile);
+	BRE::MaterialManager::gInstance->LoadMaterials(cookedMaterials ? sCookedMaterialsFile : sMaterialsFile);        
+	BRE::DrawManager::gInstance->LoadModels(modelsFilepath);    
 }
 
 void Scene::Update(const float elapsedTime) {   
+	BRE_PROFILE_SCOPE("Scene::Update");
 	UpdateDirectionalLight(elapsedTime);
 
-	// Directional
-	std::vector<BRE::LightsDrawer::DirLightData>& dirLightDataVec = BRE::DrawManager::gInstance->DirLightDataVec();
+	// Directional. Drawers get it from the frame snapshot.
 	const XMMATRIX viewMatrix = BRE::Camera::gInstance->ViewMatrix();
 	const XMFLOAT4 lightDir = XMFLOAT4(mDirectionalLight.Direction().x, mDirectionalLight.Direction().y, mDirectionalLight.Direction().z, 0.0f);
-	for (BRE::LightsDrawer::DirLightData& data : dirLightDataVec) {
-		XMFLOAT4 s;
-		XMStoreFloat4(&s, XMVector4Transform(XMLoadFloat4(&lightDir), viewMatrix));
-		data.mPixelShaderData.Light().mDirection.x = s.x;
-		data.mPixelShaderData.Light().mDirection.y = s.y;  
-		data.mPixelShaderData.Light().mDirection.z = s.z;       
-	}  
+	XMFLOAT4 s;
+	XMStoreFloat4(&s, XMVector4Transform(XMLoadFloat4(&lightDir), viewMatrix));
+	BRE::DirectionalLightData dirLightData;
+	dirLightData.mColor = mDirectionalLight.Color();
+	dirLightData.mDirection = XMFLOAT3(s.x, s.y, s.z);
+	BRE::FramePipeline::gInstance->SimulationFrame().mDirLights.push_back(dirLightData);
 }
   
 void Scene::InitDirectionalLights() {   
@@ -59,17 +68,7 @@ void Scene::InitDirectionalLights() {
 }
 
 void Scene::InitPointLights() {  
-	std::vector<BRE::LightsDrawer::PointLightData>& quadCulledPointLightDataVec = BRE::DrawManager::gInstance->PointLightDataVec();
-	BRE::LightsDrawer::PointLightData data;
-	data.mPointLightVsData.SetNumLights(1);
-	data.mPointLightVsData.LightPosAndRadius(0).x = -500.0f;
-	data.mPointLightVsData.LightPosAndRadius(0).y = 200.0f;
-	data.mPointLightVsData.LightPosAndRadius(0).z = 0.0f;
-	data.mPointLightVsData.LightPosAndRadius(0).w = 1000.0f;
-	const DirectX::XMFLOAT4 colorAndPower = DirectX::XMFLOAT4(1.0f, 1.0f, 1.0f, 1000000.0f);
-	data.mPointLightVsData.LightColorAndPower(0) = colorAndPower;
-	quadCulledPointLightDataVec.push_back(data);
-
+	BRE::DrawManager::gInstance->LoadPointLights(sScenePointLightsFile);
 }
 
 void Scene::UpdateDirectionalLight(const float elapsedTime) {    
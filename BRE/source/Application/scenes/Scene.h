@@ -20,6 +20,10 @@ public:
 	Scene();
 	virtual void Update(const float elapsedTime) override;
 
+protected:
+	// Same lights, with the models of modelsFilepath
+	explicit Scene(const char* modelsFilepath);
+
 private:
 	void InitDirectionalLights();
 	void InitPointLights();
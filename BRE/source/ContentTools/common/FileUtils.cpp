@@ -0,0 +1,122 @@
+#include "FileUtils.h"
+
+#include <cerrno>
+#include <fstream>
+#include <sys/stat.h>
+
+#ifdef _WIN32
+#include <direct.h>
+#include <windows.h>
+#else
+#include <dirent.h>
+#endif
+
+namespace {
+	bool MakeDirectory(const std::string& path) {
+#ifdef _WIN32
+		const int result = _mkdir(path.c_str());
+#else
+		const int result = mkdir(path.c_str(), 0755);
+#endif
+		return result == 0 || errno == EEXIST;
+	}
+
+	bool ListDirectory(const std::string& directory, const std::string& prefix, std::vector<std::string>& files) {
+#ifdef _WIN32
+		WIN32_FIND_DATAA data;
+		HANDLE find = FindFirstFileA((directory + "\\*").c_str(), &data);
+		if (find == INVALID_HANDLE_VALUE) {
+			return false;
+		}
+		bool succeeded = true;
+		do {
+			const std::string name = data.cFileName;
+			if (name == "." || name == "..") {
+				continue;
+			}
+			if ((data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0U) {
+				succeeded = ListDirectory(directory + "\\" + name, prefix + name + "/", files) && succeeded;
+			}
+			else {
+				files.push_back(prefix + name);
+			}
+		} while (FindNextFileA(find, &data));
+		FindClose(find);
+		return succeeded;
+#else
+		DIR* dir = opendir(directory.c_str());
+		if (!dir) {
+			return false;
+		}
+		bool succeeded = true;
+		while (const dirent* entry = readdir(dir)) {
+			const std::string name = entry->d_name;
+			if (name == "." || name == "..") {
+				continue;
+			}
+			const std::string path = directory + "/" + name;
+			struct stat status;
+			if (stat(path.c_str(), &status) != 0) {
+				succeeded = false;
+			}
+			else if (S_ISDIR(status.st_mode)) {
+				succeeded = ListDirectory(path, prefix + name + "/", files) && succeeded;
+			}
+			else if (S_ISREG(status.st_mode)) {
+				files.push_back(prefix + name);
+			}
+		}
+		closedir(dir);
+		return succeeded;
+#endif
+	}
+}
+
+namespace BRE {
+	namespace FileUtils {
+		std::string NativePath(const std::string& rootDirectory, const std::string& contentPath) {
+			std::string path = rootDirectory.empty() ? contentPath : rootDirectory + "/" + contentPath;
+			for (char& c : path) {
+				if (c == '\\') {
+					c = '/';
+				}
+			}
+			return path;
+		}
+
+		std::string Directory(const std::string& path) {
+			const size_t pos = path.find_last_of("/\\");
+			return pos == std::string::npos ? std::string() : path.substr(0U, pos);
+		}
+
+		bool CreateDirectories(const std::string& path) {
+			for (size_t pos = path.find_first_of("/\\", 1U); pos != std::string::npos; pos = path.find_first_of("/\\", pos + 1U)) {
+				const std::string directory = path.substr(0U, pos);
+				// Skip drive letters ("C:")
+				if (directory.back() != ':' && directory != "." && directory != ".." && !MakeDirectory(directory)) {
+					return false;
+				}
+			}
+			return path.empty() || MakeDirectory(path);
+		}
+
+		bool ReadFile(const std::string& filepath, std::vector<std::uint8_t>& data) {
+			std::ifstream stream(filepath, std::ios::in | std::ios::binary);
+			if (!stream.is_open()) {
+				return false;
+			}
+			stream.seekg(0, std::ios::end);
+			const std::streamoff size = stream.tellg();
+			if (size < 0) {
+				return false;
+			}
+			data.resize(static_cast<size_t>(size));
+			stream.seekg(0, std::ios::beg);
+			return data.empty() || stream.read(reinterpret_cast<char*>(data.data()), size);
+		}
+
+		bool ListFiles(const std::string& directory, std::vector<std::string>& files) {
+			return ListDirectory(directory, std::string(), files);
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace BRE {
+	namespace FileUtils {
+		// Content paths are written with '\\' separators and are relative to
+		// the application directory. Returns rootDirectory/contentPath with
+		// separators that work on every platform.
+		std::string NativePath(const std::string& rootDirectory, const std::string& contentPath);
+
+		// Directory of a path (without the last separator) or an empty string
+		std::string Directory(const std::string& path);
+
+		// Creates every missing directory of path. Returns false on failure.
+		bool CreateDirectories(const std::string& path);
+
+		// Reads the whole file. Returns false if it cannot be read.
+		bool ReadFile(const std::string& filepath, std::vector<std::uint8_t>& data);
+
+		// Appends the paths of every file under directory (recursively), relative
+		// to it and with '/' separators. Returns false if a directory cannot be read.
+		bool ListFiles(const std::string& directory, std::vector<std::string>& files);
+	}
+}
\ No newline at end of file
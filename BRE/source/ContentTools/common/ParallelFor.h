@@ -0,0 +1,30 @@
+#pragma once
+
+#include <general/JobSystem.h>
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Parallel loop of the content tools. It runs on the job system of the
+// process (main() creates it), so worker threads are created once instead
+// of on every call. Without a job system, the loop runs in the calling
+// thread.
+//
+//////////////////////////////////////////////////////////////////////////
+
+namespace BRE {
+	// Runs function(i) for i in [0, count)
+	template<typename Function>
+	void ParallelFor(const unsigned int count, const Function& function) {
+		if (count <= 1U || JobSystem::gInstance == nullptr) {
+			for (unsigned int i = 0U; i < count; ++i) {
+				function(i);
+			}
+			return;
+		}
+		JobSystem::gInstance->ParallelFor(0U, count, 1U, [&function](const size_t begin, const size_t end) {
+			for (size_t i = begin; i < end; ++i) {
+				function(static_cast<unsigned int>(i));
+			}
+		});
+	}
+}
\ No newline at end of file
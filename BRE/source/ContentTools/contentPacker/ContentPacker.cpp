@@ -0,0 +1,239 @@
+#include "ContentPacker.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <unordered_map>
+
+#include <common/FileUtils.h>
+#include <common/ParallelFor.h>
+#include <streaming/ContentPack.h>
+#include <utils/Assert.h>
+#include <utils/Lz4.h>
+
+namespace {
+	// 64 bits FNV-1a
+	std::uint64_t ContentHash(const std::vector<std::uint8_t>& data) {
+		std::uint64_t hash = 14695981039346656037ULL;
+		for (const std::uint8_t value : data) {
+			hash ^= value;
+			hash *= 1099511628211ULL;
+		}
+		return hash;
+	}
+
+	void WritePadding(std::ofstream& stream, const std::uint64_t alignment, std::uint64_t& position) {
+		static const char zeros[256] = {};
+		std::uint64_t padding = (alignment - position % alignment) % alignment;
+		position += padding;
+		while (padding > 0U) {
+			const std::uint64_t bytes = std::min<std::uint64_t>(padding, sizeof(zeros));
+			stream.write(zeros, static_cast<std::streamsize>(bytes));
+			padding -= bytes;
+		}
+	}
+
+	// Data written once and shared by every file with the same content
+	struct StoredData {
+		std::string mNativePath;
+		std::uint64_t mSize;
+		std::uint64_t mOffset;
+		std::uint64_t mStoredSize;
+		std::uint32_t mFlags;
+	};
+}
+
+namespace BRE {
+	bool ContentPacker::CompressEntry(const std::vector<std::uint8_t>& data, const unsigned int blockSize, std::vector<std::uint8_t>& stored) {
+		BRE_ASSERT(blockSize > 0U);
+		if (data.empty()) {
+			return false;
+		}
+
+		const size_t numBlocks = ContentPack::NumBlocks(data.size(), blockSize);
+		std::vector<std::vector<std::uint8_t>> blocks(numBlocks);
+		ParallelFor(static_cast<unsigned int>(numBlocks), [&](const unsigned int block) {
+			const size_t start = static_cast<size_t>(block) * blockSize;
+			const size_t bytes = std::min(static_cast<size_t>(blockSize), data.size() - start);
+			std::vector<std::uint8_t>& blockData = blocks[block];
+			blockData.resize(Lz4::CompressBound(bytes));
+			const size_t compressedSize = Lz4::Compress(data.data() + start, bytes, blockData.data(), blockData.size());
+			// Blocks that do not shrink are stored as they are (ContentPack tells them by their size)
+			if (compressedSize == 0U || compressedSize >= bytes) {
+				blockData.assign(data.begin() + start, data.begin() + start + bytes);
+			}
+			else {
+				blockData.resize(compressedSize);
+			}
+		});
+
+		stored.assign(numBlocks * sizeof(std::uint64_t), 0U);
+		std::uint64_t end = 0U;
+		for (size_t block = 0U; block < numBlocks; ++block) {
+			end += blocks[block].size();
+			memcpy(stored.data() + block * sizeof(std::uint64_t), &end, sizeof(end));
+		}
+		for (const std::vector<std::uint8_t>& blockData : blocks) {
+			stored.insert(stored.end(), blockData.begin(), blockData.end());
+		}
+		return stored.size() <= data.size() - data.size() / 8U;
+	}
+
+	bool ContentPacker::Pack(const Settings& settings, const std::string& packFilepath, std::ostream& log, Result& result) {
+		BRE_ASSERT(settings.mAlignment > 0U && (settings.mAlignment & (settings.mAlignment - 1U)) == 0U);
+		BRE_ASSERT(settings.mBlockSize > 0U);
+		result.mNumFiles = 0U;
+		result.mNumDuplicates = 0U;
+		result.mNumCompressed = 0U;
+		result.mInputBytes = 0U;
+		result.mPackBytes = 0U;
+
+		// Native path of each normalized content path, sorted so packs are reproducible
+		std::map<std::string, std::string> nativePathByPath;
+		const std::string normalizedPackPath = ContentPack::NormalizePath(packFilepath);
+		for (const std::string& directory : settings.mDirectories) {
+			const std::string nativeDirectory = FileUtils::NativePath(settings.mRootDirectory, directory);
+			std::vector<std::string> files;
+			if (!FileUtils::ListFiles(nativeDirectory, files)) {
+				log << nativeDirectory << ": directory could not be read" << std::endl;
+				return false;
+			}
+			for (const std::string& file : files) {
+				const std::string contentPath = directory + "/" + file;
+				const std::string path = ContentPack::NormalizePath(contentPath);
+				if (path != normalizedPackPath) {
+					nativePathByPath[path] = FileUtils::NativePath(settings.mRootDirectory, contentPath);
+				}
+			}
+		}
+
+		const std::string nativePackPath = FileUtils::NativePath(settings.mRootDirectory, packFilepath);
+		const std::string packDirectory = FileUtils::Directory(nativePackPath);
+		if (!packDirectory.empty() && !FileUtils::CreateDirectories(packDirectory)) {
+			log << packDirectory << ": directory could not be created" << std::endl;
+			return false;
+		}
+		std::ofstream stream(nativePackPath, std::ios::out | std::ios::binary | std::ios::trunc);
+		if (!stream.is_open()) {
+			log << nativePackPath << ": file could not be written" << std::endl;
+			return false;
+		}
+
+		ContentPack::Header header;
+		memset(&header, 0, sizeof(header));
+		stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		std::uint64_t position = sizeof(header);
+
+		std::vector<ContentPack::Entry> entries;
+		std::string names;
+		std::vector<StoredData> storedData;
+		std::unordered_map<std::uint64_t, std::vector<size_t>> storedDataByHash;
+		std::vector<std::uint8_t> data;
+		std::vector<std::uint8_t> otherData;
+		std::vector<std::uint8_t> compressedData;
+		for (const auto& file : nativePathByPath) {
+			if (!FileUtils::ReadFile(file.second, data)) {
+				log << file.second << ": file could not be read" << std::endl;
+				return false;
+			}
+			++result.mNumFiles;
+			result.mInputBytes += data.size();
+
+			std::vector<size_t>& candidates = storedDataByHash[ContentHash(data)];
+			const StoredData* shared = nullptr;
+			for (const size_t candidate : candidates) {
+				if (storedData[candidate].mSize == data.size() && FileUtils::ReadFile(storedData[candidate].mNativePath, otherData) && otherData == data) {
+					shared = &storedData[candidate];
+					break;
+				}
+			}
+			if (shared) {
+				++result.mNumDuplicates;
+			}
+			else {
+				StoredData newData;
+				newData.mNativePath = file.second;
+				newData.mSize = data.size();
+				newData.mFlags = 0U;
+				const std::vector<std::uint8_t>* written = &data;
+				if (settings.mCompress && CompressEntry(data, settings.mBlockSize, compressedData)) {
+					newData.mFlags = ContentPack::sCompressed;
+					written = &compressedData;
+					++result.mNumCompressed;
+				}
+				WritePadding(stream, settings.mAlignment, position);
+				newData.mOffset = position;
+				newData.mStoredSize = written->size();
+				stream.write(reinterpret_cast<const char*>(written->data()), static_cast<std::streamsize>(written->size()));
+				position += written->size();
+				candidates.push_back(storedData.size());
+				storedData.push_back(newData);
+				shared = &storedData.back();
+			}
+
+			ContentPack::Entry entry;
+			entry.mPathHash = ContentPack::HashPath(file.first);
+			entry.mOffset = shared->mOffset;
+			entry.mSize = shared->mSize;
+			entry.mStoredSize = shared->mStoredSize;
+			entry.mNameOffset = static_cast<std::uint32_t>(names.size());
+			entry.mFlags = shared->mFlags;
+			entries.push_back(entry);
+			names += file.first;
+			names.push_back('\0');
+		}
+
+		std::sort(entries.begin(), entries.end(), [&names](const ContentPack::Entry& lhs, const ContentPack::Entry& rhs) {
+			if (lhs.mPathHash != rhs.mPathHash) {
+				return lhs.mPathHash < rhs.mPathHash;
+			}
+			return strcmp(names.c_str() + lhs.mNameOffset, names.c_str() + rhs.mNameOffset) < 0;
+		});
+		WritePadding(stream, sizeof(std::uint64_t), position);
+		header.mEntriesOffset = position;
+		stream.write(reinterpret_cast<const char*>(entries.data()), static_cast<std::streamsize>(entries.size() * sizeof(ContentPack::Entry)));
+		position += entries.size() * sizeof(ContentPack::Entry);
+		header.mNamesOffset = position;
+		header.mNamesSize = names.size();
+		stream.write(names.data(), static_cast<std::streamsize>(names.size()));
+		position += names.size();
+
+		header.mMagic = ContentPack::sMagic;
+		header.mVersion = ContentPack::sVersion;
+		header.mNumEntries = static_cast<std::uint32_t>(entries.size());
+		header.mAlignment = settings.mAlignment;
+		header.mBlockSize = settings.mBlockSize;
+		stream.seekp(0, std::ios::beg);
+		stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		stream.close();
+		if (!stream) {
+			log << nativePackPath << ": file could not be written" << std::endl;
+			return false;
+		}
+		result.mPackBytes = position;
+
+		if (!settings.mVerify) {
+			return true;
+		}
+		ContentPack pack;
+		std::string error;
+		if (!pack.Open(nativePackPath, error)) {
+			log << error << std::endl;
+			return false;
+		}
+		for (const auto& file : nativePathByPath) {
+			size_t entry;
+			if (!pack.Find(file.first, entry) || !FileUtils::ReadFile(file.second, data)) {
+				log << file.first << ": entry not found" << std::endl;
+				return false;
+			}
+			otherData.resize(static_cast<size_t>(pack.GetEntry(entry).mSize));
+			if (!pack.Read(entry, 0U, otherData.size(), otherData.data()) || otherData != data) {
+				log << file.first << ": entry does not match its file" << std::endl;
+				return false;
+			}
+		}
+		return true;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Offline content packer.
+// Every file under the packed directories becomes an entry of a single
+// content pack (see ContentPack in RenderingLib), named by its content path
+// so the renderer VirtualFileSystem finds it instead of the loose file.
+// Files with the same content are stored once (content hash, confirmed
+// byte by byte). With compression, entries are split in blocks compressed
+// in parallel (see Lz4), and only entries that shrink by at least an
+// eighth are stored compressed, so already compressed content (block
+// compressed textures, shader archives) stays directly mappable.
+//
+//////////////////////////////////////////////////////////////////////////
+
+namespace BRE {
+	class ContentPacker {
+	public:
+		struct Settings {
+			// Directory content paths are relative to (application directory)
+			std::string mRootDirectory = ".";
+			// Content paths of the directories to pack
+			std::vector<std::string> mDirectories;
+			// Entry data alignment (power of two)
+			unsigned int mAlignment = 64U;
+			bool mCompress = false;
+			// Uncompressed bytes of each compressed block
+			unsigned int mBlockSize = 64U * 1024U;
+			// Read every entry back and compare it with its file
+			bool mVerify = false;
+		};
+
+		struct Result {
+			size_t mNumFiles;
+			// Entries that share the data of a previous file
+			size_t mNumDuplicates;
+			size_t mNumCompressed;
+			std::uint64_t mInputBytes;
+			std::uint64_t mPackBytes;
+		};
+
+		// Stored layout of a compressed entry (block end table and blocks).
+		// Returns false if it does not shrink enough to be stored compressed.
+		static bool CompressEntry(const std::vector<std::uint8_t>& data, const unsigned int blockSize, std::vector<std::uint8_t>& stored);
+
+		// packFilepath is a content path. Returns false if a file cannot be
+		// read, the pack cannot be written or the verification fails.
+		// Progress and errors go to log.
+		static bool Pack(const Settings& settings, const std::string& packFilepath, std::ostream& log, Result& result);
+	};
+}
\ No newline at end of file
@@ -0,0 +1,339 @@
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include <contentPacker/ContentPacker.h>
+#include <general/JobSystem.h>
+#include <materialCooker/MaterialCooker.h>
+#include <sceneGenerator/SceneGenerator.h>
+#include <shaderArchiver/ShaderArchiver.h>
+#include <textures/DdsFile.h>
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Offline content tools.
+// Usage: ContentTools <command> [--option value]...
+//
+//////////////////////////////////////////////////////////////////////////
+
+namespace {
+	void PrintUsage() {
+		std::cout << "Usage: ContentTools <command> [options]\n"
+			"\n"
+			"generateScene\n"
+			"  --out <directory>       Output directory of models.yml, materials.yml and lights.yml\n"
+			"  --seed <n>              Random seed (default 1)\n"
+			"  --objects <n>           Number of objects (default 1000)\n"
+			"  --meshReuse <0..1>      Fraction of objects that reuse a mesh (default 0.9)\n"
+			"  --materials <n>         Number of materials (default 10)\n"
+			"  --lights <n>            Number of point lights (default 512)\n"
+			"  --extent <f>            Half size of the placement area (default 5000)\n"
+			"  --renderType <type>     Basic, Normal or Normal_Displacement (default Normal)\n"
+			"  --mesh <path>           Mesh to use. It can be repeated. Replaces the default meshes.\n"
+			"\n"
+			"cookMaterials\n"
+			"  --root <directory>      Directory content paths are relative to (default .)\n"
+			"  --materials <path>      Materials file (default content\\configs\\materials.yml)\n"
+			"  --manifest <path>       Cooked materials file (default content\\configs\\cookedMaterials.yml)\n"
+			"  --out <path>            Cooked textures directory (default content\\cookedMaterials)\n"
+			"  --noPack                Do not pack smoothness, metal mask and curvature\n"
+			"  --uncompressed          Do not block compress textures\n"
+			"  --baseColorFormat <f>   BC1 or BC7 (default BC1)\n"
+			"  --report <file>         CSV file with the PSNR of each compressed texture\n"
+			"  --minPsnr <dB>          Fail if a compressed texture has a lower PSNR (default 0)\n"
+			"  --noUniform             Do not replace uniform textures by material constants\n"
+			"  --uniformTolerance <n>  Largest texel difference (0..255) of uniform textures (default 2)\n"
+			"\n"
+			"generateMips\n"
+			"  --in <file>             DDS file (its top level is used)\n"
+			"  --out <file>            DDS file with the full RGBA8 mip chain\n"
+			"  --filter <filter>       Box or Kaiser (default Kaiser)\n"
+			"  --srgb                  Color channels are sRGB encoded (filter them in linear space)\n"
+			"  --clamp                 Clamp addressing (default is wrap, for tiled textures)\n"
+			"  --normal                Tangent space normal map (average vectors and renormalize)\n"
+			"\n"
+			"pack\n"
+			"  --root <directory>      Directory content paths are relative to (default .)\n"
+			"  --dir <path>            Content directory to pack. It can be repeated (default content)\n"
+			"  --out <path>            Content pack (default content.pack)\n"
+			"  --alignment <n>         Alignment of entries, a power of two (default 64)\n"
+			"  --compress              LZ4 compress entries that shrink by at least an eighth\n"
+			"  --blockSize <n>         Bytes of each compressed block (default 65536)\n"
+			"  --verify                Read every entry back and compare it with its file\n"
+			"\n"
+			"shaders\n"
+			"  --root <directory>      Directory content paths are relative to (default .)\n"
+			"  --manifest <path>       Shaders manifest (default content\\configs\\shaders.yml)\n"
+			"  --out <path>            Shader archive (default content\\shaders\\shaders.archive)\n";
+	}
+
+	// Returns the value of the option at index and advances it
+	const char* NextValue(const int argc, char** argv, int& index) {
+		if (index + 1 >= argc) {
+			std::cerr << "Missing value for " << argv[index] << std::endl;
+			exit(EXIT_FAILURE);
+		}
+		++index;
+		return argv[index];
+	}
+
+	int GenerateScene(const int argc, char** argv) {
+		BRE::SceneGenerator::Settings settings = BRE::SceneGenerator::DefaultSettings();
+		std::string outDirectory = ".";
+		bool defaultMeshes = true;
+		for (int i = 2; i < argc; ++i) {
+			const char* option = argv[i];
+			if (strcmp(option, "--out") == 0) outDirectory = NextValue(argc, argv, i);
+			else if (strcmp(option, "--seed") == 0) settings.mSeed = static_cast<std::uint32_t>(strtoul(NextValue(argc, argv, i), nullptr, 10));
+			else if (strcmp(option, "--objects") == 0) settings.mNumObjects = static_cast<size_t>(strtoull(NextValue(argc, argv, i), nullptr, 10));
+			else if (strcmp(option, "--meshReuse") == 0) settings.mMeshReuseRatio = static_cast<float>(atof(NextValue(argc, argv, i)));
+			else if (strcmp(option, "--materials") == 0) settings.mNumMaterials = static_cast<size_t>(strtoull(NextValue(argc, argv, i), nullptr, 10));
+			else if (strcmp(option, "--lights") == 0) settings.mNumLights = static_cast<size_t>(strtoull(NextValue(argc, argv, i), nullptr, 10));
+			else if (strcmp(option, "--extent") == 0) settings.mExtent = static_cast<float>(atof(NextValue(argc, argv, i)));
+			else if (strcmp(option, "--renderType") == 0) settings.mRenderType = NextValue(argc, argv, i);
+			else if (strcmp(option, "--mesh") == 0) {
+				if (defaultMeshes) {
+					settings.mMeshes.clear();
+					defaultMeshes = false;
+				}
+				settings.mMeshes.push_back(NextValue(argc, argv, i));
+			}
+			else {
+				std::cerr << "Unknown option " << option << std::endl;
+				PrintUsage();
+				return EXIT_FAILURE;
+			}
+		}
+
+		BRE::SceneGenerator::Result result;
+		if (!BRE::SceneGenerator::Generate(settings, outDirectory + "/models.yml", outDirectory + "/materials.yml", outDirectory + "/lights.yml", result)) {
+			std::cerr << "Scene generation failed" << std::endl;
+			return EXIT_FAILURE;
+		}
+
+		std::cout << "Generated " << result.mNumObjects << " objects (" << result.mNumDistinctMeshes << " distinct meshes), "
+			<< result.mNumMaterials << " materials and " << result.mNumLights << " point lights in " << outDirectory << std::endl;
+		return EXIT_SUCCESS;
+	}
+
+	bool WriteReport(const std::string& filepath, const BRE::MaterialCooker::Result& result) {
+		std::ofstream stream(filepath, std::ios::out | std::ios::trunc);
+		if (!stream.is_open()) {
+			return false;
+		}
+		stream << "material,texture,format,width,height,psnr\n";
+		for (const BRE::MaterialCooker::CompressedTexture& texture : result.mCompressedTextures) {
+			stream << texture.mMaterial << "," << texture.mTexture << "," << BRE::BlockCompression::Name(texture.mFormat) << ","
+				<< texture.mWidth << "," << texture.mHeight << "," << texture.mPsnr << "\n";
+		}
+		return stream.good();
+	}
+
+	int CookMaterials(const int argc, char** argv) {
+		BRE::MaterialCooker::Settings settings;
+		std::string materialsFilepath = "content\\configs\\materials.yml";
+		std::string manifestFilepath = "content\\configs\\cookedMaterials.yml";
+		std::string reportFilepath;
+		for (int i = 2; i < argc; ++i) {
+			const char* option = argv[i];
+			if (strcmp(option, "--root") == 0) settings.mRootDirectory = NextValue(argc, argv, i);
+			else if (strcmp(option, "--materials") == 0) materialsFilepath = NextValue(argc, argv, i);
+			else if (strcmp(option, "--manifest") == 0) manifestFilepath = NextValue(argc, argv, i);
+			else if (strcmp(option, "--out") == 0) settings.mOutputDirectory = NextValue(argc, argv, i);
+			else if (strcmp(option, "--noPack") == 0) settings.mPack = false;
+			else if (strcmp(option, "--uncompressed") == 0) settings.mCompress = false;
+			else if (strcmp(option, "--report") == 0) reportFilepath = NextValue(argc, argv, i);
+			else if (strcmp(option, "--minPsnr") == 0) settings.mMinPsnr = atof(NextValue(argc, argv, i));
+			else if (strcmp(option, "--noUniform") == 0) settings.mDetectUniform = false;
+			else if (strcmp(option, "--uniformTolerance") == 0) settings.mUniformTolerance = static_cast<unsigned int>(strtoul(NextValue(argc, argv, i), nullptr, 10));
+			else if (strcmp(option, "--baseColorFormat") == 0) {
+				const char* format = NextValue(argc, argv, i);
+				if (strcmp(format, "BC1") == 0) settings.mBaseColorFormat = BRE::BlockFormat::BC1;
+				else if (strcmp(format, "BC7") == 0) settings.mBaseColorFormat = BRE::BlockFormat::BC7;
+				else {
+					std::cerr << "Unknown base color format " << format << std::endl;
+					return EXIT_FAILURE;
+				}
+			}
+			else {
+				std::cerr << "Unknown option " << option << std::endl;
+				PrintUsage();
+				return EXIT_FAILURE;
+			}
+		}
+
+		BRE::MaterialCooker::Result result;
+		const bool cooked = BRE::MaterialCooker::Cook(settings, materialsFilepath, manifestFilepath, std::cerr, result);
+		if (!reportFilepath.empty() && !WriteReport(reportFilepath, result)) {
+			std::cerr << reportFilepath << ": report could not be written" << std::endl;
+			return EXIT_FAILURE;
+		}
+		if (!cooked) {
+			std::cerr << "Material cooking failed" << std::endl;
+			return EXIT_FAILURE;
+		}
+
+		for (const BRE::MaterialCooker::CompressedTexture& texture : result.mCompressedTextures) {
+			std::cout << texture.mMaterial << " " << texture.mTexture << " " << BRE::BlockCompression::Name(texture.mFormat)
+				<< " " << texture.mWidth << "x" << texture.mHeight << " PSNR " << texture.mPsnr << " dB" << std::endl;
+		}
+		std::cout << "Cooked " << result.mNumPacked << " packed and " << result.mNumUnpacked << " unpacked materials ("
+			<< result.mNumCompressed << " compressed, " << result.mNumUniform << " uniform textures) in " << manifestFilepath << std::endl;
+		return EXIT_SUCCESS;
+	}
+
+	int GenerateMips(const int argc, char** argv) {
+		BRE::MipGenerator::Settings settings;
+		settings.mFilter = BRE::MipGenerator::Filter::Kaiser;
+		std::string inFilepath;
+		std::string outFilepath;
+		for (int i = 2; i < argc; ++i) {
+			const char* option = argv[i];
+			if (strcmp(option, "--in") == 0) inFilepath = NextValue(argc, argv, i);
+			else if (strcmp(option, "--out") == 0) outFilepath = NextValue(argc, argv, i);
+			else if (strcmp(option, "--srgb") == 0) settings.mSRGB = true;
+			else if (strcmp(option, "--clamp") == 0) settings.mWrap = false;
+			else if (strcmp(option, "--normal") == 0) settings.mNormalMap = true;
+			else if (strcmp(option, "--filter") == 0) {
+				const char* filter = NextValue(argc, argv, i);
+				if (strcmp(filter, "Box") == 0) settings.mFilter = BRE::MipGenerator::Filter::Box;
+				else if (strcmp(filter, "Kaiser") == 0) settings.mFilter = BRE::MipGenerator::Filter::Kaiser;
+				else {
+					std::cerr << "Unknown filter " << filter << std::endl;
+					return EXIT_FAILURE;
+				}
+			}
+			else {
+				std::cerr << "Unknown option " << option << std::endl;
+				PrintUsage();
+				return EXIT_FAILURE;
+			}
+		}
+		if (inFilepath.empty() || outFilepath.empty()) {
+			std::cerr << "--in and --out are required" << std::endl;
+			return EXIT_FAILURE;
+		}
+		if (settings.mSRGB && settings.mNormalMap) {
+			std::cerr << "--srgb and --normal are exclusive" << std::endl;
+			return EXIT_FAILURE;
+		}
+
+		BRE::Image image;
+		std::string error;
+		if (!BRE::DdsFile::Read(inFilepath, image, error)) {
+			std::cerr << inFilepath << ": " << error << std::endl;
+			return EXIT_FAILURE;
+		}
+		std::vector<BRE::Image> mips;
+		BRE::ImageUtils::GenerateMips(image, mips, settings);
+		if (!BRE::DdsFile::Write(outFilepath, mips, error)) {
+			std::cerr << outFilepath << ": " << error << std::endl;
+			return EXIT_FAILURE;
+		}
+
+		std::cout << "Generated " << mips.size() << " levels (" << image.mWidth << "x" << image.mHeight << ") in " << outFilepath << std::endl;
+		return EXIT_SUCCESS;
+	}
+
+	int Pack(const int argc, char** argv) {
+		BRE::ContentPacker::Settings settings;
+		std::string packFilepath = "content.pack";
+		for (int i = 2; i < argc; ++i) {
+			const char* option = argv[i];
+			if (strcmp(option, "--root") == 0) settings.mRootDirectory = NextValue(argc, argv, i);
+			else if (strcmp(option, "--dir") == 0) settings.mDirectories.push_back(NextValue(argc, argv, i));
+			else if (strcmp(option, "--out") == 0) packFilepath = NextValue(argc, argv, i);
+			else if (strcmp(option, "--alignment") == 0) settings.mAlignment = static_cast<unsigned int>(strtoul(NextValue(argc, argv, i), nullptr, 10));
+			else if (strcmp(option, "--compress") == 0) settings.mCompress = true;
+			else if (strcmp(option, "--blockSize") == 0) settings.mBlockSize = static_cast<unsigned int>(strtoul(NextValue(argc, argv, i), nullptr, 10));
+			else if (strcmp(option, "--verify") == 0) settings.mVerify = true;
+			else {
+				std::cerr << "Unknown option " << option << std::endl;
+				PrintUsage();
+				return EXIT_FAILURE;
+			}
+		}
+		if (settings.mDirectories.empty()) {
+			settings.mDirectories.push_back("content");
+		}
+		if (settings.mAlignment == 0U || (settings.mAlignment & (settings.mAlignment - 1U)) != 0U) {
+			std::cerr << "--alignment must be a power of two" << std::endl;
+			return EXIT_FAILURE;
+		}
+		if (settings.mBlockSize == 0U) {
+			std::cerr << "--blockSize must be positive" << std::endl;
+			return EXIT_FAILURE;
+		}
+
+		BRE::ContentPacker::Result result;
+		if (!BRE::ContentPacker::Pack(settings, packFilepath, std::cerr, result)) {
+			std::cerr << "Packing failed" << std::endl;
+			return EXIT_FAILURE;
+		}
+
+		std::cout << "Packed " << result.mNumFiles << " files (" << result.mNumDuplicates << " duplicates, " << result.mNumCompressed << " compressed), "
+			<< result.mInputBytes << " bytes into " << result.mPackBytes << " bytes in " << packFilepath << std::endl;
+		return EXIT_SUCCESS;
+	}
+
+	int Shaders(const int argc, char** argv) {
+		BRE::ShaderArchiver::Settings settings;
+		std::string manifestFilepath = "content\\configs\\shaders.yml";
+		std::string archiveFilepath = "content\\shaders\\shaders.archive";
+		for (int i = 2; i < argc; ++i) {
+			const char* option = argv[i];
+			if (strcmp(option, "--root") == 0) settings.mRootDirectory = NextValue(argc, argv, i);
+			else if (strcmp(option, "--manifest") == 0) manifestFilepath = NextValue(argc, argv, i);
+			else if (strcmp(option, "--out") == 0) archiveFilepath = NextValue(argc, argv, i);
+			else {
+				std::cerr << "Unknown option " << option << std::endl;
+				PrintUsage();
+				return EXIT_FAILURE;
+			}
+		}
+
+		BRE::ShaderArchiver::Result result;
+		if (!BRE::ShaderArchiver::Build(settings, manifestFilepath, archiveFilepath, std::cerr, result)) {
+			std::cerr << "Shader archiving failed" << std::endl;
+			return EXIT_FAILURE;
+		}
+
+		std::cout << "Archived " << result.mNumShaders << " shaders of " << result.mNumRenderTypes << " render types ("
+			<< result.mArchiveBytes << " bytes) in " << archiveFilepath << std::endl;
+		return EXIT_SUCCESS;
+	}
+}
+
+int main(int argc, char** argv) {
+	if (argc < 2) {
+		PrintUsage();
+		return EXIT_FAILURE;
+	}
+
+	// Parallel loops of every command run on it (see ParallelFor)
+	BRE::JobSystem jobSystem;
+	BRE::JobSystem::gInstance = &jobSystem;
+
+	const char* command = argv[1];
+	if (strcmp(command, "generateScene") == 0) {
+		return GenerateScene(argc, argv);
+	}
+	if (strcmp(command, "cookMaterials") == 0) {
+		return CookMaterials(argc, argv);
+	}
+	if (strcmp(command, "generateMips") == 0) {
+		return GenerateMips(argc, argv);
+	}
+	if (strcmp(command, "pack") == 0) {
+		return Pack(argc, argv);
+	}
+	if (strcmp(command, "shaders") == 0) {
+		return Shaders(argc, argv);
+	}
+
+	std::cerr << "Unknown command " << command << std::endl;
+	PrintUsage();
+	return EXIT_FAILURE;
+}
\ No newline at end of file
@@ -0,0 +1,370 @@
+#include "MaterialCooker.h"
+
+#include <algorithm>
+#include <fstream>
+#include <vector>
+#include <yaml-cpp/yaml.h>
+
+#include <common/FileUtils.h>
+#include <textures/DdsFile.h>
+#include <textures/UniformTexture.h>
+#include <utils/Assert.h>
+
+namespace {
+	const char* sScalarKeys[] = { "smoothness", "metalMask", "curvature" };
+	const char* sScalarSuffixes[] = { "_smoothness.dds", "_metal_mask.dds", "_curvature.dds" };
+	// Authored instead of smoothness (sScalarKeys[0])
+	const char* sRoughnessKey = "roughness";
+	const char* sPackedKey = "smoothnessMetalMaskCurvature";
+	const char* sBaseColorValueKey = "baseColorValue";
+	const char* sPackedValueKey = "smoothnessMetalMaskCurvatureValue";
+
+	void EmitEntry(YAML::Emitter& emitter, const char* key, const std::string& value) {
+		emitter << YAML::Key << key << YAML::Value << YAML::DoubleQuoted << value;
+	}
+
+	// Normalized R, G and B of value
+	void EmitValue(YAML::Emitter& emitter, const char* key, const std::uint8_t value[BRE::Image::sNumChannels]) {
+		emitter << YAML::Key << key << YAML::Value << YAML::Flow << YAML::BeginSeq;
+		for (unsigned int c = 0U; c < 3U; ++c) {
+			emitter << value[c] / 255.0f;
+		}
+		emitter << YAML::EndSeq;
+	}
+
+	// Copies a value entry of an already cooked material
+	void CopyValue(YAML::Emitter& emitter, const YAML::Node& node, const char* key) {
+		emitter << YAML::Key << key << YAML::Value << YAML::Flow << node[key];
+	}
+
+	std::string GetString(const YAML::Node& node, const char* key) {
+		const YAML::Node attr = node[key];
+		return attr.IsDefined() && attr.IsScalar() ? attr.as<std::string>() : std::string();
+	}
+
+	bool ReadTexture(const BRE::MaterialCooker::Settings& settings, const std::string& material, const char* key, const std::string& path, BRE::Image& image, std::ostream& log) {
+		std::string error;
+		if (!BRE::DdsFile::Read(BRE::FileUtils::NativePath(settings.mRootDirectory, path), image, error)) {
+			log << material << ": " << key << " texture \"" << path << "\" not cooked (" << error << ")" << std::endl;
+			return false;
+		}
+		return true;
+	}
+
+	// Writes image and its mip chain block compressed. Direct3D requires
+	// the top level of block compressed textures to be a multiple of 4,
+	// so it is resized if needed. Its PSNR is appended to the result.
+	bool WriteCompressed(const BRE::MaterialCooker::Settings& settings, const std::string& material, const char* key, const BRE::Image& image, const BRE::BlockFormat format, const BRE::MipGenerator::Settings& mipSettings, const std::string& contentPath, std::ostream& log, BRE::MaterialCooker::Result& result) {
+		using namespace BRE;
+
+		const unsigned int alignment = BlockCompression::sBlockDimension;
+		const unsigned int width = (image.mWidth + alignment - 1U) / alignment * alignment;
+		const unsigned int height = (image.mHeight + alignment - 1U) / alignment * alignment;
+		Image top;
+		if (width != image.mWidth || height != image.mHeight) {
+			ImageUtils::Resize(image, width, height, top);
+		}
+		else {
+			top = image;
+		}
+
+		std::vector<Image> mips;
+		ImageUtils::GenerateMips(top, mips, mipSettings);
+		std::vector<std::vector<std::uint8_t>> levels(mips.size());
+		for (size_t i = 0U; i < mips.size(); ++i) {
+			BlockCompression::Encode(format, mips[i], levels[i]);
+		}
+
+		Image decoded;
+		BlockCompression::Decode(format, levels.front().data(), width, height, decoded);
+		const MaterialCooker::CompressedTexture texture = { material, key, format, width, height, BlockCompression::Psnr(top, decoded, BlockCompression::ChannelMask(format)) };
+		result.mCompressedTextures.push_back(texture);
+
+		std::string error;
+		if (!DdsFile::WriteBlockCompressed(FileUtils::NativePath(settings.mRootDirectory, contentPath), format, width, height, levels, error)) {
+			log << contentPath << ": " << error << std::endl;
+			return false;
+		}
+		return true;
+	}
+
+	bool WriteUncompressed(const BRE::MaterialCooker::Settings& settings, const BRE::Image& image, const BRE::MipGenerator::Settings& mipSettings, const std::string& contentPath, std::ostream& log) {
+		std::vector<BRE::Image> mips;
+		BRE::ImageUtils::GenerateMips(image, mips, mipSettings);
+		std::string error;
+		if (!BRE::DdsFile::Write(BRE::FileUtils::NativePath(settings.mRootDirectory, contentPath), mips, error)) {
+			log << contentPath << ": " << error << std::endl;
+			return false;
+		}
+		return true;
+	}
+
+	// Smoothness of a roughness map. Only the R channel is inverted.
+	void InvertRoughness(BRE::Image& image) {
+		for (size_t i = 0U; i < image.mData.size(); i += BRE::Image::sNumChannels) {
+			image.mData[i] = static_cast<std::uint8_t>(255U - image.mData[i]);
+		}
+	}
+
+	// A uniform normal map is still sampled, so it is replaced by a single
+	// block (4x4 texels) of its value instead of a constant.
+	void ShrinkUniformNormal(const BRE::Image& normal, const std::uint8_t value[BRE::Image::sNumChannels], BRE::Image& result) {
+		using BRE::Image;
+		const unsigned int dimension = BRE::BlockCompression::sBlockDimension;
+		result = Image(dimension, dimension);
+		const std::uint8_t* first = normal.Texel(0U, 0U);
+		for (unsigned int i = 0U; i < dimension * dimension; ++i) {
+			std::uint8_t* dst = &result.mData[i * Image::sNumChannels];
+			dst[0] = value[0];
+			dst[1] = value[1];
+			dst[2] = first[2];
+			dst[3] = first[3];
+		}
+	}
+}
+
+namespace BRE {
+	void MaterialCooker::PackSmoothnessMetalMaskCurvature(const Image& smoothness, const Image& metalMask, const Image& curvature, const bool smoothnessIsRoughness, Image& result) {
+		const Image* inputs[] = { &smoothness, &metalMask, &curvature };
+		unsigned int width = 0U;
+		unsigned int height = 0U;
+		for (const Image* input : inputs) {
+			BRE_ASSERT(!input->Empty());
+			width = std::max(width, input->mWidth);
+			height = std::max(height, input->mHeight);
+		}
+
+		Image resized[3];
+		for (size_t i = 0U; i < 3U; ++i) {
+			ImageUtils::Resize(*inputs[i], width, height, resized[i]);
+		}
+		if (smoothnessIsRoughness) {
+			InvertRoughness(resized[0]);
+		}
+
+		result = Image(width, height);
+		const size_t numTexels = static_cast<size_t>(width) * height;
+		for (size_t i = 0U; i < numTexels; ++i) {
+			std::uint8_t* dst = &result.mData[i * Image::sNumChannels];
+			dst[0] = resized[0].mData[i * Image::sNumChannels];
+			dst[1] = resized[1].mData[i * Image::sNumChannels];
+			dst[2] = resized[2].mData[i * Image::sNumChannels];
+			dst[3] = 255U;
+		}
+	}
+
+	bool MaterialCooker::Cook(const Settings& settings, const std::string& materialsFilepath, const std::string& manifestFilepath, std::ostream& log, Result& result) {
+		BRE_ASSERT(settings.mBaseColorFormat == BlockFormat::BC1 || settings.mBaseColorFormat == BlockFormat::BC7);
+		result.mNumPacked = 0U;
+		result.mNumUnpacked = 0U;
+		result.mNumCompressed = 0U;
+		result.mNumUniform = 0U;
+		result.mCompressedTextures.clear();
+
+		YAML::Node yamlFile;
+		try {
+			yamlFile = YAML::LoadFile(FileUtils::NativePath(settings.mRootDirectory, materialsFilepath));
+		}
+		catch (const YAML::Exception& e) {
+			log << materialsFilepath << ": " << e.what() << std::endl;
+			return false;
+		}
+		const YAML::Node nodes = yamlFile["materials"];
+		if (!nodes.IsDefined() || !nodes.IsSequence()) {
+			log << materialsFilepath << ": materials sequence not found" << std::endl;
+			return false;
+		}
+
+		const std::string nativeOutputDirectory = FileUtils::NativePath(settings.mRootDirectory, settings.mOutputDirectory);
+		if (!FileUtils::CreateDirectories(nativeOutputDirectory)) {
+			log << nativeOutputDirectory << ": directory could not be created" << std::endl;
+			return false;
+		}
+
+		YAML::Emitter emitter;
+		emitter << YAML::BeginMap << YAML::Key << "materials" << YAML::Value << YAML::BeginSeq;
+		for (const YAML::Node& node : nodes) {
+			const std::string name = GetString(node, "name");
+			if (name.empty()) {
+				log << materialsFilepath << ": material without name skipped" << std::endl;
+				continue;
+			}
+
+			emitter << YAML::BeginMap;
+			EmitEntry(emitter, "name", name);
+			const std::string sampler = GetString(node, "sampler");
+			if (!sampler.empty()) {
+				EmitEntry(emitter, "sampler", sampler);
+			}
+
+			// Already cooked materials are copied as they are
+			const std::string packedPath = GetString(node, sPackedKey);
+			if (!packedPath.empty() || node[sPackedValueKey].IsDefined()) {
+				EmitEntry(emitter, "normal", GetString(node, "normal"));
+				if (node[sBaseColorValueKey].IsDefined()) {
+					CopyValue(emitter, node, sBaseColorValueKey);
+				}
+				else {
+					EmitEntry(emitter, "baseColor", GetString(node, "baseColor"));
+				}
+				if (packedPath.empty()) {
+					CopyValue(emitter, node, sPackedValueKey);
+				}
+				else {
+					EmitEntry(emitter, sPackedKey, packedPath);
+				}
+				emitter << YAML::EndMap;
+				++result.mNumPacked;
+				continue;
+			}
+
+			const bool roughness = GetString(node, sScalarKeys[0]).empty() && !GetString(node, sRoughnessKey).empty();
+			Image scalars[3];
+			bool readAll = true;
+			for (size_t i = 0U; i < 3U && readAll; ++i) {
+				const char* key = i == 0U && roughness ? sRoughnessKey : sScalarKeys[i];
+				readAll = ReadTexture(settings, name, key, GetString(node, key), scalars[i], log);
+			}
+
+			// A material is compressed only if all its textures can be read.
+			// Uniform textures are only detected in packed materials, the
+			// pixel shaders have constant permutations of the packed ones only.
+			Image normal;
+			Image baseColor;
+			const bool readMaps = readAll &&
+				(settings.mCompress || (settings.mDetectUniform && settings.mPack)) &&
+				ReadTexture(settings, name, "normal", GetString(node, "normal"), normal, log) &&
+				ReadTexture(settings, name, "baseColor", GetString(node, "baseColor"), baseColor, log);
+			const bool compress = settings.mCompress && readMaps;
+			const bool detectUniform = settings.mDetectUniform && settings.mPack && readMaps;
+
+			std::uint8_t normalValue[Image::sNumChannels];
+			const bool uniformNormal = detectUniform && UniformTexture::Detect(normal, 0x3U, settings.mUniformTolerance, normalValue);
+			if (uniformNormal) {
+				Image shrunk;
+				ShrinkUniformNormal(normal, normalValue, shrunk);
+				normal = shrunk;
+				++result.mNumUniform;
+			}
+			std::uint8_t baseColorValue[Image::sNumChannels];
+			const bool uniformBaseColor = detectUniform && UniformTexture::Detect(baseColor, 0x7U, settings.mUniformTolerance, baseColorValue);
+			if (uniformBaseColor) {
+				++result.mNumUniform;
+			}
+
+			const std::string outputPath = settings.mOutputDirectory + "\\" + name;
+			const std::string normalPath = outputPath + "_normal.dds";
+			const std::string baseColorPath = outputPath + "_base_color.dds";
+			// Normal mips are averaged as vectors and renormalized, base color
+			// mips are filtered in linear space.
+			MipGenerator::Settings normalMipSettings;
+			normalMipSettings.mNormalMap = true;
+			MipGenerator::Settings baseColorMipSettings;
+			baseColorMipSettings.mSRGB = true;
+			const MipGenerator::Settings dataMipSettings;
+			if (compress) {
+				if (!WriteCompressed(settings, name, "normal", normal, BlockFormat::BC5, normalMipSettings, normalPath, log, result)) {
+					return false;
+				}
+				EmitEntry(emitter, "normal", normalPath);
+				if (!uniformBaseColor) {
+					if (!WriteCompressed(settings, name, "baseColor", baseColor, settings.mBaseColorFormat, baseColorMipSettings, baseColorPath, log, result)) {
+						return false;
+					}
+					EmitEntry(emitter, "baseColor", baseColorPath);
+				}
+				++result.mNumCompressed;
+			}
+			else {
+				if (uniformNormal) {
+					if (!WriteUncompressed(settings, normal, normalMipSettings, normalPath, log)) {
+						return false;
+					}
+					EmitEntry(emitter, "normal", normalPath);
+				}
+				else {
+					EmitEntry(emitter, "normal", GetString(node, "normal"));
+				}
+				if (!uniformBaseColor) {
+					EmitEntry(emitter, "baseColor", GetString(node, "baseColor"));
+				}
+			}
+			if (uniformBaseColor) {
+				EmitValue(emitter, sBaseColorValueKey, baseColorValue);
+			}
+
+			if (readAll && settings.mPack) {
+				Image packed;
+				PackSmoothnessMetalMaskCurvature(scalars[0], scalars[1], scalars[2], roughness, packed);
+
+				std::uint8_t packedValue[Image::sNumChannels];
+				if (detectUniform && UniformTexture::Detect(packed, 0x7U, settings.mUniformTolerance, packedValue)) {
+					EmitValue(emitter, sPackedValueKey, packedValue);
+					++result.mNumUniform;
+				}
+				else {
+					const std::string packedContentPath = outputPath + "_smoothness_metal_mask_curvature.dds";
+					if (compress) {
+						if (!WriteCompressed(settings, name, sPackedKey, packed, BlockFormat::BC7, dataMipSettings, packedContentPath, log, result)) {
+							return false;
+						}
+					}
+					else if (!WriteUncompressed(settings, packed, dataMipSettings, packedContentPath, log)) {
+						return false;
+					}
+					EmitEntry(emitter, sPackedKey, packedContentPath);
+				}
+				++result.mNumPacked;
+			}
+			else {
+				if (roughness) {
+					InvertRoughness(scalars[0]);
+				}
+				for (size_t i = 0U; i < 3U; ++i) {
+					if (compress) {
+						const std::string scalarPath = outputPath + sScalarSuffixes[i];
+						if (!WriteCompressed(settings, name, sScalarKeys[i], scalars[i], BlockFormat::BC4, dataMipSettings, scalarPath, log, result)) {
+							return false;
+						}
+						EmitEntry(emitter, sScalarKeys[i], scalarPath);
+					}
+					else if (i == 0U && roughness && readAll) {
+						// Roughness is not in the manifest, so its smoothness is written
+						const std::string smoothnessPath = outputPath + sScalarSuffixes[0];
+						if (!WriteUncompressed(settings, scalars[0], dataMipSettings, smoothnessPath, log)) {
+							return false;
+						}
+						EmitEntry(emitter, sScalarKeys[0], smoothnessPath);
+					}
+					else {
+						// Unpacked fallback
+						EmitEntry(emitter, sScalarKeys[i], GetString(node, sScalarKeys[i]));
+					}
+				}
+				++result.mNumUnpacked;
+			}
+			emitter << YAML::EndMap;
+		}
+		emitter << YAML::EndSeq << YAML::EndMap;
+
+		std::ofstream stream(FileUtils::NativePath(settings.mRootDirectory, manifestFilepath), std::ios::out | std::ios::trunc);
+		if (!stream.is_open()) {
+			log << manifestFilepath << ": file could not be created" << std::endl;
+			return false;
+		}
+		stream << emitter.c_str() << "\n";
+		if (!stream.good()) {
+			return false;
+		}
+
+		bool quality = true;
+		for (const CompressedTexture& texture : result.mCompressedTextures) {
+			if (texture.mPsnr < settings.mMinPsnr) {
+				log << texture.mMaterial << ": " << texture.mTexture << " PSNR " << texture.mPsnr << " dB is below " << settings.mMinPsnr << " dB" << std::endl;
+				quality = false;
+			}
+		}
+
+		return quality;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include <textures/BlockCompression.h>
+#include <textures/Image.h>
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Offline material cooker.
+// Smoothness, metal mask and curvature are scalars, but each one is
+// authored in its own texture. The cooker packs them in the R, G and B
+// channels of a single texture and writes a materials manifest (same
+// layout as materials.yml) where packed materials have a
+// smoothnessMetalMaskCurvature entry instead of the three scalar ones.
+// Materials whose textures cannot be read are copied unpacked, so the
+// manifest always describes every input material. Sampler entries are
+// copied as they are.
+// A material can give a roughness texture instead of the smoothness one.
+// It is inverted (smoothness = 1 - roughness) when it is cooked, so the
+// manifest only has smoothness.
+// When compression is enabled, every texture of a material is written
+// block compressed with its mip chain: BC5 for normals (the pixel shaders
+// reconstruct Z), BC1 or BC7 for base color, BC7 for the packed texture
+// and BC4 for scalars that are not packed. The PSNR of the top level of
+// each compressed texture is reported.
+// Uniform textures of packed materials (see UniformTexture) are not
+// written. Base color and packed ones become baseColorValue and
+// smoothnessMetalMaskCurvatureValue entries (normalized R, G and B) that
+// the renderer binds as material constants. Uniform normal maps are
+// shrunk to a single 4x4 block.
+//
+//////////////////////////////////////////////////////////////////////////
+
+namespace BRE {
+	class MaterialCooker {
+	public:
+		struct Settings {
+			// Directory content paths are relative to (application directory)
+			std::string mRootDirectory = ".";
+			// Content path where cooked textures are written
+			std::string mOutputDirectory = "content\\cookedMaterials";
+			bool mPack = true;
+			bool mCompress = true;
+			// BC1 or BC7
+			BlockFormat mBaseColorFormat = BlockFormat::BC1;
+			// Cooking fails if a compressed texture has a lower PSNR (dB)
+			double mMinPsnr = 0.0;
+			// Replace uniform textures of packed materials by constants
+			bool mDetectUniform = true;
+			// Largest difference between texel values (0..255) of a uniform texture
+			unsigned int mUniformTolerance = 2U;
+		};
+
+		struct CompressedTexture {
+			std::string mMaterial;
+			std::string mTexture;
+			BlockFormat mFormat;
+			unsigned int mWidth;
+			unsigned int mHeight;
+			double mPsnr;
+		};
+
+		struct Result {
+			size_t mNumPacked;
+			size_t mNumUnpacked;
+			size_t mNumCompressed;
+			// Textures replaced by constants or shrunk because they are uniform
+			size_t mNumUniform;
+			std::vector<CompressedTexture> mCompressedTextures;
+		};
+
+		// Inputs are resized to the largest dimensions of the three. Only
+		// the R channel of each input is used. Alpha is set to 255.
+		// If smoothnessIsRoughness, smoothness holds roughness and it is inverted.
+		static void PackSmoothnessMetalMaskCurvature(const Image& smoothness, const Image& metalMask, const Image& curvature, const bool smoothnessIsRoughness, Image& result);
+
+		// materialsFilepath and manifestFilepath are content paths.
+		// Returns false if the materials file cannot be parsed, an output
+		// file cannot be written or a compressed texture is below the
+		// minimum PSNR. Progress and warnings go to log.
+		static bool Cook(const Settings& settings, const std::string& materialsFilepath, const std::string& manifestFilepath, std::ostream& log, Result& result);
+	};
+}
\ No newline at end of file
@@ -0,0 +1,195 @@
+#include "SceneGenerator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <limits>
+#include <random>
+
+namespace {
+	// std::uniform_real_distribution output is implementation defined,
+	// so floats are built from the raw (fully specified) mt19937 output.
+	class Random {
+	public:
+		explicit Random(const std::uint32_t seed)
+			: mEngine(seed)
+		{
+		}
+
+		float Float(const float min, const float max) {
+			const float unit = (mEngine() >> 8U) * (1.0f / 16777216.0f);
+			return min + (max - min) * unit;
+		}
+
+		size_t Index(const size_t count) {
+			return static_cast<size_t>(mEngine() % count);
+		}
+
+	private:
+		std::mt19937 mEngine;
+	};
+
+	const char* sRenderTypes[] = { "Basic", "Normal", "Normal_Displacement" };
+
+	void WriteEscaped(std::ostream& stream, const std::string& str) {
+		stream << '"';
+		for (const char c : str) {
+			if (c == '\\' || c == '"') {
+				stream << '\\';
+			}
+			stream << c;
+		}
+		stream << '"';
+	}
+
+	std::string MaterialName(const size_t index) {
+		return "generated_material_" + std::to_string(index);
+	}
+
+	std::string TexturePath(const std::string& textureSet, const char* suffix) {
+		return "content\\materials\\" + textureSet + "\\" + textureSet + "_" + suffix + ".dds";
+	}
+
+	// Enough digits to read every float back to the same value
+	void SetFloatPrecision(std::ostream& stream) {
+		stream.precision(std::numeric_limits<float>::max_digits10);
+	}
+}
+
+namespace BRE {
+	SceneGenerator::Settings SceneGenerator::DefaultSettings() {
+		Settings settings;
+		settings.mMeshes = {
+			"content\\models\\cylinder.obj",
+			"content\\models\\plane.obj",
+			"content\\models\\sphere.obj",
+			"content\\models\\teapot.obj",
+			"content\\models\\torusKnot.obj",
+		};
+		settings.mTextureSets = {
+			"bronze", "concrete1", "copper", "gold", "iron",
+			"muddy_dirt", "rock1", "silver", "stone1", "titanium",
+		};
+		return settings;
+	}
+
+	bool SceneGenerator::Generate(const Settings& settings, const std::string& modelsFilepath, const std::string& materialsFilepath, const std::string& lightsFilepath, Result& result) {
+		if (settings.mMeshes.empty() || settings.mTextureSets.empty() || settings.mNumMaterials == 0U) {
+			return false;
+		}
+		if (std::find(std::begin(sRenderTypes), std::end(sRenderTypes), settings.mRenderType) == std::end(sRenderTypes)) {
+			return false;
+		}
+		if (settings.mMinTessellationFactor < 1.0f || settings.mMinTessellationFactor > settings.mMaxTessellationFactor) {
+			return false;
+		}
+		const bool textureScaled = settings.mRenderType != "Basic";
+		const bool displaced = settings.mRenderType == "Normal_Displacement";
+
+		Random random(settings.mSeed);
+
+		// Materials. Texture sets are shared, so a material only costs its entry in MaterialManager.
+		{
+			std::ofstream stream(materialsFilepath, std::ios::out | std::ios::trunc);
+			if (!stream.is_open()) {
+				return false;
+			}
+			stream << "materials:\n";
+			for (size_t i = 0U; i < settings.mNumMaterials; ++i) {
+				const std::string& textureSet = settings.mTextureSets[i % settings.mTextureSets.size()];
+				stream << "  - name: ";
+				WriteEscaped(stream, MaterialName(i));
+				stream << "\n    normal: ";
+				WriteEscaped(stream, TexturePath(textureSet, "normal"));
+				stream << "\n    baseColor: ";
+				WriteEscaped(stream, TexturePath(textureSet, "base_color"));
+				stream << "\n    smoothness: ";
+				WriteEscaped(stream, TexturePath(textureSet, "smoothness"));
+				stream << "\n    metalMask: ";
+				WriteEscaped(stream, TexturePath(textureSet, "metal_mask"));
+				stream << "\n    curvature: ";
+				WriteEscaped(stream, TexturePath(textureSet, "curvature"));
+				stream << "\n";
+			}
+			if (!stream.good()) {
+				return false;
+			}
+		}
+
+		// Models
+		const float reuseRatio = std::min(std::max(settings.mMeshReuseRatio, 0.0f), 1.0f);
+		const size_t requestedMeshes = static_cast<size_t>(std::round(settings.mNumObjects * (1.0f - reuseRatio)));
+		const size_t numDistinctMeshes = std::max<size_t>(1U, std::min(requestedMeshes, settings.mMeshes.size()));
+		{
+			std::ofstream stream(modelsFilepath, std::ios::out | std::ios::trunc);
+			if (!stream.is_open()) {
+				return false;
+			}
+			SetFloatPrecision(stream);
+			stream << "models:\n";
+			for (size_t i = 0U; i < settings.mNumObjects; ++i) {
+				// First objects introduce every distinct mesh, the rest reuse them
+				const size_t meshIndex = i < numDistinctMeshes ? i : random.Index(numDistinctMeshes);
+				const float x = random.Float(-settings.mExtent, settings.mExtent);
+				const float z = random.Float(-settings.mExtent, settings.mExtent);
+				const float yaw = random.Float(0.0f, 6.2831853f);
+				const float scale = random.Float(settings.mMinScale, settings.mMaxScale);
+				const size_t materialIndex = random.Index(settings.mNumMaterials);
+
+				stream << "  - renderType: " << settings.mRenderType << "\n    path: ";
+				WriteEscaped(stream, settings.mMeshes[meshIndex]);
+				stream << "\n    translation: [" << x << ", 0.0, " << z << "]";
+				stream << "\n    rotation: [0.0, " << yaw << ", 0.0]";
+				stream << "\n    scaling: [" << scale << ", " << scale << ", " << scale << "]";
+				stream << "\n    material: ";
+				WriteEscaped(stream, MaterialName(materialIndex));
+				if (textureScaled) {
+					stream << "\n    textureScaleFactor: " << settings.mTextureScaleFactor;
+				}
+				if (displaced) {
+					stream << "\n    displacementMapTexture: ";
+					WriteEscaped(stream, TexturePath(settings.mTextureSets[materialIndex % settings.mTextureSets.size()], "height"));
+					stream << "\n    displacementScale: " << settings.mDisplacementScale;
+					stream << "\n    minTessellationFactor: " << settings.mMinTessellationFactor;
+					stream << "\n    maxTessellationFactor: " << settings.mMaxTessellationFactor;
+				}
+				stream << "\n";
+			}
+			if (!stream.good()) {
+				return false;
+			}
+		}
+
+		// Point lights
+		{
+			std::ofstream stream(lightsFilepath, std::ios::out | std::ios::trunc);
+			if (!stream.is_open()) {
+				return false;
+			}
+			SetFloatPrecision(stream);
+			stream << "pointLights:\n";
+			for (size_t i = 0U; i < settings.mNumLights; ++i) {
+				const float x = random.Float(-settings.mExtent, settings.mExtent);
+				const float y = random.Float(0.0f, settings.mMaxLightRadius);
+				const float z = random.Float(-settings.mExtent, settings.mExtent);
+				const float radius = random.Float(settings.mMinLightRadius, settings.mMaxLightRadius);
+				const float r = random.Float(0.2f, 1.0f);
+				const float g = random.Float(0.2f, 1.0f);
+				const float b = random.Float(0.2f, 1.0f);
+				stream << "  - position: [" << x << ", " << y << ", " << z << "]";
+				stream << "\n    radius: " << radius;
+				stream << "\n    color: [" << r << ", " << g << ", " << b << "]";
+				stream << "\n    power: " << settings.mLightPower << "\n";
+			}
+			if (!stream.good()) {
+				return false;
+			}
+		}
+
+		result.mNumDistinctMeshes = numDistinctMeshes;
+		result.mNumMaterials = settings.mNumMaterials;
+		result.mNumObjects = settings.mNumObjects;
+		result.mNumLights = settings.mNumLights;
+		return true;
+	}
+}
\ No newline at end of file
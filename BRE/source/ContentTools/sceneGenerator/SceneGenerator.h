@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Synthetic scene generator.
+// It writes models.yml, materials.yml and lights.yml files that
+// DrawManager, MaterialManager and Scene load, with a given number of
+// objects, materials and point lights. Models have every key their render
+// type needs (see DrawerSettings). Output only depends on the settings
+// (seed included), so the same settings always produce the same scene on
+// every platform. Floats are written with enough digits to be read back
+// exactly.
+//
+//////////////////////////////////////////////////////////////////////////
+
+namespace BRE {
+	class SceneGenerator {
+	public:
+		struct Settings {
+			std::uint32_t mSeed = 1U;
+			size_t mNumObjects = 1000U;
+			// Fraction of objects that reuse a mesh of a previous object.
+			// Number of distinct meshes is limited by mMeshes size.
+			float mMeshReuseRatio = 0.9f;
+			size_t mNumMaterials = 10U;
+			size_t mNumLights = 512U;
+			// Objects and lights are placed in [-mExtent, mExtent] in X and Z
+			float mExtent = 5000.0f;
+			float mMinScale = 0.5f;
+			float mMaxScale = 2.0f;
+			float mMinLightRadius = 100.0f;
+			float mMaxLightRadius = 500.0f;
+			float mLightPower = 100000.0f;
+			std::string mRenderType = "Normal";
+			// Normal and Normal_Displacement
+			float mTextureScaleFactor = 1.0f;
+			// Normal_Displacement. The height map of the material texture set is the displacement map.
+			float mDisplacementScale = 5.0f;
+			float mMinTessellationFactor = 1.0f;
+			float mMaxTessellationFactor = 16.0f;
+			std::vector<std::string> mMeshes;
+			// Texture sets of existing materials (content\materials\<name>\<name>_*.dds)
+			std::vector<std::string> mTextureSets;
+		};
+
+		struct Result {
+			size_t mNumDistinctMeshes;
+			size_t mNumMaterials;
+			size_t mNumObjects;
+			size_t mNumLights;
+		};
+
+		static Settings DefaultSettings();
+
+		// Returns false if a file could not be written
+		static bool Generate(const Settings& settings, const std::string& modelsFilepath, const std::string& materialsFilepath, const std::string& lightsFilepath, Result& result);
+	};
+}
\ No newline at end of file
@@ -0,0 +1,212 @@
+#include "ShaderArchiver.h"
+
+#include <fstream>
+#include <unordered_map>
+#include <vector>
+
+#include <common/FileUtils.h>
+#include <utils/ShaderArchive.h>
+#include <yaml-cpp/yaml.h>
+
+namespace {
+	struct NamedValue {
+		const char* mName;
+		std::uint32_t mValue;
+	};
+
+	// DXGI_FORMAT values of vertex formats. ContentTools does not depend on DXGI.
+	const NamedValue sFormats[] = {
+		{ "R32G32B32A32_FLOAT", 2U },
+		{ "R32G32B32A32_UINT", 3U },
+		{ "R32G32B32A32_SINT", 4U },
+		{ "R32G32B32_FLOAT", 6U },
+		{ "R32G32B32_UINT", 7U },
+		{ "R32G32B32_SINT", 8U },
+		{ "R16G16B16A16_FLOAT", 10U },
+		{ "R16G16B16A16_UNORM", 11U },
+		{ "R16G16B16A16_SNORM", 13U },
+		{ "R32G32_FLOAT", 16U },
+		{ "R32G32_UINT", 17U },
+		{ "R32G32_SINT", 18U },
+		{ "R10G10B10A2_UNORM", 24U },
+		{ "R8G8B8A8_UNORM", 28U },
+		{ "R8G8B8A8_UINT", 30U },
+		{ "R8G8B8A8_SNORM", 31U },
+		{ "R16G16_FLOAT", 34U },
+		{ "R16G16_UNORM", 35U },
+		{ "R16G16_SNORM", 37U },
+		{ "R32_FLOAT", 41U },
+		{ "R32_UINT", 42U },
+		{ "R32_SINT", 43U },
+	};
+
+	const NamedValue sShaderTypes[] = {
+		{ "vertex", static_cast<std::uint32_t>(BRE::ShaderArchive::ShaderType::Vertex) },
+		{ "hull", static_cast<std::uint32_t>(BRE::ShaderArchive::ShaderType::Hull) },
+		{ "domain", static_cast<std::uint32_t>(BRE::ShaderArchive::ShaderType::Domain) },
+		{ "geometry", static_cast<std::uint32_t>(BRE::ShaderArchive::ShaderType::Geometry) },
+		{ "pixel", static_cast<std::uint32_t>(BRE::ShaderArchive::ShaderType::Pixel) },
+		{ "compute", static_cast<std::uint32_t>(BRE::ShaderArchive::ShaderType::Compute) },
+	};
+
+	template<size_t N>
+	bool FindValue(const NamedValue (&values)[N], const std::string& name, std::uint32_t& value) {
+		for (const NamedValue& namedValue : values) {
+			if (name == namedValue.mName) {
+				value = namedValue.mValue;
+				return true;
+			}
+		}
+		return false;
+	}
+
+	bool ReadInputElement(const YAML::Node& node, BRE::ShaderArchive::InputElementDesc& element, std::string& error) {
+		if (!node.IsMap() || !node["semantic"].IsDefined() || !node["format"].IsDefined()) {
+			error = "input elements need semantic and format entries";
+			return false;
+		}
+		element.mSemanticName = node["semantic"].as<std::string>();
+		const std::string format = node["format"].as<std::string>();
+		if (!BRE::ShaderArchiver::FormatFromName(format, element.mFormat)) {
+			error = "unknown format " + format;
+			return false;
+		}
+		if (node["index"].IsDefined()) element.mSemanticIndex = node["index"].as<std::uint32_t>();
+		if (node["slot"].IsDefined()) element.mInputSlot = node["slot"].as<std::uint32_t>();
+		if (node["offset"].IsDefined()) element.mAlignedByteOffset = node["offset"].as<std::uint32_t>();
+		if (node["stepRate"].IsDefined()) {
+			element.mInputSlotClass = 1U;
+			element.mInstanceDataStepRate = node["stepRate"].as<std::uint32_t>();
+		}
+		return true;
+	}
+
+	bool SameInputLayout(const std::vector<BRE::ShaderArchive::InputElementDesc>& a, const std::vector<BRE::ShaderArchive::InputElementDesc>& b) {
+		if (a.size() != b.size()) {
+			return false;
+		}
+		for (size_t i = 0U; i < a.size(); ++i) {
+			if (a[i].mSemanticName != b[i].mSemanticName || a[i].mSemanticIndex != b[i].mSemanticIndex || a[i].mFormat != b[i].mFormat || a[i].mInputSlot != b[i].mInputSlot
+				|| a[i].mAlignedByteOffset != b[i].mAlignedByteOffset || a[i].mInputSlotClass != b[i].mInputSlotClass || a[i].mInstanceDataStepRate != b[i].mInstanceDataStepRate) {
+				return false;
+			}
+		}
+		return true;
+	}
+}
+
+namespace BRE {
+	bool ShaderArchiver::FormatFromName(const std::string& name, std::uint32_t& format) {
+		return FindValue(sFormats, name, format);
+	}
+
+	bool ShaderArchiver::Build(const Settings& settings, const std::string& manifestFilepath, const std::string& archiveFilepath, std::ostream& log, Result& result) {
+		result.mNumRenderTypes = 0U;
+		result.mNumShaders = 0U;
+		result.mArchiveBytes = 0U;
+
+		YAML::Node yamlFile;
+		try {
+			yamlFile = YAML::LoadFile(FileUtils::NativePath(settings.mRootDirectory, manifestFilepath));
+		}
+		catch (const YAML::Exception& e) {
+			log << manifestFilepath << ": " << e.what() << std::endl;
+			return false;
+		}
+		const YAML::Node renderTypeNodes = yamlFile["renderTypes"];
+		if (!renderTypeNodes.IsDefined() || !renderTypeNodes.IsSequence()) {
+			log << manifestFilepath << ": renderTypes sequence not found" << std::endl;
+			return false;
+		}
+
+		std::vector<ShaderArchive::ShaderDesc> shaders;
+		std::vector<ShaderArchive::RenderTypeDesc> renderTypes;
+		std::unordered_map<std::string, size_t> shaderByPath;
+		try {
+			for (const YAML::Node& renderTypeNode : renderTypeNodes) {
+				const YAML::Node shaderNodes = renderTypeNode["shaders"];
+				if (!renderTypeNode["name"].IsDefined() || !shaderNodes.IsDefined() || !shaderNodes.IsSequence()) {
+					log << manifestFilepath << ": render types need name and shaders entries" << std::endl;
+					return false;
+				}
+				ShaderArchive::RenderTypeDesc renderType;
+				renderType.mName = renderTypeNode["name"].as<std::string>();
+
+				for (const YAML::Node& shaderNode : shaderNodes) {
+					if (!shaderNode["path"].IsDefined() || !shaderNode["type"].IsDefined()) {
+						log << renderType.mName << ": shaders need path and type entries" << std::endl;
+						return false;
+					}
+					ShaderArchive::ShaderDesc shader;
+					shader.mName = shaderNode["path"].as<std::string>();
+					const std::string type = shaderNode["type"].as<std::string>();
+					std::uint32_t typeValue;
+					if (!FindValue(sShaderTypes, type, typeValue)) {
+						log << shader.mName << ": unknown shader type " << type << std::endl;
+						return false;
+					}
+					shader.mType = static_cast<ShaderArchive::ShaderType>(typeValue);
+					const YAML::Node inputLayoutNode = shaderNode["inputLayout"];
+					if (inputLayoutNode.IsDefined()) {
+						for (const YAML::Node& elementNode : inputLayoutNode) {
+							ShaderArchive::InputElementDesc element;
+							std::string error;
+							if (!ReadInputElement(elementNode, element, error)) {
+								log << shader.mName << ": " << error << std::endl;
+								return false;
+							}
+							shader.mInputLayout.push_back(element);
+						}
+					}
+
+					const std::unordered_map<std::string, size_t>::const_iterator findIt = shaderByPath.find(shader.mName);
+					if (findIt != shaderByPath.end()) {
+						const ShaderArchive::ShaderDesc& stored = shaders[findIt->second];
+						if (stored.mType != shader.mType || !SameInputLayout(stored.mInputLayout, shader.mInputLayout)) {
+							log << shader.mName << ": listed with different types or input layouts" << std::endl;
+							return false;
+						}
+						renderType.mShaders.push_back(findIt->second);
+						continue;
+					}
+					if (!FileUtils::ReadFile(FileUtils::NativePath(settings.mRootDirectory, shader.mName), shader.mByteCode)) {
+						log << shader.mName << ": cannot be read" << std::endl;
+						return false;
+					}
+					shaderByPath[shader.mName] = shaders.size();
+					renderType.mShaders.push_back(shaders.size());
+					shaders.push_back(shader);
+				}
+				renderTypes.push_back(renderType);
+			}
+		}
+		catch (const YAML::Exception& e) {
+			log << manifestFilepath << ": " << e.what() << std::endl;
+			return false;
+		}
+
+		std::vector<std::uint8_t> archive;
+		std::string error;
+		if (!ShaderArchive::Build(shaders, renderTypes, archive, error)) {
+			log << manifestFilepath << ": " << error << std::endl;
+			return false;
+		}
+
+		const std::string nativeArchivePath = FileUtils::NativePath(settings.mRootDirectory, archiveFilepath);
+		const std::string archiveDirectory = FileUtils::Directory(nativeArchivePath);
+		if (!archiveDirectory.empty() && !FileUtils::CreateDirectories(archiveDirectory)) {
+			log << archiveFilepath << ": directory cannot be created" << std::endl;
+			return false;
+		}
+		std::ofstream stream(nativeArchivePath, std::ios::out | std::ios::binary | std::ios::trunc);
+		if (!stream.is_open() || !stream.write(reinterpret_cast<const char*>(archive.data()), static_cast<std::streamsize>(archive.size()))) {
+			log << archiveFilepath << ": cannot be written" << std::endl;
+			return false;
+		}
+
+		result.mNumRenderTypes = renderTypes.size();
+		result.mNumShaders = shaders.size();
+		result.mArchiveBytes = archive.size();
+		return true;
+	}
+}
\ No newline at end of file
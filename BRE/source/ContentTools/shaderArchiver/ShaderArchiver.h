@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Offline shader archiver.
+// It reads a shaders manifest (content\configs\shaders.yml) that lists the
+// compiled shaders (.cso) of each render type, with the input layout of
+// vertex shaders, and writes every one of them in a single shader archive
+// (see ShaderArchive in RenderingLib). Shaders shared by several render
+// types are stored once, and their input layouts must be the same.
+// Shader paths must be written as drawers load them, because the renderer
+// finds archive shaders by the hash of that path.
+//
+//////////////////////////////////////////////////////////////////////////
+
+namespace BRE {
+	class ShaderArchiver {
+	public:
+		struct Settings {
+			// Directory content paths are relative to (application directory)
+			std::string mRootDirectory = ".";
+		};
+
+		struct Result {
+			size_t mNumRenderTypes;
+			size_t mNumShaders;
+			std::uint64_t mArchiveBytes;
+		};
+
+		// DXGI_FORMAT value of a format name without its prefix (R32G32B32_FLOAT, for example)
+		static bool FormatFromName(const std::string& name, std::uint32_t& format);
+
+		// manifestFilepath and archiveFilepath are content paths. Returns false if
+		// the manifest is invalid, a shader cannot be read or the archive cannot
+		// be written. Errors go to log.
+		static bool Build(const Settings& settings, const std::string& manifestFilepath, const std::string& archiveFilepath, std::ostream& log, Result& result);
+	};
+}
\ No newline at end of file
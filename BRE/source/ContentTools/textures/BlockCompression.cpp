@@ -0,0 +1,800 @@
+#include "BlockCompression.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#if defined(_M_X64) || defined(__SSE2__)
+#define BRE_BLOCK_COMPRESSION_SSE2
+#include <emmintrin.h>
+#endif
+
+#include <common/ParallelFor.h>
+#include <utils/Assert.h>
+
+namespace {
+	using BRE::BlockFormat;
+	using BRE::BlockCompression::sTexelsPerBlock;
+
+	const std::uint32_t sFormatBC1Unorm = 71U;
+	const std::uint32_t sFormatBC4Unorm = 80U;
+	const std::uint32_t sFormatBC5Unorm = 83U;
+	const std::uint32_t sFormatBC7Unorm = 98U;
+
+	// Texels of a block as floats. Only the first numChannels are used.
+	typedef float BlockPoints[sTexelsPerBlock][4];
+
+	std::uint8_t ClampToByte(const float value) {
+		return static_cast<std::uint8_t>(std::min(255.0f, std::max(0.0f, value + 0.5f)));
+	}
+
+	//////////////////////////////////////////////////////////////////////////
+	// Endpoint fitting shared by BC1 and BC7
+	//////////////////////////////////////////////////////////////////////////
+
+	// Extremes of the points projected on their principal axis (power iteration).
+	void PrincipalEndpoints(const BlockPoints& points, const unsigned int numChannels, float e0[4], float e1[4]) {
+		float mean[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+		float minimum[4] = { 255.0f, 255.0f, 255.0f, 255.0f };
+		float maximum[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+		for (unsigned int i = 0U; i < sTexelsPerBlock; ++i) {
+			for (unsigned int c = 0U; c < numChannels; ++c) {
+				mean[c] += points[i][c];
+				minimum[c] = std::min(minimum[c], points[i][c]);
+				maximum[c] = std::max(maximum[c], points[i][c]);
+			}
+		}
+		for (unsigned int c = 0U; c < numChannels; ++c) {
+			mean[c] /= sTexelsPerBlock;
+		}
+
+		float covariance[4][4] = {};
+		for (unsigned int i = 0U; i < sTexelsPerBlock; ++i) {
+			for (unsigned int r = 0U; r < numChannels; ++r) {
+				for (unsigned int c = 0U; c < numChannels; ++c) {
+					covariance[r][c] += (points[i][r] - mean[r]) * (points[i][c] - mean[c]);
+				}
+			}
+		}
+
+		float axis[4];
+		for (unsigned int c = 0U; c < numChannels; ++c) {
+			axis[c] = maximum[c] - minimum[c];
+		}
+		for (unsigned int iteration = 0U; iteration < 8U; ++iteration) {
+			float next[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+			float length = 0.0f;
+			for (unsigned int r = 0U; r < numChannels; ++r) {
+				for (unsigned int c = 0U; c < numChannels; ++c) {
+					next[r] += covariance[r][c] * axis[c];
+				}
+				length = std::max(length, std::fabs(next[r]));
+			}
+			if (length < 1e-6f) {
+				break;
+			}
+			for (unsigned int c = 0U; c < numChannels; ++c) {
+				axis[c] = next[c] / length;
+			}
+		}
+
+		float length = 0.0f;
+		for (unsigned int c = 0U; c < numChannels; ++c) {
+			length += axis[c] * axis[c];
+		}
+		if (length < 1e-12f) {
+			// Constant block
+			for (unsigned int c = 0U; c < numChannels; ++c) {
+				e0[c] = e1[c] = mean[c];
+			}
+			return;
+		}
+		length = std::sqrt(length);
+
+		float minProjection = std::numeric_limits<float>::max();
+		float maxProjection = -std::numeric_limits<float>::max();
+		for (unsigned int i = 0U; i < sTexelsPerBlock; ++i) {
+			float projection = 0.0f;
+			for (unsigned int c = 0U; c < numChannels; ++c) {
+				projection += (points[i][c] - mean[c]) * axis[c] / length;
+			}
+			minProjection = std::min(minProjection, projection);
+			maxProjection = std::max(maxProjection, projection);
+		}
+		for (unsigned int c = 0U; c < numChannels; ++c) {
+			e0[c] = std::min(255.0f, std::max(0.0f, mean[c] + axis[c] / length * minProjection));
+			e1[c] = std::min(255.0f, std::max(0.0f, mean[c] + axis[c] / length * maxProjection));
+		}
+	}
+
+	// Least squares endpoints given the interpolation factor (0 = e0, 1 = e1)
+	// of each texel. Texels with a negative factor are ignored.
+	bool LeastSquaresEndpoints(const BlockPoints& points, const unsigned int numChannels, const float factors[sTexelsPerBlock], float e0[4], float e1[4]) {
+		float aa = 0.0f;
+		float ab = 0.0f;
+		float bb = 0.0f;
+		float av[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+		float bv[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+		for (unsigned int i = 0U; i < sTexelsPerBlock; ++i) {
+			const float t = factors[i];
+			if (t < 0.0f) {
+				continue;
+			}
+			const float s = 1.0f - t;
+			aa += s * s;
+			ab += s * t;
+			bb += t * t;
+			for (unsigned int c = 0U; c < numChannels; ++c) {
+				av[c] += s * points[i][c];
+				bv[c] += t * points[i][c];
+			}
+		}
+
+		const float determinant = aa * bb - ab * ab;
+		if (std::fabs(determinant) < 1e-6f) {
+			return false;
+		}
+		for (unsigned int c = 0U; c < numChannels; ++c) {
+			e0[c] = std::min(255.0f, std::max(0.0f, (av[c] * bb - bv[c] * ab) / determinant));
+			e1[c] = std::min(255.0f, std::max(0.0f, (bv[c] * aa - av[c] * ab) / determinant));
+		}
+		return true;
+	}
+
+	//////////////////////////////////////////////////////////////////////////
+	// BC4
+	//////////////////////////////////////////////////////////////////////////
+
+	void Bc4Palette(const std::uint8_t e0, const std::uint8_t e1, std::uint8_t palette[8]) {
+		palette[0] = e0;
+		palette[1] = e1;
+		if (e0 > e1) {
+			for (unsigned int i = 1U; i < 7U; ++i) {
+				palette[i + 1U] = static_cast<std::uint8_t>(((7U - i) * e0 + i * e1 + 3U) / 7U);
+			}
+		}
+		else {
+			for (unsigned int i = 1U; i < 5U; ++i) {
+				palette[i + 1U] = static_cast<std::uint8_t>(((5U - i) * e0 + i * e1 + 2U) / 5U);
+			}
+			palette[6] = 0U;
+			palette[7] = 255U;
+		}
+	}
+
+	// Nearest palette entry of each value (lowest index on ties).
+	// Returns the sum of squared errors.
+	std::uint32_t Bc4FindIndices(const std::uint8_t values[sTexelsPerBlock], const std::uint8_t palette[8], std::uint8_t indices[sTexelsPerBlock]) {
+#ifdef BRE_BLOCK_COMPRESSION_SSE2
+		const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values));
+		__m128i bestDistance = _mm_set1_epi8(static_cast<char>(0xFF));
+		__m128i bestIndex = _mm_setzero_si128();
+		for (unsigned int i = 0U; i < 8U; ++i) {
+			const __m128i p = _mm_set1_epi8(static_cast<char>(palette[i]));
+			const __m128i distance = _mm_or_si128(_mm_subs_epu8(v, p), _mm_subs_epu8(p, v));
+			// distance < bestDistance <=> max(distance, bestDistance) != distance
+			const __m128i notLess = _mm_cmpeq_epi8(_mm_max_epu8(distance, bestDistance), distance);
+			const __m128i index = _mm_set1_epi8(static_cast<char>(i));
+			bestIndex = _mm_or_si128(_mm_and_si128(notLess, bestIndex), _mm_andnot_si128(notLess, index));
+			bestDistance = _mm_min_epu8(distance, bestDistance);
+		}
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(indices), bestIndex);
+
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i low = _mm_unpacklo_epi8(bestDistance, zero);
+		const __m128i high = _mm_unpackhi_epi8(bestDistance, zero);
+		__m128i sum = _mm_add_epi32(_mm_madd_epi16(low, low), _mm_madd_epi16(high, high));
+		sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+		sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+		return static_cast<std::uint32_t>(_mm_cvtsi128_si32(sum));
+#else
+		std::uint32_t error = 0U;
+		for (unsigned int t = 0U; t < sTexelsPerBlock; ++t) {
+			unsigned int bestDistance = 256U;
+			for (unsigned int i = 0U; i < 8U; ++i) {
+				const unsigned int distance = static_cast<unsigned int>(std::abs(static_cast<int>(values[t]) - static_cast<int>(palette[i])));
+				if (distance < bestDistance) {
+					bestDistance = distance;
+					indices[t] = static_cast<std::uint8_t>(i);
+				}
+			}
+			error += bestDistance * bestDistance;
+		}
+		return error;
+#endif
+	}
+
+	struct Bc4Candidate {
+		std::uint8_t mEndpoints[2];
+		std::uint8_t mIndices[sTexelsPerBlock];
+		std::uint32_t mError;
+	};
+
+	void Bc4Evaluate(const std::uint8_t values[sTexelsPerBlock], const std::uint8_t e0, const std::uint8_t e1, Bc4Candidate& best) {
+		Bc4Candidate candidate;
+		candidate.mEndpoints[0] = e0;
+		candidate.mEndpoints[1] = e1;
+		std::uint8_t palette[8];
+		Bc4Palette(e0, e1, palette);
+		candidate.mError = Bc4FindIndices(values, palette, candidate.mIndices);
+		if (candidate.mError < best.mError) {
+			best = candidate;
+		}
+	}
+
+	// Least squares refinement that keeps the mode of the candidate
+	void Bc4Refine(const std::uint8_t values[sTexelsPerBlock], Bc4Candidate& best) {
+		const bool eightValues = best.mEndpoints[0] > best.mEndpoints[1];
+		for (unsigned int iteration = 0U; iteration < 2U; ++iteration) {
+			BlockPoints points;
+			float factors[sTexelsPerBlock];
+			for (unsigned int i = 0U; i < sTexelsPerBlock; ++i) {
+				points[i][0] = values[i];
+				const std::uint8_t index = best.mIndices[i];
+				if (index < 2U) {
+					factors[i] = static_cast<float>(index);
+				}
+				else if (eightValues) {
+					factors[i] = (index - 1U) / 7.0f;
+				}
+				else {
+					factors[i] = index < 6U ? (index - 1U) / 5.0f : -1.0f;
+				}
+			}
+
+			float e0;
+			float e1;
+			if (!LeastSquaresEndpoints(points, 1U, factors, &e0, &e1)) {
+				return;
+			}
+			const std::uint8_t q0 = ClampToByte(e0);
+			const std::uint8_t q1 = ClampToByte(e1);
+			if ((q0 > q1) != eightValues || (q0 == best.mEndpoints[0] && q1 == best.mEndpoints[1])) {
+				return;
+			}
+			Bc4Evaluate(values, q0, q1, best);
+		}
+	}
+
+	void EncodeBc4(const std::uint8_t* texels, const unsigned int channel, std::uint8_t* block) {
+		std::uint8_t values[sTexelsPerBlock];
+		std::uint8_t minimum = 255U;
+		std::uint8_t maximum = 0U;
+		std::uint8_t innerMinimum = 255U;
+		std::uint8_t innerMaximum = 0U;
+		for (unsigned int i = 0U; i < sTexelsPerBlock; ++i) {
+			const std::uint8_t value = texels[i * BRE::Image::sNumChannels + channel];
+			values[i] = value;
+			minimum = std::min(minimum, value);
+			maximum = std::max(maximum, value);
+			if (value != 0U && value != 255U) {
+				innerMinimum = std::min(innerMinimum, value);
+				innerMaximum = std::max(innerMaximum, value);
+			}
+		}
+
+		Bc4Candidate best;
+		best.mError = std::numeric_limits<std::uint32_t>::max();
+		if (minimum == maximum) {
+			Bc4Evaluate(values, minimum, maximum, best);
+		}
+		else {
+			// 8 interpolated values (e0 > e1)
+			Bc4Evaluate(values, maximum, minimum, best);
+			Bc4Refine(values, best);
+
+			// 6 interpolated values plus 0 and 255 (e0 <= e1)
+			if (best.mError != 0U) {
+				Bc4Candidate sixValues;
+				sixValues.mError = std::numeric_limits<std::uint32_t>::max();
+				if (innerMinimum > innerMaximum) {
+					innerMinimum = 0U;
+					innerMaximum = 255U;
+				}
+				Bc4Evaluate(values, innerMinimum, innerMaximum, sixValues);
+				Bc4Refine(values, sixValues);
+				if (sixValues.mError < best.mError) {
+					best = sixValues;
+				}
+			}
+		}
+
+		block[0] = best.mEndpoints[0];
+		block[1] = best.mEndpoints[1];
+		std::uint64_t bits = 0U;
+		for (unsigned int i = 0U; i < sTexelsPerBlock; ++i) {
+			bits |= static_cast<std::uint64_t>(best.mIndices[i]) << (i * 3U);
+		}
+		for (unsigned int i = 0U; i < 6U; ++i) {
+			block[2U + i] = static_cast<std::uint8_t>(bits >> (i * 8U));
+		}
+	}
+
+	void DecodeBc4(const std::uint8_t* block, const unsigned int channel, std::uint8_t* texels) {
+		std::uint8_t palette[8];
+		Bc4Palette(block[0], block[1], palette);
+		std::uint64_t bits = 0U;
+		for (unsigned int i = 0U; i < 6U; ++i) {
+			bits |= static_cast<std::uint64_t>(block[2U + i]) << (i * 8U);
+		}
+		for (unsigned int i = 0U; i < sTexelsPerBlock; ++i) {
+			texels[i * BRE::Image::sNumChannels + channel] = palette[(bits >> (i * 3U)) & 0x7U];
+		}
+	}
+
+	//////////////////////////////////////////////////////////////////////////
+	// BC1
+	//////////////////////////////////////////////////////////////////////////
+
+	std::uint16_t PackRgb565(const float color[3]) {
+		const unsigned int r = static_cast<unsigned int>(std::min(31.0f, std::max(0.0f, color[0] * 31.0f / 255.0f + 0.5f)));
+		const unsigned int g = static_cast<unsigned int>(std::min(63.0f, std::max(0.0f, color[1] * 63.0f / 255.0f + 0.5f)));
+		const unsigned int b = static_cast<unsigned int>(std::min(31.0f, std::max(0.0f, color[2] * 31.0f / 255.0f + 0.5f)));
+		return static_cast<std::uint16_t>((r << 11U) | (g << 5U) | b);
+	}
+
+	void UnpackRgb565(const std::uint16_t color, unsigned int rgb[3]) {
+		const unsigned int r = (color >> 11U) & 0x1FU;
+		const unsigned int g = (color >> 5U) & 0x3FU;
+		const unsigned int b = color & 0x1FU;
+		rgb[0] = (r << 3U) | (r >> 2U);
+		rgb[1] = (g << 2U) | (g >> 4U);
+		rgb[2] = (b << 3U) | (b >> 2U);
+	}
+
+	// Entry 3 of the 3 colors mode is transparent black (alpha in entry [3])
+	void Bc1Palette(const std::uint16_t c0, const std::uint16_t c1, unsigned int palette[4][4]) {
+		UnpackRgb565(c0, palette[0]);
+		UnpackRgb565(c1, palette[1]);
+		for (unsigned int c = 0U; c < 3U; ++c) {
+			if (c0 > c1) {
+				palette[2][c] = (2U * palette[0][c] + palette[1][c] + 1U) / 3U;
+				palette[3][c] = (palette[0][c] + 2U * palette[1][c] + 1U) / 3U;
+			}
+			else {
+				palette[2][c] = (palette[0][c] + palette[1][c] + 1U) / 2U;
+				palette[3][c] = 0U;
+			}
+		}
+		palette[0][3] = palette[1][3] = palette[2][3] = 255U;
+		palette[3][3] = c0 > c1 ? 255U : 0U;
+	}
+
+	struct Bc1Candidate {
+		std::uint16_t mEndpoints[2];
+		std::uint8_t mIndices[sTexelsPerBlock];
+		std::uint32_t mError;
+	};
+
+	// Only the 4 colors mode is used, so c0 > c1 is enforced by swapping
+	void Bc1Evaluate(const BlockPoints& points, std::uint16_t c0, std::uint16_t c1, Bc1Candidate& best) {
+		if (c0 < c1) {
+			std::swap(c0, c1);
+		}
+
+		Bc1Candidate candidate;
+		candidate.mEndpoints[0] = c0;
+		candidate.mEndpoints[1] = c1;
+		candidate.mError = 0U;
+		if (c0 == c1) {
+			unsigned int color[3];
+			UnpackRgb565(c0, color);
+			for (unsigned int i = 0U; i < sTexelsPerBlock; ++i) {
+				candidate.mIndices[i] = 0U;
+				for (unsigned int c = 0U; c < 3U; ++c) {
+					const int difference = static_cast<int>(points[i][c]) - static_cast<int>(color[c]);
+					candidate.mError += static_cast<std::uint32_t>(difference * difference);
+				}
+			}
+		}
+		else {
+			unsigned int palette[4][4];
+			Bc1Palette(c0, c1, palette);
+			for (unsigned int i = 0U; i < sTexelsPerBlock; ++i) {
+				std::uint32_t bestDistance = std::numeric_limits<std::uint32_t>::max();
+				for (unsigned int p = 0U; p < 4U; ++p) {
+					std::uint32_t distance = 0U;
+					for (unsigned int c = 0U; c < 3U; ++c) {
+						const int difference = static_cast<int>(points[i][c]) - static_cast<int>(palette[p][c]);
+						distance += static_cast<std::uint32_t>(difference * difference);
+					}
+					if (distance < bestDistance) {
+						bestDistance = distance;
+						candidate.mIndices[i] = static_cast<std::uint8_t>(p);
+					}
+				}
+				candidate.mError += bestDistance;
+			}
+		}
+
+		if (candidate.mError < best.mError) {
+			best = candidate;
+		}
+	}
+
+	void EncodeBc1(const std::uint8_t* texels, std::uint8_t* block) {
+		BlockPoints points;
+		for (unsigned int i = 0U; i < sTexelsPerBlock; ++i) {
+			for (unsigned int c = 0U; c < 3U; ++c) {
+				points[i][c] = texels[i * BRE::Image::sNumChannels + c];
+			}
+		}
+
+		float e0[4];
+		float e1[4];
+		PrincipalEndpoints(points, 3U, e0, e1);
+
+		Bc1Candidate best;
+		best.mError = std::numeric_limits<std::uint32_t>::max();
+		Bc1Evaluate(points, PackRgb565(e1), PackRgb565(e0), best);
+
+		if (best.mError != 0U && best.mEndpoints[0] != best.mEndpoints[1]) {
+			static const float sFactors[] = { 0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f };
+			float factors[sTexelsPerBlock];
+			for (unsigned int i = 0U; i < sTexelsPerBlock; ++i) {
+				factors[i] = sFactors[best.mIndices[i]];
+			}
+			if (LeastSquaresEndpoints(points, 3U, factors, e0, e1)) {
+				Bc1Evaluate(points, PackRgb565(e0), PackRgb565(e1), best);
+			}
+		}
+
+		block[0] = static_cast<std::uint8_t>(best.mEndpoints[0]);
+		block[1] = static_cast<std::uint8_t>(best.mEndpoints[0] >> 8U);
+		block[2] = static_cast<std::uint8_t>(best.mEndpoints[1]);
+		block[3] = static_cast<std::uint8_t>(best.mEndpoints[1] >> 8U);
+		std::uint32_t bits = 0U;
+		for (unsigned int i = 0U; i < sTexelsPerBlock; ++i) {
+			bits |= static_cast<std::uint32_t>(best.mIndices[i]) << (i * 2U);
+		}
+		for (unsigned int i = 0U; i < 4U; ++i) {
+			block[4U + i] = static_cast<std::uint8_t>(bits >> (i * 8U));
+		}
+	}
+
+	void DecodeBc1(const std::uint8_t* block, std::uint8_t* texels) {
+		const std::uint16_t c0 = static_cast<std::uint16_t>(block[0] | (block[1] << 8U));
+		const std::uint16_t c1 = static_cast<std::uint16_t>(block[2] | (block[3] << 8U));
+		unsigned int palette[4][4];
+		Bc1Palette(c0, c1, palette);
+		const std::uint32_t bits = block[4] | (block[5] << 8U) | (block[6] << 16U) | (static_cast<std::uint32_t>(block[7]) << 24U);
+		for (unsigned int i = 0U; i < sTexelsPerBlock; ++i) {
+			const unsigned int* color = palette[(bits >> (i * 2U)) & 0x3U];
+			for (unsigned int c = 0U; c < 4U; ++c) {
+				texels[i * BRE::Image::sNumChannels + c] = static_cast<std::uint8_t>(color[c]);
+			}
+		}
+	}
+
+	//////////////////////////////////////////////////////////////////////////
+	// BC7 (mode 6: one subset, RGBA 7 bits endpoints with a unique p-bit
+	// per endpoint, 4 bits indices)
+	//////////////////////////////////////////////////////////////////////////
+
+	const unsigned int sBc7Weights[16] = { 0U, 4U, 9U, 13U, 17U, 21U, 26U, 30U, 34U, 38U, 43U, 47U, 51U, 55U, 60U, 64U };
+
+	struct Bc7Candidate {
+		// 7 bits per channel
+		std::uint8_t mEndpoints[2][4];
+		std::uint8_t mPBits[2];
+		std::uint8_t mIndices[sTexelsPerBlock];
+		std::uint32_t mError;
+	};
+
+	void Bc7Palette(const std::uint8_t endpoints[2][4], const std::uint8_t pBits[2], unsigned int palette[16][4]) {
+		for (unsigned int c = 0U; c < 4U; ++c) {
+			const unsigned int e0 = (endpoints[0][c] << 1U) | pBits[0];
+			const unsigned int e1 = (endpoints[1][c] << 1U) | pBits[1];
+			for (unsigned int i = 0U; i < 16U; ++i) {
+				palette[i][c] = ((64U - sBc7Weights[i]) * e0 + sBc7Weights[i] * e1 + 32U) >> 6U;
+			}
+		}
+	}
+
+	// Tries the four p-bit combinations for float endpoints
+	void Bc7Evaluate(const BlockPoints& points, const float e0[4], const float e1[4], Bc7Candidate& best) {
+		const float* endpoints[] = { e0, e1 };
+		for (unsigned int pBits = 0U; pBits < 4U; ++pBits) {
+			Bc7Candidate candidate;
+			candidate.mPBits[0] = static_cast<std::uint8_t>(pBits & 1U);
+			candidate.mPBits[1] = static_cast<std::uint8_t>(pBits >> 1U);
+			for (unsigned int e = 0U; e < 2U; ++e) {
+				for (unsigned int c = 0U; c < 4U; ++c) {
+					const float value = (endpoints[e][c] - candidate.mPBits[e]) * 0.5f;
+					candidate.mEndpoints[e][c] = static_cast<std::uint8_t>(std::min(127.0f, std::max(0.0f, value + 0.5f)));
+				}
+			}
+
+			unsigned int palette[16][4];
+			Bc7Palette(candidate.mEndpoints, candidate.mPBits, palette);
+			candidate.mError = 0U;
+			for (unsigned int i = 0U; i < sTexelsPerBlock && candidate.mError < best.mError; ++i) {
+				std::uint32_t bestDistance = std::numeric_limits<std::uint32_t>::max();
+				for (unsigned int p = 0U; p < 16U; ++p) {
+					std::uint32_t distance = 0U;
+					for (unsigned int c = 0U; c < 4U; ++c) {
+						const int difference = static_cast<int>(points[i][c]) - static_cast<int>(palette[p][c]);
+						distance += static_cast<std::uint32_t>(difference * difference);
+					}
+					if (distance < bestDistance) {
+						bestDistance = distance;
+						candidate.mIndices[i] = static_cast<std::uint8_t>(p);
+					}
+				}
+				candidate.mError += bestDistance;
+			}
+
+			if (candidate.mError < best.mError) {
+				best = candidate;
+			}
+		}
+	}
+
+	class BitWriter {
+	public:
+		explicit BitWriter(std::uint8_t* data)
+			: mData(data)
+		{
+			memset(mData, 0, 16U);
+		}
+
+		void Write(const unsigned int value, const unsigned int numBits) {
+			for (unsigned int i = 0U; i < numBits; ++i, ++mPosition) {
+				mData[mPosition >> 3U] |= static_cast<std::uint8_t>(((value >> i) & 1U) << (mPosition & 7U));
+			}
+		}
+
+	private:
+		std::uint8_t* mData;
+		unsigned int mPosition = 0U;
+	};
+
+	class BitReader {
+	public:
+		explicit BitReader(const std::uint8_t* data)
+			: mData(data)
+		{
+		}
+
+		unsigned int Read(const unsigned int numBits) {
+			unsigned int value = 0U;
+			for (unsigned int i = 0U; i < numBits; ++i, ++mPosition) {
+				value |= ((mData[mPosition >> 3U] >> (mPosition & 7U)) & 1U) << i;
+			}
+			return value;
+		}
+
+	private:
+		const std::uint8_t* mData;
+		unsigned int mPosition = 0U;
+	};
+
+	void EncodeBc7(const std::uint8_t* texels, std::uint8_t* block) {
+		BlockPoints points;
+		for (unsigned int i = 0U; i < sTexelsPerBlock; ++i) {
+			for (unsigned int c = 0U; c < 4U; ++c) {
+				points[i][c] = texels[i * BRE::Image::sNumChannels + c];
+			}
+		}
+
+		float e0[4];
+		float e1[4];
+		PrincipalEndpoints(points, 4U, e0, e1);
+
+		Bc7Candidate best;
+		best.mError = std::numeric_limits<std::uint32_t>::max();
+		Bc7Evaluate(points, e0, e1, best);
+
+		if (best.mError != 0U) {
+			float factors[sTexelsPerBlock];
+			for (unsigned int i = 0U; i < sTexelsPerBlock; ++i) {
+				factors[i] = sBc7Weights[best.mIndices[i]] / 64.0f;
+			}
+			if (LeastSquaresEndpoints(points, 4U, factors, e0, e1)) {
+				Bc7Evaluate(points, e0, e1, best);
+			}
+		}
+
+		// The most significant index bit of texel 0 is implicit (0)
+		if (best.mIndices[0] >= 8U) {
+			for (unsigned int c = 0U; c < 4U; ++c) {
+				std::swap(best.mEndpoints[0][c], best.mEndpoints[1][c]);
+			}
+			std::swap(best.mPBits[0], best.mPBits[1]);
+			for (std::uint8_t& index : best.mIndices) {
+				index = static_cast<std::uint8_t>(15U - index);
+			}
+		}
+
+		BitWriter writer(block);
+		writer.Write(1U << 6U, 7U);
+		for (unsigned int c = 0U; c < 4U; ++c) {
+			writer.Write(best.mEndpoints[0][c], 7U);
+			writer.Write(best.mEndpoints[1][c], 7U);
+		}
+		writer.Write(best.mPBits[0], 1U);
+		writer.Write(best.mPBits[1], 1U);
+		writer.Write(best.mIndices[0], 3U);
+		for (unsigned int i = 1U; i < sTexelsPerBlock; ++i) {
+			writer.Write(best.mIndices[i], 4U);
+		}
+	}
+
+	// Only mode 6 (the one the encoder writes) is decoded. Other modes
+	// decode as transparent black.
+	void DecodeBc7(const std::uint8_t* block, std::uint8_t* texels) {
+		BitReader reader(block);
+		if (reader.Read(7U) != (1U << 6U)) {
+			memset(texels, 0, sTexelsPerBlock * BRE::Image::sNumChannels);
+			return;
+		}
+
+		std::uint8_t endpoints[2][4];
+		for (unsigned int c = 0U; c < 4U; ++c) {
+			endpoints[0][c] = static_cast<std::uint8_t>(reader.Read(7U));
+			endpoints[1][c] = static_cast<std::uint8_t>(reader.Read(7U));
+		}
+		std::uint8_t pBits[2];
+		pBits[0] = static_cast<std::uint8_t>(reader.Read(1U));
+		pBits[1] = static_cast<std::uint8_t>(reader.Read(1U));
+
+		unsigned int palette[16][4];
+		Bc7Palette(endpoints, pBits, palette);
+		for (unsigned int i = 0U; i < sTexelsPerBlock; ++i) {
+			const unsigned int index = reader.Read(i == 0U ? 3U : 4U);
+			for (unsigned int c = 0U; c < 4U; ++c) {
+				texels[i * BRE::Image::sNumChannels + c] = static_cast<std::uint8_t>(palette[index][c]);
+			}
+		}
+	}
+}
+
+namespace BRE {
+	namespace BlockCompression {
+		size_t BlockSize(const BlockFormat format) {
+			return (format == BlockFormat::BC1 || format == BlockFormat::BC4) ? 8U : 16U;
+		}
+
+		unsigned int ChannelMask(const BlockFormat format) {
+			switch (format) {
+			case BlockFormat::BC1: return 0x7U;
+			case BlockFormat::BC4: return 0x1U;
+			case BlockFormat::BC5: return 0x3U;
+			case BlockFormat::BC7: return 0xFU;
+			default: BRE_ASSERT(false); return 0U;
+			}
+		}
+
+		const char* Name(const BlockFormat format) {
+			switch (format) {
+			case BlockFormat::BC1: return "BC1";
+			case BlockFormat::BC4: return "BC4";
+			case BlockFormat::BC5: return "BC5";
+			case BlockFormat::BC7: return "BC7";
+			default: BRE_ASSERT(false); return "";
+			}
+		}
+
+		std::uint32_t DxgiFormat(const BlockFormat format) {
+			switch (format) {
+			case BlockFormat::BC1: return sFormatBC1Unorm;
+			case BlockFormat::BC4: return sFormatBC4Unorm;
+			case BlockFormat::BC5: return sFormatBC5Unorm;
+			case BlockFormat::BC7: return sFormatBC7Unorm;
+			default: BRE_ASSERT(false); return 0U;
+			}
+		}
+
+		void EncodeBlock(const BlockFormat format, const std::uint8_t* texels, std::uint8_t* block) {
+			BRE_ASSERT(texels != nullptr);
+			BRE_ASSERT(block != nullptr);
+			switch (format) {
+			case BlockFormat::BC1:
+				EncodeBc1(texels, block);
+				break;
+			case BlockFormat::BC4:
+				EncodeBc4(texels, 0U, block);
+				break;
+			case BlockFormat::BC5:
+				EncodeBc4(texels, 0U, block);
+				EncodeBc4(texels, 1U, block + 8U);
+				break;
+			case BlockFormat::BC7:
+				EncodeBc7(texels, block);
+				break;
+			default:
+				BRE_ASSERT(false);
+			}
+		}
+
+		void DecodeBlock(const BlockFormat format, const std::uint8_t* block, std::uint8_t* texels) {
+			BRE_ASSERT(block != nullptr);
+			BRE_ASSERT(texels != nullptr);
+			switch (format) {
+			case BlockFormat::BC1:
+				DecodeBc1(block, texels);
+				break;
+			case BlockFormat::BC4:
+			case BlockFormat::BC5:
+				// Missing channels decode as in D3D: 0 for color, 255 for alpha
+				for (unsigned int i = 0U; i < sTexelsPerBlock; ++i) {
+					std::uint8_t* texel = texels + i * Image::sNumChannels;
+					texel[1] = texel[2] = 0U;
+					texel[3] = 255U;
+				}
+				DecodeBc4(block, 0U, texels);
+				if (format == BlockFormat::BC5) {
+					DecodeBc4(block + 8U, 1U, texels);
+				}
+				break;
+			case BlockFormat::BC7:
+				DecodeBc7(block, texels);
+				break;
+			default:
+				BRE_ASSERT(false);
+			}
+		}
+
+		void Encode(const BlockFormat format, const Image& image, std::vector<std::uint8_t>& blocks) {
+			BRE_ASSERT(!image.Empty());
+			const unsigned int numBlocksX = (image.mWidth + sBlockDimension - 1U) / sBlockDimension;
+			const unsigned int numBlocksY = (image.mHeight + sBlockDimension - 1U) / sBlockDimension;
+			const size_t blockSize = BlockSize(format);
+			blocks.resize(static_cast<size_t>(numBlocksX) * numBlocksY * blockSize);
+
+			ParallelFor(numBlocksY, [&](const unsigned int blockY) {
+				std::uint8_t texels[sTexelsPerBlock * Image::sNumChannels];
+				for (unsigned int blockX = 0U; blockX < numBlocksX; ++blockX) {
+					for (unsigned int y = 0U; y < sBlockDimension; ++y) {
+						const unsigned int sourceY = std::min(blockY * sBlockDimension + y, image.mHeight - 1U);
+						for (unsigned int x = 0U; x < sBlockDimension; ++x) {
+							const unsigned int sourceX = std::min(blockX * sBlockDimension + x, image.mWidth - 1U);
+							memcpy(&texels[(y * sBlockDimension + x) * Image::sNumChannels], image.Texel(sourceX, sourceY), Image::sNumChannels);
+						}
+					}
+					EncodeBlock(format, texels, &blocks[(static_cast<size_t>(blockY) * numBlocksX + blockX) * blockSize]);
+				}
+			});
+		}
+
+		void Decode(const BlockFormat format, const std::uint8_t* blocks, const unsigned int width, const unsigned int height, Image& image) {
+			BRE_ASSERT(blocks != nullptr);
+			const unsigned int numBlocksX = (width + sBlockDimension - 1U) / sBlockDimension;
+			const unsigned int numBlocksY = (height + sBlockDimension - 1U) / sBlockDimension;
+			const size_t blockSize = BlockSize(format);
+			image = Image(width, height);
+
+			std::uint8_t texels[sTexelsPerBlock * Image::sNumChannels];
+			for (unsigned int blockY = 0U; blockY < numBlocksY; ++blockY) {
+				for (unsigned int blockX = 0U; blockX < numBlocksX; ++blockX) {
+					DecodeBlock(format, &blocks[(static_cast<size_t>(blockY) * numBlocksX + blockX) * blockSize], texels);
+					for (unsigned int y = 0U; y < sBlockDimension && blockY * sBlockDimension + y < height; ++y) {
+						for (unsigned int x = 0U; x < sBlockDimension && blockX * sBlockDimension + x < width; ++x) {
+							memcpy(image.Texel(blockX * sBlockDimension + x, blockY * sBlockDimension + y), &texels[(y * sBlockDimension + x) * Image::sNumChannels], Image::sNumChannels);
+						}
+					}
+				}
+			}
+		}
+
+		double Psnr(const Image& reference, const Image& image, const unsigned int channelMask) {
+			BRE_ASSERT(reference.mWidth == image.mWidth && reference.mHeight == image.mHeight);
+			BRE_ASSERT(channelMask != 0U);
+
+			double squaredError = 0.0;
+			size_t count = 0U;
+			for (size_t i = 0U; i < reference.mData.size(); ++i) {
+				if ((channelMask & (1U << (i % Image::sNumChannels))) != 0U) {
+					const double difference = static_cast<double>(reference.mData[i]) - image.mData[i];
+					squaredError += difference * difference;
+					++count;
+				}
+			}
+			if (squaredError == 0.0) {
+				return std::numeric_limits<double>::infinity();
+			}
+			return 10.0 * std::log10(255.0 * 255.0 * count / squaredError);
+		}
+	}
+}
\ No newline at end of file
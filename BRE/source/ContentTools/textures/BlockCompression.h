@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Image.h"
+
+//////////////////////////////////////////////////////////////////////////
+//
+// CPU block compression encoders and decoders (4x4 texel blocks).
+// - BC1: RGB, 565 endpoints and 2 bits indices (alpha is ignored)
+// - BC4: R channel, 8 bits endpoints and 3 bits indices
+// - BC5: R and G channels as two BC4 blocks (normal maps)
+// - BC7: RGBA, mode 6 only (7777.1 endpoints and 4 bits indices)
+// Images are encoded in parallel by rows of blocks. BC4/BC5 index search
+// uses SSE2 when it is available.
+//
+//////////////////////////////////////////////////////////////////////////
+
+namespace BRE {
+	enum class BlockFormat {
+		BC1,
+		BC4,
+		BC5,
+		BC7,
+	};
+
+	namespace BlockCompression {
+		static const unsigned int sBlockDimension = 4U;
+		static const unsigned int sTexelsPerBlock = sBlockDimension * sBlockDimension;
+
+		// Size in bytes of a 4x4 block
+		size_t BlockSize(const BlockFormat format);
+		// Channels (bit 0 = R ... bit 3 = A) the format stores
+		unsigned int ChannelMask(const BlockFormat format);
+		const char* Name(const BlockFormat format);
+		// DXGI_FORMAT value (UNORM variant)
+		std::uint32_t DxgiFormat(const BlockFormat format);
+
+		// texels are 16 RGBA8 texels, row by row
+		void EncodeBlock(const BlockFormat format, const std::uint8_t* texels, std::uint8_t* block);
+		void DecodeBlock(const BlockFormat format, const std::uint8_t* block, std::uint8_t* texels);
+
+		// Borders of images whose dimensions are not multiple of 4 are filled by clamping.
+		void Encode(const BlockFormat format, const Image& image, std::vector<std::uint8_t>& blocks);
+		void Decode(const BlockFormat format, const std::uint8_t* blocks, const unsigned int width, const unsigned int height, Image& image);
+
+		// Peak signal to noise ratio (dB) of the channels in channelMask.
+		// It is infinity if both images are equal.
+		double Psnr(const Image& reference, const Image& image, const unsigned int channelMask);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,314 @@
+#include "DdsFile.h"
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+
+#include <utils/Assert.h>
+
+namespace {
+	const std::uint32_t sMagic = 0x20534444U; // "DDS "
+
+	const std::uint32_t sFlagCaps = 0x1U;
+	const std::uint32_t sFlagHeight = 0x2U;
+	const std::uint32_t sFlagWidth = 0x4U;
+	const std::uint32_t sFlagPitch = 0x8U;
+	const std::uint32_t sFlagPixelFormat = 0x1000U;
+	const std::uint32_t sFlagMipMapCount = 0x20000U;
+	const std::uint32_t sFlagLinearSize = 0x80000U;
+
+	const std::uint32_t sPixelFormatAlphaPixels = 0x1U;
+	const std::uint32_t sPixelFormatFourCC = 0x4U;
+	const std::uint32_t sPixelFormatRgb = 0x40U;
+	const std::uint32_t sPixelFormatLuminance = 0x20000U;
+
+	const std::uint32_t sCapsComplex = 0x8U;
+	const std::uint32_t sCapsTexture = 0x1000U;
+	const std::uint32_t sCapsMipMap = 0x400000U;
+
+	const std::uint32_t sFourCCDX10 = 0x30315844U; // "DX10"
+
+	const std::uint32_t sResourceDimensionTexture2D = 3U;
+
+	// DXGI_FORMAT values
+	const std::uint32_t sFormatR8G8B8A8Unorm = 28U;
+	const std::uint32_t sFormatR8G8B8A8UnormSrgb = 29U;
+	const std::uint32_t sFormatB8G8R8A8Unorm = 87U;
+	const std::uint32_t sFormatB8G8R8X8Unorm = 88U;
+	const std::uint32_t sFormatB8G8R8A8UnormSrgb = 91U;
+	const std::uint32_t sFormatB8G8R8X8UnormSrgb = 93U;
+
+	struct PixelFormat {
+		std::uint32_t mSize;
+		std::uint32_t mFlags;
+		std::uint32_t mFourCC;
+		std::uint32_t mRGBBitCount;
+		std::uint32_t mRBitMask;
+		std::uint32_t mGBitMask;
+		std::uint32_t mBBitMask;
+		std::uint32_t mABitMask;
+	};
+
+	struct Header {
+		std::uint32_t mSize;
+		std::uint32_t mFlags;
+		std::uint32_t mHeight;
+		std::uint32_t mWidth;
+		std::uint32_t mPitchOrLinearSize;
+		std::uint32_t mDepth;
+		std::uint32_t mMipMapCount;
+		std::uint32_t mReserved1[11];
+		PixelFormat mPixelFormat;
+		std::uint32_t mCaps;
+		std::uint32_t mCaps2;
+		std::uint32_t mCaps3;
+		std::uint32_t mCaps4;
+		std::uint32_t mReserved2;
+	};
+	static_assert(sizeof(Header) == 124U, "Invalid DDS header size");
+
+	struct HeaderDX10 {
+		std::uint32_t mDxgiFormat;
+		std::uint32_t mResourceDimension;
+		std::uint32_t mMiscFlag;
+		std::uint32_t mArraySize;
+		std::uint32_t mMiscFlags2;
+	};
+
+	// Byte offset of a channel inside a texel given its bit mask.
+	// Returns false if the mask is not a whole byte.
+	bool MaskToByte(const std::uint32_t mask, unsigned int& byte) {
+		for (unsigned int i = 0U; i < 4U; ++i) {
+			if (mask == (0xFFU << (i * 8U))) {
+				byte = i;
+				return true;
+			}
+		}
+		return false;
+	}
+
+	// Texel layout of the source, as byte offsets of each channel.
+	// A negative offset means the channel is missing (alpha defaults to 255,
+	// G and B replicate R for luminance formats).
+	struct Layout {
+		unsigned int mBytesPerTexel;
+		int mOffsets[4];
+		bool mLuminance;
+	};
+
+	bool LegacyLayout(const PixelFormat& format, Layout& layout, std::string& error) {
+		layout.mLuminance = false;
+		if ((format.mFlags & sPixelFormatLuminance) != 0U && format.mRGBBitCount == 8U) {
+			layout.mBytesPerTexel = 1U;
+			layout.mOffsets[0] = 0;
+			layout.mOffsets[1] = layout.mOffsets[2] = layout.mOffsets[3] = -1;
+			layout.mLuminance = true;
+			return true;
+		}
+
+		if ((format.mFlags & sPixelFormatRgb) == 0U || (format.mRGBBitCount != 24U && format.mRGBBitCount != 32U)) {
+			error = "unsupported pixel format (only uncompressed 8 bits per channel is supported)";
+			return false;
+		}
+
+		layout.mBytesPerTexel = format.mRGBBitCount / 8U;
+		const std::uint32_t masks[] = { format.mRBitMask, format.mGBitMask, format.mBBitMask };
+		for (unsigned int i = 0U; i < 3U; ++i) {
+			unsigned int byte;
+			if (!MaskToByte(masks[i], byte) || byte >= layout.mBytesPerTexel) {
+				error = "unsupported channel mask";
+				return false;
+			}
+			layout.mOffsets[i] = static_cast<int>(byte);
+		}
+		unsigned int alphaByte;
+		const bool hasAlpha = (format.mFlags & sPixelFormatAlphaPixels) != 0U && MaskToByte(format.mABitMask, alphaByte) && alphaByte < layout.mBytesPerTexel;
+		layout.mOffsets[3] = hasAlpha ? static_cast<int>(alphaByte) : -1;
+		return true;
+	}
+
+	bool DX10Layout(const HeaderDX10& header, Layout& layout, std::string& error) {
+		layout.mBytesPerTexel = 4U;
+		layout.mLuminance = false;
+		switch (header.mDxgiFormat) {
+		case sFormatR8G8B8A8Unorm:
+		case sFormatR8G8B8A8UnormSrgb:
+			layout.mOffsets[0] = 0; layout.mOffsets[1] = 1; layout.mOffsets[2] = 2; layout.mOffsets[3] = 3;
+			return true;
+		case sFormatB8G8R8A8Unorm:
+		case sFormatB8G8R8A8UnormSrgb:
+			layout.mOffsets[0] = 2; layout.mOffsets[1] = 1; layout.mOffsets[2] = 0; layout.mOffsets[3] = 3;
+			return true;
+		case sFormatB8G8R8X8Unorm:
+		case sFormatB8G8R8X8UnormSrgb:
+			layout.mOffsets[0] = 2; layout.mOffsets[1] = 1; layout.mOffsets[2] = 0; layout.mOffsets[3] = -1;
+			return true;
+		default:
+			error = "unsupported DXGI format " + std::to_string(header.mDxgiFormat);
+			return false;
+		}
+	}
+}
+
+namespace BRE {
+	namespace DdsFile {
+		bool Read(const std::string& filepath, Image& image, std::string& error) {
+			std::ifstream stream(filepath, std::ios::in | std::ios::binary);
+			if (!stream.is_open()) {
+				error = "file not found";
+				return false;
+			}
+
+			std::uint32_t magic = 0U;
+			Header header;
+			stream.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+			stream.read(reinterpret_cast<char*>(&header), sizeof(header));
+			if (!stream || magic != sMagic || header.mSize != sizeof(Header) || header.mPixelFormat.mSize != sizeof(PixelFormat)) {
+				error = "invalid DDS header";
+				return false;
+			}
+			if (header.mWidth == 0U || header.mHeight == 0U) {
+				error = "invalid dimensions";
+				return false;
+			}
+
+			Layout layout;
+			if ((header.mPixelFormat.mFlags & sPixelFormatFourCC) != 0U) {
+				if (header.mPixelFormat.mFourCC != sFourCCDX10) {
+					error = "compressed formats are not supported";
+					return false;
+				}
+				HeaderDX10 headerDX10;
+				stream.read(reinterpret_cast<char*>(&headerDX10), sizeof(headerDX10));
+				if (!stream || !DX10Layout(headerDX10, layout, error)) {
+					if (error.empty()) {
+						error = "invalid DX10 header";
+					}
+					return false;
+				}
+			}
+			else if (!LegacyLayout(header.mPixelFormat, layout, error)) {
+				return false;
+			}
+
+			// Top mip level is stored first. Rows are tightly packed for
+			// uncompressed formats with whole byte texels.
+			const size_t rowSize = static_cast<size_t>(header.mWidth) * layout.mBytesPerTexel;
+			std::vector<std::uint8_t> row(rowSize);
+			image = Image(header.mWidth, header.mHeight);
+			for (unsigned int y = 0U; y < header.mHeight; ++y) {
+				stream.read(reinterpret_cast<char*>(row.data()), rowSize);
+				if (!stream) {
+					error = "unexpected end of file";
+					return false;
+				}
+				for (unsigned int x = 0U; x < header.mWidth; ++x) {
+					const std::uint8_t* src = &row[x * layout.mBytesPerTexel];
+					std::uint8_t* dst = image.Texel(x, y);
+					for (unsigned int c = 0U; c < Image::sNumChannels; ++c) {
+						const int offset = layout.mOffsets[c];
+						if (offset >= 0) {
+							dst[c] = src[offset];
+						}
+						else {
+							dst[c] = (c < 3U && layout.mLuminance) ? src[layout.mOffsets[0]] : 255U;
+						}
+					}
+				}
+			}
+
+			return true;
+		}
+
+		bool Write(const std::string& filepath, const std::vector<Image>& mips, std::string& error) {
+			BRE_ASSERT(!mips.empty());
+			const Image& top = mips.front();
+
+			Header header;
+			memset(&header, 0, sizeof(header));
+			header.mSize = sizeof(Header);
+			header.mFlags = sFlagCaps | sFlagHeight | sFlagWidth | sFlagPitch | sFlagPixelFormat;
+			header.mHeight = top.mHeight;
+			header.mWidth = top.mWidth;
+			header.mPitchOrLinearSize = top.mWidth * Image::sNumChannels;
+			header.mMipMapCount = static_cast<std::uint32_t>(mips.size());
+			header.mPixelFormat.mSize = sizeof(PixelFormat);
+			header.mPixelFormat.mFlags = sPixelFormatRgb | sPixelFormatAlphaPixels;
+			header.mPixelFormat.mRGBBitCount = 32U;
+			header.mPixelFormat.mRBitMask = 0x000000FFU;
+			header.mPixelFormat.mGBitMask = 0x0000FF00U;
+			header.mPixelFormat.mBBitMask = 0x00FF0000U;
+			header.mPixelFormat.mABitMask = 0xFF000000U;
+			header.mCaps = sCapsTexture;
+			if (mips.size() > 1U) {
+				header.mFlags |= sFlagMipMapCount;
+				header.mCaps |= sCapsComplex | sCapsMipMap;
+			}
+
+			std::ofstream stream(filepath, std::ios::out | std::ios::binary | std::ios::trunc);
+			if (!stream.is_open()) {
+				error = "file could not be created";
+				return false;
+			}
+			stream.write(reinterpret_cast<const char*>(&sMagic), sizeof(sMagic));
+			stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+			for (const Image& mip : mips) {
+				BRE_ASSERT(!mip.Empty());
+				stream.write(reinterpret_cast<const char*>(mip.mData.data()), mip.mData.size());
+			}
+			if (!stream.good()) {
+				error = "write failed";
+				return false;
+			}
+
+			return true;
+		}
+
+		bool WriteBlockCompressed(const std::string& filepath, const BlockFormat format, const unsigned int width, const unsigned int height, const std::vector<std::vector<std::uint8_t>>& levels, std::string& error) {
+			BRE_ASSERT(!levels.empty());
+			BRE_ASSERT(width > 0U && height > 0U);
+
+			Header header;
+			memset(&header, 0, sizeof(header));
+			header.mSize = sizeof(Header);
+			header.mFlags = sFlagCaps | sFlagHeight | sFlagWidth | sFlagPixelFormat | sFlagLinearSize;
+			header.mHeight = height;
+			header.mWidth = width;
+			header.mPitchOrLinearSize = static_cast<std::uint32_t>(levels.front().size());
+			header.mMipMapCount = static_cast<std::uint32_t>(levels.size());
+			header.mPixelFormat.mSize = sizeof(PixelFormat);
+			header.mPixelFormat.mFlags = sPixelFormatFourCC;
+			header.mPixelFormat.mFourCC = sFourCCDX10;
+			header.mCaps = sCapsTexture;
+			if (levels.size() > 1U) {
+				header.mFlags |= sFlagMipMapCount;
+				header.mCaps |= sCapsComplex | sCapsMipMap;
+			}
+
+			HeaderDX10 headerDX10;
+			memset(&headerDX10, 0, sizeof(headerDX10));
+			headerDX10.mDxgiFormat = BlockCompression::DxgiFormat(format);
+			headerDX10.mResourceDimension = sResourceDimensionTexture2D;
+			headerDX10.mArraySize = 1U;
+
+			std::ofstream stream(filepath, std::ios::out | std::ios::binary | std::ios::trunc);
+			if (!stream.is_open()) {
+				error = "file could not be created";
+				return false;
+			}
+			stream.write(reinterpret_cast<const char*>(&sMagic), sizeof(sMagic));
+			stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+			stream.write(reinterpret_cast<const char*>(&headerDX10), sizeof(headerDX10));
+			for (const std::vector<std::uint8_t>& level : levels) {
+				BRE_ASSERT(!level.empty());
+				stream.write(reinterpret_cast<const char*>(level.data()), level.size());
+			}
+			if (!stream.good()) {
+				error = "write failed";
+				return false;
+			}
+
+			return true;
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "BlockCompression.h"
+#include "Image.h"
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Minimal DDS reader and writer for the offline texture tools.
+// Reading supports uncompressed 8 bits per channel layouts (legacy
+// RGB/RGBA/luminance headers and DX10 headers with R8G8B8A8 or B8G8R8A8
+// formats) and returns the top mip level of the first array slice.
+// Writing stores an RGBA8 mip chain with a legacy header, so it loads as
+// DXGI_FORMAT_R8G8B8A8_UNORM with DirectXTK DDSTextureLoader.
+// Block compressed mip chains are written with a DX10 header.
+//
+//////////////////////////////////////////////////////////////////////////
+
+namespace BRE {
+	namespace DdsFile {
+		// On failure, error is filled and false is returned
+		bool Read(const std::string& filepath, Image& image, std::string& error);
+		bool Write(const std::string& filepath, const std::vector<Image>& mips, std::string& error);
+		// levels are the encoded blocks of each mip level, top level first
+		bool WriteBlockCompressed(const std::string& filepath, const BlockFormat format, const unsigned int width, const unsigned int height, const std::vector<std::vector<std::uint8_t>>& levels, std::string& error);
+	}
+}
\ No newline at end of file
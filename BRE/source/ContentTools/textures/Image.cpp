@@ -0,0 +1,60 @@
+#include "Image.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include <utils/Assert.h>
+
+namespace BRE {
+	namespace ImageUtils {
+		void Resize(const Image& source, const unsigned int width, const unsigned int height, Image& result) {
+			BRE_ASSERT(!source.Empty());
+			BRE_ASSERT(width > 0U && height > 0U);
+			result = Image(width, height);
+			if (width == source.mWidth && height == source.mHeight) {
+				result.mData = source.mData;
+				return;
+			}
+
+			const float scaleX = static_cast<float>(source.mWidth) / width;
+			const float scaleY = static_cast<float>(source.mHeight) / height;
+			const int maxX = static_cast<int>(source.mWidth) - 1;
+			const int maxY = static_cast<int>(source.mHeight) - 1;
+			for (unsigned int y = 0U; y < height; ++y) {
+				const float srcY = std::max((y + 0.5f) * scaleY - 0.5f, 0.0f);
+				const int y0 = std::min(static_cast<int>(srcY), maxY);
+				const int y1 = std::min(y0 + 1, maxY);
+				const float fy = srcY - y0;
+				for (unsigned int x = 0U; x < width; ++x) {
+					const float srcX = std::max((x + 0.5f) * scaleX - 0.5f, 0.0f);
+					const int x0 = std::min(static_cast<int>(srcX), maxX);
+					const int x1 = std::min(x0 + 1, maxX);
+					const float fx = srcX - x0;
+
+					const std::uint8_t* t00 = source.Texel(x0, y0);
+					const std::uint8_t* t10 = source.Texel(x1, y0);
+					const std::uint8_t* t01 = source.Texel(x0, y1);
+					const std::uint8_t* t11 = source.Texel(x1, y1);
+					std::uint8_t* dst = result.Texel(x, y);
+					for (unsigned int c = 0U; c < Image::sNumChannels; ++c) {
+						const float top = t00[c] + (t10[c] - t00[c]) * fx;
+						const float bottom = t01[c] + (t11[c] - t01[c]) * fx;
+						dst[c] = static_cast<std::uint8_t>(std::lround(top + (bottom - top) * fy));
+					}
+				}
+			}
+		}
+
+		void GenerateMips(const Image& image, std::vector<Image>& mips, const MipGenerator::Settings& settings) {
+			BRE_ASSERT(!image.Empty());
+			std::vector<std::vector<std::uint8_t>> levels;
+			MipGenerator::Generate(image.mData.data(), image.mWidth, image.mHeight, settings, levels);
+			mips.resize(levels.size());
+			for (size_t i = 0U; i < levels.size(); ++i) {
+				mips[i].mWidth = std::max(1U, image.mWidth >> i);
+				mips[i].mHeight = std::max(1U, image.mHeight >> i);
+				mips[i].mData.swap(levels[i]);
+			}
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <utils/MipGenerator.h>
+
+//////////////////////////////////////////////////////////////////////////
+//
+// 8 bits per channel RGBA image used by the offline texture tools.
+// Texels are stored row by row, R first.
+//
+//////////////////////////////////////////////////////////////////////////
+
+namespace BRE {
+	struct Image {
+		static const unsigned int sNumChannels = 4U;
+
+		Image() = default;
+		Image(const unsigned int width, const unsigned int height)
+			: mWidth(width)
+			, mHeight(height)
+			, mData(static_cast<size_t>(width) * height * sNumChannels, 0U)
+		{
+		}
+
+		bool Empty() const { return mData.empty(); }
+		std::uint8_t* Texel(const unsigned int x, const unsigned int y) { return &mData[(static_cast<size_t>(y) * mWidth + x) * sNumChannels]; }
+		const std::uint8_t* Texel(const unsigned int x, const unsigned int y) const { return &mData[(static_cast<size_t>(y) * mWidth + x) * sNumChannels]; }
+
+		unsigned int mWidth = 0U;
+		unsigned int mHeight = 0U;
+		std::vector<std::uint8_t> mData;
+	};
+
+	namespace ImageUtils {
+		// Bilinear resampling with clamp addressing
+		void Resize(const Image& source, const unsigned int width, const unsigned int height, Image& result);
+
+		// Full mip chain down to 1x1 (level 0 is a copy of image), see MipGenerator
+		void GenerateMips(const Image& image, std::vector<Image>& mips, const MipGenerator::Settings& settings = MipGenerator::Settings());
+	}
+}
\ No newline at end of file
@@ -0,0 +1,118 @@
+#include "UniformTexture.h"
+
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+#if defined(_M_X64) || defined(__SSE2__)
+#define BRE_UNIFORM_TEXTURE_SSE2
+#include <emmintrin.h>
+#endif
+
+#include <common/ParallelFor.h>
+#include <utils/Assert.h>
+
+namespace {
+	using BRE::Image;
+
+	// Rows scanned by each task
+	const unsigned int sRowsPerTask = 32U;
+
+	struct Range {
+		std::uint8_t mMin[Image::sNumChannels];
+		std::uint8_t mMax[Image::sNumChannels];
+	};
+
+	void InitRange(Range& range) {
+		for (unsigned int c = 0U; c < Image::sNumChannels; ++c) {
+			range.mMin[c] = 255U;
+			range.mMax[c] = 0U;
+		}
+	}
+
+	bool WithinTolerance(const Range& range, const unsigned int channelMask, const unsigned int tolerance) {
+		for (unsigned int c = 0U; c < Image::sNumChannels; ++c) {
+			if ((channelMask & (1U << c)) != 0U && range.mMax[c] > range.mMin[c] + tolerance) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	// Adds the texels of a row to range
+	void ScanRow(const std::uint8_t* texels, const unsigned int width, Range& range) {
+		const size_t numBytes = static_cast<size_t>(width) * Image::sNumChannels;
+		size_t i = 0U;
+#ifdef BRE_UNIFORM_TEXTURE_SSE2
+		// 4 RGBA texels per register, so lane i holds channel i % 4
+		const size_t numVectorBytes = numBytes & ~static_cast<size_t>(15U);
+		if (numVectorBytes > 0U) {
+			__m128i minimum = _mm_set1_epi8(static_cast<char>(0xff));
+			__m128i maximum = _mm_setzero_si128();
+			for (; i < numVectorBytes; i += 16U) {
+				const __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i*>(texels + i));
+				minimum = _mm_min_epu8(minimum, data);
+				maximum = _mm_max_epu8(maximum, data);
+			}
+			alignas(16) std::uint8_t lanesMin[16];
+			alignas(16) std::uint8_t lanesMax[16];
+			_mm_store_si128(reinterpret_cast<__m128i*>(lanesMin), minimum);
+			_mm_store_si128(reinterpret_cast<__m128i*>(lanesMax), maximum);
+			for (unsigned int lane = 0U; lane < 16U; ++lane) {
+				const unsigned int c = lane % Image::sNumChannels;
+				range.mMin[c] = std::min(range.mMin[c], lanesMin[lane]);
+				range.mMax[c] = std::max(range.mMax[c], lanesMax[lane]);
+			}
+		}
+#endif
+		for (; i < numBytes; ++i) {
+			const unsigned int c = i % Image::sNumChannels;
+			range.mMin[c] = std::min(range.mMin[c], texels[i]);
+			range.mMax[c] = std::max(range.mMax[c], texels[i]);
+		}
+	}
+}
+
+namespace BRE {
+	namespace UniformTexture {
+		bool Detect(const Image& image, const unsigned int channelMask, const unsigned int tolerance, std::uint8_t value[Image::sNumChannels]) {
+			BRE_ASSERT(!image.Empty());
+			BRE_ASSERT(value);
+
+			const unsigned int numTasks = (image.mHeight + sRowsPerTask - 1U) / sRowsPerTask;
+			std::vector<Range> ranges(numTasks);
+			std::atomic<bool> uniform(true);
+			ParallelFor(numTasks, [&](const unsigned int task) {
+				Range& range = ranges[task];
+				InitRange(range);
+				const unsigned int lastRow = std::min((task + 1U) * sRowsPerTask, image.mHeight);
+				for (unsigned int y = task * sRowsPerTask; y < lastRow && uniform; ++y) {
+					ScanRow(image.Texel(0U, y), image.mWidth, range);
+					if (!WithinTolerance(range, channelMask, tolerance)) {
+						uniform = false;
+					}
+				}
+			});
+			if (!uniform) {
+				return false;
+			}
+
+			Range range;
+			InitRange(range);
+			for (const Range& taskRange : ranges) {
+				for (unsigned int c = 0U; c < Image::sNumChannels; ++c) {
+					range.mMin[c] = std::min(range.mMin[c], taskRange.mMin[c]);
+					range.mMax[c] = std::max(range.mMax[c], taskRange.mMax[c]);
+				}
+			}
+			if (!WithinTolerance(range, channelMask, tolerance)) {
+				return false;
+			}
+
+			for (unsigned int c = 0U; c < Image::sNumChannels; ++c) {
+				value[c] = (channelMask & (1U << c)) != 0U ? static_cast<std::uint8_t>((range.mMin[c] + range.mMax[c] + 1U) / 2U) : 0U;
+			}
+			return true;
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstdint>
+
+#include "Image.h"
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Detection of uniform textures (every texel has the same value, within
+// a tolerance), like a metal mask that is all ones on metals. The material
+// cooker replaces them by material constants, so they cost neither
+// texture memory nor texture fetches.
+// Rows are scanned in parallel and with SSE2 when it is available. The
+// scan stops as soon as a channel range exceeds the tolerance.
+//
+//////////////////////////////////////////////////////////////////////////
+
+namespace BRE {
+	namespace UniformTexture {
+		// Returns true if, in every channel of channelMask (bit 0 = R ... bit 3 = A),
+		// the difference between the largest and the smallest texel value is
+		// not greater than tolerance. In that case, value gets the middle of
+		// the range of each channel (0 for channels not in channelMask).
+		bool Detect(const Image& image, const unsigned int channelMask, const unsigned int tolerance, std::uint8_t value[Image::sNumChannels]);
+	}
+}
\ No newline at end of file
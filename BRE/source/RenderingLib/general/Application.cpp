@@ -2,18 +2,28 @@
 
 #include <d3d11_1.h>
 #include <dinput.h>
-#include <sstream>
+#include <iostream>
 #include <yaml-cpp/yaml.h>
 
+#include <general/Benchmark.h>
 #include <general/Camera.h>
+#include <general/CameraPath.h>
 #include <general/Component.h>
+#include <general/FramePipeline.h>
+#include <general/JobSystem.h>
+#include <general/Profiler.h>
+#include <general/RenderCounters.h>
 #include <input/Keyboard.h>
 #include <input/Mouse.h>
 #include <managers/DrawManager.h>
+#include <managers/GeometryPool.h>
 #include <managers/MaterialManager.h>
+#include <managers/MaterialTable.h>
 #include <managers/ModelManager.h>
 #include <managers/ShadersManager.h>
 #include <managers/ShaderResourcesManager.h>
+#include <managers/TextureStreamer.h>
+#include <managers/VirtualFileSystem.h>
 #include <rendering/GlobalResources.h>
 #include <rendering/RenderStateHelper.h>
 #include <utils/DXUtils.h>
@@ -22,6 +32,40 @@
 using namespace DirectX;
 
 namespace {
+#ifdef BRE_PROFILING
+	const char* sProfilerCaptureFile = "profile_capture.json";
+	const unsigned int sProfilerCaptureFrames = 60U;
+#endif
+
+	BRE::Benchmark* LoadBenchmark(const char* filepath) {
+		BRE_ASSERT(filepath);
+		const YAML::Node yamlFile = BRE::YamlUtils::LoadFile(filepath);
+		BRE_ASSERT(yamlFile.IsDefined());
+		const YAML::Node benchmarkNode = yamlFile["benchmark"];
+		BRE_ASSERT(benchmarkNode.IsDefined());
+		BRE_ASSERT(benchmarkNode.IsMap());
+
+		BRE::Benchmark::Settings settings;
+		settings.mTimeStep = BRE::YamlUtils::GetScalar<float>(benchmarkNode, "timeStep");
+		settings.mWarmupFrames = BRE::YamlUtils::GetScalar<unsigned int>(benchmarkNode, "warmupFrames");
+		settings.mReportFilepath = BRE::YamlUtils::GetScalar<std::string>(benchmarkNode, "report");
+
+		const YAML::Node pathNode = benchmarkNode["path"];
+		BRE_ASSERT(pathNode.IsDefined());
+		BRE_ASSERT(pathNode.IsSequence());
+		BRE::CameraPath path;
+		for (const YAML::Node& keyNode : pathNode) {
+			BRE_ASSERT(keyNode.IsMap());
+			BRE::CameraPath::Key key;
+			key.mTime = BRE::YamlUtils::GetScalar<float>(keyNode, "time");
+			BRE::YamlUtils::GetSequence<float>(keyNode, "translation", key.mTranslation, ARRAYSIZE(key.mTranslation));
+			BRE::YamlUtils::GetSequence<float>(keyNode, "rotation", key.mRotation, ARRAYSIZE(key.mRotation));
+			path.AddKey(key);
+		}
+
+		return new BRE::Benchmark(settings, path);
+	}
+
 	POINT CenterWindow(const int windowWidth, const int windowHeight) {
 		const int screenWidth = GetSystemMetrics(SM_CXSCREEN);
 		const int screenHeight = GetSystemMetrics(SM_CYSCREEN);
@@ -143,11 +187,30 @@ namespace {
 namespace BRE {    
 	Application::Application(const HINSTANCE& instance, const int showCommand) { 
 		srand(static_cast<unsigned int>(time(reinterpret_cast<time_t*>(0))));
+#ifdef BRE_PROFILING
+		Profiler::gInstance = new Profiler();
+#endif
+		RenderCounters::gInstance = new RenderCounters();
+		// Settings are never packed (they name the content pack)
 		const YAML::Node yamlFile = YAML::LoadFile("content/configs/settings.yml");
 		BRE_ASSERT(yamlFile.IsDefined());
 		const YAML::Node settingsNode = yamlFile["settings"];
 		BRE_ASSERT(settingsNode.IsDefined());
 		BRE_ASSERT(settingsNode.IsMap());
+
+		// Job system threads, the main thread included. One per hardware thread when it is not defined.
+		const unsigned int jobThreads = YamlUtils::IsDefined(settingsNode, "jobThreads") ? YamlUtils::GetScalar<unsigned int>(settingsNode, "jobThreads") : 0U;
+		JobSystem::gInstance = new JobSystem(jobThreads);
+
+		// Content is read from the pack when it exists, from loose files otherwise
+		VirtualFileSystem::gInstance = new VirtualFileSystem();
+		if (YamlUtils::IsDefined(settingsNode, "contentPack")) {
+			const std::string packFilepath = YamlUtils::GetScalar<std::string>(settingsNode, "contentPack");
+			std::string error;
+			if (!VirtualFileSystem::gInstance->Mount(packFilepath, error)) {
+				std::cout << error << std::endl;
+			}
+		}
 			
 		mScreenWidth = YamlUtils::GetScalar<unsigned int>(settingsNode, "screenWidth");
 		mScreenHeight = YamlUtils::GetScalar<unsigned int>(settingsNode, "screenHeight");
@@ -158,8 +221,31 @@ namespace BRE {
 		InitDirectX(multisamplingCount, mScreenWidth, mScreenHeight, frameRate, mWindowHandle, mDevice, mContext, mSwapChain, mBackBufferRTV, mDepthStencilView, mDepthStencilSRV);
 
 		ShadersManager::gInstance = new ShadersManager(*mDevice);    
+		// Archive shaders are created on a worker thread while the other managers are created.
+		// Shaders that are not in the archive are read from their files.
+		if (YamlUtils::IsDefined(settingsNode, "shaderArchive")) {
+			const std::string archiveFilepath = YamlUtils::GetScalar<std::string>(settingsNode, "shaderArchive");
+			std::string error;
+			if (!ShadersManager::gInstance->LoadArchive(archiveFilepath.c_str(), true, error)) {
+				std::cout << error << std::endl;
+			}
+		}
+		const bool materialTable = YamlUtils::IsDefined(settingsNode, "materialTable") && YamlUtils::GetScalar<bool>(settingsNode, "materialTable");
+		if (YamlUtils::IsDefined(settingsNode, "textureStreamingBudget")) {
+			TextureStreamer::Settings streamerSettings;
+			streamerSettings.mBudgetBytes = static_cast<size_t>(YamlUtils::GetScalar<unsigned int>(settingsNode, "textureStreamingBudget")) * 1024U * 1024U;
+			TextureStreamer::gInstance = new TextureStreamer(*mDevice, *mContext, mScreenHeight, streamerSettings);
+			// Streamed textures change, so they cannot be copied into the table
+			if (materialTable) {
+				std::cout << "materialTable is not used: it cannot be combined with textureStreamingBudget" << std::endl;
+			}
+		}
+		else if (materialTable) {
+			MaterialTable::gInstance = new MaterialTable(*mDevice, *mContext);
+		}
 		MaterialManager::gInstance = new MaterialManager();
 		ModelManager::gInstance = new ModelManager(); 
+		GeometryPool::gInstance = new GeometryPool(*mDevice, *mContext);
 		DrawManager::gInstance = new DrawManager(*mDevice, *mContext, mScreenWidth, mScreenHeight); 
 		RenderStateHelper::gInstance = new RenderStateHelper(*mContext);  
 
@@ -185,12 +271,26 @@ namespace BRE {
 		camData.mMovementRate = YamlUtils::GetScalar<float>(settingsNode, "movementRate");
 		camData.mAspectRatio = static_cast<float> (mScreenWidth) / mScreenHeight;
 		Camera::gInstance = new BRE::Camera(camData);
+
+		if (YamlUtils::IsDefined(settingsNode, "frameLatency")) {
+			mFrameLatency = YamlUtils::GetScalar<unsigned int>(settingsNode, "frameLatency");
+			BRE_ASSERT(mFrameLatency <= FramePipeline::sMaxFrameLatency);
+		}
+
+		if (YamlUtils::IsDefined(settingsNode, "benchmark")) {
+			const std::string benchmarkFile = YamlUtils::GetScalar<std::string>(settingsNode, "benchmark");
+			mBenchmark = LoadBenchmark(benchmarkFile.c_str());
+		}
 	}
 
 	Application::~Application() {
 		for (Component* component : mComponents) {
 			delete component;
 		}
+		delete JobSystem::gInstance;
+		delete TextureStreamer::gInstance;
+		delete MaterialTable::gInstance;
+		delete GeometryPool::gInstance;
 		delete ShaderResourcesManager::gInstance;
 		delete ShadersManager::gInstance;
 		delete DrawManager::gInstance;
@@ -199,11 +299,19 @@ namespace BRE {
 		delete Mouse::gInstance;
 		delete GlobalResources::gInstance;
 		delete Camera::gInstance;
+		delete mBenchmark;
+#ifdef BRE_PROFILING
+		delete Profiler::gInstance;
+#endif
+		delete RenderCounters::gInstance;
+		delete VirtualFileSystem::gInstance;
 		mContext->ClearState();
 		UnregisterClass(L"BRE", mWindowClass.hInstance);
 	}
 
 	void Application::Run() {
+		// The render thread only exists while frames are run
+		FramePipeline::gInstance = new FramePipeline(mFrameLatency, [this](const FrameSnapshot& frame) { Submit(frame); });
 		MSG message; 
 		ZeroMemory(&message, sizeof(message)); 
 		mClock.Reset();
@@ -217,23 +325,98 @@ namespace BRE {
 				Update();
 			}
 		}
+		delete FramePipeline::gInstance;
+		FramePipeline::gInstance = nullptr;
 	}
 
 	void Application::Update() {
-		const float elapsedTime = mClock.ElapsedTime();
-		if (BRE::Keyboard::gInstance->WasKeyPressedThisFrame(DIK_ESCAPE)) {
-			PostQuitMessage(0);
+		std::uint64_t frameIndex;
+		{
+			BRE_PROFILE_SCOPE("Application::Update");
+			FrameSnapshot& frame = FramePipeline::gInstance->BeginFrame();
+			frameIndex = frame.mFrameIndex;
+			// Benchmark uses a fixed time step to get the same frames in every run
+			const float elapsedTime = mBenchmark ? mBenchmark->TimeStep() : mClock.ElapsedTime();
+			if (BRE::Keyboard::gInstance->WasKeyPressedThisFrame(DIK_ESCAPE)) {
+				PostQuitMessage(0);
+			}
+#ifdef BRE_PROFILING
+			if (BRE::Keyboard::gInstance->WasKeyPressedThisFrame(DIK_F11)) {
+				Profiler::gInstance->RequestCapture(sProfilerCaptureFile, sProfilerCaptureFrames);
+			}
+#endif
+			Keyboard::gInstance->Update();
+			Mouse::gInstance->Update();		
+			if (mBenchmark) {
+				UpdateBenchmark();
+			}
+			else {
+				Camera::gInstance->Update(elapsedTime);
+			}
+			{
+				BRE_PROFILE_SCOPE("Components");
+				for (Component* component : mComponents) {
+					BRE_ASSERT(component);
+					component->Update(elapsedTime);
+				}
+			}
+			DrawManager::gInstance->UpdateTransforms(frame);
+			frame.SetCamera(*Camera::gInstance);
+			frame.mElapsedTime = elapsedTime;
+			frame.mFrameRate = mClock.FrameRate();
 		}
-		Keyboard::gInstance->Update();
-		Mouse::gInstance->Update();		
-		Camera::gInstance->Update(elapsedTime);
-		for (Component* component : mComponents) {
-			BRE_ASSERT(component);
-			component->Update(elapsedTime);
+		FramePipeline::gInstance->EndFrame();
+
+		if (mBenchmark) {
+			// Profiler is not always compiled in, so the main thread frame time is taken from the clock
+			mBenchmark->EndFrame(frameIndex, mClock.ElapsedTime() * 1000.0);
+			{
+				std::lock_guard<std::mutex> lock(mGpuFramesMutex);
+				for (const GpuFrame& gpuFrame : mGpuFrames) {
+					mBenchmark->SetGpuMs(gpuFrame.mFrame, gpuFrame.mMs);
+				}
+				mGpuFrames.clear();
+			}
+			if (mBenchmark->IsFinished()) {
+				const bool reportWritten = mBenchmark->WriteReport();
+				BRE_ASSERT(reportWritten);
+				PostQuitMessage(0);
+			}
+		}
+	}
+
+	void Application::Submit(const FrameSnapshot& frame) {
+		// They use the immediate context
+		MaterialManager::gInstance->Update();
+		if (TextureStreamer::gInstance) {
+			TextureStreamer::gInstance->Update();
+		}
+		DrawManager::gInstance->DrawAll(frame, *mDevice, *mContext, *mSwapChain, *mBackBufferRTV, *mDepthStencilView, *mDepthStencilSRV);
+		// Only the last frame resolved while this one began is kept by the profiler
+		const GpuProfiler& gpuProfiler = DrawManager::gInstance->GpuPassProfiler();
+		if (mBenchmark && gpuProfiler.ResolvedFrames() != mResolvedGpuFrames) {
+			mResolvedGpuFrames = gpuProfiler.ResolvedFrames();
+			const GpuFrame gpuFrame = { gpuProfiler.Frame(), gpuProfiler.FrameMs() };
+			std::lock_guard<std::mutex> lock(mGpuFramesMutex);
+			mGpuFrames.push_back(gpuFrame);
 		}
-		std::wostringstream frameRate;
-		frameRate << mClock.FrameRate();
-		DrawManager::gInstance->FrameRateDrawer().Text() = frameRate.str();
-		DrawManager::gInstance->DrawAll(*mDevice, *mContext, *mSwapChain, *mBackBufferRTV, *mDepthStencilView, *mDepthStencilSRV);
+
+		// Counters are added while the frame is submitted, so its frame ends here and
+		// not when the simulation thread ends the frame it runs ahead.
+#ifdef BRE_PROFILING
+		Profiler::gInstance->EndFrame();
+#endif
+		RenderCounters::gInstance->EndFrame();
+	}
+
+	void Application::UpdateBenchmark() {
+		BRE_ASSERT(mBenchmark);
+		CameraPath::Key key;
+		mBenchmark->CurrentKey(key);
+		Camera& camera = *Camera::gInstance;
+		camera.SetPosition(key.mTranslation[0], key.mTranslation[1], key.mTranslation[2]);
+		camera.ResetRotation();
+		camera.ApplyRotation(XMMatrixRotationX(key.mRotation[0]) * XMMatrixRotationY(key.mRotation[1]) * XMMatrixRotationZ(key.mRotation[2]));
+		camera.UpdateViewMatrix();
 	}
 }
\ No newline at end of file
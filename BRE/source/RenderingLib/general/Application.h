@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstdint>
+#include <mutex>
 #include <vector>
 
 #include <general/Clock.h>
@@ -13,7 +15,9 @@ struct ID3D11ShaderResourceView;
 struct IDXGISwapChain1;
 
 namespace BRE {
+	class Benchmark;
 	class Component;
+	struct FrameSnapshot;
 
 	class Application {
 	public:
@@ -27,7 +31,12 @@ namespace BRE {
 		void Run();
 
 	private:
+		// Simulation stage (main thread)
 		void Update();
+		void UpdateBenchmark();
+		// Submit stage (render thread, see FramePipeline)
+		void Submit(const FrameSnapshot& frame);
+
 		WNDCLASSEX mWindowClass;
 		HWND mWindowHandle;
 
@@ -43,7 +52,20 @@ namespace BRE {
 		ID3D11ShaderResourceView* mDepthStencilSRV;
 
 		Clock mClock;
+		// Frames simulated ahead of the submitted one. 0 to simulate and submit in the main thread.
+		unsigned int mFrameLatency = 0U;
+		// GPU times resolved by the render thread that the benchmark has not taken yet
+		struct GpuFrame {
+			std::uint64_t mFrame;
+			double mMs;
+		};
+		std::vector<GpuFrame> mGpuFrames;
+		std::mutex mGpuFramesMutex;
+		size_t mResolvedGpuFrames = 0U;
 
 		std::vector<Component*> mComponents;
+
+		// Only created when settings.yml has a benchmark file
+		Benchmark* mBenchmark = nullptr;
 	};
 }
\ No newline at end of file
@@ -0,0 +1,140 @@
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+
+#include <utils/Assert.h>
+
+namespace {
+	void WriteSummary(std::ostream& stream, const char* name, const BRE::Benchmark::Summary& summary) {
+		stream << "  \"" << name << "\": {"
+			<< "\"count\": " << summary.mCount
+			<< ", \"mean\": " << summary.mMean
+			<< ", \"min\": " << summary.mMin
+			<< ", \"max\": " << summary.mMax
+			<< ", \"p50\": " << summary.mP50
+			<< ", \"p95\": " << summary.mP95
+			<< ", \"p99\": " << summary.mP99 << "}";
+	}
+}
+
+namespace BRE {
+	Benchmark::Benchmark(const Settings& settings, const CameraPath& path)
+		: mSettings(settings)
+		, mPath(path)
+		, mWarmupFramesLeft(settings.mWarmupFrames)
+	{
+		BRE_ASSERT(settings.mTimeStep > 0.0f);
+		BRE_ASSERT(!path.Empty());
+		BRE_ASSERT(!settings.mReportFilepath.empty());
+		mSamples.reserve(static_cast<size_t>(path.Duration() / settings.mTimeStep) + 1U);
+	}
+
+	void Benchmark::CurrentKey(CameraPath::Key& key) const {
+		mPath.Evaluate(mPath.StartTime() + mFrameIndex * mSettings.mTimeStep, key);
+	}
+
+	void Benchmark::EndFrame(const std::uint64_t frame, const double cpuMs) {
+		if (mFinished) {
+			return;
+		}
+		if (mWarmupFramesLeft > 0U) {
+			--mWarmupFramesLeft;
+			return;
+		}
+
+		BRE_ASSERT(mSamples.empty() || frame > mSamples.back().mFrame);
+		const Sample sample = { frame, cpuMs, -1.0 };
+		mSamples.push_back(sample);
+		++mFrameIndex;
+		mFinished = mFrameIndex * mSettings.mTimeStep > mPath.Duration();
+	}
+
+	void Benchmark::SetGpuMs(const std::uint64_t frame, const double gpuMs) {
+		BRE_ASSERT(gpuMs >= 0.0);
+		// Samples are sorted by frame
+		const std::vector<Sample>::iterator it = std::lower_bound(mSamples.begin(), mSamples.end(), frame, [](const Sample& sample, const std::uint64_t f) { return sample.mFrame < f; });
+		if (it != mSamples.end() && it->mFrame == frame) {
+			it->mGpuMs = gpuMs;
+		}
+	}
+
+	bool Benchmark::WriteReport() const {
+		std::vector<double> cpuMs;
+		std::vector<double> gpuMs;
+		cpuMs.reserve(mSamples.size());
+		gpuMs.reserve(mSamples.size());
+
+		// Per frame samples
+		{
+			std::ofstream stream(mSettings.mReportFilepath + ".csv", std::ios::out | std::ios::trunc);
+			if (!stream.is_open()) {
+				return false;
+			}
+			stream << std::fixed << std::setprecision(4);
+			stream << "frame,cpuMs,gpuMs\n";
+			for (size_t i = 0U; i < mSamples.size(); ++i) {
+				const Sample& sample = mSamples[i];
+				stream << i << "," << sample.mCpuMs << ",";
+				cpuMs.push_back(sample.mCpuMs);
+				if (sample.mGpuMs >= 0.0) {
+					stream << sample.mGpuMs;
+					gpuMs.push_back(sample.mGpuMs);
+				}
+				stream << "\n";
+			}
+			if (!stream.good()) {
+				return false;
+			}
+		}
+
+		// Summary
+		std::ofstream stream(mSettings.mReportFilepath + ".json", std::ios::out | std::ios::trunc);
+		if (!stream.is_open()) {
+			return false;
+		}
+		stream << std::fixed << std::setprecision(4);
+		stream << "{\n";
+		stream << "  \"timeStep\": " << mSettings.mTimeStep << ",\n";
+		stream << "  \"warmupFrames\": " << mSettings.mWarmupFrames << ",\n";
+		WriteSummary(stream, "cpuMs", Summarize(cpuMs));
+		stream << ",\n";
+		WriteSummary(stream, "gpuMs", Summarize(gpuMs));
+		stream << "\n}\n";
+
+		return stream.good();
+	}
+
+	Benchmark::Summary Benchmark::Summarize(const std::vector<double>& values) {
+		Summary summary = {};
+		summary.mCount = values.size();
+		if (values.empty()) {
+			return summary;
+		}
+
+		std::vector<double> sortedValues(values);
+		std::sort(sortedValues.begin(), sortedValues.end());
+		double sum = 0.0;
+		for (const double value : sortedValues) {
+			sum += value;
+		}
+		summary.mMean = sum / sortedValues.size();
+		summary.mMin = sortedValues.front();
+		summary.mMax = sortedValues.back();
+		summary.mP50 = Percentile(sortedValues, 50.0);
+		summary.mP95 = Percentile(sortedValues, 95.0);
+		summary.mP99 = Percentile(sortedValues, 99.0);
+		return summary;
+	}
+
+	double Benchmark::Percentile(const std::vector<double>& sortedValues, const double percentile) {
+		BRE_ASSERT(percentile >= 0.0 && percentile <= 100.0);
+		if (sortedValues.empty()) {
+			return 0.0;
+		}
+		const size_t rank = static_cast<size_t>(std::ceil(percentile / 100.0 * sortedValues.size()));
+		return sortedValues[rank == 0U ? 0U : rank - 1U];
+	}
+}
\ No newline at end of file
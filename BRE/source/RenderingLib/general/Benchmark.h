@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <general/CameraPath.h>
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Deterministic benchmark.
+// It uses a fixed time step and it drives the camera through a CameraPath.
+// First, it runs some warm-up frames at the start of the path. Then it
+// records a sample per frame until the end of the path, and finally it
+// writes <report>.csv (one row per frame) and <report>.json (summary).
+// GPU times are resolved some frames after the CPU ones, so they are set
+// on the row of the frame they belong to when they arrive. Rows whose GPU
+// time did not arrive (the last frames in flight or frames whose queries
+// were skipped) have an empty gpuMs field.
+//
+//////////////////////////////////////////////////////////////////////////
+
+namespace BRE {
+	class Benchmark {
+	public:
+		struct Settings {
+			float mTimeStep;
+			unsigned int mWarmupFrames;
+			std::string mReportFilepath;
+		};
+
+		struct Sample {
+			// FrameSnapshot::mFrameIndex
+			std::uint64_t mFrame;
+			double mCpuMs;
+			// Negative until the GPU time of the frame is set
+			double mGpuMs;
+		};
+
+		struct Summary {
+			size_t mCount;
+			double mMean;
+			double mMin;
+			double mMax;
+			double mP50;
+			double mP95;
+			double mP99;
+		};
+
+		Benchmark(const Settings& settings, const CameraPath& path);
+
+		const Benchmark& operator=(const Benchmark& rhs) = delete;
+
+		float TimeStep() const { return mSettings.mTimeStep; }
+		bool IsWarmingUp() const { return mWarmupFramesLeft > 0U; }
+		bool IsFinished() const { return mFinished; }
+
+		// Camera key of the frame in progress
+		void CurrentKey(CameraPath::Key& key) const;
+
+		// Record the CPU time of the frame in progress and advance to the next one
+		void EndFrame(const std::uint64_t frame, const double cpuMs);
+		// GPU time of a frame that was recorded. Other frames are ignored.
+		void SetGpuMs(const std::uint64_t frame, const double gpuMs);
+
+		const std::vector<Sample>& Samples() const { return mSamples; }
+
+		bool WriteReport() const;
+
+		static Summary Summarize(const std::vector<double>& values);
+		// Nearest rank percentile. Values must be sorted.
+		static double Percentile(const std::vector<double>& sortedValues, const double percentile);
+
+	private:
+		const Settings mSettings;
+		const CameraPath mPath;
+
+		unsigned int mWarmupFramesLeft;
+		unsigned int mFrameIndex = 0U;
+		bool mFinished = false;
+
+		std::vector<Sample> mSamples;
+	};
+}
\ No newline at end of file
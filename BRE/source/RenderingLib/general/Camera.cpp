@@ -1,5 +1,6 @@
 #include "Camera.h"
 
+#include <general/Profiler.h>
 #include <input/Keyboard.h>
 #include <input/Mouse.h>
 
@@ -43,7 +44,14 @@ namespace BRE {
 		XMStoreFloat3(&mUp, up);
 	}
 
+	void Camera::ResetRotation() {
+		mDirection = DirectX::XMFLOAT3(0.0f, 0.0f, 1.0f);
+		mUp = DirectX::XMFLOAT3(0.0f, 1.0f, 0.0f);
+		mRight = DirectX::XMFLOAT3(1.0f, 0.0f, 0.0f);
+	}
+
 	void Camera::Update(const float elapsedTime) {
+		BRE_PROFILE_SCOPE("Camera::Update");
 		// Update rotation
 		XMFLOAT2 rotationAmount = DirectX::XMFLOAT2(0.0f, 0.0f);
 		if (Mouse::gInstance->IsButtonHeldDown(Mouse::MouseButtonsLeft)) {
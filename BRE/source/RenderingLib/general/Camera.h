@@ -63,6 +63,8 @@ namespace BRE {
 
 		void ApplyRotation(const DirectX::XMFLOAT4X4& transform) { ApplyRotation(DirectX::XMLoadFloat4x4(&transform)); }
 		void ApplyRotation(DirectX::CXMMATRIX transform);
+		// Go back to the initial orientation, so next ApplyRotation() is absolute
+		void ResetRotation();
 
 		void Update(const float elapsedTime);
 
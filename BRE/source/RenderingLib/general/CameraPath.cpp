@@ -0,0 +1,59 @@
+#include "CameraPath.h"
+
+#include <algorithm>
+
+#include <utils/Assert.h>
+
+namespace {
+	float CatmullRom(const float p0, const float p1, const float p2, const float p3, const float t) {
+		const float t2 = t * t;
+		const float t3 = t2 * t;
+		return 0.5f * ((2.0f * p1) + (-p0 + p2) * t + (2.0f * p0 - 5.0f * p1 + 4.0f * p2 - p3) * t2 + (-p0 + 3.0f * p1 - 3.0f * p2 + p3) * t3);
+	}
+}
+
+namespace BRE {
+	void CameraPath::AddKey(const Key& key) {
+		BRE_ASSERT(mKeys.empty() || key.mTime > mKeys.back().mTime);
+		mKeys.push_back(key);
+	}
+
+	float CameraPath::StartTime() const {
+		return mKeys.empty() ? 0.0f : mKeys.front().mTime;
+	}
+
+	float CameraPath::Duration() const {
+		return mKeys.empty() ? 0.0f : mKeys.back().mTime - mKeys.front().mTime;
+	}
+
+	void CameraPath::Evaluate(const float time, Key& result) const {
+		BRE_ASSERT(!mKeys.empty());
+		if (mKeys.size() == 1U || time <= mKeys.front().mTime) {
+			result = mKeys.front();
+			result.mTime = time;
+			return;
+		}
+		if (time >= mKeys.back().mTime) {
+			result = mKeys.back();
+			result.mTime = time;
+			return;
+		}
+
+		// Segment [i, i + 1] that contains time
+		const std::vector<Key>::const_iterator it = std::upper_bound(mKeys.begin(), mKeys.end(), time, [](const float t, const Key& key) { return t < key.mTime; });
+		const size_t i = static_cast<size_t>(it - mKeys.begin()) - 1U;
+
+		// End points are duplicated to get control points outside the path
+		const Key& k0 = mKeys[i == 0U ? 0U : i - 1U];
+		const Key& k1 = mKeys[i];
+		const Key& k2 = mKeys[i + 1U];
+		const Key& k3 = mKeys[std::min(i + 2U, mKeys.size() - 1U)];
+		const float t = (time - k1.mTime) / (k2.mTime - k1.mTime);
+
+		result.mTime = time;
+		for (size_t c = 0U; c < 3U; ++c) {
+			result.mTranslation[c] = CatmullRom(k0.mTranslation[c], k1.mTranslation[c], k2.mTranslation[c], k3.mTranslation[c], t);
+			result.mRotation[c] = CatmullRom(k0.mRotation[c], k1.mRotation[c], k2.mRotation[c], k3.mRotation[c], t);
+		}
+	}
+}
\ No newline at end of file
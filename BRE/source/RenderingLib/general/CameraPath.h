@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Camera path defined by timed keys (translation and rotation) that is
+// evaluated with a Catmull-Rom spline. Rotation is in radians and it is
+// applied as Camera::InputData::mRotation (X, then Y, then Z).
+//
+//////////////////////////////////////////////////////////////////////////
+
+namespace BRE {
+	class CameraPath {
+	public:
+		struct Key {
+			float mTime;
+			float mTranslation[3];
+			float mRotation[3];
+		};
+
+		// Keys must be added in increasing time order
+		void AddKey(const Key& key);
+
+		bool Empty() const { return mKeys.empty(); }
+		size_t NumKeys() const { return mKeys.size(); }
+		float StartTime() const;
+		float Duration() const;
+
+		// Time is clamped to [first key time, last key time]
+		void Evaluate(const float time, Key& result) const;
+
+	private:
+		std::vector<Key> mKeys;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <general/RenderCounters.h>
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Immediate context calls that bind shaders, resources and geometry
+// buffers or draw, counted in RenderCounters. Shader data classes and
+// managers make these calls through here, so the counters follow the
+// calls they make. Context is ID3D11DeviceContext1 (a stand-in in tests),
+// so this header does not include Direct3D ones.
+// Unbinding after a draw (null shaders and views) is not counted and
+// uses the context directly.
+//
+//////////////////////////////////////////////////////////////////////////
+
+namespace BRE {
+	namespace CountedContext {
+		template<typename Context, typename Shader>
+		void VSSetShader(Context& context, Shader* shader) {
+			context.VSSetShader(shader, nullptr, 0);
+			BRE_COUNTER_ADD(RenderCounter::ShaderBinds, 1U);
+		}
+
+		template<typename Context, typename Shader>
+		void HSSetShader(Context& context, Shader* shader) {
+			context.HSSetShader(shader, nullptr, 0);
+			BRE_COUNTER_ADD(RenderCounter::ShaderBinds, 1U);
+		}
+
+		template<typename Context, typename Shader>
+		void DSSetShader(Context& context, Shader* shader) {
+			context.DSSetShader(shader, nullptr, 0);
+			BRE_COUNTER_ADD(RenderCounter::ShaderBinds, 1U);
+		}
+
+		template<typename Context, typename Shader>
+		void GSSetShader(Context& context, Shader* shader) {
+			context.GSSetShader(shader, nullptr, 0);
+			BRE_COUNTER_ADD(RenderCounter::ShaderBinds, 1U);
+		}
+
+		template<typename Context, typename Shader>
+		void PSSetShader(Context& context, Shader* shader) {
+			context.PSSetShader(shader, nullptr, 0);
+			BRE_COUNTER_ADD(RenderCounter::ShaderBinds, 1U);
+		}
+
+		template<typename Context, typename Buffer>
+		void VSSetConstantBuffers(Context& context, const unsigned int startSlot, const unsigned int numBuffers, Buffer* const* buffers) {
+			context.VSSetConstantBuffers(startSlot, numBuffers, buffers);
+			BRE_COUNTER_ADD(RenderCounter::ConstantBufferBinds, numBuffers);
+		}
+
+		template<typename Context, typename Buffer>
+		void HSSetConstantBuffers(Context& context, const unsigned int startSlot, const unsigned int numBuffers, Buffer* const* buffers) {
+			context.HSSetConstantBuffers(startSlot, numBuffers, buffers);
+			BRE_COUNTER_ADD(RenderCounter::ConstantBufferBinds, numBuffers);
+		}
+
+		template<typename Context, typename Buffer>
+		void DSSetConstantBuffers(Context& context, const unsigned int startSlot, const unsigned int numBuffers, Buffer* const* buffers) {
+			context.DSSetConstantBuffers(startSlot, numBuffers, buffers);
+			BRE_COUNTER_ADD(RenderCounter::ConstantBufferBinds, numBuffers);
+		}
+
+		template<typename Context, typename Buffer>
+		void GSSetConstantBuffers(Context& context, const unsigned int startSlot, const unsigned int numBuffers, Buffer* const* buffers) {
+			context.GSSetConstantBuffers(startSlot, numBuffers, buffers);
+			BRE_COUNTER_ADD(RenderCounter::ConstantBufferBinds, numBuffers);
+		}
+
+		template<typename Context, typename Buffer>
+		void PSSetConstantBuffers(Context& context, const unsigned int startSlot, const unsigned int numBuffers, Buffer* const* buffers) {
+			context.PSSetConstantBuffers(startSlot, numBuffers, buffers);
+			BRE_COUNTER_ADD(RenderCounter::ConstantBufferBinds, numBuffers);
+		}
+
+		template<typename Context, typename View>
+		void DSSetShaderResources(Context& context, const unsigned int startSlot, const unsigned int numViews, View* const* views) {
+			context.DSSetShaderResources(startSlot, numViews, views);
+			BRE_COUNTER_ADD(RenderCounter::SRVBinds, numViews);
+		}
+
+		template<typename Context, typename View>
+		void PSSetShaderResources(Context& context, const unsigned int startSlot, const unsigned int numViews, View* const* views) {
+			context.PSSetShaderResources(startSlot, numViews, views);
+			BRE_COUNTER_ADD(RenderCounter::SRVBinds, numViews);
+		}
+
+		template<typename Context, typename Sampler>
+		void DSSetSamplers(Context& context, const unsigned int startSlot, const unsigned int numSamplers, Sampler* const* samplers) {
+			context.DSSetSamplers(startSlot, numSamplers, samplers);
+			BRE_COUNTER_ADD(RenderCounter::SamplerBinds, numSamplers);
+		}
+
+		template<typename Context, typename Sampler>
+		void PSSetSamplers(Context& context, const unsigned int startSlot, const unsigned int numSamplers, Sampler* const* samplers) {
+			context.PSSetSamplers(startSlot, numSamplers, samplers);
+			BRE_COUNTER_ADD(RenderCounter::SamplerBinds, numSamplers);
+		}
+
+		template<typename Context, typename Buffer>
+		void IASetVertexBuffers(Context& context, const unsigned int startSlot, const unsigned int numBuffers, Buffer* const* buffers, const unsigned int* strides, const unsigned int* offsets) {
+			context.IASetVertexBuffers(startSlot, numBuffers, buffers, strides, offsets);
+			BRE_COUNTER_ADD(RenderCounter::GeometryBufferBinds, numBuffers);
+		}
+
+		template<typename Context, typename Buffer, typename Format>
+		void IASetIndexBuffer(Context& context, Buffer* buffer, const Format format, const unsigned int offset) {
+			context.IASetIndexBuffer(buffer, format, offset);
+			BRE_COUNTER_ADD(RenderCounter::GeometryBufferBinds, 1U);
+		}
+
+		template<typename Context>
+		void Draw(Context& context, const unsigned int vertexCount, const unsigned int startVertex) {
+			context.Draw(vertexCount, startVertex);
+			BRE_COUNTER_ADD(RenderCounter::DrawCalls, 1U);
+		}
+
+		template<typename Context>
+		void DrawIndexed(Context& context, const unsigned int indexCount, const unsigned int startIndex, const int baseVertex) {
+			context.DrawIndexed(indexCount, startIndex, baseVertex);
+			BRE_COUNTER_ADD(RenderCounter::DrawCalls, 1U);
+			BRE_COUNTER_ADD(RenderCounter::Indices, indexCount);
+		}
+	}
+}
\ No newline at end of file
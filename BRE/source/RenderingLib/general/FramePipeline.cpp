@@ -0,0 +1,100 @@
+#include "FramePipeline.h"
+
+#include <general/Profiler.h>
+#include <utils/Assert.h>
+
+namespace BRE {
+	FramePipeline* FramePipeline::gInstance = nullptr;
+
+	FramePipeline::FramePipeline(const unsigned int frameLatency, const SubmitFunction& submit)
+		: mFrameLatency(frameLatency)
+		, mSubmit(submit)
+		, mSnapshots(frameLatency + 1U)
+	{
+		BRE_ASSERT(frameLatency <= sMaxFrameLatency);
+		BRE_ASSERT(mSubmit);
+		if (mFrameLatency > 0U) {
+			mRenderThread = std::thread(&FramePipeline::RenderThread, this);
+		}
+	}
+
+	FramePipeline::~FramePipeline() {
+		BRE_ASSERT(mSimulationFrame == nullptr);
+		if (mRenderThread.joinable()) {
+			{
+				std::lock_guard<std::mutex> lock(mMutex);
+				mExit = true;
+			}
+			mFrameWritten.notify_one();
+			mRenderThread.join();
+		}
+	}
+
+	FrameSnapshot& FramePipeline::BeginFrame() {
+		BRE_ASSERT(mSimulationFrame == nullptr);
+		mSimulationFrame = mSnapshots.TryBeginWrite();
+		if (mSimulationFrame == nullptr) {
+			BRE_PROFILE_SCOPE("FramePipeline::WaitForSubmit");
+			std::unique_lock<std::mutex> lock(mMutex);
+			mFrameSubmitted.wait(lock, [this]() { return (mSimulationFrame = mSnapshots.TryBeginWrite()) != nullptr; });
+		}
+		mSimulationFrame->mFrameIndex = mNumSimulatedFrames;
+		mSimulationFrame->mDirLights.clear();
+		mSimulationFrame->mTransformUpdates.clear();
+		return *mSimulationFrame;
+	}
+
+	void FramePipeline::EndFrame() {
+		BRE_ASSERT(mSimulationFrame);
+		mSimulationFrame = nullptr;
+		mSnapshots.EndWrite();
+		++mNumSimulatedFrames;
+		if (mFrameLatency == 0U) {
+			SubmitPendingFrames();
+		}
+		else {
+			// The render thread checks the ring with the mutex locked, so it
+			// either sees the frame or is waiting when it is notified.
+			{
+				std::lock_guard<std::mutex> lock(mMutex);
+			}
+			mFrameWritten.notify_one();
+		}
+	}
+
+	void FramePipeline::SubmitPendingFrames() {
+		while (const FrameSnapshot* frame = mSnapshots.TryBeginRead()) {
+			{
+				BRE_PROFILE_SCOPE("FramePipeline::Submit");
+				mSubmit(*frame);
+			}
+			// Counted before the slot is released, so simulation never sees
+			// more than the frame latency pending
+			mNumSubmittedFrames.fetch_add(1U, std::memory_order_release);
+			mSnapshots.EndRead();
+			if (mFrameLatency > 0U) {
+				{
+					std::lock_guard<std::mutex> lock(mMutex);
+				}
+				mFrameSubmitted.notify_one();
+			}
+		}
+	}
+
+	void FramePipeline::RenderThread() {
+		// Exit is read before the ring is drained, so frames published before
+		// destruction are submitted.
+		for (;;) {
+			bool exit;
+			{
+				std::unique_lock<std::mutex> lock(mMutex);
+				mFrameWritten.wait(lock, [this]() { return mExit || mSnapshots.NumPending() > 0U; });
+				exit = mExit;
+			}
+			SubmitPendingFrames();
+			if (exit) {
+				return;
+			}
+		}
+	}
+}
\ No newline at end of file
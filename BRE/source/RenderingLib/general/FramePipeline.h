@@ -0,0 +1,77 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+#include <general/FrameSnapshot.h>
+#include <utils/Assert.h>
+#include <utils/SnapshotRing.h>
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Two stage frame pipeline. The main thread simulates a frame and writes
+// its FrameSnapshot between BeginFrame() and EndFrame(), while a render
+// thread submits previous frames (submit function) from their snapshots.
+// Frame latency is the number of frames simulation can run ahead of the
+// frame being submitted (1 or 2). With 0 there is no render thread:
+// EndFrame() submits the frame right away.
+// Snapshots are handed through a SnapshotRing, so neither stage locks
+// while the other one has work for it. A stage that has to wait for the
+// other one blocks on a condition variable until it is notified.
+// The submit stage owns the immediate context: everything that uses it
+// must be done there.
+//
+//////////////////////////////////////////////////////////////////////////
+
+namespace BRE {
+	class FramePipeline {
+	public:
+		static FramePipeline* gInstance;
+
+		static const unsigned int sMaxFrameLatency = 2U;
+
+		typedef std::function<void(const FrameSnapshot&)> SubmitFunction;
+
+		FramePipeline(const unsigned int frameLatency, const SubmitFunction& submit);
+		// Pending frames are submitted before the render thread ends
+		~FramePipeline();
+
+		const FramePipeline& operator=(const FramePipeline& rhs) = delete;
+
+		// Main thread. It waits while every snapshot is pending.
+		FrameSnapshot& BeginFrame();
+		void EndFrame();
+
+		// Snapshot of the frame being simulated (between BeginFrame() and EndFrame())
+		FrameSnapshot& SimulationFrame() { BRE_ASSERT(mSimulationFrame); return *mSimulationFrame; }
+
+		unsigned int FrameLatency() const { return mFrameLatency; }
+		// Frames simulated and frames submitted since creation
+		std::uint64_t NumSimulatedFrames() const { return mNumSimulatedFrames; }
+		std::uint64_t NumSubmittedFrames() const { return mNumSubmittedFrames.load(std::memory_order_acquire); }
+
+	private:
+		void SubmitPendingFrames();
+		void RenderThread();
+
+		const unsigned int mFrameLatency;
+		const SubmitFunction mSubmit;
+
+		SnapshotRing<FrameSnapshot> mSnapshots;
+		FrameSnapshot* mSimulationFrame = nullptr;
+		std::uint64_t mNumSimulatedFrames = 0U;
+		std::atomic<std::uint64_t> mNumSubmittedFrames{ 0U };
+
+		// Guards waits and mExit. Each stage notifies the other one after it
+		// publishes or releases a snapshot.
+		std::mutex mMutex;
+		std::condition_variable mFrameWritten;
+		std::condition_variable mFrameSubmitted;
+		bool mExit = false;
+		std::thread mRenderThread;
+	};
+}
\ No newline at end of file
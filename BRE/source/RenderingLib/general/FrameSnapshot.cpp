@@ -0,0 +1,14 @@
+#include "FrameSnapshot.h"
+
+#include <general/Camera.h>
+
+using namespace DirectX;
+
+namespace BRE {
+	void FrameSnapshot::SetCamera(const Camera& camera) {
+		XMStoreFloat4x4(&mViewMatrix, camera.ViewMatrix());
+		XMStoreFloat4x4(&mProjectionMatrix, camera.ProjectionMatrix());
+		mNearPlaneDistance = camera.NearPlaneDistance();
+		mFarPlaneDistance = camera.FarPlaneDistance();
+	}
+}
\ No newline at end of file
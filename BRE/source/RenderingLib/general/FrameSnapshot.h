@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstdint>
+#include <DirectXMath.h>
+#include <vector>
+
+#include <rendering/shaders/LightsData.h>
+
+//////////////////////////////////////////////////////////////////////////
+//
+// State of a frame that simulation hands to submission (see FramePipeline).
+// Simulation writes it, then it is only read while the frame is drawn, so
+// rendering never reads simulation objects (Camera, components) that are
+// already updating the next frame.
+// Only world matrices of transform hierarchy nodes that changed in the
+// frame are copied (see DrawManager::UpdateTransforms()).
+//
+//////////////////////////////////////////////////////////////////////////
+
+namespace BRE {
+	class Camera;
+
+	struct FrameSnapshot {
+		void SetCamera(const Camera& camera);
+
+		DirectX::XMFLOAT4X4 mViewMatrix;
+		DirectX::XMFLOAT4X4 mProjectionMatrix;
+		float mNearPlaneDistance;
+		float mFarPlaneDistance;
+
+		// View space directions. Cleared when the frame begins.
+		std::vector<DirectionalLightData> mDirLights;
+
+		struct TransformUpdate {
+			// TransformHierarchy node
+			size_t mNode;
+			DirectX::XMFLOAT4X4 mWorld;
+		};
+		// Parents before children. Cleared when the frame begins.
+		std::vector<TransformUpdate> mTransformUpdates;
+
+		// Frames simulated before this one. Set when the frame begins.
+		std::uint64_t mFrameIndex;
+		float mElapsedTime;
+		unsigned int mFrameRate;
+	};
+}
\ No newline at end of file
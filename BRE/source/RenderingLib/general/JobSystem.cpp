@@ -0,0 +1,427 @@
+#include "JobSystem.h"
+
+#include <algorithm>
+
+#include <general/Profiler.h>
+#include <utils/Assert.h>
+
+namespace {
+	// Jobs of each worker deque. When it is full, pushed jobs are run right away.
+	const size_t sDequeCapacity = 4096U;
+	// Failed searches (yielding between them) before a worker sleeps
+	const unsigned int sSpinRounds = 64U;
+	// Jobs allocated at once when the pools are empty
+	const size_t sJobsPerBlock = 256U;
+	// Free jobs a worker keeps. Half of them go back to the shared pool
+	// beyond that (thieves free jobs that other workers created).
+	const size_t sMaxWorkerFreeJobs = 2U * sJobsPerBlock;
+
+	std::atomic<std::uint32_t> sNextGeneration(1U);
+
+	// Worker index of the current thread and the job system instance it belongs to
+	thread_local int sWorkerIndex = -1;
+	thread_local std::uint32_t sWorkerGeneration = 0U;
+	thread_local std::uint32_t sRandomState = 0U;
+
+	// xorshift32, to choose steal victims
+	std::uint32_t NextRandom() {
+		std::uint32_t x = sRandomState;
+		if (x == 0U) {
+			x = static_cast<std::uint32_t>(std::hash<std::thread::id>()(std::this_thread::get_id())) | 1U;
+		}
+		x ^= x << 13U;
+		x ^= x >> 17U;
+		x ^= x << 5U;
+		sRandomState = x;
+		return x;
+	}
+
+	// Profiler zone of named jobs
+	class JobZone {
+	public:
+		explicit JobZone(const char* name)
+			: mName(name)
+		{
+#ifdef BRE_PROFILING
+			if (mName) {
+				BRE::Profiler::gInstance->BeginZone(mName);
+			}
+#endif
+		}
+
+		~JobZone() {
+#ifdef BRE_PROFILING
+			if (mName) {
+				BRE::Profiler::gInstance->EndZone();
+			}
+#endif
+		}
+
+		JobZone(const JobZone&) = delete;
+		const JobZone& operator=(const JobZone& rhs) = delete;
+
+	private:
+		const char* mName;
+	};
+}
+
+namespace BRE {
+	JobSystem* JobSystem::gInstance = nullptr;
+
+	// Chase-Lev deque of fixed capacity ("Correct and Efficient Work-Stealing
+	// for Weak Memory Models", Le et al. 2013). The owner pushes and pops at
+	// the bottom, thieves take from the top. Fences of the paper are done by
+	// sequentially consistent accesses.
+	struct JobSystem::Worker {
+		Worker()
+			: mJobs(sDequeCapacity)
+		{
+		}
+
+		bool Push(Job* job) {
+			const std::int64_t bottom = mBottom.load(std::memory_order_relaxed);
+			const std::int64_t top = mTop.load(std::memory_order_acquire);
+			if (bottom - top >= static_cast<std::int64_t>(sDequeCapacity)) {
+				return false;
+			}
+			mJobs[static_cast<size_t>(bottom) & (sDequeCapacity - 1U)].store(job, std::memory_order_relaxed);
+			mBottom.store(bottom + 1, std::memory_order_release);
+			return true;
+		}
+
+		Job* Pop() {
+			const std::int64_t bottom = mBottom.load(std::memory_order_relaxed) - 1;
+			mBottom.store(bottom, std::memory_order_seq_cst);
+			std::int64_t top = mTop.load(std::memory_order_seq_cst);
+			if (top > bottom) {
+				// Empty
+				mBottom.store(bottom + 1, std::memory_order_relaxed);
+				return nullptr;
+			}
+			Job* job = mJobs[static_cast<size_t>(bottom) & (sDequeCapacity - 1U)].load(std::memory_order_relaxed);
+			if (top == bottom) {
+				// Last job: thieves can take it too
+				if (!mTop.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+					job = nullptr;
+				}
+				mBottom.store(bottom + 1, std::memory_order_relaxed);
+			}
+			return job;
+		}
+
+		Job* Steal() {
+			std::int64_t top = mTop.load(std::memory_order_seq_cst);
+			const std::int64_t bottom = mBottom.load(std::memory_order_seq_cst);
+			if (top >= bottom) {
+				return nullptr;
+			}
+			Job* job = mJobs[static_cast<size_t>(top) & (sDequeCapacity - 1U)].load(std::memory_order_relaxed);
+			// Another thief or the owner took it
+			if (!mTop.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+				return nullptr;
+			}
+			return job;
+		}
+
+		bool IsEmpty() const { return mTop.load(std::memory_order_acquire) >= mBottom.load(std::memory_order_acquire); }
+
+		// Job pool of the worker thread (no locks)
+		Job* mFreeJobs = nullptr;
+		size_t mNumFreeJobs = 0U;
+
+		// Top and bottom are in different cache lines
+		std::atomic<std::int64_t> mTop{ 0 };
+		char mPadding[64U];
+		std::atomic<std::int64_t> mBottom{ 0 };
+		std::vector<std::atomic<Job*>> mJobs;
+	};
+
+	JobCounter::~JobCounter() {
+		BRE_ASSERT(IsDone());
+		BRE_ASSERT(mWaitingJobs.empty());
+	}
+
+	JobSystem::JobSystem(const unsigned int numThreads)
+		: mGeneration(sNextGeneration.fetch_add(1U))
+	{
+		const unsigned int count = numThreads > 0U ? numThreads : (std::max)(std::thread::hardware_concurrency(), 1U);
+		for (unsigned int i = 0U; i < count; ++i) {
+			mWorkers.emplace_back(new Worker());
+		}
+		sWorkerIndex = 0;
+		sWorkerGeneration = mGeneration;
+		for (unsigned int i = 1U; i < count; ++i) {
+			mThreads.emplace_back(&JobSystem::WorkerThread, this, i);
+		}
+	}
+
+	JobSystem::~JobSystem() {
+		{
+			std::lock_guard<std::mutex> lock(mSleepMutex);
+			mExit = true;
+			++mWakeEpoch;
+		}
+		mSleepCondition.notify_all();
+		for (std::thread& thread : mThreads) {
+			thread.join();
+		}
+#ifdef _DEBUG
+		for (const std::unique_ptr<Worker>& worker : mWorkers) {
+			BRE_ASSERT(worker->IsEmpty());
+		}
+#endif
+		BRE_ASSERT(mSharedJobs.empty());
+		if (WorkerIndex() == 0) {
+			sWorkerIndex = -1;
+		}
+	}
+
+	void JobSystem::Schedule(Job* job, JobCounter* dependency) {
+		BRE_ASSERT(job);
+		if (dependency) {
+			std::lock_guard<std::mutex> lock(dependency->mMutex);
+			if (dependency->mValue.load(std::memory_order_acquire) > 0U) {
+				dependency->mWaitingJobs.push_back(job);
+				return;
+			}
+		}
+		Push(job);
+	}
+
+	void JobSystem::Wait(const JobCounter& counter) {
+		if (counter.IsDone()) {
+			return;
+		}
+		BRE_PROFILE_SCOPE("JobSystem::Wait");
+		const int workerIndex = WorkerIndex();
+		while (!counter.IsDone()) {
+			Job* job = FindJob(workerIndex);
+			if (job) {
+				Execute(job);
+			}
+			else {
+				std::this_thread::yield();
+			}
+		}
+	}
+
+	void JobSystem::ParallelFor(const size_t begin, const size_t end, const size_t grainSize, const RangeFunction& function, const char* name) {
+		BRE_ASSERT(grainSize > 0U);
+		BRE_ASSERT(function);
+		if (begin >= end) {
+			return;
+		}
+		JobCounter counter;
+		ParallelForRange(begin, end, grainSize, function, counter, name);
+		Wait(counter);
+	}
+
+	int JobSystem::WorkerIndex() const {
+		return sWorkerGeneration == mGeneration ? sWorkerIndex : -1;
+	}
+
+	JobSystem::Job* JobSystem::CreateJob(JobCounter* counter, const char* name) {
+		if (counter) {
+			counter->mValue.fetch_add(1U, std::memory_order_relaxed);
+		}
+
+		const int workerIndex = WorkerIndex();
+		Worker* worker = workerIndex >= 0 ? mWorkers[workerIndex].get() : nullptr;
+		Job* job = worker ? worker->mFreeJobs : nullptr;
+		if (job) {
+			worker->mFreeJobs = job->mNext;
+			--worker->mNumFreeJobs;
+		}
+		else {
+			std::lock_guard<std::mutex> lock(mPoolMutex);
+			if (mSharedFreeJobs == nullptr) {
+				// Jobs are aligned to cache lines, so workers do not share them
+				const size_t blockSize = sJobsPerBlock * sizeof(Job) + alignof(Job);
+				mJobBlocks.emplace_back(new unsigned char[blockSize]);
+				void* jobs = mJobBlocks.back().get();
+				size_t space = blockSize;
+				jobs = std::align(alignof(Job), sJobsPerBlock * sizeof(Job), jobs, space);
+				BRE_ASSERT(jobs);
+				for (size_t i = 0U; i < sJobsPerBlock; ++i) {
+					Job* freeJob = new (static_cast<Job*>(jobs) + i) Job();
+					freeJob->mNext = mSharedFreeJobs;
+					mSharedFreeJobs = freeJob;
+				}
+			}
+			job = mSharedFreeJobs;
+			mSharedFreeJobs = job->mNext;
+		}
+		job->mRun = nullptr;
+		job->mCounter = counter;
+		job->mName = name;
+		job->mNext = nullptr;
+		return job;
+	}
+
+	void JobSystem::FreeJob(Job* job) {
+		BRE_ASSERT(job);
+		const int workerIndex = WorkerIndex();
+		if (workerIndex < 0) {
+			std::lock_guard<std::mutex> lock(mPoolMutex);
+			job->mNext = mSharedFreeJobs;
+			mSharedFreeJobs = job;
+			return;
+		}
+
+		Worker& worker = *mWorkers[workerIndex];
+		job->mNext = worker.mFreeJobs;
+		worker.mFreeJobs = job;
+		if (++worker.mNumFreeJobs <= sMaxWorkerFreeJobs) {
+			return;
+		}
+		// Half of them go back, so workers that only create jobs find them
+		Job* first = worker.mFreeJobs;
+		Job* last = first;
+		for (size_t i = 1U; i < sMaxWorkerFreeJobs / 2U; ++i) {
+			last = last->mNext;
+		}
+		worker.mFreeJobs = last->mNext;
+		worker.mNumFreeJobs -= sMaxWorkerFreeJobs / 2U;
+		std::lock_guard<std::mutex> lock(mPoolMutex);
+		last->mNext = mSharedFreeJobs;
+		mSharedFreeJobs = first;
+	}
+
+	void JobSystem::Push(Job* job) {
+		BRE_ASSERT(job);
+		const int workerIndex = WorkerIndex();
+		if (workerIndex >= 0) {
+			if (!mWorkers[workerIndex]->Push(job)) {
+				Execute(job);
+				return;
+			}
+		}
+		else {
+			std::lock_guard<std::mutex> lock(mSharedMutex);
+			mSharedJobs.push_back(job);
+			mNumSharedJobs.fetch_add(1U, std::memory_order_release);
+		}
+
+		// Sleeping workers announce it (read-modify-write) before their last search.
+		// Reading it with a read-modify-write too, either it is seen here or their
+		// search finds the job.
+		if (mNumSleeping.fetch_add(0U, std::memory_order_seq_cst) > 0U) {
+			{
+				std::lock_guard<std::mutex> lock(mSleepMutex);
+				++mWakeEpoch;
+			}
+			mSleepCondition.notify_one();
+		}
+	}
+
+	JobSystem::Job* JobSystem::FindJob(const int workerIndex) {
+		if (workerIndex >= 0) {
+			Job* job = mWorkers[workerIndex]->Pop();
+			if (job) {
+				return job;
+			}
+		}
+
+		// Steal from a random worker first, then from the next ones
+		const size_t numWorkers = mWorkers.size();
+		const size_t firstVictim = NextRandom() % numWorkers;
+		for (size_t i = 0U; i < numWorkers; ++i) {
+			const size_t victim = (firstVictim + i) % numWorkers;
+			if (static_cast<int>(victim) == workerIndex) {
+				continue;
+			}
+			Job* job = mWorkers[victim]->Steal();
+			if (job) {
+				return job;
+			}
+		}
+
+		if (mNumSharedJobs.load(std::memory_order_acquire) > 0U) {
+			std::lock_guard<std::mutex> lock(mSharedMutex);
+			if (!mSharedJobs.empty()) {
+				Job* job = mSharedJobs.front();
+				mSharedJobs.pop_front();
+				mNumSharedJobs.fetch_sub(1U, std::memory_order_relaxed);
+				return job;
+			}
+		}
+		return nullptr;
+	}
+
+	void JobSystem::Execute(Job* job) {
+		BRE_ASSERT(job);
+		{
+			const JobZone zone(job->mName);
+			job->mRun(*job);
+		}
+		JobCounter* counter = job->mCounter;
+		FreeJob(job);
+		if (counter) {
+			Finish(*counter);
+		}
+	}
+
+	void JobSystem::Finish(JobCounter& counter) {
+		// The counter cannot be destroyed until mFinishing is zero again
+		counter.mFinishing.fetch_add(1U, std::memory_order_acq_rel);
+		std::vector<Job*> jobs;
+		if (counter.mValue.fetch_sub(1U, std::memory_order_acq_rel) == 1U) {
+			std::lock_guard<std::mutex> lock(counter.mMutex);
+			jobs.swap(counter.mWaitingJobs);
+		}
+		counter.mFinishing.fetch_sub(1U, std::memory_order_release);
+		// Dependent jobs start once the counter is done
+		for (Job* job : jobs) {
+			Push(job);
+		}
+	}
+
+	void JobSystem::WorkerThread(const unsigned int workerIndex) {
+		sWorkerIndex = static_cast<int>(workerIndex);
+		sWorkerGeneration = mGeneration;
+		unsigned int idleRounds = 0U;
+		for (;;) {
+			Job* job = FindJob(sWorkerIndex);
+			if (job) {
+				Execute(job);
+				idleRounds = 0U;
+				continue;
+			}
+			if (++idleRounds < sSpinRounds) {
+				std::this_thread::yield();
+				continue;
+			}
+
+			std::uint64_t epoch;
+			{
+				std::lock_guard<std::mutex> lock(mSleepMutex);
+				if (mExit) {
+					return;
+				}
+				epoch = mWakeEpoch;
+			}
+			mNumSleeping.fetch_add(1U, std::memory_order_seq_cst);
+			job = FindJob(sWorkerIndex);
+			if (job == nullptr) {
+				std::unique_lock<std::mutex> lock(mSleepMutex);
+				mSleepCondition.wait(lock, [this, epoch]() { return mExit || mWakeEpoch != epoch; });
+			}
+			mNumSleeping.fetch_sub(1U, std::memory_order_relaxed);
+			if (job) {
+				Execute(job);
+			}
+			idleRounds = 0U;
+		}
+	}
+
+	void JobSystem::ParallelForRange(size_t begin, size_t end, const size_t grainSize, const RangeFunction& function, JobCounter& counter, const char* name) {
+		// Halves are pushed from the biggest one, so thieves take the biggest ranges
+		while (end - begin > grainSize) {
+			const size_t middle = begin + (end - begin) / 2U;
+			Run([this, middle, end, grainSize, &function, &counter, name]() { ParallelForRange(middle, end, grainSize, function, counter, name); }, &counter);
+			end = middle;
+		}
+		const JobZone zone(name);
+		function(begin, end);
+	}
+}
\ No newline at end of file
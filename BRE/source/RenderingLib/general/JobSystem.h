@@ -0,0 +1,153 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Work stealing job system.
+// The thread that creates it is worker 0 and the other workers have their
+// own thread. Each worker pushes and pops its jobs at the bottom of its
+// own Chase-Lev deque (no locks), and idle workers steal from the top of
+// other deques. Other threads (render thread, loading threads) push into a
+// shared queue.
+// A JobCounter counts unfinished jobs. Jobs can wait for a counter before
+// they start (dependency). Wait() runs other jobs until the counter is
+// zero, so a waiting thread never blocks the jobs it waits for.
+// ParallelFor() splits a range in halves until they are not larger than
+// the grain size; idle workers steal the biggest halves.
+// Named jobs are profiler zones (see Profiler). Names must be string
+// literals.
+// Jobs are fixed size and come from pools (a free list per worker and a
+// shared one), so running a job does not allocate. The function is stored
+// in the job: its captures must fit in Job::sDataSize bytes.
+//
+//////////////////////////////////////////////////////////////////////////
+
+namespace BRE {
+	class JobCounter;
+
+	class JobSystem {
+	public:
+		static JobSystem* gInstance;
+
+		typedef std::function<void(const size_t begin, const size_t end)> RangeFunction;
+
+		struct alignas(64) Job {
+			static const size_t sDataSize = 96U;
+
+			// Runs the function stored in mData and destroys it
+			void (*mRun)(Job& job);
+			JobCounter* mCounter;
+			const char* mName;
+			// Next free job of a pool
+			Job* mNext;
+			alignas(std::max_align_t) unsigned char mData[sDataSize];
+		};
+
+		// 0 threads means one per hardware thread
+		explicit JobSystem(const unsigned int numThreads = 0U);
+		~JobSystem();
+
+		const JobSystem& operator=(const JobSystem& rhs) = delete;
+
+		// counter (if not null) is incremented now and decremented when the job finishes.
+		// The job does not start until dependency (if not null) is done.
+		template<typename Function>
+		void Run(Function&& function, JobCounter* counter = nullptr, JobCounter* dependency = nullptr, const char* name = nullptr) {
+			typedef typename std::decay<Function>::type StoredFunction;
+			static_assert(sizeof(StoredFunction) <= Job::sDataSize, "Job function captures do not fit in a job");
+			static_assert(alignof(StoredFunction) <= alignof(std::max_align_t), "Job function is over-aligned");
+			Job* job = CreateJob(counter, name);
+			new (job->mData) StoredFunction(std::forward<Function>(function));
+			job->mRun = [](Job& runningJob) {
+				StoredFunction& stored = *reinterpret_cast<StoredFunction*>(runningJob.mData);
+				stored();
+				stored.~StoredFunction();
+			};
+			Schedule(job, dependency);
+		}
+
+		// It runs jobs while it waits
+		void Wait(const JobCounter& counter);
+
+		// function(begin, end) for subranges of [begin, end) of grainSize
+		// elements at most. It returns when the whole range is done.
+		void ParallelFor(const size_t begin, const size_t end, const size_t grainSize, const RangeFunction& function, const char* name = nullptr);
+
+		unsigned int NumThreads() const { return static_cast<unsigned int>(mWorkers.size()); }
+		// Index of the worker of the calling thread (-1 if it is not a worker)
+		int WorkerIndex() const;
+
+	private:
+		struct Worker;
+
+		// Job of the pool with the counter incremented
+		Job* CreateJob(JobCounter* counter, const char* name);
+		void FreeJob(Job* job);
+		// Pushes the job, or queues it in the dependency until it is done
+		void Schedule(Job* job, JobCounter* dependency);
+		void Push(Job* job);
+		Job* FindJob(const int workerIndex);
+		void Execute(Job* job);
+		void Finish(JobCounter& counter);
+		void WorkerThread(const unsigned int workerIndex);
+		void ParallelForRange(size_t begin, size_t end, const size_t grainSize, const RangeFunction& function, JobCounter& counter, const char* name);
+
+		const std::uint32_t mGeneration;
+		std::vector<std::unique_ptr<Worker>> mWorkers;
+		std::vector<std::thread> mThreads;
+
+		// Job pool of threads that are not workers and free jobs that workers
+		// give back. Jobs are allocated in blocks that live as long as the system.
+		std::mutex mPoolMutex;
+		Job* mSharedFreeJobs = nullptr;
+		std::vector<std::unique_ptr<unsigned char[]>> mJobBlocks;
+
+		// Jobs pushed by threads that are not workers
+		std::mutex mSharedMutex;
+		std::deque<Job*> mSharedJobs;
+		std::atomic<size_t> mNumSharedJobs{ 0U };
+
+		// Sleeping workers are woken when jobs are pushed
+		std::mutex mSleepMutex;
+		std::condition_variable mSleepCondition;
+		std::atomic<unsigned int> mNumSleeping{ 0U };
+		std::uint64_t mWakeEpoch = 0U;
+		bool mExit = false;
+	};
+
+	class JobCounter {
+	public:
+		JobCounter() = default;
+		~JobCounter();
+
+		JobCounter(const JobCounter&) = delete;
+		const JobCounter& operator=(const JobCounter& rhs) = delete;
+
+		// When it is true, the counter can be destroyed. It can still be false
+		// for a moment after its last job finished.
+		bool IsDone() const { return mValue.load(std::memory_order_acquire) == 0U && mFinishing.load(std::memory_order_acquire) == 0U; }
+
+	private:
+		friend class JobSystem;
+
+		std::atomic<std::uint32_t> mValue{ 0U };
+		// Jobs that are decrementing mValue (they can still use the counter after it is zero)
+		std::atomic<std::uint32_t> mFinishing{ 0U };
+		// Jobs that start when mValue becomes zero
+		std::mutex mMutex;
+		std::vector<JobSystem::Job*> mWaitingJobs;
+	};
+}
\ No newline at end of file
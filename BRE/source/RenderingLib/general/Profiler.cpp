@@ -0,0 +1,302 @@
+#include "Profiler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <thread>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+
+#include <utils/Assert.h>
+
+namespace {
+	typedef std::chrono::steady_clock ProfilerClock;
+
+	// Time stamp counter is much cheaper to read than the OS clock.
+	// Its rate is calibrated against the steady clock when the first
+	// profiler is created, not during static initialization.
+	double CalibrateMsPerTick() {
+		const ProfilerClock::time_point clockBegin = ProfilerClock::now();
+		const std::uint64_t ticksBegin = __rdtsc();
+		std::this_thread::sleep_for(std::chrono::milliseconds(20));
+		const ProfilerClock::time_point clockEnd = ProfilerClock::now();
+		const std::uint64_t ticksEnd = __rdtsc();
+		const double elapsedMs = std::chrono::duration<double, std::milli>(clockEnd - clockBegin).count();
+		return elapsedMs / static_cast<double>(ticksEnd - ticksBegin);
+	}
+
+	std::once_flag sCalibrationFlag;
+	double sMsPerTick = 0.0;
+
+	std::atomic<std::uint32_t> sNextGeneration(1U);
+	std::atomic<std::uint32_t> sNextThreadId(0U);
+
+	// Thread buffer of the current thread and the profiler instance it belongs to
+	thread_local void* sLocalBuffer = nullptr;
+	thread_local std::uint32_t sLocalGeneration = 0U;
+
+	size_t NextPowerOfTwo(const size_t value) {
+		size_t result = 1U;
+		while (result < value) {
+			result <<= 1U;
+		}
+		return result;
+	}
+
+	void WriteJsonString(std::ostream& stream, const char* str) {
+		stream << '"';
+		for (const char* c = str; *c != '\0'; ++c) {
+			if (*c == '"' || *c == '\\') {
+				stream << '\\';
+			}
+			stream << *c;
+		}
+		stream << '"';
+	}
+}
+
+namespace BRE {
+	Profiler* Profiler::gInstance = nullptr;
+
+	Profiler::ThreadBuffer::ThreadBuffer(const size_t capacity, const std::uint32_t threadId)
+		: mEvents(capacity)
+		, mMask(capacity - 1U)
+		, mWriteIndex(0U)
+		, mReadIndex(0U)
+		, mDropped(0U)
+		, mThreadId(threadId)
+		, mCachedReadIndex(0U)
+		, mDepth(0U)
+	{
+		BRE_ASSERT(capacity > 0U && (capacity & mMask) == 0U);
+	}
+
+	Profiler::Profiler(const size_t eventsPerThread)
+		: mEventsPerThread(NextPowerOfTwo(eventsPerThread))
+		, mGeneration(sNextGeneration.fetch_add(1U))
+		, mFrameBegin(Now())
+	{
+		std::call_once(sCalibrationFlag, []() { sMsPerTick = CalibrateMsPerTick(); });
+	}
+
+	Profiler::~Profiler() {
+		if (mCaptureFramesLeft.load(std::memory_order_relaxed) > 0U && !mCaptureEvents.empty()) {
+			WriteChromeTrace(mCaptureFilepath.c_str(), mCaptureEvents);
+		}
+	}
+
+	void Profiler::BeginZone(const char* name) {
+		BRE_ASSERT(name);
+		ThreadBuffer& buffer = LocalBuffer();
+		if (buffer.mDepth < sMaxDepth) {
+			buffer.mNames[buffer.mDepth] = name;
+			buffer.mBegins[buffer.mDepth] = Now();
+		}
+		++buffer.mDepth;
+	}
+
+	void Profiler::EndZone() {
+		const std::uint64_t end = Now();
+		ThreadBuffer& buffer = LocalBuffer();
+		BRE_ASSERT(buffer.mDepth > 0U);
+		--buffer.mDepth;
+		if (buffer.mDepth >= sMaxDepth) {
+			return;
+		}
+
+		// The read index is only loaded again when the ring looks full, so the
+		// cache line the drain writes is not touched by every zone.
+		const size_t writeIndex = buffer.mWriteIndex.load(std::memory_order_relaxed);
+		if (writeIndex - buffer.mCachedReadIndex > buffer.mMask) {
+			buffer.mCachedReadIndex = buffer.mReadIndex.load(std::memory_order_acquire);
+			if (writeIndex - buffer.mCachedReadIndex > buffer.mMask) {
+				buffer.mDropped.fetch_add(1U, std::memory_order_relaxed);
+				return;
+			}
+		}
+
+		ZoneEvent& zoneEvent = buffer.mEvents[writeIndex & buffer.mMask];
+		zoneEvent.mName = buffer.mNames[buffer.mDepth];
+		zoneEvent.mBegin = buffer.mBegins[buffer.mDepth];
+		zoneEvent.mEnd = end;
+		zoneEvent.mDepth = buffer.mDepth;
+		zoneEvent.mThreadId = buffer.mThreadId;
+		buffer.mWriteIndex.store(writeIndex + 1U, std::memory_order_release);
+	}
+
+	void Profiler::EndFrame() {
+		const std::uint64_t frameEnd = Now();
+		mFrameMs = TicksToMs(frameEnd - mFrameBegin);
+		mFrameBegin = frameEnd;
+
+		{
+			std::lock_guard<std::mutex> lock(mBuffersMutex);
+			for (std::unique_ptr<ThreadBuffer>& buffer : mBuffers) {
+				Drain(*buffer, mFrameEvents);
+			}
+		}
+
+		BuildStats(mFrameEvents);
+
+		if (mCaptureFramesLeft.load(std::memory_order_relaxed) == 0U && mCaptureRequested.load(std::memory_order_acquire)) {
+			std::lock_guard<std::mutex> lock(mCaptureRequestMutex);
+			mCaptureFilepath = mRequestedCaptureFilepath;
+			mCaptureEvents.clear();
+			// Frames left are set before the request is cleared, so IsCapturing() stays true
+			mCaptureFramesLeft.store(mRequestedCaptureFrames, std::memory_order_release);
+			mCaptureRequested.store(false, std::memory_order_release);
+		}
+
+		if (mCaptureFramesLeft.load(std::memory_order_relaxed) > 0U) {
+			mCaptureEvents.insert(mCaptureEvents.end(), mFrameEvents.begin(), mFrameEvents.end());
+			if (mCaptureFramesLeft.fetch_sub(1U, std::memory_order_acq_rel) == 1U) {
+				WriteChromeTrace(mCaptureFilepath.c_str(), mCaptureEvents);
+				mCaptureEvents.clear();
+				mCaptureEvents.shrink_to_fit();
+			}
+		}
+
+		mFrameEvents.clear();
+	}
+
+	void Profiler::RequestCapture(const char* filepath, const unsigned int frameCount) {
+		BRE_ASSERT(filepath);
+		BRE_ASSERT(frameCount > 0U);
+		std::lock_guard<std::mutex> lock(mCaptureRequestMutex);
+		if (IsCapturing()) {
+			return;
+		}
+		mRequestedCaptureFilepath = filepath;
+		mRequestedCaptureFrames = frameCount;
+		mCaptureRequested.store(true, std::memory_order_release);
+	}
+
+	double Profiler::MeasureZoneOverhead(const unsigned int iterations) {
+		BRE_ASSERT(iterations > 0U);
+		ThreadBuffer& buffer = LocalBuffer();
+
+		// Keep events already recorded by this thread for the current frame
+		Drain(buffer, mFrameEvents);
+
+		// Zones are timed in batches that fit in the thread buffer, so no zone
+		// is dropped and the drain between batches is not timed. The fastest
+		// batch is kept, as the others include preemptions and interrupts.
+		std::vector<ZoneEvent> scratch;
+		scratch.reserve(mEventsPerThread);
+		const unsigned int batchSize = static_cast<unsigned int>(std::min<size_t>(std::min<size_t>(mEventsPerThread, 4096U), iterations));
+		double minBatchMs = std::numeric_limits<double>::max();
+		for (unsigned int done = 0U; done < iterations; done += batchSize) {
+			const std::uint64_t begin = Now();
+			for (unsigned int i = 0U; i < batchSize; ++i) {
+				BeginZone("ProfilerOverhead");
+				EndZone();
+			}
+			const std::uint64_t end = Now();
+			minBatchMs = std::min(minBatchMs, TicksToMs(end - begin));
+			scratch.clear();
+			Drain(buffer, scratch);
+		}
+
+		return minBatchMs * 1.0e6 / batchSize;
+	}
+
+	std::uint64_t Profiler::Now() {
+		return __rdtsc();
+	}
+
+	double Profiler::TicksToMs(const std::uint64_t ticks) {
+		// Calibrated by the first profiler
+		BRE_ASSERT(sMsPerTick > 0.0);
+		return static_cast<double>(ticks) * sMsPerTick;
+	}
+
+	bool Profiler::WriteChromeTrace(const char* filepath, const std::vector<ZoneEvent>& events) {
+		BRE_ASSERT(filepath);
+		std::ofstream stream(filepath, std::ios::out | std::ios::trunc);
+		if (!stream.is_open()) {
+			return false;
+		}
+
+		std::uint64_t origin = std::numeric_limits<std::uint64_t>::max();
+		for (const ZoneEvent& zoneEvent : events) {
+			origin = std::min(origin, zoneEvent.mBegin);
+		}
+
+		stream << std::fixed << std::setprecision(3);
+		stream << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+		for (size_t i = 0U; i < events.size(); ++i) {
+			const ZoneEvent& zoneEvent = events[i];
+			stream << (i == 0U ? "\n" : ",\n") << "{\"name\":";
+			WriteJsonString(stream, zoneEvent.mName);
+			stream << ",\"cat\":\"cpu\",\"ph\":\"X\",\"pid\":0,\"tid\":" << zoneEvent.mThreadId
+				<< ",\"ts\":" << TicksToMs(zoneEvent.mBegin - origin) * 1000.0
+				<< ",\"dur\":" << TicksToMs(zoneEvent.mEnd - zoneEvent.mBegin) * 1000.0 << "}";
+		}
+		stream << "\n]}\n";
+
+		return stream.good();
+	}
+
+	Profiler::ThreadBuffer& Profiler::LocalBuffer() {
+		if (sLocalGeneration != mGeneration) {
+			std::unique_ptr<ThreadBuffer> buffer(new ThreadBuffer(mEventsPerThread, sNextThreadId.fetch_add(1U)));
+			sLocalBuffer = buffer.get();
+			sLocalGeneration = mGeneration;
+			std::lock_guard<std::mutex> lock(mBuffersMutex);
+			mBuffers.push_back(std::move(buffer));
+		}
+		return *static_cast<ThreadBuffer*>(sLocalBuffer);
+	}
+
+	void Profiler::Drain(ThreadBuffer& buffer, std::vector<ZoneEvent>& events) {
+		const size_t readIndex = buffer.mReadIndex.load(std::memory_order_relaxed);
+		const size_t writeIndex = buffer.mWriteIndex.load(std::memory_order_acquire);
+		for (size_t i = readIndex; i != writeIndex; ++i) {
+			events.push_back(buffer.mEvents[i & buffer.mMask]);
+		}
+		buffer.mReadIndex.store(writeIndex, std::memory_order_release);
+		mDroppedEvents += buffer.mDropped.exchange(0U, std::memory_order_relaxed);
+	}
+
+	void Profiler::BuildStats(const std::vector<ZoneEvent>& events) {
+		// Zones are recorded when they end, so sort them by begin time to get parents first
+		std::vector<const ZoneEvent*> sortedEvents;
+		sortedEvents.reserve(events.size());
+		for (const ZoneEvent& zoneEvent : events) {
+			sortedEvents.push_back(&zoneEvent);
+		}
+		std::sort(sortedEvents.begin(), sortedEvents.end(), [](const ZoneEvent* a, const ZoneEvent* b) {
+			return a->mBegin != b->mBegin ? a->mBegin < b->mBegin : a->mDepth < b->mDepth;
+		});
+
+		mFrameStats.clear();
+		mStatsIndexByName.clear();
+		for (const ZoneEvent* zoneEvent : sortedEvents) {
+			const double ms = TicksToMs(zoneEvent->mEnd - zoneEvent->mBegin);
+			std::unordered_map<const char*, size_t>::const_iterator it = mStatsIndexByName.find(zoneEvent->mName);
+			if (it == mStatsIndexByName.end()) {
+				mStatsIndexByName.insert(std::make_pair(zoneEvent->mName, mFrameStats.size()));
+				ZoneStats stats;
+				stats.mName = zoneEvent->mName;
+				stats.mDepth = zoneEvent->mDepth;
+				stats.mCalls = 1U;
+				stats.mTotalMs = ms;
+				stats.mMaxMs = ms;
+				mFrameStats.push_back(stats);
+			}
+			else {
+				ZoneStats& stats = mFrameStats[it->second];
+				stats.mDepth = std::min(stats.mDepth, zoneEvent->mDepth);
+				++stats.mCalls;
+				stats.mTotalMs += ms;
+				stats.mMaxMs = std::max(stats.mMaxMs, ms);
+			}
+		}
+	}
+}
\ No newline at end of file
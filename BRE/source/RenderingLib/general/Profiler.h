@@ -0,0 +1,148 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Hierarchical CPU profiler.
+// Each thread records complete zones (name, begin, end, depth) into its own
+// single producer / single consumer ring buffer, so recording never locks.
+// EndFrame() is called once per frame by the thread that submits frames
+// (the render thread when FramePipeline runs one): it drains every ring,
+// builds per zone statistics for the frame and, while a capture is in
+// progress, accumulates the events to export them as Chrome trace JSON
+// (chrome://tracing or https://ui.perfetto.dev). Zones of threads that run
+// ahead (simulation) belong to the frame whose submission they end in.
+// RequestCapture() can be called from any thread.
+//
+// Use BRE_PROFILE_SCOPE("Name") to mark zones. Name must be a string
+// literal (only its address is stored). Markers are compiled out unless
+// BRE_PROFILING is defined.
+//
+//////////////////////////////////////////////////////////////////////////
+
+namespace BRE {
+	class Profiler {
+	public:
+		static Profiler* gInstance;
+
+		struct ZoneEvent {
+			const char* mName;
+			std::uint64_t mBegin;
+			std::uint64_t mEnd;
+			std::uint32_t mDepth;
+			std::uint32_t mThreadId;
+		};
+
+		struct ZoneStats {
+			const char* mName;
+			std::uint32_t mDepth;
+			std::uint32_t mCalls;
+			double mTotalMs;
+			double mMaxMs;
+		};
+
+		explicit Profiler(const size_t eventsPerThread = 16384U);
+		~Profiler();
+
+		const Profiler& operator=(const Profiler& rhs) = delete;
+
+		void BeginZone(const char* name);
+		void EndZone();
+
+		// Drain thread buffers and compute statistics of the frame that ends.
+		void EndFrame();
+
+		// Record next frameCount frames and write them to filepath as Chrome trace JSON.
+		void RequestCapture(const char* filepath, const unsigned int frameCount);
+		// True from the request until the trace is written
+		bool IsCapturing() const {
+			return mCaptureRequested.load(std::memory_order_acquire) || mCaptureFramesLeft.load(std::memory_order_acquire) > 0U;
+		}
+
+		// Sorted by first occurrence in the frame, so parents come before their children.
+		const std::vector<ZoneStats>& FrameStats() const { return mFrameStats; }
+		double FrameMs() const { return mFrameMs; }
+		size_t DroppedEvents() const { return mDroppedEvents; }
+
+		// Cost (in nanoseconds) of an empty zone (begin + end) on the calling thread.
+		double MeasureZoneOverhead(const unsigned int iterations = 100000U);
+
+		static std::uint64_t Now();
+		static double TicksToMs(const std::uint64_t ticks);
+
+		static bool WriteChromeTrace(const char* filepath, const std::vector<ZoneEvent>& events);
+
+	private:
+		static const std::uint32_t sMaxDepth = 64U;
+
+		struct ThreadBuffer {
+			explicit ThreadBuffer(const size_t capacity, const std::uint32_t threadId);
+
+			std::vector<ZoneEvent> mEvents;
+			size_t mMask;
+			std::atomic<size_t> mWriteIndex;
+			std::atomic<size_t> mReadIndex;
+			std::atomic<size_t> mDropped;
+			std::uint32_t mThreadId;
+
+			// Only touched by the owner thread
+			size_t mCachedReadIndex;
+			std::uint32_t mDepth;
+			const char* mNames[sMaxDepth];
+			std::uint64_t mBegins[sMaxDepth];
+		};
+
+		ThreadBuffer& LocalBuffer();
+		void Drain(ThreadBuffer& buffer, std::vector<ZoneEvent>& events);
+		void BuildStats(const std::vector<ZoneEvent>& events);
+
+		const size_t mEventsPerThread;
+		const std::uint32_t mGeneration;
+
+		std::mutex mBuffersMutex;
+		std::vector<std::unique_ptr<ThreadBuffer>> mBuffers;
+
+		std::vector<ZoneEvent> mFrameEvents;
+		std::vector<ZoneStats> mFrameStats;
+		std::unordered_map<const char*, size_t> mStatsIndexByName;
+		std::uint64_t mFrameBegin;
+		double mFrameMs = 0.0;
+		size_t mDroppedEvents = 0U;
+
+		// Request made by any thread, started by the next EndFrame()
+		std::mutex mCaptureRequestMutex;
+		std::string mRequestedCaptureFilepath;
+		unsigned int mRequestedCaptureFrames = 0U;
+		std::atomic<bool> mCaptureRequested{ false };
+
+		std::string mCaptureFilepath;
+		std::atomic<unsigned int> mCaptureFramesLeft{ 0U };
+		std::vector<ZoneEvent> mCaptureEvents;
+	};
+
+	class ProfileScope {
+	public:
+		explicit ProfileScope(const char* name) { Profiler::gInstance->BeginZone(name); }
+		~ProfileScope() { Profiler::gInstance->EndZone(); }
+
+		ProfileScope(const ProfileScope&) = delete;
+		const ProfileScope& operator=(const ProfileScope& rhs) = delete;
+	};
+}
+
+#define BRE_PROFILE_CONCAT_IMPL(a, b) a##b
+#define BRE_PROFILE_CONCAT(a, b) BRE_PROFILE_CONCAT_IMPL(a, b)
+
+#ifdef BRE_PROFILING
+#define BRE_PROFILE_SCOPE(name) \
+	const BRE::ProfileScope BRE_PROFILE_CONCAT(profileScope, __LINE__)(name)
+#else
+#define BRE_PROFILE_SCOPE(name)
+#endif
\ No newline at end of file
@@ -0,0 +1,110 @@
+#include "RenderCounters.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include <utils/Assert.h>
+
+namespace {
+	std::atomic<std::uint32_t> sNextGeneration(1U);
+
+	// Counters block of the current thread and the RenderCounters instance it belongs to
+	thread_local void* sLocalBlock = nullptr;
+	thread_local std::uint32_t sLocalGeneration = 0U;
+
+	const char* sCounterNames[] = {
+		"PreDrawCalls",
+		"DrawCalls",
+		"ShaderBinds",
+		"SRVBinds",
+		"ConstantBufferBinds",
+		"SamplerBinds",
+		"UploadBytes",
+		"Indices",
+		"Lights",
+		"StreamedBytes",
+		"StreamingEvictions",
+		"CulledObjects",
+		"OccludedObjects",
+		"Impostors",
+		"GeometryBufferBinds",
+	};
+	static_assert(sizeof(sCounterNames) / sizeof(sCounterNames[0]) == BRE::RenderCounters::sNumCounters, "Counter names do not match RenderCounter enum");
+}
+
+namespace BRE {
+	RenderCounters* RenderCounters::gInstance = nullptr;
+
+	RenderCounters::RenderCounters(const size_t historySize)
+		: mGeneration(sNextGeneration.fetch_add(1U))
+		, mHistory(historySize)
+	{
+		BRE_ASSERT(historySize > 0U);
+		memset(&mLastFrame, 0, sizeof(mLastFrame));
+	}
+
+	void RenderCounters::Add(const RenderCounter counter, const std::uint64_t value) {
+		BRE_ASSERT(counter < RenderCounter::Count);
+		// Only the owner thread adds, so the atomic is never contended
+		LocalBlock().mValues[static_cast<size_t>(counter)].fetch_add(value, std::memory_order_relaxed);
+	}
+
+	void RenderCounters::EndFrame() {
+		memset(&mLastFrame, 0, sizeof(mLastFrame));
+		{
+			std::lock_guard<std::mutex> lock(mBlocksMutex);
+			for (std::unique_ptr<ThreadBlock>& block : mBlocks) {
+				for (size_t i = 0U; i < sNumCounters; ++i) {
+					mLastFrame.mValues[i] += block->mValues[i].exchange(0U, std::memory_order_relaxed);
+				}
+			}
+		}
+
+		mHistory[mHistoryNext] = mLastFrame;
+		mHistoryNext = (mHistoryNext + 1U) % mHistory.size();
+		mHistoryCount = std::min(mHistoryCount + 1U, mHistory.size());
+	}
+
+	const RenderCounters::Frame& RenderCounters::History(const size_t index) const {
+		BRE_ASSERT(index < mHistoryCount);
+		return mHistory[(mHistoryNext + mHistory.size() - 1U - index) % mHistory.size()];
+	}
+
+	double RenderCounters::Average(const RenderCounter counter) const {
+		if (mHistoryCount == 0U) {
+			return 0.0;
+		}
+		std::uint64_t sum = 0U;
+		for (size_t i = 0U; i < mHistoryCount; ++i) {
+			sum += History(i)[counter];
+		}
+		return static_cast<double>(sum) / mHistoryCount;
+	}
+
+	std::uint64_t RenderCounters::Max(const RenderCounter counter) const {
+		std::uint64_t result = 0U;
+		for (size_t i = 0U; i < mHistoryCount; ++i) {
+			result = std::max(result, History(i)[counter]);
+		}
+		return result;
+	}
+
+	const char* RenderCounters::Name(const RenderCounter counter) {
+		BRE_ASSERT(counter < RenderCounter::Count);
+		return sCounterNames[static_cast<size_t>(counter)];
+	}
+
+	RenderCounters::ThreadBlock& RenderCounters::LocalBlock() {
+		if (sLocalGeneration != mGeneration) {
+			std::unique_ptr<ThreadBlock> block(new ThreadBlock());
+			for (std::atomic<std::uint64_t>& value : block->mValues) {
+				value.store(0U, std::memory_order_relaxed);
+			}
+			sLocalBlock = block.get();
+			sLocalGeneration = mGeneration;
+			std::lock_guard<std::mutex> lock(mBlocksMutex);
+			mBlocks.push_back(std::move(block));
+		}
+		return *static_cast<ThreadBlock*>(sLocalBlock);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Per frame rendering counters (draws, binds, uploaded bytes, etc).
+// Each thread increments its own block of counters. EndFrame() folds
+// every block into the frame totals and pushes them into a rolling
+// history. It is called when a frame has been submitted, by the thread
+// that submits it, as draws and binds are counted there. Use BRE_COUNTER_ADD(RenderCounter::X, value) to increment them.
+// It is compiled out unless BRE_PROFILING is defined.
+//
+//////////////////////////////////////////////////////////////////////////
+
+namespace BRE {
+	enum class RenderCounter : unsigned int {
+		PreDrawCalls = 0U,
+		DrawCalls,
+		ShaderBinds,
+		SRVBinds,
+		ConstantBufferBinds,
+		SamplerBinds,
+		UploadBytes,
+		Indices,
+		Lights,
+		StreamedBytes,
+		StreamingEvictions,
+		CulledObjects,
+		OccludedObjects,
+		Impostors,
+		GeometryBufferBinds,
+		Count
+	};
+
+	class RenderCounters {
+	public:
+		static RenderCounters* gInstance;
+
+		static const size_t sNumCounters = static_cast<size_t>(RenderCounter::Count);
+
+		struct Frame {
+			std::uint64_t mValues[sNumCounters];
+			std::uint64_t operator[](const RenderCounter counter) const { return mValues[static_cast<size_t>(counter)]; }
+		};
+
+		explicit RenderCounters(const size_t historySize = 240U);
+
+		const RenderCounters& operator=(const RenderCounters& rhs) = delete;
+
+		void Add(const RenderCounter counter, const std::uint64_t value);
+
+		// Fold thread counters into a new history entry and reset them
+		void EndFrame();
+
+		// Totals of the last finished frame
+		const Frame& LastFrame() const { return mLastFrame; }
+
+		// index 0 is the last finished frame, index HistorySize() - 1 the oldest one
+		size_t HistorySize() const { return mHistoryCount; }
+		const Frame& History(const size_t index) const;
+
+		double Average(const RenderCounter counter) const;
+		std::uint64_t Max(const RenderCounter counter) const;
+
+		static const char* Name(const RenderCounter counter);
+
+	private:
+		struct ThreadBlock {
+			std::atomic<std::uint64_t> mValues[sNumCounters];
+		};
+
+		ThreadBlock& LocalBlock();
+
+		const std::uint32_t mGeneration;
+
+		std::mutex mBlocksMutex;
+		std::vector<std::unique_ptr<ThreadBlock>> mBlocks;
+
+		Frame mLastFrame;
+		std::vector<Frame> mHistory;
+		size_t mHistoryNext = 0U;
+		size_t mHistoryCount = 0U;
+	};
+}
+
+#ifdef BRE_PROFILING
+#define BRE_COUNTER_ADD(counter, value) \
+	BRE::RenderCounters::gInstance->Add(counter, value)
+#else
+#define BRE_COUNTER_ADD(counter, value)
+#endif
\ No newline at end of file
@@ -0,0 +1,204 @@
+#include "TransformHierarchy.h"
+
+#include <algorithm>
+#include <functional>
+#include <numeric>
+
+#include <general/Profiler.h>
+#include <utils/Assert.h>
+
+using namespace DirectX;
+
+namespace {
+	// Dirty nodes are updated through a sweep of all nodes when there are
+	// more than one of this number of nodes.
+	const size_t sSweepDirtyFraction = 64U;
+
+	template<typename T>
+	void Permute(std::vector<T>& values, const std::vector<size_t>& newIndices) {
+		std::vector<T> permuted(values.size());
+		for (size_t i = 0U; i < values.size(); ++i) {
+			permuted[newIndices[i]] = values[i];
+		}
+		values.swap(permuted);
+	}
+}
+
+namespace BRE {
+	TransformHierarchy::LocalTransform::LocalTransform()
+		: mTranslation(0.0f, 0.0f, 0.0f)
+		, mRotation(0.0f, 0.0f, 0.0f, 1.0f)
+		, mScaling(1.0f, 1.0f, 1.0f)
+	{
+	}
+
+	size_t TransformHierarchy::AddNode(const LocalTransform& local, const size_t parent) {
+		BRE_ASSERT(parent == sNoNode || parent < NumNodes());
+		const size_t node = NumNodes();
+		// Appended. Parents are still before their children, but children of a node are not contiguous until Sort().
+		const size_t slot = mNodeBySlot.size();
+		mSlotByNode.push_back(slot);
+		mParentByNode.push_back(parent);
+		mDepthByNode.push_back(parent == sNoNode ? 0U : mDepthByNode[parent] + 1U);
+		mNodeBySlot.push_back(node);
+		mParentSlots.push_back(parent == sNoNode ? parent : mSlotByNode[parent]);
+		mFirstChildSlots.push_back(0U);
+		mNumChildren.push_back(0U);
+		mLocals.push_back(local);
+		XMFLOAT4X4 world;
+		XMStoreFloat4x4(&world, XMMatrixIdentity());
+		mWorlds.push_back(world);
+		mDirty.push_back(0U);
+		mSorted = false;
+		return node;
+	}
+
+	const TransformHierarchy::LocalTransform& TransformHierarchy::Local(const size_t node) const {
+		BRE_ASSERT(node < NumNodes());
+		return mLocals[mSlotByNode[node]];
+	}
+
+	void TransformHierarchy::SetLocal(const size_t node, const LocalTransform& local) {
+		BRE_ASSERT(node < NumNodes());
+		const size_t slot = mSlotByNode[node];
+		mLocals[slot] = local;
+		if (mDirty[slot] == 0U) {
+			mDirty[slot] = 1U;
+			mDirtyNodes.push_back(node);
+		}
+	}
+
+	size_t TransformHierarchy::Parent(const size_t node) const {
+		BRE_ASSERT(node < NumNodes());
+		return mParentByNode[node];
+	}
+
+	XMMATRIX TransformHierarchy::World(const size_t node) const {
+		BRE_ASSERT(node < NumNodes());
+		return XMLoadFloat4x4(&mWorlds[mSlotByNode[node]]);
+	}
+
+	void TransformHierarchy::Update() {
+		BRE_PROFILE_SCOPE("TransformHierarchy::Update");
+		mChangedNodes.clear();
+		if (!mSorted) {
+			Sort();
+			std::fill(mDirty.begin(), mDirty.end(), static_cast<std::uint8_t>(1U));
+			UpdateSweep();
+		}
+		else if (mDirtyNodes.size() * sSweepDirtyFraction > NumNodes()) {
+			UpdateSweep();
+		}
+		else {
+			UpdateDirty();
+		}
+		mDirtyNodes.clear();
+	}
+
+	void TransformHierarchy::Sort() {
+		const size_t numNodes = NumNodes();
+		std::vector<size_t> nodes(numNodes);
+		std::iota(nodes.begin(), nodes.end(), 0U);
+		std::stable_sort(nodes.begin(), nodes.end(), [this](const size_t a, const size_t b) { return mDepthByNode[a] < mDepthByNode[b]; });
+
+		// Slots of a depth are sorted by parent slot, so children of a node are
+		// contiguous. Slots of the previous depth are already set.
+		std::vector<size_t> newSlotByNode(numNodes);
+		size_t levelBegin = 0U;
+		while (levelBegin < numNodes) {
+			size_t levelEnd = levelBegin;
+			while (levelEnd < numNodes && mDepthByNode[nodes[levelEnd]] == mDepthByNode[nodes[levelBegin]]) {
+				++levelEnd;
+			}
+			std::stable_sort(nodes.begin() + levelBegin, nodes.begin() + levelEnd, [this, &newSlotByNode](const size_t a, const size_t b) {
+				const size_t parentA = mParentByNode[a] == sNoNode ? 0U : newSlotByNode[mParentByNode[a]];
+				const size_t parentB = mParentByNode[b] == sNoNode ? 0U : newSlotByNode[mParentByNode[b]];
+				return parentA < parentB;
+			});
+			for (size_t slot = levelBegin; slot < levelEnd; ++slot) {
+				newSlotByNode[nodes[slot]] = slot;
+			}
+			levelBegin = levelEnd;
+		}
+
+		// New slot of each current slot
+		std::vector<size_t> newSlots(numNodes);
+		for (size_t node = 0U; node < numNodes; ++node) {
+			newSlots[mSlotByNode[node]] = newSlotByNode[node];
+		}
+		Permute(mLocals, newSlots);
+		Permute(mWorlds, newSlots);
+		mSlotByNode.swap(newSlotByNode);
+		mNodeBySlot.swap(nodes);
+		for (size_t slot = 0U; slot < numNodes; ++slot) {
+			const size_t parent = mParentByNode[mNodeBySlot[slot]];
+			mParentSlots[slot] = parent == sNoNode ? parent : mSlotByNode[parent];
+			mNumChildren[slot] = 0U;
+		}
+		for (size_t slot = 0U; slot < numNodes; ++slot) {
+			const size_t parentSlot = mParentSlots[slot];
+			if (parentSlot != sNoNode) {
+				if (mNumChildren[parentSlot] == 0U) {
+					mFirstChildSlots[parentSlot] = slot;
+				}
+				BRE_ASSERT(mFirstChildSlots[parentSlot] + mNumChildren[parentSlot] == slot);
+				++mNumChildren[parentSlot];
+			}
+		}
+		mSorted = true;
+	}
+
+	void TransformHierarchy::UpdateSlot(const size_t slot) {
+		const LocalTransform& local = mLocals[slot];
+		XMMATRIX world = XMMatrixScaling(local.mScaling.x, local.mScaling.y, local.mScaling.z);
+		world *= XMMatrixRotationQuaternion(XMLoadFloat4(&local.mRotation));
+		world *= XMMatrixTranslation(local.mTranslation.x, local.mTranslation.y, local.mTranslation.z);
+		const size_t parentSlot = mParentSlots[slot];
+		if (parentSlot != sNoNode) {
+			BRE_ASSERT(parentSlot < slot);
+			world *= XMLoadFloat4x4(&mWorlds[parentSlot]);
+		}
+		XMStoreFloat4x4(&mWorlds[slot], world);
+		mChangedNodes.push_back(mNodeBySlot[slot]);
+	}
+
+	void TransformHierarchy::UpdateSweep() {
+		// Parents are before their children, so dirty flags are propagated down in the same pass
+		const size_t numSlots = mNodeBySlot.size();
+		for (size_t slot = 0U; slot < numSlots; ++slot) {
+			const size_t parentSlot = mParentSlots[slot];
+			if (mDirty[slot] != 0U || (parentSlot != sNoNode && mDirty[parentSlot] != 0U)) {
+				mDirty[slot] = 1U;
+				UpdateSlot(slot);
+			}
+		}
+		for (const size_t node : mChangedNodes) {
+			mDirty[mSlotByNode[node]] = 0U;
+		}
+	}
+
+	void TransformHierarchy::UpdateDirty() {
+		// Lowest slot first, so parents are updated before their children
+		mSlotsToUpdate.clear();
+		for (const size_t node : mDirtyNodes) {
+			mSlotsToUpdate.push_back(mSlotByNode[node]);
+		}
+		std::make_heap(mSlotsToUpdate.begin(), mSlotsToUpdate.end(), std::greater<size_t>());
+		while (!mSlotsToUpdate.empty()) {
+			std::pop_heap(mSlotsToUpdate.begin(), mSlotsToUpdate.end(), std::greater<size_t>());
+			const size_t slot = mSlotsToUpdate.back();
+			mSlotsToUpdate.pop_back();
+			UpdateSlot(slot);
+			mDirty[slot] = 0U;
+
+			const size_t childrenEnd = mFirstChildSlots[slot] + mNumChildren[slot];
+			for (size_t childSlot = mFirstChildSlots[slot]; childSlot < childrenEnd; ++childSlot) {
+				if (mDirty[childSlot] == 0U) {
+					mDirty[childSlot] = 1U;
+					mSlotsToUpdate.push_back(childSlot);
+					std::push_heap(mSlotsToUpdate.begin(), mSlotsToUpdate.end(), std::greater<size_t>());
+				}
+			}
+		}
+	}
+}
\ No newline at end of file
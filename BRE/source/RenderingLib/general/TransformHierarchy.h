@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstdint>
+#include <DirectXMath.h>
+#include <vector>
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Scene graph transforms. Each node has a local transform (translation,
+// rotation quaternion and scaling, relative to its parent) and a world
+// matrix (local * parent world).
+// Nodes are stored in flat arrays sorted by depth (parents before their
+// children, children of a node contiguous), so world matrices are computed
+// top-down in one pass over the arrays.
+// SetLocal() marks the node dirty. Update() only recomputes dirty nodes and
+// their descendants, so its cost depends on what changed, not on the number
+// of nodes. When most nodes changed, it sweeps the arrays instead.
+// Node ids returned by AddNode() are stable. Arrays are sorted again in the
+// next Update() after nodes are added.
+// It is used from the simulation thread only.
+//
+//////////////////////////////////////////////////////////////////////////
+
+namespace BRE {
+	class TransformHierarchy {
+	public:
+		static const size_t sNoNode = static_cast<size_t>(-1);
+
+		struct LocalTransform {
+			LocalTransform();
+
+			DirectX::XMFLOAT3 mTranslation;
+			DirectX::XMFLOAT4 mRotation;
+			DirectX::XMFLOAT3 mScaling;
+		};
+
+		// Parent must be added before its children
+		size_t AddNode(const LocalTransform& local, const size_t parent = sNoNode);
+		size_t NumNodes() const { return mSlotByNode.size(); }
+
+		const LocalTransform& Local(const size_t node) const;
+		void SetLocal(const size_t node, const LocalTransform& local);
+
+		size_t Parent(const size_t node) const;
+		// Valid after Update()
+		DirectX::XMMATRIX World(const size_t node) const;
+
+		// Computes world matrices of dirty nodes and their descendants
+		void Update();
+		// Nodes whose world matrix was computed by the last Update(), parents before children
+		const std::vector<size_t>& ChangedNodes() const { return mChangedNodes; }
+
+	private:
+		void Sort();
+		void UpdateSlot(const size_t slot);
+		// Dirty slots and their descendants, in one pass over all slots
+		void UpdateSweep();
+		// Dirty slots and their descendants, through a heap of slots
+		void UpdateDirty();
+
+		// By node
+		std::vector<size_t> mSlotByNode;
+		std::vector<size_t> mParentByNode;
+		std::vector<size_t> mDepthByNode;
+
+		// By slot (depth order)
+		std::vector<size_t> mNodeBySlot;
+		std::vector<size_t> mParentSlots;
+		std::vector<size_t> mFirstChildSlots;
+		std::vector<size_t> mNumChildren;
+		std::vector<LocalTransform> mLocals;
+		std::vector<DirectX::XMFLOAT4X4> mWorlds;
+		// Nodes of dirty slots are in mDirtyNodes
+		std::vector<std::uint8_t> mDirty;
+
+		std::vector<size_t> mDirtyNodes;
+		std::vector<size_t> mChangedNodes;
+		// Heap of slots to update
+		std::vector<size_t> mSlotsToUpdate;
+		bool mSorted = true;
+	};
+}
\ No newline at end of file
@@ -1,23 +1,53 @@
 #include "DrawManager.h"
 
+#include <algorithm>
 #include <d3d11_1.h>
+#include <sstream>
 #include <vector>
 #include <yaml-cpp/yaml.h>
 
-#include <general/Camera.h>
+#include <general/Profiler.h>
+#include <general/RenderCounters.h>
+#include <managers/GeometryPool.h>
+#include <managers/MaterialTable.h>
+#include <managers/ModelManager.h>
 #include <managers/ShaderResourcesManager.h>
 #include <rendering/RenderStateHelper.h>
+#include <rendering/models/Mesh.h>
+#include <rendering/models/Model.h>
 #include <utils/Assert.h>
+#include <utils/Hash.h>
+#include <utils/MathUtils.h>
 #include <utils/YamlUtils.h>
 
 using namespace DirectX;
 
+namespace {
+	// GPU query results are read this number of frames later
+	const size_t sGpuFramesInFlight = 4U;
+	const size_t sMaxGpuPasses = 5U;
+	// Occlusion culling depth buffer size is the screen size divided by this
+	const unsigned int sOcclusionBufferDivisor = 4U;
+	// Impostors are drawn again as geometry above their screen fraction times this
+	const float sImpostorHysteresis = 1.2f;
+	// Bytes of each geometry pool buffer that are moved to compact it each frame
+	const unsigned int sGeometryDefragmentBytes = 1024U * 1024U;
+}
+
 namespace BRE {
 	DrawManager* DrawManager::gInstance = nullptr;
 
 	DrawManager::DrawManager(ID3D11Device1& device, ID3D11DeviceContext1& context, const unsigned int screenWidth, const unsigned int screenHeight)
-		: mPostProcessDrawer(device)
+		: mOcclusionCuller(screenWidth / sOcclusionBufferDivisor, screenHeight / sOcclusionBufferDivisor)
+		, mPostProcessDrawer(device)
 		, mFrameRateDrawer(device, context)
+		, mGpuQuerySource(device, context, sGpuFramesInFlight, sMaxGpuPasses)
+		, mGpuProfiler(mGpuQuerySource)
+		, mGeometryGpuPass(mGpuProfiler.RegisterPass("Geometry"))
+		, mNormalDisplacementGpuPass(mGpuProfiler.RegisterPass("NormalDisplacement"))
+		, mImpostorsGpuPass(mGpuProfiler.RegisterPass("Impostors"))
+		, mLightingGpuPass(mGpuProfiler.RegisterPass("Lighting"))
+		, mToneMappingGpuPass(mGpuProfiler.RegisterPass("ToneMapping"))
 	{
 		InitGBuffers(screenWidth, screenHeight);
 		InitPostProcessResources(screenWidth, screenHeight);		
@@ -26,7 +56,7 @@ namespace BRE {
 	void DrawManager::LoadModels(const char* filepath) {
 		BRE_ASSERT(filepath);
 
-		const YAML::Node yamlFile = YAML::LoadFile(filepath);
+		const YAML::Node yamlFile = YamlUtils::LoadFile(filepath);
 		BRE_ASSERT(yamlFile.IsDefined());
 
 		// Get models node
@@ -34,25 +64,215 @@ namespace BRE {
 		BRE_ASSERT(nodes.IsDefined());
 		BRE_ASSERT(nodes.IsSequence());
 		
-		// Iterate through each node
+		// Hierarchy nodes first, drawers are created with their world matrices
+		const size_t firstNode = mHierarchy.NumNodes();
 		for (const YAML::Node& node : nodes) {
 			BRE_ASSERT(node.IsDefined());
 			BRE_ASSERT(node.IsMap());
-			const std::string renderType = YamlUtils::GetScalar<std::string>(node, "renderType");
+			TransformHierarchy::LocalTransform local;
+			float translation[3];
+			YamlUtils::GetSequence<float>(node, "translation", translation, ARRAYSIZE(translation));
+			local.mTranslation = XMFLOAT3(translation[0], translation[1], translation[2]);
+			float rotation[3];
+			YamlUtils::GetSequence<float>(node, "rotation", rotation, ARRAYSIZE(rotation));
+			XMStoreFloat4(&local.mRotation, XMQuaternionRotationRollPitchYaw(rotation[0], rotation[1], rotation[2]));
+			float scaling[3];
+			YamlUtils::GetSequence<float>(node, "scaling", scaling, ARRAYSIZE(scaling));
+			local.mScaling = XMFLOAT3(scaling[0], scaling[1], scaling[2]);
+
+			size_t parent = TransformHierarchy::sNoNode;
+			if (YamlUtils::IsDefined(node, "parent")) {
+				const std::string parentName = YamlUtils::GetScalar<std::string>(node, "parent");
+				parent = FindNode(parentName.c_str());
+				// Parents must be declared before their children
+				BRE_ASSERT(parent != TransformHierarchy::sNoNode);
+			}
+			const size_t hierarchyNode = mHierarchy.AddNode(local, parent);
+			if (YamlUtils::IsDefined(node, "name")) {
+				const std::string name = YamlUtils::GetScalar<std::string>(node, "name");
+				const size_t nameId = Utils::Hash(name.c_str());
+				BRE_ASSERT(mNodeByName.find(nameId) == mNodeByName.end());
+				mNodeByName[nameId] = hierarchyNode;
+			}
+		}
+		mHierarchy.Update();
+
+		size_t hierarchyNode = firstNode;
+		for (const YAML::Node& node : nodes) {
+			NodeDrawers nodeDrawers;
+			nodeDrawers.mTransform = mTransforms.Add(mHierarchy.World(hierarchyNode));
+			nodeDrawers.mType = DrawerType::None;
+			nodeDrawers.mFirstDrawer = 0U;
+			nodeDrawers.mNumDrawers = 0U;
+			nodeDrawers.mImpostorNode = sNoImpostor;
+			const std::string renderType = YamlUtils::IsDefined(node, "renderType") ? YamlUtils::GetScalar<std::string>(node, "renderType") : std::string();
 			if (renderType == "Normal") {	
-				NormalMappingDrawer::Create(node, mNormalMappingDrawers);
+				nodeDrawers.mType = DrawerType::NormalMapping;
+				nodeDrawers.mFirstDrawer = mNormalMappingDrawers.size();
+				NormalMappingDrawer::Create(node, mTransforms, nodeDrawers.mTransform, mNormalMappingDrawers);
+				nodeDrawers.mNumDrawers = mNormalMappingDrawers.size() - nodeDrawers.mFirstDrawer;
 			}
 			else if (renderType == "Normal_Displacement") {
-				NormalDisplacementDrawer::Create(node, mNormalDisplacementDrawers);
+				nodeDrawers.mType = DrawerType::NormalDisplacement;
+				nodeDrawers.mFirstDrawer = mNormalDisplacementDrawers.size();
+				NormalDisplacementDrawer::Create(node, mTransforms, nodeDrawers.mTransform, mNormalDisplacementDrawers);
+				nodeDrawers.mNumDrawers = mNormalDisplacementDrawers.size() - nodeDrawers.mFirstDrawer;
 			}
 			else if (renderType == "Basic") {
-				BasicDrawer::Create(node, mBasicDrawers);
+				nodeDrawers.mType = DrawerType::Basic;
+				nodeDrawers.mFirstDrawer = mBasicDrawers.size();
+				BasicDrawer::Create(node, mTransforms, nodeDrawers.mTransform, mBasicDrawers);
+				nodeDrawers.mNumDrawers = mBasicDrawers.size() - nodeDrawers.mFirstDrawer;
+			}
+			if (nodeDrawers.mType != DrawerType::None && YamlUtils::IsDefined(node, "impostor")) {
+				const std::string impostorName = YamlUtils::GetScalar<std::string>(node, "impostor");
+				const size_t impostorId = Utils::Hash(impostorName.c_str());
+				ImpostorModelByName::const_iterator findIt = mImpostorModelByName.find(impostorId);
+				if (findIt == mImpostorModelByName.end()) {
+					findIt = mImpostorModelByName.insert(std::make_pair(impostorId, mImpostorDrawer.AddModel(node))).first;
+				}
+				ImpostorNode impostorNode;
+				impostorNode.mNode = hierarchyNode;
+				impostorNode.mModel = findIt->second;
+				impostorNode.mScreenFraction = YamlUtils::GetScalar<float>(node, "impostorScreenFraction");
+				impostorNode.mBoundingSphere = Utils::TransformBoundingSphere(mImpostorDrawer.BoundingSphere(impostorNode.mModel), mHierarchy.World(hierarchyNode));
+				impostorNode.mImpostor = false;
+				nodeDrawers.mImpostorNode = mImpostorNodes.size();
+				mImpostorNodes.push_back(impostorNode);
+			}
+			if (YamlUtils::IsDefined(node, "occluder")) {
+				const std::string occluderFilePath = YamlUtils::GetScalar<std::string>(node, "occluder");
+				const Model* occluderModel;
+				ModelManager::gInstance->LoadModel(occluderFilePath.c_str(), &occluderModel);
+				BRE_ASSERT(occluderModel);
+				for (const Mesh* mesh : occluderModel->Meshes()) {
+					mOcclusionCuller.AddOccluder(mesh->Vertices(), mesh->Indices(), nodeDrawers.mTransform);
+				}
+			}
+			BRE_ASSERT(mNodeDrawers.size() == hierarchyNode);
+			mNodeDrawers.push_back(nodeDrawers);
+			++hierarchyNode;
+		}
+
+		BuildObjectBvh();
+	}
+
+	void DrawManager::BuildObjectBvh() {
+		std::vector<BoundingVolumeHierarchy::Aabb> bounds;
+		bounds.reserve(mNormalMappingDrawers.size() + mBasicDrawers.size() + mNormalDisplacementDrawers.size());
+		for (const NormalMappingDrawer& drawer : mNormalMappingDrawers) {
+			bounds.push_back(BoundingVolumeHierarchy::SphereBounds(drawer.BoundingSphere()));
+		}
+		for (const BasicDrawer& drawer : mBasicDrawers) {
+			bounds.push_back(BoundingVolumeHierarchy::SphereBounds(drawer.BoundingSphere()));
+		}
+		// Displacement only moves vertices inwards, so mesh bounds still bound them
+		for (const NormalDisplacementDrawer& drawer : mNormalDisplacementDrawers) {
+			bounds.push_back(BoundingVolumeHierarchy::SphereBounds(drawer.BoundingSphere()));
+		}
+		mObjectBvh.Build(bounds);
+
+		mObjectNodes.resize(bounds.size());
+		const size_t firstBasicObject = mNormalMappingDrawers.size();
+		const size_t firstNormalDisplacementObject = firstBasicObject + mBasicDrawers.size();
+		for (size_t iNode = 0U; iNode < mNodeDrawers.size(); ++iNode) {
+			const NodeDrawers& nodeDrawers = mNodeDrawers[iNode];
+			size_t firstObject = 0U;
+			switch (nodeDrawers.mType) {
+			case DrawerType::NormalMapping:
+				firstObject = nodeDrawers.mFirstDrawer;
+				break;
+			case DrawerType::NormalDisplacement:
+				firstObject = firstNormalDisplacementObject + nodeDrawers.mFirstDrawer;
+				break;
+			case DrawerType::Basic:
+				firstObject = firstBasicObject + nodeDrawers.mFirstDrawer;
+				break;
+			default:
+				break;
 			}
+			for (size_t iObject = firstObject; iObject < firstObject + nodeDrawers.mNumDrawers; ++iObject) {
+				mObjectNodes[iObject] = static_cast<std::uint32_t>(iNode);
+			}
+		}
+	}
+
+	void DrawManager::SelectImpostors(const XMMATRIX& view, const XMMATRIX& proj) {
+		if (mImpostorNodes.empty()) {
+			return;
+		}
+		BRE_PROFILE_SCOPE("ImpostorSelection");
+		for (ImpostorNode& impostorNode : mImpostorNodes) {
+			const float screenFraction = Utils::ProjectedScreenFraction(impostorNode.mBoundingSphere, view, proj);
+			const float threshold = impostorNode.mImpostor ? impostorNode.mScreenFraction * sImpostorHysteresis : impostorNode.mScreenFraction;
+			impostorNode.mImpostor = screenFraction < threshold;
+		}
+
+		// Objects of a node are next to each other. A node is drawn as an
+		// impostor if any of its objects is visible.
+		size_t lastImpostorNode = sNoImpostor;
+		size_t numVisibleObjects = 0U;
+		for (const std::uint32_t object : mVisibleObjects) {
+			const size_t impostorNode = mNodeDrawers[mObjectNodes[object]].mImpostorNode;
+			if (impostorNode == sNoImpostor || !mImpostorNodes[impostorNode].mImpostor) {
+				mVisibleObjects[numVisibleObjects++] = object;
+			}
+			else if (impostorNode != lastImpostorNode) {
+				const ImpostorNode& node = mImpostorNodes[impostorNode];
+				mImpostorDrawer.AddInstance(node.mModel, mTransforms.GetDrawTransforms(mNodeDrawers[node.mNode].mTransform));
+				lastImpostorNode = impostorNode;
+			}
+		}
+		mVisibleObjects.resize(numVisibleObjects);
+	}
+
+	size_t DrawManager::FindNode(const char* name) const {
+		BRE_ASSERT(name);
+		const NodeByName::const_iterator findIt = mNodeByName.find(Utils::Hash(name));
+		return findIt == mNodeByName.end() ? TransformHierarchy::sNoNode : findIt->second;
+	}
+
+	void DrawManager::UpdateTransforms(FrameSnapshot& frame) {
+		BRE_PROFILE_SCOPE("DrawManager::UpdateTransforms");
+		mHierarchy.Update();
+		for (const size_t node : mHierarchy.ChangedNodes()) {
+			FrameSnapshot::TransformUpdate update;
+			update.mNode = node;
+			XMStoreFloat4x4(&update.mWorld, mHierarchy.World(node));
+			frame.mTransformUpdates.push_back(update);
+		}
+	}
+
+	void DrawManager::LoadPointLights(const char* filepath) {
+		BRE_ASSERT(filepath);
+
+		const YAML::Node yamlFile = YamlUtils::LoadFile(filepath);
+		BRE_ASSERT(yamlFile.IsDefined());
+
+		// Get point lights node
+		const YAML::Node nodes = yamlFile["pointLights"];
+		BRE_ASSERT(nodes.IsDefined());
+		BRE_ASSERT(nodes.IsSequence());
+
+		mLightsDrawer.ReservePointLights(mLightsDrawer.NumPointLights() + nodes.size());
+		for (const YAML::Node& node : nodes) {
+			BRE_ASSERT(node.IsDefined());
+			BRE_ASSERT(node.IsMap());
+			float position[3];
+			YamlUtils::GetSequence(node, "position", position, 3U);
+			float color[3];
+			YamlUtils::GetSequence(node, "color", color, 3U);
+			const float radius = YamlUtils::GetScalar<float>(node, "radius");
+			const float power = YamlUtils::GetScalar<float>(node, "power");
+
+			mLightsDrawer.AddPointLight(XMFLOAT4(position[0], position[1], position[2], radius), XMFLOAT4(color[0], color[1], color[2], power));
 		}
 	}
 
-	void DrawManager::DrawAll(ID3D11Device1& device, ID3D11DeviceContext1& context, IDXGISwapChain1& swapChain, ID3D11RenderTargetView& backBufferRTV, ID3D11DepthStencilView& depthStencilView, ID3D11ShaderResourceView& depthStencilSRV) {
+	void DrawManager::DrawAll(const FrameSnapshot& frame, ID3D11Device1& device, ID3D11DeviceContext1& context, IDXGISwapChain1& swapChain, ID3D11RenderTargetView& backBufferRTV, ID3D11DepthStencilView& depthStencilView, ID3D11ShaderResourceView& depthStencilSRV) {
+		BRE_PROFILE_SCOPE("DrawManager::DrawAll");
 		RenderStateHelper::gInstance->SaveAll();
+		mGpuProfiler.BeginFrame(frame.mFrameIndex);
 
 		// Clear render target views
 		ID3D11RenderTargetView* backBuffer = &backBufferRTV;
@@ -66,43 +286,150 @@ namespace BRE {
 			context.ClearRenderTargetView(mPostprocess2RTV, reinterpret_cast<const float*>(&Colors::Black));
 		}
 		
+		ApplyTransformUpdates(frame);
+
+		std::vector<LightsDrawer::DirLightData>& dirLightDataVec = mLightsDrawer.DirLightDataVec();
+		const size_t numDirLights = (std::min)(dirLightDataVec.size(), frame.mDirLights.size());
+		for (size_t i = 0U; i < numDirLights; ++i) {
+			dirLightDataVec[i].mPixelShaderData.Light() = frame.mDirLights[i];
+		}
+
 		// Geometry pass
-		const XMMATRIX view = Camera::gInstance->ViewMatrix();
-		const XMMATRIX proj = Camera::gInstance->ProjectionMatrix();
-		{			
+		const XMMATRIX view = XMLoadFloat4x4(&frame.mViewMatrix);
+		const XMMATRIX proj = XMLoadFloat4x4(&frame.mProjectionMatrix);
+		const XMMATRIX viewProj = view * proj;
+		{
+			BRE_PROFILE_SCOPE("FrustumCulling");
+			mVisibleObjects.clear();
+			mObjectBvh.QueryFrustum(viewProj, mVisibleObjects);
+			// Drawers are drawn in the same order every frame
+			std::sort(mVisibleObjects.begin(), mVisibleObjects.end());
+			BRE_COUNTER_ADD(RenderCounter::CulledObjects, mObjectBvh.NumObjects() - mVisibleObjects.size());
+		}
+		if (mOcclusionCuller.NumOccluders() > 0U) {
+			BRE_PROFILE_SCOPE("OcclusionCulling");
+			const size_t numObjectsInFrustum = mVisibleObjects.size();
+			mOcclusionCuller.RenderOccluders(viewProj, mTransforms);
+			mOcclusionCuller.RemoveOccluded(mObjectBvh, mVisibleObjects);
+			BRE_COUNTER_ADD(RenderCounter::OccludedObjects, numObjectsInFrustum - mVisibleObjects.size());
+		}
+		// Culled objects (and impostors of culled nodes) are not drawn. Objects of a
+		// node are next to each other and share its transform.
+		mVisibleTransforms.clear();
+		for (const std::uint32_t object : mVisibleObjects) {
+			const size_t transform = mNodeDrawers[mObjectNodes[object]].mTransform;
+			if (mVisibleTransforms.empty() || mVisibleTransforms.back() != transform) {
+				mVisibleTransforms.push_back(transform);
+			}
+		}
+		mTransforms.ComputeDrawTransforms(view, proj, mVisibleTransforms);
+		SelectImpostors(view, proj);
+		const std::uint32_t firstBasicObject = static_cast<std::uint32_t>(mNormalMappingDrawers.size());
+		const std::uint32_t firstNormalDisplacementObject = firstBasicObject + static_cast<std::uint32_t>(mBasicDrawers.size());
+		const std::vector<std::uint32_t>::const_iterator normalDisplacementObjects = std::lower_bound(mVisibleObjects.cbegin(), mVisibleObjects.cend(), firstNormalDisplacementObject);
+		{
+			BRE_PROFILE_SCOPE("GeometryPass");
 			context.OMSetRenderTargets(1, &backBuffer, &depthStencilView);
-			for (NormalMappingDrawer& elem : mNormalMappingDrawers) {
-				elem.Draw(device, context, mGBuffersRTVs, view, proj);
+			// Drawers of the other passes bind their own buffers
+			GeometryPool::gInstance->Defragment(sGeometryDefragmentBytes);
+			GeometryPool::gInstance->Invalidate();
+			// Textures of all materials of the table, for the whole pass
+			if (MaterialTable::gInstance) {
+				MaterialTable::gInstance->Bind(context);
+			}
+			{
+				const GpuProfileScope gpuScope(mGpuProfiler, mGeometryGpuPass);
+				for (std::vector<std::uint32_t>::const_iterator it = mVisibleObjects.cbegin(); it != normalDisplacementObjects; ++it) {
+					if (*it < firstBasicObject) {
+						mNormalMappingDrawers[*it].Draw(device, context, mGBuffersRTVs, mTransforms, view, proj);
+					}
+					else {
+						mBasicDrawers[*it - firstBasicObject].Draw(device, context, mGBuffersRTVs, mTransforms, view, proj);
+					}
+				}
 			}
-			for (NormalDisplacementDrawer& elem : mNormalDisplacementDrawers) {
-				elem.Draw(device, context, mGBuffersRTVs, view, proj);
+			{
+				// Tessellated draws are timed apart to tune tessellation factors
+				const GpuProfileScope gpuScope(mGpuProfiler, mNormalDisplacementGpuPass);
+				for (std::vector<std::uint32_t>::const_iterator it = normalDisplacementObjects; it != mVisibleObjects.cend(); ++it) {
+					mNormalDisplacementDrawers[*it - firstNormalDisplacementObject].Draw(device, context, mGBuffersRTVs, mTransforms, view, proj);
+				}
 			}
-			for (BasicDrawer& elem : mBasicDrawers) {
-				elem.Draw(device, context, mGBuffersRTVs, view, proj);
+			{
+				const GpuProfileScope gpuScope(mGpuProfiler, mImpostorsGpuPass);
+				mImpostorDrawer.Draw(device, context, mGBuffersRTVs, proj);
+			}
+			if (MaterialTable::gInstance) {
+				MaterialTable::gInstance->Unbind(context);
 			}
 		}
 
 		// Lighting pass
 		{
+			BRE_PROFILE_SCOPE("LightingPass");
 			context.OMSetRenderTargets(1, &mPostprocess1RTV, nullptr);
-			const float nearClipPlaneDistance = Camera::gInstance->NearPlaneDistance();
-			const float farClipPlaneDistance = Camera::gInstance->FarPlaneDistance();
-			mLightsDrawer.Draw(device, context, mGBuffersSRVs, depthStencilSRV, nearClipPlaneDistance, farClipPlaneDistance, view, proj);
+			const GpuProfileScope gpuScope(mGpuProfiler, mLightingGpuPass);
+			mLightsDrawer.Draw(device, context, mGBuffersSRVs, depthStencilSRV, frame.mNearPlaneDistance, frame.mFarPlaneDistance, view, proj);
 		}
 
 		// Post-process pass
 		{
+			BRE_PROFILE_SCOPE("PostProcessPass");
 			context.OMSetRenderTargets(1, &backBuffer, &depthStencilView);
+			const GpuProfileScope gpuScope(mGpuProfiler, mToneMappingGpuPass);
 			mPostProcessDrawer.Draw(device, context, mPostprocess1SRV);
 		}
 
+		std::wostringstream frameRate;
+		frameRate << frame.mFrameRate;
+		mFrameRateDrawer.Text() = frameRate.str();
 		mFrameRateDrawer.Draw();
 
-		ASSERT_HR(swapChain.Present(0, 0));
+		mGpuProfiler.EndFrame();
+
+		{
+			BRE_PROFILE_SCOPE("Present");
+			ASSERT_HR(swapChain.Present(0, 0));
+		}
 
 		RenderStateHelper::gInstance->RestoreAll();
 	}
 
+	void DrawManager::ApplyTransformUpdates(const FrameSnapshot& frame) {
+		const size_t firstBasicObject = mNormalMappingDrawers.size();
+		const size_t firstNormalDisplacementObject = firstBasicObject + mBasicDrawers.size();
+		for (const FrameSnapshot::TransformUpdate& update : frame.mTransformUpdates) {
+			BRE_ASSERT(update.mNode < mNodeDrawers.size());
+			const NodeDrawers& nodeDrawers = mNodeDrawers[update.mNode];
+			const XMMATRIX world = XMLoadFloat4x4(&update.mWorld);
+			mTransforms.Set(nodeDrawers.mTransform, world);
+			if (nodeDrawers.mImpostorNode != sNoImpostor) {
+				ImpostorNode& impostorNode = mImpostorNodes[nodeDrawers.mImpostorNode];
+				impostorNode.mBoundingSphere = Utils::TransformBoundingSphere(mImpostorDrawer.BoundingSphere(impostorNode.mModel), world);
+			}
+			const size_t drawersEnd = nodeDrawers.mFirstDrawer + nodeDrawers.mNumDrawers;
+			for (size_t iDrawer = nodeDrawers.mFirstDrawer; iDrawer < drawersEnd; ++iDrawer) {
+				switch (nodeDrawers.mType) {
+				case DrawerType::NormalMapping:
+					mNormalMappingDrawers[iDrawer].SetWorld(world);
+					mObjectBvh.SetBounds(iDrawer, BoundingVolumeHierarchy::SphereBounds(mNormalMappingDrawers[iDrawer].BoundingSphere()));
+					break;
+				case DrawerType::NormalDisplacement:
+					mNormalDisplacementDrawers[iDrawer].SetWorld(world);
+					mObjectBvh.SetBounds(firstNormalDisplacementObject + iDrawer, BoundingVolumeHierarchy::SphereBounds(mNormalDisplacementDrawers[iDrawer].BoundingSphere()));
+					break;
+				case DrawerType::Basic:
+					mBasicDrawers[iDrawer].SetWorld(world);
+					mObjectBvh.SetBounds(firstBasicObject + iDrawer, BoundingVolumeHierarchy::SphereBounds(mBasicDrawers[iDrawer].BoundingSphere()));
+					break;
+				default:
+					break;
+				}
+			}
+		}
+		mObjectBvh.Refit();
+	}
+
 	void DrawManager::InitGBuffers(const unsigned int screenWidth, const unsigned int screenHeight) {
 		const size_t numTextures = ARRAYSIZE(mGBuffersSRVs);
 
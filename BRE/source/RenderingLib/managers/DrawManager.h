@@ -1,11 +1,20 @@
 #pragma once
 
 #include <DirectXMath.h>
+#include <unordered_map>
 #include <vector>
 
+#include <general/FrameSnapshot.h>
+#include <general/TransformHierarchy.h>
+#include <rendering/BoundingVolumeHierarchy.h>
+#include <rendering/D3D11GpuQuerySource.h>
+#include <rendering/GpuProfiler.h>
+#include <rendering/OcclusionCuller.h>
 #include <rendering/StringDrawer.h>
+#include <rendering/TransformArray.h>
 #include <rendering/shaders/basic/BasicDrawer.h>
 #include <rendering/shaders/filters/PostProcessDrawer.h>
+#include <rendering/shaders/impostor/ImpostorDrawer.h>
 #include <rendering/shaders/lightPasses/LightsDrawer.h>
 #include <rendering/shaders/normalDisplacement/NormalDisplacementDrawer.h>
 #include <rendering/shaders/normalMapping/NormalMappingDrawer.h>
@@ -27,17 +36,40 @@ namespace BRE {
 
 		DrawManager(ID3D11Device1& device, ID3D11DeviceContext1& context, const unsigned int screenWidth, const unsigned int screenHeight);
 
+		// Each entry of the file is a TransformHierarchy node. Its translation,
+		// rotation and scaling are relative to the "parent" entry (the "name" of
+		// a previous entry), if any. Entries without a known render type have no
+		// drawers (pivots). The meshes of the "occluder" model (a low poly proxy,
+		// or the model itself) of an entry hide the objects behind them.
+		// Entries with the same "impostor" name share the impostor of the first
+		// one. They are drawn with it while they cover less than their
+		// "impostorScreenFraction" of the screen height.
 		void LoadModels(const char* filepath);
+		// Point lights are frustum culled by LightsDrawer
+		void LoadPointLights(const char* filepath);
 
-		void DrawAll(ID3D11Device1& device, ID3D11DeviceContext1& context, IDXGISwapChain1& swapChain, ID3D11RenderTargetView& backBufferRTV, ID3D11DepthStencilView& depthStencilView, ID3D11ShaderResourceView& depthStencilSRV);
+		// Simulation thread. Nodes can be moved through the hierarchy, then
+		// UpdateTransforms() copies world matrices that changed to the frame.
+		TransformHierarchy& Hierarchy() { return mHierarchy; }
+		// Node of the models file entry with that name. TransformHierarchy::sNoNode if there is none.
+		size_t FindNode(const char* name) const;
+		void UpdateTransforms(FrameSnapshot& frame);
+
+		// It draws and presents the frame of the snapshot. It is the only method
+		// that can be called while the main thread simulates next frames.
+		void DrawAll(const FrameSnapshot& frame, ID3D11Device1& device, ID3D11DeviceContext1& context, IDXGISwapChain1& swapChain, ID3D11RenderTargetView& backBufferRTV, ID3D11DepthStencilView& depthStencilView, ID3D11ShaderResourceView& depthStencilSRV);
 
 		std::vector<LightsDrawer::DirLightData>& DirLightDataVec() { return mLightsDrawer.DirLightDataVec(); }
-		std::vector<LightsDrawer::PointLightData>& PointLightDataVec() { return mLightsDrawer.PointLightDataVec(); }
-		StringDrawer& FrameRateDrawer() { return mFrameRateDrawer; }
+		const GpuProfiler& GpuPassProfiler() const { return mGpuProfiler; }
 
 	private:
 		void InitPostProcessResources(const unsigned int screenWidth, const unsigned int screenHeight);
 		void InitGBuffers(const unsigned int screenWidth, const unsigned int screenHeight);
+		// World matrices and bounds of the drawers of the nodes that changed
+		void ApplyTransformUpdates(const FrameSnapshot& frame);
+		void BuildObjectBvh();
+		// Nodes drawn as impostors this frame. Their objects are removed from the visible ones.
+		void SelectImpostors(const DirectX::XMMATRIX& view, const DirectX::XMMATRIX& proj);
 
 		// Render target views and shader resources views
 		// for fully deferred rendering purposes
@@ -54,11 +86,69 @@ namespace BRE {
 		ID3D11RenderTargetView* mPostprocess2RTV;
 		ID3D11ShaderResourceView* mPostprocess2SRV;
 
+		// Drawers of each hierarchy node. They are contiguous in the vector of their type.
+		enum class DrawerType {
+			None,
+			NormalMapping,
+			NormalDisplacement,
+			Basic,
+		};
+		struct NodeDrawers {
+			size_t mTransform;
+			DrawerType mType;
+			size_t mFirstDrawer;
+			size_t mNumDrawers;
+			// Index in mImpostorNodes, or sNoImpostor
+			size_t mImpostorNode;
+		};
+		static const size_t sNoImpostor = static_cast<size_t>(-1);
+
+		struct ImpostorNode {
+			size_t mNode;
+			// ImpostorDrawer model
+			size_t mModel;
+			float mScreenFraction;
+			// World space bounds of the model
+			DirectX::XMFLOAT4 mBoundingSphere;
+			// Drawn as an impostor last frame
+			bool mImpostor;
+		};
+
+		// Only used by the simulation thread after loading
+		TransformHierarchy mHierarchy;
+		typedef std::unordered_map<size_t, size_t> NodeByName;
+		NodeByName mNodeByName;
+
+		// World matrices of the drawers below
+		TransformArray mTransforms;
+		// By hierarchy node
+		std::vector<NodeDrawers> mNodeDrawers;
 		std::vector<NormalDisplacementDrawer> mNormalDisplacementDrawers;
 		std::vector<NormalMappingDrawer> mNormalMappingDrawers;
 		std::vector<BasicDrawer> mBasicDrawers;
+		// Objects are the normal mapping drawers, then the basic ones, then the normal displacement ones
+		BoundingVolumeHierarchy mObjectBvh;
+		// Hierarchy node of each object
+		std::vector<std::uint32_t> mObjectNodes;
+		std::vector<ImpostorNode> mImpostorNodes;
+		typedef std::unordered_map<size_t, size_t> ImpostorModelByName;
+		ImpostorModelByName mImpostorModelByName;
+		ImpostorDrawer mImpostorDrawer;
+		// Objects in the frustum and not occluded this frame, sorted
+		std::vector<std::uint32_t> mVisibleObjects;
+		// Transforms of the visible objects, the only draw transforms computed
+		std::vector<size_t> mVisibleTransforms;
+		OcclusionCuller mOcclusionCuller;
 		LightsDrawer mLightsDrawer;
 		PostProcessDrawer mPostProcessDrawer;
 		StringDrawer mFrameRateDrawer;		
+
+		D3D11GpuQuerySource mGpuQuerySource;
+		GpuProfiler mGpuProfiler;
+		size_t mGeometryGpuPass;
+		size_t mNormalDisplacementGpuPass;
+		size_t mImpostorsGpuPass;
+		size_t mLightingGpuPass;
+		size_t mToneMappingGpuPass;
 	};
 }
\ No newline at end of file
@@ -0,0 +1,265 @@
+#include "GeometryPool.h"
+
+#include <algorithm>
+#include <d3d11_1.h>
+
+#include <general/CountedContext.h>
+#include <general/Profiler.h>
+#include <managers/ModelManager.h>
+#include <rendering/models/Mesh.h>
+#include <rendering/models/Model.h>
+#include <rendering/shaders/VertexType.h>
+#include <utils/Assert.h>
+
+namespace {
+	// Elements of each pool before it grows
+	const unsigned int sInitialVertexCapacity = 65536U;
+	const unsigned int sInitialIndexCapacity = 262144U;
+	// Pools are defragmented while more than this fraction of them is free
+	// space below their highest range
+	const unsigned int sMinFragmentationDivisor = 16U;
+}
+
+namespace BRE {
+	GeometryPool* GeometryPool::gInstance = nullptr;
+
+	GeometryPool::Pool::Pool(const unsigned int stride, const unsigned int bindFlags, const unsigned int capacity)
+		: mBuffer(nullptr)
+		, mScratchBuffer(nullptr)
+		, mScratchCapacity(0U)
+		, mStride(stride)
+		, mBindFlags(bindFlags)
+		, mAllocator(capacity)
+		, mFragmented(false)
+	{
+	}
+
+	GeometryPool::GeometryPool(ID3D11Device1& device, ID3D11DeviceContext1& context)
+		: mDevice(device)
+		, mContext(context)
+		, mBoundFormat(VertexFormat::Count)
+	{
+		mPools.reserve(static_cast<size_t>(VertexFormat::Count) + 1U);
+		mPools.push_back(Pool(static_cast<unsigned int>(sizeof(NormalMappingVertexData)), D3D11_BIND_VERTEX_BUFFER, sInitialVertexCapacity));
+		mPools.push_back(Pool(static_cast<unsigned int>(sizeof(BasicVertexData)), D3D11_BIND_VERTEX_BUFFER, sInitialVertexCapacity));
+		mPools.push_back(Pool(static_cast<unsigned int>(sizeof(unsigned int)), D3D11_BIND_INDEX_BUFFER, sInitialIndexCapacity));
+		for (Pool& pool : mPools) {
+			CreateBuffer(pool.mAllocator.Capacity() * pool.mStride, pool.mBindFlags, pool.mBuffer);
+		}
+	}
+
+	GeometryPool::~GeometryPool() {
+		for (Pool& pool : mPools) {
+			pool.mBuffer->Release();
+			if (pool.mScratchBuffer) {
+				pool.mScratchBuffer->Release();
+			}
+		}
+	}
+
+	size_t GeometryPool::AddMesh(const size_t modelId, const size_t meshIndex, const VertexFormat format) {
+		BRE_ASSERT(format < VertexFormat::Count);
+		const MeshKey key = { modelId, meshIndex, format };
+		const std::map<MeshKey, size_t>::const_iterator findIt = mMeshByKey.find(key);
+		if (findIt != mMeshByKey.end()) {
+			++mMeshes[findIt->second].mReferences;
+			return findIt->second;
+		}
+
+		BRE_ASSERT(ModelManager::gInstance->GetModel(modelId));
+		const Model& model = *ModelManager::gInstance->GetModel(modelId);
+		BRE_ASSERT(meshIndex < model.Meshes().size());
+		const BRE::Mesh& mesh = *model.Meshes()[meshIndex];
+
+		MeshRanges ranges;
+		ranges.mModelId = modelId;
+		ranges.mMeshIndex = meshIndex;
+		ranges.mFormat = format;
+		ranges.mReferences = 1U;
+		Pool& vertexPool = mPools[static_cast<size_t>(format)];
+		switch (format) {
+		case VertexFormat::NormalMapping:
+		{
+			std::vector<NormalMappingVertexData> vertices;
+			NormalMappingVertexData::CreateVertices(mesh, vertices);
+			ranges.mBaseVertex = Allocate(vertexPool, static_cast<unsigned int>(vertices.size()));
+			Upload(vertexPool, ranges.mBaseVertex, vertices.data(), static_cast<unsigned int>(vertices.size()));
+			break;
+		}
+		case VertexFormat::Basic:
+		{
+			std::vector<BasicVertexData> vertices;
+			BasicVertexData::CreateVertices(mesh, vertices);
+			ranges.mBaseVertex = Allocate(vertexPool, static_cast<unsigned int>(vertices.size()));
+			Upload(vertexPool, ranges.mBaseVertex, vertices.data(), static_cast<unsigned int>(vertices.size()));
+			break;
+		}
+		default:
+			BRE_ASSERT(false);
+			break;
+		}
+		std::vector<unsigned int> indices;
+		model.CreateIndices(meshIndex, indices);
+		Pool& indexPool = mPools.back();
+		ranges.mStartIndex = Allocate(indexPool, static_cast<unsigned int>(indices.size()));
+		Upload(indexPool, ranges.mStartIndex, indices.data(), static_cast<unsigned int>(indices.size()));
+
+		size_t handle;
+		if (mFreeMeshes.empty()) {
+			handle = mMeshes.size();
+			mMeshes.push_back(ranges);
+		}
+		else {
+			handle = mFreeMeshes.back();
+			mFreeMeshes.pop_back();
+			mMeshes[handle] = ranges;
+		}
+		vertexPool.mMeshByOffset[ranges.mBaseVertex] = handle;
+		indexPool.mMeshByOffset[ranges.mStartIndex] = handle;
+		mMeshByKey[key] = handle;
+		return handle;
+	}
+
+	void GeometryPool::RemoveMesh(const size_t mesh) {
+		BRE_ASSERT(mesh < mMeshes.size());
+		MeshRanges& ranges = mMeshes[mesh];
+		BRE_ASSERT(ranges.mReferences > 0U);
+		--ranges.mReferences;
+		if (ranges.mReferences > 0U) {
+			return;
+		}
+		Pool& vertexPool = mPools[static_cast<size_t>(ranges.mFormat)];
+		vertexPool.mAllocator.Free(ranges.mBaseVertex);
+		vertexPool.mMeshByOffset.erase(ranges.mBaseVertex);
+		vertexPool.mFragmented = true;
+		Pool& indexPool = mPools.back();
+		indexPool.mAllocator.Free(ranges.mStartIndex);
+		indexPool.mMeshByOffset.erase(ranges.mStartIndex);
+		indexPool.mFragmented = true;
+		const MeshKey key = { ranges.mModelId, ranges.mMeshIndex, ranges.mFormat };
+		mMeshByKey.erase(key);
+		mFreeMeshes.push_back(mesh);
+	}
+
+	unsigned int GeometryPool::BaseVertex(const size_t mesh) const {
+		BRE_ASSERT(mesh < mMeshes.size());
+		BRE_ASSERT(mMeshes[mesh].mReferences > 0U);
+		return mMeshes[mesh].mBaseVertex;
+	}
+
+	unsigned int GeometryPool::StartIndex(const size_t mesh) const {
+		BRE_ASSERT(mesh < mMeshes.size());
+		BRE_ASSERT(mMeshes[mesh].mReferences > 0U);
+		return mMeshes[mesh].mStartIndex;
+	}
+
+	void GeometryPool::Bind(ID3D11DeviceContext1& context, const VertexFormat format) {
+		BRE_ASSERT(format < VertexFormat::Count);
+		if (format == mBoundFormat) {
+			return;
+		}
+		const Pool& vertexPool = mPools[static_cast<size_t>(format)];
+		const unsigned int offset = 0U;
+		CountedContext::IASetVertexBuffers(context, 0, 1, &vertexPool.mBuffer, &vertexPool.mStride, &offset);
+		// The index buffer is shared by all formats
+		if (mBoundFormat == VertexFormat::Count) {
+			CountedContext::IASetIndexBuffer(context, mPools.back().mBuffer, DXGI_FORMAT_R32_UINT, 0);
+		}
+		mBoundFormat = format;
+	}
+
+	void GeometryPool::Defragment(const unsigned int maxBytes) {
+		if (std::none_of(mPools.cbegin(), mPools.cend(), [](const Pool& pool) { return pool.mFragmented; })) {
+			return;
+		}
+		BRE_PROFILE_SCOPE("GeometryPool::Defragment");
+		const size_t indexPool = mPools.size() - 1U;
+		for (size_t iPool = 0U; iPool < mPools.size(); ++iPool) {
+			Defragment(mPools[iPool], iPool == indexPool, (std::max)(maxBytes / mPools[iPool].mStride, 1U));
+		}
+	}
+
+	unsigned int GeometryPool::Allocate(Pool& pool, const unsigned int size) {
+		BRE_ASSERT(size > 0U);
+		unsigned int offset = pool.mAllocator.Allocate(size);
+		if (offset != RangeAllocator::sInvalidOffset) {
+			return offset;
+		}
+
+		// Double the capacity (or more, for a large mesh) and copy the old buffer
+		const unsigned int oldCapacity = pool.mAllocator.Capacity();
+		const unsigned int newCapacity = (std::max)(oldCapacity * 2U, oldCapacity + size);
+		ID3D11Buffer* newBuffer;
+		CreateBuffer(newCapacity * pool.mStride, pool.mBindFlags, newBuffer);
+		D3D11_BOX box = { 0U, 0U, 0U, oldCapacity * pool.mStride, 1U, 1U };
+		mContext.CopySubresourceRegion(newBuffer, 0U, 0U, 0U, 0U, pool.mBuffer, 0U, &box);
+		pool.mBuffer->Release();
+		pool.mBuffer = newBuffer;
+		pool.mAllocator.Grow(newCapacity);
+		Invalidate();
+
+		offset = pool.mAllocator.Allocate(size);
+		BRE_ASSERT(offset != RangeAllocator::sInvalidOffset);
+		return offset;
+	}
+
+	void GeometryPool::Upload(Pool& pool, const unsigned int offset, const void* data, const unsigned int size) {
+		BRE_ASSERT(data);
+		const D3D11_BOX box = { offset * pool.mStride, 0U, 0U, (offset + size) * pool.mStride, 1U, 1U };
+		mContext.UpdateSubresource(pool.mBuffer, 0U, &box, data, 0U, 0U);
+		BRE_COUNTER_ADD(RenderCounter::UploadBytes, size * pool.mStride);
+	}
+
+	void GeometryPool::CreateBuffer(const unsigned int byteWidth, const unsigned int bindFlags, ID3D11Buffer* &buffer) {
+		D3D11_BUFFER_DESC bufferDesc;
+		ZeroMemory(&bufferDesc, sizeof(D3D11_BUFFER_DESC));
+		bufferDesc.ByteWidth = byteWidth;
+		bufferDesc.Usage = D3D11_USAGE_DEFAULT;
+		bufferDesc.BindFlags = bindFlags;
+		ASSERT_HR(mDevice.CreateBuffer(&bufferDesc, nullptr, &buffer));
+		BRE_ASSERT(buffer);
+	}
+
+	void GeometryPool::Defragment(Pool& pool, const bool indices, const unsigned int maxElements) {
+		if (!pool.mFragmented) {
+			return;
+		}
+		// A few small holes are not worth the copies
+		if (pool.mAllocator.FragmentedSize() <= pool.mAllocator.Capacity() / sMinFragmentationDivisor) {
+			pool.mFragmented = false;
+			return;
+		}
+		mMoves.clear();
+		pool.mAllocator.Defragment(maxElements, mMoves);
+		// The remaining holes are smaller than the ranges above them
+		if (mMoves.empty()) {
+			pool.mFragmented = false;
+		}
+		for (const RangeAllocator::Move& move : mMoves) {
+			const unsigned int moveBytes = move.mSize * pool.mStride;
+			if (moveBytes > pool.mScratchCapacity) {
+				if (pool.mScratchBuffer) {
+					pool.mScratchBuffer->Release();
+				}
+				pool.mScratchCapacity = (std::max)(moveBytes, pool.mScratchCapacity * 2U);
+				CreateBuffer(pool.mScratchCapacity, pool.mBindFlags, pool.mScratchBuffer);
+			}
+			const D3D11_BOX fromBox = { move.mFrom * pool.mStride, 0U, 0U, move.mFrom * pool.mStride + moveBytes, 1U, 1U };
+			mContext.CopySubresourceRegion(pool.mScratchBuffer, 0U, 0U, 0U, 0U, pool.mBuffer, 0U, &fromBox);
+			const D3D11_BOX scratchBox = { 0U, 0U, 0U, moveBytes, 1U, 1U };
+			mContext.CopySubresourceRegion(pool.mBuffer, 0U, move.mTo * pool.mStride, 0U, 0U, pool.mScratchBuffer, 0U, &scratchBox);
+
+			const std::unordered_map<unsigned int, size_t>::iterator meshIt = pool.mMeshByOffset.find(move.mFrom);
+			BRE_ASSERT(meshIt != pool.mMeshByOffset.end());
+			const size_t mesh = meshIt->second;
+			pool.mMeshByOffset.erase(meshIt);
+			pool.mMeshByOffset[move.mTo] = mesh;
+			if (indices) {
+				mMeshes[mesh].mStartIndex = move.mTo;
+			}
+			else {
+				mMeshes[mesh].mBaseVertex = move.mTo;
+			}
+		}
+	}
+}
\ No newline at end of file
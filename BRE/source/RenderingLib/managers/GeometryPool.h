@@ -0,0 +1,121 @@
+#pragma once
+
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+#include <utils/RangeAllocator.h>
+
+struct ID3D11Buffer;
+struct ID3D11Device1;
+struct ID3D11DeviceContext1;
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Vertices and indices of model meshes in a few large buffers: a vertex
+// buffer for each vertex format and an index buffer shared by all of
+// them. Meshes are ranges of them (RangeAllocator) drawn with their base
+// vertex and start index, so consecutive draws of a format do not bind
+// buffers. A full buffer doubles its capacity (it is recreated and its
+// contents copied). Defragment() moves some ranges each frame, so the
+// free space of removed meshes (streaming) goes to the end of the buffers.
+// It does nothing until a mesh is removed and the free space below the
+// highest range of a buffer is a noticeable part of it.
+// Ranges move, so offsets of a mesh must be read when it is drawn.
+// It uses the immediate context, so it must be used by the thread that
+// draws (or before drawing starts).
+//
+//////////////////////////////////////////////////////////////////////////
+
+namespace BRE {
+	class GeometryPool {
+	public:
+		static GeometryPool* gInstance;
+
+		enum class VertexFormat {
+			NormalMapping = 0,
+			Basic,
+			Count
+		};
+
+		GeometryPool(ID3D11Device1& device, ID3D11DeviceContext1& context);
+		~GeometryPool();
+
+		const GeometryPool& operator=(const GeometryPool& rhs) = delete;
+
+		// Vertices in the format and indices of all levels of detail
+		// (Model::CreateIndices) of the mesh of the model. Meshes are shared,
+		// so adding one again returns the same handle.
+		size_t AddMesh(const size_t modelId, const size_t meshIndex, const VertexFormat format);
+		// Its ranges are freed when it is removed as many times as it was added
+		void RemoveMesh(const size_t mesh);
+
+		unsigned int BaseVertex(const size_t mesh) const;
+		unsigned int StartIndex(const size_t mesh) const;
+
+		// Binds the vertex buffer of the format and the index buffer, unless they are bound
+		void Bind(ID3D11DeviceContext1& context, const VertexFormat format);
+		// Next Bind() binds the buffers. Input assembler buffers may have been changed by other drawers.
+		void Invalidate() { mBoundFormat = VertexFormat::Count; }
+
+		// Moves at least maxBytes of each fragmented buffer (if there are ranges to move)
+		void Defragment(const unsigned int maxBytes);
+
+	private:
+		struct Pool {
+			Pool(const unsigned int stride, const unsigned int bindFlags, const unsigned int capacity);
+
+			ID3D11Buffer* mBuffer;
+			// Moved ranges are copied through it (a buffer region cannot be copied into the same buffer)
+			ID3D11Buffer* mScratchBuffer;
+			unsigned int mScratchCapacity;
+			unsigned int mStride;
+			unsigned int mBindFlags;
+			RangeAllocator mAllocator;
+			// Meshes by offset of their range
+			std::unordered_map<unsigned int, size_t> mMeshByOffset;
+			// Set when a range is freed. Cleared when the fragmentation is below
+			// the threshold or no range can move down.
+			bool mFragmented;
+		};
+
+		struct MeshRanges {
+			size_t mModelId;
+			size_t mMeshIndex;
+			VertexFormat mFormat;
+			unsigned int mBaseVertex;
+			unsigned int mStartIndex;
+			// 0 if the handle is free
+			unsigned int mReferences;
+		};
+
+		struct MeshKey {
+			size_t mModelId;
+			size_t mMeshIndex;
+			VertexFormat mFormat;
+
+			bool operator<(const MeshKey& key) const {
+				if (mModelId != key.mModelId) return mModelId < key.mModelId;
+				if (mMeshIndex != key.mMeshIndex) return mMeshIndex < key.mMeshIndex;
+				return mFormat < key.mFormat;
+			}
+		};
+
+		// Offset of size elements of the pool, which grows if they do not fit
+		unsigned int Allocate(Pool& pool, const unsigned int size);
+		void Upload(Pool& pool, const unsigned int offset, const void* data, const unsigned int size);
+		void CreateBuffer(const unsigned int byteWidth, const unsigned int bindFlags, ID3D11Buffer* &buffer);
+		void Defragment(Pool& pool, const bool indices, const unsigned int maxElements);
+
+		ID3D11Device1& mDevice;
+		ID3D11DeviceContext1& mContext;
+
+		// A pool for each vertex format, then the index pool
+		std::vector<Pool> mPools;
+		std::vector<MeshRanges> mMeshes;
+		std::vector<size_t> mFreeMeshes;
+		std::map<MeshKey, size_t> mMeshByKey;
+		std::vector<RangeAllocator::Move> mMoves;
+		VertexFormat mBoundFormat;
+	};
+}
\ No newline at end of file
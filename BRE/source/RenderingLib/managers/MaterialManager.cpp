@@ -1,17 +1,40 @@
 #include "MaterialManager.h"
 
+#include <algorithm>
+#include <d3d11_1.h>
+
+#include <general/Profiler.h>
+#include <managers/MaterialTable.h>
 #include <managers/ShaderResourcesManager.h>
+#include <managers/TextureStreamer.h>
 
 #include <utils/Assert.h>
 #include <utils/Hash.h>
 #include <utils/YamlUtils.h>
 
+namespace {
+	BRE::SamplerFilter GetSamplerFilter(const std::string& name) {
+		if (name == "Point") {
+			return BRE::SamplerFilter::Point;
+		}
+		if (name == "Anisotropic") {
+			return BRE::SamplerFilter::Anisotropic;
+		}
+		BRE_ASSERT(name == "Trilinear");
+		return BRE::SamplerFilter::Trilinear;
+	}
+
+	bool IsPacked(const BRE::MaterialManager::InputData& data) {
+		return !data.mSmoothnessMetalMaskCurvatureTexturePath.empty() || (data.mUniformMask & BRE::MaterialManager::sUniformSmoothnessMetalMaskCurvature) != 0U;
+	}
+}
+
 namespace BRE {
 	MaterialManager* MaterialManager::gInstance = nullptr;
 
 	void MaterialManager::LoadMaterials(const char* materialFile) {
 		BRE_ASSERT(materialFile);
-		const YAML::Node yamlFile = YAML::LoadFile(materialFile);
+		const YAML::Node yamlFile = YamlUtils::LoadFile(materialFile);
 		BRE_ASSERT(yamlFile.IsDefined());
 		const YAML::Node nodes = yamlFile["materials"];
 		BRE_ASSERT(nodes.IsDefined());
@@ -22,38 +45,294 @@ namespace BRE {
 			InputData data;
 			data.mName = YamlUtils::GetScalar<std::string>(node, "name");
 			data.mNormalTexturePath = YamlUtils::GetScalar<std::string>(node, "normal");
-			data.mBaseColorTexturePath = YamlUtils::GetScalar<std::string>(node, "baseColor");
-			data.mSmoothnessTexturePath = YamlUtils::GetScalar<std::string>(node, "smoothness");
-			data.mMetalMaskTexturePath = YamlUtils::GetScalar<std::string>(node, "metalMask");
-			data.mCurvatureTexturePath = YamlUtils::GetScalar<std::string>(node, "curvature");
-			AddMaterial(data);
+			if (node["baseColorValue"].IsDefined()) {
+				YamlUtils::GetSequence<float>(node, "baseColorValue", data.mBaseColorValue, 3U);
+				data.mUniformMask |= sUniformBaseColor;
+			}
+			else {
+				data.mBaseColorTexturePath = YamlUtils::GetScalar<std::string>(node, "baseColor");
+			}
+			if (node["smoothnessMetalMaskCurvature"].IsDefined()) {
+				data.mSmoothnessMetalMaskCurvatureTexturePath = YamlUtils::GetScalar<std::string>(node, "smoothnessMetalMaskCurvature");
+			}
+			else if (node["smoothnessMetalMaskCurvatureValue"].IsDefined()) {
+				YamlUtils::GetSequence<float>(node, "smoothnessMetalMaskCurvatureValue", data.mSmoothnessMetalMaskCurvatureValue, 3U);
+				data.mUniformMask |= sUniformSmoothnessMetalMaskCurvature;
+			}
+			else {
+				data.mSmoothnessTexturePath = YamlUtils::GetScalar<std::string>(node, "smoothness");
+				data.mMetalMaskTexturePath = YamlUtils::GetScalar<std::string>(node, "metalMask");
+				data.mCurvatureTexturePath = YamlUtils::GetScalar<std::string>(node, "curvature");
+			}
+			if (node["sampler"].IsDefined()) {
+				data.mSampler = GetSamplerFilter(YamlUtils::GetScalar<std::string>(node, "sampler"));
+			}
+			RegisterMaterial(data);
 		}
 	}
 
+	size_t MaterialManager::RegisterMaterial(const InputData& data) {
+		const size_t id = Utils::Hash(data.mName.c_str());
+		BRE_ASSERT(mMaterialDataIdById.find(id) == mMaterialDataIdById.end());
+		MaterialDataId& newMaterialId = mMaterialDataIdById[id];
+		newMaterialId.mPacked = IsPacked(data);
+		BRE_ASSERT(newMaterialId.mPacked || data.mUniformMask == 0U);
+		newMaterialId.mSampler = data.mSampler;
+		newMaterialId.mUniformMask = data.mUniformMask;
+		newMaterialId.mConstantsBuffer = nullptr;
+		newMaterialId.mTableIndexBuffer = nullptr;
+		newMaterialId.mResidency = mResidency.Add();
+		newMaterialId.mInputData = data;
+		mMaterialIdByResidency.push_back(id);
+		return id;
+	}
+
 	size_t MaterialManager::AddMaterial(const InputData& data, MaterialData* material) {
 		const size_t id = Utils::Hash(data.mName.c_str());
 		BRE_ASSERT(mMaterialDataIdById.find(id) == mMaterialDataIdById.end());		
 		MaterialDataId& newMaterialId = mMaterialDataIdById[id];
-		newMaterialId.mNormal = ShaderResourcesManager::gInstance->AddTextureFromFileSRV(data.mNormalTexturePath.c_str(), (material) ? &material->mNormalSRV : nullptr);
-		newMaterialId.mBaseColor = ShaderResourcesManager::gInstance->AddTextureFromFileSRV(data.mBaseColorTexturePath.c_str(), (material) ? &material->mBaseColorSRV : nullptr);
-		newMaterialId.mSmoothness = ShaderResourcesManager::gInstance->AddTextureFromFileSRV(data.mSmoothnessTexturePath.c_str(), (material) ? &material->mSmoothnessSRV : nullptr);
-		newMaterialId.mMetalMask = ShaderResourcesManager::gInstance->AddTextureFromFileSRV(data.mMetalMaskTexturePath.c_str(), (material) ? &material->mMetalMaskSRV : nullptr);
-		newMaterialId.mCurvature = ShaderResourcesManager::gInstance->AddTextureFromFileSRV(data.mCurvatureTexturePath.c_str(), (material) ? &material->mCurvatureSRV : nullptr);
+		newMaterialId.mPacked = IsPacked(data);
+		BRE_ASSERT(newMaterialId.mPacked || data.mUniformMask == 0U);
+		newMaterialId.mSampler = data.mSampler;
+		newMaterialId.mUniformMask = data.mUniformMask;
+		newMaterialId.mConstantsBuffer = nullptr;
+		newMaterialId.mTableIndexBuffer = nullptr;
+		newMaterialId.mResidency = mResidency.AddResident();
+		mMaterialIdByResidency.push_back(id);
+		LoadTextures(data, newMaterialId, material);
+		AddToTable(data, newMaterialId);
+		if (material) {
+			BRE_ASSERT(GlobalResources::gInstance);
+			material->mSampler = GlobalResources::gInstance->Sampler(data.mSampler);
+			material->mTableIndexBuffer = newMaterialId.mTableIndexBuffer;
+			material->mResident = true;
+		}
 		return id;
 	}
 
 	void MaterialManager::GetMaterial(const size_t id, MaterialManager::MaterialData& material) const {
 		auto findIt = mMaterialDataIdById.find(id);
 		BRE_ASSERT(findIt != mMaterialDataIdById.end());
-		material.mNormalSRV = ShaderResourcesManager::gInstance->ShaderResourceView(findIt->second.mNormal);
+		BRE_ASSERT(GlobalResources::gInstance);
+		material.mSampler = GlobalResources::gInstance->Sampler(findIt->second.mSampler);
+		BRE_ASSERT(material.mSampler);
+		material.mResident = mResidency.IsResident(findIt->second.mResidency);
+		if (!material.mResident) {
+			// Placeholders are packed, whatever the material is
+			material.mNormalSRV = GlobalResources::gInstance->PlaceholderNormalSRV();
+			material.mBaseColorSRV = GlobalResources::gInstance->PlaceholderBaseColorSRV();
+			material.mSmoothnessSRV = nullptr;
+			material.mMetalMaskSRV = nullptr;
+			material.mCurvatureSRV = nullptr;
+			material.mSmoothnessMetalMaskCurvatureSRV = GlobalResources::gInstance->PlaceholderSmoothnessMetalMaskCurvatureSRV();
+			material.mUniformMask = 0U;
+			material.mConstantsBuffer = nullptr;
+			material.mTableIndexBuffer = nullptr;
+			return;
+		}
+
+		const unsigned int uniformMask = findIt->second.mUniformMask;
+		material.mUniformMask = uniformMask;
+		material.mConstantsBuffer = findIt->second.mConstantsBuffer;
+		BRE_ASSERT(uniformMask == 0U || material.mConstantsBuffer);
+		material.mTableIndexBuffer = findIt->second.mTableIndexBuffer;
+		material.mNormalSRV = TextureView(findIt->second.mNormal);
 		BRE_ASSERT(material.mNormalSRV);
-		material.mBaseColorSRV = ShaderResourcesManager::gInstance->ShaderResourceView(findIt->second.mBaseColor);
-		BRE_ASSERT(material.mBaseColorSRV);
-		material.mSmoothnessSRV = ShaderResourcesManager::gInstance->ShaderResourceView(findIt->second.mSmoothness);
-		BRE_ASSERT(material.mSmoothnessSRV);
-		material.mMetalMaskSRV = ShaderResourcesManager::gInstance->ShaderResourceView(findIt->second.mMetalMask);
-		BRE_ASSERT(material.mMetalMaskSRV);
-		material.mCurvatureSRV = ShaderResourcesManager::gInstance->ShaderResourceView(findIt->second.mCurvature);
-		BRE_ASSERT(material.mCurvatureSRV);
+		if ((uniformMask & sUniformBaseColor) != 0U) {
+			material.mBaseColorSRV = nullptr;
+		}
+		else {
+			material.mBaseColorSRV = TextureView(findIt->second.mBaseColor);
+			BRE_ASSERT(material.mBaseColorSRV);
+		}
+		if (findIt->second.mPacked) {
+			material.mSmoothnessSRV = nullptr;
+			material.mMetalMaskSRV = nullptr;
+			material.mCurvatureSRV = nullptr;
+			if ((uniformMask & sUniformSmoothnessMetalMaskCurvature) != 0U) {
+				material.mSmoothnessMetalMaskCurvatureSRV = nullptr;
+			}
+			else {
+				material.mSmoothnessMetalMaskCurvatureSRV = TextureView(findIt->second.mSmoothnessMetalMaskCurvature);
+				BRE_ASSERT(material.mSmoothnessMetalMaskCurvatureSRV);
+			}
+		}
+		else {
+			material.mSmoothnessSRV = TextureView(findIt->second.mSmoothness);
+			BRE_ASSERT(material.mSmoothnessSRV);
+			material.mMetalMaskSRV = TextureView(findIt->second.mMetalMask);
+			BRE_ASSERT(material.mMetalMaskSRV);
+			material.mCurvatureSRV = TextureView(findIt->second.mCurvature);
+			BRE_ASSERT(material.mCurvatureSRV);
+			material.mSmoothnessMetalMaskCurvatureSRV = nullptr;
+		}
+	}
+
+	void MaterialManager::RequestResidency(const size_t id) {
+		auto findIt = mMaterialDataIdById.find(id);
+		BRE_ASSERT(findIt != mMaterialDataIdById.end());
+		mResidency.Request(findIt->second.mResidency);
+	}
+
+	void MaterialManager::Update() {
+		BRE_PROFILE_SCOPE("MaterialManager::Update");
+		mResidency.Update(mLoads);
+		for (const size_t entry : mLoads) {
+			auto findIt = mMaterialDataIdById.find(mMaterialIdByResidency[entry]);
+			BRE_ASSERT(findIt != mMaterialDataIdById.end());
+			MaterialDataId& materialId = findIt->second;
+			LoadTextures(materialId.mInputData, materialId, nullptr);
+			AddToTable(materialId.mInputData, materialId);
+			// Paths are not needed anymore
+			materialId.mInputData = InputData();
+			mResidency.OnLoaded(entry, true);
+		}
+		if (!mLoads.empty()) {
+			++mResidencyVersion;
+		}
+	}
+
+	bool MaterialManager::IsStreaming() const {
+		return TextureStreamer::gInstance != nullptr;
+	}
+
+	unsigned int MaterialManager::TextureViewsVersion() const {
+		// Both only increase, so their sum changes when any of them does
+		return mResidencyVersion + (TextureStreamer::gInstance ? TextureStreamer::gInstance->ViewsVersion() : 0U);
+	}
+
+	void MaterialManager::RequestDetail(const size_t id, const float screenFraction) const {
+		if (!TextureStreamer::gInstance || screenFraction <= 0.0f) {
+			return;
+		}
+
+		auto findIt = mMaterialDataIdById.find(id);
+		BRE_ASSERT(findIt != mMaterialDataIdById.end());
+		const MaterialDataId& materialId = findIt->second;
+		if (!mResidency.IsResident(materialId.mResidency)) {
+			return;
+		}
+		auto request = [screenFraction](const TextureId& textureId) {
+			if (textureId.mStreamed) {
+				TextureStreamer::gInstance->Request(textureId.mId, screenFraction);
+			}
+		};
+		request(materialId.mNormal);
+		request(materialId.mBaseColor);
+		if (materialId.mPacked) {
+			request(materialId.mSmoothnessMetalMaskCurvature);
+		}
+		else {
+			request(materialId.mSmoothness);
+			request(materialId.mMetalMask);
+			request(materialId.mCurvature);
+		}
+	}
+
+	void MaterialManager::LoadTextures(const InputData& data, MaterialDataId& materialId, MaterialData* material) {
+		// Uniform textures are not loaded
+		const TextureId uniformTextureId = { 0U, false };
+		materialId.mNormal = AddTexture(data.mNormalTexturePath, false, (material) ? &material->mNormalSRV : nullptr);
+		// Base color is sRGB encoded (light passes convert it to linear)
+		if ((data.mUniformMask & sUniformBaseColor) != 0U) {
+			materialId.mBaseColor = uniformTextureId;
+			if (material) {
+				material->mBaseColorSRV = nullptr;
+			}
+		}
+		else {
+			materialId.mBaseColor = AddTexture(data.mBaseColorTexturePath, true, (material) ? &material->mBaseColorSRV : nullptr);
+		}
+		if (materialId.mPacked) {
+			if ((data.mUniformMask & sUniformSmoothnessMetalMaskCurvature) != 0U) {
+				materialId.mSmoothnessMetalMaskCurvature = uniformTextureId;
+				if (material) {
+					material->mSmoothnessMetalMaskCurvatureSRV = nullptr;
+				}
+			}
+			else {
+				materialId.mSmoothnessMetalMaskCurvature = AddTexture(data.mSmoothnessMetalMaskCurvatureTexturePath, false, (material) ? &material->mSmoothnessMetalMaskCurvatureSRV : nullptr);
+			}
+			if (material) {
+				material->mSmoothnessSRV = nullptr;
+				material->mMetalMaskSRV = nullptr;
+				material->mCurvatureSRV = nullptr;
+			}
+		}
+		else {
+			materialId.mSmoothness = AddTexture(data.mSmoothnessTexturePath, false, (material) ? &material->mSmoothnessSRV : nullptr);
+			materialId.mMetalMask = AddTexture(data.mMetalMaskTexturePath, false, (material) ? &material->mMetalMaskSRV : nullptr);
+			materialId.mCurvature = AddTexture(data.mCurvatureTexturePath, false, (material) ? &material->mCurvatureSRV : nullptr);
+			if (material) {
+				material->mSmoothnessMetalMaskCurvatureSRV = nullptr;
+			}
+		}
+
+		if (data.mUniformMask != 0U) {
+			MaterialConstants constants = {};
+			for (size_t i = 0U; i < 3U; ++i) {
+				constants.mBaseColor[i] = (data.mUniformMask & sUniformBaseColor) != 0U ? data.mBaseColorValue[i] : 0.0f;
+				constants.mSmoothnessMetalMaskCurvature[i] = (data.mUniformMask & sUniformSmoothnessMetalMaskCurvature) != 0U ? data.mSmoothnessMetalMaskCurvatureValue[i] : 0.0f;
+			}
+			D3D11_BUFFER_DESC desc;
+			ZeroMemory(&desc, sizeof(desc));
+			desc.ByteWidth = sizeof(constants);
+			desc.Usage = D3D11_USAGE_IMMUTABLE;
+			desc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
+			D3D11_SUBRESOURCE_DATA initData;
+			ZeroMemory(&initData, sizeof(initData));
+			initData.pSysMem = &constants;
+			const std::string bufferId = data.mName + "_materialConstants";
+			ShaderResourcesManager::gInstance->AddBuffer(bufferId.c_str(), desc, &initData, &materialId.mConstantsBuffer);
+		}
+		if (material) {
+			material->mUniformMask = data.mUniformMask;
+			material->mConstantsBuffer = materialId.mConstantsBuffer;
+		}
+	}
+
+	void MaterialManager::AddToTable(const InputData& data, MaterialDataId& materialId) {
+		// Streamed textures change, so they cannot be copied into the table
+		if (!MaterialTable::gInstance || TextureStreamer::gInstance || !materialId.mPacked) {
+			return;
+		}
+		MaterialTable::Material material;
+		material.mNormalSRV = TextureView(materialId.mNormal);
+		material.mUniformMask = data.mUniformMask;
+		if ((data.mUniformMask & sUniformBaseColor) != 0U) {
+			material.mBaseColorSRV = nullptr;
+			std::copy(data.mBaseColorValue, data.mBaseColorValue + 3U, material.mBaseColorValue);
+		}
+		else {
+			material.mBaseColorSRV = TextureView(materialId.mBaseColor);
+		}
+		if ((data.mUniformMask & sUniformSmoothnessMetalMaskCurvature) != 0U) {
+			material.mSmoothnessMetalMaskCurvatureSRV = nullptr;
+			std::copy(data.mSmoothnessMetalMaskCurvatureValue, data.mSmoothnessMetalMaskCurvatureValue + 3U, material.mSmoothnessMetalMaskCurvatureValue);
+		}
+		else {
+			material.mSmoothnessMetalMaskCurvatureSRV = TextureView(materialId.mSmoothnessMetalMaskCurvature);
+		}
+		materialId.mTableIndexBuffer = MaterialTable::gInstance->AddMaterial(material);
+	}
+
+	MaterialManager::TextureId MaterialManager::AddTexture(const std::string& filepath, const bool sRGBContent, ID3D11ShaderResourceView* *view) {
+		// Textures that cannot be streamed (streamingError tells why) are loaded whole
+		TextureId textureId;
+		std::string streamingError;
+		textureId.mStreamed = TextureStreamer::gInstance && TextureStreamer::gInstance->AddTexture(filepath.c_str(), textureId.mId, streamingError);
+		if (textureId.mStreamed) {
+			if (view) {
+				*view = TextureStreamer::gInstance->ShaderResourceView(textureId.mId);
+			}
+		}
+		else {
+			textureId.mId = ShaderResourcesManager::gInstance->AddTextureFromFileSRV(filepath.c_str(), view, false, sRGBContent);
+		}
+		return textureId;
+	}
+
+	ID3D11ShaderResourceView* MaterialManager::TextureView(const TextureId& id) {
+		return id.mStreamed ? TextureStreamer::gInstance->ShaderResourceView(id.mId) : ShaderResourcesManager::gInstance->ShaderResourceView(id.mId);
 	}
 }
\ No newline at end of file
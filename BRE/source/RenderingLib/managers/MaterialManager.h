@@ -2,7 +2,13 @@
 
 #include <string>
 #include <unordered_map>
+#include <vector>
 
+#include <rendering/GlobalResources.h>
+#include <streaming/ResidencyTracker.h>
+
+struct ID3D11Buffer;
+struct ID3D11SamplerState;
 struct ID3D11ShaderResourceView;
 
 namespace BRE {
@@ -10,6 +16,24 @@ namespace BRE {
 	public:
 		static MaterialManager* gInstance;
 
+		explicit MaterialManager(const unsigned int maxLoadsPerFrame = 2U)
+			: mResidency(maxLoadsPerFrame)
+		{
+		}
+
+		const MaterialManager& operator=(const MaterialManager& rhs) = delete;
+
+		// Uniform mask bits. Packed pixel shaders have a permutation for each mask.
+		static const unsigned int sUniformBaseColor = 1U;
+		static const unsigned int sUniformSmoothnessMetalMaskCurvature = 2U;
+		static const unsigned int sNumUniformPermutations = 4U;
+
+		// Material constant table (b0 of packed pixel shaders, see MaterialConstants.hlsli)
+		struct MaterialConstants {
+			float mBaseColor[4];
+			float mSmoothnessMetalMaskCurvature[4];
+		};
+
 		struct InputData {
 			std::string mName;
 			std::string mNormalTexturePath;
@@ -17,6 +41,17 @@ namespace BRE {
 			std::string mSmoothnessTexturePath;
 			std::string mMetalMaskTexturePath;
 			std::string mCurvatureTexturePath;
+			// Cooked materials (ContentTools cookMaterials) pack smoothness, metal mask
+			// and curvature in R, G and B. When it is not empty, the three paths above are ignored.
+			std::string mSmoothnessMetalMaskCurvatureTexturePath;
+			// "sampler" entry: Point, Trilinear (default) or Anisotropic
+			SamplerFilter mSampler = SamplerFilter::Trilinear;
+			// Uniform textures replaced by constants (baseColorValue and
+			// smoothnessMetalMaskCurvatureValue entries, see MaterialCooker).
+			// Their paths are empty. Only packed materials have them.
+			unsigned int mUniformMask = 0U;
+			float mBaseColorValue[3];
+			float mSmoothnessMetalMaskCurvatureValue[3];
 		};
 
 		struct MaterialData {
@@ -25,23 +60,83 @@ namespace BRE {
 			ID3D11ShaderResourceView* mSmoothnessSRV;
 			ID3D11ShaderResourceView* mMetalMaskSRV;
 			ID3D11ShaderResourceView* mCurvatureSRV;
+			// Not null for packed materials (unless it is uniform). In that case, the three SRVs above are null.
+			ID3D11ShaderResourceView* mSmoothnessMetalMaskCurvatureSRV;
+			ID3D11SamplerState* mSampler;
+			// Textures of the mask have null SRVs. Their values are in mConstantsBuffer
+			// (null if the mask is 0).
+			unsigned int mUniformMask;
+			ID3D11Buffer* mConstantsBuffer;
+			// Record index of the material in MaterialTable (b0 of table pixel shaders).
+			// Null if the material is not in the table: its textures must be bound.
+			ID3D11Buffer* mTableIndexBuffer;
+			// False while placeholder textures are used instead of the material ones
+			bool mResident;
 		};
 
+		// Materials of the file are only registered. Their textures are loaded
+		// after their first RequestResidency().
 		void LoadMaterials(const char* materialFile);
+		size_t RegisterMaterial(const InputData& data);
+		// Loads textures right away
 		size_t AddMaterial(const InputData& data, MaterialData* material = nullptr);
 		void GetMaterial(const size_t id, MaterialData& material) const;
 
+		// Drawers call it when they use a material that is not resident yet
+		void RequestResidency(const size_t id);
+		// Once per frame, before drawing. Loads some requested materials.
+		void Update();
+		size_t NumMaterials() const { return mMaterialDataIdById.size(); }
+		size_t NumResidentMaterials() const { return mResidency.NumResident(); }
+
+		// Textures are streamed when TextureStreamer::gInstance exists. Their views
+		// change with resident levels and materials residency, so materials must
+		// be got again when TextureViewsVersion() changes.
+		bool IsStreaming() const;
+		unsigned int TextureViewsVersion() const;
+		// screenFraction is the fraction of the screen height covered by one texture
+		// repeat of the material this frame. Nothing is requested if it is not positive.
+		void RequestDetail(const size_t id, const float screenFraction) const;
+
 	private:
+		struct TextureId {
+			size_t mId;
+			// mId is a TextureStreamer id instead of a ShaderResourcesManager one
+			bool mStreamed;
+		};
+
 		struct MaterialDataId {
-			size_t mNormal;
-			size_t mBaseColor;
-			size_t mSmoothness;
-			size_t mMetalMask;
-			size_t mCurvature;
+			TextureId mNormal;
+			TextureId mBaseColor;
+			TextureId mSmoothness;
+			TextureId mMetalMask;
+			TextureId mCurvature;
+			TextureId mSmoothnessMetalMaskCurvature;
+			bool mPacked;
+			SamplerFilter mSampler;
+			unsigned int mUniformMask;
+			ID3D11Buffer* mConstantsBuffer;
+			ID3D11Buffer* mTableIndexBuffer;
+			// ResidencyTracker entry
+			size_t mResidency;
+			// Texture paths, until textures are loaded
+			InputData mInputData;
 		};
+
+		static void LoadTextures(const InputData& data, MaterialDataId& materialId, MaterialData* material);
+		// Adds resident packed materials to MaterialTable (if it exists)
+		static void AddToTable(const InputData& data, MaterialDataId& materialId);
+		static TextureId AddTexture(const std::string& filepath, const bool sRGBContent, ID3D11ShaderResourceView* *view);
+		static ID3D11ShaderResourceView* TextureView(const TextureId& id);
 		
 		typedef std::unordered_map<size_t, MaterialDataId> MaterialDataIdById;
 		MaterialDataIdById mMaterialDataIdById;
 
+		ResidencyTracker mResidency;
+		// Material id of each residency entry
+		std::vector<size_t> mMaterialIdByResidency;
+		std::vector<size_t> mLoads;
+		// Incremented each time materials become resident
+		unsigned int mResidencyVersion = 0U;
 	};
 }
@@ -0,0 +1,221 @@
+#include "MaterialTable.h"
+
+#include <algorithm>
+#include <d3d11_1.h>
+
+#include <general/CountedContext.h>
+#include <managers/MaterialManager.h>
+#include <utils/Assert.h>
+
+namespace {
+	const unsigned int sInitialPoolCapacity = 4U;
+	const size_t sInitialRecordsCapacity = 64U;
+}
+
+namespace BRE {
+	MaterialTable* MaterialTable::gInstance = nullptr;
+
+	MaterialTable::MaterialTable(ID3D11Device1& device, ID3D11DeviceContext1& context)
+		: mDevice(device)
+		, mContext(context)
+		, mPacker(sMaxPools, sInitialPoolCapacity, D3D11_REQ_TEXTURE2D_ARRAY_AXIS_DIMENSION)
+	{
+	}
+
+	MaterialTable::~MaterialTable() {
+		for (Pool& pool : mPools) {
+			pool.mSRV->Release();
+			pool.mTexture->Release();
+		}
+		for (ID3D11Buffer* buffer : mIndexBuffers) {
+			buffer->Release();
+		}
+		if (mRecordsBuffer) {
+			mRecordsSRV->Release();
+			mRecordsBuffer->Release();
+		}
+	}
+
+	ID3D11Buffer* MaterialTable::AddMaterial(const Material& material) {
+		BRE_ASSERT(material.mNormalSRV);
+		Record record;
+		ZeroMemory(&record, sizeof(record));
+		TextureArrayPacker::Slot slot;
+		if (!AddTexture(*material.mNormalSRV, slot)) {
+			return nullptr;
+		}
+		record.mNormalPool = slot.mPool;
+		record.mNormalSlice = slot.mSlice;
+		if ((material.mUniformMask & MaterialManager::sUniformBaseColor) != 0U) {
+			std::copy(material.mBaseColorValue, material.mBaseColorValue + 3U, record.mBaseColorValue);
+		}
+		else {
+			BRE_ASSERT(material.mBaseColorSRV);
+			if (!AddTexture(*material.mBaseColorSRV, slot)) {
+				return nullptr;
+			}
+			record.mBaseColorPool = slot.mPool;
+			record.mBaseColorSlice = slot.mSlice;
+		}
+		if ((material.mUniformMask & MaterialManager::sUniformSmoothnessMetalMaskCurvature) != 0U) {
+			std::copy(material.mSmoothnessMetalMaskCurvatureValue, material.mSmoothnessMetalMaskCurvatureValue + 3U, record.mSmoothnessMetalMaskCurvatureValue);
+		}
+		else {
+			BRE_ASSERT(material.mSmoothnessMetalMaskCurvatureSRV);
+			if (!AddTexture(*material.mSmoothnessMetalMaskCurvatureSRV, slot)) {
+				return nullptr;
+			}
+			record.mSmoothnessMetalMaskCurvaturePool = slot.mPool;
+			record.mSmoothnessMetalMaskCurvatureSlice = slot.mSlice;
+		}
+		record.mUniformMask = material.mUniformMask;
+
+		const size_t index = mRecords.size();
+		mRecords.push_back(record);
+		UploadRecord(index);
+
+		const unsigned int indexData[4] = { static_cast<unsigned int>(index), 0U, 0U, 0U };
+		D3D11_BUFFER_DESC desc;
+		ZeroMemory(&desc, sizeof(desc));
+		desc.ByteWidth = sizeof(indexData);
+		desc.Usage = D3D11_USAGE_IMMUTABLE;
+		desc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
+		D3D11_SUBRESOURCE_DATA initData;
+		ZeroMemory(&initData, sizeof(initData));
+		initData.pSysMem = indexData;
+		ID3D11Buffer* indexBuffer;
+		ASSERT_HR(mDevice.CreateBuffer(&desc, &initData, &indexBuffer));
+		mIndexBuffers.push_back(indexBuffer);
+		return indexBuffer;
+	}
+
+	void MaterialTable::Bind(ID3D11DeviceContext1& context) {
+		ID3D11ShaderResourceView* srvs[sMaxPools + 1U];
+		for (size_t i = 0U; i < sMaxPools; ++i) {
+			srvs[i] = i < mPools.size() ? mPools[i].mSRV : nullptr;
+		}
+		srvs[sMaxPools] = mRecordsSRV;
+		CountedContext::PSSetShaderResources(context, sFirstSlot, ARRAYSIZE(srvs), srvs);
+	}
+
+	void MaterialTable::Unbind(ID3D11DeviceContext1& context) {
+		ID3D11ShaderResourceView* srvs[sMaxPools + 1U];
+		ZeroMemory(srvs, sizeof(srvs));
+		context.PSSetShaderResources(sFirstSlot, ARRAYSIZE(srvs), srvs);
+	}
+
+	bool MaterialTable::AddTexture(ID3D11ShaderResourceView& view, TextureArrayPacker::Slot& slot) {
+		SlotByView::const_iterator findIt = mSlotByView.find(&view);
+		if (findIt != mSlotByView.end()) {
+			slot = findIt->second;
+			return true;
+		}
+
+		ID3D11Resource* resource;
+		view.GetResource(&resource);
+		D3D11_RESOURCE_DIMENSION dimension;
+		resource->GetType(&dimension);
+		if (dimension != D3D11_RESOURCE_DIMENSION_TEXTURE2D) {
+			resource->Release();
+			return false;
+		}
+		ID3D11Texture2D* texture = static_cast<ID3D11Texture2D*>(resource);
+		D3D11_TEXTURE2D_DESC desc;
+		texture->GetDesc(&desc);
+		const TextureArrayPacker::Key key = { desc.Width, desc.Height, desc.MipLevels, static_cast<unsigned int>(desc.Format) };
+		if (desc.ArraySize != 1U || !mPacker.Allocate(key, slot)) {
+			texture->Release();
+			return false;
+		}
+
+		const unsigned int capacity = mPacker.PoolCapacity(slot.mPool);
+		if (slot.mPool == mPools.size()) {
+			Pool pool;
+			CreatePool(key, capacity, pool);
+			mPools.push_back(pool);
+		}
+		else if (capacity != mPools[slot.mPool].mCapacity) {
+			// Full pool, slices are copied to a larger one
+			Pool& oldPool = mPools[slot.mPool];
+			Pool pool;
+			CreatePool(key, capacity, pool);
+			for (unsigned int slice = 0U; slice < oldPool.mCapacity; ++slice) {
+				for (unsigned int mip = 0U; mip < key.mNumMips; ++mip) {
+					mContext.CopySubresourceRegion(pool.mTexture, D3D11CalcSubresource(mip, slice, key.mNumMips), 0U, 0U, 0U, oldPool.mTexture, D3D11CalcSubresource(mip, slice, key.mNumMips), nullptr);
+				}
+			}
+			oldPool.mSRV->Release();
+			oldPool.mTexture->Release();
+			oldPool = pool;
+		}
+
+		Pool& pool = mPools[slot.mPool];
+		for (unsigned int mip = 0U; mip < key.mNumMips; ++mip) {
+			mContext.CopySubresourceRegion(pool.mTexture, D3D11CalcSubresource(mip, slot.mSlice, key.mNumMips), 0U, 0U, 0U, texture, D3D11CalcSubresource(mip, 0U, key.mNumMips), nullptr);
+		}
+		texture->Release();
+		mSlotByView[&view] = slot;
+		return true;
+	}
+
+	void MaterialTable::CreatePool(const TextureArrayPacker::Key& key, const unsigned int capacity, Pool& pool) {
+		D3D11_TEXTURE2D_DESC desc;
+		ZeroMemory(&desc, sizeof(desc));
+		desc.Width = key.mWidth;
+		desc.Height = key.mHeight;
+		desc.MipLevels = key.mNumMips;
+		desc.ArraySize = capacity;
+		desc.Format = static_cast<DXGI_FORMAT>(key.mFormat);
+		desc.SampleDesc.Count = 1U;
+		desc.Usage = D3D11_USAGE_DEFAULT;
+		desc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+		ASSERT_HR(mDevice.CreateTexture2D(&desc, nullptr, &pool.mTexture));
+		ASSERT_HR(mDevice.CreateShaderResourceView(pool.mTexture, nullptr, &pool.mSRV));
+		pool.mCapacity = capacity;
+	}
+
+	void MaterialTable::UploadRecord(const size_t index) {
+		BRE_ASSERT(index < mRecords.size());
+		if (mRecords.size() > mRecordsCapacity) {
+			// The buffer is recreated with every record
+			mRecordsCapacity = (std::max)(sInitialRecordsCapacity, mRecordsCapacity * 2U);
+			std::vector<Record> data(mRecords);
+			data.resize(mRecordsCapacity);
+
+			D3D11_BUFFER_DESC desc;
+			ZeroMemory(&desc, sizeof(desc));
+			desc.ByteWidth = static_cast<unsigned int>(sizeof(Record) * mRecordsCapacity);
+			desc.Usage = D3D11_USAGE_DEFAULT;
+			desc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+			desc.MiscFlags = D3D11_RESOURCE_MISC_BUFFER_STRUCTURED;
+			desc.StructureByteStride = sizeof(Record);
+			D3D11_SUBRESOURCE_DATA initData;
+			ZeroMemory(&initData, sizeof(initData));
+			initData.pSysMem = data.data();
+			if (mRecordsBuffer) {
+				mRecordsSRV->Release();
+				mRecordsBuffer->Release();
+			}
+			ASSERT_HR(mDevice.CreateBuffer(&desc, &initData, &mRecordsBuffer));
+
+			D3D11_SHADER_RESOURCE_VIEW_DESC viewDesc;
+			ZeroMemory(&viewDesc, sizeof(viewDesc));
+			viewDesc.Format = DXGI_FORMAT_UNKNOWN;
+			viewDesc.ViewDimension = D3D11_SRV_DIMENSION_BUFFER;
+			viewDesc.Buffer.FirstElement = 0U;
+			viewDesc.Buffer.NumElements = static_cast<unsigned int>(mRecordsCapacity);
+			ASSERT_HR(mDevice.CreateShaderResourceView(mRecordsBuffer, &viewDesc, &mRecordsSRV));
+			return;
+		}
+
+		D3D11_BOX box;
+		box.left = static_cast<unsigned int>(sizeof(Record) * index);
+		box.right = box.left + sizeof(Record);
+		box.top = 0U;
+		box.bottom = 1U;
+		box.front = 0U;
+		box.back = 1U;
+		mContext.UpdateSubresource(mRecordsBuffer, 0U, &box, &mRecords[index], 0U, 0U);
+		BRE_COUNTER_ADD(RenderCounter::UploadBytes, sizeof(Record));
+	}
+}
\ No newline at end of file
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+
+#include <utils/TextureArrayPacker.h>
+
+struct ID3D11Buffer;
+struct ID3D11Device1;
+struct ID3D11DeviceContext1;
+struct ID3D11ShaderResourceView;
+struct ID3D11Texture2D;
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Material textures copied into Texture2DArray pools (see
+// TextureArrayPacker) and a structured buffer of material records (pool
+// and slice of each texture and uniform values). Bind() binds all of them
+// once for the whole geometry pass, so pixel shaders select their material
+// with a record index (b0 of table pixel shaders) instead of binding its
+// textures in each draw.
+// Only packed materials are added. Textures must not change after they
+// are added, so it is not used with texture streaming.
+//
+//////////////////////////////////////////////////////////////////////////
+
+namespace BRE {
+	class MaterialTable {
+	public:
+		static MaterialTable* gInstance;
+
+		// Pools declared by MaterialTable.hlsli
+		static const unsigned int sMaxPools = 8U;
+		// Pools are bound from this slot, records after them
+		static const unsigned int sFirstSlot = 8U;
+
+		struct Material {
+			// Textures of uniformMask (see MaterialManager) are null
+			ID3D11ShaderResourceView* mNormalSRV;
+			ID3D11ShaderResourceView* mBaseColorSRV;
+			ID3D11ShaderResourceView* mSmoothnessMetalMaskCurvatureSRV;
+			unsigned int mUniformMask;
+			float mBaseColorValue[3];
+			float mSmoothnessMetalMaskCurvatureValue[3];
+		};
+
+		MaterialTable(ID3D11Device1& device, ID3D11DeviceContext1& context);
+		~MaterialTable();
+
+		const MaterialTable& operator=(const MaterialTable& rhs) = delete;
+
+		// Returns the constant buffer with the record index of the material or
+		// null if its textures do not fit in the pools (it must be bound as usual).
+		ID3D11Buffer* AddMaterial(const Material& material);
+
+		void Bind(ID3D11DeviceContext1& context);
+		void Unbind(ID3D11DeviceContext1& context);
+
+		size_t NumRecords() const { return mRecords.size(); }
+
+	private:
+		// Same layout as MaterialRecord in MaterialTable.hlsli
+		struct Record {
+			unsigned int mNormalPool;
+			unsigned int mNormalSlice;
+			unsigned int mBaseColorPool;
+			unsigned int mBaseColorSlice;
+			unsigned int mSmoothnessMetalMaskCurvaturePool;
+			unsigned int mSmoothnessMetalMaskCurvatureSlice;
+			unsigned int mUniformMask;
+			unsigned int mPadding;
+			float mBaseColorValue[4];
+			float mSmoothnessMetalMaskCurvatureValue[4];
+		};
+
+		struct Pool {
+			ID3D11Texture2D* mTexture;
+			ID3D11ShaderResourceView* mSRV;
+			unsigned int mCapacity;
+		};
+
+		// Copies the texture of view into a pool slice (once per texture)
+		bool AddTexture(ID3D11ShaderResourceView& view, TextureArrayPacker::Slot& slot);
+		void CreatePool(const TextureArrayPacker::Key& key, const unsigned int capacity, Pool& pool);
+		void UploadRecord(const size_t index);
+
+		ID3D11Device1& mDevice;
+		ID3D11DeviceContext1& mContext;
+
+		TextureArrayPacker mPacker;
+		std::vector<Pool> mPools;
+		typedef std::unordered_map<ID3D11ShaderResourceView*, TextureArrayPacker::Slot> SlotByView;
+		SlotByView mSlotByView;
+
+		std::vector<Record> mRecords;
+		ID3D11Buffer* mRecordsBuffer = nullptr;
+		ID3D11ShaderResourceView* mRecordsSRV = nullptr;
+		size_t mRecordsCapacity = 0U;
+		// Record index constant buffers, one per record
+		std::vector<ID3D11Buffer*> mIndexBuffers;
+	};
+}
\ No newline at end of file
@@ -8,29 +8,20 @@ namespace BRE {
 	ModelManager* ModelManager::gInstance = nullptr;
 
 	ModelManager::~ModelManager() {
-		for (auto elem : mModelById) {
-			delete elem.second;
-		}
+		mModelById.ForEach([](const size_t, Model* elem) { delete elem; });
 	}
 
 	size_t ModelManager::LoadModel(const char* modelPath, const Model* *model) {
 		BRE_ASSERT(modelPath);
 		const size_t id = Utils::Hash(modelPath);
-		ModelById::const_iterator it = mModelById.find(id);
-		if (it == mModelById.end()) {
-			Model* elem = new Model(modelPath);
-			if (model) *model = elem;
-			mModelById[id] = new Model(modelPath);
-		}
-		else {
-			if (model) *model = it->second;
-		}
-
+		const Model* elem = mModelById.GetOrCreate(id, [modelPath]() { return new Model(modelPath); });
+		if (model) *model = elem;
 		return id;
 	}
 
-	const Model* ModelManager::GetModel(const size_t id) {
-		ModelById::const_iterator it = mModelById.find(id);
-		return (it != mModelById.end()) ? it->second : nullptr;
+	const Model* ModelManager::GetModel(const size_t id) const {
+		Model* elem = nullptr;
+		mModelById.Find(id, elem);
+		return elem;
 	}
 }
\ No newline at end of file
@@ -1,6 +1,6 @@
 #pragma once
 
-#include <unordered_map>
+#include <utils/ConcurrentRegistry.h>
 
 namespace BRE {
 	class Model;
@@ -13,12 +13,12 @@ namespace BRE {
 		ModelManager(const ModelManager&) = delete;
 		const ModelManager& operator=(const ModelManager&) = delete;
 
+		// It can be called from any thread. Concurrent requests of the same model load it once.
 		size_t LoadModel(const char* modelPath, const Model* *model = nullptr);
-		const Model* GetModel(const size_t id);
+		const Model* GetModel(const size_t id) const;
 
 	private:
-		typedef std::unordered_map<size_t, Model*> ModelById;
-		ModelById mModelById;
+		ConcurrentRegistry<Model*> mModelById;
 	};
 
 
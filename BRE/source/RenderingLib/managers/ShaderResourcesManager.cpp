@@ -1,67 +1,147 @@
 #include "ShaderResourcesManager.h"
 
+#include <algorithm>
 #include <cassert>
+#include <cstring>
 #include <DDSTextureLoader.h>
 #include <d3d11_1.h>
 #include <fstream>
 #include <vector>
 #include <WICTextureLoader.h>
 
+#include <managers/VirtualFileSystem.h>
 #include <utils/Assert.h>
 #include <utils/Hash.h>
-#include <utils/StringUtils.h>
+#include <utils/MipGenerator.h>
+
+namespace {
+	bool IsRGBA8(const DXGI_FORMAT format) {
+		switch (format) {
+		case DXGI_FORMAT_R8G8B8A8_UNORM:
+		case DXGI_FORMAT_R8G8B8A8_UNORM_SRGB:
+		case DXGI_FORMAT_B8G8R8A8_UNORM:
+		case DXGI_FORMAT_B8G8R8A8_UNORM_SRGB:
+		case DXGI_FORMAT_B8G8R8X8_UNORM:
+		case DXGI_FORMAT_B8G8R8X8_UNORM_SRGB:
+			return true;
+		default:
+			return false;
+		}
+	}
+
+	bool IsSRGB(const DXGI_FORMAT format) {
+		return format == DXGI_FORMAT_R8G8B8A8_UNORM_SRGB || format == DXGI_FORMAT_B8G8R8A8_UNORM_SRGB || format == DXGI_FORMAT_B8G8R8X8_UNORM_SRGB;
+	}
+
+	// Textures without a full mip chain are sampled at their top level when
+	// minified. If the format is 8 bits per channel RGBA/BGRA, the top level
+	// is read back and the texture and its view are replaced by new ones with
+	// a full chain generated on the CPU. Block compressed textures are kept
+	// as they are (ContentTools cooks them with full chains).
+	void CompleteMipChain(ID3D11Device1& device, const bool sRGBContent, ID3D11Resource* &texture, ID3D11ShaderResourceView* &view) {
+		D3D11_RESOURCE_DIMENSION dimension;
+		texture->GetType(&dimension);
+		if (dimension != D3D11_RESOURCE_DIMENSION_TEXTURE2D) {
+			return;
+		}
+
+		ID3D11Texture2D* texture2D = static_cast<ID3D11Texture2D*>(texture);
+		D3D11_TEXTURE2D_DESC desc;
+		texture2D->GetDesc(&desc);
+		const unsigned int numLevels = BRE::MipGenerator::NumLevels(desc.Width, desc.Height);
+		if (desc.MipLevels >= numLevels || desc.ArraySize != 1U || !IsRGBA8(desc.Format)) {
+			return;
+		}
+
+		D3D11_TEXTURE2D_DESC stagingDesc = desc;
+		stagingDesc.MipLevels = 1U;
+		stagingDesc.Usage = D3D11_USAGE_STAGING;
+		stagingDesc.BindFlags = 0U;
+		stagingDesc.CPUAccessFlags = D3D11_CPU_ACCESS_READ;
+		stagingDesc.MiscFlags = 0U;
+		ID3D11Texture2D* staging;
+		ASSERT_HR(device.CreateTexture2D(&stagingDesc, nullptr, &staging));
+
+		ID3D11DeviceContext* context;
+		device.GetImmediateContext(&context);
+		context->CopySubresourceRegion(staging, 0U, 0U, 0U, 0U, texture2D, 0U, nullptr);
+		D3D11_MAPPED_SUBRESOURCE mapped;
+		ASSERT_HR(context->Map(staging, 0U, D3D11_MAP_READ, 0U, &mapped));
+		const size_t rowSize = desc.Width * BRE::MipGenerator::sNumChannels;
+		std::vector<std::uint8_t> topLevel(rowSize * desc.Height);
+		for (unsigned int y = 0U; y < desc.Height; ++y) {
+			memcpy(&topLevel[y * rowSize], static_cast<const std::uint8_t*>(mapped.pData) + y * mapped.RowPitch, rowSize);
+		}
+		context->Unmap(staging, 0U);
+		context->Release();
+		staging->Release();
+
+		// Box filter keeps load times low. ContentTools generateMips can bake Kaiser filtered chains.
+		BRE::MipGenerator::Settings settings;
+		settings.mSRGB = sRGBContent || IsSRGB(desc.Format);
+		std::vector<std::vector<std::uint8_t>> levels;
+		BRE::MipGenerator::Generate(topLevel.data(), desc.Width, desc.Height, settings, levels);
+		BRE_ASSERT(levels.size() == numLevels);
+
+		std::vector<D3D11_SUBRESOURCE_DATA> initialData(levels.size());
+		for (size_t i = 0U; i < levels.size(); ++i) {
+			initialData[i].pSysMem = levels[i].data();
+			initialData[i].SysMemPitch = (std::max)(1U, desc.Width >> i) * BRE::MipGenerator::sNumChannels;
+			initialData[i].SysMemSlicePitch = 0U;
+		}
+		desc.MipLevels = numLevels;
+		ID3D11Texture2D* newTexture;
+		ASSERT_HR(device.CreateTexture2D(&desc, initialData.data(), &newTexture));
+		ID3D11ShaderResourceView* newView;
+		ASSERT_HR(device.CreateShaderResourceView(newTexture, nullptr, &newView));
+
+		view->Release();
+		texture->Release();
+		texture = newTexture;
+		view = newView;
+	}
+}
 
 namespace BRE {
 	ShaderResourcesManager* ShaderResourcesManager::gInstance = nullptr;
 
 	ShaderResourcesManager::~ShaderResourcesManager() {
-		for (auto& elem : mShaderResourceViews) {
-			elem.second->Release();
-		}
-		for (auto& elem : mUnorderedAccessViews) {
-			elem.second->Release();
-		}
-		for (auto& elem : mBuffers) {
-			elem.second->Release();
-		}
-		for (auto& elem : mTextures2D) {
-			elem.second->Release();
-		}
-		for (auto& elem : mRasterizerStates) {
-			elem.second->Release();
-		}
-		for (auto& elem : mRenderTargetViews) {
-			elem.second->Release();
-		}
-		for (auto& elem : mDepthStencilViews) {
-			elem.second->Release();
-		}
-		for (auto& elem : mBlendStates) {
-			elem.second->Release();
-		}
-		for (auto& elem : mDepthStencilStates) {
-			elem.second->Release();
-		}
-		for (auto& elem : mSamplerStates) {
-			elem.second->Release();
-		}
+		mShaderResourceViews.ForEach([](const size_t, ID3D11ShaderResourceView* elem) { elem->Release(); });
+		mUnorderedAccessViews.ForEach([](const size_t, ID3D11UnorderedAccessView* elem) { elem->Release(); });
+		mBuffers.ForEach([](const size_t, ID3D11Buffer* elem) { elem->Release(); });
+		mTextures2D.ForEach([](const size_t, ID3D11Texture2D* elem) { elem->Release(); });
+		mRasterizerStates.ForEach([](const size_t, ID3D11RasterizerState* elem) { elem->Release(); });
+		mRenderTargetViews.ForEach([](const size_t, ID3D11RenderTargetView* elem) { elem->Release(); });
+		mDepthStencilViews.ForEach([](const size_t, ID3D11DepthStencilView* elem) { elem->Release(); });
+		mBlendStates.ForEach([](const size_t, ID3D11BlendState* elem) { elem->Release(); });
+		mDepthStencilStates.ForEach([](const size_t, ID3D11DepthStencilState* elem) { elem->Release(); });
+		mSamplerStates.ForEach([](const size_t, ID3D11SamplerState* elem) { elem->Release(); });
 	}
 
-	size_t ShaderResourcesManager::AddTextureFromFileSRV(const char* filepath, ID3D11ShaderResourceView* *resource, const bool forceSRGB) {
+	size_t ShaderResourcesManager::AddTextureFromFileSRV(const char* filepath, ID3D11ShaderResourceView* *resource, const bool forceSRGB, const bool sRGBContent) {
 		BRE_ASSERT(filepath);
 		const size_t id = Utils::Hash(filepath);
-		ShaderResourceViews::iterator findIt = mShaderResourceViews.find(id);
-		if (findIt != mShaderResourceViews.end()) {
-			if (resource) *resource = findIt->second;
-			return id; 
-		}
+		ID3D11ShaderResourceView* elem = mShaderResourceViews.GetOrCreate(id, [&]() {
+			// Uncompressed pack entries are used in place, other files are read
+			BRE_ASSERT(VirtualFileSystem::gInstance);
+			size_t size = 0U;
+			const std::uint8_t* data = VirtualFileSystem::gInstance->MappedData(filepath, size);
+			std::vector<std::uint8_t> fileData;
+			if (!data) {
+				const bool read = VirtualFileSystem::gInstance->ReadFile(filepath, fileData);
+				BRE_ASSERT(read);
+				data = fileData.data();
+				size = fileData.size();
+			}
 
-		ID3D11Resource* texture;
-		ID3D11ShaderResourceView* elem = nullptr;
-		ASSERT_HR(DirectX::CreateDDSTextureFromFileEx(&mDevice, Utils::ToWideString(filepath).c_str(), 0ui64, D3D11_USAGE_DEFAULT, D3D11_BIND_SHADER_RESOURCE, 0, 0, forceSRGB, &texture, &elem));
-		texture->Release();
+			ID3D11Resource* texture;
+			ID3D11ShaderResourceView* view = nullptr;
+			ASSERT_HR(DirectX::CreateDDSTextureFromMemoryEx(&mDevice, data, size, 0ui64, D3D11_USAGE_DEFAULT, D3D11_BIND_SHADER_RESOURCE, 0, 0, forceSRGB, &texture, &view));
+			CompleteMipChain(mDevice, sRGBContent, texture, view);
+			texture->Release();
+			return view;
+		});
 		BRE_ASSERT(elem);
-		mShaderResourceViews[id] = elem;
 		if (resource) *resource = elem;
 		return id;
 	} 
@@ -69,10 +149,10 @@ namespace BRE {
 	size_t ShaderResourcesManager::AddResourceSRV(const char* id, ID3D11Resource& resource, const D3D11_SHADER_RESOURCE_VIEW_DESC* desc, ID3D11ShaderResourceView* *view) {
 		BRE_ASSERT(id);
 		const size_t idHash = Utils::Hash(id);
-		BRE_ASSERT(mShaderResourceViews.find(idHash) == mShaderResourceViews.end());
 		ID3D11ShaderResourceView* elem;
 		ASSERT_HR(mDevice.CreateShaderResourceView(&resource, desc, &elem));
-		mShaderResourceViews[idHash] = elem;
+		const bool inserted = mShaderResourceViews.Insert(idHash, elem);
+		BRE_ASSERT(inserted);
 		if (view) *view = elem;
 		return idHash;
 	}
@@ -80,10 +160,10 @@ namespace BRE {
 	size_t ShaderResourcesManager::AddResourceUAV(const char* id, ID3D11Resource& resource, const D3D11_UNORDERED_ACCESS_VIEW_DESC& desc, ID3D11UnorderedAccessView* *view) {
 		BRE_ASSERT(id);
 		const size_t idHash = Utils::Hash(id);
-		BRE_ASSERT(mUnorderedAccessViews.find(idHash) == mUnorderedAccessViews.end())
 		ID3D11UnorderedAccessView* elem;
 		ASSERT_HR(mDevice.CreateUnorderedAccessView(&resource, &desc, &elem));
-		mUnorderedAccessViews[idHash] = elem;
+		const bool inserted = mUnorderedAccessViews.Insert(idHash, elem);
+		BRE_ASSERT(inserted);
 		if (view) *view = elem;
 		return idHash;
 	}
@@ -91,18 +171,17 @@ namespace BRE {
 	size_t ShaderResourcesManager::AddBuffer(const char* id, D3D11_BUFFER_DESC& desc, const D3D11_SUBRESOURCE_DATA* const initData, ID3D11Buffer* *buffer) {
 		BRE_ASSERT(id);
 		const size_t idHash = Utils::Hash(id);
-		BRE_ASSERT(mBuffers.find(idHash) == mBuffers.end());
-
 		// If the bind flag is D3D11_BIND_CONSTANT_BUFFER,
 		// you must set the ByteWidth value in multiples of 16,
 		// and less than or equal to D3D11_REQ_CONSTANT_BUFFER_ELEMENT_COUNT.
 		if (desc.BindFlags == D3D11_BIND_CONSTANT_BUFFER) {
 			const size_t baseAlignment = 16;
-			desc.ByteWidth = static_cast<unsigned int>(desc.ByteWidth + (baseAlignment - (desc.ByteWidth % baseAlignment)));
+			desc.ByteWidth = static_cast<unsigned int>((desc.ByteWidth + baseAlignment - 1) / baseAlignment * baseAlignment);
 		}
 		ID3D11Buffer* elem;
 		ASSERT_HR(mDevice.CreateBuffer(&desc, initData, &elem));
-		mBuffers[idHash] = elem;
+		const bool inserted = mBuffers.Insert(idHash, elem);
+		BRE_ASSERT(inserted);
 		if (buffer) *buffer = elem;
 		return idHash;
 	}
@@ -110,10 +189,10 @@ namespace BRE {
 	size_t ShaderResourcesManager::AddTexture2D(const char* id, const D3D11_TEXTURE2D_DESC& texDesc, const D3D11_SUBRESOURCE_DATA* initialData, ID3D11Texture2D* *texture) {
 		BRE_ASSERT(id);
 		const size_t idHash = Utils::Hash(id);
-		BRE_ASSERT(mTextures2D.find(idHash) == mTextures2D.end());
 		ID3D11Texture2D* elem;
 		ASSERT_HR(mDevice.CreateTexture2D(&texDesc, initialData, &elem));
-		mTextures2D[idHash] = elem;
+		const bool inserted = mTextures2D.Insert(idHash, elem);
+		BRE_ASSERT(inserted);
 		if (texture) *texture = elem;
 		return idHash;
 	}
@@ -121,10 +200,10 @@ namespace BRE {
 	size_t ShaderResourcesManager::AddRasterizerState(const char* id, const D3D11_RASTERIZER_DESC& desc, ID3D11RasterizerState* *state) {
 		BRE_ASSERT(id);
 		const size_t idHash = Utils::Hash(id);
-		BRE_ASSERT(mRasterizerStates.find(idHash) == mRasterizerStates.end());
 		ID3D11RasterizerState* elem;
 		ASSERT_HR(mDevice.CreateRasterizerState(&desc, &elem));
-		mRasterizerStates[idHash] = elem;
+		const bool inserted = mRasterizerStates.Insert(idHash, elem);
+		BRE_ASSERT(inserted);
 		if (state) *state = elem;
 		return idHash;
 	}
@@ -132,10 +211,10 @@ namespace BRE {
 	size_t ShaderResourcesManager::AddRenderTargetView(const char* id, ID3D11Resource& resource, const D3D11_RENDER_TARGET_VIEW_DESC* desc, ID3D11RenderTargetView* *view) {
 		BRE_ASSERT(id);
 		const size_t idHash = Utils::Hash(id);
-		BRE_ASSERT(mRenderTargetViews.find(idHash) == mRenderTargetViews.end());
 		ID3D11RenderTargetView* elem;
 		ASSERT_HR(mDevice.CreateRenderTargetView(&resource, desc, &elem));
-		mRenderTargetViews[idHash] = elem;
+		const bool inserted = mRenderTargetViews.Insert(idHash, elem);
+		BRE_ASSERT(inserted);
 		if (view) *view = elem;
 		return idHash;
 	}
@@ -143,10 +222,10 @@ namespace BRE {
 	size_t ShaderResourcesManager::AddDepthStencilView(const char* id, ID3D11Resource& resource, const D3D11_DEPTH_STENCIL_VIEW_DESC* desc, ID3D11DepthStencilView* *view) {
 		BRE_ASSERT(id);
 		const size_t idHash = Utils::Hash(id);
-		BRE_ASSERT(mDepthStencilViews.find(idHash) == mDepthStencilViews.end());
 		ID3D11DepthStencilView* elem;
 		ASSERT_HR(mDevice.CreateDepthStencilView(&resource, desc, &elem));
-		mDepthStencilViews[idHash] = elem;
+		const bool inserted = mDepthStencilViews.Insert(idHash, elem);
+		BRE_ASSERT(inserted);
 		if (view) *view = elem;
 		return idHash;
 	}
@@ -154,10 +233,10 @@ namespace BRE {
 	size_t ShaderResourcesManager::AddBlendState(const char* id, const D3D11_BLEND_DESC& desc, ID3D11BlendState* *state) {
 		BRE_ASSERT(id);
 		const size_t idHash = Utils::Hash(id);
-		BRE_ASSERT(mBlendStates.find(idHash) == mBlendStates.end());
 		ID3D11BlendState* elem;
 		ASSERT_HR(mDevice.CreateBlendState(&desc, &elem));
-		mBlendStates[idHash] = elem;
+		const bool inserted = mBlendStates.Insert(idHash, elem);
+		BRE_ASSERT(inserted);
 		if (state) *state = elem;
 		return idHash;
 	}
@@ -165,10 +244,10 @@ namespace BRE {
 	size_t ShaderResourcesManager::AddDepthStencilState(const char* id, const D3D11_DEPTH_STENCIL_DESC& desc, ID3D11DepthStencilState* *state) {
 		BRE_ASSERT(id);
 		const size_t idHash = Utils::Hash(id);
-		BRE_ASSERT(mDepthStencilStates.find(idHash) == mDepthStencilStates.end());
 		ID3D11DepthStencilState* elem;
 		ASSERT_HR(mDevice.CreateDepthStencilState(&desc, &elem));
-		mDepthStencilStates[idHash] = elem;
+		const bool inserted = mDepthStencilStates.Insert(idHash, elem);
+		BRE_ASSERT(inserted);
 		if (state) *state = elem;
 		return idHash;
 	}
@@ -176,111 +255,71 @@ namespace BRE {
 	size_t ShaderResourcesManager::AddSamplerState(const char* id, const D3D11_SAMPLER_DESC& desc, ID3D11SamplerState* *state) {
 		BRE_ASSERT(id);
 		const size_t idHash = Utils::Hash(id);
-		BRE_ASSERT(mSamplerStates.find(idHash) == mSamplerStates.end());
 		ID3D11SamplerState* elem;
 		ASSERT_HR(mDevice.CreateSamplerState(&desc, &elem));
-		mSamplerStates[idHash] = elem;
+		const bool inserted = mSamplerStates.Insert(idHash, elem);
+		BRE_ASSERT(inserted);
 		if (state) *state = elem;
 		return idHash;
 	}
 	
 	ID3D11ShaderResourceView* ShaderResourcesManager::ShaderResourceView(const size_t id) const {
-		ShaderResourceViews::const_iterator it = mShaderResourceViews.find(id);
-		if (it != mShaderResourceViews.end()) {
-			return it->second;
-		}
-		else {
-			return nullptr;
-		}
+		ID3D11ShaderResourceView* elem = nullptr;
+		mShaderResourceViews.Find(id, elem);
+		return elem;
 	}
 
 	ID3D11UnorderedAccessView* ShaderResourcesManager::UnorderedAccessView(const size_t id) const {
-		UnorderedAccessViews::const_iterator it = mUnorderedAccessViews.find(id);
-		if (it != mUnorderedAccessViews.end()) {
-			return it->second;
-		}
-		else {
-			return nullptr;
-		}
+		ID3D11UnorderedAccessView* elem = nullptr;
+		mUnorderedAccessViews.Find(id, elem);
+		return elem;
 	}
 	
 	ID3D11Buffer* ShaderResourcesManager::Buffer(const size_t id) const {
-		Buffers::const_iterator it = mBuffers.find(id);
-		if (it != mBuffers.end()) {
-			return it->second;
-		}
-		else {
-			return nullptr;
-		}
+		ID3D11Buffer* elem = nullptr;
+		mBuffers.Find(id, elem);
+		return elem;
 	}
 	
 	ID3D11Texture2D* ShaderResourcesManager::Texture2D(const size_t id) const {
-		Textures2D::const_iterator it = mTextures2D.find(id);
-		if (it != mTextures2D.end()) {
-			return it->second;
-		}
-		else {
-			return nullptr;
-		}
+		ID3D11Texture2D* elem = nullptr;
+		mTextures2D.Find(id, elem);
+		return elem;
 	}
 	
 	ID3D11RasterizerState* ShaderResourcesManager::RasterizerState(const size_t id) const {
-		RasterizerStates::const_iterator it = mRasterizerStates.find(id);
-		if (it != mRasterizerStates.end()) {
-			return it->second;
-		}
-		else {
-			return nullptr;
-		}
+		ID3D11RasterizerState* elem = nullptr;
+		mRasterizerStates.Find(id, elem);
+		return elem;
 	}
 	
 	ID3D11RenderTargetView* ShaderResourcesManager::RenderTargetView(const size_t id) const {
-		RenderTargetViews::const_iterator it = mRenderTargetViews.find(id);
-		if (it != mRenderTargetViews.end()) {
-			return it->second;
-		}
-		else {
-			return nullptr;
-		}
+		ID3D11RenderTargetView* elem = nullptr;
+		mRenderTargetViews.Find(id, elem);
+		return elem;
 	}
 	
 	ID3D11DepthStencilView* ShaderResourcesManager::DepthStencilView(const size_t id) const {
-		DepthStencilViews::const_iterator it = mDepthStencilViews.find(id);
-		if (it != mDepthStencilViews.end()) {
-			return it->second;
-		}
-		else {
-			return nullptr;
-		}
+		ID3D11DepthStencilView* elem = nullptr;
+		mDepthStencilViews.Find(id, elem);
+		return elem;
 	}
 	
 	ID3D11BlendState* ShaderResourcesManager::BlendState(const size_t id) const {
-		BlendStates::const_iterator it = mBlendStates.find(id);
-		if (it != mBlendStates.end()) {
-			return it->second;
-		}
-		else {
-			return nullptr;
-		}
+		ID3D11BlendState* elem = nullptr;
+		mBlendStates.Find(id, elem);
+		return elem;
 	}
 
 	ID3D11DepthStencilState* ShaderResourcesManager::DepthStencilState(const size_t id) const {
-		DepthStencilStates::const_iterator it = mDepthStencilStates.find(id);
-		if (it != mDepthStencilStates.end()) {
-			return it->second;
-		}
-		else {
-			return nullptr;
-		}
+		ID3D11DepthStencilState* elem = nullptr;
+		mDepthStencilStates.Find(id, elem);
+		return elem;
 	}
 	
 	ID3D11SamplerState* ShaderResourcesManager::SamplerState(const size_t id) const {
-		SamplerStates::const_iterator it = mSamplerStates.find(id);
-		if (it != mSamplerStates.end()) {
-			return it->second;
-		}
-		else {
-			return nullptr;
-		}
+		ID3D11SamplerState* elem = nullptr;
+		mSamplerStates.Find(id, elem);
+		return elem;
 	}
 }
\ No newline at end of file
@@ -1,6 +1,6 @@
 #pragma once
 
-#include <unordered_map>
+#include <utils/ConcurrentRegistry.h>
 
 struct D3D11_BLEND_DESC;
 struct D3D11_BUFFER_DESC;
@@ -40,7 +40,14 @@ namespace BRE {
 
 		const ShaderResourcesManager& operator=(const ShaderResourcesManager& rhs) = delete;
 
-		size_t AddTextureFromFileSRV(const char* filepath, ID3D11ShaderResourceView* * resource, const bool forceSRGB = false);
+		// Methods can be called from any thread. Concurrent requests of the same
+		// texture file load it once. Textures whose mip chain is completed use
+		// the immediate context, so they must be loaded on the rendering thread.
+
+		// Missing mip levels of uncompressed textures are generated on load.
+		// sRGBContent means texels are sRGB encoded even if the format is not
+		// (base color), so generated levels are filtered in linear space.
+		size_t AddTextureFromFileSRV(const char* filepath, ID3D11ShaderResourceView* * resource, const bool forceSRGB = false, const bool sRGBContent = false);
 
 		size_t AddResourceSRV(const char* id, ID3D11Resource& resource, const D3D11_SHADER_RESOURCE_VIEW_DESC* desc, ID3D11ShaderResourceView* * view = nullptr);
 		size_t AddResourceUAV(const char* id, ID3D11Resource& resource, const D3D11_UNORDERED_ACCESS_VIEW_DESC& desc, ID3D11UnorderedAccessView* *view = nullptr);
@@ -67,34 +74,24 @@ namespace BRE {
 	private:
 		ID3D11Device1& mDevice;
 
-		typedef std::unordered_map<size_t, ID3D11ShaderResourceView*> ShaderResourceViews;
-		ShaderResourceViews mShaderResourceViews;
+		ConcurrentRegistry<ID3D11ShaderResourceView*> mShaderResourceViews;
 
-		typedef std::unordered_map<size_t, ID3D11UnorderedAccessView*> UnorderedAccessViews;
-		UnorderedAccessViews mUnorderedAccessViews;
+		ConcurrentRegistry<ID3D11UnorderedAccessView*> mUnorderedAccessViews;
 
-		typedef std::unordered_map<size_t, ID3D11Buffer*> Buffers;
-		Buffers mBuffers;
+		ConcurrentRegistry<ID3D11Buffer*> mBuffers;
 
-		typedef std::unordered_map<size_t, ID3D11Texture2D*> Textures2D;
-		Textures2D mTextures2D;
+		ConcurrentRegistry<ID3D11Texture2D*> mTextures2D;
 
-		typedef std::unordered_map<size_t, ID3D11RasterizerState*> RasterizerStates;
-		RasterizerStates mRasterizerStates;
+		ConcurrentRegistry<ID3D11RasterizerState*> mRasterizerStates;
 
-		typedef std::unordered_map<size_t, ID3D11RenderTargetView*> RenderTargetViews;
-		RenderTargetViews mRenderTargetViews;
+		ConcurrentRegistry<ID3D11RenderTargetView*> mRenderTargetViews;
 
-		typedef std::unordered_map<size_t, ID3D11DepthStencilView*> DepthStencilViews;
-		DepthStencilViews mDepthStencilViews;
+		ConcurrentRegistry<ID3D11DepthStencilView*> mDepthStencilViews;
 
-		typedef std::unordered_map<size_t, ID3D11BlendState*> BlendStates;
-		BlendStates mBlendStates;
+		ConcurrentRegistry<ID3D11BlendState*> mBlendStates;
 
-		typedef std::unordered_map<size_t, ID3D11DepthStencilState*> DepthStencilStates;
-		DepthStencilStates mDepthStencilStates;
+		ConcurrentRegistry<ID3D11DepthStencilState*> mDepthStencilStates;
 
-		typedef std::unordered_map<size_t, ID3D11SamplerState*> SamplerStates;
-		SamplerStates mSamplerStates;
+		ConcurrentRegistry<ID3D11SamplerState*> mSamplerStates;
 	};
 }
\ No newline at end of file
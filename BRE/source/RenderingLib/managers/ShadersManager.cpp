@@ -1,11 +1,14 @@
 #include "ShadersManager.h"
 
+#include <cstring>
 #include <d3d11_1.h>
-#include <fstream>
 
+#include <managers/VirtualFileSystem.h>
 #include <utils/Assert.h>
 #include <utils/Hash.h>
 
+static_assert(BRE::ShaderArchive::sAppendAligned == D3D11_APPEND_ALIGNED_ELEMENT, "Archive input elements must use D3D11 values");
+
 namespace BRE {
 	ShadersManager* ShadersManager::gInstance = nullptr;
 
@@ -15,158 +18,277 @@ namespace BRE {
 	}
 
 	ShadersManager::~ShadersManager() {
-		for (auto& elem : mInputLayouts) {
-			elem.second->Release();
-		}
-		for (auto& elem : mVertexShaders) {
-			elem.second->Release();
-		}
-		for (auto& elem : mPixelShaders) {
-			elem.second->Release();
-		}
-		for (auto& elem : mGeometryShaders) {
-			elem.second->Release();
-		}
-		for (auto& elem : mComputeShaders) {
-			elem.second->Release();
-		}
-		for (auto& elem : mHullShaders) {
-			elem.second->Release();
-		}
-		for (auto& elem : mDomainShaders) {
-			elem.second->Release();
-		}
+		WaitForArchive();
+		mInputLayouts.ForEach([](const size_t, ID3D11InputLayout* elem) { elem->Release(); });
+		mVertexShaders.ForEach([](const size_t, ID3D11VertexShader* elem) { elem->Release(); });
+		mPixelShaders.ForEach([](const size_t, ID3D11PixelShader* elem) { elem->Release(); });
+		mGeometryShaders.ForEach([](const size_t, ID3D11GeometryShader* elem) { elem->Release(); });
+		mComputeShaders.ForEach([](const size_t, ID3D11ComputeShader* elem) { elem->Release(); });
+		mHullShaders.ForEach([](const size_t, ID3D11HullShader* elem) { elem->Release(); });
+		mDomainShaders.ForEach([](const size_t, ID3D11DomainShader* elem) { elem->Release(); });
 	}
 
 	size_t ShadersManager::LoadVertexShader(const char* filepath, const D3D11_INPUT_ELEMENT_DESC* inputLayoutDesc, const unsigned int* descNumElems, ID3D11VertexShader* *shader) {
 		BRE_ASSERT(filepath);
+		WaitForArchive();
 		const bool createInputLayout = inputLayoutDesc != nullptr && descNumElems != nullptr;
-		BRE_ASSERT(!createInputLayout || (createInputLayout && mInputLayouts.find(*filepath) == mInputLayouts.end()));
 		const size_t id = Utils::Hash(filepath);
-		VertexShaders::const_iterator findIt = mVertexShaders.find(id);
-		if (findIt != mVertexShaders.end()) {
-			if (shader) *shader = findIt->second;
-			return id;
-		}
-		std::vector<char> shaderByteCode;
-		StoreShaderByteCode(filepath, shaderByteCode);
+		ID3D11VertexShader* elem = mVertexShaders.GetOrCreate(id, [&]() {
+			std::vector<std::uint8_t> shaderByteCode;
+			StoreShaderByteCode(filepath, shaderByteCode);
+			if (createInputLayout) {
+				// Another load of the same id may have created the layout already
+				mInputLayouts.GetOrCreate(id, [&]() {
+					ID3D11InputLayout* inputLayout;
+					BuildVertexLayout(shaderByteCode.data(), shaderByteCode.size(), inputLayoutDesc, *descNumElems, inputLayout);
+					return inputLayout;
+				});
+			}
+			ID3D11VertexShader* created = nullptr;
+			ASSERT_HR(mDevice.CreateVertexShader(&shaderByteCode[0], shaderByteCode.size(), nullptr, &created));
+			return created;
+		});
+
 		if (createInputLayout) {
-			ID3D11InputLayout* inputLayout;
-			BuildVertexLayout(shaderByteCode, inputLayoutDesc, *descNumElems, inputLayout);
-			mInputLayouts[id] = inputLayout;
+			const std::unordered_map<size_t, size_t>::const_iterator archiveIt = mArchiveVertexShaders.find(id);
+			bool createdLayout = false;
+			// It was loaded without input layout
+			mInputLayouts.GetOrCreate(id, [&]() {
+				ID3D11InputLayout* inputLayout;
+				if (archiveIt != mArchiveVertexShaders.end()) {
+					BuildVertexLayout(mArchive.ByteCode(archiveIt->second), static_cast<size_t>(mArchive.GetShader(archiveIt->second).mByteCodeSize), inputLayoutDesc, *descNumElems, inputLayout);
+				}
+				else {
+					std::vector<std::uint8_t> shaderByteCode;
+					StoreShaderByteCode(filepath, shaderByteCode);
+					BuildVertexLayout(shaderByteCode.data(), shaderByteCode.size(), inputLayoutDesc, *descNumElems, inputLayout);
+				}
+				return inputLayout;
+			}, &createdLayout);
+			// Layouts of the archive must match the requested one
+			BRE_ASSERT(createdLayout || archiveIt == mArchiveVertexShaders.end() || mArchive.GetShader(archiveIt->second).mNumInputElements == 0U || MatchesArchiveLayout(archiveIt->second, inputLayoutDesc, *descNumElems));
 		}
-		ID3D11VertexShader* elem = nullptr;
-		ASSERT_HR(mDevice.CreateVertexShader(&shaderByteCode[0], shaderByteCode.size(), nullptr, &elem));
-		mVertexShaders[id] = elem;
 		if (shader) *shader = elem;
 		return id;
 	}
 
 	size_t ShadersManager::LoadPixelShader(const char* filepath, ID3D11PixelShader* *shader) {
 		BRE_ASSERT(filepath);
+		WaitForArchive();
 		const size_t id = Utils::Hash(filepath);
-		PixelShaders::const_iterator findIt = mPixelShaders.find(id);
-		if (findIt != mPixelShaders.end()) {
-			if (shader) *shader = findIt->second;
-			return id;
-		}
-		std::vector<char> shaderByteCode;
-		StoreShaderByteCode(filepath, shaderByteCode);
-		ID3D11PixelShader* elem = nullptr;
-		ASSERT_HR(mDevice.CreatePixelShader(&shaderByteCode[0], shaderByteCode.size(), nullptr, &elem));
-		mPixelShaders[id] = elem;
+		ID3D11PixelShader* elem = mPixelShaders.GetOrCreate(id, [&]() {
+			std::vector<std::uint8_t> shaderByteCode;
+			StoreShaderByteCode(filepath, shaderByteCode);
+			ID3D11PixelShader* created = nullptr;
+			ASSERT_HR(mDevice.CreatePixelShader(&shaderByteCode[0], shaderByteCode.size(), nullptr, &created));
+			return created;
+		});
 		if (shader) *shader = elem;
 		return id;
 	}
 
 	size_t ShadersManager::LoadHullShader(const char* filepath, ID3D11HullShader* *shader) {
 		BRE_ASSERT(filepath);
+		WaitForArchive();
 		const size_t id = Utils::Hash(filepath);
-		HullShaders::const_iterator findIt = mHullShaders.find(id);
-		if (findIt != mHullShaders.end()) {
-			if (shader) *shader = findIt->second;
-			return id;
-		}
-		std::vector<char> shaderByteCode;
-		StoreShaderByteCode(filepath, shaderByteCode);
-		ID3D11HullShader* elem = nullptr;
-		ASSERT_HR(mDevice.CreateHullShader(&shaderByteCode[0], shaderByteCode.size(), nullptr, &elem));
-		mHullShaders[id] = elem;
+		ID3D11HullShader* elem = mHullShaders.GetOrCreate(id, [&]() {
+			std::vector<std::uint8_t> shaderByteCode;
+			StoreShaderByteCode(filepath, shaderByteCode);
+			ID3D11HullShader* created = nullptr;
+			ASSERT_HR(mDevice.CreateHullShader(&shaderByteCode[0], shaderByteCode.size(), nullptr, &created));
+			return created;
+		});
 		if (shader) *shader = elem;
 		return id;
 	}
 
 	size_t ShadersManager::LoadDomainShader(const char* filepath, ID3D11DomainShader* *shader) {
 		BRE_ASSERT(filepath);
+		WaitForArchive();
 		const size_t id = Utils::Hash(filepath);
-		DomainShaders::const_iterator findIt = mDomainShaders.find(id);
-		if (findIt != mDomainShaders.end()) {
-			if (shader) *shader = findIt->second;
-			return id;
-		}
-		std::vector<char> shaderByteCode;
-		StoreShaderByteCode(filepath, shaderByteCode);
-		ID3D11DomainShader* elem = nullptr;
-		ASSERT_HR(mDevice.CreateDomainShader(&shaderByteCode[0], shaderByteCode.size(), nullptr, &elem));
-		mDomainShaders[id] = elem;
+		ID3D11DomainShader* elem = mDomainShaders.GetOrCreate(id, [&]() {
+			std::vector<std::uint8_t> shaderByteCode;
+			StoreShaderByteCode(filepath, shaderByteCode);
+			ID3D11DomainShader* created = nullptr;
+			ASSERT_HR(mDevice.CreateDomainShader(&shaderByteCode[0], shaderByteCode.size(), nullptr, &created));
+			return created;
+		});
 		if (shader) *shader = elem;
 		return id;
 	}
 
 	size_t ShadersManager::LoadGeometryShader(const char* filepath, ID3D11GeometryShader* *shader) {
 		BRE_ASSERT(filepath);
+		WaitForArchive();
 		const size_t id = Utils::Hash(filepath);
-		GeometryShaders::const_iterator findIt = mGeometryShaders.find(id);
-		if (findIt != mGeometryShaders.end()) {
-			if (shader) *shader = findIt->second;
-			return id;
-		}
-		std::vector<char> shaderByteCode;
-		StoreShaderByteCode(filepath, shaderByteCode);
-		ID3D11GeometryShader* elem = nullptr;
-		ASSERT_HR(mDevice.CreateGeometryShader(&shaderByteCode[0], shaderByteCode.size(), nullptr, &elem));
-		mGeometryShaders[id] = elem;
+		ID3D11GeometryShader* elem = mGeometryShaders.GetOrCreate(id, [&]() {
+			std::vector<std::uint8_t> shaderByteCode;
+			StoreShaderByteCode(filepath, shaderByteCode);
+			ID3D11GeometryShader* created = nullptr;
+			ASSERT_HR(mDevice.CreateGeometryShader(&shaderByteCode[0], shaderByteCode.size(), nullptr, &created));
+			return created;
+		});
 		if (shader) *shader = elem;
 		return id;
 	}
 
 	size_t ShadersManager::LoadComputeShader(const char* filepath, ID3D11ComputeShader* *shader) {
 		BRE_ASSERT(filepath);
+		WaitForArchive();
 		const size_t id = Utils::Hash(filepath);
-		ComputeShaders::const_iterator findIt = mComputeShaders.find(id);
-		if (findIt != mComputeShaders.end()) {
-			if (shader) *shader = findIt->second;
-			return id;
-		}
-		std::vector<char> shaderByteCode;
-		StoreShaderByteCode(filepath, shaderByteCode);
-		ID3D11ComputeShader* elem = nullptr;
-		ASSERT_HR(mDevice.CreateComputeShader(&shaderByteCode[0], shaderByteCode.size(), nullptr, &elem));
-		mComputeShaders[id] = elem;
+		ID3D11ComputeShader* elem = mComputeShaders.GetOrCreate(id, [&]() {
+			std::vector<std::uint8_t> shaderByteCode;
+			StoreShaderByteCode(filepath, shaderByteCode);
+			ID3D11ComputeShader* created = nullptr;
+			ASSERT_HR(mDevice.CreateComputeShader(&shaderByteCode[0], shaderByteCode.size(), nullptr, &created));
+			return created;
+		});
+		if (shader) *shader = elem;
 		return id;
 	}
 
 	ID3D11InputLayout* ShadersManager::InputLayout(const size_t id) const {
-		InputLayouts::const_iterator findIt = mInputLayouts.find(id);
-		BRE_ASSERT(findIt != mInputLayouts.end());
-		return findIt->second;
+		ID3D11InputLayout* inputLayout = nullptr;
+		const bool found = mInputLayouts.Find(id, inputLayout);
+		BRE_ASSERT(found);
+		return inputLayout;
+	}
+
+	bool ShadersManager::LoadArchive(const char* filepath, const bool async, std::string& error) {
+		BRE_ASSERT(filepath);
+		BRE_ASSERT(!mArchive.IsOpen());
+		BRE_ASSERT(VirtualFileSystem::gInstance);
+		size_t size = 0U;
+		const std::uint8_t* data = VirtualFileSystem::gInstance->MappedData(filepath, size);
+		if (data == nullptr) {
+			if (!VirtualFileSystem::gInstance->ReadFile(filepath, mArchiveData)) {
+				error = std::string("Cannot read ") + filepath;
+				return false;
+			}
+			data = mArchiveData.data();
+			size = mArchiveData.size();
+		}
+		if (!mArchive.Open(data, size, error)) {
+			error = std::string(filepath) + ": " + error;
+			mArchiveData.clear();
+			return false;
+		}
+
+		if (async) {
+			mArchiveThread = std::thread(&ShadersManager::CreateArchiveShaders, this);
+			mArchivePending.store(true, std::memory_order_release);
+		}
+		else {
+			CreateArchiveShaders();
+		}
+		return true;
+	}
+
+	void ShadersManager::CreateArchiveShaders() {
+		std::vector<D3D11_INPUT_ELEMENT_DESC> inputLayoutDesc;
+		for (size_t i = 0U; i < mArchive.NumShaders(); ++i) {
+			const ShaderArchive::Shader& archiveShader = mArchive.GetShader(i);
+			const size_t id = Utils::Hash(mArchive.ShaderName(i));
+			const std::uint8_t* byteCode = mArchive.ByteCode(i);
+			const size_t byteCodeSize = static_cast<size_t>(archiveShader.mByteCodeSize);
+			switch (archiveShader.mType) {
+			case ShaderArchive::ShaderType::Vertex: {
+				ID3D11VertexShader* elem = nullptr;
+				ASSERT_HR(mDevice.CreateVertexShader(byteCode, byteCodeSize, nullptr, &elem));
+				mVertexShaders.Insert(id, elem);
+				mArchiveVertexShaders[id] = i;
+				if (archiveShader.mNumInputElements > 0U) {
+					inputLayoutDesc.resize(archiveShader.mNumInputElements);
+					for (size_t j = 0U; j < inputLayoutDesc.size(); ++j) {
+						const ShaderArchive::InputElement& element = mArchive.GetInputElement(i, j);
+						D3D11_INPUT_ELEMENT_DESC& desc = inputLayoutDesc[j];
+						desc.SemanticName = mArchive.SemanticName(element);
+						desc.SemanticIndex = element.mSemanticIndex;
+						desc.Format = static_cast<DXGI_FORMAT>(element.mFormat);
+						desc.InputSlot = element.mInputSlot;
+						desc.AlignedByteOffset = element.mAlignedByteOffset;
+						desc.InputSlotClass = static_cast<D3D11_INPUT_CLASSIFICATION>(element.mInputSlotClass);
+						desc.InstanceDataStepRate = element.mInstanceDataStepRate;
+					}
+					ID3D11InputLayout* inputLayout;
+					BuildVertexLayout(byteCode, byteCodeSize, inputLayoutDesc.data(), static_cast<unsigned int>(inputLayoutDesc.size()), inputLayout);
+					mInputLayouts.Insert(id, inputLayout);
+				}
+				break;
+			}
+			case ShaderArchive::ShaderType::Hull: {
+				ID3D11HullShader* elem = nullptr;
+				ASSERT_HR(mDevice.CreateHullShader(byteCode, byteCodeSize, nullptr, &elem));
+				mHullShaders.Insert(id, elem);
+				break;
+			}
+			case ShaderArchive::ShaderType::Domain: {
+				ID3D11DomainShader* elem = nullptr;
+				ASSERT_HR(mDevice.CreateDomainShader(byteCode, byteCodeSize, nullptr, &elem));
+				mDomainShaders.Insert(id, elem);
+				break;
+			}
+			case ShaderArchive::ShaderType::Geometry: {
+				ID3D11GeometryShader* elem = nullptr;
+				ASSERT_HR(mDevice.CreateGeometryShader(byteCode, byteCodeSize, nullptr, &elem));
+				mGeometryShaders.Insert(id, elem);
+				break;
+			}
+			case ShaderArchive::ShaderType::Pixel: {
+				ID3D11PixelShader* elem = nullptr;
+				ASSERT_HR(mDevice.CreatePixelShader(byteCode, byteCodeSize, nullptr, &elem));
+				mPixelShaders.Insert(id, elem);
+				break;
+			}
+			case ShaderArchive::ShaderType::Compute: {
+				ID3D11ComputeShader* elem = nullptr;
+				ASSERT_HR(mDevice.CreateComputeShader(byteCode, byteCodeSize, nullptr, &elem));
+				mComputeShaders.Insert(id, elem);
+				break;
+			}
+			default:
+				BRE_ASSERT(false);
+			}
+		}
+	}
+
+	void ShadersManager::WaitForArchive() {
+		if (mArchivePending.load(std::memory_order_acquire)) {
+			std::lock_guard<std::mutex> lock(mArchiveMutex);
+			if (mArchiveThread.joinable()) {
+				mArchiveThread.join();
+			}
+			mArchivePending.store(false, std::memory_order_release);
+		}
+	}
+
+	bool ShadersManager::MatchesArchiveLayout(const size_t archiveShader, const D3D11_INPUT_ELEMENT_DESC* inputLayoutDesc, const unsigned int inputLayoutDescSize) const {
+		if (mArchive.GetShader(archiveShader).mNumInputElements != inputLayoutDescSize) {
+			return false;
+		}
+		for (unsigned int i = 0U; i < inputLayoutDescSize; ++i) {
+			const ShaderArchive::InputElement& element = mArchive.GetInputElement(archiveShader, i);
+			const D3D11_INPUT_ELEMENT_DESC& desc = inputLayoutDesc[i];
+			if (strcmp(mArchive.SemanticName(element), desc.SemanticName) != 0 || element.mSemanticIndex != desc.SemanticIndex || element.mFormat != static_cast<std::uint32_t>(desc.Format)
+				|| element.mInputSlot != desc.InputSlot || element.mAlignedByteOffset != desc.AlignedByteOffset
+				|| element.mInputSlotClass != static_cast<std::uint32_t>(desc.InputSlotClass) || element.mInstanceDataStepRate != desc.InstanceDataStepRate) {
+				return false;
+			}
+		}
+		return true;
 	}
 
-	void ShadersManager::StoreShaderByteCode(const char* fileName, std::vector<char>& buffer) const {
+	void ShadersManager::StoreShaderByteCode(const char* fileName, std::vector<std::uint8_t>& buffer) const {
 		BRE_ASSERT(fileName);
-		std::ifstream file;
-		file.open(fileName, std::ios::binary);
-		BRE_ASSERT(file.is_open());
-		file.seekg(0, std::ios_base::end);
-		size_t size = static_cast<size_t> (file.tellg());
-		file.seekg(0, std::ios_base::beg);
-		buffer.resize(size);
-		file.read(&buffer[0], size);
-		file.close();
+		BRE_ASSERT(VirtualFileSystem::gInstance);
+		const bool read = VirtualFileSystem::gInstance->ReadFile(fileName, buffer);
+		BRE_ASSERT(read);
+		BRE_ASSERT(!buffer.empty());
 	}
 
-	void ShadersManager::BuildVertexLayout(std::vector<char>& shaderByteCode, const D3D11_INPUT_ELEMENT_DESC* inputLayoutDesc, const unsigned int inputLayoutDescSize, ID3D11InputLayout* &inputLayout) const {
-		BRE_ASSERT(!shaderByteCode.empty());
-		ASSERT_HR(mDevice.CreateInputLayout(inputLayoutDesc, inputLayoutDescSize, &shaderByteCode[0], shaderByteCode.size(), &inputLayout));
+	void ShadersManager::BuildVertexLayout(const std::uint8_t* shaderByteCode, const size_t shaderByteCodeSize, const D3D11_INPUT_ELEMENT_DESC* inputLayoutDesc, const unsigned int inputLayoutDescSize, ID3D11InputLayout* &inputLayout) const {
+		BRE_ASSERT(shaderByteCode);
+		BRE_ASSERT(shaderByteCodeSize > 0U);
+		ASSERT_HR(mDevice.CreateInputLayout(inputLayoutDesc, inputLayoutDescSize, shaderByteCode, shaderByteCodeSize, &inputLayout));
 	}
 }
\ No newline at end of file
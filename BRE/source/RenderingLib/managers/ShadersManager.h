@@ -1,6 +1,15 @@
 #pragma once
 
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
 #include <unordered_map>
+#include <vector>
+
+#include <utils/ConcurrentRegistry.h>
+#include <utils/ShaderArchive.h>
 
 struct D3D11_INPUT_ELEMENT_DESC;
 struct ID3D11ComputeShader;
@@ -25,6 +34,10 @@ namespace BRE {
 		// If a shader was already loaded, it is only returned.
 		// For vertex shader loading, you can optionally load a input layout too or not.
 		// Note: Shader should be previously compiled to .cso
+		// Shaders of the loaded archive are only returned. The others are read
+		// from their file.
+		// Load methods can be called from any thread. Concurrent requests of the
+		// same shader create it once.
 
 		size_t LoadVertexShader(const char* filepath, const D3D11_INPUT_ELEMENT_DESC* inputLayoutDesc = nullptr, const unsigned int* descNumElems = nullptr, ID3D11VertexShader* * shader = nullptr);
 		size_t LoadPixelShader(const char* filepath, ID3D11PixelShader* *shader = nullptr);
@@ -35,31 +48,46 @@ namespace BRE {
 
 		ID3D11InputLayout* InputLayout(const size_t id) const;
 
+		// Creates every shader (and input layout) of the archive (see ShaderArchive)
+		// in one batch, from the mapped archive when it is in a content pack.
+		// With async, they are created on a worker thread and the first Load
+		// method waits for it. Call it before loading any shader.
+		// On failure, error is filled and false is returned.
+		bool LoadArchive(const char* filepath, const bool async, std::string& error);
+
 	private:
-		void StoreShaderByteCode(const char* fileName, std::vector<char>& buffer) const;
-		void BuildVertexLayout(std::vector<char>& shaderByteCode, const D3D11_INPUT_ELEMENT_DESC* inputLayoutDesc, const unsigned int inputLayoutDescSize, ID3D11InputLayout* &inputLayout) const;
+		void CreateArchiveShaders();
+		void WaitForArchive();
+		// Drawers input layouts must match the archive ones
+		bool MatchesArchiveLayout(const size_t archiveShader, const D3D11_INPUT_ELEMENT_DESC* inputLayoutDesc, const unsigned int inputLayoutDescSize) const;
+
+		void StoreShaderByteCode(const char* fileName, std::vector<std::uint8_t>& buffer) const;
+		void BuildVertexLayout(const std::uint8_t* shaderByteCode, const size_t shaderByteCodeSize, const D3D11_INPUT_ELEMENT_DESC* inputLayoutDesc, const unsigned int inputLayoutDescSize, ID3D11InputLayout* &inputLayout) const;
 
 		ID3D11Device1& mDevice;
 
-		typedef std::unordered_map<size_t, ID3D11InputLayout*> InputLayouts;
-		InputLayouts mInputLayouts;
+		// Archive memory when it is not mapped
+		std::vector<std::uint8_t> mArchiveData;
+		ShaderArchive mArchive;
+		std::thread mArchiveThread;
+		// True while mArchiveThread must be joined
+		std::atomic<bool> mArchivePending{ false };
+		std::mutex mArchiveMutex;
+		// Archive shader index of each archive vertex shader id
+		std::unordered_map<size_t, size_t> mArchiveVertexShaders;
+
+		ConcurrentRegistry<ID3D11InputLayout*> mInputLayouts;
 
-		typedef std::unordered_map<size_t, ID3D11VertexShader*> VertexShaders;
-		VertexShaders mVertexShaders;
+		ConcurrentRegistry<ID3D11VertexShader*> mVertexShaders;
 
-		typedef std::unordered_map<size_t, ID3D11PixelShader*> PixelShaders;
-		PixelShaders mPixelShaders;
+		ConcurrentRegistry<ID3D11PixelShader*> mPixelShaders;
 
-		typedef std::unordered_map<size_t, ID3D11HullShader*> HullShaders;
-		HullShaders mHullShaders;
+		ConcurrentRegistry<ID3D11HullShader*> mHullShaders;
 
-		typedef std::unordered_map<size_t, ID3D11DomainShader*> DomainShaders;
-		DomainShaders mDomainShaders;
+		ConcurrentRegistry<ID3D11DomainShader*> mDomainShaders;
 
-		typedef std::unordered_map<size_t, ID3D11ComputeShader*> ComputeShaders;
-		ComputeShaders mComputeShaders;
+		ConcurrentRegistry<ID3D11ComputeShader*> mComputeShaders;
 
-		typedef std::unordered_map<size_t, ID3D11GeometryShader*> GeometryShaders;
-		GeometryShaders mGeometryShaders;
+		ConcurrentRegistry<ID3D11GeometryShader*> mGeometryShaders;
 	};
 }
\ No newline at end of file
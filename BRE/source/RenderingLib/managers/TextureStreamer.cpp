@@ -0,0 +1,277 @@
+#include "TextureStreamer.h"
+
+#include <algorithm>
+#include <d3d11_1.h>
+
+#include <general/Profiler.h>
+#include <general/RenderCounters.h>
+#include <utils/Assert.h>
+#include <utils/Hash.h>
+#include <utils/MipGenerator.h>
+
+namespace {
+	bool IsBlockCompressed(const DXGI_FORMAT format) {
+		switch (format) {
+		case DXGI_FORMAT_BC1_UNORM:
+		case DXGI_FORMAT_BC1_UNORM_SRGB:
+		case DXGI_FORMAT_BC4_UNORM:
+		case DXGI_FORMAT_BC5_UNORM:
+		case DXGI_FORMAT_BC7_UNORM:
+		case DXGI_FORMAT_BC7_UNORM_SRGB:
+			return true;
+		default:
+			return false;
+		}
+	}
+
+	// Lowest detail level that can be the top level of a texture. Block compressed
+	// textures need top level dimensions multiple of the block size (4).
+	unsigned int LastValidTopMip(const BRE::DdsTextureInfo& info) {
+		if (!IsBlockCompressed(static_cast<DXGI_FORMAT>(info.mDxgiFormat))) {
+			return info.mNumMips - 1U;
+		}
+		unsigned int mip = 0U;
+		while (mip + 1U < info.mNumMips && (info.MipWidth(mip + 1U) % 4U) == 0U && (info.MipHeight(mip + 1U) % 4U) == 0U) {
+			++mip;
+		}
+		return mip;
+	}
+}
+
+namespace BRE {
+	TextureStreamer* TextureStreamer::gInstance = nullptr;
+
+	TextureStreamer::TextureStreamer(ID3D11Device1& device, ID3D11DeviceContext1& context, const unsigned int screenHeight, const Settings& settings)
+		: mDevice(device)
+		, mContext(context)
+		, mScreenHeight(static_cast<float>(screenHeight))
+		, mTailDimension(settings.mTailDimension)
+		, mScheduler(settings.mBudgetBytes, settings.mMaxLoadsInFlight)
+	{
+		BRE_ASSERT(settings.mMaxLoadsInFlight > 0U);
+		mThread = std::thread(&TextureStreamer::LoadThread, this);
+	}
+
+	TextureStreamer::~TextureStreamer() {
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			mExit = true;
+		}
+		mCondition.notify_one();
+		mThread.join();
+
+		for (Load& load : mFinishedLoads) {
+			if (load.mSRV) {
+				load.mSRV->Release();
+				load.mResource->Release();
+			}
+		}
+		for (Texture& texture : mTextures) {
+			texture.mSRV->Release();
+			texture.mTexture->Release();
+		}
+	}
+
+	bool TextureStreamer::AddTexture(const char* filepath, size_t& id, std::string& error) {
+		BRE_ASSERT(filepath);
+		const size_t pathId = Utils::Hash(filepath);
+		TextureIdByPath::const_iterator findIt = mTextureIdByPath.find(pathId);
+		if (findIt != mTextureIdByPath.end()) {
+			id = findIt->second;
+			return true;
+		}
+
+		Texture texture;
+		texture.mFilepath = filepath;
+		if (!DdsMipReader::ReadInfo(texture.mFilepath, texture.mInfo, error)) {
+			return false;
+		}
+		const DdsTextureInfo& info = texture.mInfo;
+		if (info.mNumMips != MipGenerator::NumLevels(info.mWidth, info.mHeight)) {
+			error = texture.mFilepath + " has no full mip chain";
+			return false;
+		}
+
+		unsigned int tailTopMip = 0U;
+		while (tailTopMip + 1U < info.mNumMips && (std::max)(info.MipWidth(tailTopMip), info.MipHeight(tailTopMip)) > mTailDimension) {
+			++tailTopMip;
+		}
+		tailTopMip = (std::min)(tailTopMip, LastValidTopMip(info));
+
+		std::vector<std::uint8_t> data;
+		if (!DdsMipReader::ReadMips(texture.mFilepath, info, tailTopMip, data, error)) {
+			return false;
+		}
+		if (!CreateTexture(info, tailTopMip, data, &texture.mTexture, &texture.mSRV)) {
+			error = texture.mFilepath + " texture could not be created";
+			return false;
+		}
+		texture.mTopMip = tailTopMip;
+
+		id = mScheduler.AddTexture(info.mMipSizes, tailTopMip);
+		BRE_ASSERT(id == mTextures.size());
+		mTextures.push_back(texture);
+		mTextureIdByPath[pathId] = id;
+		return true;
+	}
+
+	ID3D11ShaderResourceView* TextureStreamer::ShaderResourceView(const size_t id) const {
+		BRE_ASSERT(id < mTextures.size());
+		return mTextures[id].mSRV;
+	}
+
+	void TextureStreamer::Request(const size_t id, const float screenFraction) {
+		BRE_ASSERT(id < mTextures.size());
+		const DdsTextureInfo& info = mTextures[id].mInfo;
+		const float screenPixels = screenFraction * mScreenHeight;
+		const unsigned int topMip = TextureStreamingScheduler::TopMipForScreenSize(info.mWidth, info.mHeight, info.mNumMips, screenPixels);
+		mScheduler.Request(id, topMip, screenPixels);
+	}
+
+	void TextureStreamer::Update() {
+		BRE_PROFILE_SCOPE("TextureStreamer::Update");
+
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			mLoadsToApply.swap(mFinishedLoads);
+		}
+		bool viewsChanged = false;
+		for (Load& load : mLoadsToApply) {
+			Texture& texture = mTextures[load.mTexture];
+			const bool succeeded = load.mSRV != nullptr;
+			if (succeeded) {
+				texture.mSRV->Release();
+				texture.mTexture->Release();
+				texture.mTexture = load.mResource;
+				texture.mSRV = load.mSRV;
+				texture.mTopMip = load.mTopMip;
+				viewsChanged = true;
+			}
+			else {
+				++mNumFailedLoads;
+				mLastLoadError.swap(load.mError);
+			}
+			mScheduler.OnLoaded(load.mTexture, succeeded);
+		}
+		mLoadsToApply.clear();
+
+		mScheduler.Update(mDecisions);
+		bool newLoads = false;
+		for (const TextureStreamingScheduler::Decision& decision : mDecisions) {
+			Texture& texture = mTextures[decision.mTexture];
+			if (decision.mLoad) {
+				Load load;
+				load.mTexture = decision.mTexture;
+				load.mTopMip = decision.mTopMip;
+				load.mFilepath = texture.mFilepath;
+				load.mInfo = texture.mInfo;
+				load.mResource = nullptr;
+				load.mSRV = nullptr;
+				std::lock_guard<std::mutex> lock(mMutex);
+				mPendingLoads.push_back(load);
+				newLoads = true;
+			}
+			else {
+				Evict(texture, decision.mTopMip);
+				viewsChanged = true;
+			}
+		}
+		if (newLoads) {
+			mCondition.notify_one();
+		}
+		if (viewsChanged) {
+			++mViewsVersion;
+		}
+	}
+
+	void TextureStreamer::LoadThread() {
+		std::vector<std::uint8_t> data;
+		for (;;) {
+			Load load;
+			{
+				std::unique_lock<std::mutex> lock(mMutex);
+				mCondition.wait(lock, [this]() { return mExit || !mPendingLoads.empty(); });
+				if (mExit) {
+					return;
+				}
+				load = mPendingLoads.front();
+				mPendingLoads.pop_front();
+			}
+
+			if (DdsMipReader::ReadMips(load.mFilepath, load.mInfo, load.mTopMip, data, load.mError)) {
+				BRE_COUNTER_ADD(RenderCounter::StreamedBytes, data.size());
+				if (!CreateTexture(load.mInfo, load.mTopMip, data, &load.mResource, &load.mSRV)) {
+					load.mError = load.mFilepath + " texture could not be created";
+				}
+			}
+
+			std::lock_guard<std::mutex> lock(mMutex);
+			mFinishedLoads.push_back(load);
+		}
+	}
+
+	bool TextureStreamer::CreateTexture(const DdsTextureInfo& info, const unsigned int topMip, const std::vector<std::uint8_t>& data, ID3D11Texture2D* *texture, ID3D11ShaderResourceView* *view) {
+		BRE_ASSERT(texture);
+		BRE_ASSERT(view);
+		BRE_ASSERT(topMip < info.mNumMips);
+
+		D3D11_TEXTURE2D_DESC desc;
+		ZeroMemory(&desc, sizeof(desc));
+		desc.Width = info.MipWidth(topMip);
+		desc.Height = info.MipHeight(topMip);
+		desc.MipLevels = info.mNumMips - topMip;
+		desc.ArraySize = 1U;
+		desc.Format = static_cast<DXGI_FORMAT>(info.mDxgiFormat);
+		desc.SampleDesc.Count = 1U;
+		desc.Usage = D3D11_USAGE_DEFAULT;
+		desc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+
+		D3D11_SUBRESOURCE_DATA initialData[D3D11_REQ_MIP_LEVELS];
+		for (unsigned int level = 0U; level < desc.MipLevels; ++level) {
+			const unsigned int mip = topMip + level;
+			initialData[level].pSysMem = data.data() + (info.mMipOffsets[mip] - info.mMipOffsets[topMip]);
+			initialData[level].SysMemPitch = info.mMipRowPitches[mip];
+			initialData[level].SysMemSlicePitch = static_cast<unsigned int>(info.mMipSizes[mip]);
+		}
+
+		*texture = nullptr;
+		*view = nullptr;
+		if (FAILED(mDevice.CreateTexture2D(&desc, initialData, texture))) {
+			return false;
+		}
+		if (FAILED(mDevice.CreateShaderResourceView(*texture, nullptr, view))) {
+			(*texture)->Release();
+			*texture = nullptr;
+			return false;
+		}
+		return true;
+	}
+
+	void TextureStreamer::Evict(Texture& texture, const unsigned int topMip) {
+		BRE_ASSERT(topMip > texture.mTopMip);
+		BRE_COUNTER_ADD(RenderCounter::StreamingEvictions, 1U);
+
+		const DdsTextureInfo& info = texture.mInfo;
+		D3D11_TEXTURE2D_DESC desc;
+		texture.mTexture->GetDesc(&desc);
+		const unsigned int numLevels = desc.MipLevels;
+		desc.Width = info.MipWidth(topMip);
+		desc.Height = info.MipHeight(topMip);
+		desc.MipLevels = info.mNumMips - topMip;
+
+		ID3D11Texture2D* evictedTexture;
+		ASSERT_HR(mDevice.CreateTexture2D(&desc, nullptr, &evictedTexture));
+		const unsigned int skippedLevels = topMip - texture.mTopMip;
+		for (unsigned int level = 0U; level < desc.MipLevels; ++level) {
+			mContext.CopySubresourceRegion(evictedTexture, D3D11CalcSubresource(level, 0U, desc.MipLevels), 0U, 0U, 0U, texture.mTexture, D3D11CalcSubresource(level + skippedLevels, 0U, numLevels), nullptr);
+		}
+		ID3D11ShaderResourceView* evictedView;
+		ASSERT_HR(mDevice.CreateShaderResourceView(evictedTexture, nullptr, &evictedView));
+
+		texture.mSRV->Release();
+		texture.mTexture->Release();
+		texture.mTexture = evictedTexture;
+		texture.mSRV = evictedView;
+		texture.mTopMip = topMip;
+	}
+}
\ No newline at end of file
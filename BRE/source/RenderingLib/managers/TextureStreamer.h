@@ -0,0 +1,127 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <streaming/DdsMipReader.h>
+#include <streaming/TextureStreamingScheduler.h>
+
+struct ID3D11Device1;
+struct ID3D11DeviceContext1;
+struct ID3D11ShaderResourceView;
+struct ID3D11Texture2D;
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Streams mip levels of DDS textures within a video memory budget.
+// Small levels (the tail) are loaded when a texture is added, so it can be
+// used right away. Drawers request detail each frame based on their
+// projected size and Update() (once per frame, before drawing) applies
+// finished loads, evicts levels of least recently used textures and
+// schedules new loads. A loading thread reads levels and creates their
+// resources (the device is free threaded). Evictions copy the remaining
+// levels to a smaller texture on the GPU.
+// Views change when levels are loaded or evicted, so users must not keep
+// them across frames without checking ViewsVersion().
+//
+//////////////////////////////////////////////////////////////////////////
+
+namespace BRE {
+	class TextureStreamer {
+	public:
+		static TextureStreamer* gInstance;
+
+		struct Settings {
+			size_t mBudgetBytes = 256U * 1024U * 1024U;
+			// Levels up to this size (largest dimension) are always resident
+			unsigned int mTailDimension = 64U;
+			unsigned int mMaxLoadsInFlight = 4U;
+		};
+
+		TextureStreamer(ID3D11Device1& device, ID3D11DeviceContext1& context, const unsigned int screenHeight, const Settings& settings);
+		~TextureStreamer();
+
+		const TextureStreamer& operator=(const TextureStreamer& rhs) = delete;
+
+		// Returns false (and fills error) if the file cannot be streamed (it is not
+		// a DDS with a full mip chain in a supported format). It must be loaded as
+		// usual in that case.
+		bool AddTexture(const char* filepath, size_t& id, std::string& error);
+
+		ID3D11ShaderResourceView* ShaderResourceView(const size_t id) const;
+
+		// screenFraction is the fraction of the screen height covered by one texture repeat
+		void Request(const size_t id, const float screenFraction);
+
+		void Update();
+
+		// Incremented each time some view changes
+		unsigned int ViewsVersion() const { return mViewsVersion; }
+		size_t ResidentBytes() const { return mScheduler.ResidentBytes(); }
+		size_t BudgetBytes() const { return mScheduler.BudgetBytes(); }
+
+		// Loads that failed (their textures keep their levels), and the error of the
+		// last one. They are recorded by Update().
+		size_t NumFailedLoads() const { return mNumFailedLoads; }
+		const std::string& LastLoadError() const { return mLastLoadError; }
+
+	private:
+		struct Texture {
+			std::string mFilepath;
+			DdsTextureInfo mInfo;
+			ID3D11Texture2D* mTexture;
+			ID3D11ShaderResourceView* mSRV;
+			unsigned int mTopMip;
+		};
+
+		struct Load {
+			size_t mTexture;
+			unsigned int mTopMip;
+			// Copied, so the loading thread does not touch mTextures
+			std::string mFilepath;
+			DdsTextureInfo mInfo;
+			// Filled by the loading thread. Null if it failed, and error tells why.
+			ID3D11Texture2D* mResource;
+			ID3D11ShaderResourceView* mSRV;
+			std::string mError;
+		};
+
+		void LoadThread();
+		// data has levels [topMip, info.mNumMips), as read by DdsMipReader::ReadMips()
+		bool CreateTexture(const DdsTextureInfo& info, const unsigned int topMip, const std::vector<std::uint8_t>& data, ID3D11Texture2D* *texture, ID3D11ShaderResourceView* *view);
+		void Evict(Texture& texture, const unsigned int topMip);
+
+		ID3D11Device1& mDevice;
+		ID3D11DeviceContext1& mContext;
+		const float mScreenHeight;
+		const unsigned int mTailDimension;
+
+		TextureStreamingScheduler mScheduler;
+		std::vector<TextureStreamingScheduler::Decision> mDecisions;
+
+		// Indexed by scheduler texture
+		std::vector<Texture> mTextures;
+		typedef std::unordered_map<size_t, size_t> TextureIdByPath;
+		TextureIdByPath mTextureIdByPath;
+
+		unsigned int mViewsVersion = 0U;
+		size_t mNumFailedLoads = 0U;
+		std::string mLastLoadError;
+
+		// Shared with the loading thread
+		std::mutex mMutex;
+		std::condition_variable mCondition;
+		std::deque<Load> mPendingLoads;
+		std::vector<Load> mFinishedLoads;
+		bool mExit = false;
+
+		std::vector<Load> mLoadsToApply;
+		std::thread mThread;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,115 @@
+#include "VirtualFileSystem.h"
+
+#include <fstream>
+
+#include <utils/Assert.h>
+
+namespace {
+	// Content paths use '\\' separators, which only Windows accepts
+	std::string LoosePath(const std::string& filepath) {
+#ifdef _WIN32
+		return filepath;
+#else
+		std::string path(filepath);
+		for (char& c : path) {
+			if (c == '\\') {
+				c = '/';
+			}
+		}
+		return path;
+#endif
+	}
+
+	bool LooseFileSize(std::ifstream& file, size_t& size) {
+		file.seekg(0, std::ios::end);
+		const std::streamoff end = file.tellg();
+		if (end < 0) {
+			return false;
+		}
+		size = static_cast<size_t>(end);
+		return true;
+	}
+}
+
+namespace BRE {
+	VirtualFileSystem* VirtualFileSystem::gInstance = nullptr;
+
+	bool VirtualFileSystem::Mount(const std::string& packFilepath, std::string& error) {
+		std::unique_ptr<ContentPack> pack(new ContentPack());
+		if (!pack->Open(LoosePath(packFilepath), error)) {
+			return false;
+		}
+		mPacks.push_back(std::move(pack));
+		return true;
+	}
+
+	bool VirtualFileSystem::Exists(const std::string& filepath) const {
+		const ContentPack* pack;
+		size_t entry;
+		return Find(filepath, pack, entry) || std::ifstream(LoosePath(filepath)).good();
+	}
+
+	bool VirtualFileSystem::FileSize(const std::string& filepath, size_t& size) const {
+		const ContentPack* pack;
+		size_t entry;
+		if (Find(filepath, pack, entry)) {
+			size = static_cast<size_t>(pack->GetEntry(entry).mSize);
+			return true;
+		}
+		std::ifstream file(LoosePath(filepath), std::ios::binary);
+		return file && LooseFileSize(file, size);
+	}
+
+	bool VirtualFileSystem::ReadFile(const std::string& filepath, std::vector<std::uint8_t>& data) const {
+		const ContentPack* pack;
+		size_t entry;
+		if (Find(filepath, pack, entry)) {
+			data.resize(static_cast<size_t>(pack->GetEntry(entry).mSize));
+			return pack->Read(entry, 0U, data.size(), data.data());
+		}
+
+		std::ifstream file(LoosePath(filepath), std::ios::binary);
+		size_t size;
+		if (!file || !LooseFileSize(file, size)) {
+			return false;
+		}
+		data.resize(size);
+		file.seekg(0, std::ios::beg);
+		return size == 0U || file.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(size));
+	}
+
+	bool VirtualFileSystem::ReadRange(const std::string& filepath, const size_t offset, const size_t size, std::uint8_t* data) const {
+		const ContentPack* pack;
+		size_t entry;
+		if (Find(filepath, pack, entry)) {
+			return pack->Read(entry, offset, size, data);
+		}
+
+		std::ifstream file(LoosePath(filepath), std::ios::binary);
+		if (!file) {
+			return false;
+		}
+		file.seekg(static_cast<std::streamoff>(offset));
+		return size == 0U || file.read(reinterpret_cast<char*>(data), static_cast<std::streamsize>(size));
+	}
+
+	const std::uint8_t* VirtualFileSystem::MappedData(const std::string& filepath, size_t& size) const {
+		const ContentPack* pack;
+		size_t entry;
+		if (!Find(filepath, pack, entry)) {
+			return nullptr;
+		}
+		size = static_cast<size_t>(pack->GetEntry(entry).mSize);
+		return pack->EntryData(entry);
+	}
+
+	bool VirtualFileSystem::Find(const std::string& filepath, const ContentPack* &pack, size_t& entry) const {
+		for (auto it = mPacks.rbegin(); it != mPacks.rend(); ++it) {
+			if ((*it)->Find(filepath, entry)) {
+				pack = it->get();
+				return true;
+			}
+		}
+		return false;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <streaming/ContentPack.h>
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Resolves content paths through mounted content packs (see ContentPack)
+// and falls back to loose files for paths that are in no pack. Packs
+// mounted later hide the entries of packs mounted before.
+// Packs must be mounted before any read. After that, reads do not change
+// it, so loaders can use it from their own threads.
+//
+//////////////////////////////////////////////////////////////////////////
+
+namespace BRE {
+	class VirtualFileSystem {
+	public:
+		static VirtualFileSystem* gInstance;
+
+		VirtualFileSystem() = default;
+		const VirtualFileSystem& operator=(const VirtualFileSystem& rhs) = delete;
+
+		// On failure, error is filled and false is returned
+		bool Mount(const std::string& packFilepath, std::string& error);
+		size_t NumPacks() const { return mPacks.size(); }
+
+		bool Exists(const std::string& filepath) const;
+		bool FileSize(const std::string& filepath, size_t& size) const;
+
+		bool ReadFile(const std::string& filepath, std::vector<std::uint8_t>& data) const;
+		// Reads bytes [offset, offset + size) of the file
+		bool ReadRange(const std::string& filepath, const size_t offset, const size_t size, std::uint8_t* data) const;
+
+		// Memory of an uncompressed pack entry (no copy), valid while the file system
+		// exists. It returns null for compressed entries and loose files (use ReadFile()).
+		const std::uint8_t* MappedData(const std::string& filepath, size_t& size) const;
+
+	private:
+		bool Find(const std::string& filepath, const ContentPack* &pack, size_t& entry) const;
+
+		std::vector<std::unique_ptr<ContentPack>> mPacks;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,643 @@
+#include "BoundingVolumeHierarchy.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+#include <general/JobSystem.h>
+#include <general/Profiler.h>
+#include <utils/Assert.h>
+
+using namespace DirectX;
+
+namespace {
+	typedef BRE::BoundingVolumeHierarchy::Aabb Aabb;
+
+	const std::uint32_t sNoNode = static_cast<std::uint32_t>(-1);
+	// Bins per axis of the surface area heuristic
+	const size_t sNumBins = 16U;
+	// Children with less objects are built in parallel once the top of the tree is built
+	const std::uint32_t sParallelBuildObjects = 4096U;
+	// Refit() refits all nodes when more than 1 / sRefitSweepRatio of them are dirty
+	const size_t sRefitSweepRatio = 8U;
+	// Traversal stack capacity reserved by queries
+	const size_t sStackReserve = 64U;
+
+	float Component(const XMFLOAT3& vector, const size_t axis) {
+		return (&vector.x)[axis];
+	}
+
+	float& Lane(XMFLOAT4& vector, const size_t lane) {
+		return (&vector.x)[lane];
+	}
+
+	float Lane(const XMFLOAT4& vector, const size_t lane) {
+		return (&vector.x)[lane];
+	}
+
+	Aabb EmptyAabb() {
+		Aabb aabb;
+		aabb.mMin = XMFLOAT3(FLT_MAX, FLT_MAX, FLT_MAX);
+		aabb.mMax = XMFLOAT3(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+		return aabb;
+	}
+
+	void Grow(Aabb& aabb, const Aabb& other) {
+		aabb.mMin.x = (std::min)(aabb.mMin.x, other.mMin.x);
+		aabb.mMin.y = (std::min)(aabb.mMin.y, other.mMin.y);
+		aabb.mMin.z = (std::min)(aabb.mMin.z, other.mMin.z);
+		aabb.mMax.x = (std::max)(aabb.mMax.x, other.mMax.x);
+		aabb.mMax.y = (std::max)(aabb.mMax.y, other.mMax.y);
+		aabb.mMax.z = (std::max)(aabb.mMax.z, other.mMax.z);
+	}
+
+	// Half the surface area, as the heuristic only compares them
+	float HalfArea(const Aabb& aabb) {
+		const float x = aabb.mMax.x - aabb.mMin.x;
+		const float y = aabb.mMax.y - aabb.mMin.y;
+		const float z = aabb.mMax.z - aabb.mMin.z;
+		return x * y + y * z + z * x;
+	}
+
+	// Bit of each lane set in the control vector (lanes are all ones or all zeros)
+	unsigned int LaneMask(FXMVECTOR control) {
+		std::uint32_t lanes[4];
+		XMStoreInt4(lanes, control);
+		return (lanes[0] & 1U) | (lanes[1] & 2U) | (lanes[2] & 4U) | (lanes[3] & 8U);
+	}
+
+	// Plane (xyz normal pointing inside, w distance) of each side of a view projection frustum
+	void FrustumPlanes(const XMMATRIX& viewProj, XMFLOAT4 planes[6]) {
+		XMFLOAT4X4 m;
+		XMStoreFloat4x4(&m, viewProj);
+		planes[0] = XMFLOAT4(m._14 + m._11, m._24 + m._21, m._34 + m._31, m._44 + m._41);
+		planes[1] = XMFLOAT4(m._14 - m._11, m._24 - m._21, m._34 - m._31, m._44 - m._41);
+		planes[2] = XMFLOAT4(m._14 + m._12, m._24 + m._22, m._34 + m._32, m._44 + m._42);
+		planes[3] = XMFLOAT4(m._14 - m._12, m._24 - m._22, m._34 - m._32, m._44 - m._42);
+		planes[4] = XMFLOAT4(m._13, m._23, m._33, m._43);
+		planes[5] = XMFLOAT4(m._14 - m._13, m._24 - m._23, m._34 - m._33, m._44 - m._43);
+	}
+}
+
+namespace BRE {
+	class BoundingVolumeHierarchy::Builder {
+	public:
+		// Subtree built apart and appended later to the nodes array
+		struct Subtree {
+			std::uint32_t mBegin;
+			std::uint32_t mEnd;
+			std::uint32_t mParent;
+			std::uint32_t mLane;
+			std::vector<Node> mNodes;
+		};
+
+		explicit Builder(const std::vector<Aabb>& bounds);
+
+		// Builds the node of the objects range and its descendants. If subtrees is not null,
+		// children with less than sParallelBuildObjects objects are left to be built apart.
+		// Ranges must not overlap those built concurrently.
+		std::uint32_t BuildNode(const std::uint32_t begin, const std::uint32_t end, std::vector<Node>& nodes, std::vector<Subtree>* subtrees);
+		// Object ids in tree order
+		void Objects(std::vector<std::uint32_t>& objects) const;
+
+	private:
+		// Partitions the range in two non empty ranges. Returns the end of the first one.
+		std::uint32_t Split(const std::uint32_t begin, const std::uint32_t end);
+		Aabb RangeBounds(const std::uint32_t begin, const std::uint32_t end) const;
+
+		// Objects are partitioned with their bounds, so ranges are read sequentially
+		struct Entry {
+			Aabb mBounds;
+			XMFLOAT3 mCentroid;
+			std::uint32_t mObject;
+		};
+
+		std::vector<Entry> mEntries;
+	};
+
+	BoundingVolumeHierarchy::Builder::Builder(const std::vector<Aabb>& bounds)
+		: mEntries(bounds.size())
+	{
+		for (size_t i = 0U; i < bounds.size(); ++i) {
+			Entry& entry = mEntries[i];
+			entry.mBounds = bounds[i];
+			entry.mCentroid = XMFLOAT3((bounds[i].mMin.x + bounds[i].mMax.x) * 0.5f, (bounds[i].mMin.y + bounds[i].mMax.y) * 0.5f, (bounds[i].mMin.z + bounds[i].mMax.z) * 0.5f);
+			entry.mObject = static_cast<std::uint32_t>(i);
+		}
+	}
+
+	void BoundingVolumeHierarchy::Builder::Objects(std::vector<std::uint32_t>& objects) const {
+		objects.resize(mEntries.size());
+		for (size_t i = 0U; i < mEntries.size(); ++i) {
+			objects[i] = mEntries[i].mObject;
+		}
+	}
+
+	std::uint32_t BoundingVolumeHierarchy::Builder::BuildNode(const std::uint32_t begin, const std::uint32_t end, std::vector<Node>& nodes, std::vector<Subtree>* subtrees) {
+		BRE_ASSERT(begin < end);
+		const std::uint32_t nodeIndex = static_cast<std::uint32_t>(nodes.size());
+		Node node;
+		const Aabb empty = EmptyAabb();
+		node.mMinX = XMFLOAT4(empty.mMin.x, empty.mMin.x, empty.mMin.x, empty.mMin.x);
+		node.mMinY = node.mMinX;
+		node.mMinZ = node.mMinX;
+		node.mMaxX = XMFLOAT4(empty.mMax.x, empty.mMax.x, empty.mMax.x, empty.mMax.x);
+		node.mMaxY = node.mMaxX;
+		node.mMaxZ = node.mMaxX;
+		for (size_t lane = 0U; lane < 4U; ++lane) {
+			node.mFirst[lane] = 0U;
+			node.mCount[lane] = 0U;
+			node.mChild[lane] = sNoNode;
+		}
+
+		// The largest range is split until there is one per child
+		std::uint32_t ranges[4][2] = { { begin, end } };
+		size_t numRanges = 1U;
+		while (numRanges < 4U) {
+			size_t largest = 0U;
+			for (size_t i = 1U; i < numRanges; ++i) {
+				if (ranges[i][1] - ranges[i][0] > ranges[largest][1] - ranges[largest][0]) {
+					largest = i;
+				}
+			}
+			if (ranges[largest][1] - ranges[largest][0] <= sMaxLeafObjects) {
+				break;
+			}
+			const std::uint32_t middle = Split(ranges[largest][0], ranges[largest][1]);
+			ranges[numRanges][0] = middle;
+			ranges[numRanges][1] = ranges[largest][1];
+			ranges[largest][1] = middle;
+			++numRanges;
+		}
+
+		for (size_t lane = 0U; lane < numRanges; ++lane) {
+			const Aabb aabb = RangeBounds(ranges[lane][0], ranges[lane][1]);
+			Lane(node.mMinX, lane) = aabb.mMin.x;
+			Lane(node.mMinY, lane) = aabb.mMin.y;
+			Lane(node.mMinZ, lane) = aabb.mMin.z;
+			Lane(node.mMaxX, lane) = aabb.mMax.x;
+			Lane(node.mMaxY, lane) = aabb.mMax.y;
+			Lane(node.mMaxZ, lane) = aabb.mMax.z;
+			node.mFirst[lane] = ranges[lane][0];
+			node.mCount[lane] = ranges[lane][1] - ranges[lane][0];
+		}
+		nodes.push_back(node);
+
+		for (std::uint32_t lane = 0U; lane < numRanges; ++lane) {
+			const std::uint32_t count = ranges[lane][1] - ranges[lane][0];
+			if (count <= sMaxLeafObjects) {
+				continue;
+			}
+			if (subtrees && count < sParallelBuildObjects) {
+				Subtree subtree;
+				subtree.mBegin = ranges[lane][0];
+				subtree.mEnd = ranges[lane][1];
+				subtree.mParent = nodeIndex;
+				subtree.mLane = lane;
+				subtrees->push_back(subtree);
+			}
+			else {
+				// nodes can grow, so the node is not kept by reference
+				const std::uint32_t child = BuildNode(ranges[lane][0], ranges[lane][1], nodes, subtrees);
+				nodes[nodeIndex].mChild[lane] = child;
+			}
+		}
+		return nodeIndex;
+	}
+
+	std::uint32_t BoundingVolumeHierarchy::Builder::Split(const std::uint32_t begin, const std::uint32_t end) {
+		BRE_ASSERT(end - begin > 1U);
+		XMFLOAT3 centroidMin = mEntries[begin].mCentroid;
+		XMFLOAT3 centroidMax = centroidMin;
+		for (std::uint32_t i = begin + 1U; i < end; ++i) {
+			const XMFLOAT3& centroid = mEntries[i].mCentroid;
+			centroidMin = XMFLOAT3((std::min)(centroidMin.x, centroid.x), (std::min)(centroidMin.y, centroid.y), (std::min)(centroidMin.z, centroid.z));
+			centroidMax = XMFLOAT3((std::max)(centroidMax.x, centroid.x), (std::max)(centroidMax.y, centroid.y), (std::max)(centroidMax.z, centroid.z));
+		}
+
+		float bestCost = FLT_MAX;
+		size_t bestAxis = 3U;
+		size_t bestBin = 0U;
+		// Objects are binned along the three axes in one pass over them
+		float origins[3];
+		float scales[3];
+		bool splittable[3];
+		Aabb binBounds[3][sNumBins];
+		std::uint32_t binCounts[3][sNumBins];
+		for (size_t axis = 0U; axis < 3U; ++axis) {
+			origins[axis] = Component(centroidMin, axis);
+			const float extent = Component(centroidMax, axis) - origins[axis];
+			scales[axis] = static_cast<float>(sNumBins) / extent;
+			splittable[axis] = extent > 0.0f && scales[axis] < FLT_MAX;
+			if (!splittable[axis]) {
+				scales[axis] = 0.0f;
+			}
+			for (size_t bin = 0U; bin < sNumBins; ++bin) {
+				binBounds[axis][bin] = EmptyAabb();
+				binCounts[axis][bin] = 0U;
+			}
+		}
+		for (std::uint32_t i = begin; i < end; ++i) {
+			const Entry& entry = mEntries[i];
+			for (size_t axis = 0U; axis < 3U; ++axis) {
+				const size_t bin = (std::min)(static_cast<size_t>((Component(entry.mCentroid, axis) - origins[axis]) * scales[axis]), sNumBins - 1U);
+				Grow(binBounds[axis][bin], entry.mBounds);
+				++binCounts[axis][bin];
+			}
+		}
+
+		for (size_t axis = 0U; axis < 3U; ++axis) {
+			if (!splittable[axis]) {
+				continue;
+			}
+			// Cost of the objects of bins [bin, sNumBins)
+			float rightCosts[sNumBins];
+			Aabb bounds = EmptyAabb();
+			std::uint32_t count = 0U;
+			for (size_t bin = sNumBins - 1U; bin > 0U; --bin) {
+				Grow(bounds, binBounds[axis][bin]);
+				count += binCounts[axis][bin];
+				rightCosts[bin] = count > 0U ? count * HalfArea(bounds) : -1.0f;
+			}
+			bounds = EmptyAabb();
+			count = 0U;
+			for (size_t bin = 1U; bin < sNumBins; ++bin) {
+				Grow(bounds, binBounds[axis][bin - 1U]);
+				count += binCounts[axis][bin - 1U];
+				if (count > 0U && rightCosts[bin] >= 0.0f) {
+					const float cost = count * HalfArea(bounds) + rightCosts[bin];
+					if (cost < bestCost) {
+						bestCost = cost;
+						bestAxis = axis;
+						bestBin = bin;
+					}
+				}
+			}
+		}
+
+		if (bestAxis < 3U) {
+			const std::vector<Entry>::iterator middle = std::partition(mEntries.begin() + begin, mEntries.begin() + end, [bestAxis, bestBin, &origins, &scales](const Entry& entry) {
+				return (std::min)(static_cast<size_t>((Component(entry.mCentroid, bestAxis) - origins[bestAxis]) * scales[bestAxis]), sNumBins - 1U) < bestBin;
+			});
+			const std::uint32_t middleIndex = static_cast<std::uint32_t>(middle - mEntries.begin());
+			if (middleIndex > begin && middleIndex < end) {
+				return middleIndex;
+			}
+		}
+		// All centroids are at the same point
+		return begin + (end - begin) / 2U;
+	}
+
+	Aabb BoundingVolumeHierarchy::Builder::RangeBounds(const std::uint32_t begin, const std::uint32_t end) const {
+		Aabb aabb = EmptyAabb();
+		for (std::uint32_t i = begin; i < end; ++i) {
+			Grow(aabb, mEntries[i].mBounds);
+		}
+		return aabb;
+	}
+
+	BoundingVolumeHierarchy::Aabb BoundingVolumeHierarchy::SphereBounds(const XMFLOAT4& sphere) {
+		Aabb aabb;
+		aabb.mMin = XMFLOAT3(sphere.x - sphere.w, sphere.y - sphere.w, sphere.z - sphere.w);
+		aabb.mMax = XMFLOAT3(sphere.x + sphere.w, sphere.y + sphere.w, sphere.z + sphere.w);
+		return aabb;
+	}
+
+	void BoundingVolumeHierarchy::Build(const std::vector<Aabb>& bounds) {
+		BRE_PROFILE_SCOPE("BoundingVolumeHierarchy::Build");
+		BRE_ASSERT(bounds.size() < sNoNode);
+		const std::uint32_t numObjects = static_cast<std::uint32_t>(bounds.size());
+		mNodes.clear();
+		mObjects.clear();
+		mDirtyNodes.clear();
+
+		if (numObjects > 0U) {
+			Builder builder(bounds);
+			std::vector<Builder::Subtree> subtrees;
+			builder.BuildNode(0U, numObjects, mNodes, &subtrees);
+			const auto buildSubtrees = [&builder, &subtrees](const size_t begin, const size_t end) {
+				for (size_t i = begin; i < end; ++i) {
+					builder.BuildNode(subtrees[i].mBegin, subtrees[i].mEnd, subtrees[i].mNodes, nullptr);
+				}
+			};
+			if (JobSystem::gInstance && subtrees.size() > 1U) {
+				JobSystem::gInstance->ParallelFor(0U, subtrees.size(), 1U, buildSubtrees, "BoundingVolumeHierarchy::BuildSubtrees");
+			}
+			else {
+				buildSubtrees(0U, subtrees.size());
+			}
+
+			// Subtree roots are their first node
+			for (Builder::Subtree& subtree : subtrees) {
+				const std::uint32_t offset = static_cast<std::uint32_t>(mNodes.size());
+				for (Node& node : subtree.mNodes) {
+					for (size_t lane = 0U; lane < 4U; ++lane) {
+						if (node.mCount[lane] > sMaxLeafObjects) {
+							node.mChild[lane] += offset;
+						}
+					}
+					mNodes.push_back(node);
+				}
+				mNodes[subtree.mParent].mChild[subtree.mLane] = offset;
+			}
+			builder.Objects(mObjects);
+		}
+
+		const std::uint32_t numNodes = static_cast<std::uint32_t>(mNodes.size());
+		mObjectBounds.resize(numObjects);
+		mSlotByObject.resize(numObjects);
+		mNodeByObject.resize(numObjects);
+		for (std::uint32_t slot = 0U; slot < numObjects; ++slot) {
+			mObjectBounds[slot] = bounds[mObjects[slot]];
+			mSlotByObject[mObjects[slot]] = slot;
+		}
+		mParents.assign(numNodes, sNoNode);
+		for (std::uint32_t nodeIndex = 0U; nodeIndex < numNodes; ++nodeIndex) {
+			const Node& node = mNodes[nodeIndex];
+			for (size_t lane = 0U; lane < 4U; ++lane) {
+				if (node.mCount[lane] > sMaxLeafObjects) {
+					BRE_ASSERT(node.mChild[lane] > nodeIndex && node.mChild[lane] < numNodes);
+					mParents[node.mChild[lane]] = nodeIndex;
+				}
+				else {
+					for (std::uint32_t slot = node.mFirst[lane]; slot < node.mFirst[lane] + node.mCount[lane]; ++slot) {
+						mNodeByObject[mObjects[slot]] = nodeIndex;
+					}
+				}
+			}
+		}
+		mDirty.assign(numNodes, 0U);
+	}
+
+	const BoundingVolumeHierarchy::Aabb& BoundingVolumeHierarchy::Bounds(const size_t object) const {
+		BRE_ASSERT(object < NumObjects());
+		return mObjectBounds[mSlotByObject[object]];
+	}
+
+	void BoundingVolumeHierarchy::SetBounds(const size_t object, const Aabb& bounds) {
+		BRE_ASSERT(object < NumObjects());
+		mObjectBounds[mSlotByObject[object]] = bounds;
+		const std::uint32_t node = mNodeByObject[object];
+		if (mDirty[node] == 0U) {
+			mDirty[node] = 1U;
+			mDirtyNodes.push_back(node);
+		}
+	}
+
+	void BoundingVolumeHierarchy::Refit() {
+		BRE_PROFILE_SCOPE("BoundingVolumeHierarchy::Refit");
+		if (mDirtyNodes.size() * sRefitSweepRatio > mNodes.size()) {
+			// Most ancestors are dirty too, so all nodes are refitted, children first
+			for (size_t node = mNodes.size(); node > 0U; --node) {
+				RefitNode(static_cast<std::uint32_t>(node - 1U));
+			}
+			std::fill(mDirty.begin(), mDirty.end(), static_cast<std::uint8_t>(0U));
+			mDirtyNodes.clear();
+			return;
+		}
+
+		// Children are after their parents, so the highest node index is refitted first
+		std::make_heap(mDirtyNodes.begin(), mDirtyNodes.end());
+		while (!mDirtyNodes.empty()) {
+			std::pop_heap(mDirtyNodes.begin(), mDirtyNodes.end());
+			const std::uint32_t node = mDirtyNodes.back();
+			mDirtyNodes.pop_back();
+			RefitNode(node);
+			mDirty[node] = 0U;
+			const std::uint32_t parent = mParents[node];
+			if (parent != sNoNode && mDirty[parent] == 0U) {
+				mDirty[parent] = 1U;
+				mDirtyNodes.push_back(parent);
+				std::push_heap(mDirtyNodes.begin(), mDirtyNodes.end());
+			}
+		}
+	}
+
+	void BoundingVolumeHierarchy::RefitNode(const std::uint32_t nodeIndex) {
+		Node& node = mNodes[nodeIndex];
+		for (size_t lane = 0U; lane < 4U; ++lane) {
+			const std::uint32_t count = node.mCount[lane];
+			if (count == 0U) {
+				continue;
+			}
+			Aabb aabb;
+			if (count > sMaxLeafObjects) {
+				aabb = NodeBounds(node.mChild[lane]);
+			}
+			else {
+				aabb = EmptyAabb();
+				for (std::uint32_t slot = node.mFirst[lane]; slot < node.mFirst[lane] + count; ++slot) {
+					Grow(aabb, mObjectBounds[slot]);
+				}
+			}
+			Lane(node.mMinX, lane) = aabb.mMin.x;
+			Lane(node.mMinY, lane) = aabb.mMin.y;
+			Lane(node.mMinZ, lane) = aabb.mMin.z;
+			Lane(node.mMaxX, lane) = aabb.mMax.x;
+			Lane(node.mMaxY, lane) = aabb.mMax.y;
+			Lane(node.mMaxZ, lane) = aabb.mMax.z;
+		}
+	}
+
+	BoundingVolumeHierarchy::Aabb BoundingVolumeHierarchy::NodeBounds(const std::uint32_t nodeIndex) const {
+		const Node& node = mNodes[nodeIndex];
+		Aabb aabb = EmptyAabb();
+		for (size_t lane = 0U; lane < 4U; ++lane) {
+			if (node.mCount[lane] > 0U) {
+				Aabb laneBounds;
+				laneBounds.mMin = XMFLOAT3(Lane(node.mMinX, lane), Lane(node.mMinY, lane), Lane(node.mMinZ, lane));
+				laneBounds.mMax = XMFLOAT3(Lane(node.mMaxX, lane), Lane(node.mMaxY, lane), Lane(node.mMaxZ, lane));
+				Grow(aabb, laneBounds);
+			}
+		}
+		return aabb;
+	}
+
+	template<typename NodeTest, typename ObjectTest>
+	void BoundingVolumeHierarchy::Query(const NodeTest& nodeTest, const ObjectTest& objectTest, std::vector<std::uint32_t>& objects) const {
+		if (mNodes.empty()) {
+			return;
+		}
+		std::vector<std::uint32_t> stack;
+		stack.reserve(sStackReserve);
+		stack.push_back(0U);
+		while (!stack.empty()) {
+			const Node& node = mNodes[stack.back()];
+			stack.pop_back();
+			unsigned int hitMask;
+			unsigned int insideMask;
+			nodeTest(node, hitMask, insideMask);
+			for (size_t lane = 0U; lane < 4U; ++lane) {
+				const std::uint32_t count = node.mCount[lane];
+				if ((hitMask & (1U << lane)) == 0U || count == 0U) {
+					continue;
+				}
+				const std::uint32_t first = node.mFirst[lane];
+				if ((insideMask & (1U << lane)) != 0U) {
+					objects.insert(objects.end(), mObjects.begin() + first, mObjects.begin() + first + count);
+				}
+				else if (count <= sMaxLeafObjects) {
+					for (std::uint32_t slot = first; slot < first + count; ++slot) {
+						if (objectTest(mObjectBounds[slot])) {
+							objects.push_back(mObjects[slot]);
+						}
+					}
+				}
+				else {
+					stack.push_back(node.mChild[lane]);
+				}
+			}
+		}
+	}
+
+	void BoundingVolumeHierarchy::QueryFrustum(const XMMATRIX& viewProj, std::vector<std::uint32_t>& objects) const {
+		XMFLOAT4 planes[6];
+		FrustumPlanes(viewProj, planes);
+		XMVECTOR planeVectors[6][4];
+		for (size_t i = 0U; i < 6U; ++i) {
+			planeVectors[i][0] = XMVectorReplicate(planes[i].x);
+			planeVectors[i][1] = XMVectorReplicate(planes[i].y);
+			planeVectors[i][2] = XMVectorReplicate(planes[i].z);
+			planeVectors[i][3] = XMVectorReplicate(planes[i].w);
+		}
+
+		// The corner of the box farthest along the plane normal is tested to know if
+		// it intersects, the nearest one to know if it is inside.
+		const auto nodeTest = [&planes, &planeVectors](const Node& node, unsigned int& hitMask, unsigned int& insideMask) {
+			const XMVECTOR minX = XMLoadFloat4(&node.mMinX);
+			const XMVECTOR minY = XMLoadFloat4(&node.mMinY);
+			const XMVECTOR minZ = XMLoadFloat4(&node.mMinZ);
+			const XMVECTOR maxX = XMLoadFloat4(&node.mMaxX);
+			const XMVECTOR maxY = XMLoadFloat4(&node.mMaxY);
+			const XMVECTOR maxZ = XMLoadFloat4(&node.mMaxZ);
+			const XMVECTOR zero = XMVectorZero();
+			XMVECTOR hit = XMVectorTrueInt();
+			XMVECTOR inside = XMVectorTrueInt();
+			for (size_t i = 0U; i < 6U; ++i) {
+				const XMVECTOR* plane = planeVectors[i];
+				XMVECTOR farthest = XMVectorMultiplyAdd(plane[0], planes[i].x >= 0.0f ? maxX : minX, plane[3]);
+				farthest = XMVectorMultiplyAdd(plane[1], planes[i].y >= 0.0f ? maxY : minY, farthest);
+				farthest = XMVectorMultiplyAdd(plane[2], planes[i].z >= 0.0f ? maxZ : minZ, farthest);
+				XMVECTOR nearest = XMVectorMultiplyAdd(plane[0], planes[i].x >= 0.0f ? minX : maxX, plane[3]);
+				nearest = XMVectorMultiplyAdd(plane[1], planes[i].y >= 0.0f ? minY : maxY, nearest);
+				nearest = XMVectorMultiplyAdd(plane[2], planes[i].z >= 0.0f ? minZ : maxZ, nearest);
+				hit = XMVectorAndInt(hit, XMVectorGreaterOrEqual(farthest, zero));
+				inside = XMVectorAndInt(inside, XMVectorGreaterOrEqual(nearest, zero));
+			}
+			hitMask = LaneMask(hit);
+			insideMask = LaneMask(inside);
+		};
+		const auto objectTest = [&planes](const Aabb& aabb) {
+			for (size_t i = 0U; i < 6U; ++i) {
+				const XMFLOAT4& plane = planes[i];
+				const float x = plane.x >= 0.0f ? aabb.mMax.x : aabb.mMin.x;
+				const float y = plane.y >= 0.0f ? aabb.mMax.y : aabb.mMin.y;
+				const float z = plane.z >= 0.0f ? aabb.mMax.z : aabb.mMin.z;
+				if (plane.x * x + plane.y * y + plane.z * z + plane.w < 0.0f) {
+					return false;
+				}
+			}
+			return true;
+		};
+		Query(nodeTest, objectTest, objects);
+	}
+
+	void BoundingVolumeHierarchy::QuerySphere(const XMFLOAT4& sphere, std::vector<std::uint32_t>& objects) const {
+		const XMVECTOR centerX = XMVectorReplicate(sphere.x);
+		const XMVECTOR centerY = XMVectorReplicate(sphere.y);
+		const XMVECTOR centerZ = XMVectorReplicate(sphere.z);
+		const XMVECTOR radiusSq = XMVectorReplicate(sphere.w * sphere.w);
+
+		// Squared distance from the center to the box
+		const auto nodeTest = [centerX, centerY, centerZ, radiusSq](const Node& node, unsigned int& hitMask, unsigned int& insideMask) {
+			const XMVECTOR zero = XMVectorZero();
+			const XMVECTOR x = XMVectorMax(XMVectorMax(XMVectorSubtract(XMLoadFloat4(&node.mMinX), centerX), XMVectorSubtract(centerX, XMLoadFloat4(&node.mMaxX))), zero);
+			const XMVECTOR y = XMVectorMax(XMVectorMax(XMVectorSubtract(XMLoadFloat4(&node.mMinY), centerY), XMVectorSubtract(centerY, XMLoadFloat4(&node.mMaxY))), zero);
+			const XMVECTOR z = XMVectorMax(XMVectorMax(XMVectorSubtract(XMLoadFloat4(&node.mMinZ), centerZ), XMVectorSubtract(centerZ, XMLoadFloat4(&node.mMaxZ))), zero);
+			const XMVECTOR distanceSq = XMVectorMultiplyAdd(x, x, XMVectorMultiplyAdd(y, y, XMVectorMultiply(z, z)));
+			hitMask = LaneMask(XMVectorLessOrEqual(distanceSq, radiusSq));
+			insideMask = 0U;
+		};
+		const auto objectTest = [&sphere](const Aabb& aabb) {
+			const float x = (std::max)((std::max)(aabb.mMin.x - sphere.x, sphere.x - aabb.mMax.x), 0.0f);
+			const float y = (std::max)((std::max)(aabb.mMin.y - sphere.y, sphere.y - aabb.mMax.y), 0.0f);
+			const float z = (std::max)((std::max)(aabb.mMin.z - sphere.z, sphere.z - aabb.mMax.z), 0.0f);
+			return x * x + y * y + z * z <= sphere.w * sphere.w;
+		};
+		Query(nodeTest, objectTest, objects);
+	}
+
+	void BoundingVolumeHierarchy::QueryAabb(const Aabb& aabb, std::vector<std::uint32_t>& objects) const {
+		const XMVECTOR minX = XMVectorReplicate(aabb.mMin.x);
+		const XMVECTOR minY = XMVectorReplicate(aabb.mMin.y);
+		const XMVECTOR minZ = XMVectorReplicate(aabb.mMin.z);
+		const XMVECTOR maxX = XMVectorReplicate(aabb.mMax.x);
+		const XMVECTOR maxY = XMVectorReplicate(aabb.mMax.y);
+		const XMVECTOR maxZ = XMVectorReplicate(aabb.mMax.z);
+
+		const auto nodeTest = [minX, minY, minZ, maxX, maxY, maxZ](const Node& node, unsigned int& hitMask, unsigned int& insideMask) {
+			const XMVECTOR nodeMinX = XMLoadFloat4(&node.mMinX);
+			const XMVECTOR nodeMinY = XMLoadFloat4(&node.mMinY);
+			const XMVECTOR nodeMinZ = XMLoadFloat4(&node.mMinZ);
+			const XMVECTOR nodeMaxX = XMLoadFloat4(&node.mMaxX);
+			const XMVECTOR nodeMaxY = XMLoadFloat4(&node.mMaxY);
+			const XMVECTOR nodeMaxZ = XMLoadFloat4(&node.mMaxZ);
+			XMVECTOR hit = XMVectorAndInt(XMVectorLessOrEqual(nodeMinX, maxX), XMVectorGreaterOrEqual(nodeMaxX, minX));
+			hit = XMVectorAndInt(hit, XMVectorAndInt(XMVectorLessOrEqual(nodeMinY, maxY), XMVectorGreaterOrEqual(nodeMaxY, minY)));
+			hit = XMVectorAndInt(hit, XMVectorAndInt(XMVectorLessOrEqual(nodeMinZ, maxZ), XMVectorGreaterOrEqual(nodeMaxZ, minZ)));
+			XMVECTOR inside = XMVectorAndInt(XMVectorGreaterOrEqual(nodeMinX, minX), XMVectorLessOrEqual(nodeMaxX, maxX));
+			inside = XMVectorAndInt(inside, XMVectorAndInt(XMVectorGreaterOrEqual(nodeMinY, minY), XMVectorLessOrEqual(nodeMaxY, maxY)));
+			inside = XMVectorAndInt(inside, XMVectorAndInt(XMVectorGreaterOrEqual(nodeMinZ, minZ), XMVectorLessOrEqual(nodeMaxZ, maxZ)));
+			hitMask = LaneMask(hit);
+			insideMask = LaneMask(inside);
+		};
+		const auto objectTest = [&aabb](const Aabb& objectAabb) {
+			return objectAabb.mMin.x <= aabb.mMax.x && objectAabb.mMax.x >= aabb.mMin.x
+				&& objectAabb.mMin.y <= aabb.mMax.y && objectAabb.mMax.y >= aabb.mMin.y
+				&& objectAabb.mMin.z <= aabb.mMax.z && objectAabb.mMax.z >= aabb.mMin.z;
+		};
+		Query(nodeTest, objectTest, objects);
+	}
+
+	void BoundingVolumeHierarchy::QueryRay(const XMFLOAT3& origin, const XMFLOAT3& direction, const float maxDistance, std::vector<std::uint32_t>& objects) const {
+		// Tiny direction components instead of zeros keep slab distances finite (no 0 * infinity)
+		float inverseDirection[3];
+		for (size_t axis = 0U; axis < 3U; ++axis) {
+			const float component = Component(direction, axis);
+			inverseDirection[axis] = 1.0f / (std::fabs(component) > 1e-30f ? component : (component < 0.0f ? -1e-30f : 1e-30f));
+		}
+		const XMVECTOR originX = XMVectorReplicate(origin.x);
+		const XMVECTOR originY = XMVectorReplicate(origin.y);
+		const XMVECTOR originZ = XMVectorReplicate(origin.z);
+		const XMVECTOR inverseX = XMVectorReplicate(inverseDirection[0]);
+		const XMVECTOR inverseY = XMVectorReplicate(inverseDirection[1]);
+		const XMVECTOR inverseZ = XMVectorReplicate(inverseDirection[2]);
+		const XMVECTOR maxT = XMVectorReplicate(maxDistance);
+
+		// Distances along the ray to the slabs of each axis
+		const auto nodeTest = [originX, originY, originZ, inverseX, inverseY, inverseZ, maxT](const Node& node, unsigned int& hitMask, unsigned int& insideMask) {
+			const XMVECTOR x0 = XMVectorMultiply(XMVectorSubtract(XMLoadFloat4(&node.mMinX), originX), inverseX);
+			const XMVECTOR x1 = XMVectorMultiply(XMVectorSubtract(XMLoadFloat4(&node.mMaxX), originX), inverseX);
+			const XMVECTOR y0 = XMVectorMultiply(XMVectorSubtract(XMLoadFloat4(&node.mMinY), originY), inverseY);
+			const XMVECTOR y1 = XMVectorMultiply(XMVectorSubtract(XMLoadFloat4(&node.mMaxY), originY), inverseY);
+			const XMVECTOR z0 = XMVectorMultiply(XMVectorSubtract(XMLoadFloat4(&node.mMinZ), originZ), inverseZ);
+			const XMVECTOR z1 = XMVectorMultiply(XMVectorSubtract(XMLoadFloat4(&node.mMaxZ), originZ), inverseZ);
+			const XMVECTOR enter = XMVectorMax(XMVectorMax(XMVectorMin(x0, x1), XMVectorMin(y0, y1)), XMVectorMax(XMVectorMin(z0, z1), XMVectorZero()));
+			const XMVECTOR exit = XMVectorMin(XMVectorMin(XMVectorMax(x0, x1), XMVectorMax(y0, y1)), XMVectorMin(XMVectorMax(z0, z1), maxT));
+			hitMask = LaneMask(XMVectorLessOrEqual(enter, exit));
+			insideMask = 0U;
+		};
+		const auto objectTest = [&origin, &inverseDirection, maxDistance](const Aabb& aabb) {
+			float enter = 0.0f;
+			float exit = maxDistance;
+			for (size_t axis = 0U; axis < 3U; ++axis) {
+				const float t0 = (Component(aabb.mMin, axis) - Component(origin, axis)) * inverseDirection[axis];
+				const float t1 = (Component(aabb.mMax, axis) - Component(origin, axis)) * inverseDirection[axis];
+				enter = (std::max)(enter, (std::min)(t0, t1));
+				exit = (std::min)(exit, (std::max)(t0, t1));
+			}
+			return enter <= exit;
+		};
+		Query(nodeTest, objectTest, objects);
+	}
+}
\ No newline at end of file
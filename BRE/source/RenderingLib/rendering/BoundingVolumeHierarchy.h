@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstdint>
+#include <DirectXMath.h>
+#include <vector>
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Bounding volume hierarchy over axis aligned bounding boxes of objects
+// (object ids are their indices in the Build() vector).
+// Nodes have four children whose bounds are stored as structure of arrays,
+// so queries test the four of them at once with SIMD operations. Nodes are
+// in one array, parents before their children, and the objects of a child
+// are a contiguous range of mObjects.
+// Build() splits objects with a binned surface area heuristic. Subtrees of
+// the lower levels are built in parallel (JobSystem).
+// Objects that move are refitted: SetBounds() then Refit() updates the
+// bounds of their ancestors without changing the tree, so it degrades if
+// objects move far from where they were built.
+// Queries append (unordered) the objects whose bounds intersect the volume.
+// Objects of children fully inside a frustum are appended without further
+// tests.
+//
+//////////////////////////////////////////////////////////////////////////
+
+namespace BRE {
+	class BoundingVolumeHierarchy {
+	public:
+		struct Aabb {
+			DirectX::XMFLOAT3 mMin;
+			DirectX::XMFLOAT3 mMax;
+		};
+
+		// Children with up to this number of objects are leaves
+		static const std::uint32_t sMaxLeafObjects = 4U;
+
+		// Bounds of the sphere (center in xyz, radius in w)
+		static Aabb SphereBounds(const DirectX::XMFLOAT4& sphere);
+
+		void Build(const std::vector<Aabb>& bounds);
+		size_t NumObjects() const { return mObjects.size(); }
+		size_t NumNodes() const { return mNodes.size(); }
+
+		const Aabb& Bounds(const size_t object) const;
+		void SetBounds(const size_t object, const Aabb& bounds);
+		// Updates bounds of the nodes of objects set since the last call and their ancestors
+		void Refit();
+
+		// Frustum of the view projection matrix
+		void QueryFrustum(const DirectX::XMMATRIX& viewProj, std::vector<std::uint32_t>& objects) const;
+		// Center in xyz, radius in w
+		void QuerySphere(const DirectX::XMFLOAT4& sphere, std::vector<std::uint32_t>& objects) const;
+		void QueryAabb(const Aabb& aabb, std::vector<std::uint32_t>& objects) const;
+		// Objects hit by the ray before maxDistance (in direction length units)
+		void QueryRay(const DirectX::XMFLOAT3& origin, const DirectX::XMFLOAT3& direction, const float maxDistance, std::vector<std::uint32_t>& objects) const;
+
+	private:
+		struct Node {
+			// Bounds of the four children
+			DirectX::XMFLOAT4 mMinX;
+			DirectX::XMFLOAT4 mMinY;
+			DirectX::XMFLOAT4 mMinZ;
+			DirectX::XMFLOAT4 mMaxX;
+			DirectX::XMFLOAT4 mMaxY;
+			DirectX::XMFLOAT4 mMaxZ;
+			// Range of the objects of each child in mObjects. Count is 0 for empty children.
+			std::uint32_t mFirst[4];
+			std::uint32_t mCount[4];
+			// Node index of children that are not leaves
+			std::uint32_t mChild[4];
+		};
+
+		class Builder;
+
+		// NodeTest(node, hitMask, insideMask) sets lane bits of the children that
+		// intersect the volume and of those fully inside it. ObjectTest(aabb) tests
+		// objects of leaves.
+		template<typename NodeTest, typename ObjectTest>
+		void Query(const NodeTest& nodeTest, const ObjectTest& objectTest, std::vector<std::uint32_t>& objects) const;
+
+		void RefitNode(const std::uint32_t node);
+		Aabb NodeBounds(const std::uint32_t node) const;
+
+		std::vector<Node> mNodes;
+		// Object ids in tree order and their bounds
+		std::vector<std::uint32_t> mObjects;
+		std::vector<Aabb> mObjectBounds;
+		// By object id
+		std::vector<std::uint32_t> mSlotByObject;
+		std::vector<std::uint32_t> mNodeByObject;
+		// Parent node index of each node
+		std::vector<std::uint32_t> mParents;
+		// Nodes to refit
+		std::vector<std::uint32_t> mDirtyNodes;
+		std::vector<std::uint8_t> mDirty;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,125 @@
+#include "D3D11GpuQuerySource.h"
+
+#include <d3d11_1.h>
+
+#include <utils/Assert.h>
+
+namespace {
+	ID3D11Query* CreateQuery(ID3D11Device1& device, const D3D11_QUERY type) {
+		D3D11_QUERY_DESC desc;
+		desc.Query = type;
+		desc.MiscFlags = 0U;
+		ID3D11Query* query = nullptr;
+		ASSERT_HR(device.CreateQuery(&desc, &query));
+		BRE_ASSERT(query);
+		return query;
+	}
+
+	// S_FALSE means data is not available yet. DONOTFLUSH keeps GetData from touching the command buffer.
+	template<typename T>
+	bool GetQueryData(ID3D11DeviceContext1& context, ID3D11Query& query, T& data) {
+		return context.GetData(&query, &data, sizeof(T), D3D11_ASYNC_GETDATA_DONOTFLUSH) == S_OK;
+	}
+}
+
+namespace BRE {
+	D3D11GpuQuerySource::D3D11GpuQuerySource(ID3D11Device1& device, ID3D11DeviceContext1& context, const size_t maxSlots, const size_t maxPasses)
+		: mContext(context)
+		, mMaxPasses(maxPasses)
+		, mSlots(maxSlots)
+	{
+		BRE_ASSERT(maxSlots > 0U);
+		BRE_ASSERT(maxPasses > 0U);
+		for (SlotQueries& slot : mSlots) {
+			slot.mDisjoint = CreateQuery(device, D3D11_QUERY_TIMESTAMP_DISJOINT);
+			slot.mPasses.resize(maxPasses);
+			for (PassQueries& pass : slot.mPasses) {
+				pass.mBegin = CreateQuery(device, D3D11_QUERY_TIMESTAMP);
+				pass.mEnd = CreateQuery(device, D3D11_QUERY_TIMESTAMP);
+				pass.mStatistics = CreateQuery(device, D3D11_QUERY_PIPELINE_STATISTICS);
+			}
+		}
+	}
+
+	D3D11GpuQuerySource::~D3D11GpuQuerySource() {
+		for (SlotQueries& slot : mSlots) {
+			slot.mDisjoint->Release();
+			for (PassQueries& pass : slot.mPasses) {
+				pass.mBegin->Release();
+				pass.mEnd->Release();
+				pass.mStatistics->Release();
+			}
+		}
+	}
+
+	void D3D11GpuQuerySource::BeginFrame(const size_t slot) {
+		BRE_ASSERT(slot < mSlots.size());
+		mContext.Begin(mSlots[slot].mDisjoint);
+	}
+
+	void D3D11GpuQuerySource::EndFrame(const size_t slot) {
+		BRE_ASSERT(slot < mSlots.size());
+		mContext.End(mSlots[slot].mDisjoint);
+	}
+
+	void D3D11GpuQuerySource::BeginPass(const size_t slot, const size_t pass) {
+		BRE_ASSERT(slot < mSlots.size());
+		BRE_ASSERT(pass < mMaxPasses);
+		PassQueries& queries = mSlots[slot].mPasses[pass];
+		mContext.End(queries.mBegin);
+		mContext.Begin(queries.mStatistics);
+	}
+
+	void D3D11GpuQuerySource::EndPass(const size_t slot, const size_t pass) {
+		BRE_ASSERT(slot < mSlots.size());
+		BRE_ASSERT(pass < mMaxPasses);
+		PassQueries& queries = mSlots[slot].mPasses[pass];
+		mContext.End(queries.mStatistics);
+		mContext.End(queries.mEnd);
+	}
+
+	bool D3D11GpuQuerySource::ReadFrame(const size_t slot, const std::vector<bool>& recordedPasses, FrameData& frameData) {
+		BRE_ASSERT(slot < mSlots.size());
+		BRE_ASSERT(recordedPasses.size() <= mMaxPasses);
+		BRE_ASSERT(frameData.mPasses.size() >= recordedPasses.size());
+		SlotQueries& queries = mSlots[slot];
+
+		// Disjoint query ends after every other query of the slot, so check it first.
+		D3D11_QUERY_DATA_TIMESTAMP_DISJOINT disjointData;
+		if (!GetQueryData(mContext, *queries.mDisjoint, disjointData)) {
+			return false;
+		}
+
+		frameData.mFrequency = disjointData.Frequency;
+		frameData.mDisjoint = disjointData.Disjoint != FALSE;
+
+		for (size_t i = 0U; i < recordedPasses.size(); ++i) {
+			if (!recordedPasses[i]) {
+				continue;
+			}
+
+			PassQueries& passQueries = queries.mPasses[i];
+			PassData& passData = frameData.mPasses[i];
+			D3D11_QUERY_DATA_PIPELINE_STATISTICS statistics;
+			if (!GetQueryData(mContext, *passQueries.mBegin, passData.mBegin) ||
+				!GetQueryData(mContext, *passQueries.mEnd, passData.mEnd) ||
+				!GetQueryData(mContext, *passQueries.mStatistics, statistics)) {
+				return false;
+			}
+
+			passData.mStatistics.mIAVertices = statistics.IAVertices;
+			passData.mStatistics.mIAPrimitives = statistics.IAPrimitives;
+			passData.mStatistics.mVSInvocations = statistics.VSInvocations;
+			passData.mStatistics.mGSInvocations = statistics.GSInvocations;
+			passData.mStatistics.mGSPrimitives = statistics.GSPrimitives;
+			passData.mStatistics.mCInvocations = statistics.CInvocations;
+			passData.mStatistics.mCPrimitives = statistics.CPrimitives;
+			passData.mStatistics.mPSInvocations = statistics.PSInvocations;
+			passData.mStatistics.mHSInvocations = statistics.HSInvocations;
+			passData.mStatistics.mDSInvocations = statistics.DSInvocations;
+			passData.mStatistics.mCSInvocations = statistics.CSInvocations;
+		}
+
+		return true;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <vector>
+
+#include <rendering/GpuQuerySource.h>
+
+struct ID3D11Device1;
+struct ID3D11DeviceContext1;
+struct ID3D11Query;
+
+namespace BRE {
+	// GpuQuerySource based on D3D11 TIMESTAMP, TIMESTAMP_DISJOINT and PIPELINE_STATISTICS queries
+	class D3D11GpuQuerySource : public GpuQuerySource {
+	public:
+		D3D11GpuQuerySource(ID3D11Device1& device, ID3D11DeviceContext1& context, const size_t maxSlots, const size_t maxPasses);
+		~D3D11GpuQuerySource();
+
+		const D3D11GpuQuerySource& operator=(const D3D11GpuQuerySource& rhs) = delete;
+
+		size_t MaxSlots() const override { return mSlots.size(); }
+		size_t MaxPasses() const override { return mMaxPasses; }
+
+		void BeginFrame(const size_t slot) override;
+		void EndFrame(const size_t slot) override;
+		void BeginPass(const size_t slot, const size_t pass) override;
+		void EndPass(const size_t slot, const size_t pass) override;
+
+		bool ReadFrame(const size_t slot, const std::vector<bool>& recordedPasses, FrameData& frameData) override;
+
+	private:
+		struct PassQueries {
+			ID3D11Query* mBegin;
+			ID3D11Query* mEnd;
+			ID3D11Query* mStatistics;
+		};
+
+		struct SlotQueries {
+			ID3D11Query* mDisjoint;
+			std::vector<PassQueries> mPasses;
+		};
+
+		ID3D11DeviceContext1& mContext;
+		const size_t mMaxPasses;
+		std::vector<SlotQueries> mSlots;
+	};
+}
\ No newline at end of file
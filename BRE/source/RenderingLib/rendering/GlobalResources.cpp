@@ -1,10 +1,40 @@
 #include "GlobalResources.h"
 
+#include <cstdint>
 #include <d3d11_1.h>
 
 #include <managers/ShaderResourcesManager.h>
 #include <utils/Assert.h>
 
+namespace {
+	// texel is R8G8B8A8 (R in the lowest byte)
+	ID3D11ShaderResourceView* CreatePlaceholder(const char* id, const std::uint32_t texel) {
+		D3D11_TEXTURE2D_DESC desc;
+		ZeroMemory(&desc, sizeof(desc));
+		desc.Width = 1U;
+		desc.Height = 1U;
+		desc.MipLevels = 1U;
+		desc.ArraySize = 1U;
+		desc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+		desc.SampleDesc.Count = 1U;
+		desc.Usage = D3D11_USAGE_IMMUTABLE;
+		desc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+
+		D3D11_SUBRESOURCE_DATA initialData;
+		ZeroMemory(&initialData, sizeof(initialData));
+		initialData.pSysMem = &texel;
+		initialData.SysMemPitch = sizeof(texel);
+
+		ID3D11Texture2D* texture;
+		BRE::ShaderResourcesManager::gInstance->AddTexture2D(id, desc, &initialData, &texture);
+		BRE_ASSERT(texture);
+		ID3D11ShaderResourceView* view;
+		BRE::ShaderResourcesManager::gInstance->AddResourceSRV(id, *texture, nullptr, &view);
+		BRE_ASSERT(view);
+		return view;
+	}
+}
+
 namespace BRE {
 	GlobalResources* GlobalResources::gInstance = nullptr;
 
@@ -27,5 +57,30 @@ namespace BRE {
 		desc.MaxLOD = 0.0f;
 		ShaderResourcesManager::gInstance->AddSamplerState("D3D11_FILTER_MIN_MAG_MIP_POINT_sampler_state", desc, &mMinMagMipPointSS);
 		BRE_ASSERT(mMinMagMipPointSS);
+
+		// Create D3D11_FILTER_MIN_MAG_MIP_LINEAR (trilinear) sampler state
+		desc.Filter = D3D11_FILTER_MIN_MAG_MIP_LINEAR;
+		desc.MaxLOD = D3D11_FLOAT32_MAX;
+		ShaderResourcesManager::gInstance->AddSamplerState("D3D11_FILTER_MIN_MAG_MIP_LINEAR_sampler_state", desc, &mMinMagMipLinearSS);
+		BRE_ASSERT(mMinMagMipLinearSS);
+
+		// Create D3D11_FILTER_ANISOTROPIC sampler state
+		desc.Filter = D3D11_FILTER_ANISOTROPIC;
+		desc.MaxAnisotropy = sMaxAnisotropy;
+		ShaderResourcesManager::gInstance->AddSamplerState("D3D11_FILTER_ANISOTROPIC_sampler_state", desc, &mAnisotropicSS);
+		BRE_ASSERT(mAnisotropicSS);
+
+		mPlaceholderNormalSRV = CreatePlaceholder("placeholder_normal", 0xffff8080U);
+		mPlaceholderBaseColorSRV = CreatePlaceholder("placeholder_base_color", 0xff808080U);
+		mPlaceholderSmoothnessMetalMaskCurvatureSRV = CreatePlaceholder("placeholder_smoothness_metal_mask_curvature", 0xff000080U);
+	}
+
+	ID3D11SamplerState* GlobalResources::Sampler(const SamplerFilter filter) {
+		switch (filter) {
+		case SamplerFilter::Point: return mMinMagMipPointSS;
+		case SamplerFilter::Trilinear: return mMinMagMipLinearSS;
+		case SamplerFilter::Anisotropic: return mAnisotropicSS;
+		default: BRE_ASSERT(false); return nullptr;
+		}
 	}
 }
\ No newline at end of file
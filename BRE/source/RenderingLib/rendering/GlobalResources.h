@@ -1,15 +1,41 @@
 #pragma once
 
 struct ID3D11SamplerState;
+struct ID3D11ShaderResourceView;
 
 namespace BRE {
+	// Texture filtering of material samplers (materials.yml "sampler")
+	enum class SamplerFilter {
+		Point,
+		Trilinear,
+		Anisotropic,
+	};
+
 	class GlobalResources {
 	public:
 		static GlobalResources* gInstance;
 
+		static const unsigned int sMaxAnisotropy = 8U;
+
 		GlobalResources();
 		ID3D11SamplerState* MinMagMipPointSampler() { return mMinMagMipPointSS; }
+		// Wrap addressing, all mip levels
+		ID3D11SamplerState* MinMagMipLinearSampler() { return mMinMagMipLinearSS; }
+		ID3D11SamplerState* AnisotropicSampler() { return mAnisotropicSS; }
+		ID3D11SamplerState* Sampler(const SamplerFilter filter);
+
+		// 1x1 textures used while material textures are not loaded:
+		// flat normal, mid grey base color and packed smoothness (0.5), metal mask (0) and curvature (0)
+		ID3D11ShaderResourceView* PlaceholderNormalSRV() { return mPlaceholderNormalSRV; }
+		ID3D11ShaderResourceView* PlaceholderBaseColorSRV() { return mPlaceholderBaseColorSRV; }
+		ID3D11ShaderResourceView* PlaceholderSmoothnessMetalMaskCurvatureSRV() { return mPlaceholderSmoothnessMetalMaskCurvatureSRV; }
 	private:
 		ID3D11SamplerState* mMinMagMipPointSS;
+		ID3D11SamplerState* mMinMagMipLinearSS;
+		ID3D11SamplerState* mAnisotropicSS;
+
+		ID3D11ShaderResourceView* mPlaceholderNormalSRV;
+		ID3D11ShaderResourceView* mPlaceholderBaseColorSRV;
+		ID3D11ShaderResourceView* mPlaceholderSmoothnessMetalMaskCurvatureSRV;
 	};
 }
\ No newline at end of file
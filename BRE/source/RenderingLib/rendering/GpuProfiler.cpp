@@ -0,0 +1,119 @@
+#include "GpuProfiler.h"
+
+#include <cstring>
+
+#include <utils/Assert.h>
+
+namespace BRE {
+	GpuProfiler::GpuProfiler(GpuQuerySource& querySource)
+		: mQuerySource(querySource)
+		, mRecordedPasses(querySource.MaxSlots())
+		, mSlotFrames(querySource.MaxSlots(), 0U)
+	{
+		BRE_ASSERT(querySource.MaxSlots() > 0U);
+		for (std::vector<bool>& recordedPasses : mRecordedPasses) {
+			recordedPasses.resize(querySource.MaxPasses(), false);
+		}
+		mFrameData.mPasses.resize(querySource.MaxPasses());
+	}
+
+	size_t GpuProfiler::RegisterPass(const char* name) {
+		BRE_ASSERT(name);
+		BRE_ASSERT(mPasses.size() < mQuerySource.MaxPasses());
+		PassStats stats;
+		stats.mName = name;
+		stats.mValid = false;
+		stats.mMs = 0.0;
+		memset(&stats.mStatistics, 0, sizeof(stats.mStatistics));
+		mPasses.push_back(stats);
+		return mPasses.size() - 1U;
+	}
+
+	void GpuProfiler::BeginFrame(const std::uint64_t frame) {
+		BRE_ASSERT(!mRecording);
+		Poll();
+
+		// Every slot is waiting for the GPU. Skip this frame instead of stalling.
+		if (mPendingCount == mRecordedPasses.size()) {
+			++mSkippedFrames;
+			return;
+		}
+
+		std::vector<bool>& recordedPasses = mRecordedPasses[mNextSlot];
+		recordedPasses.assign(recordedPasses.size(), false);
+		mSlotFrames[mNextSlot] = frame;
+		mQuerySource.BeginFrame(mNextSlot);
+		mRecording = true;
+	}
+
+	void GpuProfiler::EndFrame() {
+		if (!mRecording) {
+			return;
+		}
+		BRE_ASSERT(!mInPass);
+		mQuerySource.EndFrame(mNextSlot);
+		mRecording = false;
+		++mPendingCount;
+		mNextSlot = (mNextSlot + 1U) % mRecordedPasses.size();
+	}
+
+	void GpuProfiler::BeginPass(const size_t pass) {
+		BRE_ASSERT(pass < mPasses.size());
+		if (!mRecording) {
+			return;
+		}
+		// Pipeline statistics queries cannot be nested
+		BRE_ASSERT(!mInPass);
+		BRE_ASSERT(!mRecordedPasses[mNextSlot][pass]);
+		mQuerySource.BeginPass(mNextSlot, pass);
+		mInPass = true;
+	}
+
+	void GpuProfiler::EndPass(const size_t pass) {
+		BRE_ASSERT(pass < mPasses.size());
+		if (!mRecording) {
+			return;
+		}
+		BRE_ASSERT(mInPass);
+		mQuerySource.EndPass(mNextSlot, pass);
+		mRecordedPasses[mNextSlot][pass] = true;
+		mInPass = false;
+	}
+
+	void GpuProfiler::Poll() {
+		// Slots are resolved in submission order. Stop at the first one that is not ready.
+		const size_t numSlots = mRecordedPasses.size();
+		while (mPendingCount > 0U) {
+			const size_t oldestSlot = (mNextSlot + numSlots - mPendingCount) % numSlots;
+			if (!mQuerySource.ReadFrame(oldestSlot, mRecordedPasses[oldestSlot], mFrameData)) {
+				break;
+			}
+			Resolve(oldestSlot);
+			--mPendingCount;
+		}
+	}
+
+	void GpuProfiler::Resolve(const size_t slot) {
+		if (mFrameData.mDisjoint || mFrameData.mFrequency == 0U) {
+			++mDisjointFrames;
+			return;
+		}
+
+		const std::vector<bool>& recordedPasses = mRecordedPasses[slot];
+		const double msPerTick = 1000.0 / static_cast<double>(mFrameData.mFrequency);
+		mFrame = mSlotFrames[slot];
+		mFrameMs = 0.0;
+		for (size_t i = 0U; i < mPasses.size(); ++i) {
+			PassStats& stats = mPasses[i];
+			stats.mValid = recordedPasses[i];
+			if (!stats.mValid) {
+				continue;
+			}
+			const GpuQuerySource::PassData& passData = mFrameData.mPasses[i];
+			stats.mMs = passData.mEnd > passData.mBegin ? (passData.mEnd - passData.mBegin) * msPerTick : 0.0;
+			stats.mStatistics = passData.mStatistics;
+			mFrameMs += stats.mMs;
+		}
+		++mResolvedFrames;
+	}
+}
\ No newline at end of file
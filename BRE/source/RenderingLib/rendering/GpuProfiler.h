@@ -0,0 +1,95 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <rendering/GpuQuerySource.h>
+
+//////////////////////////////////////////////////////////////////////////
+//
+// GPU pass profiler.
+// It keeps a ring of frames in flight so query results are read some
+// frames later without stalling the pipeline. If every slot is still
+// waiting for the GPU, the current frame is simply not recorded.
+// Query API specific work is delegated to a GpuQuerySource, so the
+// scheduling can run against a fake source on the CPU.
+//
+//////////////////////////////////////////////////////////////////////////
+
+namespace BRE {
+	class GpuProfiler {
+	public:
+		struct PassStats {
+			std::string mName;
+			// False if the pass was not recorded in the last resolved frame
+			bool mValid;
+			double mMs;
+			GpuQuerySource::PipelineStatistics mStatistics;
+		};
+
+		explicit GpuProfiler(GpuQuerySource& querySource);
+
+		const GpuProfiler& operator=(const GpuProfiler& rhs) = delete;
+
+		size_t RegisterPass(const char* name);
+
+		// Frame() returns frame once the queries of this frame are resolved
+		void BeginFrame(const std::uint64_t frame);
+		void EndFrame();
+		void BeginPass(const size_t pass);
+		void EndPass(const size_t pass);
+
+		// Stats of the most recent frame whose queries are available
+		const std::vector<PassStats>& Passes() const { return mPasses; }
+		double FrameMs() const { return mFrameMs; }
+		std::uint64_t Frame() const { return mFrame; }
+
+		size_t ResolvedFrames() const { return mResolvedFrames; }
+		size_t SkippedFrames() const { return mSkippedFrames; }
+		size_t DisjointFrames() const { return mDisjointFrames; }
+		size_t PendingFrames() const { return mPendingCount; }
+
+	private:
+		void Poll();
+		void Resolve(const size_t slot);
+
+		GpuQuerySource& mQuerySource;
+
+		std::vector<PassStats> mPasses;
+		double mFrameMs = 0.0;
+		std::uint64_t mFrame = 0U;
+
+		// Recorded passes and frame per slot
+		std::vector<std::vector<bool>> mRecordedPasses;
+		std::vector<std::uint64_t> mSlotFrames;
+		GpuQuerySource::FrameData mFrameData;
+
+		size_t mNextSlot = 0U;
+		size_t mPendingCount = 0U;
+		bool mRecording = false;
+		bool mInPass = false;
+
+		size_t mResolvedFrames = 0U;
+		size_t mSkippedFrames = 0U;
+		size_t mDisjointFrames = 0U;
+	};
+
+	class GpuProfileScope {
+	public:
+		GpuProfileScope(GpuProfiler& profiler, const size_t pass)
+			: mProfiler(profiler)
+			, mPass(pass)
+		{
+			mProfiler.BeginPass(mPass);
+		}
+
+		~GpuProfileScope() { mProfiler.EndPass(mPass); }
+
+		const GpuProfileScope& operator=(const GpuProfileScope& rhs) = delete;
+
+	private:
+		GpuProfiler& mProfiler;
+		const size_t mPass;
+	};
+}
\ No newline at end of file
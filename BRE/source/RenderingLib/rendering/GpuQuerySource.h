@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Interface GpuProfiler uses to issue and read GPU queries.
+// Queries are grouped in slots (one slot per frame in flight) and
+// each slot has one timestamp pair and one pipeline statistics query
+// per pass.
+//
+//////////////////////////////////////////////////////////////////////////
+
+namespace BRE {
+	class GpuQuerySource {
+	public:
+		struct PipelineStatistics {
+			std::uint64_t mIAVertices;
+			std::uint64_t mIAPrimitives;
+			std::uint64_t mVSInvocations;
+			std::uint64_t mGSInvocations;
+			std::uint64_t mGSPrimitives;
+			std::uint64_t mCInvocations;
+			std::uint64_t mCPrimitives;
+			std::uint64_t mPSInvocations;
+			std::uint64_t mHSInvocations;
+			std::uint64_t mDSInvocations;
+			std::uint64_t mCSInvocations;
+		};
+
+		struct PassData {
+			std::uint64_t mBegin;
+			std::uint64_t mEnd;
+			PipelineStatistics mStatistics;
+		};
+
+		struct FrameData {
+			std::uint64_t mFrequency;
+			bool mDisjoint;
+			// Only entries of recorded passes are filled
+			std::vector<PassData> mPasses;
+		};
+
+		virtual ~GpuQuerySource() {}
+
+		virtual size_t MaxSlots() const = 0;
+		virtual size_t MaxPasses() const = 0;
+
+		virtual void BeginFrame(const size_t slot) = 0;
+		virtual void EndFrame(const size_t slot) = 0;
+		virtual void BeginPass(const size_t slot, const size_t pass) = 0;
+		virtual void EndPass(const size_t slot, const size_t pass) = 0;
+
+		// It must never block. Returns false if the GPU has not finished the slot yet.
+		virtual bool ReadFrame(const size_t slot, const std::vector<bool>& recordedPasses, FrameData& frameData) = 0;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,359 @@
+#include "OcclusionCuller.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+#include <general/JobSystem.h>
+#include <general/Profiler.h>
+#include <rendering/TransformArray.h>
+#include <utils/Assert.h>
+
+using namespace DirectX;
+
+namespace {
+	const size_t sOccludersPerJob = 4U;
+	const size_t sTilesPerJob = 4U;
+	const size_t sObjectsPerJob = 64U;
+	// Four pixels per depth buffer element
+	const size_t sTileRowElements = BRE::OcclusionCuller::sTileWidth / 4U;
+	const size_t sTileElements = sTileRowElements * BRE::OcclusionCuller::sTileHeight;
+
+	bool AnyLane(FXMVECTOR control) {
+		std::uint32_t lanes[4];
+		XMStoreInt4(lanes, control);
+		return (lanes[0] | lanes[1] | lanes[2] | lanes[3]) != 0U;
+	}
+
+	float MaxLane(FXMVECTOR vector) {
+		XMFLOAT4 lanes;
+		XMStoreFloat4(&lanes, vector);
+		return (std::max)((std::max)(lanes.x, lanes.y), (std::max)(lanes.z, lanes.w));
+	}
+
+	// Point of the segment where clip space z is 0
+	XMFLOAT4 NearPlaneIntersection(const XMFLOAT4& a, const XMFLOAT4& b) {
+		const float t = a.z / (a.z - b.z);
+		return XMFLOAT4(a.x + (b.x - a.x) * t, a.y + (b.y - a.y) * t, 0.0f, a.w + (b.w - a.w) * t);
+	}
+}
+
+namespace BRE {
+	OcclusionCuller::OcclusionCuller(const unsigned int width, const unsigned int height)
+		: mTilesX((width + sTileWidth - 1U) / sTileWidth)
+		, mTilesY((height + sTileHeight - 1U) / sTileHeight)
+		, mTileTriangles(mTilesX * mTilesY)
+		, mDepth(mTilesX * mTilesY * sTileElements, XMFLOAT4(1.0f, 1.0f, 1.0f, 1.0f))
+		, mTileMaxDepth(mTilesX * mTilesY, 1.0f)
+	{
+		BRE_ASSERT(width > 0U);
+		BRE_ASSERT(height > 0U);
+		XMStoreFloat4x4(&mViewProj, XMMatrixIdentity());
+	}
+
+	void OcclusionCuller::AddOccluder(const std::vector<XMFLOAT3>& vertices, const std::vector<unsigned int>& indices, const size_t transform) {
+		BRE_ASSERT(indices.size() % 3U == 0U);
+		Occluder occluder;
+		occluder.mTransform = transform;
+		occluder.mFirstVertex = mVertices.size();
+		occluder.mNumVertices = vertices.size();
+		occluder.mFirstIndex = mIndices.size();
+		occluder.mNumIndices = indices.size();
+		mVertices.insert(mVertices.end(), vertices.begin(), vertices.end());
+		mIndices.insert(mIndices.end(), indices.begin(), indices.end());
+		mOccluders.push_back(occluder);
+	}
+
+	void OcclusionCuller::RenderOccluders(const XMMATRIX& viewProj, const TransformArray& transforms) {
+		BRE_PROFILE_SCOPE("OcclusionCuller::RenderOccluders");
+		XMStoreFloat4x4(&mViewProj, viewProj);
+
+		// Clip space vertices
+		mClipVertices.resize(mVertices.size());
+		const auto transformVertices = [this, &viewProj, &transforms](const size_t begin, const size_t end) {
+			for (size_t iOccluder = begin; iOccluder < end; ++iOccluder) {
+				const Occluder& occluder = mOccluders[iOccluder];
+				const XMMATRIX worldViewProj = XMMatrixMultiply(transforms.World(occluder.mTransform), viewProj);
+				const size_t verticesEnd = occluder.mFirstVertex + occluder.mNumVertices;
+				for (size_t iVertex = occluder.mFirstVertex; iVertex < verticesEnd; ++iVertex) {
+					XMStoreFloat4(&mClipVertices[iVertex], XMVector3Transform(XMLoadFloat3(&mVertices[iVertex]), worldViewProj));
+				}
+			}
+		};
+		if (mOccluders.size() <= sOccludersPerJob || JobSystem::gInstance == nullptr) {
+			transformVertices(0U, mOccluders.size());
+		}
+		else {
+			JobSystem::gInstance->ParallelFor(0U, mOccluders.size(), sOccludersPerJob, transformVertices, "OcclusionCuller::TransformVertices");
+		}
+
+		// Triangles setup and binning
+		mTriangles.clear();
+		for (std::vector<std::uint32_t>& tileTriangles : mTileTriangles) {
+			tileTriangles.clear();
+		}
+		for (const Occluder& occluder : mOccluders) {
+			const size_t indicesEnd = occluder.mFirstIndex + occluder.mNumIndices;
+			for (size_t iIndex = occluder.mFirstIndex; iIndex < indicesEnd; iIndex += 3U) {
+				const XMFLOAT4 clipVertices[3] = {
+					mClipVertices[occluder.mFirstVertex + mIndices[iIndex]],
+					mClipVertices[occluder.mFirstVertex + mIndices[iIndex + 1U]],
+					mClipVertices[occluder.mFirstVertex + mIndices[iIndex + 2U]],
+				};
+				SetupTriangle(clipVertices);
+			}
+		}
+
+		// Tiles
+		const size_t numTiles = mTileTriangles.size();
+		if (numTiles <= sTilesPerJob || JobSystem::gInstance == nullptr) {
+			for (size_t tile = 0U; tile < numTiles; ++tile) {
+				RasterizeTile(tile);
+			}
+		}
+		else {
+			JobSystem::gInstance->ParallelFor(0U, numTiles, sTilesPerJob, [this](const size_t begin, const size_t end) {
+				for (size_t tile = begin; tile < end; ++tile) {
+					RasterizeTile(tile);
+				}
+			}, "OcclusionCuller::RasterizeTiles");
+		}
+	}
+
+	void OcclusionCuller::SetupTriangle(const XMFLOAT4 clipVertices[3]) {
+		// Clipped by the near plane (z = 0), the polygon has up to four vertices
+		XMFLOAT4 polygon[4];
+		size_t numVertices = 0U;
+		for (size_t i = 0U; i < 3U; ++i) {
+			const XMFLOAT4& current = clipVertices[i];
+			const XMFLOAT4& next = clipVertices[(i + 1U) % 3U];
+			if (current.z >= 0.0f) {
+				polygon[numVertices++] = current;
+			}
+			if ((current.z >= 0.0f) != (next.z >= 0.0f)) {
+				polygon[numVertices++] = NearPlaneIntersection(current, next);
+			}
+		}
+		if (numVertices < 3U) {
+			return;
+		}
+
+		const float width = static_cast<float>(Width());
+		const float height = static_cast<float>(Height());
+		XMFLOAT3 screenPolygon[4];
+		for (size_t i = 0U; i < numVertices; ++i) {
+			const XMFLOAT4& vertex = polygon[i];
+			if (!(vertex.w > 0.0f)) {
+				return;
+			}
+			const float invW = 1.0f / vertex.w;
+			screenPolygon[i] = XMFLOAT3((vertex.x * invW * 0.5f + 0.5f) * width, (0.5f - vertex.y * invW * 0.5f) * height, vertex.z * invW);
+		}
+		for (size_t i = 2U; i < numVertices; ++i) {
+			const XMFLOAT3 triangle[3] = { screenPolygon[0], screenPolygon[i - 1U], screenPolygon[i] };
+			AddScreenTriangle(triangle);
+		}
+	}
+
+	void OcclusionCuller::AddScreenTriangle(const XMFLOAT3 vertices[3]) {
+		// Clockwise on screen (y down) is a positive area. It also discards degenerate triangles.
+		const float area = (vertices[1].x - vertices[0].x) * (vertices[2].y - vertices[0].y) - (vertices[1].y - vertices[0].y) * (vertices[2].x - vertices[0].x);
+		if (!(area > 0.0f)) {
+			return;
+		}
+
+		// Pixels whose centers are in the bounds of the vertices
+		const float minX = (std::min)((std::min)(vertices[0].x, vertices[1].x), vertices[2].x);
+		const float maxX = (std::max)((std::max)(vertices[0].x, vertices[1].x), vertices[2].x);
+		const float minY = (std::min)((std::min)(vertices[0].y, vertices[1].y), vertices[2].y);
+		const float maxY = (std::max)((std::max)(vertices[0].y, vertices[1].y), vertices[2].y);
+		const float lastX = static_cast<float>(Width() - 1U);
+		const float lastY = static_cast<float>(Height() - 1U);
+		if (maxX < 0.5f || maxY < 0.5f || minX > lastX + 0.5f || minY > lastY + 0.5f) {
+			return;
+		}
+
+		Triangle triangle;
+		triangle.mMinX = static_cast<int>(std::ceil((std::max)(minX - 0.5f, 0.0f)));
+		triangle.mMinY = static_cast<int>(std::ceil((std::max)(minY - 0.5f, 0.0f)));
+		triangle.mMaxX = static_cast<int>(std::floor((std::min)(maxX - 0.5f, lastX)));
+		triangle.mMaxY = static_cast<int>(std::floor((std::min)(maxY - 0.5f, lastY)));
+		if (triangle.mMinX > triangle.mMaxX || triangle.mMinY > triangle.mMaxY) {
+			return;
+		}
+
+		// Edge i goes from vertex i to the next one. It is positive inside.
+		for (size_t i = 0U; i < 3U; ++i) {
+			const XMFLOAT3& a = vertices[i];
+			const XMFLOAT3& b = vertices[(i + 1U) % 3U];
+			triangle.mEdgeA[i] = a.y - b.y;
+			triangle.mEdgeB[i] = b.x - a.x;
+			triangle.mEdgeC[i] = -(triangle.mEdgeA[i] * a.x + triangle.mEdgeB[i] * a.y);
+		}
+		// Barycentric coordinate of a vertex is the edge function of its opposite edge divided by the area
+		const float invArea = 1.0f / area;
+		triangle.mDepthA = (triangle.mEdgeA[1] * vertices[0].z + triangle.mEdgeA[2] * vertices[1].z + triangle.mEdgeA[0] * vertices[2].z) * invArea;
+		triangle.mDepthB = (triangle.mEdgeB[1] * vertices[0].z + triangle.mEdgeB[2] * vertices[1].z + triangle.mEdgeB[0] * vertices[2].z) * invArea;
+		triangle.mDepthC = (triangle.mEdgeC[1] * vertices[0].z + triangle.mEdgeC[2] * vertices[1].z + triangle.mEdgeC[0] * vertices[2].z) * invArea;
+
+		const std::uint32_t index = static_cast<std::uint32_t>(mTriangles.size());
+		mTriangles.push_back(triangle);
+		for (int tileY = triangle.mMinY / static_cast<int>(sTileHeight); tileY <= triangle.mMaxY / static_cast<int>(sTileHeight); ++tileY) {
+			for (int tileX = triangle.mMinX / static_cast<int>(sTileWidth); tileX <= triangle.mMaxX / static_cast<int>(sTileWidth); ++tileX) {
+				mTileTriangles[tileY * mTilesX + tileX].push_back(index);
+			}
+		}
+	}
+
+	void OcclusionCuller::RasterizeTile(const size_t tile) {
+		const int tileMinX = static_cast<int>((tile % mTilesX) * sTileWidth);
+		const int tileMinY = static_cast<int>((tile / mTilesX) * sTileHeight);
+		XMFLOAT4* depth = &mDepth[tile * sTileElements];
+		std::fill(depth, depth + sTileElements, XMFLOAT4(1.0f, 1.0f, 1.0f, 1.0f));
+
+		const XMVECTOR laneCenters = XMVectorSet(0.5f, 1.5f, 2.5f, 3.5f);
+		const XMVECTOR zero = XMVectorZero();
+		for (const std::uint32_t index : mTileTriangles[tile]) {
+			const Triangle& triangle = mTriangles[index];
+			const int minX = (std::max)(triangle.mMinX, tileMinX) - tileMinX;
+			const int maxX = (std::min)(triangle.mMaxX, tileMinX + static_cast<int>(sTileWidth) - 1) - tileMinX;
+			const int minY = (std::max)(triangle.mMinY, tileMinY) - tileMinY;
+			const int maxY = (std::min)(triangle.mMaxY, tileMinY + static_cast<int>(sTileHeight) - 1) - tileMinY;
+			const XMVECTOR edgeA[3] = { XMVectorReplicate(triangle.mEdgeA[0]), XMVectorReplicate(triangle.mEdgeA[1]), XMVectorReplicate(triangle.mEdgeA[2]) };
+			const XMVECTOR depthA = XMVectorReplicate(triangle.mDepthA);
+
+			for (int y = minY; y <= maxY; ++y) {
+				const float centerY = static_cast<float>(tileMinY + y) + 0.5f;
+				// Terms of the row
+				XMVECTOR edgeRow[3];
+				for (size_t i = 0U; i < 3U; ++i) {
+					edgeRow[i] = XMVectorReplicate(triangle.mEdgeB[i] * centerY + triangle.mEdgeC[i]);
+				}
+				const XMVECTOR depthRow = XMVectorReplicate(triangle.mDepthB * centerY + triangle.mDepthC);
+				XMFLOAT4* depthRowElements = depth + y * sTileRowElements;
+
+				for (int element = minX / 4; element <= maxX / 4; ++element) {
+					const XMVECTOR centerX = XMVectorAdd(XMVectorReplicate(static_cast<float>(tileMinX + element * 4)), laneCenters);
+					XMVECTOR inside = XMVectorGreaterOrEqual(XMVectorMultiplyAdd(edgeA[0], centerX, edgeRow[0]), zero);
+					inside = XMVectorAndInt(inside, XMVectorGreaterOrEqual(XMVectorMultiplyAdd(edgeA[1], centerX, edgeRow[1]), zero));
+					inside = XMVectorAndInt(inside, XMVectorGreaterOrEqual(XMVectorMultiplyAdd(edgeA[2], centerX, edgeRow[2]), zero));
+					const XMVECTOR triangleDepth = XMVectorMultiplyAdd(depthA, centerX, depthRow);
+					const XMVECTOR pixelsDepth = XMLoadFloat4(&depthRowElements[element]);
+					XMStoreFloat4(&depthRowElements[element], XMVectorSelect(pixelsDepth, XMVectorMin(pixelsDepth, triangleDepth), inside));
+				}
+			}
+		}
+
+		XMVECTOR maxDepth = XMLoadFloat4(&depth[0]);
+		for (size_t element = 1U; element < sTileElements; ++element) {
+			maxDepth = XMVectorMax(maxDepth, XMLoadFloat4(&depth[element]));
+		}
+		mTileMaxDepth[tile] = MaxLane(maxDepth);
+	}
+
+	bool OcclusionCuller::IsVisible(const BoundingVolumeHierarchy::Aabb& bounds) const {
+		const XMMATRIX viewProj = XMLoadFloat4x4(&mViewProj);
+		const float width = static_cast<float>(Width());
+		const float height = static_cast<float>(Height());
+		float minX = FLT_MAX;
+		float maxX = -FLT_MAX;
+		float minY = FLT_MAX;
+		float maxY = -FLT_MAX;
+		float minDepth = FLT_MAX;
+		size_t numNearCorners = 0U;
+		for (size_t corner = 0U; corner < 8U; ++corner) {
+			const XMVECTOR position = XMVectorSet((corner & 1U) ? bounds.mMax.x : bounds.mMin.x, (corner & 2U) ? bounds.mMax.y : bounds.mMin.y, (corner & 4U) ? bounds.mMax.z : bounds.mMin.z, 1.0f);
+			XMFLOAT4 clip;
+			XMStoreFloat4(&clip, XMVector4Transform(position, viewProj));
+			if (clip.z < 0.0f || !(clip.w > 0.0f)) {
+				++numNearCorners;
+				continue;
+			}
+			const float invW = 1.0f / clip.w;
+			const float x = (clip.x * invW * 0.5f + 0.5f) * width;
+			const float y = (0.5f - clip.y * invW * 0.5f) * height;
+			minX = (std::min)(minX, x);
+			maxX = (std::max)(maxX, x);
+			minY = (std::min)(minY, y);
+			maxY = (std::max)(maxY, y);
+			minDepth = (std::min)(minDepth, clip.z * invW);
+		}
+		// Bounds that cross the near plane are not tested
+		if (numNearCorners > 0U) {
+			return numNearCorners < 8U;
+		}
+		if (maxX < 0.0f || maxY < 0.0f || minX >= width || minY >= height) {
+			return false;
+		}
+
+		// Every pixel the rectangle touches
+		const int rectMinX = static_cast<int>((std::max)(minX, 0.0f));
+		const int rectMinY = static_cast<int>((std::max)(minY, 0.0f));
+		const int rectMaxX = static_cast<int>((std::min)(maxX, width - 1.0f));
+		const int rectMaxY = static_cast<int>((std::min)(maxY, height - 1.0f));
+		const XMVECTOR laneOffsets = XMVectorSet(0.0f, 1.0f, 2.0f, 3.0f);
+		const XMVECTOR rectMinXVector = XMVectorReplicate(static_cast<float>(rectMinX));
+		const XMVECTOR rectMaxXVector = XMVectorReplicate(static_cast<float>(rectMaxX));
+		const XMVECTOR minDepthVector = XMVectorReplicate(minDepth);
+		for (int tileY = rectMinY / static_cast<int>(sTileHeight); tileY <= rectMaxY / static_cast<int>(sTileHeight); ++tileY) {
+			for (int tileX = rectMinX / static_cast<int>(sTileWidth); tileX <= rectMaxX / static_cast<int>(sTileWidth); ++tileX) {
+				const size_t tile = tileY * mTilesX + tileX;
+				// The whole tile is nearer
+				if (mTileMaxDepth[tile] < minDepth) {
+					continue;
+				}
+				const int tileMinX = tileX * static_cast<int>(sTileWidth);
+				const int tileMinY = tileY * static_cast<int>(sTileHeight);
+				const int minElement = ((std::max)(rectMinX, tileMinX) - tileMinX) / 4;
+				const int maxElement = ((std::min)(rectMaxX, tileMinX + static_cast<int>(sTileWidth) - 1) - tileMinX) / 4;
+				const int minRow = (std::max)(rectMinY, tileMinY) - tileMinY;
+				const int maxRow = (std::min)(rectMaxY, tileMinY + static_cast<int>(sTileHeight) - 1) - tileMinY;
+				const XMFLOAT4* depth = &mDepth[tile * sTileElements];
+				for (int row = minRow; row <= maxRow; ++row) {
+					for (int element = minElement; element <= maxElement; ++element) {
+						const XMVECTOR x = XMVectorAdd(XMVectorReplicate(static_cast<float>(tileMinX + element * 4)), laneOffsets);
+						XMVECTOR visible = XMVectorGreaterOrEqual(XMLoadFloat4(&depth[row * sTileRowElements + element]), minDepthVector);
+						visible = XMVectorAndInt(visible, XMVectorAndInt(XMVectorGreaterOrEqual(x, rectMinXVector), XMVectorLessOrEqual(x, rectMaxXVector)));
+						if (AnyLane(visible)) {
+							return true;
+						}
+					}
+				}
+			}
+		}
+		return false;
+	}
+
+	void OcclusionCuller::RemoveOccluded(const BoundingVolumeHierarchy& bvh, std::vector<std::uint32_t>& objects) {
+		BRE_PROFILE_SCOPE("OcclusionCuller::RemoveOccluded");
+		const size_t numObjects = objects.size();
+		mVisible.resize(numObjects);
+		const auto testObjects = [this, &bvh, &objects](const size_t begin, const size_t end) {
+			for (size_t i = begin; i < end; ++i) {
+				mVisible[i] = static_cast<std::uint8_t>(IsVisible(bvh.Bounds(objects[i])) ? 1U : 0U);
+			}
+		};
+		if (numObjects <= sObjectsPerJob || JobSystem::gInstance == nullptr) {
+			testObjects(0U, numObjects);
+		}
+		else {
+			JobSystem::gInstance->ParallelFor(0U, numObjects, sObjectsPerJob, testObjects, "OcclusionCuller::TestObjects");
+		}
+
+		size_t numVisible = 0U;
+		for (size_t i = 0U; i < numObjects; ++i) {
+			if (mVisible[i] != 0U) {
+				objects[numVisible++] = objects[i];
+			}
+		}
+		objects.resize(numVisible);
+	}
+
+	float OcclusionCuller::Depth(const unsigned int x, const unsigned int y) const {
+		BRE_ASSERT(x < Width());
+		BRE_ASSERT(y < Height());
+		const size_t tile = (y / sTileHeight) * mTilesX + x / sTileWidth;
+		const XMFLOAT4& element = mDepth[tile * sTileElements + (y % sTileHeight) * sTileRowElements + (x % sTileWidth) / 4U];
+		return (&element.x)[x % 4U];
+	}
+}
\ No newline at end of file
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <cstdint>
+#include <DirectXMath.h>
+#include <vector>
+
+#include <rendering/BoundingVolumeHierarchy.h>
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Software occlusion culling.
+// Occluders (low poly meshes) are rasterized on the CPU into a low
+// resolution depth buffer (z / w, as Direct3D) split in tiles of
+// sTileWidth x sTileHeight pixels. Triangles are binned into the tiles
+// they overlap and tiles are rasterized in parallel (JobSystem), four
+// pixels per SIMD operation. Only front faces (clockwise, as the default
+// rasterizer state) are rasterized and each pixel keeps the nearest depth.
+// Bounds are hidden when their nearest depth is farther than the depth of
+// every pixel of their screen rectangle. The farthest depth of each tile
+// skips the pixel tests of tiles that fully hide them.
+//
+//////////////////////////////////////////////////////////////////////////
+
+namespace BRE {
+	class TransformArray;
+
+	class OcclusionCuller {
+	public:
+		static const unsigned int sTileWidth = 32U;
+		static const unsigned int sTileHeight = 8U;
+
+		// Size in pixels of the depth buffer. It is rounded up to whole tiles.
+		OcclusionCuller(const unsigned int width, const unsigned int height);
+
+		const OcclusionCuller& operator=(const OcclusionCuller& rhs) = delete;
+
+		// Model space triangle list. Its world matrix is the transform of the array.
+		void AddOccluder(const std::vector<DirectX::XMFLOAT3>& vertices, const std::vector<unsigned int>& indices, const size_t transform);
+		size_t NumOccluders() const { return mOccluders.size(); }
+
+		// Clears the depth buffer and rasterizes the occluders
+		void RenderOccluders(const DirectX::XMMATRIX& viewProj, const TransformArray& transforms);
+
+		// World space bounds, after RenderOccluders() with the same matrix. False if
+		// they are outside the screen or hidden by occluders.
+		bool IsVisible(const BoundingVolumeHierarchy::Aabb& bounds) const;
+		// Removes objects of the hierarchy hidden by occluders (in parallel). The order of the others is kept.
+		void RemoveOccluded(const BoundingVolumeHierarchy& bvh, std::vector<std::uint32_t>& objects);
+
+		unsigned int Width() const { return mTilesX * sTileWidth; }
+		unsigned int Height() const { return mTilesY * sTileHeight; }
+		// Row 0 is the top one. 1.0 where there are no occluders.
+		float Depth(const unsigned int x, const unsigned int y) const;
+
+	private:
+		struct Occluder {
+			size_t mTransform;
+			size_t mFirstVertex;
+			size_t mNumVertices;
+			size_t mFirstIndex;
+			size_t mNumIndices;
+		};
+
+		// Screen space triangle. Pixels are inside when the three edge functions
+		// (a * x + b * y + c) are not negative at their centers.
+		struct Triangle {
+			float mEdgeA[3];
+			float mEdgeB[3];
+			float mEdgeC[3];
+			// Depth is a * x + b * y + c
+			float mDepthA;
+			float mDepthB;
+			float mDepthC;
+			// Pixel bounds (inclusive), inside the buffer
+			int mMinX;
+			int mMinY;
+			int mMaxX;
+			int mMaxY;
+		};
+
+		// Clips the triangle by the near plane and adds the result
+		void SetupTriangle(const DirectX::XMFLOAT4 clipVertices[3]);
+		// Appends front facing triangles that cover pixel centers and bins them into tiles
+		void AddScreenTriangle(const DirectX::XMFLOAT3 vertices[3]);
+		void RasterizeTile(const size_t tile);
+
+		unsigned int mTilesX;
+		unsigned int mTilesY;
+
+		std::vector<Occluder> mOccluders;
+		std::vector<DirectX::XMFLOAT3> mVertices;
+		std::vector<unsigned int> mIndices;
+
+		// Of this frame: clip space vertices of the occluders, their triangles,
+		// and the triangles of each tile
+		std::vector<DirectX::XMFLOAT4> mClipVertices;
+		std::vector<Triangle> mTriangles;
+		std::vector<std::vector<std::uint32_t>> mTileTriangles;
+
+		// Tiles are contiguous, row by row. Each element holds four pixels of a tile row.
+		std::vector<DirectX::XMFLOAT4> mDepth;
+		std::vector<float> mTileMaxDepth;
+		// Of the last RenderOccluders()
+		DirectX::XMFLOAT4X4 mViewProj;
+
+		std::vector<std::uint8_t> mVisible;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,165 @@
+#include "TransformArray.h"
+
+#include <algorithm>
+#include <iterator>
+
+#include <general/JobSystem.h>
+#include <general/Profiler.h>
+#include <utils/Assert.h>
+
+using namespace DirectX;
+
+namespace {
+	// Blocks (of four draws) computed by each job
+	const size_t sBlocksPerJob = 256U;
+
+	float& Lane(XMFLOAT4& vector, const size_t lane) {
+		return (&vector.x)[lane];
+	}
+
+	float Lane(const XMFLOAT4& vector, const size_t lane) {
+		return (&vector.x)[lane];
+	}
+
+	// Each element (row, column) of the matrix replicated in a vector
+	void ReplicateElements(const XMMATRIX& matrix, XMVECTOR elements[16]) {
+		XMFLOAT4X4 m;
+		XMStoreFloat4x4(&m, matrix);
+		for (size_t row = 0U; row < 4U; ++row) {
+			for (size_t column = 0U; column < 4U; ++column) {
+				elements[row * 4U + column] = XMVectorReplicate(m.m[row][column]);
+			}
+		}
+	}
+
+	// result = a * b, for the four matrices of a. b elements are replicated.
+	void Multiply(const XMVECTOR a[16], const XMVECTOR b[16], XMVECTOR result[16]) {
+		for (size_t row = 0U; row < 4U; ++row) {
+			for (size_t column = 0U; column < 4U; ++column) {
+				XMVECTOR element = XMVectorMultiply(a[row * 4U], b[column]);
+				element = XMVectorMultiplyAdd(a[row * 4U + 1U], b[4U + column], element);
+				element = XMVectorMultiplyAdd(a[row * 4U + 2U], b[8U + column], element);
+				element = XMVectorMultiplyAdd(a[row * 4U + 3U], b[12U + column], element);
+				result[row * 4U + column] = element;
+			}
+		}
+	}
+
+	// Row of the transposed matrix is the column of the matrix, so each column of the
+	// four matrices is transposed to get that row of each one.
+	void StoreTransposed(const XMVECTOR elements[16], XMFLOAT4X4* const matrices[4]) {
+		for (size_t column = 0U; column < 4U; ++column) {
+			const XMMATRIX rows = XMMatrixTranspose(XMMATRIX(elements[column], elements[4U + column], elements[8U + column], elements[12U + column]));
+			for (size_t lane = 0U; lane < 4U; ++lane) {
+				XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(&matrices[lane]->m[column][0]), rows.r[lane]);
+			}
+		}
+	}
+}
+
+namespace BRE {
+	size_t TransformArray::Add(const XMMATRIX& world) {
+		const size_t index = mSize;
+		if (index / 4U == mBlocks.size()) {
+			// Lanes without a draw stay zero
+			Block block;
+			std::fill(std::begin(block.mElements), std::end(block.mElements), XMFLOAT4(0.0f, 0.0f, 0.0f, 0.0f));
+			mBlocks.push_back(block);
+			mDrawTransforms.resize(mBlocks.size() * 4U);
+			mBlockSelected.push_back(0U);
+		}
+		++mSize;
+		Set(index, world);
+		return index;
+	}
+
+	void TransformArray::Set(const size_t index, const XMMATRIX& world) {
+		BRE_ASSERT(index < mSize);
+		XMFLOAT4X4 m;
+		XMStoreFloat4x4(&m, world);
+		Block& block = mBlocks[index / 4U];
+		for (size_t element = 0U; element < 16U; ++element) {
+			Lane(block.mElements[element], index % 4U) = m.m[element / 4U][element % 4U];
+		}
+	}
+
+	XMMATRIX TransformArray::World(const size_t index) const {
+		BRE_ASSERT(index < mSize);
+		const Block& block = mBlocks[index / 4U];
+		XMFLOAT4X4 m;
+		for (size_t element = 0U; element < 16U; ++element) {
+			m.m[element / 4U][element % 4U] = Lane(block.mElements[element], index % 4U);
+		}
+		return XMLoadFloat4x4(&m);
+	}
+
+	void TransformArray::ComputeDrawTransforms(const XMMATRIX& view, const XMMATRIX& proj) {
+		BRE_PROFILE_SCOPE("TransformArray::ComputeDrawTransforms");
+		XMVECTOR viewElements[16];
+		ReplicateElements(view, viewElements);
+		XMVECTOR viewProjElements[16];
+		ReplicateElements(XMMatrixMultiply(view, proj), viewProjElements);
+
+		const size_t numBlocks = mBlocks.size();
+		const auto computeBlocks = [this, &viewElements, &viewProjElements](const size_t begin, const size_t end) {
+			for (size_t iBlock = begin; iBlock < end; ++iBlock) {
+				ComputeBlock(iBlock, viewElements, viewProjElements);
+			}
+		};
+		if (numBlocks <= sBlocksPerJob || JobSystem::gInstance == nullptr) {
+			computeBlocks(0U, numBlocks);
+			return;
+		}
+		JobSystem::gInstance->ParallelFor(0U, numBlocks, sBlocksPerJob, computeBlocks, "TransformArray::ComputeBlocks");
+	}
+
+	void TransformArray::ComputeDrawTransforms(const XMMATRIX& view, const XMMATRIX& proj, const std::vector<size_t>& indices) {
+		BRE_PROFILE_SCOPE("TransformArray::ComputeDrawTransforms");
+		mSelectedBlocks.clear();
+		for (const size_t index : indices) {
+			BRE_ASSERT(index < mSize);
+			const size_t iBlock = index / 4U;
+			if (mBlockSelected[iBlock] == 0U) {
+				mBlockSelected[iBlock] = 1U;
+				mSelectedBlocks.push_back(iBlock);
+			}
+		}
+		for (const size_t iBlock : mSelectedBlocks) {
+			mBlockSelected[iBlock] = 0U;
+		}
+
+		XMVECTOR viewElements[16];
+		ReplicateElements(view, viewElements);
+		XMVECTOR viewProjElements[16];
+		ReplicateElements(XMMatrixMultiply(view, proj), viewProjElements);
+
+		const size_t numBlocks = mSelectedBlocks.size();
+		const auto computeBlocks = [this, &viewElements, &viewProjElements](const size_t begin, const size_t end) {
+			for (size_t i = begin; i < end; ++i) {
+				ComputeBlock(mSelectedBlocks[i], viewElements, viewProjElements);
+			}
+		};
+		if (numBlocks <= sBlocksPerJob || JobSystem::gInstance == nullptr) {
+			computeBlocks(0U, numBlocks);
+			return;
+		}
+		JobSystem::gInstance->ParallelFor(0U, numBlocks, sBlocksPerJob, computeBlocks, "TransformArray::ComputeBlocks");
+	}
+
+	void TransformArray::ComputeBlock(const size_t iBlock, const XMVECTOR* view, const XMVECTOR* viewProj) {
+		BRE_ASSERT(iBlock < mBlocks.size());
+		const Block& block = mBlocks[iBlock];
+		XMVECTOR world[16];
+		for (size_t element = 0U; element < 16U; ++element) {
+			world[element] = XMLoadFloat4(&block.mElements[element]);
+		}
+		DrawTransforms* drawTransforms = &mDrawTransforms[iBlock * 4U];
+		XMFLOAT4X4* const worldViews[4] = { &drawTransforms[0].mWorldView, &drawTransforms[1].mWorldView, &drawTransforms[2].mWorldView, &drawTransforms[3].mWorldView };
+		XMFLOAT4X4* const worldViewProjs[4] = { &drawTransforms[0].mWorldViewProjection, &drawTransforms[1].mWorldViewProjection, &drawTransforms[2].mWorldViewProjection, &drawTransforms[3].mWorldViewProjection };
+		XMVECTOR result[16];
+		Multiply(world, view, result);
+		StoreTransposed(result, worldViews);
+		Multiply(world, viewProj, result);
+		StoreTransposed(result, worldViewProjs);
+	}
+}
\ No newline at end of file
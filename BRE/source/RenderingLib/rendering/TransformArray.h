@@ -0,0 +1,57 @@
+#pragma once
+
+#include <DirectXMath.h>
+#include <cstdint>
+#include <vector>
+
+//////////////////////////////////////////////////////////////////////////
+//
+// World matrices of every draw, stored in blocks of four matrices where
+// each element (row, column) of the four matrices is a vector (structure
+// of arrays). ComputeDrawTransforms() computes world * view and
+// world * view * projection of four draws per SIMD operation, over
+// chunks of blocks in parallel (JobSystem), and writes them transposed
+// (as HLSL expects them) into one contiguous array.
+// Draw transforms can be computed for some indices only (draws left after
+// culling): the blocks that hold them are computed.
+// Drawers only keep the index of their world matrix.
+//
+//////////////////////////////////////////////////////////////////////////
+
+namespace BRE {
+	class TransformArray {
+	public:
+		// Transposed
+		struct DrawTransforms {
+			DirectX::XMFLOAT4X4 mWorldView;
+			DirectX::XMFLOAT4X4 mWorldViewProjection;
+		};
+
+		size_t Add(const DirectX::XMMATRIX& world);
+		void Set(const size_t index, const DirectX::XMMATRIX& world);
+		DirectX::XMMATRIX World(const size_t index) const;
+		size_t Size() const { return mSize; }
+
+		void ComputeDrawTransforms(const DirectX::XMMATRIX& view, const DirectX::XMMATRIX& proj);
+		// Only for these indices (they can be repeated)
+		void ComputeDrawTransforms(const DirectX::XMMATRIX& view, const DirectX::XMMATRIX& proj, const std::vector<size_t>& indices);
+		// Valid after ComputeDrawTransforms() computed the index
+		const DrawTransforms& GetDrawTransforms(const size_t index) const { return mDrawTransforms[index]; }
+
+	private:
+		struct Block {
+			// Element (row, column) of each matrix is mElements[row * 4 + column]
+			DirectX::XMFLOAT4 mElements[16];
+		};
+
+		void ComputeBlock(const size_t iBlock, const DirectX::XMVECTOR* view, const DirectX::XMVECTOR* viewProj);
+
+		std::vector<Block> mBlocks;
+		size_t mSize = 0U;
+		// Four per block
+		std::vector<DrawTransforms> mDrawTransforms;
+		// Blocks of the indices to compute, and whether each block is one of them
+		std::vector<size_t> mSelectedBlocks;
+		std::vector<std::uint8_t> mBlockSelected;
+	};
+}
\ No newline at end of file
@@ -7,6 +7,7 @@
 #include <general/Application.h>
 #include <rendering/models/Model.h>
 #include <utils/Assert.h>
+#include <utils/MathUtils.h>
 
 using namespace DirectX;
 
@@ -66,6 +67,9 @@ namespace BRE {
 			mIndices.push_back(face->mIndices[1]);
 			mIndices.push_back(face->mIndices[2]);
 		}
+
+		// Levels of detail
+		MeshLod::Generate(mVertices, mNormals, mTextureCoordinates, mIndices, Utils::BoundingSphere(mVertices, XMMatrixIdentity()).w, mLods, mLodIndices);
 		
 
 		// Tangents and Binormals
@@ -1,14 +1,18 @@
 #pragma once
 
 #include <DirectXMath.h>
+#include <string>
 #include <vector>
 
+#include <rendering/models/MeshLod.h>
+
 struct aiMesh;
 struct ID3D11Buffer;
 struct ID3D11Device1;
 
 namespace BRE {
 	class Material;
+	class Model;
 	class ModelMaterial;
 
 	class Mesh {
@@ -30,6 +34,9 @@ namespace BRE {
 		const std::vector<DirectX::XMFLOAT4>& Colors() const { return mColors; }
 		unsigned int FaceCount() const { return mFaceCount; }
 		const std::vector<unsigned int>& Indices() const { return mIndices; }
+		// Level 0 is Indices(). Next levels are ranges of LodIndices(), after Indices().
+		const std::vector<MeshLod>& Lods() const { return mLods; }
+		const std::vector<unsigned int>& LodIndices() const { return mLodIndices; }
 
 	private:
 		Mesh(Model& model, const aiMesh& mesh);
@@ -45,5 +52,7 @@ namespace BRE {
 		std::vector<DirectX::XMFLOAT4> mColors;
 		unsigned int mFaceCount;
 		std::vector<unsigned int> mIndices;
+		std::vector<MeshLod> mLods;
+		std::vector<unsigned int> mLodIndices;
 	};
 }
\ No newline at end of file
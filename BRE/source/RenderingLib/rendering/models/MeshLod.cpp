@@ -0,0 +1,62 @@
+#include "MeshLod.h"
+
+#include <algorithm>
+#include <cfloat>
+
+#include <utils/Assert.h>
+#include <utils/MeshSimplifier.h>
+
+using namespace DirectX;
+
+namespace {
+	const unsigned int sMaxLods = 5U;
+	// Meshes with fewer triangles are not simplified
+	const size_t sMinSimplifiedIndices = 64U * 3U;
+	// The chain stops when a level keeps more of the previous one triangles
+	const float sMinReduction = 0.8f;
+	// Screen height fraction of the error, about a pixel at 1080p
+	const float sMaxScreenError = 1.0f / 1080.0f;
+	const float sHysteresis = 0.15f;
+}
+
+namespace BRE {
+	void MeshLod::Generate(const std::vector<XMFLOAT3>& positions, const std::vector<XMFLOAT3>& normals, const std::vector<XMFLOAT3>& textureCoordinates, const std::vector<unsigned int>& indices, const float radius, std::vector<MeshLod>& lods, std::vector<unsigned int>& lodIndices) {
+		BRE_ASSERT(!indices.empty());
+		lods.clear();
+		lodIndices.clear();
+		lods.push_back(MeshLod{ 0U, static_cast<unsigned int>(indices.size()), FLT_MAX });
+
+		// Each level simplifies the previous one, so errors add up
+		const MeshSimplifier::Settings settings;
+		std::vector<unsigned int> previous(indices);
+		std::vector<unsigned int> simplified;
+		float error = 0.0f;
+		while (radius > 0.0f && lods.size() < sMaxLods && previous.size() >= sMinSimplifiedIndices * 2U) {
+			const size_t targetIndexCount = previous.size() / 6U * 3U;
+			error += MeshSimplifier::Simplify(positions, normals, textureCoordinates, previous, targetIndexCount, settings, simplified);
+			if (simplified.empty() || simplified.size() > previous.size() * sMinReduction) {
+				break;
+			}
+			// The error projects to relativeError * screenFraction / 2 of the screen height
+			const float relativeError = error / radius;
+			const float maxScreenFraction = relativeError > 0.0f ? 2.0f * sMaxScreenError / relativeError : FLT_MAX;
+			lods.push_back(MeshLod{ static_cast<unsigned int>(indices.size() + lodIndices.size()), static_cast<unsigned int>(simplified.size()), (std::min)(maxScreenFraction, lods.back().mMaxScreenFraction) });
+			lodIndices.insert(lodIndices.end(), simplified.begin(), simplified.end());
+			previous.swap(simplified);
+		}
+	}
+
+	unsigned int MeshLod::Select(const std::vector<MeshLod>& lods, const unsigned int currentLod, const float screenFraction) {
+		BRE_ASSERT(!lods.empty());
+		const unsigned int numLods = static_cast<unsigned int>(lods.size());
+		unsigned int lod = (std::min)(currentLod, numLods - 1U);
+		// Finer while the error of the level is visible, coarser while the one of the next level is not
+		while (lod > 0U && screenFraction > lods[lod].mMaxScreenFraction * (1.0f + sHysteresis)) {
+			--lod;
+		}
+		while (lod + 1U < numLods && screenFraction < lods[lod + 1U].mMaxScreenFraction * (1.0f - sHysteresis)) {
+			++lod;
+		}
+		return lod;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <DirectXMath.h>
+#include <vector>
+
+namespace BRE {
+	// Level of detail of a mesh. Levels are ranges of the mesh indices
+	// (Model::CreateIndices), so they share its vertices.
+	struct MeshLod {
+		// Level 0 is indices. Each next level has about half the triangles of
+		// the previous one, until the simplification stops (borders are locked).
+		// Their indices are appended to lodIndices, which go after indices in
+		// the index buffer. radius is the bounding sphere radius of the mesh.
+		static void Generate(const std::vector<DirectX::XMFLOAT3>& positions, const std::vector<DirectX::XMFLOAT3>& normals, const std::vector<DirectX::XMFLOAT3>& textureCoordinates, const std::vector<unsigned int>& indices, const float radius, std::vector<MeshLod>& lods, std::vector<unsigned int>& lodIndices);
+
+		// Level to draw at the projected screen fraction (Utils::ProjectedScreenFraction)
+		// of the bounding sphere. Thresholds have hysteresis, so the level does
+		// not flicker while the fraction stays close to one of them.
+		static unsigned int Select(const std::vector<MeshLod>& lods, const unsigned int currentLod, const float screenFraction);
+
+		unsigned int mStartIndex;
+		unsigned int mIndexCount;
+		// Largest projected screen fraction the level error is below a pixel at
+		float mMaxScreenFraction;
+	};
+}
\ No newline at end of file
@@ -1,18 +1,109 @@
 #include "Model.h"
 
+#include <algorithm>
 #include <assimp/Importer.hpp>
+#include <assimp/IOStream.hpp>
+#include <assimp/IOSystem.hpp>
 #include <assimp/postprocess.h>
 #include <assimp/scene.h>
-#include <d3d11_1.h>
+#include <cstring>
 #include <iostream>
-#include <sstream>
 
-#include <managers/ShaderResourcesManager.h>
+#include <general/JobSystem.h>
+#include <managers/VirtualFileSystem.h>
 #include <rendering/models/ModelMaterial.h>
 #include <rendering/models/Mesh.h>
 #include <utils/Assert.h>
-#include <utils/Hash.h>
-#include <utils/DXUtils.h>
+
+namespace {
+	// Read only file read whole through VirtualFileSystem
+	class ContentIOStream : public Assimp::IOStream {
+	public:
+		explicit ContentIOStream(std::vector<std::uint8_t>& data) {
+			mData.swap(data);
+		}
+
+		size_t Read(void* buffer, size_t size, size_t count) override {
+			if (size == 0U) {
+				return 0U;
+			}
+			count = (std::min)(count, (mData.size() - mPosition) / size);
+			memcpy(buffer, mData.data() + mPosition, size * count);
+			mPosition += size * count;
+			return count;
+		}
+
+		size_t Write(const void* /*buffer*/, size_t /*size*/, size_t /*count*/) override {
+			return 0U;
+		}
+
+		aiReturn Seek(size_t offset, aiOrigin origin) override {
+			size_t position;
+			switch (origin) {
+			case aiOrigin_SET:
+				position = offset;
+				break;
+			case aiOrigin_CUR:
+				position = mPosition + offset;
+				break;
+			case aiOrigin_END:
+				position = mData.size() - offset;
+				break;
+			default:
+				return aiReturn_FAILURE;
+			}
+			if (position > mData.size()) {
+				return aiReturn_FAILURE;
+			}
+			mPosition = position;
+			return aiReturn_SUCCESS;
+		}
+
+		size_t Tell() const override {
+			return mPosition;
+		}
+
+		size_t FileSize() const override {
+			return mData.size();
+		}
+
+		void Flush() override {
+		}
+
+	private:
+		std::vector<std::uint8_t> mData;
+		size_t mPosition = 0U;
+	};
+
+	// Models and the files they reference (OBJ materials) are resolved through content packs
+	class ContentIOSystem : public Assimp::IOSystem {
+	public:
+		bool Exists(const char* file) const override {
+			return BRE::VirtualFileSystem::gInstance->Exists(file);
+		}
+
+		char getOsSeparator() const override {
+			return '\\';
+		}
+
+		Assimp::IOStream* Open(const char* file, const char* mode) override {
+			BRE_ASSERT(file);
+			BRE_ASSERT(mode);
+			if (strchr(mode, 'w') || strchr(mode, 'a')) {
+				return nullptr;
+			}
+			std::vector<std::uint8_t> data;
+			if (!BRE::VirtualFileSystem::gInstance->ReadFile(file, data)) {
+				return nullptr;
+			}
+			return new ContentIOStream(data);
+		}
+
+		void Close(Assimp::IOStream* stream) override {
+			delete stream;
+		}
+	};
+}
 
 namespace BRE {
 	Model::Model(const char* filename) 
@@ -20,6 +111,9 @@ namespace BRE {
 	{
 		BRE_ASSERT(filename);
 		Assimp::Importer importer;
+		BRE_ASSERT(VirtualFileSystem::gInstance);
+		// The importer deletes it
+		importer.SetIOHandler(new ContentIOSystem());
 		const unsigned int flags = aiProcessPreset_TargetRealtime_Fast | aiProcess_ConvertToLeftHanded;
 		const aiScene* scene = importer.ReadFile(filename, flags);
 		if (!scene) {
@@ -34,10 +128,14 @@ namespace BRE {
 			}
 		}
 		if (scene->HasMeshes()) {
-			for (unsigned int i = 0; i < scene->mNumMeshes; ++i) {
-				aiMesh* mesh = scene->mMeshes[i];
-				mMeshes.push_back(new Mesh(*this, *(mesh)));
-			}
+			// Meshes only read the scene and the materials, so they are copied in parallel
+			mMeshes.resize(scene->mNumMeshes);
+			BRE_ASSERT(JobSystem::gInstance);
+			JobSystem::gInstance->ParallelFor(0U, mMeshes.size(), 1U, [this, scene](const size_t begin, const size_t end) {
+				for (size_t i = begin; i < end; ++i) {
+					mMeshes[i] = new Mesh(*this, *scene->mMeshes[i]);
+				}
+			}, "Model::Meshes");
 		}
 	}
 
@@ -50,28 +148,13 @@ namespace BRE {
 		}
 	}
 
-	size_t Model::CreateIndexBuffer(const size_t meshIndex, ID3D11Buffer* *buffer) const {
+	void Model::CreateIndices(const size_t meshIndex, std::vector<unsigned int>& indices) const {
 		BRE_ASSERT(meshIndex < mMeshes.size());
-
-		// Check if there is already a buffer for current model
-		std::stringstream stream;
-		stream << meshIndex;
-		const std::string bufferName = mFilename + std::string("_indexBuffer_") + stream.str();
-		const size_t bufferId = Utils::Hash(bufferName.c_str());
-		ID3D11Buffer* elem = ShaderResourcesManager::gInstance->Buffer(bufferId);
-		if (elem) {
-			if (buffer) *buffer = elem;
-			return bufferId;
-		}
-
-		// Create buffer
-		BRE::Mesh& mesh = *Meshes()[meshIndex];
+		const BRE::Mesh& mesh = *mMeshes[meshIndex];
 		BRE_ASSERT(!mesh.Indices().empty());
-		std::vector<unsigned int> indices;
+		indices.clear();
+		indices.reserve(mesh.Indices().size() + mesh.LodIndices().size());
 		indices.insert(indices.end(), mesh.Indices().begin(), mesh.Indices().end());
-		const unsigned int bufferSize = static_cast<unsigned int> (indices.size() * sizeof(unsigned int));
-		Utils::CreateInitializedBuffer(bufferName.c_str(), &indices[0], bufferSize, D3D11_USAGE_IMMUTABLE, D3D11_BIND_INDEX_BUFFER, buffer);
-
-		return bufferId;
+		indices.insert(indices.end(), mesh.LodIndices().begin(), mesh.LodIndices().end());
 	}
 }
\ No newline at end of file
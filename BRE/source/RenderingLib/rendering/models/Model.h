@@ -3,8 +3,6 @@
 #include <string>
 #include <vector>
 
-struct ID3D11Buffer;
-
 namespace BRE {
 	class Mesh;
 	class ModelMaterial;
@@ -22,7 +20,8 @@ namespace BRE {
 		const std::vector<Mesh*>& Meshes() const { return mMeshes; }
 		const std::vector<ModelMaterial*>& Materials() const { return mMaterials; }
 
-		size_t CreateIndexBuffer(const size_t meshIndex, ID3D11Buffer* *buffer = nullptr) const;
+		// Indices of all the levels of detail of the mesh (Mesh::Lods()), for GeometryPool
+		void CreateIndices(const size_t meshIndex, std::vector<unsigned int>& indices) const;
 
 	private:
 		std::string mFilename;
@@ -0,0 +1,51 @@
+#include "DrawerSettings.h"
+
+#include <yaml-cpp/yaml.h>
+
+#include <utils/YamlUtils.h>
+
+namespace BRE {
+	bool DrawerSettings::Read(const YAML::Node& node, DrawerSettings& settings) {
+		if (!YamlUtils::IsDefined(node, "renderType") || !YamlUtils::IsDefined(node, "path") || !YamlUtils::IsDefined(node, "material")) {
+			return false;
+		}
+		settings.mRenderType = YamlUtils::GetScalar<std::string>(node, "renderType");
+		settings.mPath = YamlUtils::GetScalar<std::string>(node, "path");
+		settings.mMaterial = YamlUtils::GetScalar<std::string>(node, "material");
+		settings.mNormalMapTexture = YamlUtils::IsDefined(node, "normalMapTexture") ? YamlUtils::GetScalar<std::string>(node, "normalMapTexture") : std::string();
+
+		if (settings.mRenderType == "Basic") {
+			return true;
+		}
+		if (settings.mRenderType != "Normal" && settings.mRenderType != "Normal_Displacement") {
+			return false;
+		}
+
+		if (!YamlUtils::IsDefined(node, "textureScaleFactor")) {
+			return false;
+		}
+		settings.mTextureScaleFactor = YamlUtils::GetScalar<float>(node, "textureScaleFactor");
+		if (settings.mRenderType == "Normal") {
+			return true;
+		}
+
+		if (!YamlUtils::IsDefined(node, "displacementMapTexture") || !YamlUtils::IsDefined(node, "displacementScale")) {
+			return false;
+		}
+		settings.mDisplacementMapTexture = YamlUtils::GetScalar<std::string>(node, "displacementMapTexture");
+		settings.mDisplacementScale = YamlUtils::GetScalar<float>(node, "displacementScale");
+		// Adaptive tessellation between the min and max factors, or a constant factor
+		if (YamlUtils::IsDefined(node, "maxTessellationFactor")) {
+			settings.mMinTessellationFactor = YamlUtils::IsDefined(node, "minTessellationFactor") ? YamlUtils::GetScalar<float>(node, "minTessellationFactor") : 1.0f;
+			settings.mMaxTessellationFactor = YamlUtils::GetScalar<float>(node, "maxTessellationFactor");
+		}
+		else if (YamlUtils::IsDefined(node, "tessellationFactor")) {
+			settings.mMinTessellationFactor = YamlUtils::GetScalar<float>(node, "tessellationFactor");
+			settings.mMaxTessellationFactor = settings.mMinTessellationFactor;
+		}
+		else {
+			return false;
+		}
+		return settings.mMinTessellationFactor >= 1.0f && settings.mMinTessellationFactor <= settings.mMaxTessellationFactor;
+	}
+}
\ No newline at end of file
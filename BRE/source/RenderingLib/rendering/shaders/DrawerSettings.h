@@ -0,0 +1,31 @@
+#pragma once
+
+#include <string>
+
+namespace YAML {
+	class Node;
+}
+
+namespace BRE {
+	// Keys of a models.yml node that drawers are created from.
+	// Basic needs path and material. Normal also needs textureScaleFactor.
+	// Normal_Displacement also needs displacementMapTexture,
+	// displacementScale and tessellationFactor (constant) or
+	// maxTessellationFactor with an optional minTessellationFactor (adaptive).
+	// normalMapTexture is optional.
+	struct DrawerSettings {
+		// Returns false if the render type is unknown or a key it needs is missing
+		static bool Read(const YAML::Node& node, DrawerSettings& settings);
+
+		std::string mRenderType;
+		std::string mPath;
+		std::string mMaterial;
+		float mTextureScaleFactor = 1.0f;
+		// Empty if it is not defined
+		std::string mNormalMapTexture;
+		std::string mDisplacementMapTexture;
+		float mDisplacementScale = 0.0f;
+		float mMinTessellationFactor = 1.0f;
+		float mMaxTessellationFactor = 1.0f;
+	};
+}
\ No newline at end of file
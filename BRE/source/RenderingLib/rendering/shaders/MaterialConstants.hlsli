@@ -0,0 +1,12 @@
+#ifndef MATERIAL_CONSTANTS_HEADER
+#define MATERIAL_CONSTANTS_HEADER
+
+// Values of uniform material textures (see MaterialManager).
+// Packed pixel shaders read them instead of sampling when
+// UNIFORM_BASE_COLOR or UNIFORM_SMOOTHNESS_METAL_MASK_CURVATURE are defined.
+cbuffer MaterialConstants : register (b0) {
+	float3 BaseColorValue;
+	float3 SmoothnessMetalMaskCurvatureValue;
+};
+
+#endif
\ No newline at end of file
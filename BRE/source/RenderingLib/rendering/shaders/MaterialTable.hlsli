@@ -0,0 +1,70 @@
+#ifndef MATERIAL_TABLE_HEADER
+#define MATERIAL_TABLE_HEADER
+
+// Materials of MaterialTable. Pools and records are bound once for the
+// whole geometry pass, and MaterialIndexValue selects the record of the draw.
+#define MATERIAL_TABLE_UNIFORM_BASE_COLOR 1
+#define MATERIAL_TABLE_UNIFORM_SMOOTHNESS_METAL_MASK_CURVATURE 2
+
+struct MaterialRecord {
+	uint NormalPool;
+	uint NormalSlice;
+	uint BaseColorPool;
+	uint BaseColorSlice;
+	uint SmoothnessMetalMaskCurvaturePool;
+	uint SmoothnessMetalMaskCurvatureSlice;
+	uint UniformMask;
+	uint Padding;
+	float4 BaseColorValue;
+	float4 SmoothnessMetalMaskCurvatureValue;
+};
+
+Texture2DArray MaterialPool0 : register (t8);
+Texture2DArray MaterialPool1 : register (t9);
+Texture2DArray MaterialPool2 : register (t10);
+Texture2DArray MaterialPool3 : register (t11);
+Texture2DArray MaterialPool4 : register (t12);
+Texture2DArray MaterialPool5 : register (t13);
+Texture2DArray MaterialPool6 : register (t14);
+Texture2DArray MaterialPool7 : register (t15);
+StructuredBuffer<MaterialRecord> MaterialRecords : register (t16);
+
+cbuffer MaterialIndex : register (b0) {
+	uint MaterialIndexValue;
+};
+
+// Shader model 5.0 cannot index texture arrays with a variable, so pools are
+// selected with a switch. The pool is the same for the whole draw. Gradients
+// are computed before the branch.
+float4 SampleMaterialPool(const uint pool, const uint slice, SamplerState texSampler, const float2 texCoord) {
+	const float3 location = float3(texCoord, slice);
+	const float2 texCoordDx = ddx(texCoord);
+	const float2 texCoordDy = ddy(texCoord);
+	[branch] switch (pool) {
+	case 0: return MaterialPool0.SampleGrad(texSampler, location, texCoordDx, texCoordDy);
+	case 1: return MaterialPool1.SampleGrad(texSampler, location, texCoordDx, texCoordDy);
+	case 2: return MaterialPool2.SampleGrad(texSampler, location, texCoordDx, texCoordDy);
+	case 3: return MaterialPool3.SampleGrad(texSampler, location, texCoordDx, texCoordDy);
+	case 4: return MaterialPool4.SampleGrad(texSampler, location, texCoordDx, texCoordDy);
+	case 5: return MaterialPool5.SampleGrad(texSampler, location, texCoordDx, texCoordDy);
+	case 6: return MaterialPool6.SampleGrad(texSampler, location, texCoordDx, texCoordDy);
+	default: return MaterialPool7.SampleGrad(texSampler, location, texCoordDx, texCoordDy);
+	}
+}
+
+float3 MaterialBaseColor(const MaterialRecord record, SamplerState texSampler, const float2 texCoord) {
+	[branch] if ((record.UniformMask & MATERIAL_TABLE_UNIFORM_BASE_COLOR) != 0) {
+		return record.BaseColorValue.rgb;
+	}
+	return SampleMaterialPool(record.BaseColorPool, record.BaseColorSlice, texSampler, texCoord).rgb;
+}
+
+// R: smoothness, G: metal mask, B: curvature
+float3 MaterialSmoothnessMetalMaskCurvature(const MaterialRecord record, SamplerState texSampler, const float2 texCoord) {
+	[branch] if ((record.UniformMask & MATERIAL_TABLE_UNIFORM_SMOOTHNESS_METAL_MASK_CURVATURE) != 0) {
+		return record.SmoothnessMetalMaskCurvatureValue.rgb;
+	}
+	return SampleMaterialPool(record.SmoothnessMetalMaskCurvaturePool, record.SmoothnessMetalMaskCurvatureSlice, texSampler, texCoord).rgb;
+}
+
+#endif
\ No newline at end of file
@@ -33,3 +33,10 @@ float3 UnmapNormal(const float3 n) {
 	return n * 2.0f - float3(1.0f, 1.0f, 1.0f);
 }
 
+// UnMap a normal whose X and Y are stored in [0.0f, 1.0f] (two channels
+// textures like BC5) and reconstruct Z (tangent space normals point outwards)
+float3 UnmapNormalXY(const float2 n) {
+	const float2 xy = n * 2.0f - float2(1.0f, 1.0f);
+	return float3(xy, sqrt(saturate(1.0f - dot(xy, xy))));
+}
+
@@ -1,9 +1,10 @@
 #pragma once
 
 #include <DirectXMath.h>
+#include <vector>
 
 namespace BRE {
-	class Model;
+	class Mesh;
 
 	struct NormalMappingVertexData {
 		DirectX::XMFLOAT4 mPosL;
@@ -14,7 +15,8 @@ namespace BRE {
 		NormalMappingVertexData();
 		NormalMappingVertexData(const DirectX::XMFLOAT4& posL, const DirectX::XMFLOAT2& texC, const DirectX::XMFLOAT3& normalL, const DirectX::XMFLOAT3& tangentL);
 
-		static size_t CreateVertexBuffer(const size_t modelId, const size_t meshIndex);
+		// Vertices of the mesh in this format (GeometryPool)
+		static void CreateVertices(const Mesh& mesh, std::vector<NormalMappingVertexData>& vertices);
 	};
 
 	struct BasicVertexData {
@@ -24,6 +26,6 @@ namespace BRE {
 		BasicVertexData();
 		BasicVertexData(const DirectX::XMFLOAT4& posL, const DirectX::XMFLOAT3& normalL);
 
-		static size_t CreateVertexBuffer(const size_t modelId, const size_t meshIndex);
+		static void CreateVertices(const Mesh& mesh, std::vector<BasicVertexData>& vertices);
 	};
 }
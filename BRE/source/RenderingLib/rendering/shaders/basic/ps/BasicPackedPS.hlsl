@@ -0,0 +1 @@
+#include <rendering/shaders/basic/ps/BasicPackedPS.hlsli>
\ No newline at end of file
@@ -0,0 +1,39 @@
+#include <rendering/shaders/MaterialConstants.hlsli>
+#include <rendering/shaders/Utils.hlsli>
+struct Input {
+	float4 PosCS : SV_Position;
+	float3 NormalVS : NORMAL;
+};
+
+struct Output {
+	float3 NormalVS : SV_Target0;
+	float3 BaseColor : SV_Target1;
+	float3 Smoothness_MetalMask_Curvature : SV_Target2;
+};
+
+SamplerState TexSampler : register (s0);
+
+#ifndef UNIFORM_BASE_COLOR
+Texture2D BaseColorTexture : register (t0);
+#endif
+#ifndef UNIFORM_SMOOTHNESS_METAL_MASK_CURVATURE
+// R: smoothness, G: metal mask, B: curvature
+Texture2D SmoothnessMetalMaskCurvatureTexture : register (t1);
+#endif
+
+Output main(Input input) {
+	Output output = (Output)0;
+	output.NormalVS = normalize(input.NormalVS);
+	const float2 texCoord = float2(0.0f, 0.0f);
+#ifdef UNIFORM_BASE_COLOR
+	output.BaseColor = BaseColorValue;
+#else
+	output.BaseColor = BaseColorTexture.Sample(TexSampler, texCoord).rgb;
+#endif
+#ifdef UNIFORM_SMOOTHNESS_METAL_MASK_CURVATURE
+	output.Smoothness_MetalMask_Curvature = SmoothnessMetalMaskCurvatureValue;
+#else
+	output.Smoothness_MetalMask_Curvature = SmoothnessMetalMaskCurvatureTexture.Sample(TexSampler, texCoord).rgb;
+#endif
+	return output;
+}
\ No newline at end of file
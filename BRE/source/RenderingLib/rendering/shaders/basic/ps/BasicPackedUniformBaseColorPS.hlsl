@@ -0,0 +1,2 @@
+#define UNIFORM_BASE_COLOR
+#include <rendering/shaders/basic/ps/BasicPackedPS.hlsli>
\ No newline at end of file
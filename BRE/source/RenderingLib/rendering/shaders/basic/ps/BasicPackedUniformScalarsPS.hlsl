@@ -0,0 +1,2 @@
+#define UNIFORM_SMOOTHNESS_METAL_MASK_CURVATURE
+#include <rendering/shaders/basic/ps/BasicPackedPS.hlsli>
\ No newline at end of file
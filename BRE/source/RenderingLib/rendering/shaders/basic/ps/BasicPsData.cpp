@@ -3,12 +3,21 @@
 #include <d3d11_1.h>
 #include <sstream>
 
+#include <general/CountedContext.h>
 #include <managers/MaterialManager.h>
 #include <managers/ShadersManager.h>
 #include <utils/Assert.h>
 
 namespace {
 	const char* shader = "content\\shaders\\basic\\BasicPS.cso";
+	// Indexed by MaterialManager uniform mask
+	const char* packedShaders[] = {
+		"content\\shaders\\basic\\BasicPackedPS.cso",
+		"content\\shaders\\basic\\BasicPackedUniformBaseColorPS.cso",
+		"content\\shaders\\basic\\BasicPackedUniformScalarsPS.cso",
+		"content\\shaders\\basic\\BasicPackedUniformPS.cso",
+	};
+	const char* tableShader = "content\\shaders\\basic\\BasicTablePS.cso";
 	const size_t sNumGBuffers = 3;
 }
 
@@ -16,30 +25,76 @@ namespace BRE {
 	BasicPixelShaderData::BasicPixelShaderData() {
 		ShadersManager::gInstance->LoadPixelShader(shader, &mShader);
 		BRE_ASSERT(mShader);
+		static_assert(ARRAYSIZE(packedShaders) == MaterialManager::sNumUniformPermutations, "One packed shader per uniform mask");
+		for (size_t i = 0U; i < ARRAYSIZE(packedShaders); ++i) {
+			ShadersManager::gInstance->LoadPixelShader(packedShaders[i], &mPackedShaders[i]);
+			BRE_ASSERT(mPackedShaders[i]);
+		}
+		ShadersManager::gInstance->LoadPixelShader(tableShader, &mTableShader);
+		BRE_ASSERT(mTableShader);
 	}
 
 	void BasicPixelShaderData::SetMaterial(const size_t matId) {
+		mMaterialId = matId;
+		FetchMaterial();
+	}
+
+	void BasicPixelShaderData::FetchMaterial() {
 		MaterialManager::MaterialData matData;
-		MaterialManager::gInstance->GetMaterial(matId, matData);
+		MaterialManager::gInstance->GetMaterial(mMaterialId, matData);
+		mUniformMask = matData.mUniformMask;
+		mMaterialConstantsBuffer = matData.mConstantsBuffer;
+		mTableIndexBuffer = matData.mTableIndexBuffer;
 		mBaseColorSRV = matData.mBaseColorSRV;
-		BRE_ASSERT(mBaseColorSRV);
-		mSmoothnessSRV = matData.mSmoothnessSRV; 
-		BRE_ASSERT(mSmoothnessSRV);
+		BRE_ASSERT(mBaseColorSRV || (mUniformMask & MaterialManager::sUniformBaseColor) != 0U);
+		mSmoothnessSRV = matData.mSmoothnessSRV;
 		mMetalMaskSRV = matData.mMetalMaskSRV;
-		BRE_ASSERT(mMetalMaskSRV);
 		mCurvatureSRV = matData.mCurvatureSRV;
-		BRE_ASSERT(mCurvatureSRV);
+		mSmoothnessMetalMaskCurvatureSRV = matData.mSmoothnessMetalMaskCurvatureSRV;
+		mSampler = matData.mSampler;
+		BRE_ASSERT(mSampler);
+		BRE_ASSERT(mSmoothnessMetalMaskCurvatureSRV || (mUniformMask & MaterialManager::sUniformSmoothnessMetalMaskCurvature) != 0U || (mSmoothnessSRV && mMetalMaskSRV && mCurvatureSRV));
+		mMaterialResident = matData.mResident;
+		mMaterialVersion = MaterialManager::gInstance->TextureViewsVersion();
 	}
 
 	void BasicPixelShaderData::PreDraw(ID3D11Device1& /*device*/, ID3D11DeviceContext1& context, ID3D11RenderTargetView* *geometryBuffersRTVs) {
-		BRE_ASSERT(mShader);
-		context.PSSetShader(mShader, nullptr, 0);
-		
-		ID3D11ShaderResourceView* const srvs[] = { mBaseColorSRV, mSmoothnessSRV, mMetalMaskSRV, mCurvatureSRV };
-		context.PSSetShaderResources(0, ARRAYSIZE(srvs), srvs);
+		BRE_COUNTER_ADD(RenderCounter::PreDrawCalls, 1U);
+		// Material textures are loaded on first use
+		if (!mMaterialResident) {
+			MaterialManager::gInstance->RequestResidency(mMaterialId);
+		}
+		if (mMaterialVersion != MaterialManager::gInstance->TextureViewsVersion()) {
+			FetchMaterial();
+		}
+		if (mTableIndexBuffer) {
+			// Material textures are bound once for the geometry pass (see MaterialTable)
+			BRE_ASSERT(mTableShader);
+			CountedContext::PSSetShader(context, mTableShader);
+			ID3D11Buffer* const cBuffers[] = { mTableIndexBuffer };
+			CountedContext::PSSetConstantBuffers(context, 0, ARRAYSIZE(cBuffers), cBuffers);
+		}
+		// Uniform textures are only used by packed materials
+		else if (mSmoothnessMetalMaskCurvatureSRV || mUniformMask != 0U) {
+			BRE_ASSERT(mUniformMask < ARRAYSIZE(mPackedShaders));
+			BRE_ASSERT(mPackedShaders[mUniformMask]);
+			CountedContext::PSSetShader(context, mPackedShaders[mUniformMask]);
+			ID3D11ShaderResourceView* const srvs[] = { mBaseColorSRV, mSmoothnessMetalMaskCurvatureSRV };
+			CountedContext::PSSetShaderResources(context, 0, ARRAYSIZE(srvs), srvs);
+			if (mMaterialConstantsBuffer) {
+				ID3D11Buffer* const cBuffers[] = { mMaterialConstantsBuffer };
+				CountedContext::PSSetConstantBuffers(context, 0, ARRAYSIZE(cBuffers), cBuffers);
+			}
+		}
+		else {
+			BRE_ASSERT(mShader);
+			CountedContext::PSSetShader(context, mShader);
+			ID3D11ShaderResourceView* const srvs[] = { mBaseColorSRV, mSmoothnessSRV, mMetalMaskSRV, mCurvatureSRV };
+			CountedContext::PSSetShaderResources(context, 0, ARRAYSIZE(srvs), srvs);
+		}
 
 		ID3D11SamplerState* const samplerStates[] = { mSampler };
-		context.PSSetSamplers(0, ARRAYSIZE(samplerStates), samplerStates);
+		CountedContext::PSSetSamplers(context, 0, ARRAYSIZE(samplerStates), samplerStates);
 
 		context.OMGetRenderTargets(1, &mDefaultRTV, &mDefaultDSV);
 		context.OMSetRenderTargets(sNumGBuffers, geometryBuffersRTVs, mDefaultDSV);
@@ -48,12 +103,19 @@ namespace BRE {
 	void BasicPixelShaderData::PostDraw(ID3D11DeviceContext1& context) {
 		context.PSSetShader(nullptr, nullptr, 0);
 
-		ID3D11ShaderResourceView* const srvs[] = { nullptr, nullptr, nullptr, nullptr };
-		context.PSSetShaderResources(0, ARRAYSIZE(srvs), srvs);
+		if (!mTableIndexBuffer) {
+			ID3D11ShaderResourceView* const srvs[] = { nullptr, nullptr, nullptr, nullptr };
+			context.PSSetShaderResources(0, ARRAYSIZE(srvs), srvs);
+		}
 
 		ID3D11SamplerState* const samplerStates[] = { nullptr };
 		context.PSSetSamplers(0, ARRAYSIZE(samplerStates), samplerStates);
 
+		if (mMaterialConstantsBuffer || mTableIndexBuffer) {
+			ID3D11Buffer* const cBuffers[] = { nullptr };
+			context.PSSetConstantBuffers(0, ARRAYSIZE(cBuffers), cBuffers);
+		}
+
 		ID3D11RenderTargetView* rtvs[sNumGBuffers];
 		ZeroMemory(rtvs, sizeof(ID3D11RenderTargetView*) * ARRAYSIZE(rtvs));
 		rtvs[0] = mDefaultRTV;
@@ -0,0 +1,24 @@
+#include <rendering/shaders/MaterialTable.hlsli>
+#include <rendering/shaders/Utils.hlsli>
+struct Input {
+	float4 PosCS : SV_Position;
+	float3 NormalVS : NORMAL;
+};
+
+struct Output {
+	float3 NormalVS : SV_Target0;
+	float3 BaseColor : SV_Target1;
+	float3 Smoothness_MetalMask_Curvature : SV_Target2;
+};
+
+SamplerState TexSampler : register (s0);
+
+Output main(Input input) {
+	Output output = (Output)0;
+	const MaterialRecord record = MaterialRecords[MaterialIndexValue];
+	output.NormalVS = normalize(input.NormalVS);
+	const float2 texCoord = float2(0.0f, 0.0f);
+	output.BaseColor = MaterialBaseColor(record, TexSampler, texCoord);
+	output.Smoothness_MetalMask_Curvature = MaterialSmoothnessMetalMaskCurvature(record, TexSampler, texCoord);
+	return output;
+}
\ No newline at end of file
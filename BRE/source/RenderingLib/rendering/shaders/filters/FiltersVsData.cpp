@@ -3,6 +3,7 @@
 #include <d3d11_1.h>
 #include <DirectXMath.h>
 
+#include <general/CountedContext.h>
 #include <managers/ShadersManager.h>
 #include <managers/ShaderResourcesManager.h>
 #include <utils/Assert.h>
@@ -112,6 +113,7 @@ namespace BRE {
 	}
 
 	void FiltersVertexShaderData::PreDraw(ID3D11Device1& /*device*/, ID3D11DeviceContext1& context) {
+		BRE_COUNTER_ADD(RenderCounter::PreDrawCalls, 1U);
 		BRE_ASSERT(mInputLayout);
 		BRE_ASSERT(mShader);
 		BRE_ASSERT(mVertexBuffer);
@@ -120,7 +122,7 @@ namespace BRE {
 
 		context.IASetInputLayout(mInputLayout);
 
-		context.VSSetShader(mShader, nullptr, 0);
+		CountedContext::VSSetShader(context, mShader);
 
 		ID3D11Buffer* vertexBuffers[] = { mVertexBuffer };
 		const unsigned int stride[] = { sizeof(VertexData) };
@@ -143,6 +145,6 @@ namespace BRE {
 		BRE_ASSERT(mVertexBuffer);
 		BRE_ASSERT(mIndexBuffer);
 		BRE_ASSERT(mIndexCount > 0);
-		context.DrawIndexed(mIndexCount, 0, 0);
+		CountedContext::DrawIndexed(context, mIndexCount, 0, 0);
 	}
 }
\ No newline at end of file
@@ -2,6 +2,7 @@
 
 #include <d3d11_1.h>
 
+#include <general/CountedContext.h>
 #include <managers/ShadersManager.h>
 #include <utils/Assert.h>
 
@@ -18,14 +19,15 @@ namespace BRE {
 	}
 
 	void ToneMappingPixelShaderData::PreDraw(ID3D11Device1& /*device*/, ID3D11DeviceContext1& context) {
+		BRE_COUNTER_ADD(RenderCounter::PreDrawCalls, 1U);
 		BRE_ASSERT(mShader);
-		context.PSSetShader(mShader, nullptr, 0);
+		CountedContext::PSSetShader(context, mShader);
 
 		BRE_ASSERT(mTextureToFilterSRV);
-		context.PSSetShaderResources(0, 1, &mTextureToFilterSRV);
+		CountedContext::PSSetShaderResources(context, 0, 1, &mTextureToFilterSRV);
 
 		ID3D11SamplerState* const samplerStates[] = { mSampler };
-		context.PSSetSamplers(0, ARRAYSIZE(samplerStates), samplerStates);
+		CountedContext::PSSetSamplers(context, 0, ARRAYSIZE(samplerStates), samplerStates);
 	}
 
 	void ToneMappingPixelShaderData::PostDraw(ID3D11DeviceContext1& context) {
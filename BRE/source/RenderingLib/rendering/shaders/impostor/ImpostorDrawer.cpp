@@ -0,0 +1,378 @@
+#include "ImpostorDrawer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <d3d11_1.h>
+#include <yaml-cpp/yaml.h>
+
+#include <general/Profiler.h>
+#include <managers/MaterialManager.h>
+#include <rendering/GlobalResources.h>
+#include <utils/Assert.h>
+#include <utils/YamlUtils.h>
+
+using namespace DirectX;
+
+namespace {
+	// Atlas texture arrays slices size and count
+	const unsigned int sPageSize = 2048U;
+	const unsigned int sMaxPages = 4U;
+	const unsigned int sDefaultFramesPerSide = 8U;
+	const unsigned int sDefaultFrameSize = 128U;
+	// Radius of models in bake space
+	const float sBakeRadius = 0.5f;
+
+	// Same formats as the geometry buffers, and depth
+	const DXGI_FORMAT sAtlasFormats[] = {
+		DXGI_FORMAT_R16G16B16A16_SNORM,
+		DXGI_FORMAT_R8G8B8A8_UNORM,
+		DXGI_FORMAT_R8G8B8A8_UNORM,
+		DXGI_FORMAT_R32_TYPELESS,
+	};
+	const size_t sDepthAtlas = 3U;
+
+	// Sphere enclosing both spheres (center in xyz, radius in w)
+	XMFLOAT4 MergeSpheres(const XMFLOAT4& a, const XMFLOAT4& b) {
+		const XMFLOAT3 offset(b.x - a.x, b.y - a.y, b.z - a.z);
+		const float distance = std::sqrt(offset.x * offset.x + offset.y * offset.y + offset.z * offset.z);
+		if (distance + b.w <= a.w) {
+			return a;
+		}
+		if (distance + a.w <= b.w) {
+			return b;
+		}
+		const float radius = (distance + a.w + b.w) * 0.5f;
+		const float t = (radius - a.w) / distance;
+		return XMFLOAT4(a.x + offset.x * t, a.y + offset.y * t, a.z + offset.z * t, radius);
+	}
+
+	template<typename Drawer>
+	XMFLOAT4 DrawersBoundingSphere(const std::vector<Drawer>& drawers, const size_t firstDrawer, const size_t numDrawers) {
+		BRE_ASSERT(numDrawers > 0U);
+		XMFLOAT4 sphere = drawers[firstDrawer].BoundingSphere();
+		for (size_t iDrawer = firstDrawer + 1U; iDrawer < firstDrawer + numDrawers; ++iDrawer) {
+			sphere = MergeSpheres(sphere, drawers[iDrawer].BoundingSphere());
+		}
+		return sphere;
+	}
+}
+
+namespace BRE {
+	ImpostorDrawer::ImpostorDrawer()
+		: mPacker(sPageSize, sMaxPages)
+	{
+		static_assert(ARRAYSIZE(sAtlasFormats) == ImpostorPixelShaderData::sNumAtlases, "One format per atlas");
+	}
+
+	ImpostorDrawer::~ImpostorDrawer() {
+		ReleaseAtlases();
+	}
+
+	size_t ImpostorDrawer::AddModel(const YAML::Node& node) {
+		Model model;
+		// Drawer bounds are in model space until the bake world matrix is set
+		model.mBakeTransform = mBakeTransforms.Add(XMMatrixIdentity());
+		const std::string renderType = YamlUtils::GetScalar<std::string>(node, "renderType");
+		if (renderType == "Normal") {
+			model.mType = DrawerType::NormalMapping;
+			model.mFirstDrawer = mNormalMappingDrawers.size();
+			NormalMappingDrawer::Create(node, mBakeTransforms, model.mBakeTransform, mNormalMappingDrawers);
+			model.mNumDrawers = mNormalMappingDrawers.size() - model.mFirstDrawer;
+			model.mBoundingSphere = DrawersBoundingSphere(mNormalMappingDrawers, model.mFirstDrawer, model.mNumDrawers);
+		}
+		else if (renderType == "Normal_Displacement") {
+			model.mType = DrawerType::NormalDisplacement;
+			model.mFirstDrawer = mNormalDisplacementDrawers.size();
+			NormalDisplacementDrawer::Create(node, mBakeTransforms, model.mBakeTransform, mNormalDisplacementDrawers);
+			model.mNumDrawers = mNormalDisplacementDrawers.size() - model.mFirstDrawer;
+			model.mBoundingSphere = DrawersBoundingSphere(mNormalDisplacementDrawers, model.mFirstDrawer, model.mNumDrawers);
+		}
+		else {
+			BRE_ASSERT(renderType == "Basic");
+			model.mType = DrawerType::Basic;
+			model.mFirstDrawer = mBasicDrawers.size();
+			BasicDrawer::Create(node, mBakeTransforms, model.mBakeTransform, mBasicDrawers);
+			model.mNumDrawers = mBasicDrawers.size() - model.mFirstDrawer;
+			model.mBoundingSphere = DrawersBoundingSphere(mBasicDrawers, model.mFirstDrawer, model.mNumDrawers);
+		}
+
+		const XMFLOAT4& sphere = model.mBoundingSphere;
+		const float scale = sBakeRadius / sphere.w;
+		const XMMATRIX bakeWorld = XMMatrixTranslation(-sphere.x, -sphere.y, -sphere.z) * XMMatrixScaling(scale, scale, scale);
+		mBakeTransforms.Set(model.mBakeTransform, bakeWorld);
+		const size_t drawersEnd = model.mFirstDrawer + model.mNumDrawers;
+		for (size_t iDrawer = model.mFirstDrawer; iDrawer < drawersEnd; ++iDrawer) {
+			switch (model.mType) {
+			case DrawerType::NormalMapping:
+				mNormalMappingDrawers[iDrawer].SetWorld(bakeWorld);
+				break;
+			case DrawerType::NormalDisplacement:
+				mNormalDisplacementDrawers[iDrawer].SetWorld(bakeWorld);
+				break;
+			case DrawerType::Basic:
+				mBasicDrawers[iDrawer].SetWorld(bakeWorld);
+				break;
+			}
+		}
+
+		model.mFramesPerSide = YamlUtils::IsDefined(node, "impostorFrames") ? YamlUtils::GetScalar<unsigned int>(node, "impostorFrames") : sDefaultFramesPerSide;
+		// With two frames per side, every frame is the -Z one
+		BRE_ASSERT(model.mFramesPerSide > 2U);
+		const unsigned int frameSize = YamlUtils::IsDefined(node, "impostorFrameSize") ? YamlUtils::GetScalar<unsigned int>(node, "impostorFrameSize") : sDefaultFrameSize;
+		const bool allocated = mPacker.Allocate(model.mFramesPerSide * frameSize, model.mRect);
+		BRE_ASSERT(allocated);
+		while (mPages.size() < mPacker.NumPages()) {
+			Page page;
+			ZeroMemory(&page, sizeof(page));
+			mPages.push_back(page);
+		}
+		// A new model on a baked page
+		mPages[model.mRect.mPage].mBaked = false;
+
+		mModels.push_back(model);
+		return mModels.size() - 1U;
+	}
+
+	const XMFLOAT4& ImpostorDrawer::BoundingSphere(const size_t model) const {
+		BRE_ASSERT(model < mModels.size());
+		return mModels[model].mBoundingSphere;
+	}
+
+	void ImpostorDrawer::AddInstance(const size_t model, const TransformArray::DrawTransforms& drawTransforms) {
+		BRE_ASSERT(model < mModels.size());
+		const Model& impostorModel = mModels[model];
+		const XMFLOAT4& sphere = impostorModel.mBoundingSphere;
+
+		// Direction from the model center to the camera, in model space
+		const XMMATRIX worldView = XMMatrixTranspose(XMLoadFloat4x4(&drawTransforms.mWorldView));
+		XMVECTOR determinant;
+		const XMMATRIX viewWorld = XMMatrixInverse(&determinant, worldView);
+		XMFLOAT3 camera;
+		XMStoreFloat3(&camera, viewWorld.r[3]);
+		const XMFLOAT3 direction(camera.x - sphere.x, camera.y - sphere.y, camera.z - sphere.z);
+
+		const unsigned int framesPerSide = impostorModel.mFramesPerSide;
+		unsigned int frameX;
+		unsigned int frameY;
+		ImpostorLayout::NearestFrame(direction, framesPerSide, frameX, frameY);
+		const ImpostorLayout::FrameBasis basis = ImpostorLayout::ComputeFrameBasis(ImpostorLayout::FrameDirection(frameX, frameY, framesPerSide));
+
+		const ImpostorLayout::AtlasPacker::Rect& rect = impostorModel.mRect;
+		const unsigned int frameSize = rect.mSize / framesPerSide;
+		const float page = static_cast<float>(rect.mPage);
+		ImpostorVertexShaderData::Instance instance;
+		instance.mWorldViewProjection = drawTransforms.mWorldViewProjection;
+		instance.mWorldView = drawTransforms.mWorldView;
+		instance.mCenterAndRadius = sphere;
+		instance.mRight = XMFLOAT4(basis.mRight.x, basis.mRight.y, basis.mRight.z, page);
+		instance.mUp = XMFLOAT4(basis.mUp.x, basis.mUp.y, basis.mUp.z, 0.0f);
+		instance.mForward = XMFLOAT4(basis.mForward.x, basis.mForward.y, basis.mForward.z, 0.0f);
+		instance.mFrameRect = XMFLOAT4(
+			static_cast<float>(rect.mX + frameX * frameSize) / sPageSize,
+			static_cast<float>(rect.mY + frameY * frameSize) / sPageSize,
+			static_cast<float>(frameSize) / sPageSize,
+			static_cast<float>(frameSize) / sPageSize);
+		mInstances.push_back(instance);
+		mPages[rect.mPage].mDrawn = true;
+	}
+
+	void ImpostorDrawer::Draw(ID3D11Device1& device, ID3D11DeviceContext1& context, ID3D11RenderTargetView* *geometryBuffersRTVs, const XMMATRIX& proj) {
+		if (mInstances.empty()) {
+			return;
+		}
+
+		if (mNumAtlasPages != mPages.size()) {
+			ReleaseAtlases();
+			CreateAtlases(device);
+		}
+
+		// Pages are baked before their first draw. Pages whose materials changed
+		// are baked again one per frame, and drawn with their previous bake meanwhile.
+		const unsigned int materialVersion = MaterialManager::gInstance->TextureViewsVersion();
+		bool rebaked = false;
+		for (unsigned int iPage = 0U; iPage < mPages.size(); ++iPage) {
+			const Page& page = mPages[iPage];
+			if (!page.mDrawn || (page.mBaked && (rebaked || page.mMaterialVersion == materialVersion))) {
+				continue;
+			}
+			rebaked |= page.mBaked;
+
+			BRE_PROFILE_SCOPE("ImpostorBake");
+			ID3D11RenderTargetView* defaultRTV;
+			ID3D11DepthStencilView* defaultDSV;
+			context.OMGetRenderTargets(1, &defaultRTV, &defaultDSV);
+			D3D11_VIEWPORT viewports[D3D11_VIEWPORT_AND_SCISSORRECT_OBJECT_COUNT_PER_PIPELINE];
+			unsigned int numViewports = ARRAYSIZE(viewports);
+			context.RSGetViewports(&numViewports, viewports);
+
+			BakePage(device, context, iPage);
+
+			context.RSSetViewports(numViewports, viewports);
+			context.OMSetRenderTargets(1, &defaultRTV, defaultDSV);
+			if (defaultRTV) {
+				defaultRTV->Release();
+			}
+			if (defaultDSV) {
+				defaultDSV->Release();
+			}
+		}
+
+		XMStoreFloat4x4(&mPixelShaderData.ProjectionMatrix(), XMMatrixTranspose(proj));
+		// Frames are next to each other in the atlas
+		mPixelShaderData.SamplerState() = GlobalResources::gInstance->MinMagMipPointSampler();
+		for (size_t firstInstance = 0U; firstInstance < mInstances.size(); firstInstance += ImpostorVertexShaderData::sMaxInstances) {
+			const unsigned int numInstances = static_cast<unsigned int>((std::min)(mInstances.size() - firstInstance, static_cast<size_t>(ImpostorVertexShaderData::sMaxInstances)));
+			for (unsigned int iInstance = 0U; iInstance < numInstances; ++iInstance) {
+				mVertexShaderData.GetInstance(iInstance) = mInstances[firstInstance + iInstance];
+			}
+			mVertexShaderData.SetNumInstances(numInstances);
+			mVertexShaderData.PreDraw(device, context);
+			mPixelShaderData.PreDraw(device, context, geometryBuffersRTVs, mAtlasesSRVs);
+			mVertexShaderData.Draw(context);
+			mVertexShaderData.PostDraw(context);
+			mPixelShaderData.PostDraw(context);
+		}
+
+		mInstances.clear();
+		for (Page& page : mPages) {
+			page.mDrawn = false;
+		}
+	}
+
+	void ImpostorDrawer::BakePage(ID3D11Device1& device, ID3D11DeviceContext1& context, const unsigned int page) {
+		BRE_ASSERT(page < mPages.size());
+		Page& atlasPage = mPages[page];
+		atlasPage.mMaterialVersion = MaterialManager::gInstance->TextureViewsVersion();
+		atlasPage.mBaked = true;
+
+		for (ID3D11RenderTargetView* rtv : atlasPage.mRTVs) {
+			context.ClearRenderTargetView(rtv, reinterpret_cast<const float*>(&Colors::Black));
+		}
+		context.ClearDepthStencilView(atlasPage.mDSV, D3D11_CLEAR_DEPTH, 1.0f, 0);
+		// Drawers bind geometry buffers with the bound depth stencil view
+		context.OMSetRenderTargets(ARRAYSIZE(atlasPage.mRTVs), atlasPage.mRTVs, atlasPage.mDSV);
+
+		for (Model& model : mModels) {
+			if (model.mRect.mPage == page) {
+				BakeModel(device, context, model, atlasPage.mRTVs);
+			}
+		}
+	}
+
+	void ImpostorDrawer::BakeModel(ID3D11Device1& device, ID3D11DeviceContext1& context, const Model& model, ID3D11RenderTargetView* *rtvs) {
+		// The model center is in the middle of the depth range
+		const XMMATRIX proj = XMMatrixOrthographicLH(2.0f * sBakeRadius, 2.0f * sBakeRadius, sBakeRadius, 3.0f * sBakeRadius);
+
+		const unsigned int framesPerSide = model.mFramesPerSide;
+		const unsigned int frameSize = model.mRect.mSize / framesPerSide;
+		for (unsigned int frameY = 0U; frameY < framesPerSide; ++frameY) {
+			for (unsigned int frameX = 0U; frameX < framesPerSide; ++frameX) {
+				const XMFLOAT3 direction = ImpostorLayout::FrameDirection(frameX, frameY, framesPerSide);
+				const ImpostorLayout::FrameBasis basis = ImpostorLayout::ComputeFrameBasis(direction);
+				const XMVECTOR eye = XMVectorScale(XMLoadFloat3(&direction), 2.0f * sBakeRadius);
+				const XMMATRIX view = XMMatrixLookToLH(eye, XMLoadFloat3(&basis.mForward), XMLoadFloat3(&basis.mUp));
+
+				D3D11_VIEWPORT viewport;
+				viewport.TopLeftX = static_cast<float>(model.mRect.mX + frameX * frameSize);
+				viewport.TopLeftY = static_cast<float>(model.mRect.mY + frameY * frameSize);
+				viewport.Width = static_cast<float>(frameSize);
+				viewport.Height = static_cast<float>(frameSize);
+				viewport.MinDepth = 0.0f;
+				viewport.MaxDepth = 1.0f;
+				context.RSSetViewports(1, &viewport);
+
+				mBakeTransforms.ComputeDrawTransforms(view, proj);
+				const size_t drawersEnd = model.mFirstDrawer + model.mNumDrawers;
+				for (size_t iDrawer = model.mFirstDrawer; iDrawer < drawersEnd; ++iDrawer) {
+					switch (model.mType) {
+					case DrawerType::NormalMapping:
+						mNormalMappingDrawers[iDrawer].Draw(device, context, rtvs, mBakeTransforms, view, proj);
+						break;
+					case DrawerType::NormalDisplacement:
+						mNormalDisplacementDrawers[iDrawer].Draw(device, context, rtvs, mBakeTransforms, view, proj);
+						break;
+					case DrawerType::Basic:
+						mBasicDrawers[iDrawer].Draw(device, context, rtvs, mBakeTransforms, view, proj);
+						break;
+					}
+				}
+			}
+		}
+	}
+
+	void ImpostorDrawer::CreateAtlases(ID3D11Device1& device) {
+		mNumAtlasPages = static_cast<unsigned int>(mPages.size());
+		BRE_ASSERT(mNumAtlasPages > 0U);
+
+		for (size_t iAtlas = 0U; iAtlas < ARRAYSIZE(mAtlases); ++iAtlas) {
+			const bool isDepth = iAtlas == sDepthAtlas;
+			D3D11_TEXTURE2D_DESC desc;
+			ZeroMemory(&desc, sizeof(desc));
+			desc.Width = sPageSize;
+			desc.Height = sPageSize;
+			desc.MipLevels = 1U;
+			desc.ArraySize = mNumAtlasPages;
+			desc.Format = sAtlasFormats[iAtlas];
+			desc.SampleDesc.Count = 1U;
+			desc.Usage = D3D11_USAGE_DEFAULT;
+			desc.BindFlags = (isDepth ? D3D11_BIND_DEPTH_STENCIL : D3D11_BIND_RENDER_TARGET) | D3D11_BIND_SHADER_RESOURCE;
+			ASSERT_HR(device.CreateTexture2D(&desc, nullptr, &mAtlases[iAtlas]));
+
+			D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc;
+			ZeroMemory(&srvDesc, sizeof(srvDesc));
+			srvDesc.Format = isDepth ? DXGI_FORMAT_R32_FLOAT : desc.Format;
+			srvDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2DARRAY;
+			srvDesc.Texture2DArray.MipLevels = 1U;
+			srvDesc.Texture2DArray.ArraySize = mNumAtlasPages;
+			ASSERT_HR(device.CreateShaderResourceView(mAtlases[iAtlas], &srvDesc, &mAtlasesSRVs[iAtlas]));
+		}
+
+		for (unsigned int iPage = 0U; iPage < mNumAtlasPages; ++iPage) {
+			Page& page = mPages[iPage];
+			for (size_t iAtlas = 0U; iAtlas < ARRAYSIZE(page.mRTVs); ++iAtlas) {
+				D3D11_RENDER_TARGET_VIEW_DESC rtvDesc;
+				ZeroMemory(&rtvDesc, sizeof(rtvDesc));
+				rtvDesc.Format = sAtlasFormats[iAtlas];
+				rtvDesc.ViewDimension = D3D11_RTV_DIMENSION_TEXTURE2DARRAY;
+				rtvDesc.Texture2DArray.FirstArraySlice = iPage;
+				rtvDesc.Texture2DArray.ArraySize = 1U;
+				ASSERT_HR(device.CreateRenderTargetView(mAtlases[iAtlas], &rtvDesc, &page.mRTVs[iAtlas]));
+			}
+
+			D3D11_DEPTH_STENCIL_VIEW_DESC dsvDesc;
+			ZeroMemory(&dsvDesc, sizeof(dsvDesc));
+			dsvDesc.Format = DXGI_FORMAT_D32_FLOAT;
+			dsvDesc.ViewDimension = D3D11_DSV_DIMENSION_TEXTURE2DARRAY;
+			dsvDesc.Texture2DArray.FirstArraySlice = iPage;
+			dsvDesc.Texture2DArray.ArraySize = 1U;
+			ASSERT_HR(device.CreateDepthStencilView(mAtlases[sDepthAtlas], &dsvDesc, &page.mDSV));
+
+			// New textures
+			page.mBaked = false;
+		}
+	}
+
+	void ImpostorDrawer::ReleaseAtlases() {
+		for (Page& page : mPages) {
+			for (ID3D11RenderTargetView* &rtv : page.mRTVs) {
+				if (rtv) {
+					rtv->Release();
+					rtv = nullptr;
+				}
+			}
+			if (page.mDSV) {
+				page.mDSV->Release();
+				page.mDSV = nullptr;
+			}
+		}
+		for (size_t iAtlas = 0U; iAtlas < ARRAYSIZE(mAtlases); ++iAtlas) {
+			if (mAtlases[iAtlas]) {
+				mAtlasesSRVs[iAtlas]->Release();
+				mAtlasesSRVs[iAtlas] = nullptr;
+				mAtlases[iAtlas]->Release();
+				mAtlases[iAtlas] = nullptr;
+			}
+		}
+		mNumAtlasPages = 0U;
+	}
+}
\ No newline at end of file
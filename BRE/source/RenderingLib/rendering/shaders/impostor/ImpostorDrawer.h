@@ -0,0 +1,116 @@
+#pragma once
+
+#include <DirectXMath.h>
+#include <vector>
+
+#include <rendering/TransformArray.h>
+#include <rendering/shaders/basic/BasicDrawer.h>
+#include <rendering/shaders/impostor/ImpostorPsData.h>
+#include <rendering/shaders/impostor/ImpostorVsData.h>
+#include <rendering/shaders/normalDisplacement/NormalDisplacementDrawer.h>
+#include <rendering/shaders/normalMapping/NormalMappingDrawer.h>
+#include <utils/ImpostorLayout.h>
+
+struct ID3D11DepthStencilView;
+struct ID3D11Device1;
+struct ID3D11DeviceContext1;
+struct ID3D11RenderTargetView;
+struct ID3D11ShaderResourceView;
+struct ID3D11Texture2D;
+
+namespace YAML {
+	class Node;
+}
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Impostors of models drawn far away. The geometry buffers of each model
+// are baked from the views of ImpostorLayout into a region of the atlas
+// texture arrays (one slice per atlas page), with its own drawers. Each
+// instance is a quad that faces the frame nearest to the camera and
+// writes the baked geometry buffers and depth, so lighting treats it
+// like the model.
+// Pages are baked before they are first drawn, and baked again (at most
+// one per frame) when material textures change: placeholders become
+// resident, streamed mip levels.
+//
+//////////////////////////////////////////////////////////////////////////
+
+namespace BRE {
+	class ImpostorDrawer {
+	public:
+		ImpostorDrawer();
+		~ImpostorDrawer();
+
+		const ImpostorDrawer& operator=(const ImpostorDrawer& rhs) = delete;
+
+		// Impostor of the models file entry. Optional "impostorFrames" (frames per
+		// side of the atlas of the model) and "impostorFrameSize" (in pixels)
+		// entries. Returns the model index.
+		size_t AddModel(const YAML::Node& node);
+		size_t NumModels() const { return mModels.size(); }
+		// Model space bounds (center in xyz, radius in w)
+		const DirectX::XMFLOAT4& BoundingSphere(const size_t model) const;
+
+		// An instance of the model this frame
+		void AddInstance(const size_t model, const TransformArray::DrawTransforms& drawTransforms);
+		// Bakes a page if needed and draws the instances added since the last
+		// call. Material textures must be bound as in the geometry pass.
+		void Draw(ID3D11Device1& device, ID3D11DeviceContext1& context, ID3D11RenderTargetView* *geometryBuffersRTVs, const DirectX::XMMATRIX& proj);
+
+	private:
+		enum class DrawerType {
+			NormalMapping,
+			NormalDisplacement,
+			Basic,
+		};
+
+		struct Model {
+			DrawerType mType;
+			// World matrix of its bake drawers in the bake transform array
+			size_t mBakeTransform;
+			size_t mFirstDrawer;
+			size_t mNumDrawers;
+			DirectX::XMFLOAT4 mBoundingSphere;
+			unsigned int mFramesPerSide;
+			ImpostorLayout::AtlasPacker::Rect mRect;
+		};
+
+		struct Page {
+			ID3D11RenderTargetView* mRTVs[3];
+			ID3D11DepthStencilView* mDSV;
+			bool mBaked;
+			// MaterialManager::TextureViewsVersion() when it was baked
+			unsigned int mMaterialVersion;
+			// It has instances this frame
+			bool mDrawn;
+		};
+
+		void CreateAtlases(ID3D11Device1& device);
+		void ReleaseAtlases();
+		void BakePage(ID3D11Device1& device, ID3D11DeviceContext1& context, const unsigned int page);
+		void BakeModel(ID3D11Device1& device, ID3D11DeviceContext1& context, const Model& model, ID3D11RenderTargetView* *rtvs);
+
+		ImpostorLayout::AtlasPacker mPacker;
+		std::vector<Model> mModels;
+
+		// Bake drawers. Their world matrices fit each model in a sphere of
+		// diameter 1 at the origin, which fills the screen height of the bake
+		// frames, so drawers select their finest levels of detail.
+		TransformArray mBakeTransforms;
+		std::vector<NormalMappingDrawer> mNormalMappingDrawers;
+		std::vector<NormalDisplacementDrawer> mNormalDisplacementDrawers;
+		std::vector<BasicDrawer> mBasicDrawers;
+
+		// Atlas texture arrays: normal, base color, smoothness_metalmask_curvature and depth
+		ID3D11Texture2D* mAtlases[ImpostorPixelShaderData::sNumAtlases] = {};
+		ID3D11ShaderResourceView* mAtlasesSRVs[ImpostorPixelShaderData::sNumAtlases] = {};
+		std::vector<Page> mPages;
+		// Slices of the atlas texture arrays
+		unsigned int mNumAtlasPages = 0U;
+
+		std::vector<ImpostorVertexShaderData::Instance> mInstances;
+		ImpostorVertexShaderData mVertexShaderData;
+		ImpostorPixelShaderData mPixelShaderData;
+	};
+}
\ No newline at end of file
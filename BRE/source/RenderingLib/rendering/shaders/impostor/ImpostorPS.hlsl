@@ -0,0 +1,47 @@
+struct Input {
+	float4 PosCS : SV_Position;
+	float3 PosVS : POSITION;
+	float3 TexCoord : TEXCOORD0;
+	nointerpolation float3 FrameRightVS : FRAME_RIGHT;
+	nointerpolation float3 FrameUpVS : FRAME_UP;
+	nointerpolation float3 FrameForwardVS : FRAME_FORWARD;
+};
+
+struct Output {
+	float3 NormalVS : SV_Target0;
+	float3 BaseColor : SV_Target1;
+	float3 Smoothness_MetalMask_Curvature : SV_Target2;
+	float Depth : SV_Depth;
+};
+
+cbuffer CBufferPerFrame : register (b0) {
+	float4x4 Projection;
+};
+
+SamplerState TexSampler : register (s0);
+
+// Geometry buffers baked in each frame. Normals are in frame camera space.
+Texture2DArray NormalAtlas : register (t0);
+Texture2DArray BaseColorAtlas : register (t1);
+Texture2DArray Smoothness_MetalMask_CurvatureAtlas : register (t2);
+// Orthographic depth, from the near plane (radius in front of the model center) to the far one
+Texture2DArray<float> DepthAtlas : register (t3);
+
+Output main(const Input input) {
+	const float depth = DepthAtlas.Sample(TexSampler, input.TexCoord);
+	// Nothing was baked there
+	clip(0.999999f - depth);
+
+	const float3 normalFrame = NormalAtlas.Sample(TexSampler, input.TexCoord).xyz;
+
+	Output output = (Output)0;
+	output.NormalVS = normalize(normalFrame.x * normalize(input.FrameRightVS) + normalFrame.y * normalize(input.FrameUpVS) + normalFrame.z * normalize(input.FrameForwardVS));
+	output.BaseColor = BaseColorAtlas.Sample(TexSampler, input.TexCoord).rgb;
+	output.Smoothness_MetalMask_Curvature = Smoothness_MetalMask_CurvatureAtlas.Sample(TexSampler, input.TexCoord).rgb;
+
+	// The quad is on the plane of the model center, which is in the middle of the depth range
+	const float3 posVS = input.PosVS + input.FrameForwardVS * (depth * 2.0f - 1.0f);
+	const float4 posCS = mul(float4(posVS, 1.0f), Projection);
+	output.Depth = posCS.z / posCS.w;
+	return output;
+}
\ No newline at end of file
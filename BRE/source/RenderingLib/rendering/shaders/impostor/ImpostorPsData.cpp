@@ -0,0 +1,82 @@
+#include "ImpostorPsData.h"
+
+#include <d3d11_1.h>
+#include <sstream>
+
+#include <general/CountedContext.h>
+#include <managers/ShadersManager.h>
+#include <utils/Assert.h>
+
+using namespace DirectX;
+
+namespace {
+	const char* sShaderFile = "content\\shaders\\impostor\\ImpostorPS.cso";
+	const size_t sNumGBuffers = 3;
+}
+
+namespace BRE {
+	ImpostorPixelShaderData::ImpostorPixelShaderData()
+		: mSampler(nullptr)
+		, mDefaultRTV(nullptr)
+		, mDefaultDSV(nullptr)
+	{
+		ShadersManager::gInstance->LoadPixelShader(sShaderFile, &mShader);
+		BRE_ASSERT(mShader);
+		InitializeCBuffers();
+	}
+
+	void ImpostorPixelShaderData::InitializeCBuffers() {
+		D3D11_BUFFER_DESC bufferDesc;
+		ZeroMemory(&bufferDesc, sizeof(D3D11_BUFFER_DESC));
+		bufferDesc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
+		bufferDesc.ByteWidth = sizeof(CBufferPerFrameData);
+		bufferDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+		bufferDesc.MiscFlags = 0;
+		bufferDesc.StructureByteStride = 0;
+		bufferDesc.Usage = D3D11_USAGE_DYNAMIC;
+
+		std::stringstream str;
+		str << "ImpostorPixelShaderData";
+		str << rand();
+		mCBuffer.InitializeBuffer(str.str().c_str(), bufferDesc);
+	}
+
+	void ImpostorPixelShaderData::PreDraw(ID3D11Device1& device, ID3D11DeviceContext1& context, ID3D11RenderTargetView* *geometryBuffersRTVs, ID3D11ShaderResourceView* *atlasesSRVs) {
+		BRE_COUNTER_ADD(RenderCounter::PreDrawCalls, 1U);
+		BRE_ASSERT(mShader);
+		CountedContext::PSSetShader(context, mShader);
+
+		mCBuffer.CopyDataToBuffer(device);
+		ID3D11Buffer* const cBuffers[] = { mCBuffer.mBuffer };
+		CountedContext::PSSetConstantBuffers(context, 0, ARRAYSIZE(cBuffers), cBuffers);
+
+		BRE_ASSERT(atlasesSRVs);
+		CountedContext::PSSetShaderResources(context, 0, sNumAtlases, atlasesSRVs);
+
+		BRE_ASSERT(mSampler);
+		ID3D11SamplerState* const samplerStates[] = { mSampler };
+		CountedContext::PSSetSamplers(context, 0, ARRAYSIZE(samplerStates), samplerStates);
+
+		context.OMGetRenderTargets(1, &mDefaultRTV, &mDefaultDSV);
+		context.OMSetRenderTargets(sNumGBuffers, geometryBuffersRTVs, mDefaultDSV);
+	}
+
+	void ImpostorPixelShaderData::PostDraw(ID3D11DeviceContext1& context) {
+		context.PSSetShader(nullptr, nullptr, 0);
+
+		ID3D11Buffer* const cBuffers[] = { nullptr };
+		context.PSSetConstantBuffers(0, ARRAYSIZE(cBuffers), cBuffers);
+
+		ID3D11ShaderResourceView* srvs[sNumAtlases];
+		ZeroMemory(srvs, sizeof(ID3D11ShaderResourceView*) * ARRAYSIZE(srvs));
+		context.PSSetShaderResources(0, ARRAYSIZE(srvs), srvs);
+
+		ID3D11SamplerState* const samplerStates[] = { nullptr };
+		context.PSSetSamplers(0, ARRAYSIZE(samplerStates), samplerStates);
+
+		ID3D11RenderTargetView* rtvs[sNumGBuffers];
+		ZeroMemory(rtvs, sizeof(ID3D11RenderTargetView*) * ARRAYSIZE(rtvs));
+		rtvs[0] = mDefaultRTV;
+		context.OMSetRenderTargets(ARRAYSIZE(rtvs), rtvs, mDefaultDSV);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <DirectXMath.h>
+
+#include <rendering/shaders/Buffer.h>
+
+struct ID3D11DepthStencilView;
+struct ID3D11Device1;
+struct ID3D11DeviceContext1;
+struct ID3D11PixelShader;
+struct ID3D11RenderTargetView;
+struct ID3D11SamplerState;
+struct ID3D11ShaderResourceView;
+
+namespace BRE {
+	class ImpostorPixelShaderData {
+	public:
+		// Normal, base color, smoothness_metalmask_curvature and depth atlases
+		static const unsigned int sNumAtlases = 4U;
+
+		ImpostorPixelShaderData();
+
+		void PreDraw(ID3D11Device1& device, ID3D11DeviceContext1& context, ID3D11RenderTargetView* *geometryBuffersRTVs, ID3D11ShaderResourceView* *atlasesSRVs);
+		void PostDraw(ID3D11DeviceContext1& context);
+
+		ID3D11SamplerState* &SamplerState() { return mSampler; }
+		// Transposed
+		DirectX::XMFLOAT4X4& ProjectionMatrix() { return mCBuffer.mData.mProjection; }
+
+	private:
+		void InitializeCBuffers();
+
+		ID3D11PixelShader* mShader;
+
+		struct CBufferPerFrameData {
+			DirectX::XMFLOAT4X4 mProjection;
+		};
+		Buffer<CBufferPerFrameData> mCBuffer;
+
+		ID3D11SamplerState* mSampler;
+
+		ID3D11RenderTargetView* mDefaultRTV;
+		ID3D11DepthStencilView* mDefaultDSV;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,59 @@
+// It must be ImpostorVertexShaderData::sMaxInstances
+#define MAX_INSTANCES 256
+
+struct Input {
+	uint VertexId : SV_VertexID;
+};
+
+struct Output {
+	float4 PosCS : SV_Position;
+	float3 PosVS : POSITION;
+	// Atlas texture coordinates and page
+	float3 TexCoord : TEXCOORD0;
+	// Axes of the frame camera in view space. Forward is scaled by the model radius.
+	nointerpolation float3 FrameRightVS : FRAME_RIGHT;
+	nointerpolation float3 FrameUpVS : FRAME_UP;
+	nointerpolation float3 FrameForwardVS : FRAME_FORWARD;
+};
+
+struct Instance {
+	float4x4 WorldViewProj;
+	float4x4 WorldView;
+	// Model space bounds
+	float4 CenterAndRadius;
+	// Frame camera axes in model space. Atlas page in Right.w
+	float4 Right;
+	float4 Up;
+	float4 Forward;
+	// Atlas texture coordinates of the top left corner of the frame in xy, frame size in zw
+	float4 FrameRect;
+};
+
+cbuffer CBufferPerFrame : register (b0) {
+	Instance Instances[MAX_INSTANCES];
+};
+
+// Two clockwise triangles, facing the frame camera
+static const float2 sCorners[6] = {
+	float2(-1.0f, 1.0f), float2(1.0f, 1.0f), float2(-1.0f, -1.0f),
+	float2(-1.0f, -1.0f), float2(1.0f, 1.0f), float2(1.0f, -1.0f),
+};
+
+Output main(in const Input input) {
+	const Instance instance = Instances[input.VertexId / 6];
+	const float2 corner = sCorners[input.VertexId % 6];
+	const float radius = instance.CenterAndRadius.w;
+
+	// The quad covers the orthographic projection of the bounding sphere baked in the frame
+	const float3 posOS = instance.CenterAndRadius.xyz + (corner.x * instance.Right.xyz + corner.y * instance.Up.xyz) * radius;
+
+	Output output = (Output)0;
+	output.PosCS = mul(float4(posOS, 1.0f), instance.WorldViewProj);
+	output.PosVS = mul(float4(posOS, 1.0f), instance.WorldView).xyz;
+	const float2 frameTexCoord = corner * float2(0.5f, -0.5f) + 0.5f;
+	output.TexCoord = float3(instance.FrameRect.xy + frameTexCoord * instance.FrameRect.zw, instance.Right.w);
+	output.FrameRightVS = mul(float4(instance.Right.xyz, 0.0f), instance.WorldView).xyz;
+	output.FrameUpVS = mul(float4(instance.Up.xyz, 0.0f), instance.WorldView).xyz;
+	output.FrameForwardVS = mul(float4(instance.Forward.xyz * radius, 0.0f), instance.WorldView).xyz;
+	return output;
+}
\ No newline at end of file
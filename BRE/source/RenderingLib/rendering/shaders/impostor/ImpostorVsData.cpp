@@ -0,0 +1,81 @@
+#include "ImpostorVsData.h"
+
+#include <d3d11_1.h>
+#include <sstream>
+
+#include <general/CountedContext.h>
+#include <managers/ShadersManager.h>
+#include <utils/Assert.h>
+
+using namespace DirectX;
+
+namespace {
+	const char* sShaderFile = "content\\shaders\\impostor\\ImpostorVS.cso";
+	// Two triangles per instance
+	const unsigned int sVerticesPerInstance = 6U;
+}
+
+namespace BRE {
+	ImpostorVertexShaderData::ImpostorVertexShaderData()
+		: mNumInstances(0)
+	{
+		ShadersManager::gInstance->LoadVertexShader(sShaderFile, nullptr, nullptr, &mShader);
+		BRE_ASSERT(mShader);
+		InitializeCBuffers();
+	}
+
+	ImpostorVertexShaderData::Instance& ImpostorVertexShaderData::GetInstance(const unsigned int index) {
+		BRE_ASSERT(index < sMaxInstances);
+		return mCBuffer.mData.mInstances[index];
+	}
+
+	void ImpostorVertexShaderData::SetNumInstances(const unsigned int numInstances) {
+		BRE_ASSERT(numInstances <= sMaxInstances);
+		mNumInstances = numInstances;
+	}
+
+	void ImpostorVertexShaderData::InitializeCBuffers() {
+		D3D11_BUFFER_DESC bufferDesc;
+		ZeroMemory(&bufferDesc, sizeof(D3D11_BUFFER_DESC));
+		bufferDesc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
+		bufferDesc.ByteWidth = static_cast<unsigned int> (sizeof(CBufferPerFrameData));
+		bufferDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+		bufferDesc.MiscFlags = 0;
+		bufferDesc.StructureByteStride = 0;
+		bufferDesc.Usage = D3D11_USAGE_DYNAMIC;
+
+		std::stringstream str;
+		str << "ImpostorVertexShaderData";
+		str << rand();
+		mCBuffer.InitializeBuffer(str.str().c_str(), bufferDesc);
+	}
+
+	void ImpostorVertexShaderData::PreDraw(ID3D11Device1& device, ID3D11DeviceContext1& context) {
+		BRE_COUNTER_ADD(RenderCounter::PreDrawCalls, 1U);
+		context.IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+		context.IASetInputLayout(nullptr);
+
+		// Set shader
+		BRE_ASSERT(mShader);
+		CountedContext::VSSetShader(context, mShader);
+
+		// Set constant buffers
+		mCBuffer.CopyDataToBuffer(device);
+		ID3D11Buffer* const cBuffers[] = { mCBuffer.mBuffer };
+		CountedContext::VSSetConstantBuffers(context, 0, ARRAYSIZE(cBuffers), cBuffers);
+	}
+
+	void ImpostorVertexShaderData::Draw(ID3D11DeviceContext1& context) {
+		CountedContext::Draw(context, mNumInstances * sVerticesPerInstance, 0);
+		BRE_COUNTER_ADD(RenderCounter::Impostors, mNumInstances);
+	}
+
+	void ImpostorVertexShaderData::PostDraw(ID3D11DeviceContext1& context) {
+		// Set shader
+		context.VSSetShader(nullptr, nullptr, 0);
+
+		// Set constant buffers
+		ID3D11Buffer* const cBuffers[] = { nullptr };
+		context.VSSetConstantBuffers(0, ARRAYSIZE(cBuffers), cBuffers);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <DirectXMath.h>
+
+#include <rendering/shaders/Buffer.h>
+
+struct ID3D11Device1;
+struct ID3D11DeviceContext1;
+struct ID3D11VertexShader;
+
+namespace BRE {
+	class ImpostorVertexShaderData {
+	public:
+		// Max number of instances per draw allowed by shader
+		static const unsigned int sMaxInstances = 256;
+
+		// Same layout as Instance in ImpostorVS.hlsl. Matrices are transposed.
+		struct Instance {
+			DirectX::XMFLOAT4X4 mWorldViewProjection;
+			DirectX::XMFLOAT4X4 mWorldView;
+			DirectX::XMFLOAT4 mCenterAndRadius;
+			// Atlas page in w
+			DirectX::XMFLOAT4 mRight;
+			DirectX::XMFLOAT4 mUp;
+			DirectX::XMFLOAT4 mForward;
+			DirectX::XMFLOAT4 mFrameRect;
+		};
+
+		ImpostorVertexShaderData();
+
+		void PreDraw(ID3D11Device1& device, ID3D11DeviceContext1& context);
+		void PostDraw(ID3D11DeviceContext1& context);
+		void Draw(ID3D11DeviceContext1& context);
+
+		Instance& GetInstance(const unsigned int index);
+
+		void SetNumInstances(const unsigned int numInstances);
+		unsigned int NumInstances() const { return mNumInstances; }
+
+	private:
+		void InitializeCBuffers();
+
+		ID3D11VertexShader* mShader;
+
+		struct CBufferPerFrameData {
+			Instance mInstances[sMaxInstances];
+		};
+		Buffer<CBufferPerFrameData> mCBuffer;
+
+		unsigned int mNumInstances;
+	};
+}
\ No newline at end of file
@@ -1,8 +1,10 @@
 #include "LightsDrawer.h"
 
+#include <algorithm>
 #include <d3d11_1.h>
 #include <DirectXMath.h>
 
+#include <general/Profiler.h>
 #include <managers/ShaderResourcesManager.h>
 #include <utils/Assert.h>
 
@@ -11,6 +13,21 @@
 using namespace DirectX;
 
 namespace BRE {
+	void LightsDrawer::ReservePointLights(const size_t numLights) {
+		mPointLightPosAndRadius.reserve(numLights);
+		mPointLightColorAndPower.reserve(numLights);
+		mPointLightDataVec.reserve((numLights + PointLightVertexShaderData::sMaxLights - 1U) / PointLightVertexShaderData::sMaxLights);
+	}
+
+	void LightsDrawer::AddPointLight(const XMFLOAT4& posAndRadius, const XMFLOAT4& colorAndPower) {
+		mPointLightPosAndRadius.push_back(posAndRadius);
+		mPointLightColorAndPower.push_back(colorAndPower);
+		if (mPointLightDataVec.size() * PointLightVertexShaderData::sMaxLights < mPointLightPosAndRadius.size()) {
+			mPointLightDataVec.emplace_back();
+		}
+		mPointLightBvhDirty = true;
+	}
+
 	void LightsDrawer::Draw(ID3D11Device1& device, ID3D11DeviceContext1& context, ID3D11ShaderResourceView* *geometryBuffersSRVs, ID3D11ShaderResourceView& depthStencilSRV, const float nearClipPlaneDistance, const float farClipPlaneDistance, const XMMATRIX& view, const XMMATRIX& proj) {
 		context.OMSetBlendState(mDefaultBS, nullptr, UINT32_MAX);
 		context.OMSetDepthStencilState(mLessEqualDSS, UINT32_MAX);
@@ -33,7 +50,34 @@ namespace BRE {
 			data.mVertexShaderData.PostDraw(context);
 		}*/
 
-		for (PointLightData& data : mPointLightDataVec) {
+		if (mPointLightBvhDirty) {
+			std::vector<BoundingVolumeHierarchy::Aabb> bounds;
+			bounds.reserve(mPointLightPosAndRadius.size());
+			for (const XMFLOAT4& posAndRadius : mPointLightPosAndRadius) {
+				bounds.push_back(BoundingVolumeHierarchy::SphereBounds(posAndRadius));
+			}
+			mPointLightBvh.Build(bounds);
+			mPointLightBvhDirty = false;
+		}
+		{
+			BRE_PROFILE_SCOPE("LightCulling");
+			mVisiblePointLights.clear();
+			mPointLightBvh.QueryFrustum(view * proj, mVisiblePointLights);
+			// Lights are blended in the same order every frame
+			std::sort(mVisiblePointLights.begin(), mVisiblePointLights.end());
+		}
+
+		const size_t numVisibleLights = mVisiblePointLights.size();
+		for (size_t firstLight = 0U; firstLight < numVisibleLights; firstLight += PointLightVertexShaderData::sMaxLights) {
+			PointLightData& data = mPointLightDataVec[firstLight / PointLightVertexShaderData::sMaxLights];
+			const unsigned int numLights = static_cast<unsigned int>((std::min)(numVisibleLights - firstLight, static_cast<size_t>(PointLightVertexShaderData::sMaxLights)));
+			for (unsigned int i = 0U; i < numLights; ++i) {
+				const std::uint32_t light = mVisiblePointLights[firstLight + i];
+				data.mPointLightVsData.LightPosAndRadius(i) = mPointLightPosAndRadius[light];
+				data.mPointLightVsData.LightColorAndPower(i) = mPointLightColorAndPower[light];
+			}
+			data.mPointLightVsData.SetNumLights(numLights);
+
 			XMStoreFloat4x4(&data.mPointLightVsData.ViewMatrix(), XMMatrixTranspose(view));
 			XMStoreFloat4x4(&data.mPointLightGsData.ProjectionMatrix(), XMMatrixTranspose(proj));
 
@@ -1,7 +1,10 @@
 #pragma once
 
+#include <cstdint>
+#include <DirectXMath.h>
 #include <vector>
 
+#include <rendering/BoundingVolumeHierarchy.h>
 #include <rendering/shaders/lightPasses/DirLightVsData.h>
 #include <rendering/shaders/lightPasses/DirLightPsData.h>
 #include <rendering/shaders/lightPasses/PointLightGsData.h>
@@ -31,7 +34,13 @@ namespace BRE {
 		LightsDrawer() { InitStates(); }
 
 		std::vector<DirLightData>& DirLightDataVec() { return mDirLightDataVec; }
-		std::vector<PointLightData>& PointLightDataVec() { return mPointLightDataVec; }
+
+		// Point lights are frustum culled each frame. Visible ones are packed in
+		// PointLightData groups of up to PointLightVertexShaderData::sMaxLights
+		// lights (one draw per group).
+		void ReservePointLights(const size_t numLights);
+		void AddPointLight(const DirectX::XMFLOAT4& posAndRadius, const DirectX::XMFLOAT4& colorAndPower);
+		size_t NumPointLights() const { return mPointLightPosAndRadius.size(); }
 
 		void Draw(ID3D11Device1& device, ID3D11DeviceContext1& context, ID3D11ShaderResourceView* *geometryBuffersSRVs, ID3D11ShaderResourceView& depthStencilSRV, const float nearClipPlaneDistance, const float farClipPlaneDistance, const DirectX::XMMATRIX& view, const DirectX::XMMATRIX& proj);
 
@@ -42,6 +51,14 @@ namespace BRE {
 		ID3D11DepthStencilState* mLessEqualDSS;
 
 		std::vector<DirLightData> mDirLightDataVec;
+		// Enough groups for all the point lights
 		std::vector<PointLightData> mPointLightDataVec;
+
+		std::vector<DirectX::XMFLOAT4> mPointLightPosAndRadius;
+		std::vector<DirectX::XMFLOAT4> mPointLightColorAndPower;
+		// Built by Draw() after point lights are added
+		BoundingVolumeHierarchy mPointLightBvh;
+		bool mPointLightBvhDirty = false;
+		std::vector<std::uint32_t> mVisiblePointLights;
 	};
 }
\ No newline at end of file
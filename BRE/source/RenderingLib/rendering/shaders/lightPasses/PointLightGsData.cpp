@@ -4,6 +4,7 @@
 #include <memory>
 #include <sstream>
 
+#include <general/CountedContext.h>
 #include <managers/ShadersManager.h>
 #include <utils/Assert.h>
 
@@ -38,14 +39,15 @@ namespace BRE {
 	}
 
 	void PointLightGeometryShaderData::PreDraw(ID3D11Device1& device, ID3D11DeviceContext1& context) {
+		BRE_COUNTER_ADD(RenderCounter::PreDrawCalls, 1U);
 		// Set shader
 		BRE_ASSERT(mShader);
-		context.GSSetShader(mShader, nullptr, 0);
+		CountedContext::GSSetShader(context, mShader);
 
 		// Set constant buffers
 		mCBuffer.CopyDataToBuffer(device);
 		ID3D11Buffer* const cBuffers[] = { mCBuffer.mBuffer };
-		context.GSSetConstantBuffers(0, ARRAYSIZE(cBuffers), cBuffers);
+		CountedContext::GSSetConstantBuffers(context, 0, ARRAYSIZE(cBuffers), cBuffers);
 	}
 
 	void PointLightGeometryShaderData::PostDraw(ID3D11DeviceContext1& context) {
@@ -3,6 +3,7 @@
 #include <d3d11_1.h>
 #include <sstream>
 
+#include <general/CountedContext.h>
 #include <managers/ShadersManager.h>
 #include <utils/Assert.h>
 
@@ -37,19 +38,20 @@ namespace BRE {
 	}
 
 	void PointLightPixelShaderData::PreDraw(ID3D11Device1& device, ID3D11DeviceContext1& context, ID3D11ShaderResourceView* *geometryBuffersSRVs, ID3D11ShaderResourceView& depthStencilSRV) {
+		BRE_COUNTER_ADD(RenderCounter::PreDrawCalls, 1U);
 		BRE_ASSERT(mShader);
-		context.PSSetShader(mShader, nullptr, 0);
+		CountedContext::PSSetShader(context, mShader);
 
 		mCBuffer.CopyDataToBuffer(device);
 		ID3D11Buffer* const cBuffers[] = { mCBuffer.mBuffer };
-		context.PSSetConstantBuffers(0, ARRAYSIZE(cBuffers), cBuffers);
+		CountedContext::PSSetConstantBuffers(context, 0, ARRAYSIZE(cBuffers), cBuffers);
 
 		BRE_ASSERT(geometryBuffersSRVs);
 		ID3D11ShaderResourceView* views[sNumGBuffers] = { geometryBuffersSRVs[0], geometryBuffersSRVs[1], geometryBuffersSRVs[2], &depthStencilSRV };
-		context.PSSetShaderResources(0, ARRAYSIZE(views), views);
+		CountedContext::PSSetShaderResources(context, 0, ARRAYSIZE(views), views);
 
 		ID3D11SamplerState* const samplerStates[] = { mSampler };
-		context.PSSetSamplers(0, ARRAYSIZE(samplerStates), samplerStates);
+		CountedContext::PSSetSamplers(context, 0, ARRAYSIZE(samplerStates), samplerStates);
 	}
 
 	void PointLightPixelShaderData::PostDraw(ID3D11DeviceContext1& context) {
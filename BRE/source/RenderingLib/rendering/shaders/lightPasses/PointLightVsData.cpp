@@ -3,6 +3,7 @@
 #include <d3d11_1.h>
 #include <sstream>
 
+#include <general/CountedContext.h>
 #include <managers/ShadersManager.h>
 #include <utils/Assert.h>
 
@@ -54,21 +55,23 @@ namespace BRE {
 	}
 
 	void PointLightVertexShaderData::PreDraw(ID3D11Device1& device, ID3D11DeviceContext1& context) {
+		BRE_COUNTER_ADD(RenderCounter::PreDrawCalls, 1U);
 		context.IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_POINTLIST);
 		context.IASetInputLayout(nullptr);
 
 		// Set shader
 		BRE_ASSERT(mShader);
-		context.VSSetShader(mShader, nullptr, 0);
+		CountedContext::VSSetShader(context, mShader);
 
 		// Set constant buffers
 		mCBuffer.CopyDataToBuffer(device);
 		ID3D11Buffer* const cBuffers[] = { mCBuffer.mBuffer };
-		context.VSSetConstantBuffers(0, ARRAYSIZE(cBuffers), cBuffers);
+		CountedContext::VSSetConstantBuffers(context, 0, ARRAYSIZE(cBuffers), cBuffers);
 	}
 
 	void PointLightVertexShaderData::Draw(ID3D11DeviceContext1& context) {
-		context.Draw(mNumLights, 0);
+		CountedContext::Draw(context, mNumLights, 0);
+		BRE_COUNTER_ADD(RenderCounter::Lights, mNumLights);
 	}
 
 	void PointLightVertexShaderData::PostDraw(ID3D11DeviceContext1& context) {
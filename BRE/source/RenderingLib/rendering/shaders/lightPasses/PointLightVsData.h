@@ -10,10 +10,10 @@ struct ID3D11VertexShader;
 
 namespace BRE {
 	class PointLightVertexShaderData {
+	public:
 		// Max number of point lights allowed by shader
 		static const unsigned int sMaxLights = 512;
 
-	public:
 		PointLightVertexShaderData();
 
 		void PreDraw(ID3D11Device1& device, ID3D11DeviceContext1& context);
@@ -2,72 +2,72 @@
 
 #include <yaml-cpp/yaml.h>
 
+#include <managers/GeometryPool.h>
+#include <managers/MaterialManager.h>
 #include <managers/ModelManager.h>
 #include <rendering/GlobalResources.h>
+#include <rendering/TransformArray.h>
 #include <rendering/models/Mesh.h>
+#include <rendering/models/MeshLod.h>
 #include <rendering/models/Model.h>
-#include <rendering/shaders/VertexType.h>
+#include <rendering/shaders/DrawerSettings.h>
 
 #include <utils/Assert.h>
 #include <utils/Hash.h>
-#include <utils/YamlUtils.h>
+#include <utils/MathUtils.h>
 
 using namespace DirectX;
 
+namespace {
+	// Target length of the tessellated edges, about 8 pixels at 1080p
+	const float sTessellatedEdgeScreenFraction = 8.0f / 1080.0f;
+}
+
 namespace BRE {
-	void NormalDisplacementDrawer::Create(const YAML::Node& node, std::vector<NormalDisplacementDrawer>& drawers) {
-		BRE_ASSERT(YamlUtils::GetScalar<std::string>(node, "renderType") == std::string("Normal_Displacement"));
-
-		const std::string modelFilePath = YamlUtils::GetScalar<std::string>(node, "path");
-		float translation[3];
-		YamlUtils::GetSequence<float>(node, "translation", translation, ARRAYSIZE(translation));
-		const XMMATRIX translationMatrix = XMMatrixTranslation(translation[0], translation[1], translation[2]);
-		float rotation[3];
-		YamlUtils::GetSequence<float>(node, "rotation", rotation, ARRAYSIZE(rotation));
-		const XMMATRIX rotationMatrix = XMMatrixRotationRollPitchYaw(rotation[0], rotation[1], rotation[2]);
-		float scaling[3];
-		YamlUtils::GetSequence<float>(node, "scaling", scaling, ARRAYSIZE(scaling));
-		const XMMATRIX scalingMatrix = XMMatrixScaling(scaling[0], scaling[1], scaling[2]);
-		const XMMATRIX worldMatrix = scalingMatrix * rotationMatrix * translationMatrix;
-		const float textureScaleFactor = YamlUtils::GetScalar<float>(node, "textureScaleFactor");
-		const float tessellationFactor = YamlUtils::GetScalar<float>(node, "tessellationFactor");
-		const float displacementScale = YamlUtils::GetScalar<float>(node, "displacementScale");
+	void NormalDisplacementDrawer::Create(const YAML::Node& node, const TransformArray& transforms, const size_t transform, std::vector<NormalDisplacementDrawer>& drawers) {
+		DrawerSettings settings;
+		const bool settingsRead = DrawerSettings::Read(node, settings);
+		BRE_ASSERT(settingsRead);
+		BRE_ASSERT(settings.mRenderType == "Normal_Displacement");
+
+		const XMMATRIX worldMatrix = transforms.World(transform);
+		const float textureScaleFactor = settings.mTextureScaleFactor;
+		const float displacementScale = settings.mDisplacementScale;
+		ShaderResourcesManager& shaderResourcesMgr = *ShaderResourcesManager::gInstance;
 		ID3D11ShaderResourceView* displacementSRV;
-		{
-			ShaderResourcesManager& shaderResourcesMgr = *ShaderResourcesManager::gInstance;
-			const std::string displacementMapTexture = YamlUtils::GetScalar<std::string>(node, "displacementMapTexture");
-			shaderResourcesMgr.AddTextureFromFileSRV(displacementMapTexture.c_str(), &displacementSRV);
-			BRE_ASSERT(displacementSRV);
-		}
+		shaderResourcesMgr.AddTextureFromFileSRV(settings.mDisplacementMapTexture.c_str(), &displacementSRV);
+		BRE_ASSERT(displacementSRV);
 		ID3D11ShaderResourceView* normalMapSRV = nullptr;
-		if (YamlUtils::IsDefined(node, "normalMapTexture")) {
-			ShaderResourcesManager& shaderResourcesMgr = *ShaderResourcesManager::gInstance;
-			const std::string normalMapTexture = YamlUtils::GetScalar<std::string>(node, "normalMapTexture");
-			shaderResourcesMgr.AddTextureFromFileSRV(normalMapTexture.c_str(), &normalMapSRV);
+		if (!settings.mNormalMapTexture.empty()) {
+			shaderResourcesMgr.AddTextureFromFileSRV(settings.mNormalMapTexture.c_str(), &normalMapSRV);
 		}
 
-		const std::string material = YamlUtils::GetScalar<std::string>(node, "material");
-		const size_t matId = Utils::Hash(material.c_str());
+		const size_t matId = Utils::Hash(settings.mMaterial.c_str());
 
 		const Model* model;
-		const size_t modelId = ModelManager::gInstance->LoadModel(modelFilePath.c_str(), &model);
+		const size_t modelId = ModelManager::gInstance->LoadModel(settings.mPath.c_str(), &model);
 		BRE_ASSERT(model);
 		const std::vector<BRE::Mesh*>& meshes = model->Meshes();
 		const size_t numMeshes = meshes.size();
 		BRE_ASSERT(numMeshes > 0);
 		for (size_t iMeshIndex = 0; iMeshIndex < numMeshes; ++iMeshIndex) {
 			NormalDisplacementDrawer drawer;
-			drawer.mVertexShaderData.VertexBuffer() = ShaderResourcesManager::gInstance->Buffer(NormalMappingVertexData::CreateVertexBuffer(modelId, iMeshIndex));
-			BRE_ASSERT(drawer.mVertexShaderData.VertexBuffer());
-			drawer.mVertexShaderData.IndexBuffer() = ShaderResourcesManager::gInstance->Buffer(model->CreateIndexBuffer(iMeshIndex));
-			drawer.mVertexShaderData.SetIndexCount(static_cast<unsigned int>(model->Meshes()[iMeshIndex]->Indices().size()));
+			drawer.mVertexShaderData.SetMesh(GeometryPool::gInstance->AddMesh(modelId, iMeshIndex, GeometryPool::VertexFormat::NormalMapping));
+			drawer.mLods = &meshes[iMeshIndex]->Lods();
+			drawer.mLod = 0U;
+			drawer.mVertexShaderData.SetIndexRange(drawer.mLods->front().mStartIndex, drawer.mLods->front().mIndexCount);
 			drawer.mVertexShaderData.TextureScaleFactor() = textureScaleFactor;
 
-			// Build world matrix
-			XMStoreFloat4x4(&drawer.mWorld, worldMatrix);
+			drawer.mTransform = transform;
+			drawer.mLocalBoundingSphere = Utils::BoundingSphere(meshes[iMeshIndex]->Vertices(), XMMatrixIdentity());
+			drawer.SetWorld(worldMatrix);
+			drawer.mTextureScaleFactor = textureScaleFactor;
 
 			// Initialize hull shader data
-			drawer.mHullShaderData.TessellationFactor() = tessellationFactor;
+			NormalDisplacementTessellation::Settings& tessellation = drawer.mHullShaderData.Tessellation();
+			tessellation.mMinFactor = settings.mMinTessellationFactor;
+			tessellation.mMaxFactor = settings.mMaxTessellationFactor;
+			tessellation.mDisplacementScale = displacementScale;
 
 			// Initialize domain shader data
 			drawer.mDomainShaderData.DisplacementScale() = displacementScale;
@@ -76,19 +76,32 @@ namespace BRE {
 
 			// Initialize pixel shader data
 			drawer.mPixelShaderData.SetMaterial(matId);
-			drawer.mPixelShaderData.SamplerState() = GlobalResources::gInstance->MinMagMipPointSampler();
 
 			if (normalMapSRV) {
-				drawer.mPixelShaderData.NormalSRV() = normalMapSRV;
+				drawer.mPixelShaderData.SetNormalSRV(normalMapSRV);
 			}
 
 			drawers.push_back(drawer);
 		}
 	}
 
-	void NormalDisplacementDrawer::Draw(ID3D11Device1& device, ID3D11DeviceContext1& context, ID3D11RenderTargetView* *geometryBuffersRTVs, const XMMATRIX& view, const XMMATRIX& proj) {
-		const XMMATRIX world = XMLoadFloat4x4(&mWorld);
-		XMStoreFloat4x4(&mDomainShaderData.WorldView(), XMMatrixTranspose(world * view));
+	void NormalDisplacementDrawer::SetWorld(const XMMATRIX& world) {
+		mBoundingSphere = Utils::TransformBoundingSphere(mLocalBoundingSphere, world);
+	}
+
+	void NormalDisplacementDrawer::Draw(ID3D11Device1& device, ID3D11DeviceContext1& context, ID3D11RenderTargetView* *geometryBuffersRTVs, const TransformArray& transforms, const XMMATRIX& view, const XMMATRIX& proj) {
+		const float screenFraction = Utils::ProjectedScreenFraction(mBoundingSphere, view, proj);
+		if (MaterialManager::gInstance->IsStreaming()) {
+			// Texture coordinates are assumed to span the mesh once, so a repeat covers its bounds divided by the scale factor
+			MaterialManager::gInstance->RequestDetail(mPixelShaderData.MaterialId(), screenFraction / mTextureScaleFactor);
+		}
+		mLod = MeshLod::Select(*mLods, mLod, screenFraction);
+		mVertexShaderData.SetIndexRange((*mLods)[mLod].mStartIndex, (*mLods)[mLod].mIndexCount);
+
+		const XMFLOAT4X4& worldView = transforms.GetDrawTransforms(mTransform).mWorldView;
+		mHullShaderData.WorldView() = worldView;
+		NormalDisplacementTessellation::SetProjection(proj, sTessellatedEdgeScreenFraction, mHullShaderData.Tessellation());
+		mDomainShaderData.WorldView() = worldView;
 		XMStoreFloat4x4(&mDomainShaderData.Projection(), XMMatrixTranspose(proj));
 		mVertexShaderData.PreDraw(device, context);
 		mHullShaderData.PreDraw(device, context);
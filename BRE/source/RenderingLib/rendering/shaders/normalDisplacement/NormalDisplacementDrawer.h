@@ -16,12 +16,19 @@ namespace YAML {
 }
 
 namespace BRE {
+	struct MeshLod;
+	class TransformArray;
 	class NormalDisplacementVsData;
 
 	class NormalDisplacementDrawer {
 	public:
-		static void Create(const YAML::Node& node, std::vector<NormalDisplacementDrawer>& drawers);
-		void Draw(ID3D11Device1& device, ID3D11DeviceContext1& context, ID3D11RenderTargetView* *geometryBuffersRTVs, const DirectX::XMMATRIX& view, const DirectX::XMMATRIX& proj);
+		// A drawer for each mesh of the model. Their world matrix is the transform of the array.
+		static void Create(const YAML::Node& node, const TransformArray& transforms, const size_t transform, std::vector<NormalDisplacementDrawer>& drawers);
+		// Updates bounds. The world matrix of the transform array must be set apart.
+		void SetWorld(const DirectX::XMMATRIX& world);
+		// World space bounds (center in xyz, radius in w)
+		const DirectX::XMFLOAT4& BoundingSphere() const { return mBoundingSphere; }
+		void Draw(ID3D11Device1& device, ID3D11DeviceContext1& context, ID3D11RenderTargetView* *geometryBuffersRTVs, const TransformArray& transforms, const DirectX::XMMATRIX& view, const DirectX::XMMATRIX& proj);
 
 	private:
 		NormalDisplacementVertexShaderData mVertexShaderData;
@@ -29,6 +36,15 @@ namespace BRE {
 		NormalDisplacementDomainShaderData mDomainShaderData;
 		NormalDisplacementPixelShaderData mPixelShaderData;
 
-		DirectX::XMFLOAT4X4 mWorld;
+		// World matrix index in the TransformArray
+		size_t mTransform;
+		// Model space bounds (center in xyz, radius in w)
+		DirectX::XMFLOAT4 mLocalBoundingSphere;
+		// World space bounds, for culling, texture streaming and level of detail selection
+		DirectX::XMFLOAT4 mBoundingSphere;
+		// Levels of detail of the mesh, and the one drawn last frame
+		const std::vector<MeshLod>* mLods;
+		unsigned int mLod;
+		float mTextureScaleFactor;
 	};
 }
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include <d3d11_1.h>
 #include <sstream>
 
+#include <general/CountedContext.h>
 #include <managers/ShadersManager.h>
 #include <utils/Assert.h>
 
@@ -34,19 +35,20 @@ namespace BRE {
 	}
 
 	void NormalDisplacementDomainShaderData::PreDraw(ID3D11Device1& device, ID3D11DeviceContext1& context) {
+		BRE_COUNTER_ADD(RenderCounter::PreDrawCalls, 1U);
 		BRE_ASSERT(mShader);
-		context.DSSetShader(mShader, nullptr, 0);
+		CountedContext::DSSetShader(context, mShader);
 
 		mCBuffer.CopyDataToBuffer(device);
 		ID3D11Buffer* const cBuffers[] = { mCBuffer.mBuffer };
-		context.DSSetConstantBuffers(0, ARRAYSIZE(cBuffers), cBuffers);
+		CountedContext::DSSetConstantBuffers(context, 0, ARRAYSIZE(cBuffers), cBuffers);
 
 		BRE_ASSERT(mDisplacementMapSRV);
 		ID3D11ShaderResourceView* const srvs[] = { mDisplacementMapSRV };
-		context.DSSetShaderResources(0, ARRAYSIZE(srvs), srvs);
+		CountedContext::DSSetShaderResources(context, 0, ARRAYSIZE(srvs), srvs);
 
 		ID3D11SamplerState* const samplerStates[] = { mSampler };
-		context.DSSetSamplers(0, ARRAYSIZE(samplerStates), samplerStates);
+		CountedContext::DSSetSamplers(context, 0, ARRAYSIZE(samplerStates), samplerStates);
 	}
 
 	void NormalDisplacementDomainShaderData::PostDraw(ID3D11DeviceContext1& context) {
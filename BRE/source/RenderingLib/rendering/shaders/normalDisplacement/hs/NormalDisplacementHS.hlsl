@@ -19,16 +19,57 @@ struct Output {
 	float3 TangentOS : TANGENT;
 };
 
-cbuffer CBufferImmutable : register (b0) {
-	float TessellationFactor;
+// Mirrored by NormalDisplacementTessellation.cpp
+cbuffer CBufferPerFrame : register (b0) {
+	float4x4 WorldView;
+	// View space, normals pointing inside
+	float4 FrustumPlanes[6];
+	// Edge factor of an edge of length 1 at depth 1
+	float EdgeFactorScale;
+	float MinTessellationFactor;
+	float MaxTessellationFactor;
+	float DisplacementScale;
+}
+
+// Edges crossing the camera plane get the max factor
+static const float MinEdgeDepth = 1e-3f;
+
+// Symmetric in p0 and p1, so both patches of the edge get the same value (no cracks)
+float EdgeFactor(const float3 p0, const float3 p1) {
+	const float depth = max((p0.z + p1.z) * 0.5f, MinEdgeDepth);
+	return clamp(length(p1 - p0) * EdgeFactorScale / depth, MinTessellationFactor, MaxTessellationFactor);
+}
+
+// Displacement moves vertices inwards up to DisplacementScale, so the triangle is grown by it
+bool IsCulled(const float3 p0, const float3 p1, const float3 p2) {
+	[unroll]
+	for (uint i = 0; i < 6; ++i) {
+		const float3 distances = float3(dot(FrustumPlanes[i].xyz, p0), dot(FrustumPlanes[i].xyz, p1), dot(FrustumPlanes[i].xyz, p2)) + FrustumPlanes[i].w;
+		if (all(distances < -DisplacementScale)) {
+			return true;
+		}
+	}
+
+	// Front faces are clockwise, so their normal points to the camera (the origin)
+	const float3 normal = cross(p1 - p0, p2 - p0);
+	const float normalLength = length(normal);
+	return normalLength > 0.0f && -dot(normal, p0) / normalLength < -DisplacementScale;
 }
 
 HullShaderConstantOutput constant_hull_shader(const InputPatch<Input, NUM_PATCH_POINTS> patch, const uint patchID : SV_PrimitiveID) {
 	HullShaderConstantOutput output = (HullShaderConstantOutput)0;
-	output.EdgeFactors[0] = TessellationFactor;
-	output.EdgeFactors[1] = TessellationFactor;
-	output.EdgeFactors[2] = TessellationFactor;
-	output.InsideFactors = TessellationFactor;
+	const float3 p0 = mul(patch[0].PosOS, WorldView).xyz;
+	const float3 p1 = mul(patch[1].PosOS, WorldView).xyz;
+	const float3 p2 = mul(patch[2].PosOS, WorldView).xyz;
+	// Zero factors cull the patch
+	if (IsCulled(p0, p1, p2)) {
+		return output;
+	}
+	// Edge i is opposite to control point i
+	output.EdgeFactors[0] = EdgeFactor(p1, p2);
+	output.EdgeFactors[1] = EdgeFactor(p2, p0);
+	output.EdgeFactors[2] = EdgeFactor(p0, p1);
+	output.InsideFactors = max(output.EdgeFactors[0], max(output.EdgeFactors[1], output.EdgeFactors[2]));
 	return output;
 }
 
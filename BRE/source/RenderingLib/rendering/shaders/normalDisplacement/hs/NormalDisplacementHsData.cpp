@@ -3,6 +3,7 @@
 #include <d3d11_1.h>
 #include <sstream>
 
+#include <general/CountedContext.h>
 #include <managers/ShadersManager.h>
 #include <utils/Assert.h>
 
@@ -34,12 +35,13 @@ namespace BRE {
 	}
 
 	void NormalDisplacementHullShaderData::PreDraw(ID3D11Device1& device, ID3D11DeviceContext1& context) {
+		BRE_COUNTER_ADD(RenderCounter::PreDrawCalls, 1U);
 		BRE_ASSERT(mShader);
-		context.HSSetShader(mShader, nullptr, 0);
+		CountedContext::HSSetShader(context, mShader);
 
 		mCBuffer.CopyDataToBuffer(device);
 		ID3D11Buffer* const cBuffers[] = { mCBuffer.mBuffer };
-		context.HSSetConstantBuffers(0, ARRAYSIZE(cBuffers), cBuffers);
+		CountedContext::HSSetConstantBuffers(context, 0, ARRAYSIZE(cBuffers), cBuffers);
 	}
 
 	void NormalDisplacementHullShaderData::PostDraw(ID3D11DeviceContext1& context) {
@@ -1,6 +1,9 @@
 #pragma once
 
+#include <DirectXMath.h>
+
 #include <rendering/shaders/Buffer.h>
+#include <rendering/shaders/normalDisplacement/hs/NormalDisplacementTessellation.h>
 
 struct ID3D11Device1;
 struct ID3D11DeviceContext1;
@@ -14,7 +17,8 @@ namespace BRE {
 		void PreDraw(ID3D11Device1& device, ID3D11DeviceContext1& context);
 		void PostDraw(ID3D11DeviceContext1& context);
 
-		float& TessellationFactor() { return mCBuffer.mData.mTessellationFactor; }
+		DirectX::XMFLOAT4X4& WorldView() { return mCBuffer.mData.mWorldView; }
+		NormalDisplacementTessellation::Settings& Tessellation() { return mCBuffer.mData.mTessellation; }
 
 	private:
 		void InitializeCBuffers();
@@ -22,7 +26,8 @@ namespace BRE {
 		ID3D11HullShader* mShader;
 
 		struct CBufferPerFrameData {
-			float mTessellationFactor;
+			DirectX::XMFLOAT4X4 mWorldView;
+			NormalDisplacementTessellation::Settings mTessellation;
 		};
 		Buffer<CBufferPerFrameData> mCBuffer;
 	};
@@ -0,0 +1,101 @@
+#include "NormalDisplacementTessellation.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include <utils/Assert.h>
+
+using namespace DirectX;
+
+namespace {
+	// Edges crossing the camera plane get the max factor
+	const float sMinEdgeDepth = 1e-3f;
+	// Largest factor Direct3D supports
+	const float sMaxHardwareFactor = 64.0f;
+}
+
+namespace BRE {
+	namespace NormalDisplacementTessellation {
+		void SetProjection(const XMMATRIX& proj, const float edgeScreenFraction, Settings& settings) {
+			BRE_ASSERT(edgeScreenFraction > 0.0f);
+			BRE_ASSERT(settings.mMinFactor >= 1.0f);
+			BRE_ASSERT(settings.mMinFactor <= settings.mMaxFactor);
+			BRE_ASSERT(settings.mMaxFactor <= sMaxHardwareFactor);
+
+			// Planes of the columns of the projection (Gribb and Hartmann). The near plane is z = 0 in clip space.
+			XMFLOAT4X4 m;
+			XMStoreFloat4x4(&m, proj);
+			settings.mFrustumPlanes[0] = XMFLOAT4(m._14 + m._11, m._24 + m._21, m._34 + m._31, m._44 + m._41);
+			settings.mFrustumPlanes[1] = XMFLOAT4(m._14 - m._11, m._24 - m._21, m._34 - m._31, m._44 - m._41);
+			settings.mFrustumPlanes[2] = XMFLOAT4(m._14 + m._12, m._24 + m._22, m._34 + m._32, m._44 + m._42);
+			settings.mFrustumPlanes[3] = XMFLOAT4(m._14 - m._12, m._24 - m._22, m._34 - m._32, m._44 - m._42);
+			settings.mFrustumPlanes[4] = XMFLOAT4(m._13, m._23, m._33, m._43);
+			settings.mFrustumPlanes[5] = XMFLOAT4(m._14 - m._13, m._24 - m._23, m._34 - m._33, m._44 - m._43);
+			// Normalized, so plane distances are view space distances
+			for (XMFLOAT4& plane : settings.mFrustumPlanes) {
+				XMStoreFloat4(&plane, XMPlaneNormalize(XMLoadFloat4(&plane)));
+			}
+
+			// An edge of length l at depth d covers l * _22 / (2 * d) of the screen height
+			settings.mEdgeFactorScale = m._22 / (2.0f * edgeScreenFraction);
+		}
+
+		float EdgeFactor(const XMFLOAT3& p0, const XMFLOAT3& p1, const Settings& settings) {
+			// Symmetric in p0 and p1, so both patches of the edge get the same value
+			const float dx = p1.x - p0.x;
+			const float dy = p1.y - p0.y;
+			const float dz = p1.z - p0.z;
+			const float length = std::sqrt(dx * dx + dy * dy + dz * dz);
+			const float depth = (std::max)((p0.z + p1.z) * 0.5f, sMinEdgeDepth);
+			const float factor = length * settings.mEdgeFactorScale / depth;
+			return (std::min)((std::max)(factor, settings.mMinFactor), settings.mMaxFactor);
+		}
+
+		bool IsCulled(const XMFLOAT3& p0, const XMFLOAT3& p1, const XMFLOAT3& p2, const Settings& settings) {
+			const float displacement = settings.mDisplacementScale;
+
+			// Outside a frustum plane by more than the displacement
+			for (const XMFLOAT4& plane : settings.mFrustumPlanes) {
+				const float d0 = plane.x * p0.x + plane.y * p0.y + plane.z * p0.z + plane.w;
+				const float d1 = plane.x * p1.x + plane.y * p1.y + plane.z * p1.z + plane.w;
+				const float d2 = plane.x * p2.x + plane.y * p2.y + plane.z * p2.z + plane.w;
+				if (d0 < -displacement && d1 < -displacement && d2 < -displacement) {
+					return true;
+				}
+			}
+
+			// Back facing: the camera (the origin) is behind the triangle plane by more
+			// than the displacement. Front faces are clockwise, so their normal
+			// (p1 - p0) x (p2 - p0) points to the camera.
+			const float e1x = p1.x - p0.x;
+			const float e1y = p1.y - p0.y;
+			const float e1z = p1.z - p0.z;
+			const float e2x = p2.x - p0.x;
+			const float e2y = p2.y - p0.y;
+			const float e2z = p2.z - p0.z;
+			const float nx = e1y * e2z - e1z * e2y;
+			const float ny = e1z * e2x - e1x * e2z;
+			const float nz = e1x * e2y - e1y * e2x;
+			const float length = std::sqrt(nx * nx + ny * ny + nz * nz);
+			if (length == 0.0f) {
+				return false;
+			}
+			const float cameraDistance = -(nx * p0.x + ny * p0.y + nz * p0.z) / length;
+			return cameraDistance < -displacement;
+		}
+
+		void PatchFactors(const XMFLOAT3& p0, const XMFLOAT3& p1, const XMFLOAT3& p2, const Settings& settings, float edgeFactors[3], float& insideFactor) {
+			if (IsCulled(p0, p1, p2, settings)) {
+				edgeFactors[0] = 0.0f;
+				edgeFactors[1] = 0.0f;
+				edgeFactors[2] = 0.0f;
+				insideFactor = 0.0f;
+				return;
+			}
+			edgeFactors[0] = EdgeFactor(p1, p2, settings);
+			edgeFactors[1] = EdgeFactor(p2, p0, settings);
+			edgeFactors[2] = EdgeFactor(p0, p1, settings);
+			insideFactor = (std::max)(edgeFactors[0], (std::max)(edgeFactors[1], edgeFactors[2]));
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <DirectXMath.h>
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Tessellation factors of NormalDisplacementHS.hlsl, which mirrors these
+// functions. Positions are in view space.
+// Edge factors are proportional to the projected length of the edge (the
+// diameter of its bounding sphere), and they only depend on the edge
+// endpoints, so patches sharing an edge get the same factor (no cracks).
+// Patches outside the frustum or back facing are culled (zero factors).
+// Displacement moves vertices inwards along their normal, up to the
+// displacement scale, so the tests are done against the triangle grown
+// by it.
+//
+//////////////////////////////////////////////////////////////////////////
+
+namespace BRE {
+	namespace NormalDisplacementTessellation {
+		// Layout of the hull shader constant buffer after the world view matrix
+		struct Settings {
+			// Normal (pointing inside) and distance of the frustum planes
+			DirectX::XMFLOAT4 mFrustumPlanes[6];
+			// Edge factor of an edge of length 1 at depth 1
+			float mEdgeFactorScale;
+			float mMinFactor;
+			float mMaxFactor;
+			float mDisplacementScale;
+		};
+
+		// Sets the frustum planes and the edge factor scale for edges of
+		// edgeScreenFraction of the screen height once tessellated
+		void SetProjection(const DirectX::XMMATRIX& proj, const float edgeScreenFraction, Settings& settings);
+
+		float EdgeFactor(const DirectX::XMFLOAT3& p0, const DirectX::XMFLOAT3& p1, const Settings& settings);
+
+		bool IsCulled(const DirectX::XMFLOAT3& p0, const DirectX::XMFLOAT3& p1, const DirectX::XMFLOAT3& p2, const Settings& settings);
+
+		// Edge i is the one opposite to vertex i (SV_TessFactor order)
+		void PatchFactors(const DirectX::XMFLOAT3& p0, const DirectX::XMFLOAT3& p1, const DirectX::XMFLOAT3& p2, const Settings& settings, float edgeFactors[3], float& insideFactor);
+	}
+}
\ No newline at end of file
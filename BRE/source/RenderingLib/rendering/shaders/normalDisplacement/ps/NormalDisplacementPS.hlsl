@@ -24,7 +24,7 @@ Texture2D CurvatureTexture : register (t4);
 
 Output main(Input input) {
 	Output output = (Output)0;
-	const float3 sampledNormal = normalize(UnmapNormal(NormalTexture.Sample(TexSampler, input.TexCoord).xyz));
+	const float3 sampledNormal = normalize(UnmapNormalXY(NormalTexture.Sample(TexSampler, input.TexCoord).xy));
 	const float3x3 tbn = float3x3(normalize(input.TangentVS), normalize(input.BinormalVS), normalize(input.NormalVS));
 	output.NormalVS = mul(sampledNormal, tbn);
 	output.BaseColor = BaseColorTexture.Sample(TexSampler, input.TexCoord).rgb;
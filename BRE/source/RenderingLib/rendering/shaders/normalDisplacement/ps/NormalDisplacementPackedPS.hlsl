@@ -0,0 +1 @@
+#include <rendering/shaders/normalDisplacement/ps/NormalDisplacementPackedPS.hlsli>
\ No newline at end of file
@@ -0,0 +1,2 @@
+#define UNIFORM_SMOOTHNESS_METAL_MASK_CURVATURE
+#include <rendering/shaders/normalDisplacement/ps/NormalDisplacementPackedPS.hlsli>
\ No newline at end of file
@@ -3,50 +3,115 @@
 #include <d3d11_1.h>
 #include <sstream>
 
+#include <general/CountedContext.h>
 #include <managers/MaterialManager.h>
 #include <managers/ShadersManager.h>
 #include <utils/Assert.h>
 
 namespace {
 	const char* shader = "content\\shaders\\normalDisplacement\\NormalDisplacementPS.cso";
+	// Indexed by MaterialManager uniform mask
+	const char* packedShaders[] = {
+		"content\\shaders\\normalDisplacement\\NormalDisplacementPackedPS.cso",
+		"content\\shaders\\normalDisplacement\\NormalDisplacementPackedUniformBaseColorPS.cso",
+		"content\\shaders\\normalDisplacement\\NormalDisplacementPackedUniformScalarsPS.cso",
+		"content\\shaders\\normalDisplacement\\NormalDisplacementPackedUniformPS.cso",
+	};
+	const char* tableShader = "content\\shaders\\normalDisplacement\\NormalDisplacementTablePS.cso";
 	const size_t sNumGBuffers = 3;
 }
 
 namespace BRE {
-	NormalDisplacementPixelShaderData::NormalDisplacementPixelShaderData() {
+	NormalDisplacementPixelShaderData::NormalDisplacementPixelShaderData()
+		: mNormalOverrideSRV(nullptr)
+	{
 		ShadersManager::gInstance->LoadPixelShader(shader, &mShader);
 		BRE_ASSERT(mShader);
+		static_assert(ARRAYSIZE(packedShaders) == MaterialManager::sNumUniformPermutations, "One packed shader per uniform mask");
+		for (size_t i = 0U; i < ARRAYSIZE(packedShaders); ++i) {
+			ShadersManager::gInstance->LoadPixelShader(packedShaders[i], &mPackedShaders[i]);
+			BRE_ASSERT(mPackedShaders[i]);
+		}
+		ShadersManager::gInstance->LoadPixelShader(tableShader, &mTableShader);
+		BRE_ASSERT(mTableShader);
 	}
 
 	void NormalDisplacementPixelShaderData::SetMaterial(const size_t matId) {
+		mMaterialId = matId;
+		FetchMaterial();
+	}
+
+	void NormalDisplacementPixelShaderData::SetNormalSRV(ID3D11ShaderResourceView* normalSRV) {
+		BRE_ASSERT(normalSRV);
+		mNormalOverrideSRV = normalSRV;
+		mNormalSRV = normalSRV;
+		mTableIndexBuffer = nullptr;
+	}
+
+	void NormalDisplacementPixelShaderData::FetchMaterial() {
 		MaterialManager::MaterialData matData;
-		MaterialManager::gInstance->GetMaterial(matId, matData);
-		mNormalSRV = matData.mNormalSRV;
+		MaterialManager::gInstance->GetMaterial(mMaterialId, matData);
+		mNormalSRV = mNormalOverrideSRV ? mNormalOverrideSRV : matData.mNormalSRV;
 		BRE_ASSERT(mNormalSRV);
+		mUniformMask = matData.mUniformMask;
+		mMaterialConstantsBuffer = matData.mConstantsBuffer;
+		// The table has the material normal texture
+		mTableIndexBuffer = mNormalOverrideSRV ? nullptr : matData.mTableIndexBuffer;
 		mBaseColorSRV = matData.mBaseColorSRV;
-		BRE_ASSERT(mBaseColorSRV);
+		BRE_ASSERT(mBaseColorSRV || (mUniformMask & MaterialManager::sUniformBaseColor) != 0U);
 		mSmoothnessSRV = matData.mSmoothnessSRV;
-		BRE_ASSERT(mSmoothnessSRV);
 		mMetalMaskSRV = matData.mMetalMaskSRV;
-		BRE_ASSERT(mMetalMaskSRV);
 		mCurvatureSRV = matData.mCurvatureSRV;
-		BRE_ASSERT(mCurvatureSRV);
+		mSmoothnessMetalMaskCurvatureSRV = matData.mSmoothnessMetalMaskCurvatureSRV;
+		mSampler = matData.mSampler;
+		BRE_ASSERT(mSampler);
+		BRE_ASSERT(mSmoothnessMetalMaskCurvatureSRV || (mUniformMask & MaterialManager::sUniformSmoothnessMetalMaskCurvature) != 0U || (mSmoothnessSRV && mMetalMaskSRV && mCurvatureSRV));
+		mMaterialResident = matData.mResident;
+		mMaterialVersion = MaterialManager::gInstance->TextureViewsVersion();
 	}
 
 	void NormalDisplacementPixelShaderData::PreDraw(ID3D11Device1& /*device*/, ID3D11DeviceContext1& context, ID3D11RenderTargetView* *geometryBuffersRTVs) {
-		BRE_ASSERT(mShader);
-		context.PSSetShader(mShader, nullptr, 0);
-
+		BRE_COUNTER_ADD(RenderCounter::PreDrawCalls, 1U);
+		// Material textures are loaded on first use
+		if (!mMaterialResident) {
+			MaterialManager::gInstance->RequestResidency(mMaterialId);
+		}
+		if (mMaterialVersion != MaterialManager::gInstance->TextureViewsVersion()) {
+			FetchMaterial();
+		}
 		BRE_ASSERT(mNormalSRV);
-		BRE_ASSERT(mBaseColorSRV);
-		BRE_ASSERT(mSmoothnessSRV);
-		BRE_ASSERT(mMetalMaskSRV);
-		BRE_ASSERT(mCurvatureSRV);
-		ID3D11ShaderResourceView* const srvs[] = { mNormalSRV, mBaseColorSRV, mSmoothnessSRV, mMetalMaskSRV, mCurvatureSRV };
-		context.PSSetShaderResources(0, ARRAYSIZE(srvs), srvs);
+		if (mTableIndexBuffer) {
+			// Material textures are bound once for the geometry pass (see MaterialTable)
+			BRE_ASSERT(mTableShader);
+			CountedContext::PSSetShader(context, mTableShader);
+			ID3D11Buffer* const cBuffers[] = { mTableIndexBuffer };
+			CountedContext::PSSetConstantBuffers(context, 0, ARRAYSIZE(cBuffers), cBuffers);
+		}
+		// Uniform textures are only used by packed materials
+		else if (mSmoothnessMetalMaskCurvatureSRV || mUniformMask != 0U) {
+			BRE_ASSERT(mUniformMask < ARRAYSIZE(mPackedShaders));
+			BRE_ASSERT(mPackedShaders[mUniformMask]);
+			CountedContext::PSSetShader(context, mPackedShaders[mUniformMask]);
+			ID3D11ShaderResourceView* const srvs[] = { mNormalSRV, mBaseColorSRV, mSmoothnessMetalMaskCurvatureSRV };
+			CountedContext::PSSetShaderResources(context, 0, ARRAYSIZE(srvs), srvs);
+			if (mMaterialConstantsBuffer) {
+				ID3D11Buffer* const cBuffers[] = { mMaterialConstantsBuffer };
+				CountedContext::PSSetConstantBuffers(context, 0, ARRAYSIZE(cBuffers), cBuffers);
+			}
+		}
+		else {
+			BRE_ASSERT(mSmoothnessSRV);
+			BRE_ASSERT(mMetalMaskSRV);
+			BRE_ASSERT(mCurvatureSRV);
+			BRE_ASSERT(mBaseColorSRV);
+			BRE_ASSERT(mShader);
+			CountedContext::PSSetShader(context, mShader);
+			ID3D11ShaderResourceView* const srvs[] = { mNormalSRV, mBaseColorSRV, mSmoothnessSRV, mMetalMaskSRV, mCurvatureSRV };
+			CountedContext::PSSetShaderResources(context, 0, ARRAYSIZE(srvs), srvs);
+		}
 
 		ID3D11SamplerState* const samplerStates[] = { mSampler };
-		context.PSSetSamplers(0, ARRAYSIZE(samplerStates), samplerStates);
+		CountedContext::PSSetSamplers(context, 0, ARRAYSIZE(samplerStates), samplerStates);
 
 		context.OMGetRenderTargets(1, &mDefaultRTV, &mDefaultDSV);
 		context.OMSetRenderTargets(sNumGBuffers, geometryBuffersRTVs, mDefaultDSV);
@@ -55,12 +120,19 @@ namespace BRE {
 	void NormalDisplacementPixelShaderData::PostDraw(ID3D11DeviceContext1& context) {
 		context.PSSetShader(nullptr, nullptr, 0);
 
-		ID3D11ShaderResourceView* const srvs[] = { nullptr, nullptr, nullptr, nullptr, nullptr };
-		context.PSSetShaderResources(0, ARRAYSIZE(srvs), srvs);
+		if (!mTableIndexBuffer) {
+			ID3D11ShaderResourceView* const srvs[] = { nullptr, nullptr, nullptr, nullptr, nullptr };
+			context.PSSetShaderResources(0, ARRAYSIZE(srvs), srvs);
+		}
 		
 		ID3D11SamplerState* const samplerStates[] = { nullptr };
 		context.PSSetSamplers(0, ARRAYSIZE(samplerStates), samplerStates);
 
+		if (mMaterialConstantsBuffer || mTableIndexBuffer) {
+			ID3D11Buffer* const cBuffers[] = { nullptr };
+			context.PSSetConstantBuffers(0, ARRAYSIZE(cBuffers), cBuffers);
+		}
+
 		ID3D11RenderTargetView* rtvs[sNumGBuffers];
 		ZeroMemory(rtvs, sizeof(ID3D11RenderTargetView*) * ARRAYSIZE(rtvs));
 		rtvs[0] = mDefaultRTV;
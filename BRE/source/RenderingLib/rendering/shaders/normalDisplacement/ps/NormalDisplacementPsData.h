@@ -2,6 +2,7 @@
 
 #include <DirectXMath.h>
 
+struct ID3D11Buffer;
 struct ID3D11DepthStencilView;
 struct ID3D11Device1;
 struct ID3D11DeviceContext1;
@@ -19,12 +20,22 @@ namespace BRE {
 		void PostDraw(ID3D11DeviceContext1& context);
 
 		ID3D11SamplerState* &SamplerState() { return mSampler; }
-		ID3D11ShaderResourceView* &NormalSRV() { return mNormalSRV; }
 
 		void SetMaterial(const size_t matId);
+		size_t MaterialId() const { return mMaterialId; }
+		// Used instead of the material normal texture
+		void SetNormalSRV(ID3D11ShaderResourceView* normalSRV);
 
 	private:
+		// Gets material views again (streamed textures change them)
+		void FetchMaterial();
+
 		ID3D11PixelShader* mShader;
+		// Used by materials with packed smoothness, metal mask and curvature.
+		// Indexed by their uniform mask (see MaterialManager).
+		ID3D11PixelShader* mPackedShaders[4];
+		// Used by materials of MaterialTable
+		ID3D11PixelShader* mTableShader;
 
 		ID3D11DepthStencilView* mDefaultDSV;
 		ID3D11RenderTargetView* mDefaultRTV;
@@ -34,7 +45,19 @@ namespace BRE {
 		ID3D11ShaderResourceView* mSmoothnessSRV;
 		ID3D11ShaderResourceView* mMetalMaskSRV;
 		ID3D11ShaderResourceView* mCurvatureSRV;
+		ID3D11ShaderResourceView* mSmoothnessMetalMaskCurvatureSRV;
+		unsigned int mUniformMask;
+		ID3D11Buffer* mMaterialConstantsBuffer;
+		// Not null if the material is in MaterialTable. Its textures are not bound then.
+		ID3D11Buffer* mTableIndexBuffer;
 
 		ID3D11SamplerState* mSampler;
+
+		size_t mMaterialId;
+		// MaterialManager::TextureViewsVersion() when the material was fetched
+		unsigned int mMaterialVersion;
+		// False while placeholder textures are bound
+		bool mMaterialResident;
+		ID3D11ShaderResourceView* mNormalOverrideSRV;
 	};
 }
\ No newline at end of file
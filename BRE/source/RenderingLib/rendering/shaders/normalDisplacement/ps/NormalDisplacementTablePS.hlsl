@@ -0,0 +1,29 @@
+#include <rendering/shaders/MaterialTable.hlsli>
+#include <rendering/shaders/Utils.hlsli>
+
+struct Input {
+	float4 PosCS : SV_Position;
+	float3 NormalVS : NORMAL;
+	float2 TexCoord : TEXCOORD0;
+	float3 TangentVS : TANGENT;
+	float3 BinormalVS : BINORMAL;
+};
+
+struct Output {
+	float3 NormalVS : SV_Target0;
+	float3 BaseColor : SV_Target1;
+	float3 Smoothness_MetalMask_Curvature : SV_Target2;
+};
+
+SamplerState TexSampler : register (s0);
+
+Output main(Input input) {
+	Output output = (Output)0;
+	const MaterialRecord record = MaterialRecords[MaterialIndexValue];
+	const float3 sampledNormal = normalize(UnmapNormalXY(SampleMaterialPool(record.NormalPool, record.NormalSlice, TexSampler, input.TexCoord).xy));
+	const float3x3 tbn = float3x3(normalize(input.TangentVS), normalize(input.BinormalVS), normalize(input.NormalVS));
+	output.NormalVS = mul(sampledNormal, tbn);
+	output.BaseColor = MaterialBaseColor(record, TexSampler, input.TexCoord);
+	output.Smoothness_MetalMask_Curvature = MaterialSmoothnessMetalMaskCurvature(record, TexSampler, input.TexCoord);
+	return output;
+}
\ No newline at end of file
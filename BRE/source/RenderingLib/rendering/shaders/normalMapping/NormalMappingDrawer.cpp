@@ -2,71 +2,79 @@
 
 #include <yaml-cpp/yaml.h>
 
+#include <managers/GeometryPool.h>
+#include <managers/MaterialManager.h>
 #include <managers/ModelManager.h>
-#include <rendering/GlobalResources.h>
+#include <rendering/TransformArray.h>
 #include <rendering/models/Mesh.h>
+#include <rendering/models/MeshLod.h>
 #include <rendering/models/Model.h>
-#include <rendering/shaders/VertexType.h>
+#include <rendering/shaders/DrawerSettings.h>
 
 #include <utils/Assert.h>
 #include <utils/Hash.h>
-#include <utils/YamlUtils.h>
+#include <utils/MathUtils.h>
 
 using namespace DirectX;
 
 namespace BRE {
-	void NormalMappingDrawer::Create(const YAML::Node& node, std::vector<NormalMappingDrawer>& drawers) {
-		BRE_ASSERT(YamlUtils::GetScalar<std::string>(node, "renderType") == std::string("Normal"));
+	void NormalMappingDrawer::Create(const YAML::Node& node, const TransformArray& transforms, const size_t transform, std::vector<NormalMappingDrawer>& drawers) {
+		DrawerSettings settings;
+		const bool settingsRead = DrawerSettings::Read(node, settings);
+		BRE_ASSERT(settingsRead);
+		BRE_ASSERT(settings.mRenderType == "Normal");
 
-		const std::string modelFilePath = YamlUtils::GetScalar<std::string>(node, "path");
-		float translation[3];
-		YamlUtils::GetSequence<float>(node, "translation", translation, ARRAYSIZE(translation));
-		const XMMATRIX translationMatrix = XMMatrixTranslation(translation[0], translation[1], translation[2]);
-		float rotation[3];
-		YamlUtils::GetSequence<float>(node, "rotation", rotation, ARRAYSIZE(rotation));
-		const XMMATRIX rotationMatrix = XMMatrixRotationRollPitchYaw(rotation[0], rotation[1], rotation[2]);
-		float scaling[3];
-		YamlUtils::GetSequence<float>(node, "scaling", scaling, ARRAYSIZE(scaling));
-		const XMMATRIX scalingMatrix = XMMatrixScaling(scaling[0], scaling[1], scaling[2]);
-		const XMMATRIX worldMatrix = scalingMatrix * rotationMatrix * translationMatrix;
-		const float textureScaleFactor = YamlUtils::GetScalar<float>(node, "textureScaleFactor");
+		const XMMATRIX worldMatrix = transforms.World(transform);
+		const float textureScaleFactor = settings.mTextureScaleFactor;
 		ID3D11ShaderResourceView* normalMapSRV = nullptr;
-		if (YamlUtils::IsDefined(node, "normalMapTexture")) {
+		if (!settings.mNormalMapTexture.empty()) {
 			ShaderResourcesManager& shaderResourcesMgr = *ShaderResourcesManager::gInstance;
-			const std::string normalMapTexture = YamlUtils::GetScalar<std::string>(node, "normalMapTexture");
-			shaderResourcesMgr.AddTextureFromFileSRV(normalMapTexture.c_str(), &normalMapSRV);
+			shaderResourcesMgr.AddTextureFromFileSRV(settings.mNormalMapTexture.c_str(), &normalMapSRV);
 		}
 
-		const std::string material = YamlUtils::GetScalar<std::string>(node, "material");
-		const size_t matId = Utils::Hash(material.c_str());
+		const size_t matId = Utils::Hash(settings.mMaterial.c_str());
 
 		const Model* model;
-		const size_t modelId = ModelManager::gInstance->LoadModel(modelFilePath.c_str(), &model);
+		const size_t modelId = ModelManager::gInstance->LoadModel(settings.mPath.c_str(), &model);
 		BRE_ASSERT(model);
 		const std::vector<BRE::Mesh*>& meshes = model->Meshes();
 		const size_t numMeshes = meshes.size();
 		BRE_ASSERT(numMeshes > 0);
 		for (size_t iMeshIndex = 0; iMeshIndex < numMeshes; ++iMeshIndex) {
 			NormalMappingDrawer drawer;
-			drawer.mVertexShaderData.VertexBuffer() = ShaderResourcesManager::gInstance->Buffer(NormalMappingVertexData::CreateVertexBuffer(modelId, iMeshIndex));
-			BRE_ASSERT(drawer.mVertexShaderData.VertexBuffer());
-			drawer.mVertexShaderData.IndexBuffer() = ShaderResourcesManager::gInstance->Buffer(model->CreateIndexBuffer(iMeshIndex));
-			drawer.mVertexShaderData.SetIndexCount(static_cast<unsigned int>(model->Meshes()[iMeshIndex]->Indices().size()));
+			drawer.mVertexShaderData.SetMesh(GeometryPool::gInstance->AddMesh(modelId, iMeshIndex, GeometryPool::VertexFormat::NormalMapping));
+			drawer.mLods = &meshes[iMeshIndex]->Lods();
+			drawer.mLod = 0U;
+			drawer.mVertexShaderData.SetIndexRange(drawer.mLods->front().mStartIndex, drawer.mLods->front().mIndexCount);
 			drawer.mVertexShaderData.TextureScaleFactor() = textureScaleFactor;
-			XMStoreFloat4x4(&drawer.mWorld, worldMatrix);
+			drawer.mTransform = transform;
+			drawer.mLocalBoundingSphere = Utils::BoundingSphere(meshes[iMeshIndex]->Vertices(), XMMatrixIdentity());
+			drawer.SetWorld(worldMatrix);
+			drawer.mTextureScaleFactor = textureScaleFactor;
 			drawer.mPixelShaderData.SetMaterial(matId);
-			drawer.mPixelShaderData.SamplerState() = GlobalResources::gInstance->MinMagMipPointSampler();
 			if (normalMapSRV) {
-				drawer.mPixelShaderData.NormalSRV() = normalMapSRV;
+				drawer.mPixelShaderData.SetNormalSRV(normalMapSRV);
 			}
 			drawers.push_back(drawer);
 		}
 	}
 
-	void NormalMappingDrawer::Draw(ID3D11Device1& device, ID3D11DeviceContext1& context, ID3D11RenderTargetView* *geometryBuffersRTVs, const XMMATRIX& view, const XMMATRIX& proj) {
-		const XMMATRIX world = XMLoadFloat4x4(&mWorld);
-		XMStoreFloat4x4(&mVertexShaderData.WorldView(), XMMatrixTranspose(world * view));
-		XMStoreFloat4x4(&mVertexShaderData.WorldViewProjection(), XMMatrixTranspose(world * view * proj));
+	void NormalMappingDrawer::SetWorld(const XMMATRIX& world) {
+		mBoundingSphere = Utils::TransformBoundingSphere(mLocalBoundingSphere, world);
+	}
+
+	void NormalMappingDrawer::Draw(ID3D11Device1& device, ID3D11DeviceContext1& context, ID3D11RenderTargetView* *geometryBuffersRTVs, const TransformArray& transforms, const XMMATRIX& view, const XMMATRIX& proj) {
+		const float screenFraction = Utils::ProjectedScreenFraction(mBoundingSphere, view, proj);
+		if (MaterialManager::gInstance->IsStreaming()) {
+			// Texture coordinates are assumed to span the mesh once, so a repeat covers its bounds divided by the scale factor
+			MaterialManager::gInstance->RequestDetail(mPixelShaderData.MaterialId(), screenFraction / mTextureScaleFactor);
+		}
+		mLod = MeshLod::Select(*mLods, mLod, screenFraction);
+		mVertexShaderData.SetIndexRange((*mLods)[mLod].mStartIndex, (*mLods)[mLod].mIndexCount);
+
+		const TransformArray::DrawTransforms& drawTransforms = transforms.GetDrawTransforms(mTransform);
+		mVertexShaderData.WorldView() = drawTransforms.mWorldView;
+		mVertexShaderData.WorldViewProjection() = drawTransforms.mWorldViewProjection;
 
 		mVertexShaderData.PreDraw(device, context);
 		mPixelShaderData.PreDraw(device, context, geometryBuffersRTVs);
@@ -0,0 +1 @@
+#include <rendering/shaders/normalMapping/ps/NormalMappingPackedPS.hlsli>
\ No newline at end of file
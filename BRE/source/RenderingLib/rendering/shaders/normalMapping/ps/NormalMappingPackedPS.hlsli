@@ -0,0 +1,45 @@
+#include <rendering/shaders/MaterialConstants.hlsli>
+#include <rendering/shaders/Utils.hlsli>
+
+struct Input {
+	float4 PosCS : SV_Position;
+	float3 NormalVS : NORMAL;
+	float2 TexCoord : TEXCOORD0;
+	float3 TangentVS : TANGENT;
+	float3 BinormalVS : BINORMAL;
+};
+
+struct Output {
+	float3 NormalVS : SV_Target0;
+	float3 BaseColor : SV_Target1;
+	float3 Smoothness_MetalMask_Curvature : SV_Target2;
+};
+
+SamplerState TexSampler : register (s0);
+
+Texture2D NormalTexture : register (t0);
+#ifndef UNIFORM_BASE_COLOR
+Texture2D BaseColorTexture : register (t1);
+#endif
+#ifndef UNIFORM_SMOOTHNESS_METAL_MASK_CURVATURE
+// R: smoothness, G: metal mask, B: curvature
+Texture2D SmoothnessMetalMaskCurvatureTexture : register (t2);
+#endif
+
+Output main(Input input) {
+	Output output = (Output)0;
+	const float3 sampledNormal = normalize(UnmapNormalXY(NormalTexture.Sample(TexSampler, input.TexCoord).xy));
+	const float3x3 tbn = float3x3(normalize(input.TangentVS), normalize(input.BinormalVS), normalize(input.NormalVS));
+	output.NormalVS = mul(sampledNormal, tbn);
+#ifdef UNIFORM_BASE_COLOR
+	output.BaseColor = BaseColorValue;
+#else
+	output.BaseColor = BaseColorTexture.Sample(TexSampler, input.TexCoord).rgb;
+#endif
+#ifdef UNIFORM_SMOOTHNESS_METAL_MASK_CURVATURE
+	output.Smoothness_MetalMask_Curvature = SmoothnessMetalMaskCurvatureValue;
+#else
+	output.Smoothness_MetalMask_Curvature = SmoothnessMetalMaskCurvatureTexture.Sample(TexSampler, input.TexCoord).rgb;
+#endif
+	return output;
+}
\ No newline at end of file
@@ -0,0 +1,3 @@
+#define UNIFORM_BASE_COLOR
+#define UNIFORM_SMOOTHNESS_METAL_MASK_CURVATURE
+#include <rendering/shaders/normalMapping/ps/NormalMappingPackedPS.hlsli>
\ No newline at end of file
@@ -0,0 +1,2 @@
+#define UNIFORM_SMOOTHNESS_METAL_MASK_CURVATURE
+#include <rendering/shaders/normalMapping/ps/NormalMappingPackedPS.hlsli>
\ No newline at end of file
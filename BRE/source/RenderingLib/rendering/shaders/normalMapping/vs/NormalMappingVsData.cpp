@@ -3,8 +3,9 @@
 #include <d3d11_1.h>
 #include <sstream>
 
+#include <general/CountedContext.h>
+#include <managers/GeometryPool.h>
 #include <managers/ShadersManager.h>
-#include <rendering/shaders/VertexType.h>
 #include <utils/Hash.h>
 
 using namespace DirectX;
@@ -52,49 +53,38 @@ namespace BRE {
 	}
 
 	void NormalMappingVertexShaderData::PreDraw(ID3D11Device1& device, ID3D11DeviceContext1& context) {
+		BRE_COUNTER_ADD(RenderCounter::PreDrawCalls, 1U);
 		BRE_ASSERT(mInputLayout);
 		BRE_ASSERT(mShader);
-		BRE_ASSERT(mVertexBuffer);
-		BRE_ASSERT(mIndexBuffer);
 		BRE_ASSERT(mIndexCount > 0);
 
 		context.IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
 
 		context.IASetInputLayout(mInputLayout);
 
-		context.VSSetShader(mShader, nullptr, 0);
+		CountedContext::VSSetShader(context, mShader);
 
-		const unsigned int stride = sizeof(NormalMappingVertexData);
-		const unsigned int offset = 0;
-		context.IASetVertexBuffers(0, 1, &mVertexBuffer, &stride, &offset);
-
-		context.IASetIndexBuffer(mIndexBuffer, DXGI_FORMAT_R32_UINT, 0);
+		GeometryPool::gInstance->Bind(context, GeometryPool::VertexFormat::NormalMapping);
 
 		// Set constant buffers
 		ID3D11Buffer* const cBuffers[] = { mCBuffer.mBuffer };
 		mCBuffer.CopyDataToBuffer(device);
-		context.VSSetConstantBuffers(0, ARRAYSIZE(cBuffers), cBuffers);
+		CountedContext::VSSetConstantBuffers(context, 0, ARRAYSIZE(cBuffers), cBuffers);
 	}
 
 	void NormalMappingVertexShaderData::DrawIndexed(ID3D11DeviceContext1& context) {
 		BRE_ASSERT(mInputLayout);
 		BRE_ASSERT(mShader);
-		BRE_ASSERT(mVertexBuffer);
-		BRE_ASSERT(mIndexBuffer);
 		BRE_ASSERT(mIndexCount > 0);
-		context.DrawIndexed(mIndexCount, 0, 0);
+		const GeometryPool& geometryPool = *GeometryPool::gInstance;
+		CountedContext::DrawIndexed(context, mIndexCount, geometryPool.StartIndex(mMesh) + mStartIndex, static_cast<int>(geometryPool.BaseVertex(mMesh)));
 	}
 
 	void NormalMappingVertexShaderData::PostDraw(ID3D11DeviceContext1& context) {
 		context.IASetInputLayout(nullptr);
 		context.VSSetShader(nullptr, nullptr, 0);
 
-		ID3D11Buffer* vertexBuffers[] = { nullptr };
-		const unsigned int stride[] = { 0 };
-		const unsigned int offset[] = { 0 };
-		context.IASetVertexBuffers(0, 1, vertexBuffers, stride, offset);
-
-		context.IASetIndexBuffer(nullptr, DXGI_FORMAT_R32_UINT, 0);
+		// Geometry pool buffers stay bound for the next draw
 
 		ID3D11Buffer* const cBuffers[] = { nullptr };
 		context.VSSetConstantBuffers(0, ARRAYSIZE(cBuffers), cBuffers);
@@ -24,9 +24,9 @@ namespace BRE {
 		DirectX::XMFLOAT4X4& WorldView() { return mCBuffer.mData.mWorldView; }
 		float& TextureScaleFactor() { return mCBuffer.mData.mTextureScaleFactor;  }
 
-		ID3D11Buffer* &VertexBuffer() { return mVertexBuffer; }
-		ID3D11Buffer* &IndexBuffer() { return mIndexBuffer; }
-		void SetIndexCount(const unsigned int indexCount) { BRE_ASSERT(indexCount > 0); mIndexCount = indexCount; }
+		// GeometryPool mesh. Index range is relative to its start index.
+		void SetMesh(const size_t mesh) { mMesh = mesh; }
+		void SetIndexRange(const unsigned int startIndex, const unsigned int indexCount) { BRE_ASSERT(indexCount > 0); mStartIndex = startIndex; mIndexCount = indexCount; }
 
 	private:
 		void InitializeShader();
@@ -42,8 +42,8 @@ namespace BRE {
 		};
 		Buffer<CBufferPerFrameData> mCBuffer;
 
-		ID3D11Buffer* mVertexBuffer;
-		ID3D11Buffer* mIndexBuffer;
+		size_t mMesh;
+		unsigned int mStartIndex;
 		unsigned int mIndexCount;
 	};
 }
\ No newline at end of file
@@ -0,0 +1,233 @@
+#include "ContentPack.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include <utils/Assert.h>
+#include <utils/Lz4.h>
+
+namespace {
+	// Ranges of fewer blocks per thread are decoded on the calling thread only
+	const size_t sMinBlocksPerThread = 4U;
+
+	std::uint64_t Read64(const std::uint8_t* src) {
+		std::uint64_t value;
+		memcpy(&value, src, sizeof(value));
+		return value;
+	}
+
+	// a + b <= limit, without overflow
+	bool FitsIn(const std::uint64_t a, const std::uint64_t b, const std::uint64_t limit) {
+		return a <= limit && b <= limit - a;
+	}
+}
+
+namespace BRE {
+	std::string ContentPack::NormalizePath(const std::string& path) {
+		const size_t start = (path.size() >= 2U && path[0] == '.' && (path[1] == '/' || path[1] == '\\')) ? 2U : 0U;
+		std::string normalized;
+		normalized.reserve(path.size() - start);
+		for (size_t i = start; i < path.size(); ++i) {
+			const char c = path[i];
+			if (c == '\\') {
+				normalized.push_back('/');
+			}
+			else if (c >= 'A' && c <= 'Z') {
+				normalized.push_back(static_cast<char>(c - 'A' + 'a'));
+			}
+			else {
+				normalized.push_back(c);
+			}
+		}
+		return normalized;
+	}
+
+	std::uint64_t ContentPack::HashPath(const std::string& normalizedPath) {
+		std::uint64_t hash = 14695981039346656037ULL;
+		for (const char c : normalizedPath) {
+			hash ^= static_cast<std::uint8_t>(c);
+			hash *= 1099511628211ULL;
+		}
+		return hash;
+	}
+
+	size_t ContentPack::NumBlocks(const std::uint64_t size, const std::uint32_t blockSize) {
+		BRE_ASSERT(blockSize > 0U);
+		return static_cast<size_t>((size + blockSize - 1U) / blockSize);
+	}
+
+	bool ContentPack::Open(const std::string& filepath, std::string& error) {
+		mHeader = nullptr;
+		mEntries = nullptr;
+		mNames = nullptr;
+		mFilepath = filepath;
+		if (!mFile.Open(filepath)) {
+			error = "Cannot open " + filepath;
+			return false;
+		}
+
+		const std::uint8_t* data = mFile.Data();
+		const std::uint64_t fileSize = mFile.Size();
+		if (fileSize < sizeof(Header)) {
+			error = filepath + " is too small";
+			return false;
+		}
+		const Header* header = reinterpret_cast<const Header*>(data);
+		if (header->mMagic != sMagic) {
+			error = filepath + " is not a content pack";
+			return false;
+		}
+		if (header->mVersion != sVersion) {
+			error = filepath + " has an unsupported version";
+			return false;
+		}
+		if (header->mAlignment == 0U || (header->mAlignment & (header->mAlignment - 1U)) != 0U || header->mBlockSize == 0U) {
+			error = filepath + " has an invalid header";
+			return false;
+		}
+		if ((header->mEntriesOffset % sizeof(std::uint64_t)) != 0U || !FitsIn(header->mEntriesOffset, static_cast<std::uint64_t>(header->mNumEntries) * sizeof(Entry), fileSize)) {
+			error = filepath + " has a truncated entry table";
+			return false;
+		}
+		if (!FitsIn(header->mNamesOffset, header->mNamesSize, fileSize) || (header->mNumEntries > 0U && (header->mNamesSize == 0U || data[header->mNamesOffset + header->mNamesSize - 1U] != '\0'))) {
+			error = filepath + " has invalid names";
+			return false;
+		}
+
+		const Entry* entries = reinterpret_cast<const Entry*>(data + header->mEntriesOffset);
+		for (size_t i = 0U; i < header->mNumEntries; ++i) {
+			const Entry& entry = entries[i];
+			const bool compressed = (entry.mFlags & sCompressed) != 0U;
+			const bool validSize = compressed ? entry.mStoredSize >= NumBlocks(entry.mSize, header->mBlockSize) * sizeof(std::uint64_t) : entry.mStoredSize == entry.mSize;
+			if (!FitsIn(entry.mOffset, entry.mStoredSize, fileSize) || !validSize || entry.mNameOffset >= header->mNamesSize || (i > 0U && entries[i - 1U].mPathHash > entry.mPathHash)) {
+				error = filepath + " has an invalid entry";
+				return false;
+			}
+		}
+
+		mHeader = header;
+		mEntries = entries;
+		mNames = reinterpret_cast<const char*>(data + header->mNamesOffset);
+		return true;
+	}
+
+	const ContentPack::Entry& ContentPack::GetEntry(const size_t entry) const {
+		BRE_ASSERT(entry < NumEntries());
+		return mEntries[entry];
+	}
+
+	const char* ContentPack::EntryName(const size_t entry) const {
+		BRE_ASSERT(entry < NumEntries());
+		return mNames + mEntries[entry].mNameOffset;
+	}
+
+	bool ContentPack::Find(const std::string& path, size_t& entry) const {
+		if (!mHeader) {
+			return false;
+		}
+		const std::string normalizedPath = NormalizePath(path);
+		const std::uint64_t hash = HashPath(normalizedPath);
+		const Entry* end = mEntries + mHeader->mNumEntries;
+		const Entry* it = std::lower_bound(mEntries, end, hash, [](const Entry& lhs, const std::uint64_t rhs) { return lhs.mPathHash < rhs; });
+		// Paths with the same hash are consecutive
+		for (; it != end && it->mPathHash == hash; ++it) {
+			if (normalizedPath == mNames + it->mNameOffset) {
+				entry = static_cast<size_t>(it - mEntries);
+				return true;
+			}
+		}
+		return false;
+	}
+
+	const std::uint8_t* ContentPack::EntryData(const size_t entry) const {
+		const Entry& packEntry = GetEntry(entry);
+		return (packEntry.mFlags & sCompressed) != 0U ? nullptr : mFile.Data() + packEntry.mOffset;
+	}
+
+	bool ContentPack::Read(const size_t entry, const size_t offset, const size_t size, std::uint8_t* data) const {
+		const Entry& packEntry = GetEntry(entry);
+		if (!FitsIn(offset, size, packEntry.mSize)) {
+			return false;
+		}
+		if (size == 0U) {
+			return true;
+		}
+		BRE_ASSERT(data);
+		if ((packEntry.mFlags & sCompressed) == 0U) {
+			memcpy(data, mFile.Data() + packEntry.mOffset + offset, size);
+			return true;
+		}
+
+		const size_t blockSize = mHeader->mBlockSize;
+		const size_t firstBlock = offset / blockSize;
+		const size_t lastBlock = (offset + size - 1U) / blockSize;
+		// Blocks covered by the range are decoded in place, the others through scratch
+		auto readBlock = [&](const size_t block, std::vector<std::uint8_t>& scratch) {
+			const size_t blockStart = block * blockSize;
+			const size_t blockBytes = (std::min)(blockSize, static_cast<size_t>(packEntry.mSize) - blockStart);
+			const size_t begin = (std::max)(offset, blockStart);
+			const size_t end = (std::min)(offset + size, blockStart + blockBytes);
+			if (begin == blockStart && end == blockStart + blockBytes) {
+				return DecodeBlock(packEntry, block, blockBytes, data + (blockStart - offset));
+			}
+			scratch.resize(blockBytes);
+			if (!DecodeBlock(packEntry, block, blockBytes, scratch.data())) {
+				return false;
+			}
+			memcpy(data + (begin - offset), scratch.data() + (begin - blockStart), end - begin);
+			return true;
+		};
+
+		const size_t numBlocks = lastBlock - firstBlock + 1U;
+		const size_t numThreads = (std::min)(static_cast<size_t>((std::max)(std::thread::hardware_concurrency(), 1U)), numBlocks / sMinBlocksPerThread);
+		if (numThreads <= 1U) {
+			std::vector<std::uint8_t> scratch;
+			for (size_t block = firstBlock; block <= lastBlock; ++block) {
+				if (!readBlock(block, scratch)) {
+					return false;
+				}
+			}
+			return true;
+		}
+
+		std::atomic<size_t> nextBlock(firstBlock);
+		std::atomic<bool> succeeded(true);
+		auto decode = [&]() {
+			std::vector<std::uint8_t> scratch;
+			for (size_t block = nextBlock++; block <= lastBlock && succeeded; block = nextBlock++) {
+				if (!readBlock(block, scratch)) {
+					succeeded = false;
+				}
+			}
+		};
+		std::vector<std::thread> threads;
+		for (size_t i = 1U; i < numThreads; ++i) {
+			threads.emplace_back(decode);
+		}
+		decode();
+		for (std::thread& thread : threads) {
+			thread.join();
+		}
+		return succeeded;
+	}
+
+	bool ContentPack::DecodeBlock(const Entry& entry, const size_t block, const size_t blockBytes, std::uint8_t* data) const {
+		const std::uint8_t* base = mFile.Data() + entry.mOffset;
+		const size_t tableBytes = NumBlocks(entry.mSize, mHeader->mBlockSize) * sizeof(std::uint64_t);
+		const std::uint64_t begin = block == 0U ? 0U : Read64(base + (block - 1U) * sizeof(std::uint64_t));
+		const std::uint64_t end = Read64(base + block * sizeof(std::uint64_t));
+		if (begin > end || !FitsIn(tableBytes, end, entry.mStoredSize)) {
+			return false;
+		}
+		const std::uint8_t* src = base + tableBytes + begin;
+		const size_t srcSize = static_cast<size_t>(end - begin);
+		if (srcSize == blockBytes) {
+			memcpy(data, src, blockBytes);
+			return true;
+		}
+		return Lz4::Decompress(src, srcSize, data, blockBytes);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include <utils/MappedFile.h>
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Single file content pack (written by ContentTools pack), memory mapped.
+// Layout: Header, entry data, Entry table, null terminated path names.
+// Entries are sorted by the hash of their normalized path (see
+// NormalizePath()), so a lookup is a binary search of the mapped table
+// and no allocation. Entry data starts at multiples of the pack
+// alignment, and uncompressed entries are used in place (EntryData()).
+// Compressed entries are split in blocks of Header::mBlockSize bytes
+// compressed independently (see Lz4), preceded by a table with the end of
+// each block. Any range of the entry decodes only its blocks, and large
+// ranges are decoded on several threads. Blocks that do not shrink are
+// stored uncompressed. Entries with the same content share their data.
+// Reads do not change the pack, so they can run on any thread.
+// It does not depend on Direct3D, so offline tools use it too.
+//
+//////////////////////////////////////////////////////////////////////////
+
+namespace BRE {
+	class ContentPack {
+	public:
+		// "BREP"
+		static const std::uint32_t sMagic = 0x50455242U;
+		static const std::uint32_t sVersion = 1U;
+		// Entry::mFlags
+		static const std::uint32_t sCompressed = 1U;
+
+		struct Header {
+			std::uint32_t mMagic;
+			std::uint32_t mVersion;
+			std::uint32_t mNumEntries;
+			// Entry data offsets are multiples of it
+			std::uint32_t mAlignment;
+			// Uncompressed bytes of each block of compressed entries (the last one can be smaller)
+			std::uint32_t mBlockSize;
+			std::uint32_t mPadding;
+			// Entry table (8 bytes aligned)
+			std::uint64_t mEntriesOffset;
+			std::uint64_t mNamesOffset;
+			std::uint64_t mNamesSize;
+		};
+
+		struct Entry {
+			std::uint64_t mPathHash;
+			std::uint64_t mOffset;
+			// Bytes of the file
+			std::uint64_t mSize;
+			// Bytes in the pack (block table included)
+			std::uint64_t mStoredSize;
+			// Offset of the normalized path in the names
+			std::uint32_t mNameOffset;
+			std::uint32_t mFlags;
+		};
+
+		// '\\' separators become '/', ASCII letters lower case and a leading "./" is removed
+		static std::string NormalizePath(const std::string& path);
+		// 64 bits FNV-1a of a normalized path
+		static std::uint64_t HashPath(const std::string& normalizedPath);
+		static size_t NumBlocks(const std::uint64_t size, const std::uint32_t blockSize);
+
+		ContentPack() = default;
+		ContentPack(const ContentPack&) = delete;
+		const ContentPack& operator=(const ContentPack& rhs) = delete;
+
+		// The header and the entry table are validated. On failure, error is filled and false is returned.
+		bool Open(const std::string& filepath, std::string& error);
+		const std::string& Filepath() const { return mFilepath; }
+
+		size_t NumEntries() const { return mHeader ? mHeader->mNumEntries : 0U; }
+		const Entry& GetEntry(const size_t entry) const;
+		const char* EntryName(const size_t entry) const;
+
+		// Returns false if there is no entry with that path (not normalized)
+		bool Find(const std::string& path, size_t& entry) const;
+
+		// Memory of an uncompressed entry, valid while the pack exists. Null for compressed entries.
+		const std::uint8_t* EntryData(const size_t entry) const;
+
+		// Copies or decodes bytes [offset, offset + size) of the entry into data.
+		// Returns false if the range is out of the entry or a block is corrupted.
+		bool Read(const size_t entry, const size_t offset, const size_t size, std::uint8_t* data) const;
+
+	private:
+		// Decodes the block (blockBytes bytes) of a compressed entry
+		bool DecodeBlock(const Entry& entry, const size_t block, const size_t blockBytes, std::uint8_t* data) const;
+
+		std::string mFilepath;
+		MappedFile mFile;
+		const Header* mHeader = nullptr;
+		const Entry* mEntries = nullptr;
+		const char* mNames = nullptr;
+	};
+}
\ No newline at end of file
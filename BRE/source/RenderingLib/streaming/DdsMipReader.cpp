@@ -0,0 +1,223 @@
+#include "DdsMipReader.h"
+
+#include <algorithm>
+
+#include <managers/VirtualFileSystem.h>
+#include <utils/Assert.h>
+
+namespace {
+	const std::uint32_t sMagic = 0x20534444U; // "DDS "
+	const size_t sHeaderSize = 124U;
+	const size_t sHeaderDX10Size = 20U;
+
+	// DDS_PIXELFORMAT flags
+	const std::uint32_t sPixelFormatFourCC = 0x4U;
+	const std::uint32_t sPixelFormatRGB = 0x40U;
+
+	// Header caps2 and DX10 misc flags
+	const std::uint32_t sCaps2CubeMap = 0x200U;
+	const std::uint32_t sCaps2Volume = 0x200000U;
+	const std::uint32_t sMiscTextureCube = 0x4U;
+	const std::uint32_t sResourceDimensionTexture2D = 3U;
+
+	// DXGI_FORMAT values
+	const std::uint32_t sFormatR8G8B8A8 = 28U;
+	const std::uint32_t sFormatR8G8B8A8SRGB = 29U;
+	const std::uint32_t sFormatBC1 = 71U;
+	const std::uint32_t sFormatBC1SRGB = 72U;
+	const std::uint32_t sFormatBC4 = 80U;
+	const std::uint32_t sFormatBC5 = 83U;
+	const std::uint32_t sFormatB8G8R8A8 = 87U;
+	const std::uint32_t sFormatB8G8R8X8 = 88U;
+	const std::uint32_t sFormatB8G8R8A8SRGB = 91U;
+	const std::uint32_t sFormatB8G8R8X8SRGB = 93U;
+	const std::uint32_t sFormatBC7 = 98U;
+	const std::uint32_t sFormatBC7SRGB = 99U;
+
+	std::uint32_t FourCC(const char a, const char b, const char c, const char d) {
+		return static_cast<std::uint32_t>(a) | (static_cast<std::uint32_t>(b) << 8U) | (static_cast<std::uint32_t>(c) << 16U) | (static_cast<std::uint32_t>(d) << 24U);
+	}
+
+	std::uint32_t Read32(const std::uint8_t* data, const size_t offset) {
+		return static_cast<std::uint32_t>(data[offset]) | (static_cast<std::uint32_t>(data[offset + 1U]) << 8U) | (static_cast<std::uint32_t>(data[offset + 2U]) << 16U) | (static_cast<std::uint32_t>(data[offset + 3U]) << 24U);
+	}
+
+	// Bytes per 4x4 block of block compressed formats, 0 otherwise
+	unsigned int BlockBytes(const std::uint32_t format) {
+		switch (format) {
+		case sFormatBC1:
+		case sFormatBC1SRGB:
+		case sFormatBC4:
+			return 8U;
+		case sFormatBC5:
+		case sFormatBC7:
+		case sFormatBC7SRGB:
+			return 16U;
+		default:
+			return 0U;
+		}
+	}
+
+	bool IsSupported(const std::uint32_t format) {
+		switch (format) {
+		case sFormatR8G8B8A8:
+		case sFormatR8G8B8A8SRGB:
+		case sFormatB8G8R8A8:
+		case sFormatB8G8R8X8:
+		case sFormatB8G8R8A8SRGB:
+		case sFormatB8G8R8X8SRGB:
+			return true;
+		default:
+			return BlockBytes(format) > 0U;
+		}
+	}
+
+	// Legacy pixel formats. 0 if not supported
+	std::uint32_t LegacyFormat(const std::uint8_t* pixelFormat) {
+		const std::uint32_t flags = Read32(pixelFormat, 4U);
+		if (flags & sPixelFormatFourCC) {
+			const std::uint32_t fourCC = Read32(pixelFormat, 8U);
+			if (fourCC == FourCC('D', 'X', 'T', '1')) {
+				return sFormatBC1;
+			}
+			if (fourCC == FourCC('A', 'T', 'I', '1') || fourCC == FourCC('B', 'C', '4', 'U')) {
+				return sFormatBC4;
+			}
+			if (fourCC == FourCC('A', 'T', 'I', '2') || fourCC == FourCC('B', 'C', '5', 'U')) {
+				return sFormatBC5;
+			}
+			return 0U;
+		}
+
+		if ((flags & sPixelFormatRGB) && Read32(pixelFormat, 12U) == 32U) {
+			const std::uint32_t red = Read32(pixelFormat, 16U);
+			const std::uint32_t alpha = Read32(pixelFormat, 28U);
+			if (red == 0x000000ffU) {
+				return sFormatR8G8B8A8;
+			}
+			if (red == 0x00ff0000U) {
+				return alpha ? sFormatB8G8R8A8 : sFormatB8G8R8X8;
+			}
+		}
+		return 0U;
+	}
+}
+
+namespace BRE {
+	size_t DdsTextureInfo::Bytes(const unsigned int topMip) const {
+		size_t bytes = 0U;
+		for (unsigned int mip = topMip; mip < mNumMips; ++mip) {
+			bytes += mMipSizes[mip];
+		}
+		return bytes;
+	}
+
+	namespace DdsMipReader {
+		bool ReadInfo(const std::string& filepath, DdsTextureInfo& info, std::string& error) {
+			BRE_ASSERT(VirtualFileSystem::gInstance);
+			const VirtualFileSystem& fileSystem = *VirtualFileSystem::gInstance;
+			size_t fileSize;
+			if (!fileSystem.FileSize(filepath, fileSize)) {
+				error = "Cannot open " + filepath;
+				return false;
+			}
+
+			std::uint8_t header[sizeof(std::uint32_t) + sHeaderSize + sHeaderDX10Size];
+			if (fileSize < sizeof(std::uint32_t) + sHeaderSize || !fileSystem.ReadRange(filepath, 0U, sizeof(std::uint32_t) + sHeaderSize, header)) {
+				error = filepath + " is too small";
+				return false;
+			}
+			if (Read32(header, 0U) != sMagic || Read32(header, 4U) != sHeaderSize) {
+				error = filepath + " is not a DDS file";
+				return false;
+			}
+
+			const std::uint8_t* ddsHeader = header + sizeof(std::uint32_t);
+			const std::uint8_t* pixelFormat = ddsHeader + 72U;
+			if (Read32(ddsHeader, 108U) & (sCaps2CubeMap | sCaps2Volume)) {
+				error = filepath + " is not a 2D texture";
+				return false;
+			}
+
+			size_t dataOffset = sizeof(std::uint32_t) + sHeaderSize;
+			std::uint32_t format = 0U;
+			if ((Read32(pixelFormat, 4U) & sPixelFormatFourCC) && Read32(pixelFormat, 8U) == FourCC('D', 'X', '1', '0')) {
+				if (fileSize < dataOffset + sHeaderDX10Size || !fileSystem.ReadRange(filepath, dataOffset, sHeaderDX10Size, header + dataOffset)) {
+					error = filepath + " has a truncated DX10 header";
+					return false;
+				}
+				const std::uint8_t* dx10Header = header + dataOffset;
+				if (Read32(dx10Header, 4U) != sResourceDimensionTexture2D || (Read32(dx10Header, 8U) & sMiscTextureCube) || Read32(dx10Header, 12U) != 1U) {
+					error = filepath + " is not a single 2D texture";
+					return false;
+				}
+				format = Read32(dx10Header, 0U);
+				dataOffset += sHeaderDX10Size;
+			}
+			else {
+				format = LegacyFormat(pixelFormat);
+			}
+
+			if (!IsSupported(format)) {
+				error = filepath + " has an unsupported format";
+				return false;
+			}
+
+			info.mHeight = Read32(ddsHeader, 8U);
+			info.mWidth = Read32(ddsHeader, 12U);
+			info.mNumMips = std::max(1U, Read32(ddsHeader, 24U));
+			info.mDxgiFormat = format;
+			if (info.mWidth == 0U || info.mHeight == 0U || info.mNumMips > 32U) {
+				error = filepath + " has invalid dimensions";
+				return false;
+			}
+
+			info.mMipOffsets.resize(info.mNumMips);
+			info.mMipSizes.resize(info.mNumMips);
+			info.mMipRowPitches.resize(info.mNumMips);
+			const unsigned int blockBytes = BlockBytes(format);
+			size_t offset = dataOffset;
+			for (unsigned int mip = 0U; mip < info.mNumMips; ++mip) {
+				const unsigned int width = info.MipWidth(mip);
+				const unsigned int height = info.MipHeight(mip);
+				unsigned int rowPitch;
+				unsigned int numRows;
+				if (blockBytes > 0U) {
+					rowPitch = std::max(1U, (width + 3U) / 4U) * blockBytes;
+					numRows = std::max(1U, (height + 3U) / 4U);
+				}
+				else {
+					rowPitch = width * 4U;
+					numRows = height;
+				}
+				info.mMipOffsets[mip] = offset;
+				info.mMipSizes[mip] = static_cast<size_t>(rowPitch) * numRows;
+				info.mMipRowPitches[mip] = rowPitch;
+				offset += info.mMipSizes[mip];
+			}
+
+			if (fileSize < offset) {
+				error = filepath + " is truncated";
+				return false;
+			}
+
+			return true;
+		}
+
+		bool ReadMips(const std::string& filepath, const DdsTextureInfo& info, const unsigned int topMip, std::vector<std::uint8_t>& data, std::string& error) {
+			if (topMip >= info.mNumMips) {
+				error = "Invalid mip range";
+				return false;
+			}
+
+			BRE_ASSERT(VirtualFileSystem::gInstance);
+			data.resize(info.Bytes(topMip));
+			if (!VirtualFileSystem::gInstance->ReadRange(filepath, info.mMipOffsets[topMip], data.size(), data.data())) {
+				error = "Cannot read " + filepath;
+				return false;
+			}
+
+			return true;
+		}
+	}
+}
\ No newline at end of file
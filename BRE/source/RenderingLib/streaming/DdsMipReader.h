@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+//////////////////////////////////////////////////////////////////////////
+//
+// DDS header parsing and mip range reads for texture streaming.
+// Supported textures are 2D, single slice, with 8 bits per channel RGBA/BGRA
+// or BC1/BC4/BC5/BC7 formats (legacy or DX10 headers). Mips are stored top
+// level first, so any range of levels is a contiguous block of the file.
+// Files are read through VirtualFileSystem, so uncompressed pack entries
+// are copied from mapped memory and compressed ones decode only the
+// blocks of the range.
+// It does not depend on Direct3D (formats are DXGI_FORMAT values).
+//
+//////////////////////////////////////////////////////////////////////////
+
+namespace BRE {
+	struct DdsTextureInfo {
+		unsigned int mWidth = 0U;
+		unsigned int mHeight = 0U;
+		unsigned int mNumMips = 0U;
+		std::uint32_t mDxgiFormat = 0U;
+		// Per level layout. Offsets are relative to the beginning of the file.
+		std::vector<size_t> mMipOffsets;
+		std::vector<size_t> mMipSizes;
+		std::vector<unsigned int> mMipRowPitches;
+
+		unsigned int MipWidth(const unsigned int mip) const { return (mWidth >> mip) > 0U ? (mWidth >> mip) : 1U; }
+		unsigned int MipHeight(const unsigned int mip) const { return (mHeight >> mip) > 0U ? (mHeight >> mip) : 1U; }
+		// Bytes of levels [topMip, mNumMips)
+		size_t Bytes(const unsigned int topMip) const;
+	};
+
+	namespace DdsMipReader {
+		// On failure, error is filled and false is returned
+		bool ReadInfo(const std::string& filepath, DdsTextureInfo& info, std::string& error);
+
+		// Reads levels [topMip, info.mNumMips) into data. Level i starts at
+		// info.mMipOffsets[i] - info.mMipOffsets[topMip].
+		bool ReadMips(const std::string& filepath, const DdsTextureInfo& info, const unsigned int topMip, std::vector<std::uint8_t>& data, std::string& error);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,52 @@
+#include "ResidencyTracker.h"
+
+#include <utils/Assert.h>
+
+namespace BRE {
+	size_t ResidencyTracker::Add() {
+		mStates.push_back(State::Registered);
+		return mStates.size() - 1U;
+	}
+
+	size_t ResidencyTracker::AddResident() {
+		mStates.push_back(State::Resident);
+		++mNumResident;
+		return mStates.size() - 1U;
+	}
+
+	void ResidencyTracker::Request(const size_t entry) {
+		BRE_ASSERT(entry < mStates.size());
+		if (mStates[entry] == State::Registered) {
+			mStates[entry] = State::Queued;
+			mQueue.push_back(entry);
+		}
+	}
+
+	void ResidencyTracker::Update(std::vector<size_t>& loads) {
+		loads.clear();
+		while (!mQueue.empty() && loads.size() < mMaxLoadsPerUpdate) {
+			const size_t entry = mQueue.front();
+			mQueue.pop_front();
+			BRE_ASSERT(mStates[entry] == State::Queued);
+			mStates[entry] = State::Loading;
+			loads.push_back(entry);
+		}
+	}
+
+	void ResidencyTracker::OnLoaded(const size_t entry, const bool succeeded) {
+		BRE_ASSERT(entry < mStates.size());
+		BRE_ASSERT(mStates[entry] == State::Loading);
+		if (succeeded) {
+			mStates[entry] = State::Resident;
+			++mNumResident;
+		}
+		else {
+			mStates[entry] = State::Failed;
+		}
+	}
+
+	ResidencyTracker::State ResidencyTracker::GetState(const size_t entry) const {
+		BRE_ASSERT(entry < mStates.size());
+		return mStates[entry];
+	}
+}
\ No newline at end of file
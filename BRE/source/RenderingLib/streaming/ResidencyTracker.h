@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <deque>
+#include <vector>
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Residency state of lazily loaded resources (materials).
+// Entries start as Registered (only their descriptor exists). The first
+// Request() queues them and Update() hands out queued entries in request
+// order, a few per frame, so loads are spread instead of stalling one frame.
+// Registered -> Queued -> Loading -> Resident (or Failed).
+// It does not depend on Direct3D nor does any IO.
+//
+//////////////////////////////////////////////////////////////////////////
+
+namespace BRE {
+	class ResidencyTracker {
+	public:
+		enum class State {
+			Registered,
+			Queued,
+			Loading,
+			Resident,
+			Failed,
+		};
+
+		explicit ResidencyTracker(const unsigned int maxLoadsPerUpdate)
+			: mMaxLoadsPerUpdate(maxLoadsPerUpdate)
+		{
+		}
+
+		const ResidencyTracker& operator=(const ResidencyTracker& rhs) = delete;
+
+		size_t Add();
+		// For entries loaded right away
+		size_t AddResident();
+
+		// Registered entries are queued. It does nothing otherwise.
+		void Request(const size_t entry);
+
+		// Queued entries to load this frame (they become Loading)
+		void Update(std::vector<size_t>& loads);
+
+		void OnLoaded(const size_t entry, const bool succeeded);
+
+		State GetState(const size_t entry) const;
+		bool IsResident(const size_t entry) const { return GetState(entry) == State::Resident; }
+		size_t NumEntries() const { return mStates.size(); }
+		size_t NumQueued() const { return mQueue.size(); }
+		size_t NumResident() const { return mNumResident; }
+
+	private:
+		std::vector<State> mStates;
+		std::deque<size_t> mQueue;
+		unsigned int mMaxLoadsPerUpdate;
+		size_t mNumResident = 0U;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,215 @@
+#include "TextureStreamingScheduler.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+#include <utils/Assert.h>
+
+namespace {
+	const size_t sNoRequester = static_cast<size_t>(-1);
+}
+
+namespace BRE {
+	unsigned int TextureStreamingScheduler::TopMipForScreenSize(const unsigned int width, const unsigned int height, const unsigned int numMips, const float screenPixels) {
+		BRE_ASSERT(numMips > 0U);
+		if (screenPixels <= 0.0f) {
+			return numMips - 1U;
+		}
+
+		// One texel per pixel
+		const float ratio = static_cast<float>(std::max(width, height)) / screenPixels;
+		if (ratio <= 1.0f) {
+			return 0U;
+		}
+		const unsigned int mip = static_cast<unsigned int>(std::floor(std::log2(ratio)));
+		return std::min(mip, numMips - 1U);
+	}
+
+	size_t TextureStreamingScheduler::AddTexture(const std::vector<size_t>& mipSizes, const unsigned int tailTopMip) {
+		BRE_ASSERT(!mipSizes.empty());
+		Texture texture;
+		texture.mMipSizes = mipSizes;
+		texture.mTailTopMip = std::min(tailTopMip, static_cast<unsigned int>(mipSizes.size()) - 1U);
+		texture.mResidentTopMip = texture.mTailTopMip;
+		texture.mPendingTopMip = texture.mTailTopMip;
+		texture.mRequestedTopMip = texture.mTailTopMip;
+		texture.mPriority = 0.0f;
+		texture.mLastUsedFrame = 0U;
+
+		const size_t bytes = Bytes(texture, texture.mTailTopMip);
+		mResidentBytes += bytes;
+		mCommittedBytes += bytes;
+		mTextures.push_back(texture);
+		return mTextures.size() - 1U;
+	}
+
+	void TextureStreamingScheduler::Request(const size_t texture, const unsigned int topMip, const float priority) {
+		BRE_ASSERT(texture < mTextures.size());
+		Texture& tex = mTextures[texture];
+		const unsigned int clampedTopMip = std::min(topMip, tex.mTailTopMip);
+		if (tex.mLastUsedFrame != mFrame) {
+			tex.mRequestedTopMip = clampedTopMip;
+			tex.mPriority = priority;
+			tex.mLastUsedFrame = mFrame;
+		}
+		else {
+			tex.mRequestedTopMip = std::min(tex.mRequestedTopMip, clampedTopMip);
+			tex.mPriority = std::max(tex.mPriority, priority);
+		}
+	}
+
+	void TextureStreamingScheduler::Update(std::vector<Decision>& decisions) {
+		decisions.clear();
+
+		// The budget may have been reduced
+		if (mCommittedBytes > mBudgetBytes) {
+			Evict(mCommittedBytes - mBudgetBytes, sNoRequester, FLT_MAX, decisions);
+		}
+
+		mCandidates.clear();
+		for (size_t i = 0U; i < mTextures.size(); ++i) {
+			const Texture& texture = mTextures[i];
+			if (texture.mLastUsedFrame == mFrame && texture.mRequestedTopMip < texture.mResidentTopMip && texture.mPendingTopMip == texture.mResidentTopMip) {
+				mCandidates.push_back(i);
+			}
+		}
+		std::sort(mCandidates.begin(), mCandidates.end(), [this](const size_t a, const size_t b) {
+			return mTextures[a].mPriority > mTextures[b].mPriority || (mTextures[a].mPriority == mTextures[b].mPriority && a < b);
+		});
+
+		for (const size_t index : mCandidates) {
+			if (mLoadsInFlight >= mMaxLoadsInFlight) {
+				break;
+			}
+
+			Texture& texture = mTextures[index];
+			const size_t residentBytes = Bytes(texture, texture.mResidentTopMip);
+			const size_t freeBytes = mBudgetBytes > mCommittedBytes ? mBudgetBytes - mCommittedBytes : 0U;
+			const size_t availableBytes = freeBytes + EvictableBytes(index, texture.mPriority);
+
+			// Less detail than requested is better than nothing
+			unsigned int topMip = texture.mRequestedTopMip;
+			while (topMip < texture.mResidentTopMip && Bytes(texture, topMip) - residentBytes > availableBytes) {
+				++topMip;
+			}
+			if (topMip == texture.mResidentTopMip) {
+				continue;
+			}
+
+			const size_t neededBytes = Bytes(texture, topMip) - residentBytes;
+			if (neededBytes > freeBytes) {
+				const size_t freedBytes = Evict(neededBytes - freeBytes, index, texture.mPriority, decisions);
+				BRE_ASSERT(freedBytes >= neededBytes - freeBytes);
+				(void)freedBytes;
+			}
+
+			texture.mPendingTopMip = topMip;
+			mCommittedBytes += neededBytes;
+			++mLoadsInFlight;
+			decisions.push_back(Decision{ index, topMip, true });
+		}
+
+		++mFrame;
+	}
+
+	void TextureStreamingScheduler::OnLoaded(const size_t texture, const bool succeeded) {
+		BRE_ASSERT(texture < mTextures.size());
+		Texture& tex = mTextures[texture];
+		BRE_ASSERT(tex.mPendingTopMip < tex.mResidentTopMip);
+		BRE_ASSERT(mLoadsInFlight > 0U);
+
+		const size_t bytes = Bytes(tex, tex.mPendingTopMip) - Bytes(tex, tex.mResidentTopMip);
+		if (succeeded) {
+			mResidentBytes += bytes;
+			tex.mResidentTopMip = tex.mPendingTopMip;
+		}
+		else {
+			mCommittedBytes -= bytes;
+			tex.mPendingTopMip = tex.mResidentTopMip;
+		}
+		--mLoadsInFlight;
+	}
+
+	unsigned int TextureStreamingScheduler::ResidentTopMip(const size_t texture) const {
+		BRE_ASSERT(texture < mTextures.size());
+		return mTextures[texture].mResidentTopMip;
+	}
+
+	bool TextureStreamingScheduler::IsLoading(const size_t texture) const {
+		BRE_ASSERT(texture < mTextures.size());
+		return mTextures[texture].mPendingTopMip != mTextures[texture].mResidentTopMip;
+	}
+
+	size_t TextureStreamingScheduler::Bytes(const Texture& texture, const unsigned int topMip) const {
+		size_t bytes = 0U;
+		for (size_t mip = topMip; mip < texture.mMipSizes.size(); ++mip) {
+			bytes += texture.mMipSizes[mip];
+		}
+		return bytes;
+	}
+
+	bool TextureStreamingScheduler::IsEvictable(const Texture& texture, const size_t index, const size_t requester, const float priority) const {
+		// Textures used this frame only give room to more important ones
+		return index != requester
+			&& texture.mPendingTopMip == texture.mResidentTopMip
+			&& texture.mResidentTopMip < texture.mTailTopMip
+			&& (texture.mLastUsedFrame < mFrame || texture.mPriority < priority);
+	}
+
+	size_t TextureStreamingScheduler::EvictableBytes(const size_t requester, const float priority) const {
+		size_t bytes = 0U;
+		for (size_t i = 0U; i < mTextures.size(); ++i) {
+			const Texture& texture = mTextures[i];
+			if (IsEvictable(texture, i, requester, priority)) {
+				bytes += Bytes(texture, texture.mResidentTopMip) - Bytes(texture, texture.mTailTopMip);
+			}
+		}
+		return bytes;
+	}
+
+	size_t TextureStreamingScheduler::Evict(const size_t bytes, const size_t requester, const float priority, std::vector<Decision>& decisions) {
+		mVictims.clear();
+		for (size_t i = 0U; i < mTextures.size(); ++i) {
+			if (IsEvictable(mTextures[i], i, requester, priority)) {
+				mVictims.push_back(i);
+			}
+		}
+
+		// Least recently used first, then least important
+		std::sort(mVictims.begin(), mVictims.end(), [this](const size_t a, const size_t b) {
+			const Texture& texA = mTextures[a];
+			const Texture& texB = mTextures[b];
+			if (texA.mLastUsedFrame != texB.mLastUsedFrame) {
+				return texA.mLastUsedFrame < texB.mLastUsedFrame;
+			}
+			if (texA.mPriority != texB.mPriority) {
+				return texA.mPriority < texB.mPriority;
+			}
+			return a < b;
+		});
+
+		// Drop one level at a time, so victims keep as much detail as possible
+		size_t freedBytes = 0U;
+		for (const size_t index : mVictims) {
+			if (freedBytes >= bytes) {
+				break;
+			}
+
+			Texture& texture = mTextures[index];
+			const unsigned int previousTopMip = texture.mResidentTopMip;
+			while (freedBytes < bytes && texture.mResidentTopMip < texture.mTailTopMip) {
+				freedBytes += texture.mMipSizes[texture.mResidentTopMip];
+				++texture.mResidentTopMip;
+			}
+			texture.mPendingTopMip = texture.mResidentTopMip;
+
+			const size_t evictedBytes = Bytes(texture, previousTopMip) - Bytes(texture, texture.mResidentTopMip);
+			mResidentBytes -= evictedBytes;
+			mCommittedBytes -= evictedBytes;
+			decisions.push_back(Decision{ index, texture.mResidentTopMip, false });
+		}
+
+		return freedBytes;
+	}
+}
\ No newline at end of file
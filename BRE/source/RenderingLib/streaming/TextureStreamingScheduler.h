@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Decides which mip levels of streamed textures are resident, within a
+// memory budget. Each frame, drawers request the top mip they need and a
+// priority (projected size). Update() then issues loads for the most
+// important requests and, when they do not fit, evicts levels of least
+// recently used textures (and of lower priority ones) to make room.
+// Levels from the tail mip down are always resident and never evicted.
+// Bytes of loads in flight are reserved, so the budget holds once they
+// finish. It does not depend on Direct3D nor does any IO.
+//
+//////////////////////////////////////////////////////////////////////////
+
+namespace BRE {
+	class TextureStreamingScheduler {
+	public:
+		struct Decision {
+			size_t mTexture;
+			unsigned int mTopMip;
+			// Load levels [mTopMip, resident top mip) or evict levels above mTopMip
+			bool mLoad;
+		};
+
+		TextureStreamingScheduler(const size_t budgetBytes, const unsigned int maxLoadsInFlight)
+			: mBudgetBytes(budgetBytes)
+			, mMaxLoadsInFlight(maxLoadsInFlight)
+		{
+		}
+
+		const TextureStreamingScheduler& operator=(const TextureStreamingScheduler& rhs) = delete;
+
+		// Top mip a texture needs to be displayed with screenPixels texels
+		// per repeat (along its largest dimension).
+		static unsigned int TopMipForScreenSize(const unsigned int width, const unsigned int height, const unsigned int numMips, const float screenPixels);
+
+		// mipSizes has the bytes of each level, top level first. Levels
+		// [tailTopMip, mipSizes.size()) are resident from now on.
+		size_t AddTexture(const std::vector<size_t>& mipSizes, const unsigned int tailTopMip);
+
+		// Several requests in the same frame keep the highest detail and priority
+		void Request(const size_t texture, const unsigned int topMip, const float priority);
+
+		// Consumes this frame requests and advances to the next frame.
+		// Evictions are effective immediately, loads after OnLoaded().
+		void Update(std::vector<Decision>& decisions);
+
+		// A load decision finished
+		void OnLoaded(const size_t texture, const bool succeeded);
+
+		unsigned int ResidentTopMip(const size_t texture) const;
+		bool IsLoading(const size_t texture) const;
+		size_t NumTextures() const { return mTextures.size(); }
+
+		// Bytes of resident levels
+		size_t ResidentBytes() const { return mResidentBytes; }
+		// Bytes of resident levels and loads in flight
+		size_t CommittedBytes() const { return mCommittedBytes; }
+		size_t BudgetBytes() const { return mBudgetBytes; }
+		void SetBudgetBytes(const size_t budgetBytes) { mBudgetBytes = budgetBytes; }
+		unsigned int LoadsInFlight() const { return mLoadsInFlight; }
+		std::uint64_t Frame() const { return mFrame; }
+
+	private:
+		struct Texture {
+			std::vector<size_t> mMipSizes;
+			unsigned int mTailTopMip;
+			unsigned int mResidentTopMip;
+			// Equal to mResidentTopMip when no load is in flight
+			unsigned int mPendingTopMip;
+			unsigned int mRequestedTopMip;
+			float mPriority;
+			// Frame of the last request. Textures start as never used.
+			std::uint64_t mLastUsedFrame;
+		};
+
+		size_t Bytes(const Texture& texture, const unsigned int topMip) const;
+		bool IsEvictable(const Texture& texture, const size_t index, const size_t requester, const float priority) const;
+		// Evicts levels of other textures until bytes are freed. Returns freed bytes.
+		size_t Evict(const size_t bytes, const size_t requester, const float priority, std::vector<Decision>& decisions);
+		size_t EvictableBytes(const size_t requester, const float priority) const;
+
+		std::vector<Texture> mTextures;
+		size_t mBudgetBytes;
+		size_t mResidentBytes = 0U;
+		size_t mCommittedBytes = 0U;
+		unsigned int mMaxLoadsInFlight;
+		unsigned int mLoadsInFlight = 0U;
+		// Starts at 1, so 0 means never used
+		std::uint64_t mFrame = 1U;
+
+		// Scratch buffers reused between updates
+		std::vector<size_t> mCandidates;
+		std::vector<size_t> mVictims;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,250 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Map from ids (path hashes) to values, for the "load once, return
+// existing" registries of managers. Entries are never removed while the
+// registry exists.
+// Reads are lock free: each shard publishes an open addressing table of
+// entry pointers, and writers (serialized by the shard mutex) fill empty
+// slots or publish a table twice as large. Replaced tables are kept until
+// destruction, so a reader can always finish its probe in the table it
+// loaded, and entries never move.
+// GetOrCreate() coalesces concurrent requests of the same id: one thread
+// creates the value (outside the lock), the others wait for it. If create
+// throws, the entry is marked failed and the exception is rethrown, and
+// the next request of that id (a waiting one included) creates it again.
+// create must not request its own id (it would wait forever).
+//
+//////////////////////////////////////////////////////////////////////////
+
+namespace BRE {
+	template<typename T>
+	class ConcurrentRegistry {
+	public:
+		explicit ConcurrentRegistry(const size_t initialShardCapacity = 16U) {
+			size_t capacity = 4U;
+			while (capacity < initialShardCapacity) {
+				capacity *= 2U;
+			}
+			for (Shard& shard : mShards) {
+				shard.mTables.emplace_back(new Table(capacity));
+				shard.mTable.store(shard.mTables.back().get(), std::memory_order_release);
+			}
+		}
+
+		ConcurrentRegistry(const ConcurrentRegistry&) = delete;
+		const ConcurrentRegistry& operator=(const ConcurrentRegistry&) = delete;
+
+		// Lock free. Returns false if there is no entry or its value is still being created.
+		bool Find(const size_t id, T& value) const {
+			const Entry* entry = FindEntry(ShardOf(id), id);
+			if (entry == nullptr || entry->mState.load(std::memory_order_acquire) != State::Ready) {
+				return false;
+			}
+			value = entry->mValue;
+			return true;
+		}
+
+		// Returns false if there is an entry with that id already
+		bool Insert(const size_t id, const T& value) {
+			Shard& shard = ShardOf(id);
+			Entry* entry;
+			{
+				std::lock_guard<std::mutex> lock(shard.mMutex);
+				entry = FindEntry(shard, id);
+				if (entry == nullptr) {
+					entry = AddEntry(shard, id);
+				}
+				else if (entry->mState.load(std::memory_order_relaxed) != State::Failed) {
+					return false;
+				}
+				entry->mValue = value;
+				entry->mState.store(State::Ready, std::memory_order_release);
+			}
+			// Requests may be waiting to create it again
+			shard.mCondition.notify_all();
+			return true;
+		}
+
+		// Value of the entry with that id. If there is none, it is created with
+		// create() (a functor that returns T) and created is set to true.
+		template<typename Create>
+		T GetOrCreate(const size_t id, Create&& create, bool* created = nullptr) {
+			if (created) *created = false;
+			Shard& shard = ShardOf(id);
+			const Entry* existing = FindEntry(shard, id);
+			if (existing != nullptr && existing->mState.load(std::memory_order_acquire) == State::Ready) {
+				return existing->mValue;
+			}
+
+			Entry* entry;
+			{
+				std::unique_lock<std::mutex> lock(shard.mMutex);
+				entry = FindEntry(shard, id);
+				if (entry == nullptr) {
+					entry = AddEntry(shard, id);
+				}
+				else {
+					shard.mCondition.wait(lock, [entry]() { return entry->mState.load(std::memory_order_relaxed) != State::Creating; });
+					if (entry->mState.load(std::memory_order_relaxed) == State::Ready) {
+						return entry->mValue;
+					}
+					// The last creation failed, this request creates it again
+					entry->mState.store(State::Creating, std::memory_order_relaxed);
+				}
+			}
+
+			try {
+				const T value = create();
+				{
+					std::lock_guard<std::mutex> lock(shard.mMutex);
+					entry->mValue = value;
+					entry->mState.store(State::Ready, std::memory_order_release);
+				}
+				shard.mCondition.notify_all();
+				if (created) *created = true;
+				return value;
+			}
+			catch (...) {
+				{
+					std::lock_guard<std::mutex> lock(shard.mMutex);
+					entry->mState.store(State::Failed, std::memory_order_relaxed);
+				}
+				shard.mCondition.notify_all();
+				throw;
+			}
+		}
+
+		// function(id, value) for every created value. It must not run with writes.
+		template<typename Function>
+		void ForEach(Function&& function) const {
+			for (const Shard& shard : mShards) {
+				for (const std::unique_ptr<Entry>& entry : shard.mEntries) {
+					if (entry->mState.load(std::memory_order_acquire) == State::Ready) {
+						function(entry->mId, entry->mValue);
+					}
+				}
+			}
+		}
+
+		// Entries created or being created (failed ones are not counted)
+		size_t Size() const {
+			size_t size = 0U;
+			for (const Shard& shard : mShards) {
+				std::lock_guard<std::mutex> lock(shard.mMutex);
+				for (const std::unique_ptr<Entry>& entry : shard.mEntries) {
+					if (entry->mState.load(std::memory_order_relaxed) != State::Failed) {
+						++size;
+					}
+				}
+			}
+			return size;
+		}
+
+	private:
+		static const size_t sNumShards = 16U;
+
+		enum class State : std::uint8_t {
+			Creating,
+			Ready,
+			// create() threw. Entries are never removed, the next request reuses it.
+			Failed,
+		};
+
+		struct Entry {
+			explicit Entry(const size_t id)
+				: mId(id)
+				, mValue()
+				, mState(State::Creating)
+			{
+			}
+
+			const size_t mId;
+			T mValue;
+			// Written with the shard mutex locked
+			std::atomic<State> mState;
+		};
+
+		struct Table {
+			explicit Table(const size_t capacity)
+				: mMask(capacity - 1U)
+				, mSlots(new std::atomic<Entry*>[capacity])
+			{
+				for (size_t i = 0U; i < capacity; ++i) {
+					mSlots[i].store(nullptr, std::memory_order_relaxed);
+				}
+			}
+
+			const size_t mMask;
+			std::unique_ptr<std::atomic<Entry*>[]> mSlots;
+		};
+
+		struct Shard {
+			// Current table (readers). Tables are at most half full.
+			std::atomic<Table*> mTable;
+			// Writers only
+			mutable std::mutex mMutex;
+			std::condition_variable mCondition;
+			std::vector<std::unique_ptr<Table>> mTables;
+			std::vector<std::unique_ptr<Entry>> mEntries;
+		};
+
+		// Path hashes are poorly distributed in their low bits
+		static std::uint64_t Mix(const size_t id) {
+			std::uint64_t value = static_cast<std::uint64_t>(id);
+			value ^= value >> 33U;
+			value *= 0xFF51AFD7ED558CCDULL;
+			value ^= value >> 33U;
+			return value;
+		}
+
+		Shard& ShardOf(const size_t id) { return mShards[Mix(id) % sNumShards]; }
+		const Shard& ShardOf(const size_t id) const { return mShards[Mix(id) % sNumShards]; }
+
+		static Entry* FindEntry(const Shard& shard, const size_t id) {
+			const Table* table = shard.mTable.load(std::memory_order_acquire);
+			for (size_t slot = static_cast<size_t>(Mix(id) / sNumShards) & table->mMask;; slot = (slot + 1U) & table->mMask) {
+				Entry* entry = table->mSlots[slot].load(std::memory_order_acquire);
+				if (entry == nullptr || entry->mId == id) {
+					return entry;
+				}
+			}
+		}
+
+		static void Place(Table& table, Entry* entry) {
+			size_t slot = static_cast<size_t>(Mix(entry->mId) / sNumShards) & table.mMask;
+			while (table.mSlots[slot].load(std::memory_order_relaxed) != nullptr) {
+				slot = (slot + 1U) & table.mMask;
+			}
+			table.mSlots[slot].store(entry, std::memory_order_release);
+		}
+
+		// The shard mutex must be locked
+		static Entry* AddEntry(Shard& shard, const size_t id) {
+			Table* table = shard.mTable.load(std::memory_order_relaxed);
+			if ((shard.mEntries.size() + 1U) * 2U > table->mMask + 1U) {
+				Table* grownTable = new Table((table->mMask + 1U) * 2U);
+				shard.mTables.emplace_back(grownTable);
+				for (const std::unique_ptr<Entry>& entry : shard.mEntries) {
+					Place(*grownTable, entry.get());
+				}
+				shard.mTable.store(grownTable, std::memory_order_release);
+				table = grownTable;
+			}
+			shard.mEntries.emplace_back(new Entry(id));
+			Entry* entry = shard.mEntries.back().get();
+			Place(*table, entry);
+			return entry;
+		}
+
+		Shard mShards[sNumShards];
+	};
+}
\ No newline at end of file
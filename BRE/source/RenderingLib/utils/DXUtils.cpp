@@ -2,6 +2,7 @@
 
 #include <ScreenGrab.h>
 
+#include <general/RenderCounters.h>
 #include <managers/ShaderResourcesManager.h>
 #include <utils/Assert.h>
 
@@ -16,6 +17,7 @@ namespace BRE {
 			context->Map(&buffer, 0, mapType, 0, &mappedResource);
 			CopyMemory(mappedResource.pData, data, sizeData);
 			context->Unmap(&buffer, 0);
+			BRE_COUNTER_ADD(RenderCounter::UploadBytes, sizeData);
 		}
 
 		void SaveTextureToFile(ID3D11DeviceContext1& device, ID3D11Texture2D* texture, const wchar_t* destFilename) {
@@ -0,0 +1,144 @@
+#include "ImpostorLayout.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include <utils/Assert.h>
+
+using namespace DirectX;
+
+namespace {
+	// Directions closer than this to the Y axis use the Z axis as up vector
+	const float sVerticalThreshold = 0.999f;
+
+	float SignNotZero(const float value) {
+		return value >= 0.0f ? 1.0f : -1.0f;
+	}
+
+	XMFLOAT3 Normalize(const XMFLOAT3& v) {
+		const float length = std::sqrt(v.x * v.x + v.y * v.y + v.z * v.z);
+		BRE_ASSERT(length > 0.0f);
+		return XMFLOAT3(v.x / length, v.y / length, v.z / length);
+	}
+
+	XMFLOAT3 Cross(const XMFLOAT3& a, const XMFLOAT3& b) {
+		return XMFLOAT3(a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x);
+	}
+}
+
+namespace BRE {
+	namespace ImpostorLayout {
+		XMFLOAT2 OctahedralEncode(const XMFLOAT3& direction) {
+			const float l1Norm = std::abs(direction.x) + std::abs(direction.y) + std::abs(direction.z);
+			BRE_ASSERT(l1Norm > 0.0f);
+			float x = direction.x / l1Norm;
+			float y = direction.y / l1Norm;
+			if (direction.z < 0.0f) {
+				// Lower hemisphere is folded over the diagonals
+				const float wrappedX = (1.0f - std::abs(y)) * SignNotZero(x);
+				y = (1.0f - std::abs(x)) * SignNotZero(y);
+				x = wrappedX;
+			}
+			return XMFLOAT2(x * 0.5f + 0.5f, y * 0.5f + 0.5f);
+		}
+
+		XMFLOAT3 OctahedralDecode(const XMFLOAT2& encoded) {
+			float x = encoded.x * 2.0f - 1.0f;
+			float y = encoded.y * 2.0f - 1.0f;
+			const float z = 1.0f - std::abs(x) - std::abs(y);
+			if (z < 0.0f) {
+				const float wrappedX = (1.0f - std::abs(y)) * SignNotZero(x);
+				y = (1.0f - std::abs(x)) * SignNotZero(y);
+				x = wrappedX;
+			}
+			return Normalize(XMFLOAT3(x, y, z));
+		}
+
+		XMFLOAT3 FrameDirection(const unsigned int x, const unsigned int y, const unsigned int framesPerSide) {
+			BRE_ASSERT(framesPerSide > 1U);
+			BRE_ASSERT(x < framesPerSide && y < framesPerSide);
+			const float maxFrame = static_cast<float>(framesPerSide - 1U);
+			return OctahedralDecode(XMFLOAT2(x / maxFrame, y / maxFrame));
+		}
+
+		void NearestFrame(const XMFLOAT3& direction, const unsigned int framesPerSide, unsigned int& x, unsigned int& y) {
+			BRE_ASSERT(framesPerSide > 1U);
+			const XMFLOAT3 normalizedDirection = Normalize(direction);
+			const XMFLOAT2 encoded = OctahedralEncode(normalizedDirection);
+			const float maxFrame = static_cast<float>(framesPerSide - 1U);
+			const unsigned int x0 = (std::min)(static_cast<unsigned int>(encoded.x * maxFrame), framesPerSide - 2U);
+			const unsigned int y0 = (std::min)(static_cast<unsigned int>(encoded.y * maxFrame), framesPerSide - 2U);
+			// The mapping is not uniform, so the nearest frame is the one
+			// of the enclosing grid cell whose direction is the closest
+			float maxCosine = -2.0f;
+			for (unsigned int cellY = y0; cellY <= y0 + 1U; ++cellY) {
+				for (unsigned int cellX = x0; cellX <= x0 + 1U; ++cellX) {
+					const XMFLOAT3 frameDirection = FrameDirection(cellX, cellY, framesPerSide);
+					const float cosine = frameDirection.x * normalizedDirection.x + frameDirection.y * normalizedDirection.y + frameDirection.z * normalizedDirection.z;
+					if (cosine > maxCosine) {
+						maxCosine = cosine;
+						x = cellX;
+						y = cellY;
+					}
+				}
+			}
+		}
+
+		FrameBasis ComputeFrameBasis(const XMFLOAT3& direction) {
+			FrameBasis basis;
+			const XMFLOAT3 normalizedDirection = Normalize(direction);
+			basis.mForward = XMFLOAT3(-normalizedDirection.x, -normalizedDirection.y, -normalizedDirection.z);
+			const XMFLOAT3 up = std::abs(normalizedDirection.y) > sVerticalThreshold ? XMFLOAT3(0.0f, 0.0f, 1.0f) : XMFLOAT3(0.0f, 1.0f, 0.0f);
+			basis.mRight = Normalize(Cross(up, basis.mForward));
+			basis.mUp = Cross(basis.mForward, basis.mRight);
+			return basis;
+		}
+
+		AtlasPacker::AtlasPacker(const unsigned int pageSize, const unsigned int maxPages)
+			: mPageSize(pageSize)
+			, mMaxPages(maxPages)
+		{
+			BRE_ASSERT(pageSize > 0U);
+			BRE_ASSERT(maxPages > 0U);
+		}
+
+		bool AtlasPacker::Allocate(const unsigned int size, Rect& rect) {
+			BRE_ASSERT(size > 0U);
+			if (size > mPageSize) {
+				return false;
+			}
+
+			// Lowest shelf with room for it
+			Shelf* bestShelf = nullptr;
+			for (Shelf& shelf : mShelves) {
+				if (shelf.mHeight >= size && mPageSize - shelf.mWidth >= size && (!bestShelf || shelf.mHeight < bestShelf->mHeight)) {
+					bestShelf = &shelf;
+				}
+			}
+
+			if (!bestShelf) {
+				unsigned int page = 0U;
+				while (page < mPageHeights.size() && mPageSize - mPageHeights[page] < size) {
+					++page;
+				}
+				if (page == mPageHeights.size()) {
+					if (mPageHeights.size() == mMaxPages) {
+						return false;
+					}
+					mPageHeights.push_back(0U);
+				}
+				const Shelf shelf = { page, mPageHeights[page], size, 0U };
+				mPageHeights[page] += size;
+				mShelves.push_back(shelf);
+				bestShelf = &mShelves.back();
+			}
+
+			rect.mX = bestShelf->mWidth;
+			rect.mY = bestShelf->mY;
+			rect.mSize = size;
+			rect.mPage = bestShelf->mPage;
+			bestShelf->mWidth += size;
+			return true;
+		}
+	}
+}
\ No newline at end of file
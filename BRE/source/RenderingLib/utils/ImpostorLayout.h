@@ -0,0 +1,74 @@
+#pragma once
+
+#include <DirectXMath.h>
+#include <vector>
+
+//////////////////////////////////////////////////////////////////////////
+//
+// View selection and atlas packing of impostors. The atlas of a model
+// is a grid of framesPerSide x framesPerSide frames. Frame (x, y) shows
+// the model from the direction whose octahedral encoding (the same as
+// OctEncode() of Utils.hlsli) is (x, y) / (framesPerSide - 1), through an
+// orthographic projection that fits its bounding sphere. Model atlases
+// are square and are packed in shelves of pages (slices of the atlas
+// texture arrays).
+// It does not depend on Direct3D.
+//
+//////////////////////////////////////////////////////////////////////////
+
+namespace BRE {
+	namespace ImpostorLayout {
+		// Unit direction to [0, 1] x [0, 1] and back
+		DirectX::XMFLOAT2 OctahedralEncode(const DirectX::XMFLOAT3& direction);
+		DirectX::XMFLOAT3 OctahedralDecode(const DirectX::XMFLOAT2& encoded);
+
+		// Unit direction from the model center to the viewer of frame (x, y)
+		DirectX::XMFLOAT3 FrameDirection(const unsigned int x, const unsigned int y, const unsigned int framesPerSide);
+		// Frame whose direction is the nearest one to direction (it does not need to be normalized)
+		void NearestFrame(const DirectX::XMFLOAT3& direction, const unsigned int framesPerSide, unsigned int& x, unsigned int& y);
+
+		// Axes of the frame camera, as XMMatrixLookToLH() computes them for
+		// forward = -direction. Up is the Y axis unless direction is (almost) vertical.
+		struct FrameBasis {
+			DirectX::XMFLOAT3 mRight;
+			DirectX::XMFLOAT3 mUp;
+			DirectX::XMFLOAT3 mForward;
+		};
+		FrameBasis ComputeFrameBasis(const DirectX::XMFLOAT3& direction);
+
+		class AtlasPacker {
+		public:
+			struct Rect {
+				unsigned int mX;
+				unsigned int mY;
+				unsigned int mSize;
+				unsigned int mPage;
+			};
+
+			AtlasPacker(const unsigned int pageSize, const unsigned int maxPages);
+
+			const AtlasPacker& operator=(const AtlasPacker& rhs) = delete;
+
+			// Returns false if size is larger than the page size or there
+			// is no room for it in maxPages pages
+			bool Allocate(const unsigned int size, Rect& rect);
+
+			unsigned int PageSize() const { return mPageSize; }
+			unsigned int NumPages() const { return static_cast<unsigned int>(mPageHeights.size()); }
+
+		private:
+			struct Shelf {
+				unsigned int mPage;
+				unsigned int mY;
+				unsigned int mHeight;
+				unsigned int mWidth;
+			};
+
+			std::vector<Shelf> mShelves;
+			// Height used by the shelves of each page
+			std::vector<unsigned int> mPageHeights;
+			unsigned int mPageSize;
+			unsigned int mMaxPages;
+		};
+	}
+}
\ No newline at end of file
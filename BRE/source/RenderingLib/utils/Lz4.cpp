@@ -0,0 +1,189 @@
+#include "Lz4.h"
+
+#include <cstring>
+#include <vector>
+
+#include <utils/Assert.h>
+
+namespace {
+	const size_t sMinMatch = 4U;
+	// The last match starts at least sMatchFindLimit bytes before the end
+	// and the last sLastLiterals bytes are always literals (format rules)
+	const size_t sMatchFindLimit = 12U;
+	const size_t sLastLiterals = 5U;
+	const size_t sMaxOffset = 65535U;
+	const unsigned int sHashLog = 16U;
+
+	std::uint32_t Read32(const std::uint8_t* src) {
+		std::uint32_t value;
+		memcpy(&value, src, sizeof(value));
+		return value;
+	}
+
+	std::uint32_t HashSequence(const std::uint32_t sequence) {
+		return (sequence * 2654435761U) >> (32U - sHashLog);
+	}
+
+	// Lengths of 15 or more continue in bytes of 255 plus a last smaller one
+	size_t LengthBytes(const size_t length) {
+		return length < 15U ? 0U : (length - 15U) / 255U + 1U;
+	}
+
+	std::uint8_t* WriteLength(size_t length, std::uint8_t* dst) {
+		if (length < 15U) {
+			return dst;
+		}
+		length -= 15U;
+		while (length >= 255U) {
+			*dst++ = 255U;
+			length -= 255U;
+		}
+		*dst++ = static_cast<std::uint8_t>(length);
+		return dst;
+	}
+
+	bool ReadLength(const std::uint8_t* src, const size_t srcSize, size_t& index, size_t& length) {
+		std::uint8_t value;
+		do {
+			if (index >= srcSize) {
+				return false;
+			}
+			value = src[index++];
+			length += value;
+		} while (value == 255U);
+		return true;
+	}
+}
+
+namespace BRE {
+	namespace Lz4 {
+		size_t CompressBound(const size_t srcSize) {
+			return srcSize + srcSize / 255U + 16U;
+		}
+
+		size_t Compress(const std::uint8_t* src, const size_t srcSize, std::uint8_t* dst, const size_t dstCapacity) {
+			BRE_ASSERT(src || srcSize == 0U);
+			BRE_ASSERT(dst);
+			std::uint8_t* out = dst;
+			const std::uint8_t* const outEnd = dst + dstCapacity;
+
+			// Literals from anchor to literalEnd, then a match (matchLength 0 for the last sequence)
+			auto writeSequence = [&](const size_t anchor, const size_t literalEnd, const size_t offset, const size_t matchLength) {
+				const size_t literalLength = literalEnd - anchor;
+				const size_t sequenceBytes = 1U + LengthBytes(literalLength) + literalLength + (matchLength > 0U ? 2U + LengthBytes(matchLength - sMinMatch) : 0U);
+				if (static_cast<size_t>(outEnd - out) < sequenceBytes) {
+					return false;
+				}
+				std::uint8_t* token = out++;
+				*token = static_cast<std::uint8_t>((literalLength < 15U ? literalLength : 15U) << 4U);
+				out = WriteLength(literalLength, out);
+				if (literalLength > 0U) {
+					memcpy(out, src + anchor, literalLength);
+					out += literalLength;
+				}
+				if (matchLength > 0U) {
+					*out++ = static_cast<std::uint8_t>(offset & 0xFFU);
+					*out++ = static_cast<std::uint8_t>(offset >> 8U);
+					const size_t length = matchLength - sMinMatch;
+					*token |= static_cast<std::uint8_t>(length < 15U ? length : 15U);
+					out = WriteLength(length, out);
+				}
+				return true;
+			};
+
+			size_t anchor = 0U;
+			if (srcSize > sMatchFindLimit) {
+				std::vector<std::uint32_t> table(static_cast<size_t>(1U) << sHashLog, 0U);
+				const size_t matchFindLimit = srcSize - sMatchFindLimit;
+				const size_t matchEndLimit = srcSize - sLastLiterals;
+				size_t index = 0U;
+				while (index < matchFindLimit) {
+					const std::uint32_t sequence = Read32(src + index);
+					std::uint32_t& entry = table[HashSequence(sequence)];
+					size_t candidate = entry;
+					entry = static_cast<std::uint32_t>(index);
+					if (candidate >= index || index - candidate > sMaxOffset || Read32(src + candidate) != sequence) {
+						++index;
+						continue;
+					}
+
+					while (index > anchor && candidate > 0U && src[index - 1U] == src[candidate - 1U]) {
+						--index;
+						--candidate;
+					}
+					size_t matchLength = sMinMatch;
+					while (index + matchLength < matchEndLimit && src[candidate + matchLength] == src[index + matchLength]) {
+						++matchLength;
+					}
+					if (!writeSequence(anchor, index, index - candidate, matchLength)) {
+						return 0U;
+					}
+					index += matchLength;
+					anchor = index;
+					if (index - 2U < matchFindLimit) {
+						table[HashSequence(Read32(src + index - 2U))] = static_cast<std::uint32_t>(index - 2U);
+					}
+				}
+			}
+			if (!writeSequence(anchor, srcSize, 0U, 0U)) {
+				return 0U;
+			}
+			return static_cast<size_t>(out - dst);
+		}
+
+		bool Decompress(const std::uint8_t* src, const size_t srcSize, std::uint8_t* dst, const size_t dstSize) {
+			BRE_ASSERT(src || srcSize == 0U);
+			BRE_ASSERT(dst || dstSize == 0U);
+			size_t in = 0U;
+			size_t out = 0U;
+			while (in < srcSize) {
+				const std::uint8_t token = src[in++];
+				size_t literalLength = token >> 4U;
+				if (literalLength == 15U && !ReadLength(src, srcSize, in, literalLength)) {
+					return false;
+				}
+				if (literalLength > srcSize - in || literalLength > dstSize - out) {
+					return false;
+				}
+				if (literalLength > 0U) {
+					memcpy(dst + out, src + in, literalLength);
+					in += literalLength;
+					out += literalLength;
+				}
+				// The last sequence has no match
+				if (in == srcSize) {
+					break;
+				}
+
+				if (srcSize - in < 2U) {
+					return false;
+				}
+				const size_t offset = static_cast<size_t>(src[in]) | (static_cast<size_t>(src[in + 1U]) << 8U);
+				in += 2U;
+				if (offset == 0U || offset > out) {
+					return false;
+				}
+				size_t matchLength = token & 15U;
+				if (matchLength == 15U && !ReadLength(src, srcSize, in, matchLength)) {
+					return false;
+				}
+				matchLength += sMinMatch;
+				if (matchLength > dstSize - out) {
+					return false;
+				}
+				const std::uint8_t* match = dst + out - offset;
+				if (offset >= matchLength) {
+					memcpy(dst + out, match, matchLength);
+				}
+				else {
+					// Overlapping copy repeats the last offset bytes
+					for (size_t i = 0U; i < matchLength; ++i) {
+						dst[out + i] = match[i];
+					}
+				}
+				out += matchLength;
+			}
+			return out == dstSize;
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+//////////////////////////////////////////////////////////////////////////
+//
+// LZ4 block format codec (no frame format, no dictionary).
+// The compressor is a greedy single pass matcher with a 64K entries hash
+// table. It favours decoding speed over ratio, which is what content
+// packs need: entries are compressed once offline and decoded at load.
+// The decoder checks every length and offset, so corrupted blocks fail
+// instead of reading or writing out of bounds.
+// It does not depend on Direct3D, so offline tools use it too.
+//
+//////////////////////////////////////////////////////////////////////////
+
+namespace BRE {
+	namespace Lz4 {
+		// Largest compressed size of srcSize bytes
+		size_t CompressBound(const size_t srcSize);
+
+		// Returns the compressed size, or 0 if dstCapacity is not enough
+		size_t Compress(const std::uint8_t* src, const size_t srcSize, std::uint8_t* dst, const size_t dstCapacity);
+
+		// dstSize must be the exact decompressed size.
+		// Returns false if the block is corrupted.
+		bool Decompress(const std::uint8_t* src, const size_t srcSize, std::uint8_t* dst, const size_t dstSize);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,91 @@
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace BRE {
+	MappedFile::~MappedFile() {
+		Close();
+	}
+
+#ifdef _WIN32
+	bool MappedFile::Open(const std::string& filepath) {
+		Close();
+		HANDLE file = CreateFileA(filepath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (file == INVALID_HANDLE_VALUE) {
+			return false;
+		}
+		LARGE_INTEGER size;
+		if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+			CloseHandle(file);
+			return false;
+		}
+		HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (!mapping) {
+			CloseHandle(file);
+			return false;
+		}
+		const void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+		if (!data) {
+			CloseHandle(mapping);
+			CloseHandle(file);
+			return false;
+		}
+		mFile = file;
+		mMapping = mapping;
+		mData = static_cast<const std::uint8_t*>(data);
+		mSize = static_cast<size_t>(size.QuadPart);
+		return true;
+	}
+
+	void MappedFile::Close() {
+		if (!mData) {
+			return;
+		}
+		UnmapViewOfFile(mData);
+		CloseHandle(mMapping);
+		CloseHandle(mFile);
+		mData = nullptr;
+		mSize = 0U;
+		mMapping = nullptr;
+		mFile = nullptr;
+	}
+#else
+	bool MappedFile::Open(const std::string& filepath) {
+		Close();
+		const int file = open(filepath.c_str(), O_RDONLY);
+		if (file < 0) {
+			return false;
+		}
+		struct stat status;
+		if (fstat(file, &status) != 0 || status.st_size == 0) {
+			close(file);
+			return false;
+		}
+		void* data = mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+		// The mapping keeps the file referenced
+		close(file);
+		if (data == MAP_FAILED) {
+			return false;
+		}
+		mData = static_cast<const std::uint8_t*>(data);
+		mSize = static_cast<size_t>(status.st_size);
+		return true;
+	}
+
+	void MappedFile::Close() {
+		if (!mData) {
+			return;
+		}
+		munmap(const_cast<std::uint8_t*>(mData), mSize);
+		mData = nullptr;
+		mSize = 0U;
+	}
+#endif
+}
\ No newline at end of file
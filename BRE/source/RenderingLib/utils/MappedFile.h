@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Read only memory mapping of a whole file.
+// Pages are loaded by the OS on first access, so opening a large file
+// costs a single open and no reads. The mapping is released on Close()
+// or destruction. Windows and POSIX systems are supported.
+//
+//////////////////////////////////////////////////////////////////////////
+
+namespace BRE {
+	class MappedFile {
+	public:
+		MappedFile() = default;
+		~MappedFile();
+
+		MappedFile(const MappedFile&) = delete;
+		const MappedFile& operator=(const MappedFile& rhs) = delete;
+
+		// Empty files cannot be mapped. It returns false on failure.
+		bool Open(const std::string& filepath);
+		void Close();
+
+		bool IsOpen() const { return mData != nullptr; }
+		const std::uint8_t* Data() const { return mData; }
+		size_t Size() const { return mSize; }
+
+	private:
+		const std::uint8_t* mData = nullptr;
+		size_t mSize = 0U;
+#ifdef _WIN32
+		void* mFile = nullptr;
+		void* mMapping = nullptr;
+#endif
+	};
+}
\ No newline at end of file
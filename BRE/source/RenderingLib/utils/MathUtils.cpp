@@ -1,5 +1,7 @@
 #include "MathUtils.h"
 
+#include <algorithm>
+#include <cmath>
 #include <Windows.h>
 
 #include <rendering/models/Mesh.h>
@@ -77,5 +79,47 @@ namespace BRE {
 			}
 			delete[] tan1;
 		}
+
+		XMFLOAT4 BoundingSphere(const std::vector<XMFLOAT3>& vertices, const XMMATRIX& world) {
+			BRE_ASSERT(!vertices.empty());
+			XMVECTOR minVertex = XMLoadFloat3(&vertices[0]);
+			XMVECTOR maxVertex = minVertex;
+			for (const XMFLOAT3& vertex : vertices) {
+				minVertex = XMVectorMin(minVertex, XMLoadFloat3(&vertex));
+				maxVertex = XMVectorMax(maxVertex, XMLoadFloat3(&vertex));
+			}
+			const XMVECTOR center = XMVectorScale(XMVectorAdd(minVertex, maxVertex), 0.5f);
+			XMVECTOR radius = XMVectorZero();
+			for (const XMFLOAT3& vertex : vertices) {
+				radius = XMVectorMax(radius, XMVector3Length(XMVectorSubtract(XMLoadFloat3(&vertex), center)));
+			}
+
+			XMFLOAT4 sphere;
+			XMStoreFloat4(&sphere, center);
+			sphere.w = XMVectorGetX(radius);
+			return TransformBoundingSphere(sphere, world);
+		}
+
+		XMFLOAT4 TransformBoundingSphere(const XMFLOAT4& sphere, const XMMATRIX& world) {
+			// Largest axis scaling keeps the sphere enclosing
+			const float scaling = std::sqrt((std::max)(XMVectorGetX(XMVector3LengthSq(world.r[0])), (std::max)(XMVectorGetX(XMVector3LengthSq(world.r[1])), XMVectorGetX(XMVector3LengthSq(world.r[2])))));
+			XMFLOAT4 transformed;
+			XMStoreFloat4(&transformed, XMVector3Transform(XMVectorSet(sphere.x, sphere.y, sphere.z, 1.0f), world));
+			transformed.w = sphere.w * scaling;
+			return transformed;
+		}
+
+		float ProjectedScreenFraction(const XMFLOAT4& sphere, const XMMATRIX& view, const XMMATRIX& proj) {
+			const XMVECTOR center = XMVector3Transform(XMVectorSet(sphere.x, sphere.y, sphere.z, 1.0f), view);
+			const float depth = XMVectorGetZ(center);
+			if (depth <= -sphere.w) {
+				return 0.0f;
+			}
+			if (depth <= sphere.w) {
+				return 1.0f;
+			}
+			// Projected diameter (2 * radius * proj._22 / depth) over the NDC height (2)
+			return (std::min)(1.0f, sphere.w * XMVectorGetY(proj.r[1]) / depth);
+		}
 	}
 }
\ No newline at end of file
@@ -9,5 +9,13 @@ namespace BRE {
 	namespace Utils {
 		float RandomFloat(const float min, const float max);
 		void CalculateTangentArray(Mesh& mesh, std::vector<DirectX::XMFLOAT3>& tangents);
+
+		// Sphere (center in xyz, radius in w) enclosing vertices, transformed by world
+		DirectX::XMFLOAT4 BoundingSphere(const std::vector<DirectX::XMFLOAT3>& vertices, const DirectX::XMMATRIX& world);
+		// Sphere enclosing the sphere transformed by world
+		DirectX::XMFLOAT4 TransformBoundingSphere(const DirectX::XMFLOAT4& sphere, const DirectX::XMMATRIX& world);
+
+		// Fraction of the screen height covered by the sphere (1 if the camera is inside it, 0 if it is behind the camera)
+		float ProjectedScreenFraction(const DirectX::XMFLOAT4& sphere, const DirectX::XMMATRIX& view, const DirectX::XMMATRIX& proj);
 	};
 }
\ No newline at end of file
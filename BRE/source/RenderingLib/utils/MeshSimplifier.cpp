@@ -0,0 +1,558 @@
+#include "MeshSimplifier.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <queue>
+#include <utility>
+
+#include <utils/Assert.h>
+
+using namespace DirectX;
+
+namespace {
+	const std::uint32_t sNoVertex = 0xFFFFFFFFU;
+	// Triangles whose normal turns more than about 75 degrees after a collapse
+	// are folded. 90 degrees lets slivers stand up along texture seams.
+	const double sMinNormalCosine = 0.25;
+
+	// Sum of squared distances to planes, as the upper triangle of a symmetric 4x4 matrix
+	struct Quadric {
+		double m[10];
+
+		void AddPlane(const double a, const double b, const double c, const double d) {
+			m[0] += a * a; m[1] += a * b; m[2] += a * c; m[3] += a * d;
+			m[4] += b * b; m[5] += b * c; m[6] += b * d;
+			m[7] += c * c; m[8] += c * d;
+			m[9] += d * d;
+		}
+
+		void Add(const Quadric& quadric) {
+			for (unsigned int i = 0U; i < 10U; ++i) {
+				m[i] += quadric.m[i];
+			}
+		}
+
+		double Evaluate(const XMFLOAT3& p) const {
+			const double x = p.x;
+			const double y = p.y;
+			const double z = p.z;
+			const double error =
+				m[0] * x * x + 2.0 * m[1] * x * y + 2.0 * m[2] * x * z + 2.0 * m[3] * x +
+				m[4] * y * y + 2.0 * m[5] * y * z + 2.0 * m[6] * y +
+				m[7] * z * z + 2.0 * m[8] * z +
+				m[9];
+			// Rounding can make it slightly negative
+			return (std::max)(error, 0.0);
+		}
+	};
+
+	struct Collapse {
+		double mError;
+		std::uint32_t mFrom;
+		std::uint32_t mTo;
+
+		bool operator>(const Collapse& collapse) const {
+			return mError > collapse.mError;
+		}
+	};
+
+	XMFLOAT3 Sub(const XMFLOAT3& a, const XMFLOAT3& b) {
+		return XMFLOAT3(a.x - b.x, a.y - b.y, a.z - b.z);
+	}
+
+	XMFLOAT3 Cross(const XMFLOAT3& a, const XMFLOAT3& b) {
+		return XMFLOAT3(a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x);
+	}
+
+	float Dot(const XMFLOAT3& a, const XMFLOAT3& b) {
+		return a.x * b.x + a.y * b.y + a.z * b.z;
+	}
+
+	float DistanceSquared(const XMFLOAT3& a, const XMFLOAT3& b) {
+		const XMFLOAT3 d = Sub(a, b);
+		return Dot(d, d);
+	}
+
+	// Squared distance from p to the triangle abc (Ericson, Real-Time Collision Detection 5.1.5)
+	float PointTriangleDistanceSquared(const XMFLOAT3& p, const XMFLOAT3& a, const XMFLOAT3& b, const XMFLOAT3& c) {
+		const XMFLOAT3 ab = Sub(b, a);
+		const XMFLOAT3 ac = Sub(c, a);
+		const XMFLOAT3 ap = Sub(p, a);
+		const float d1 = Dot(ab, ap);
+		const float d2 = Dot(ac, ap);
+		if (d1 <= 0.0f && d2 <= 0.0f) {
+			return DistanceSquared(p, a);
+		}
+		const XMFLOAT3 bp = Sub(p, b);
+		const float d3 = Dot(ab, bp);
+		const float d4 = Dot(ac, bp);
+		if (d3 >= 0.0f && d4 <= d3) {
+			return DistanceSquared(p, b);
+		}
+		const float vc = d1 * d4 - d3 * d2;
+		if (vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f) {
+			const float v = d1 / (d1 - d3);
+			return DistanceSquared(p, XMFLOAT3(a.x + ab.x * v, a.y + ab.y * v, a.z + ab.z * v));
+		}
+		const XMFLOAT3 cp = Sub(p, c);
+		const float d5 = Dot(ab, cp);
+		const float d6 = Dot(ac, cp);
+		if (d6 >= 0.0f && d5 <= d6) {
+			return DistanceSquared(p, c);
+		}
+		const float vb = d5 * d2 - d1 * d6;
+		if (vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f) {
+			const float w = d2 / (d2 - d6);
+			return DistanceSquared(p, XMFLOAT3(a.x + ac.x * w, a.y + ac.y * w, a.z + ac.z * w));
+		}
+		const float va = d3 * d6 - d5 * d4;
+		if (va <= 0.0f && (d4 - d3) >= 0.0f && (d5 - d6) >= 0.0f) {
+			const float w = (d4 - d3) / ((d4 - d3) + (d5 - d6));
+			return DistanceSquared(p, XMFLOAT3(b.x + (c.x - b.x) * w, b.y + (c.y - b.y) * w, b.z + (c.z - b.z) * w));
+		}
+		const float denom = 1.0f / (va + vb + vc);
+		const float v = vb * denom;
+		const float w = vc * denom;
+		return DistanceSquared(p, XMFLOAT3(a.x + ab.x * v + ac.x * w, a.y + ab.y * v + ac.y * w, a.z + ab.z * v + ac.z * w));
+	}
+
+	// Collapses work on positions (vertices welded by position). Triangles keep
+	// the vertices of their corners, so they keep their attributes.
+	class Simplifier {
+	public:
+		Simplifier(const std::vector<XMFLOAT3>& positions, const std::vector<XMFLOAT3>& normals, const std::vector<XMFLOAT3>& textureCoordinates, const std::vector<unsigned int>& indices, const BRE::MeshSimplifier::Settings& settings)
+			: mPositions(positions)
+			, mNormals(normals)
+			, mTextureCoordinates(textureCoordinates)
+			, mSettings(settings)
+			, mTriangles(indices)
+			, mNumTriangles(0U)
+		{
+			BRE_ASSERT(indices.size() % 3U == 0U);
+			BRE_ASSERT(normals.empty() || normals.size() == positions.size());
+			BRE_ASSERT(textureCoordinates.empty() || textureCoordinates.size() == positions.size());
+			Weld();
+			InitTriangles();
+			LockBorders();
+			InitQuadrics();
+		}
+
+		size_t NumIndices() const {
+			return mNumTriangles * 3U;
+		}
+
+		// Returns the largest collapse error
+		double Run(const size_t targetIndexCount) {
+			const double maxError = static_cast<double>(mSettings.mMaxError) * mSettings.mMaxError;
+			std::priority_queue<Collapse, std::vector<Collapse>, std::greater<Collapse>> collapses;
+			for (size_t triangle = 0U; triangle < mTriangleAlive.size(); ++triangle) {
+				if (mTriangleAlive[triangle]) {
+					for (unsigned int corner = 0U; corner < 3U; ++corner) {
+						PushCollapses(Position(triangle, corner), Position(triangle, (corner + 1U) % 3U), collapses);
+					}
+				}
+			}
+
+			double error = 0.0;
+			while (NumIndices() > targetIndexCount && !collapses.empty()) {
+				const Collapse collapse = collapses.top();
+				collapses.pop();
+				if (!mPositionAlive[collapse.mFrom] || !mPositionAlive[collapse.mTo]) {
+					continue;
+				}
+				// Errors are only updated here, so the queue has entries that are too low
+				const double currentError = CollapseError(collapse.mFrom, collapse.mTo);
+				if (currentError > collapse.mError) {
+					collapses.push(Collapse{ currentError, collapse.mFrom, collapse.mTo });
+					continue;
+				}
+				if (currentError > maxError) {
+					break;
+				}
+				if (!CanCollapse(collapse.mFrom, collapse.mTo)) {
+					continue;
+				}
+				DoCollapse(collapse.mFrom, collapse.mTo);
+				error = (std::max)(error, currentError);
+				for (const std::uint32_t neighbour : mNeighbours) {
+					PushCollapses(collapse.mTo, neighbour, collapses);
+				}
+			}
+			return error;
+		}
+
+		void Result(std::vector<unsigned int>& result) const {
+			result.clear();
+			result.reserve(NumIndices());
+			for (size_t triangle = 0U; triangle < mTriangleAlive.size(); ++triangle) {
+				if (mTriangleAlive[triangle]) {
+					result.insert(result.end(), mTriangles.begin() + triangle * 3U, mTriangles.begin() + triangle * 3U + 3U);
+				}
+			}
+		}
+
+	private:
+		std::uint32_t Position(const size_t triangle, const unsigned int corner) const {
+			return mVertexPosition[mTriangles[triangle * 3U + corner]];
+		}
+
+		const XMFLOAT3& Point(const std::uint32_t position) const {
+			return mPositions[mPositionVertices[mPositionFirstVertex[position]]];
+		}
+
+		// Positions are the sorted, unique vertex positions
+		void Weld() {
+			const size_t numVertices = mPositions.size();
+			std::vector<std::uint32_t> order(numVertices);
+			for (size_t i = 0U; i < numVertices; ++i) {
+				order[i] = static_cast<std::uint32_t>(i);
+			}
+			std::sort(order.begin(), order.end(), [this](const std::uint32_t a, const std::uint32_t b) {
+				const XMFLOAT3& pa = mPositions[a];
+				const XMFLOAT3& pb = mPositions[b];
+				if (pa.x != pb.x) return pa.x < pb.x;
+				if (pa.y != pb.y) return pa.y < pb.y;
+				if (pa.z != pb.z) return pa.z < pb.z;
+				return a < b;
+			});
+			mVertexPosition.resize(numVertices);
+			mPositionVertices = order;
+			mPositionFirstVertex.clear();
+			for (size_t i = 0U; i < numVertices; ++i) {
+				const XMFLOAT3& p = mPositions[order[i]];
+				if (i == 0U || DistanceSquared(p, mPositions[order[i - 1U]]) != 0.0f) {
+					mPositionFirstVertex.push_back(static_cast<std::uint32_t>(i));
+				}
+				mVertexPosition[order[i]] = static_cast<std::uint32_t>(mPositionFirstVertex.size() - 1U);
+			}
+			mPositionFirstVertex.push_back(static_cast<std::uint32_t>(numVertices));
+			mPositionAlive.assign(mPositionFirstVertex.size() - 1U, true);
+		}
+
+		// Triangles with two corners at the same position are removed
+		void InitTriangles() {
+			const size_t numTriangles = mTriangles.size() / 3U;
+			mTriangleAlive.assign(numTriangles, false);
+			mPositionTriangles.resize(mPositionAlive.size());
+			for (size_t triangle = 0U; triangle < numTriangles; ++triangle) {
+				const std::uint32_t p0 = Position(triangle, 0U);
+				const std::uint32_t p1 = Position(triangle, 1U);
+				const std::uint32_t p2 = Position(triangle, 2U);
+				if (p0 == p1 || p1 == p2 || p2 == p0) {
+					continue;
+				}
+				mTriangleAlive[triangle] = true;
+				++mNumTriangles;
+				mPositionTriangles[p0].push_back(static_cast<std::uint32_t>(triangle));
+				mPositionTriangles[p1].push_back(static_cast<std::uint32_t>(triangle));
+				mPositionTriangles[p2].push_back(static_cast<std::uint32_t>(triangle));
+			}
+		}
+
+		// Positions of edges that do not have exactly two triangles
+		void LockBorders() {
+			std::vector<std::uint64_t> edges;
+			edges.reserve(mNumTriangles * 3U);
+			for (size_t triangle = 0U; triangle < mTriangleAlive.size(); ++triangle) {
+				if (mTriangleAlive[triangle]) {
+					for (unsigned int corner = 0U; corner < 3U; ++corner) {
+						const std::uint64_t a = Position(triangle, corner);
+						const std::uint64_t b = Position(triangle, (corner + 1U) % 3U);
+						edges.push_back(a < b ? (a << 32U) | b : (b << 32U) | a);
+					}
+				}
+			}
+			std::sort(edges.begin(), edges.end());
+			mPositionLocked.assign(mPositionAlive.size(), false);
+			for (size_t i = 0U; i < edges.size();) {
+				size_t j = i + 1U;
+				while (j < edges.size() && edges[j] == edges[i]) {
+					++j;
+				}
+				if (j - i != 2U) {
+					mPositionLocked[edges[i] >> 32U] = true;
+					mPositionLocked[edges[i] & 0xFFFFFFFFU] = true;
+				}
+				i = j;
+			}
+		}
+
+		void InitQuadrics() {
+			mQuadrics.assign(mPositionAlive.size(), Quadric{});
+			for (size_t triangle = 0U; triangle < mTriangleAlive.size(); ++triangle) {
+				if (!mTriangleAlive[triangle]) {
+					continue;
+				}
+				const XMFLOAT3& p0 = Point(Position(triangle, 0U));
+				const XMFLOAT3& p1 = Point(Position(triangle, 1U));
+				const XMFLOAT3& p2 = Point(Position(triangle, 2U));
+				const XMFLOAT3 normal = Cross(Sub(p1, p0), Sub(p2, p0));
+				const double length = std::sqrt(static_cast<double>(Dot(normal, normal)));
+				if (length == 0.0) {
+					continue;
+				}
+				const double a = normal.x / length;
+				const double b = normal.y / length;
+				const double c = normal.z / length;
+				const double d = -(a * p0.x + b * p0.y + c * p0.z);
+				for (unsigned int corner = 0U; corner < 3U; ++corner) {
+					mQuadrics[Position(triangle, corner)].AddPlane(a, b, c, d);
+				}
+			}
+		}
+
+		double AttributeDistance(const std::uint32_t vertexA, const std::uint32_t vertexB) const {
+			double distance = 0.0;
+			if (!mNormals.empty()) {
+				distance += mSettings.mNormalWeight * DistanceSquared(mNormals[vertexA], mNormals[vertexB]);
+			}
+			if (!mTextureCoordinates.empty()) {
+				distance += mSettings.mTextureCoordinateWeight * DistanceSquared(mTextureCoordinates[vertexA], mTextureCoordinates[vertexB]);
+			}
+			return distance;
+		}
+
+		// Vertex of position "to" with the closest attributes to the vertex
+		std::uint32_t ClosestVertex(const std::uint32_t vertex, const std::uint32_t to) const {
+			std::uint32_t closest = mPositionVertices[mPositionFirstVertex[to]];
+			double closestDistance = AttributeDistance(vertex, closest);
+			for (std::uint32_t i = mPositionFirstVertex[to] + 1U; i < mPositionFirstVertex[to + 1U]; ++i) {
+				const double vertexDistance = AttributeDistance(vertex, mPositionVertices[i]);
+				if (vertexDistance < closestDistance) {
+					closest = mPositionVertices[i];
+					closestDistance = vertexDistance;
+				}
+			}
+			return closest;
+		}
+
+		// Each vertex of "from" collapses onto the vertex of "to" of the triangles
+		// of the edge it belongs to, so it stays on its side of the seams. If it
+		// does not belong to them, a seam moves, and the vertex of "to" with the
+		// closest attributes is used. Returns the largest attributes difference
+		// of those.
+		double MapVertices(const std::uint32_t from, const std::uint32_t to, std::vector<std::pair<std::uint32_t, std::uint32_t>>& mapping) const {
+			mapping.clear();
+			for (std::uint32_t i = mPositionFirstVertex[from]; i < mPositionFirstVertex[from + 1U]; ++i) {
+				mapping.push_back(std::make_pair(mPositionVertices[i], sNoVertex));
+			}
+			for (const std::uint32_t triangle : mPositionTriangles[from]) {
+				if (!mTriangleAlive[triangle]) {
+					continue;
+				}
+				std::uint32_t fromVertex = sNoVertex;
+				std::uint32_t toVertex = sNoVertex;
+				for (unsigned int corner = 0U; corner < 3U; ++corner) {
+					const std::uint32_t vertex = mTriangles[triangle * 3U + corner];
+					if (mVertexPosition[vertex] == from) {
+						fromVertex = vertex;
+					}
+					else if (mVertexPosition[vertex] == to) {
+						toVertex = vertex;
+					}
+				}
+				if (toVertex != sNoVertex) {
+					for (std::pair<std::uint32_t, std::uint32_t>& vertices : mapping) {
+						if (vertices.first == fromVertex) {
+							vertices.second = toVertex;
+						}
+					}
+				}
+			}
+			double distance = 0.0;
+			for (std::pair<std::uint32_t, std::uint32_t>& vertices : mapping) {
+				if (vertices.second == sNoVertex) {
+					vertices.second = ClosestVertex(vertices.first, to);
+					distance = (std::max)(distance, AttributeDistance(vertices.first, vertices.second));
+				}
+			}
+			return distance;
+		}
+
+		double CollapseError(const std::uint32_t from, const std::uint32_t to) {
+			Quadric quadric = mQuadrics[from];
+			quadric.Add(mQuadrics[to]);
+			const XMFLOAT3& point = Point(to);
+			const double error = quadric.Evaluate(point);
+			return error + MapVertices(from, to, mMapping) * DistanceSquared(Point(from), point);
+		}
+
+		void PushCollapses(const std::uint32_t a, const std::uint32_t b, std::priority_queue<Collapse, std::vector<Collapse>, std::greater<Collapse>>& collapses) {
+			if (!mPositionLocked[a]) {
+				collapses.push(Collapse{ CollapseError(a, b), a, b });
+			}
+			if (!mPositionLocked[b]) {
+				collapses.push(Collapse{ CollapseError(b, a), b, a });
+			}
+		}
+
+		// Alive positions of the alive triangles of position, sorted
+		void Neighbours(const std::uint32_t position, std::vector<std::uint32_t>& neighbours) const {
+			neighbours.clear();
+			for (const std::uint32_t triangle : mPositionTriangles[position]) {
+				if (mTriangleAlive[triangle]) {
+					for (unsigned int corner = 0U; corner < 3U; ++corner) {
+						const std::uint32_t neighbour = Position(triangle, corner);
+						if (neighbour != position) {
+							neighbours.push_back(neighbour);
+						}
+					}
+				}
+			}
+			std::sort(neighbours.begin(), neighbours.end());
+			neighbours.erase(std::unique(neighbours.begin(), neighbours.end()), neighbours.end());
+		}
+
+		bool CanCollapse(const std::uint32_t from, const std::uint32_t to) {
+			// Link condition: the only neighbours in common are the third corners
+			// of the triangles of the edge, otherwise the collapse makes the mesh
+			// non manifold
+			size_t numEdgeTriangles = 0U;
+			for (const std::uint32_t triangle : mPositionTriangles[from]) {
+				if (mTriangleAlive[triangle] && (Position(triangle, 0U) == to || Position(triangle, 1U) == to || Position(triangle, 2U) == to)) {
+					++numEdgeTriangles;
+				}
+			}
+			if (numEdgeTriangles == 0U) {
+				return false;
+			}
+			Neighbours(from, mNeighbours);
+			Neighbours(to, mOtherNeighbours);
+			size_t numCommon = 0U;
+			for (size_t i = 0U, j = 0U; i < mNeighbours.size() && j < mOtherNeighbours.size();) {
+				if (mNeighbours[i] < mOtherNeighbours[j]) {
+					++i;
+				}
+				else if (mOtherNeighbours[j] < mNeighbours[i]) {
+					++j;
+				}
+				else {
+					++numCommon;
+					++i;
+					++j;
+				}
+			}
+			if (numCommon != numEdgeTriangles) {
+				return false;
+			}
+
+			// Triangles that move must not fold
+			const XMFLOAT3& point = Point(to);
+			for (const std::uint32_t triangle : mPositionTriangles[from]) {
+				if (!mTriangleAlive[triangle]) {
+					continue;
+				}
+				XMFLOAT3 corners[3];
+				XMFLOAT3 movedCorners[3];
+				bool hasTo = false;
+				for (unsigned int corner = 0U; corner < 3U; ++corner) {
+					const std::uint32_t position = Position(triangle, corner);
+					hasTo |= position == to;
+					corners[corner] = Point(position);
+					movedCorners[corner] = position == from ? point : corners[corner];
+				}
+				if (hasTo) {
+					continue;
+				}
+				const XMFLOAT3 normal = Cross(Sub(corners[1], corners[0]), Sub(corners[2], corners[0]));
+				const XMFLOAT3 movedNormal = Cross(Sub(movedCorners[1], movedCorners[0]), Sub(movedCorners[2], movedCorners[0]));
+				const double cosine = Dot(normal, movedNormal);
+				if (cosine <= sMinNormalCosine * std::sqrt(static_cast<double>(Dot(normal, normal)) * Dot(movedNormal, movedNormal))) {
+					return false;
+				}
+			}
+			return true;
+		}
+
+		// Neighbours of "to" after the collapse are left in mNeighbours
+		void DoCollapse(const std::uint32_t from, const std::uint32_t to) {
+			MapVertices(from, to, mMapping);
+			std::vector<std::uint32_t>& toTriangles = mPositionTriangles[to];
+			for (const std::uint32_t triangle : mPositionTriangles[from]) {
+				if (!mTriangleAlive[triangle]) {
+					continue;
+				}
+				if (Position(triangle, 0U) == to || Position(triangle, 1U) == to || Position(triangle, 2U) == to) {
+					mTriangleAlive[triangle] = false;
+					--mNumTriangles;
+					continue;
+				}
+				for (unsigned int corner = 0U; corner < 3U; ++corner) {
+					unsigned int& vertex = mTriangles[triangle * 3U + corner];
+					if (mVertexPosition[vertex] == from) {
+						for (const std::pair<std::uint32_t, std::uint32_t>& vertices : mMapping) {
+							if (vertices.first == vertex) {
+								vertex = vertices.second;
+								break;
+							}
+						}
+					}
+				}
+				toTriangles.push_back(triangle);
+			}
+			toTriangles.erase(std::remove_if(toTriangles.begin(), toTriangles.end(), [this](const std::uint32_t triangle) { return !mTriangleAlive[triangle]; }), toTriangles.end());
+			mPositionTriangles[from].clear();
+			mPositionTriangles[from].shrink_to_fit();
+			mQuadrics[to].Add(mQuadrics[from]);
+			mPositionAlive[from] = false;
+			Neighbours(to, mNeighbours);
+		}
+
+		const std::vector<XMFLOAT3>& mPositions;
+		const std::vector<XMFLOAT3>& mNormals;
+		const std::vector<XMFLOAT3>& mTextureCoordinates;
+		const BRE::MeshSimplifier::Settings& mSettings;
+
+		// Vertices of the triangles (3 per triangle)
+		std::vector<unsigned int> mTriangles;
+		std::vector<bool> mTriangleAlive;
+		size_t mNumTriangles;
+
+		std::vector<std::uint32_t> mVertexPosition;
+		// Vertices of each position are mPositionVertices[mPositionFirstVertex[p], mPositionFirstVertex[p + 1])
+		std::vector<std::uint32_t> mPositionVertices;
+		std::vector<std::uint32_t> mPositionFirstVertex;
+		std::vector<bool> mPositionAlive;
+		std::vector<bool> mPositionLocked;
+		// They can have triangles that are not alive
+		std::vector<std::vector<std::uint32_t>> mPositionTriangles;
+		std::vector<Quadric> mQuadrics;
+
+		std::vector<std::uint32_t> mNeighbours;
+		std::vector<std::uint32_t> mOtherNeighbours;
+		// Vertex of "from" and the vertex of "to" it collapses onto
+		std::vector<std::pair<std::uint32_t, std::uint32_t>> mMapping;
+	};
+}
+
+namespace BRE {
+	namespace MeshSimplifier {
+		float Simplify(const std::vector<XMFLOAT3>& positions, const std::vector<XMFLOAT3>& normals, const std::vector<XMFLOAT3>& textureCoordinates, const std::vector<unsigned int>& indices, const size_t targetIndexCount, const Settings& settings, std::vector<unsigned int>& result) {
+			Simplifier simplifier(positions, normals, textureCoordinates, indices, settings);
+			const double error = simplifier.Run(targetIndexCount);
+			simplifier.Result(result);
+			return static_cast<float>(std::sqrt(error));
+		}
+
+		float MaxDeviation(const std::vector<XMFLOAT3>& positions, const std::vector<unsigned int>& sourceIndices, const std::vector<unsigned int>& simplifiedIndices) {
+			BRE_ASSERT(sourceIndices.size() % 3U == 0U);
+			BRE_ASSERT(simplifiedIndices.size() % 3U == 0U);
+			std::vector<unsigned int> vertices(sourceIndices);
+			std::sort(vertices.begin(), vertices.end());
+			vertices.erase(std::unique(vertices.begin(), vertices.end()), vertices.end());
+
+			float maxDistance = 0.0f;
+			for (const unsigned int vertex : vertices) {
+				const XMFLOAT3& p = positions[vertex];
+				float distance = FLT_MAX;
+				for (size_t i = 0U; i < simplifiedIndices.size() && distance > 0.0f; i += 3U) {
+					distance = (std::min)(distance, PointTriangleDistanceSquared(p, positions[simplifiedIndices[i]], positions[simplifiedIndices[i + 1U]], positions[simplifiedIndices[i + 2U]]));
+				}
+				maxDistance = (std::max)(maxDistance, distance);
+			}
+			return std::sqrt(maxDistance);
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cfloat>
+#include <DirectXMath.h>
+#include <vector>
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Triangle list simplification by quadric error edge collapses (Garland
+// and Heckbert). A vertex is collapsed onto a neighbour, so simplified
+// indices reference the source vertices and share their vertex buffer.
+// Vertices with the same position (normal or texture coordinates seams)
+// collapse together, each one onto the vertex of the destination position
+// on the same side of the seams. Collapses that move a seam add the
+// attributes difference to the error, scaled by the squared edge length.
+// Vertices of open borders are locked, so meshes split in several pieces
+// do not crack.
+// It does not depend on Direct3D, so offline tools use it too.
+//
+//////////////////////////////////////////////////////////////////////////
+
+namespace BRE {
+	namespace MeshSimplifier {
+		struct Settings {
+			// Weights of the squared normal and texture coordinates differences of seams that move
+			float mNormalWeight = 0.25f;
+			float mTextureCoordinateWeight = 1.0f;
+			// Collapses with a larger error (in position units) are not done
+			float mMaxError = FLT_MAX;
+		};
+
+		// normals and textureCoordinates can be empty. result has at most
+		// targetIndexCount indices, unless the maximum error or the locked
+		// vertices stop the simplification earlier.
+		// It returns the error of the simplified mesh, an upper bound of the
+		// distance between the surfaces (plus the attributes error).
+		float Simplify(const std::vector<DirectX::XMFLOAT3>& positions, const std::vector<DirectX::XMFLOAT3>& normals, const std::vector<DirectX::XMFLOAT3>& textureCoordinates, const std::vector<unsigned int>& indices, const size_t targetIndexCount, const Settings& settings, std::vector<unsigned int>& result);
+
+		// Largest distance from the vertices of the source triangles to the
+		// simplified triangles. It is quadratic, for tools and tests.
+		float MaxDeviation(const std::vector<DirectX::XMFLOAT3>& positions, const std::vector<unsigned int>& sourceIndices, const std::vector<unsigned int>& simplifiedIndices);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,240 @@
+#include "MipGenerator.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include <utils/Assert.h>
+
+namespace {
+	using BRE::MipGenerator::sNumChannels;
+
+	// Kaiser filter radius (in destination texels) and shape
+	const float sKaiserWidth = 3.0f;
+	const float sKaiserAlpha = 4.0f;
+	const float sPi = 3.14159265358979f;
+
+	float SRGBToLinear(const float value) {
+		return value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+	}
+
+	float LinearToSRGB(const float value) {
+		return value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+	}
+
+	// Modified Bessel function of the first kind, order 0
+	float BesselI0(const float x) {
+		float sum = 1.0f;
+		float term = 1.0f;
+		for (unsigned int k = 1U; k < 32U; ++k) {
+			const float factor = x / (2.0f * k);
+			term *= factor * factor;
+			sum += term;
+			if (term < sum * 1e-8f) {
+				break;
+			}
+		}
+		return sum;
+	}
+
+	float Sinc(const float x) {
+		return std::fabs(x) < 1e-5f ? 1.0f : std::sin(sPi * x) / (sPi * x);
+	}
+
+	// x in [-1, 1]
+	float KaiserWindow(const float x) {
+		return BesselI0(sKaiserAlpha * std::sqrt(std::max(0.0f, 1.0f - x * x))) / BesselI0(sKaiserAlpha);
+	}
+
+	struct Tap {
+		unsigned int mIndex;
+		float mWeight;
+	};
+	typedef std::vector<Tap> Taps;
+
+	unsigned int Address(const int index, const unsigned int size, const bool wrap) {
+		const int n = static_cast<int>(size);
+		if (wrap) {
+			return static_cast<unsigned int>(((index % n) + n) % n);
+		}
+		return static_cast<unsigned int>(std::min(std::max(index, 0), n - 1));
+	}
+
+	// Source texels (and normalized weights) of each destination texel along one axis
+	void ComputeTaps(const unsigned int sourceSize, const unsigned int destinationSize, const BRE::MipGenerator::Settings& settings, std::vector<Taps>& taps) {
+		const float scale = static_cast<float>(sourceSize) / destinationSize;
+		taps.assign(destinationSize, Taps());
+		for (unsigned int i = 0U; i < destinationSize; ++i) {
+			Taps& destinationTaps = taps[i];
+			if (settings.mFilter == BRE::MipGenerator::Filter::Box) {
+				const float begin = i * scale;
+				const float end = (i + 1U) * scale;
+				for (int j = static_cast<int>(std::floor(begin)); j < static_cast<int>(std::ceil(end)); ++j) {
+					const float coverage = std::min(end, j + 1.0f) - std::max(begin, static_cast<float>(j));
+					if (coverage > 0.0f) {
+						destinationTaps.push_back(Tap{ Address(j, sourceSize, settings.mWrap), coverage });
+					}
+				}
+			}
+			else {
+				const float center = (i + 0.5f) * scale;
+				const float radius = sKaiserWidth * scale;
+				for (int j = static_cast<int>(std::floor(center - radius)); j <= static_cast<int>(std::ceil(center + radius)); ++j) {
+					// Distance in destination texels
+					const float x = (j + 0.5f - center) / scale;
+					if (std::fabs(x) < sKaiserWidth) {
+						destinationTaps.push_back(Tap{ Address(j, sourceSize, settings.mWrap), Sinc(x) * KaiserWindow(x / sKaiserWidth) });
+					}
+				}
+			}
+
+			float sum = 0.0f;
+			for (const Tap& tap : destinationTaps) {
+				sum += tap.mWeight;
+			}
+			BRE_ASSERT(sum > 0.0f);
+			for (Tap& tap : destinationTaps) {
+				tap.mWeight /= sum;
+			}
+		}
+	}
+
+	// Separable filter, horizontal pass first. Results are clamped to the range
+	// of the values ([0, 1], or [-1, 1] for normal vectors) so Kaiser ringing
+	// does not accumulate through the chain.
+	void Downsample(const std::vector<float>& source, const unsigned int width, const unsigned int height, const unsigned int destinationWidth, const unsigned int destinationHeight, const BRE::MipGenerator::Settings& settings, std::vector<float>& destination) {
+		std::vector<Taps> tapsX;
+		std::vector<Taps> tapsY;
+		ComputeTaps(width, destinationWidth, settings, tapsX);
+		ComputeTaps(height, destinationHeight, settings, tapsY);
+
+		std::vector<float> horizontal(static_cast<size_t>(destinationWidth) * height * sNumChannels, 0.0f);
+		for (unsigned int y = 0U; y < height; ++y) {
+			for (unsigned int x = 0U; x < destinationWidth; ++x) {
+				float* dst = &horizontal[(static_cast<size_t>(y) * destinationWidth + x) * sNumChannels];
+				for (const Tap& tap : tapsX[x]) {
+					const float* src = &source[(static_cast<size_t>(y) * width + tap.mIndex) * sNumChannels];
+					for (unsigned int c = 0U; c < sNumChannels; ++c) {
+						dst[c] += src[c] * tap.mWeight;
+					}
+				}
+			}
+		}
+
+		destination.assign(static_cast<size_t>(destinationWidth) * destinationHeight * sNumChannels, 0.0f);
+		for (unsigned int y = 0U; y < destinationHeight; ++y) {
+			for (unsigned int x = 0U; x < destinationWidth; ++x) {
+				float* dst = &destination[(static_cast<size_t>(y) * destinationWidth + x) * sNumChannels];
+				for (const Tap& tap : tapsY[y]) {
+					const float* src = &horizontal[(static_cast<size_t>(tap.mIndex) * destinationWidth + x) * sNumChannels];
+					for (unsigned int c = 0U; c < sNumChannels; ++c) {
+						dst[c] += src[c] * tap.mWeight;
+					}
+				}
+				for (unsigned int c = 0U; c < sNumChannels; ++c) {
+					const float minValue = (settings.mNormalMap && c != 3U) ? -1.0f : 0.0f;
+					dst[c] = std::min(1.0f, std::max(minValue, dst[c]));
+				}
+			}
+		}
+	}
+
+	std::uint8_t EncodeUnit(const float value) {
+		return static_cast<std::uint8_t>(std::min(1.0f, std::max(0.0f, value)) * 255.0f + 0.5f);
+	}
+
+	// Averaged vectors are shorter than 1 where the normals diverge. They are
+	// renormalized before being stored. An average close to zero has no
+	// direction left (128 does not decode to exactly 0, so it is not compared
+	// against 0) and becomes the unperturbed normal (0, 0, 1).
+	void EncodeNormals(const std::vector<float>& vectors, std::vector<std::uint8_t>& texels) {
+		for (size_t i = 0U; i < vectors.size(); i += sNumChannels) {
+			float x = vectors[i];
+			float y = vectors[i + 1U];
+			float z = vectors[i + 2U];
+			const float length = std::sqrt(x * x + y * y + z * z);
+			if (length > 0.01f) {
+				x /= length;
+				y /= length;
+				z /= length;
+			}
+			else {
+				x = 0.0f;
+				y = 0.0f;
+				z = 1.0f;
+			}
+			texels[i] = EncodeUnit(x * 0.5f + 0.5f);
+			texels[i + 1U] = EncodeUnit(y * 0.5f + 0.5f);
+			texels[i + 2U] = EncodeUnit(z * 0.5f + 0.5f);
+			texels[i + 3U] = EncodeUnit(vectors[i + 3U]);
+		}
+	}
+}
+
+namespace BRE {
+	namespace MipGenerator {
+		unsigned int NumLevels(const unsigned int width, const unsigned int height) {
+			unsigned int numLevels = 1U;
+			for (unsigned int size = std::max(width, height); size > 1U; size >>= 1U) {
+				++numLevels;
+			}
+			return numLevels;
+		}
+
+		void Generate(const std::uint8_t* data, const unsigned int width, const unsigned int height, const Settings& settings, std::vector<std::vector<std::uint8_t>>& levels) {
+			BRE_ASSERT(data);
+			BRE_ASSERT(width > 0U && height > 0U);
+
+			float toLinear[256];
+			for (unsigned int i = 0U; i < 256U; ++i) {
+				toLinear[i] = i / 255.0f;
+			}
+			float colorToLinear[256];
+			for (unsigned int i = 0U; i < 256U; ++i) {
+				colorToLinear[i] = settings.mSRGB ? SRGBToLinear(toLinear[i]) : toLinear[i];
+			}
+
+			const size_t numValues = static_cast<size_t>(width) * height * sNumChannels;
+			levels.resize(NumLevels(width, height));
+			levels[0].assign(data, data + numValues);
+
+			// Normal vectors are decoded to [-1, 1], and filtered without being
+			// renormalized so every level averages the vectors of the top one.
+			BRE_ASSERT(!(settings.mSRGB && settings.mNormalMap));
+			std::vector<float> current(numValues);
+			for (size_t i = 0U; i < numValues; ++i) {
+				if ((i % sNumChannels) == 3U) {
+					current[i] = toLinear[data[i]];
+				}
+				else {
+					current[i] = settings.mNormalMap ? toLinear[data[i]] * 2.0f - 1.0f : colorToLinear[data[i]];
+				}
+			}
+
+			unsigned int currentWidth = width;
+			unsigned int currentHeight = height;
+			std::vector<float> next;
+			for (size_t level = 1U; level < levels.size(); ++level) {
+				const unsigned int nextWidth = std::max(1U, currentWidth >> 1U);
+				const unsigned int nextHeight = std::max(1U, currentHeight >> 1U);
+				Downsample(current, currentWidth, currentHeight, nextWidth, nextHeight, settings, next);
+
+				std::vector<std::uint8_t>& texels = levels[level];
+				texels.resize(next.size());
+				if (settings.mNormalMap) {
+					EncodeNormals(next, texels);
+				}
+				else {
+					for (size_t i = 0U; i < next.size(); ++i) {
+						const bool color = (i % sNumChannels) != 3U;
+						const float value = (settings.mSRGB && color) ? LinearToSRGB(next[i]) : next[i];
+						texels[i] = static_cast<std::uint8_t>(value * 255.0f + 0.5f);
+					}
+				}
+
+				current.swap(next);
+				currentWidth = nextWidth;
+				currentHeight = nextHeight;
+			}
+		}
+	}
+}
\ No newline at end of file
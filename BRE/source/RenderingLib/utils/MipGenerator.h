@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+//////////////////////////////////////////////////////////////////////////
+//
+// CPU mip chain generation for 8 bits per channel, 4 channels textures.
+// Levels are filtered in floating point from the previous level, so only
+// the stored levels are quantized. When texels are sRGB encoded, color
+// channels are filtered in linear space (alpha is always linear). Normal
+// maps are filtered as vectors and every stored level is renormalized.
+// It does not depend on Direct3D, so offline tools use it too.
+//
+//////////////////////////////////////////////////////////////////////////
+
+namespace BRE {
+	namespace MipGenerator {
+		enum class Filter {
+			// Average of the source texels covered by each destination texel
+			Box,
+			// Kaiser windowed sinc (sharper, keeps more detail in distant mips)
+			Kaiser,
+		};
+
+		struct Settings {
+			Filter mFilter = Filter::Box;
+			// Color channels are sRGB encoded
+			bool mSRGB = false;
+			// RGB channels are a unit vector, each component mapped from
+			// [-1, 1] to [0, 1]. Not compatible with mSRGB.
+			bool mNormalMap = false;
+			// Wrap addressing for tiled textures, clamp otherwise
+			bool mWrap = true;
+		};
+
+		static const unsigned int sNumChannels = 4U;
+
+		// Number of levels of a full chain (down to 1x1)
+		unsigned int NumLevels(const unsigned int width, const unsigned int height);
+
+		// data has width * height texels, tightly packed, row by row.
+		// levels[0] is a copy of data. levels[i] has max(1, width >> i) x
+		// max(1, height >> i) texels.
+		void Generate(const std::uint8_t* data, const unsigned int width, const unsigned int height, const Settings& settings, std::vector<std::vector<std::uint8_t>>& levels);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,308 @@
+#include "RangeAllocator.h"
+
+#include <algorithm>
+#include <cstdint>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#include <utils/Assert.h>
+
+namespace {
+	// Index of the highest and lowest set bits. value must not be 0.
+	unsigned int HighestBit(const unsigned int value) {
+#if defined(_MSC_VER)
+		unsigned long index;
+		_BitScanReverse(&index, value);
+		return static_cast<unsigned int>(index);
+#else
+		return 31U - static_cast<unsigned int>(__builtin_clz(value));
+#endif
+	}
+
+	unsigned int LowestBit(const unsigned int value) {
+#if defined(_MSC_VER)
+		unsigned long index;
+		_BitScanForward(&index, value);
+		return static_cast<unsigned int>(index);
+#else
+		return static_cast<unsigned int>(__builtin_ctz(value));
+#endif
+	}
+}
+
+namespace BRE {
+	RangeAllocator::RangeAllocator(const unsigned int capacity)
+		: mUnusedBlocks(sNoBlock)
+		, mLastBlock(sNoBlock)
+		, mFirstLevelBitmap(0U)
+		, mCapacity(0U)
+		, mUsedSize(0U)
+	{
+		std::fill(mSecondLevelBitmaps, mSecondLevelBitmaps + sNumFirstLevels, 0U);
+		for (unsigned int firstLevel = 0U; firstLevel < sNumFirstLevels; ++firstLevel) {
+			for (unsigned int secondLevel = 0U; secondLevel < sLevelDivisions; ++secondLevel) {
+				mFreeLists[firstLevel][secondLevel] = sNoBlock;
+			}
+		}
+		Grow(capacity);
+	}
+
+	unsigned int RangeAllocator::Allocate(const unsigned int size) {
+		BRE_ASSERT(size > 0U);
+		const unsigned int block = FindFreeBlock(size);
+		if (block == sNoBlock) {
+			return sInvalidOffset;
+		}
+		return mBlocks[AllocateFromBlock(block, size)].mOffset;
+	}
+
+	void RangeAllocator::Free(const unsigned int offset) {
+		const std::unordered_map<unsigned int, unsigned int>::iterator findIt = mBlockByOffset.find(offset);
+		BRE_ASSERT(findIt != mBlockByOffset.end());
+		unsigned int block = findIt->second;
+		mBlockByOffset.erase(findIt);
+		BRE_ASSERT(!mBlocks[block].mFree);
+		mUsedSize -= mBlocks[block].mSize;
+
+		// Merge with free neighbours. Merged blocks are unused.
+		const unsigned int previous = mBlocks[block].mPrevious;
+		if (previous != sNoBlock && mBlocks[previous].mFree) {
+			RemoveFreeBlock(previous);
+			mBlocks[previous].mSize += mBlocks[block].mSize;
+			mBlocks[previous].mNext = mBlocks[block].mNext;
+			if (mBlocks[block].mNext != sNoBlock) {
+				mBlocks[mBlocks[block].mNext].mPrevious = previous;
+			}
+			if (mLastBlock == block) {
+				mLastBlock = previous;
+			}
+			mBlocks[block].mNextFree = mUnusedBlocks;
+			mUnusedBlocks = block;
+			block = previous;
+		}
+		const unsigned int next = mBlocks[block].mNext;
+		if (next != sNoBlock && mBlocks[next].mFree) {
+			RemoveFreeBlock(next);
+			mBlocks[block].mSize += mBlocks[next].mSize;
+			mBlocks[block].mNext = mBlocks[next].mNext;
+			if (mBlocks[next].mNext != sNoBlock) {
+				mBlocks[mBlocks[next].mNext].mPrevious = block;
+			}
+			if (mLastBlock == next) {
+				mLastBlock = block;
+			}
+			mBlocks[next].mNextFree = mUnusedBlocks;
+			mUnusedBlocks = next;
+		}
+		InsertFreeBlock(block);
+	}
+
+	void RangeAllocator::Grow(const unsigned int newCapacity) {
+		BRE_ASSERT(newCapacity >= mCapacity);
+		const unsigned int growth = newCapacity - mCapacity;
+		if (growth == 0U) {
+			return;
+		}
+		if (mLastBlock != sNoBlock && mBlocks[mLastBlock].mFree) {
+			RemoveFreeBlock(mLastBlock);
+			mBlocks[mLastBlock].mSize += growth;
+			InsertFreeBlock(mLastBlock);
+		}
+		else {
+			const unsigned int block = NewBlock();
+			Block& newBlock = mBlocks[block];
+			newBlock.mOffset = mCapacity;
+			newBlock.mSize = growth;
+			newBlock.mPrevious = mLastBlock;
+			newBlock.mNext = sNoBlock;
+			if (mLastBlock != sNoBlock) {
+				mBlocks[mLastBlock].mNext = block;
+			}
+			mLastBlock = block;
+			InsertFreeBlock(block);
+		}
+		mCapacity = newCapacity;
+	}
+
+	void RangeAllocator::Defragment(const unsigned int maxElements, std::vector<Move>& moves) {
+		// Allocations are visited from the highest one. Each one moves into
+		// the free block that Allocate() would return, if it is below it, so
+		// moves go down and the free space goes up. The free block at the end
+		// is above every allocation, so it is out of the free lists until the
+		// sources are freed (it would be the block found for its size class).
+		if (mLastBlock == sNoBlock) {
+			return;
+		}
+		const unsigned int lastFreeBlock = mBlocks[mLastBlock].mFree ? mLastBlock : sNoBlock;
+		unsigned int block = mLastBlock;
+		if (lastFreeBlock != sNoBlock) {
+			RemoveFreeBlock(lastFreeBlock);
+			block = mBlocks[lastFreeBlock].mPrevious;
+		}
+		// Sources are freed after the walk, so destinations do not overlap them
+		const size_t firstMove = moves.size();
+		unsigned int movedElements = 0U;
+		while (block != sNoBlock && movedElements < maxElements) {
+			const unsigned int previous = mBlocks[block].mPrevious;
+			const unsigned int offset = mBlocks[block].mOffset;
+			const unsigned int size = mBlocks[block].mSize;
+			// Destinations of this walk are below their source already
+			const bool moved = std::any_of(moves.cbegin() + firstMove, moves.cend(), [offset](const Move& move) { return move.mTo == offset; });
+			const unsigned int freeBlock = mBlocks[block].mFree || moved ? sNoBlock : FindFreeBlock(size);
+			if (freeBlock != sNoBlock && mBlocks[freeBlock].mOffset < offset) {
+				const unsigned int allocatedBlock = AllocateFromBlock(freeBlock, size);
+				const Move move = { offset, mBlocks[allocatedBlock].mOffset, size };
+				moves.push_back(move);
+				movedElements += size;
+			}
+			block = previous;
+		}
+
+		if (lastFreeBlock != sNoBlock) {
+			InsertFreeBlock(lastFreeBlock);
+		}
+		for (size_t iMove = firstMove; iMove < moves.size(); ++iMove) {
+			Free(moves[iMove].mFrom);
+		}
+	}
+
+	size_t RangeAllocator::NumFreeRanges() const {
+		size_t numFreeRanges = 0U;
+		for (unsigned int block = mLastBlock; block != sNoBlock; block = mBlocks[block].mPrevious) {
+			if (mBlocks[block].mFree) {
+				++numFreeRanges;
+			}
+		}
+		return numFreeRanges;
+	}
+
+	unsigned int RangeAllocator::LargestFreeRange() const {
+		unsigned int largestFreeRange = 0U;
+		for (unsigned int block = mLastBlock; block != sNoBlock; block = mBlocks[block].mPrevious) {
+			if (mBlocks[block].mFree) {
+				largestFreeRange = (std::max)(largestFreeRange, mBlocks[block].mSize);
+			}
+		}
+		return largestFreeRange;
+	}
+
+	void RangeAllocator::Mapping(const unsigned int size, unsigned int& firstLevel, unsigned int& secondLevel) {
+		if (size < sLevelDivisions) {
+			firstLevel = 0U;
+			secondLevel = size;
+		}
+		else {
+			const unsigned int highestBit = HighestBit(size);
+			firstLevel = highestBit - sLevelDivisionsLog2 + 1U;
+			secondLevel = (size >> (highestBit - sLevelDivisionsLog2)) ^ sLevelDivisions;
+		}
+	}
+
+	unsigned int RangeAllocator::FindFreeBlock(const unsigned int size) const {
+		// Round size up to the next size class, so any block of the list fits
+		std::uint64_t roundedSize = size;
+		if (size >= sLevelDivisions) {
+			roundedSize += (1U << (HighestBit(size) - sLevelDivisionsLog2)) - 1U;
+			if (roundedSize > 0xFFFFFFFFU) {
+				return sNoBlock;
+			}
+		}
+		unsigned int firstLevel;
+		unsigned int secondLevel;
+		Mapping(static_cast<unsigned int>(roundedSize), firstLevel, secondLevel);
+
+		unsigned int secondLevelBitmap = mSecondLevelBitmaps[firstLevel] & (0xFFFFFFFFU << secondLevel);
+		if (secondLevelBitmap == 0U) {
+			const unsigned int firstLevelBitmap = firstLevel + 1U < 32U ? mFirstLevelBitmap & (0xFFFFFFFFU << (firstLevel + 1U)) : 0U;
+			if (firstLevelBitmap == 0U) {
+				return sNoBlock;
+			}
+			firstLevel = LowestBit(firstLevelBitmap);
+			secondLevelBitmap = mSecondLevelBitmaps[firstLevel];
+			BRE_ASSERT(secondLevelBitmap != 0U);
+		}
+		secondLevel = LowestBit(secondLevelBitmap);
+		BRE_ASSERT(mFreeLists[firstLevel][secondLevel] != sNoBlock);
+		return mFreeLists[firstLevel][secondLevel];
+	}
+
+	void RangeAllocator::InsertFreeBlock(const unsigned int block) {
+		unsigned int firstLevel;
+		unsigned int secondLevel;
+		Mapping(mBlocks[block].mSize, firstLevel, secondLevel);
+		Block& freeBlock = mBlocks[block];
+		freeBlock.mFree = true;
+		freeBlock.mPreviousFree = sNoBlock;
+		freeBlock.mNextFree = mFreeLists[firstLevel][secondLevel];
+		if (freeBlock.mNextFree != sNoBlock) {
+			mBlocks[freeBlock.mNextFree].mPreviousFree = block;
+		}
+		mFreeLists[firstLevel][secondLevel] = block;
+		mFirstLevelBitmap |= 1U << firstLevel;
+		mSecondLevelBitmaps[firstLevel] |= 1U << secondLevel;
+	}
+
+	void RangeAllocator::RemoveFreeBlock(const unsigned int block) {
+		unsigned int firstLevel;
+		unsigned int secondLevel;
+		Mapping(mBlocks[block].mSize, firstLevel, secondLevel);
+		Block& freeBlock = mBlocks[block];
+		BRE_ASSERT(freeBlock.mFree);
+		freeBlock.mFree = false;
+		if (freeBlock.mPreviousFree != sNoBlock) {
+			mBlocks[freeBlock.mPreviousFree].mNextFree = freeBlock.mNextFree;
+		}
+		else {
+			BRE_ASSERT(mFreeLists[firstLevel][secondLevel] == block);
+			mFreeLists[firstLevel][secondLevel] = freeBlock.mNextFree;
+			if (freeBlock.mNextFree == sNoBlock) {
+				mSecondLevelBitmaps[firstLevel] &= ~(1U << secondLevel);
+				if (mSecondLevelBitmaps[firstLevel] == 0U) {
+					mFirstLevelBitmap &= ~(1U << firstLevel);
+				}
+			}
+		}
+		if (freeBlock.mNextFree != sNoBlock) {
+			mBlocks[freeBlock.mNextFree].mPreviousFree = freeBlock.mPreviousFree;
+		}
+	}
+
+	unsigned int RangeAllocator::NewBlock() {
+		if (mUnusedBlocks != sNoBlock) {
+			const unsigned int block = mUnusedBlocks;
+			mUnusedBlocks = mBlocks[block].mNextFree;
+			return block;
+		}
+		mBlocks.push_back(Block());
+		return static_cast<unsigned int>(mBlocks.size() - 1U);
+	}
+
+	unsigned int RangeAllocator::AllocateFromBlock(const unsigned int block, const unsigned int size) {
+		BRE_ASSERT(mBlocks[block].mSize >= size);
+		RemoveFreeBlock(block);
+		const unsigned int remainder = mBlocks[block].mSize - size;
+		if (remainder > 0U) {
+			// NewBlock() can reallocate mBlocks
+			const unsigned int remainderBlock = NewBlock();
+			Block& allocatedBlock = mBlocks[block];
+			Block& newBlock = mBlocks[remainderBlock];
+			newBlock.mOffset = allocatedBlock.mOffset + size;
+			newBlock.mSize = remainder;
+			newBlock.mPrevious = block;
+			newBlock.mNext = allocatedBlock.mNext;
+			if (allocatedBlock.mNext != sNoBlock) {
+				mBlocks[allocatedBlock.mNext].mPrevious = remainderBlock;
+			}
+			allocatedBlock.mNext = remainderBlock;
+			allocatedBlock.mSize = size;
+			if (mLastBlock == block) {
+				mLastBlock = remainderBlock;
+			}
+			InsertFreeBlock(remainderBlock);
+		}
+		mBlockByOffset[mBlocks[block].mOffset] = block;
+		mUsedSize += size;
+		return block;
+	}
+}
\ No newline at end of file
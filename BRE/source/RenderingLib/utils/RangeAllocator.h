@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Two level segregated fit (TLSF) allocator of ranges of elements of a
+// buffer that it does not own (vertices or indices of a geometry pool).
+// Free ranges are kept in lists by size class (a power of two split in
+// sLevelDivisions), so Allocate() and Free() take constant time. Free
+// ranges are merged with their free neighbours.
+// Defragment() moves the highest allocations into free ranges below
+// them and returns the copies its owner must do, so the free space that
+// streaming (allocations and frees while drawing) leaves goes to the end.
+// It does not depend on Direct3D.
+//
+//////////////////////////////////////////////////////////////////////////
+
+namespace BRE {
+	class RangeAllocator {
+	public:
+		static const unsigned int sInvalidOffset = 0xFFFFFFFFU;
+
+		struct Move {
+			unsigned int mFrom;
+			unsigned int mTo;
+			unsigned int mSize;
+		};
+
+		explicit RangeAllocator(const unsigned int capacity);
+
+		const RangeAllocator& operator=(const RangeAllocator& rhs) = delete;
+
+		// Offset of size elements, or sInvalidOffset if no free range is
+		// large enough (Grow() and try again).
+		unsigned int Allocate(const unsigned int size);
+		// offset must be returned by Allocate() or by a Move of Defragment()
+		void Free(const unsigned int offset);
+		// New elements go after the current ones
+		void Grow(const unsigned int newCapacity);
+
+		// Moves allocations, from the highest one, into free ranges below them
+		// until at least maxElements are moved. Moves are appended; no
+		// destination overlaps a source, so they can be copied in any order.
+		// Allocation offsets change from mFrom to mTo.
+		void Defragment(const unsigned int maxElements, std::vector<Move>& moves);
+
+		unsigned int Capacity() const { return mCapacity; }
+		unsigned int UsedSize() const { return mUsedSize; }
+		unsigned int FreeSize() const { return mCapacity - mUsedSize; }
+		size_t NumAllocations() const { return mBlockByOffset.size(); }
+		// Free elements below the highest allocation (the ones Defragment() can move it into)
+		unsigned int FragmentedSize() const { return FreeSize() - (mLastBlock != sNoBlock && mBlocks[mLastBlock].mFree ? mBlocks[mLastBlock].mSize : 0U); }
+		// These two walk all the ranges
+		size_t NumFreeRanges() const;
+		unsigned int LargestFreeRange() const;
+
+	private:
+		// Second level lists of each power of two
+		static const unsigned int sLevelDivisionsLog2 = 4U;
+		static const unsigned int sLevelDivisions = 1U << sLevelDivisionsLog2;
+		// Sizes below sLevelDivisions are all in the first first level list
+		static const unsigned int sNumFirstLevels = 32U - sLevelDivisionsLog2 + 1U;
+		static const unsigned int sNoBlock = 0xFFFFFFFFU;
+
+		struct Block {
+			unsigned int mOffset;
+			unsigned int mSize;
+			// Neighbour ranges by offset
+			unsigned int mPrevious;
+			unsigned int mNext;
+			// Free list of the size class. mNextFree also links unused blocks.
+			unsigned int mPreviousFree;
+			unsigned int mNextFree;
+			bool mFree;
+		};
+
+		static void Mapping(const unsigned int size, unsigned int& firstLevel, unsigned int& secondLevel);
+		// Free block of at least size elements, or sNoBlock
+		unsigned int FindFreeBlock(const unsigned int size) const;
+		void InsertFreeBlock(const unsigned int block);
+		void RemoveFreeBlock(const unsigned int block);
+		unsigned int NewBlock();
+		// Marks the first size elements of the free block as allocated
+		unsigned int AllocateFromBlock(const unsigned int block, const unsigned int size);
+
+		std::vector<Block> mBlocks;
+		unsigned int mUnusedBlocks;
+		unsigned int mLastBlock;
+		unsigned int mFirstLevelBitmap;
+		unsigned int mSecondLevelBitmaps[sNumFirstLevels];
+		unsigned int mFreeLists[sNumFirstLevels][sLevelDivisions];
+		// Allocated blocks by offset
+		std::unordered_map<unsigned int, unsigned int> mBlockByOffset;
+		unsigned int mCapacity;
+		unsigned int mUsedSize;
+	};
+}
\ No newline at end of file
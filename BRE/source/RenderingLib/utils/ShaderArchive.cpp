@@ -0,0 +1,248 @@
+#include "ShaderArchive.h"
+
+#include <cstring>
+#include <unordered_set>
+
+#include <utils/Assert.h>
+
+namespace {
+	// Bytecode of each shader starts at multiples of it
+	const size_t sByteCodeAlignment = 16U;
+
+	size_t AlignUp(const size_t value, const size_t alignment) {
+		return (value + alignment - 1U) / alignment * alignment;
+	}
+
+	// a + b <= limit, without overflow
+	bool FitsIn(const std::uint64_t a, const std::uint64_t b, const std::uint64_t limit) {
+		return a <= limit && b <= limit - a;
+	}
+
+	std::uint32_t AppendName(const std::string& name, std::vector<char>& names) {
+		const std::uint32_t offset = static_cast<std::uint32_t>(names.size());
+		names.insert(names.end(), name.begin(), name.end());
+		names.push_back('\0');
+		return offset;
+	}
+
+	template<typename T>
+	void Write(const std::vector<T>& elems, const size_t offset, std::vector<std::uint8_t>& archive) {
+		if (!elems.empty()) {
+			memcpy(archive.data() + offset, elems.data(), elems.size() * sizeof(T));
+		}
+	}
+}
+
+namespace BRE {
+	bool ShaderArchive::Build(const std::vector<ShaderDesc>& shaders, const std::vector<RenderTypeDesc>& renderTypes, std::vector<std::uint8_t>& archive, std::string& error) {
+		std::vector<Shader> shaderTable;
+		std::vector<InputElement> inputElements;
+		std::vector<RenderType> renderTypeTable;
+		std::vector<std::uint32_t> renderTypeShaders;
+		std::vector<char> names;
+		std::unordered_set<std::string> shaderNames;
+		size_t byteCodeSize = 0U;
+		for (const ShaderDesc& desc : shaders) {
+			if (!shaderNames.insert(desc.mName).second) {
+				error = desc.mName + " is repeated";
+				return false;
+			}
+			if (desc.mByteCode.empty()) {
+				error = desc.mName + " has no bytecode";
+				return false;
+			}
+			if (desc.mType >= ShaderType::Count || (desc.mType != ShaderType::Vertex && !desc.mInputLayout.empty())) {
+				error = desc.mName + " cannot have an input layout";
+				return false;
+			}
+
+			Shader shader;
+			shader.mNameOffset = AppendName(desc.mName, names);
+			shader.mType = desc.mType;
+			shader.mFirstInputElement = static_cast<std::uint32_t>(inputElements.size());
+			shader.mNumInputElements = static_cast<std::uint32_t>(desc.mInputLayout.size());
+			byteCodeSize = AlignUp(byteCodeSize, sByteCodeAlignment);
+			shader.mByteCodeOffset = byteCodeSize;
+			shader.mByteCodeSize = desc.mByteCode.size();
+			byteCodeSize += desc.mByteCode.size();
+			shaderTable.push_back(shader);
+
+			for (const InputElementDesc& elementDesc : desc.mInputLayout) {
+				InputElement element;
+				element.mSemanticNameOffset = AppendName(elementDesc.mSemanticName, names);
+				element.mSemanticIndex = elementDesc.mSemanticIndex;
+				element.mFormat = elementDesc.mFormat;
+				element.mInputSlot = elementDesc.mInputSlot;
+				element.mAlignedByteOffset = elementDesc.mAlignedByteOffset;
+				element.mInputSlotClass = elementDesc.mInputSlotClass;
+				element.mInstanceDataStepRate = elementDesc.mInstanceDataStepRate;
+				inputElements.push_back(element);
+			}
+		}
+
+		for (const RenderTypeDesc& desc : renderTypes) {
+			RenderType renderType;
+			renderType.mNameOffset = AppendName(desc.mName, names);
+			renderType.mFirstShader = static_cast<std::uint32_t>(renderTypeShaders.size());
+			renderType.mNumShaders = static_cast<std::uint32_t>(desc.mShaders.size());
+			for (const size_t shader : desc.mShaders) {
+				if (shader >= shaders.size()) {
+					error = desc.mName + " has an invalid shader index";
+					return false;
+				}
+				renderTypeShaders.push_back(static_cast<std::uint32_t>(shader));
+			}
+			renderTypeTable.push_back(renderType);
+		}
+
+		Header header;
+		header.mMagic = sMagic;
+		header.mVersion = sVersion;
+		header.mNumShaders = static_cast<std::uint32_t>(shaderTable.size());
+		header.mNumInputElements = static_cast<std::uint32_t>(inputElements.size());
+		header.mNumRenderTypes = static_cast<std::uint32_t>(renderTypeTable.size());
+		header.mNumRenderTypeShaders = static_cast<std::uint32_t>(renderTypeShaders.size());
+		header.mNamesSize = static_cast<std::uint32_t>(names.size());
+		header.mPadding = 0U;
+
+		const size_t shadersOffset = sizeof(Header);
+		const size_t inputElementsOffset = shadersOffset + shaderTable.size() * sizeof(Shader);
+		const size_t renderTypesOffset = inputElementsOffset + inputElements.size() * sizeof(InputElement);
+		const size_t renderTypeShadersOffset = renderTypesOffset + renderTypeTable.size() * sizeof(RenderType);
+		const size_t namesOffset = renderTypeShadersOffset + renderTypeShaders.size() * sizeof(std::uint32_t);
+		header.mByteCodeOffset = AlignUp(namesOffset + names.size(), sByteCodeAlignment);
+		header.mByteCodeSize = byteCodeSize;
+
+		archive.assign(static_cast<size_t>(header.mByteCodeOffset + byteCodeSize), 0U);
+		memcpy(archive.data(), &header, sizeof(header));
+		Write(shaderTable, shadersOffset, archive);
+		Write(inputElements, inputElementsOffset, archive);
+		Write(renderTypeTable, renderTypesOffset, archive);
+		Write(renderTypeShaders, renderTypeShadersOffset, archive);
+		Write(names, namesOffset, archive);
+		for (size_t i = 0U; i < shaders.size(); ++i) {
+			memcpy(archive.data() + header.mByteCodeOffset + shaderTable[i].mByteCodeOffset, shaders[i].mByteCode.data(), shaders[i].mByteCode.size());
+		}
+		return true;
+	}
+
+	bool ShaderArchive::Open(const std::uint8_t* data, const size_t size, std::string& error) {
+		mHeader = nullptr;
+		if (data == nullptr || size < sizeof(Header)) {
+			error = "Shader archive is too small";
+			return false;
+		}
+		if ((reinterpret_cast<std::uintptr_t>(data) % sizeof(std::uint64_t)) != 0U) {
+			error = "Shader archive is not aligned";
+			return false;
+		}
+		const Header* header = reinterpret_cast<const Header*>(data);
+		if (header->mMagic != sMagic || header->mVersion != sVersion) {
+			error = "Not a shader archive or unsupported version";
+			return false;
+		}
+
+		const std::uint64_t shadersOffset = sizeof(Header);
+		const std::uint64_t inputElementsOffset = shadersOffset + static_cast<std::uint64_t>(header->mNumShaders) * sizeof(Shader);
+		const std::uint64_t renderTypesOffset = inputElementsOffset + static_cast<std::uint64_t>(header->mNumInputElements) * sizeof(InputElement);
+		const std::uint64_t renderTypeShadersOffset = renderTypesOffset + static_cast<std::uint64_t>(header->mNumRenderTypes) * sizeof(RenderType);
+		const std::uint64_t namesOffset = renderTypeShadersOffset + static_cast<std::uint64_t>(header->mNumRenderTypeShaders) * sizeof(std::uint32_t);
+		if (!FitsIn(namesOffset, header->mNamesSize, header->mByteCodeOffset) || !FitsIn(header->mByteCodeOffset, header->mByteCodeSize, size)) {
+			error = "Shader archive is truncated";
+			return false;
+		}
+		const char* names = reinterpret_cast<const char*>(data + namesOffset);
+		if (header->mNamesSize > 0U && names[header->mNamesSize - 1U] != '\0') {
+			error = "Shader archive has invalid names";
+			return false;
+		}
+
+		const Shader* shaders = reinterpret_cast<const Shader*>(data + shadersOffset);
+		for (size_t i = 0U; i < header->mNumShaders; ++i) {
+			const Shader& shader = shaders[i];
+			const bool validLayout = shader.mNumInputElements == 0U || shader.mType == ShaderType::Vertex;
+			if (shader.mNameOffset >= header->mNamesSize || shader.mType >= ShaderType::Count || !validLayout || shader.mByteCodeSize == 0U
+				|| !FitsIn(shader.mFirstInputElement, shader.mNumInputElements, header->mNumInputElements)
+				|| !FitsIn(shader.mByteCodeOffset, shader.mByteCodeSize, header->mByteCodeSize)) {
+				error = "Shader archive has an invalid shader";
+				return false;
+			}
+		}
+		const InputElement* inputElements = reinterpret_cast<const InputElement*>(data + inputElementsOffset);
+		for (size_t i = 0U; i < header->mNumInputElements; ++i) {
+			if (inputElements[i].mSemanticNameOffset >= header->mNamesSize) {
+				error = "Shader archive has an invalid input element";
+				return false;
+			}
+		}
+		const RenderType* renderTypes = reinterpret_cast<const RenderType*>(data + renderTypesOffset);
+		for (size_t i = 0U; i < header->mNumRenderTypes; ++i) {
+			if (renderTypes[i].mNameOffset >= header->mNamesSize || !FitsIn(renderTypes[i].mFirstShader, renderTypes[i].mNumShaders, header->mNumRenderTypeShaders)) {
+				error = "Shader archive has an invalid render type";
+				return false;
+			}
+		}
+		const std::uint32_t* renderTypeShaders = reinterpret_cast<const std::uint32_t*>(data + renderTypeShadersOffset);
+		for (size_t i = 0U; i < header->mNumRenderTypeShaders; ++i) {
+			if (renderTypeShaders[i] >= header->mNumShaders) {
+				error = "Shader archive has an invalid render type shader";
+				return false;
+			}
+		}
+
+		mHeader = header;
+		mShaders = shaders;
+		mInputElements = inputElements;
+		mRenderTypes = renderTypes;
+		mRenderTypeShaders = renderTypeShaders;
+		mNames = names;
+		mByteCode = data + header->mByteCodeOffset;
+		return true;
+	}
+
+	const ShaderArchive::Shader& ShaderArchive::GetShader(const size_t shader) const {
+		BRE_ASSERT(shader < NumShaders());
+		return mShaders[shader];
+	}
+
+	const char* ShaderArchive::ShaderName(const size_t shader) const {
+		return mNames + GetShader(shader).mNameOffset;
+	}
+
+	const std::uint8_t* ShaderArchive::ByteCode(const size_t shader) const {
+		return mByteCode + GetShader(shader).mByteCodeOffset;
+	}
+
+	bool ShaderArchive::Find(const char* name, size_t& shader) const {
+		BRE_ASSERT(name);
+		for (size_t i = 0U; i < NumShaders(); ++i) {
+			if (strcmp(ShaderName(i), name) == 0) {
+				shader = i;
+				return true;
+			}
+		}
+		return false;
+	}
+
+	const ShaderArchive::InputElement& ShaderArchive::GetInputElement(const size_t shader, const size_t element) const {
+		const Shader& archiveShader = GetShader(shader);
+		BRE_ASSERT(element < archiveShader.mNumInputElements);
+		return mInputElements[archiveShader.mFirstInputElement + element];
+	}
+
+	const char* ShaderArchive::SemanticName(const InputElement& element) const {
+		BRE_ASSERT(mHeader);
+		return mNames + element.mSemanticNameOffset;
+	}
+
+	const char* ShaderArchive::RenderTypeName(const size_t renderType) const {
+		BRE_ASSERT(renderType < NumRenderTypes());
+		return mNames + mRenderTypes[renderType].mNameOffset;
+	}
+
+	const std::uint32_t* ShaderArchive::RenderTypeShaders(const size_t renderType, size_t& size) const {
+		BRE_ASSERT(renderType < NumRenderTypes());
+		size = mRenderTypes[renderType].mNumShaders;
+		return mRenderTypeShaders + mRenderTypes[renderType].mFirstShader;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,147 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Shader archive (written by ContentTools shaders).
+// It bundles the compiled bytecode (.cso) of every shader with the input
+// layout of vertex shaders, and lists the shaders each render type needs.
+// Layout: Header, Shader table, InputElement table, RenderType table,
+// shader indices of render types, null terminated names and bytecode
+// (16 bytes aligned). Shaders are named by the content path drawers load
+// them with. Open() validates an archive in memory (mapped or read) and
+// every accessor returns pointers into it, so shaders are created from
+// it with no copy.
+// Formats are DXGI_FORMAT values. It does not depend on Direct3D, so
+// offline tools use it too.
+//
+//////////////////////////////////////////////////////////////////////////
+
+namespace BRE {
+	class ShaderArchive {
+	public:
+		// "BRSA"
+		static const std::uint32_t sMagic = 0x41535242U;
+		static const std::uint32_t sVersion = 1U;
+		// D3D11_APPEND_ALIGNED_ELEMENT
+		static const std::uint32_t sAppendAligned = 0xFFFFFFFFU;
+
+		enum class ShaderType : std::uint32_t {
+			Vertex,
+			Hull,
+			Domain,
+			Geometry,
+			Pixel,
+			Compute,
+			Count,
+		};
+
+		struct Header {
+			std::uint32_t mMagic;
+			std::uint32_t mVersion;
+			std::uint32_t mNumShaders;
+			std::uint32_t mNumInputElements;
+			std::uint32_t mNumRenderTypes;
+			// Size of the shader indices of every render type
+			std::uint32_t mNumRenderTypeShaders;
+			std::uint32_t mNamesSize;
+			std::uint32_t mPadding;
+			std::uint64_t mByteCodeOffset;
+			std::uint64_t mByteCodeSize;
+		};
+
+		struct Shader {
+			std::uint32_t mNameOffset;
+			ShaderType mType;
+			// Input layout (vertex shaders only)
+			std::uint32_t mFirstInputElement;
+			std::uint32_t mNumInputElements;
+			// Relative to Header::mByteCodeOffset
+			std::uint64_t mByteCodeOffset;
+			std::uint64_t mByteCodeSize;
+		};
+
+		// Same fields as D3D11_INPUT_ELEMENT_DESC
+		struct InputElement {
+			std::uint32_t mSemanticNameOffset;
+			std::uint32_t mSemanticIndex;
+			std::uint32_t mFormat;
+			std::uint32_t mInputSlot;
+			std::uint32_t mAlignedByteOffset;
+			// 0 per vertex, 1 per instance
+			std::uint32_t mInputSlotClass;
+			std::uint32_t mInstanceDataStepRate;
+		};
+
+		struct RenderType {
+			std::uint32_t mNameOffset;
+			// Range of the render type shader indices
+			std::uint32_t mFirstShader;
+			std::uint32_t mNumShaders;
+		};
+
+		// Build() input
+		struct InputElementDesc {
+			std::string mSemanticName;
+			std::uint32_t mSemanticIndex = 0U;
+			std::uint32_t mFormat = 0U;
+			std::uint32_t mInputSlot = 0U;
+			std::uint32_t mAlignedByteOffset = sAppendAligned;
+			std::uint32_t mInputSlotClass = 0U;
+			std::uint32_t mInstanceDataStepRate = 0U;
+		};
+
+		struct ShaderDesc {
+			std::string mName;
+			ShaderType mType = ShaderType::Vertex;
+			std::vector<std::uint8_t> mByteCode;
+			std::vector<InputElementDesc> mInputLayout;
+		};
+
+		struct RenderTypeDesc {
+			std::string mName;
+			// Indices of ShaderDesc
+			std::vector<size_t> mShaders;
+		};
+
+		// Returns false (and fills error) if names are repeated, bytecode is empty,
+		// a shader that is not a vertex shader has an input layout or a render
+		// type shader index is out of range.
+		static bool Build(const std::vector<ShaderDesc>& shaders, const std::vector<RenderTypeDesc>& renderTypes, std::vector<std::uint8_t>& archive, std::string& error);
+
+		ShaderArchive() = default;
+		const ShaderArchive& operator=(const ShaderArchive& rhs) = delete;
+
+		// data must outlive the archive. On failure, error is filled and false is returned.
+		bool Open(const std::uint8_t* data, const size_t size, std::string& error);
+		bool IsOpen() const { return mHeader != nullptr; }
+
+		size_t NumShaders() const { return mHeader ? mHeader->mNumShaders : 0U; }
+		const Shader& GetShader(const size_t shader) const;
+		const char* ShaderName(const size_t shader) const;
+		const std::uint8_t* ByteCode(const size_t shader) const;
+		// Returns false if there is no shader with that name
+		bool Find(const char* name, size_t& shader) const;
+
+		const InputElement& GetInputElement(const size_t shader, const size_t element) const;
+		const char* SemanticName(const InputElement& element) const;
+
+		size_t NumRenderTypes() const { return mHeader ? mHeader->mNumRenderTypes : 0U; }
+		const char* RenderTypeName(const size_t renderType) const;
+		// Shader indices of the render type (size is filled with their number)
+		const std::uint32_t* RenderTypeShaders(const size_t renderType, size_t& size) const;
+
+	private:
+		const Header* mHeader = nullptr;
+		const Shader* mShaders = nullptr;
+		const InputElement* mInputElements = nullptr;
+		const RenderType* mRenderTypes = nullptr;
+		const std::uint32_t* mRenderTypeShaders = nullptr;
+		const char* mNames = nullptr;
+		const std::uint8_t* mByteCode = nullptr;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include <utils/Assert.h>
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Ring of snapshots handed from one producer thread to one consumer
+// thread without locks. The producer writes a free slot in place and
+// publishes it. The consumer reads published slots in order and releases
+// them. Slots are reused, so their allocations (vectors, strings) too.
+// With N slots, the producer can be writing while N - 1 snapshots are
+// published or being read.
+// Try* methods return nullptr instead of waiting: the caller decides how
+// to wait.
+//
+//////////////////////////////////////////////////////////////////////////
+
+namespace BRE {
+	template<typename T>
+	class SnapshotRing {
+	public:
+		explicit SnapshotRing(const size_t numSlots)
+			: mSlots(numSlots)
+		{
+			BRE_ASSERT(numSlots > 0U);
+		}
+
+		const SnapshotRing& operator=(const SnapshotRing& rhs) = delete;
+
+		// Producer thread
+		T* TryBeginWrite() {
+			const std::uint64_t published = mPublished.load(std::memory_order_relaxed);
+			const std::uint64_t released = mReleased.load(std::memory_order_acquire);
+			if (published - released == mSlots.size()) {
+				return nullptr;
+			}
+			return &mSlots[static_cast<size_t>(published % mSlots.size())];
+		}
+
+		void EndWrite() {
+			mPublished.store(mPublished.load(std::memory_order_relaxed) + 1U, std::memory_order_release);
+		}
+
+		// Consumer thread
+		const T* TryBeginRead() {
+			const std::uint64_t released = mReleased.load(std::memory_order_relaxed);
+			const std::uint64_t published = mPublished.load(std::memory_order_acquire);
+			if (released == published) {
+				return nullptr;
+			}
+			return &mSlots[static_cast<size_t>(released % mSlots.size())];
+		}
+
+		void EndRead() {
+			mReleased.store(mReleased.load(std::memory_order_relaxed) + 1U, std::memory_order_release);
+		}
+
+		size_t NumSlots() const { return mSlots.size(); }
+		// Snapshots published and not released yet (it can be stale)
+		size_t NumPending() const {
+			const std::uint64_t released = mReleased.load(std::memory_order_acquire);
+			return static_cast<size_t>(mPublished.load(std::memory_order_acquire) - released);
+		}
+
+	private:
+		std::vector<T> mSlots;
+		// Counters of published and released snapshots, in different cache lines
+		alignas(64) std::atomic<std::uint64_t> mPublished{ 0U };
+		alignas(64) std::atomic<std::uint64_t> mReleased{ 0U };
+	};
+}
\ No newline at end of file
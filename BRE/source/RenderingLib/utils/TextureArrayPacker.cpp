@@ -0,0 +1,57 @@
+#include "TextureArrayPacker.h"
+
+#include <algorithm>
+
+#include <utils/Assert.h>
+
+namespace BRE {
+	TextureArrayPacker::TextureArrayPacker(const unsigned int maxPools, const unsigned int initialCapacity, const unsigned int maxSlices)
+		: mMaxPools(maxPools)
+		, mInitialCapacity(initialCapacity)
+		, mMaxSlices(maxSlices)
+	{
+		BRE_ASSERT(initialCapacity > 0U);
+		BRE_ASSERT(initialCapacity <= maxSlices);
+	}
+
+	bool TextureArrayPacker::Allocate(const Key& key, Slot& slot) {
+		size_t pool = 0U;
+		while (pool < mPools.size() && !(mPools[pool].mKey == key)) {
+			++pool;
+		}
+		if (pool == mPools.size()) {
+			if (mPools.size() == mMaxPools) {
+				return false;
+			}
+			const Pool newPool = { key, mInitialCapacity, 0U };
+			mPools.push_back(newPool);
+		}
+
+		Pool& selectedPool = mPools[pool];
+		if (selectedPool.mSize == selectedPool.mCapacity) {
+			if (selectedPool.mCapacity == mMaxSlices) {
+				return false;
+			}
+			selectedPool.mCapacity = std::min(selectedPool.mCapacity * 2U, mMaxSlices);
+		}
+		slot.mPool = static_cast<unsigned int>(pool);
+		slot.mSlice = selectedPool.mSize;
+		++selectedPool.mSize;
+		return true;
+	}
+
+	const TextureArrayPacker::Key& TextureArrayPacker::PoolKey(const size_t pool) const {
+		BRE_ASSERT(pool < mPools.size());
+		return mPools[pool].mKey;
+	}
+
+	unsigned int TextureArrayPacker::PoolCapacity(const size_t pool) const {
+		BRE_ASSERT(pool < mPools.size());
+		return mPools[pool].mCapacity;
+	}
+
+	unsigned int TextureArrayPacker::PoolSize(const size_t pool) const {
+		BRE_ASSERT(pool < mPools.size());
+		return mPools[pool].mSize;
+	}
+}
\ No newline at end of file
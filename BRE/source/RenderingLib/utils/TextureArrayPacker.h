@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Slice allocation of textures in texture array pools. Textures with
+// the same dimensions, number of mip levels and format share a pool (a
+// Texture2DArray), so their slices can be selected in shaders with an
+// index instead of a shader resource view bind. There are at most
+// maxPools pools (shaders declare a fixed number of them). A full pool
+// doubles its capacity up to maxSlices; its owner must then recreate
+// the array and copy the old slices.
+// It does not depend on Direct3D.
+//
+//////////////////////////////////////////////////////////////////////////
+
+namespace BRE {
+	class TextureArrayPacker {
+	public:
+		struct Key {
+			unsigned int mWidth;
+			unsigned int mHeight;
+			unsigned int mNumMips;
+			// DXGI_FORMAT value
+			unsigned int mFormat;
+
+			bool operator==(const Key& key) const {
+				return mWidth == key.mWidth && mHeight == key.mHeight && mNumMips == key.mNumMips && mFormat == key.mFormat;
+			}
+		};
+
+		struct Slot {
+			unsigned int mPool;
+			unsigned int mSlice;
+		};
+
+		TextureArrayPacker(const unsigned int maxPools, const unsigned int initialCapacity, const unsigned int maxSlices);
+
+		const TextureArrayPacker& operator=(const TextureArrayPacker& rhs) = delete;
+
+		// Returns false if the texture needs a new pool and there are already
+		// maxPools, or if its pool has maxSlices slices. Capacity of the pool
+		// (PoolCapacity()) may have grown.
+		bool Allocate(const Key& key, Slot& slot);
+
+		size_t NumPools() const { return mPools.size(); }
+		const Key& PoolKey(const size_t pool) const;
+		unsigned int PoolCapacity(const size_t pool) const;
+		unsigned int PoolSize(const size_t pool) const;
+
+	private:
+		struct Pool {
+			Key mKey;
+			unsigned int mCapacity;
+			unsigned int mSize;
+		};
+
+		std::vector<Pool> mPools;
+		unsigned int mMaxPools;
+		unsigned int mInitialCapacity;
+		unsigned int mMaxSlices;
+	};
+}
\ No newline at end of file
@@ -1,14 +1,27 @@
 #pragma once
 
 #include <string>
+#include <vector>
 #include <boost/lexical_cast.hpp>
 #include <yaml-cpp/yaml.h>
 
+#include <managers/VirtualFileSystem.h>
 #include <utils/Assert.h>
 
 namespace BRE {
 	class YamlUtils {
 	public:
+		// Parses a file read through VirtualFileSystem. The node is undefined if the file cannot be read.
+		static YAML::Node LoadFile(const char* filepath) {
+			BRE_ASSERT(filepath);
+			BRE_ASSERT(VirtualFileSystem::gInstance);
+			std::vector<std::uint8_t> data;
+			if (!VirtualFileSystem::gInstance->ReadFile(filepath, data)) {
+				return YAML::Node(YAML::NodeType::Undefined);
+			}
+			return YAML::Load(std::string(data.begin(), data.end()));
+		}
+
 		static bool IsDefined(const YAML::Node& node, const char* key) {
 			BRE_ASSERT(key);
 			YAML::Node attr = node[key];
@@ -24,15 +37,6 @@ namespace BRE {
 			return boost::lexical_cast<T>(attr.as<std::string>());
 		}
 
-		template<>
-		static std::string GetScalar(const YAML::Node& node, const char* key) {
-			BRE_ASSERT(key);
-			YAML::Node attr = node[key];
-			BRE_ASSERT(attr.IsDefined());
-			BRE_ASSERT(attr.IsScalar());
-			return attr.as<std::string>();
-		}
-
 		template<typename T>
 #ifdef _DEBUG
 		static void GetSequence(const YAML::Node& node, const char* key, T* const sequence, const size_t numElems) {
@@ -53,26 +57,35 @@ namespace BRE {
 			}
 			BRE_ASSERT(currentNumElems == numElems);
 		}
+	};
+
+	template<>
+	inline std::string YamlUtils::GetScalar<std::string>(const YAML::Node& node, const char* key) {
+		BRE_ASSERT(key);
+		YAML::Node attr = node[key];
+		BRE_ASSERT(attr.IsDefined());
+		BRE_ASSERT(attr.IsScalar());
+		return attr.as<std::string>();
+	}
 
-		template<>
+	template<>
 #ifdef _DEBUG
-		static void GetSequence(const YAML::Node& node, const char* key, float* const sequence, const size_t numElems) {
+	inline void YamlUtils::GetSequence<float>(const YAML::Node& node, const char* key, float* const sequence, const size_t numElems) {
 #else
-		static void GetSequence(const YAML::Node& node, const char* key, float* const sequence, const size_t) {
+	inline void YamlUtils::GetSequence<float>(const YAML::Node& node, const char* key, float* const sequence, const size_t) {
 #endif
-			BRE_ASSERT(key);
-			BRE_ASSERT(sequence);
-			YAML::Node attr = node[key];
-			BRE_ASSERT(attr.IsDefined());
-			BRE_ASSERT(attr.IsSequence());
-			size_t currentNumElems = 0;
-			for (const YAML::Node& seqNode : attr) {
-				BRE_ASSERT(seqNode.IsScalar());
-				BRE_ASSERT(currentNumElems < numElems);
-				sequence[currentNumElems] = boost::lexical_cast<float>(seqNode.as<std::string>());
-				++currentNumElems;
-			}
-			BRE_ASSERT(currentNumElems == numElems);
+		BRE_ASSERT(key);
+		BRE_ASSERT(sequence);
+		YAML::Node attr = node[key];
+		BRE_ASSERT(attr.IsDefined());
+		BRE_ASSERT(attr.IsSequence());
+		size_t currentNumElems = 0;
+		for (const YAML::Node& seqNode : attr) {
+			BRE_ASSERT(seqNode.IsScalar());
+			BRE_ASSERT(currentNumElems < numElems);
+			sequence[currentNumElems] = boost::lexical_cast<float>(seqNode.as<std::string>());
+			++currentNumElems;
 		}
-	};
+		BRE_ASSERT(currentNumElems == numElems);
+	}
 }
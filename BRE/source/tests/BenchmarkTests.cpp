@@ -0,0 +1,255 @@
+#include "TestFramework.h"
+
+#include <cstdint>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <general/Benchmark.h>
+#include <general/CameraPath.h>
+
+using namespace BRE;
+
+namespace {
+	// Report files are written under the test working directory
+	const char* sReportFilepath = "BenchmarkTestsReport";
+
+	CameraPath::Key MakeKey(const float time, const float x, const float y, const float z, const float yaw) {
+		const CameraPath::Key key = { time, { x, y, z }, { 0.0f, yaw, 0.0f } };
+		return key;
+	}
+
+	// 4 keys along X, one per second, from time 2 to time 5
+	CameraPath StraightPath() {
+		CameraPath path;
+		for (unsigned int i = 0U; i < 4U; ++i) {
+			path.AddKey(MakeKey(2.0f + i, 10.0f * i, 1.0f, 0.0f, 0.5f * i));
+		}
+		return path;
+	}
+
+	Benchmark::Settings MakeSettings(const float timeStep, const unsigned int warmupFrames) {
+		Benchmark::Settings settings;
+		settings.mTimeStep = timeStep;
+		settings.mWarmupFrames = warmupFrames;
+		settings.mReportFilepath = sReportFilepath;
+		return settings;
+	}
+
+	bool KeysAreNear(const CameraPath::Key& a, const CameraPath::Key& b, const float epsilon) {
+		for (size_t c = 0U; c < 3U; ++c) {
+			if (std::fabs(a.mTranslation[c] - b.mTranslation[c]) > epsilon || std::fabs(a.mRotation[c] - b.mRotation[c]) > epsilon) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	std::vector<std::string> ReadLines(const std::string& filepath) {
+		std::vector<std::string> lines;
+		std::ifstream stream(filepath);
+		std::string line;
+		while (std::getline(stream, line)) {
+			lines.push_back(line);
+		}
+		return lines;
+	}
+}
+
+BRE_TEST(WarmupFramesAreNotRecorded) {
+	Benchmark benchmark(MakeSettings(0.5f, 3U), StraightPath());
+	for (std::uint64_t frame = 0U; frame < 3U; ++frame) {
+		BRE_CHECK(benchmark.IsWarmingUp());
+		// Warm-up frames stay at the start of the path
+		CameraPath::Key key;
+		benchmark.CurrentKey(key);
+		BRE_CHECK_NEAR(key.mTime, 2.0f, 1.0e-6f);
+		benchmark.EndFrame(frame, 100.0);
+	}
+	BRE_CHECK(!benchmark.IsWarmingUp());
+	BRE_CHECK(benchmark.Samples().empty());
+
+	benchmark.EndFrame(3U, 16.0);
+	BRE_CHECK(benchmark.Samples().size() == 1U);
+	BRE_CHECK(benchmark.Samples()[0].mFrame == 3U);
+	BRE_CHECK_NEAR(benchmark.Samples()[0].mCpuMs, 16.0, 1.0e-9);
+	CameraPath::Key key;
+	benchmark.CurrentKey(key);
+	BRE_CHECK_NEAR(key.mTime, 2.5f, 1.0e-6f);
+}
+
+BRE_TEST(FinishesAfterTheEndOfThePath) {
+	// A 3 seconds path at 0.5 seconds per frame records times 0, 0.5, ..., 3
+	Benchmark benchmark(MakeSettings(0.5f, 0U), StraightPath());
+	std::uint64_t frame = 0U;
+	while (!benchmark.IsFinished() && frame < 100U) {
+		benchmark.EndFrame(frame, 10.0);
+		++frame;
+	}
+	BRE_CHECK(benchmark.IsFinished());
+	BRE_CHECK(benchmark.Samples().size() == 7U);
+
+	// Frames after the end are ignored
+	benchmark.EndFrame(frame, 10.0);
+	BRE_CHECK(benchmark.Samples().size() == 7U);
+}
+
+BRE_TEST(GpuTimesAreSetOnTheirFrame) {
+	Benchmark benchmark(MakeSettings(0.5f, 2U), StraightPath());
+	for (std::uint64_t frame = 10U; frame < 15U; ++frame) {
+		benchmark.EndFrame(frame, 1.0);
+	}
+	const std::vector<Benchmark::Sample>& samples = benchmark.Samples();
+	BRE_CHECK(samples.size() == 3U);
+	BRE_CHECK(samples.front().mFrame == 12U && samples.back().mFrame == 14U);
+	for (const Benchmark::Sample& sample : samples) {
+		BRE_CHECK(sample.mGpuMs < 0.0);
+	}
+
+	// Results arrive out of order and for frames that were not recorded
+	benchmark.SetGpuMs(13U, 2.5);
+	benchmark.SetGpuMs(11U, 9.0);
+	benchmark.SetGpuMs(12U, 1.5);
+	benchmark.SetGpuMs(20U, 9.0);
+	BRE_CHECK_NEAR(samples[0].mGpuMs, 1.5, 1.0e-9);
+	BRE_CHECK_NEAR(samples[1].mGpuMs, 2.5, 1.0e-9);
+	BRE_CHECK(samples[2].mGpuMs < 0.0);
+}
+
+BRE_TEST(ReportHasARowPerFrame) {
+	Benchmark benchmark(MakeSettings(1.0f, 1U), StraightPath());
+	for (std::uint64_t frame = 0U; frame < 5U; ++frame) {
+		benchmark.EndFrame(frame, 10.0 + frame);
+	}
+	BRE_CHECK(benchmark.IsFinished());
+	benchmark.SetGpuMs(1U, 4.0);
+	benchmark.SetGpuMs(3U, 6.0);
+	BRE_CHECK(benchmark.WriteReport());
+
+	// Frames whose GPU time did not arrive have an empty field
+	const std::vector<std::string> rows = ReadLines(std::string(sReportFilepath) + ".csv");
+	BRE_CHECK(rows.size() == 5U);
+	if (rows.size() == 5U) {
+		BRE_CHECK(rows[0] == "frame,cpuMs,gpuMs");
+		BRE_CHECK(rows[1] == "0,11.0000,4.0000");
+		BRE_CHECK(rows[2] == "1,12.0000,");
+		BRE_CHECK(rows[3] == "2,13.0000,6.0000");
+		BRE_CHECK(rows[4] == "3,14.0000,");
+	}
+
+	std::ifstream stream(std::string(sReportFilepath) + ".json");
+	std::stringstream summary;
+	summary << stream.rdbuf();
+	BRE_CHECK(summary.str().find("\"warmupFrames\": 1,") != std::string::npos);
+	BRE_CHECK(summary.str().find("\"cpuMs\": {\"count\": 4, \"mean\": 12.5000") != std::string::npos);
+	BRE_CHECK(summary.str().find("\"gpuMs\": {\"count\": 2, \"mean\": 5.0000") != std::string::npos);
+}
+
+BRE_TEST(PercentilesUseNearestRank) {
+	std::vector<double> values;
+	for (int i = 100; i > 0; --i) {
+		values.push_back(static_cast<double>(i));
+	}
+	const Benchmark::Summary summary = Benchmark::Summarize(values);
+	BRE_CHECK(summary.mCount == 100U);
+	BRE_CHECK_NEAR(summary.mMean, 50.5, 1.0e-9);
+	BRE_CHECK_NEAR(summary.mMin, 1.0, 1.0e-9);
+	BRE_CHECK_NEAR(summary.mMax, 100.0, 1.0e-9);
+	BRE_CHECK_NEAR(summary.mP50, 50.0, 1.0e-9);
+	BRE_CHECK_NEAR(summary.mP95, 95.0, 1.0e-9);
+	BRE_CHECK_NEAR(summary.mP99, 99.0, 1.0e-9);
+
+	// Ranks are rounded up
+	const std::vector<double> sortedValues = { 10.0, 20.0, 30.0, 40.0 };
+	BRE_CHECK_NEAR(Benchmark::Percentile(sortedValues, 0.0), 10.0, 1.0e-9);
+	BRE_CHECK_NEAR(Benchmark::Percentile(sortedValues, 25.0), 10.0, 1.0e-9);
+	BRE_CHECK_NEAR(Benchmark::Percentile(sortedValues, 26.0), 20.0, 1.0e-9);
+	BRE_CHECK_NEAR(Benchmark::Percentile(sortedValues, 95.0), 40.0, 1.0e-9);
+	BRE_CHECK_NEAR(Benchmark::Percentile(sortedValues, 100.0), 40.0, 1.0e-9);
+
+	const Benchmark::Summary emptySummary = Benchmark::Summarize(std::vector<double>());
+	BRE_CHECK(emptySummary.mCount == 0U);
+	BRE_CHECK(emptySummary.mP99 == 0.0);
+}
+
+BRE_TEST(PathGoesThroughKeysAndClampsAtEndpoints) {
+	const CameraPath path = StraightPath();
+	BRE_CHECK(path.NumKeys() == 4U);
+	BRE_CHECK_NEAR(path.StartTime(), 2.0f, 1.0e-6f);
+	BRE_CHECK_NEAR(path.Duration(), 3.0f, 1.0e-6f);
+
+	CameraPath::Key key;
+	for (unsigned int i = 0U; i < 4U; ++i) {
+		path.Evaluate(2.0f + i, key);
+		BRE_CHECK(KeysAreNear(key, MakeKey(0.0f, 10.0f * i, 1.0f, 0.0f, 0.5f * i), 1.0e-5f));
+	}
+
+	path.Evaluate(0.0f, key);
+	BRE_CHECK_NEAR(key.mTime, 0.0f, 1.0e-6f);
+	BRE_CHECK(KeysAreNear(key, MakeKey(0.0f, 0.0f, 1.0f, 0.0f, 0.0f), 1.0e-6f));
+	path.Evaluate(9.0f, key);
+	BRE_CHECK_NEAR(key.mTime, 9.0f, 1.0e-6f);
+	BRE_CHECK(KeysAreNear(key, MakeKey(0.0f, 30.0f, 1.0f, 0.0f, 1.5f), 1.0e-6f));
+
+	// Just inside the endpoints the path is next to them
+	path.Evaluate(2.001f, key);
+	BRE_CHECK(KeysAreNear(key, MakeKey(0.0f, 0.0f, 1.0f, 0.0f, 0.0f), 0.05f));
+	path.Evaluate(4.999f, key);
+	BRE_CHECK(KeysAreNear(key, MakeKey(0.0f, 30.0f, 1.0f, 0.0f, 1.5f), 0.05f));
+
+	// Catmull-Rom reproduces evenly spaced collinear keys in the middle segment
+	path.Evaluate(3.5f, key);
+	BRE_CHECK(KeysAreNear(key, MakeKey(0.0f, 15.0f, 1.0f, 0.0f, 0.75f), 1.0e-5f));
+}
+
+BRE_TEST(SingleKeyPathIsConstant) {
+	CameraPath path;
+	path.AddKey(MakeKey(1.0f, 3.0f, 4.0f, 5.0f, 0.25f));
+	BRE_CHECK_NEAR(path.Duration(), 0.0f, 1.0e-6f);
+	CameraPath::Key key;
+	path.Evaluate(7.0f, key);
+	BRE_CHECK(KeysAreNear(key, MakeKey(0.0f, 3.0f, 4.0f, 5.0f, 0.25f), 1.0e-6f));
+}
+
+BRE_TEST(ClosedLoopIsContinuous) {
+	// Square loop that ends where it starts
+	CameraPath path;
+	path.AddKey(MakeKey(0.0f, 0.0f, 0.0f, 0.0f, 0.0f));
+	path.AddKey(MakeKey(1.0f, 10.0f, 0.0f, 0.0f, 1.0f));
+	path.AddKey(MakeKey(2.0f, 10.0f, 0.0f, 10.0f, 2.0f));
+	path.AddKey(MakeKey(3.0f, 0.0f, 0.0f, 10.0f, 1.0f));
+	path.AddKey(MakeKey(4.0f, 0.0f, 0.0f, 0.0f, 0.0f));
+
+	CameraPath::Key start;
+	CameraPath::Key end;
+	path.Evaluate(path.StartTime(), start);
+	path.Evaluate(path.StartTime() + path.Duration(), end);
+	BRE_CHECK(KeysAreNear(start, end, 1.0e-6f));
+
+	// No jumps along the loop or across every key
+	const float timeStep = 0.001f;
+	CameraPath::Key previous = start;
+	bool continuous = true;
+	for (float time = timeStep; time <= path.Duration(); time += timeStep) {
+		CameraPath::Key key;
+		path.Evaluate(time, key);
+		continuous = continuous && KeysAreNear(key, previous, 0.05f);
+		previous = key;
+	}
+	BRE_CHECK(continuous);
+	BRE_CHECK(KeysAreNear(previous, end, 0.05f));
+
+	// Tangents match on both sides of the interior keys
+	for (float keyTime = 1.0f; keyTime < 4.0f; keyTime += 1.0f) {
+		CameraPath::Key before;
+		CameraPath::Key at;
+		CameraPath::Key after;
+		path.Evaluate(keyTime - 0.001f, before);
+		path.Evaluate(keyTime, at);
+		path.Evaluate(keyTime + 0.001f, after);
+		for (size_t c = 0U; c < 3U; ++c) {
+			BRE_CHECK_NEAR(at.mTranslation[c] - before.mTranslation[c], after.mTranslation[c] - at.mTranslation[c], 2.0e-4f);
+		}
+	}
+}
\ No newline at end of file
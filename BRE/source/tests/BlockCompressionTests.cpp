@@ -0,0 +1,246 @@
+#include "TestFramework.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <textures/BlockCompression.h>
+#include <textures/DdsFile.h>
+#include <textures/Image.h>
+
+using namespace BRE;
+
+namespace {
+	// Files are written under the test working directory
+	const char* sDdsFilepath = "BlockCompressionTests.dds";
+
+	std::uint8_t ToByte(const float value) {
+		return static_cast<std::uint8_t>(std::lround(std::fmin(std::fmax(value, 0.0f), 255.0f)));
+	}
+
+	// Smooth gradients and waves in every channel, plus noise of the given amplitude
+	Image SyntheticImage(const unsigned int width, const unsigned int height, const float noise) {
+		std::mt19937 generator(5U);
+		std::uniform_real_distribution<float> distribution(-noise, noise);
+		Image image(width, height);
+		for (unsigned int y = 0U; y < height; ++y) {
+			for (unsigned int x = 0U; x < width; ++x) {
+				const float u = static_cast<float>(x) / width;
+				const float v = static_cast<float>(y) / height;
+				std::uint8_t* texel = image.Texel(x, y);
+				texel[0] = ToByte(255.0f * u + distribution(generator));
+				texel[1] = ToByte(255.0f * v + distribution(generator));
+				texel[2] = ToByte(127.5f + 120.0f * std::sin(6.0f * u + 4.0f * v) + distribution(generator));
+				texel[3] = ToByte(255.0f * (1.0f - 0.5f * (u + v)) + distribution(generator));
+			}
+		}
+		return image;
+	}
+
+	// Tangent space normals of a bumpy surface, Z is not stored by BC5
+	Image NormalMap(const unsigned int width, const unsigned int height) {
+		Image image(width, height);
+		for (unsigned int y = 0U; y < height; ++y) {
+			for (unsigned int x = 0U; x < width; ++x) {
+				const float dx = 0.6f * std::cos(0.3f * x) * std::sin(0.2f * y);
+				const float dy = 0.6f * std::sin(0.3f * x) * std::cos(0.2f * y);
+				const float length = std::sqrt(dx * dx + dy * dy + 1.0f);
+				std::uint8_t* texel = image.Texel(x, y);
+				texel[0] = ToByte((dx / length * 0.5f + 0.5f) * 255.0f);
+				texel[1] = ToByte((dy / length * 0.5f + 0.5f) * 255.0f);
+				texel[2] = ToByte((1.0f / length * 0.5f + 0.5f) * 255.0f);
+				texel[3] = 255U;
+			}
+		}
+		return image;
+	}
+
+	double RoundTripPsnr(const BlockFormat format, const Image& image, const unsigned int channelMask) {
+		std::vector<std::uint8_t> blocks;
+		BlockCompression::Encode(format, image, blocks);
+		Image decoded;
+		BlockCompression::Decode(format, blocks.data(), image.mWidth, image.mHeight, decoded);
+		return BlockCompression::Psnr(image, decoded, channelMask);
+	}
+
+	std::uint32_t ReadUint32(const std::vector<std::uint8_t>& bytes, const size_t offset) {
+		std::uint32_t value = 0U;
+		std::memcpy(&value, &bytes[offset], sizeof(value));
+		return value;
+	}
+}
+
+BRE_TEST(FormatsDescribeTheirBlocks) {
+	BRE_CHECK(BlockCompression::BlockSize(BlockFormat::BC1) == 8U);
+	BRE_CHECK(BlockCompression::BlockSize(BlockFormat::BC4) == 8U);
+	BRE_CHECK(BlockCompression::BlockSize(BlockFormat::BC5) == 16U);
+	BRE_CHECK(BlockCompression::BlockSize(BlockFormat::BC7) == 16U);
+	BRE_CHECK(BlockCompression::ChannelMask(BlockFormat::BC1) == 0x7U);
+	BRE_CHECK(BlockCompression::ChannelMask(BlockFormat::BC4) == 0x1U);
+	BRE_CHECK(BlockCompression::ChannelMask(BlockFormat::BC5) == 0x3U);
+	BRE_CHECK(BlockCompression::ChannelMask(BlockFormat::BC7) == 0xFU);
+	BRE_CHECK(std::strcmp(BlockCompression::Name(BlockFormat::BC7), "BC7") == 0);
+}
+
+BRE_TEST(PsnrOfEqualImagesIsInfinite) {
+	const Image image = SyntheticImage(8U, 8U, 0.0f);
+	BRE_CHECK(BlockCompression::Psnr(image, image, 0xFU) == std::numeric_limits<double>::infinity());
+
+	// A single channel off by 1 everywhere: 10 * log10(255^2)
+	Image shifted = image;
+	for (size_t i = 0U; i < shifted.mData.size(); i += Image::sNumChannels) {
+		shifted.mData[i] = image.mData[i] == 255U ? 254U : static_cast<std::uint8_t>(image.mData[i] + 1U);
+	}
+	BRE_CHECK_NEAR(BlockCompression::Psnr(image, shifted, 0x1U), 48.13, 0.01);
+	BRE_CHECK(BlockCompression::Psnr(image, shifted, 0x2U) == std::numeric_limits<double>::infinity());
+}
+
+BRE_TEST(SolidBlocksRoundTrip) {
+	const std::uint8_t color[] = { 200U, 100U, 50U, 255U };
+	std::uint8_t texels[BlockCompression::sTexelsPerBlock * Image::sNumChannels];
+	for (unsigned int i = 0U; i < BlockCompression::sTexelsPerBlock; ++i) {
+		std::memcpy(&texels[i * Image::sNumChannels], color, Image::sNumChannels);
+	}
+	const BlockFormat formats[] = { BlockFormat::BC1, BlockFormat::BC4, BlockFormat::BC5, BlockFormat::BC7 };
+	for (const BlockFormat format : formats) {
+		std::uint8_t block[16];
+		std::uint8_t decoded[BlockCompression::sTexelsPerBlock * Image::sNumChannels];
+		BlockCompression::EncodeBlock(format, texels, block);
+		BlockCompression::DecodeBlock(format, block, decoded);
+		const unsigned int channelMask = BlockCompression::ChannelMask(format);
+		// BC1 endpoints are 565. The BC7 mode 6 p-bit is shared by the
+		// channels of an endpoint, so 255 (odd) and 200 (even) are 1 apart.
+		const int tolerance = format == BlockFormat::BC1 ? 4 : (format == BlockFormat::BC7 ? 1 : 0);
+		bool texelsMatch = true;
+		for (unsigned int i = 0U; i < BlockCompression::sTexelsPerBlock * Image::sNumChannels; ++i) {
+			if ((channelMask & (1U << (i % Image::sNumChannels))) != 0U) {
+				texelsMatch = texelsMatch && std::abs(decoded[i] - texels[i]) <= tolerance;
+			}
+		}
+		BRE_CHECK(texelsMatch);
+	}
+}
+
+BRE_TEST(RoundTripPsnrIsAboveThresholds) {
+	const Image smooth = SyntheticImage(64U, 64U, 0.0f);
+	const Image noisy = SyntheticImage(64U, 64U, 24.0f);
+	const Image normals = NormalMap(64U, 64U);
+
+	BRE_CHECK(RoundTripPsnr(BlockFormat::BC1, smooth, 0x7U) > 35.0);
+	BRE_CHECK(RoundTripPsnr(BlockFormat::BC1, noisy, 0x7U) > 26.0);
+	BRE_CHECK(RoundTripPsnr(BlockFormat::BC4, smooth, 0x1U) > 49.0);
+	BRE_CHECK(RoundTripPsnr(BlockFormat::BC4, noisy, 0x1U) > 42.0);
+	BRE_CHECK(RoundTripPsnr(BlockFormat::BC5, normals, 0x3U) > 42.0);
+	BRE_CHECK(RoundTripPsnr(BlockFormat::BC5, noisy, 0x3U) > 42.0);
+	BRE_CHECK(RoundTripPsnr(BlockFormat::BC7, smooth, 0xFU) > 39.0);
+	BRE_CHECK(RoundTripPsnr(BlockFormat::BC7, noisy, 0xFU) > 26.0);
+
+	// BC7 is the higher quality color format
+	BRE_CHECK(RoundTripPsnr(BlockFormat::BC7, smooth, 0x7U) > RoundTripPsnr(BlockFormat::BC1, smooth, 0x7U));
+}
+
+BRE_TEST(BordersAreClamped) {
+	// 10x6 is encoded as 3x2 blocks
+	const Image image = SyntheticImage(10U, 6U, 0.0f);
+	std::vector<std::uint8_t> blocks;
+	BlockCompression::Encode(BlockFormat::BC4, image, blocks);
+	BRE_CHECK(blocks.size() == 3U * 2U * 8U);
+	Image decoded;
+	BlockCompression::Decode(BlockFormat::BC4, blocks.data(), 10U, 6U, decoded);
+	BRE_CHECK(decoded.mWidth == 10U && decoded.mHeight == 6U);
+
+	// Same blocks as the image padded to 12x8 by repeating its last row and column
+	Image padded(12U, 8U);
+	for (unsigned int y = 0U; y < 8U; ++y) {
+		for (unsigned int x = 0U; x < 12U; ++x) {
+			std::memcpy(padded.Texel(x, y), image.Texel(std::min(x, 9U), std::min(y, 5U)), Image::sNumChannels);
+		}
+	}
+	std::vector<std::uint8_t> paddedBlocks;
+	BlockCompression::Encode(BlockFormat::BC4, padded, paddedBlocks);
+	BRE_CHECK(blocks == paddedBlocks);
+	// Missing channels decode as 0 (color) and 255 (alpha)
+	BRE_CHECK(decoded.Texel(9U, 5U)[1] == 0U && decoded.Texel(9U, 5U)[2] == 0U && decoded.Texel(9U, 5U)[3] == 255U);
+}
+
+BRE_TEST(DdsHeaderDescribesTheBlocks) {
+	const BlockFormat formats[] = { BlockFormat::BC1, BlockFormat::BC4, BlockFormat::BC5, BlockFormat::BC7 };
+	const std::uint32_t dxgiFormats[] = { 71U, 80U, 83U, 98U };
+	for (size_t f = 0U; f < 4U; ++f) {
+		const BlockFormat format = formats[f];
+		BRE_CHECK(BlockCompression::DxgiFormat(format) == dxgiFormats[f]);
+
+		// 16x8 top level and its mips down to 1x1 (blocks are never smaller than 4x4)
+		const Image image = SyntheticImage(16U, 8U, 0.0f);
+		std::vector<Image> mips;
+		ImageUtils::GenerateMips(image, mips);
+		BRE_CHECK(mips.size() == 5U);
+		std::vector<std::vector<std::uint8_t>> levels(mips.size());
+		size_t dataSize = 0U;
+		for (size_t i = 0U; i < mips.size(); ++i) {
+			BlockCompression::Encode(format, mips[i], levels[i]);
+			dataSize += levels[i].size();
+		}
+		const size_t blockSize = BlockCompression::BlockSize(format);
+		BRE_CHECK(levels[0].size() == 4U * 2U * blockSize);
+		BRE_CHECK(levels[4].size() == blockSize);
+
+		std::string error;
+		BRE_CHECK(DdsFile::WriteBlockCompressed(sDdsFilepath, format, 16U, 8U, levels, error));
+		std::ifstream stream(sDdsFilepath, std::ios::binary);
+		const std::vector<std::uint8_t> bytes((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+		// Magic, header (124 bytes), DX10 header (20 bytes), then every level
+		BRE_CHECK(bytes.size() == 4U + 124U + 20U + dataSize);
+		if (bytes.size() < 4U + 124U + 20U) {
+			continue;
+		}
+		BRE_CHECK(ReadUint32(bytes, 0U) == 0x20534444U);
+		BRE_CHECK(ReadUint32(bytes, 4U) == 124U);
+		// Caps, height, width, pixel format, mip map count and linear size
+		BRE_CHECK(ReadUint32(bytes, 8U) == (0x1U | 0x2U | 0x4U | 0x1000U | 0x20000U | 0x80000U));
+		BRE_CHECK(ReadUint32(bytes, 12U) == 8U);
+		BRE_CHECK(ReadUint32(bytes, 16U) == 16U);
+		BRE_CHECK(ReadUint32(bytes, 20U) == levels[0].size());
+		BRE_CHECK(ReadUint32(bytes, 28U) == 5U);
+		// Pixel format: size, FourCC flag and "DX10"
+		BRE_CHECK(ReadUint32(bytes, 76U) == 32U);
+		BRE_CHECK(ReadUint32(bytes, 80U) == 0x4U);
+		BRE_CHECK(ReadUint32(bytes, 84U) == 0x30315844U);
+		// Texture, complex and mip map caps
+		BRE_CHECK(ReadUint32(bytes, 108U) == (0x1000U | 0x8U | 0x400000U));
+		// DX10 header: DXGI format, 2D texture, no flags, 1 array slice
+		BRE_CHECK(ReadUint32(bytes, 128U) == dxgiFormats[f]);
+		BRE_CHECK(ReadUint32(bytes, 132U) == 3U);
+		BRE_CHECK(ReadUint32(bytes, 136U) == 0U);
+		BRE_CHECK(ReadUint32(bytes, 140U) == 1U);
+		BRE_CHECK(std::memcmp(&bytes[148U], levels[0].data(), levels[0].size()) == 0);
+	}
+}
+
+BRE_TEST(SingleLevelDdsHasNoMipFlags) {
+	const Image image = SyntheticImage(4U, 4U, 0.0f);
+	std::vector<std::vector<std::uint8_t>> levels(1U);
+	BlockCompression::Encode(BlockFormat::BC1, image, levels[0]);
+	std::string error;
+	BRE_CHECK(DdsFile::WriteBlockCompressed(sDdsFilepath, BlockFormat::BC1, 4U, 4U, levels, error));
+	std::ifstream stream(sDdsFilepath, std::ios::binary);
+	const std::vector<std::uint8_t> bytes((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+	BRE_CHECK(bytes.size() == 4U + 124U + 20U + 8U);
+	if (bytes.size() == 4U + 124U + 20U + 8U) {
+		BRE_CHECK((ReadUint32(bytes, 8U) & 0x20000U) == 0U);
+		BRE_CHECK(ReadUint32(bytes, 28U) == 1U);
+		BRE_CHECK(ReadUint32(bytes, 108U) == 0x1000U);
+	}
+
+	// Paths that cannot be created fail with an error
+	error.clear();
+	BRE_CHECK(!DdsFile::WriteBlockCompressed("BlockCompressionTestsMissingDirectory/texture.dds", BlockFormat::BC1, 4U, 4U, levels, error));
+	BRE_CHECK(!error.empty());
+}
\ No newline at end of file
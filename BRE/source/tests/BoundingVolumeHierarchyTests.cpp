@@ -0,0 +1,236 @@
+#include "TestFramework.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include <general/JobSystem.h>
+#include <general/Profiler.h>
+#include <rendering/BoundingVolumeHierarchy.h>
+
+using namespace BRE;
+using namespace DirectX;
+
+namespace {
+	typedef BoundingVolumeHierarchy::Aabb Aabb;
+
+	// Installs the profiler (and a job system with threads) while they live
+	class ScopedJobSystem {
+	public:
+		explicit ScopedJobSystem(const unsigned int numThreads) {
+			Profiler::gInstance = &mProfiler;
+			if (numThreads > 0U) {
+				JobSystem::gInstance = new JobSystem(numThreads);
+			}
+		}
+
+		~ScopedJobSystem() {
+			delete JobSystem::gInstance;
+			JobSystem::gInstance = nullptr;
+			Profiler::gInstance = nullptr;
+		}
+
+	private:
+		Profiler mProfiler;
+	};
+
+	bool SameObjects(std::vector<std::uint32_t> a, std::vector<std::uint32_t> b) {
+		std::sort(a.begin(), a.end());
+		std::sort(b.begin(), b.end());
+		return a == b;
+	}
+
+	bool HasDuplicates(std::vector<std::uint32_t> objects) {
+		std::sort(objects.begin(), objects.end());
+		return std::adjacent_find(objects.begin(), objects.end()) != objects.end();
+	}
+
+	Aabb RandomSphereBounds(std::mt19937& generator) {
+		std::uniform_real_distribution<float> position(-500.0f, 500.0f);
+		std::uniform_real_distribution<float> radius(0.1f, 5.0f);
+		return BoundingVolumeHierarchy::SphereBounds(XMFLOAT4(position(generator), position(generator), position(generator), radius(generator)));
+	}
+
+	bool IntersectsSphere(const Aabb& aabb, const XMFLOAT4& sphere) {
+		const float x = (std::max)({ aabb.mMin.x - sphere.x, sphere.x - aabb.mMax.x, 0.0f });
+		const float y = (std::max)({ aabb.mMin.y - sphere.y, sphere.y - aabb.mMax.y, 0.0f });
+		const float z = (std::max)({ aabb.mMin.z - sphere.z, sphere.z - aabb.mMax.z, 0.0f });
+		return x * x + y * y + z * z <= sphere.w * sphere.w;
+	}
+
+	bool IntersectsAabb(const Aabb& a, const Aabb& b) {
+		return a.mMin.x <= b.mMax.x && a.mMax.x >= b.mMin.x && a.mMin.y <= b.mMax.y && a.mMax.y >= b.mMin.y && a.mMin.z <= b.mMax.z && a.mMax.z >= b.mMin.z;
+	}
+
+	// Slab test in doubles
+	bool IntersectsRay(const Aabb& aabb, const XMFLOAT3& origin, const XMFLOAT3& direction, const float maxDistance) {
+		const double origins[3] = { origin.x, origin.y, origin.z };
+		const double directions[3] = { direction.x, direction.y, direction.z };
+		const double mins[3] = { aabb.mMin.x, aabb.mMin.y, aabb.mMin.z };
+		const double maxs[3] = { aabb.mMax.x, aabb.mMax.y, aabb.mMax.z };
+		double tMin = 0.0;
+		double tMax = maxDistance;
+		for (size_t axis = 0U; axis < 3U; ++axis) {
+			if (directions[axis] == 0.0) {
+				if (origins[axis] < mins[axis] || origins[axis] > maxs[axis]) {
+					return false;
+				}
+				continue;
+			}
+			const double t0 = (mins[axis] - origins[axis]) / directions[axis];
+			const double t1 = (maxs[axis] - origins[axis]) / directions[axis];
+			tMin = (std::max)(tMin, (std::min)(t0, t1));
+			tMax = (std::min)(tMax, (std::max)(t0, t1));
+		}
+		return tMin <= tMax;
+	}
+
+	// Inside or crossing the six planes of the view projection matrix
+	bool IntersectsFrustumPlanes(const Aabb& aabb, const XMFLOAT4X4& viewProj) {
+		for (size_t iPlane = 0U; iPlane < 6U; ++iPlane) {
+			float plane[4];
+			for (size_t row = 0U; row < 4U; ++row) {
+				const float* m = viewProj.m[row];
+				const float planes[6] = { m[3] + m[0], m[3] - m[0], m[3] + m[1], m[3] - m[1], m[2], m[3] - m[2] };
+				plane[row] = planes[iPlane];
+			}
+			// Corner furthest along the plane normal
+			const float x = plane[0] >= 0.0f ? aabb.mMax.x : aabb.mMin.x;
+			const float y = plane[1] >= 0.0f ? aabb.mMax.y : aabb.mMin.y;
+			const float z = plane[2] >= 0.0f ? aabb.mMax.z : aabb.mMin.z;
+			if (plane[0] * x + plane[1] * y + plane[2] * z + plane[3] < 0.0f) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	// Not every corner is outside the same clip plane (in doubles). Plane tests
+	// accept some boxes near frustum edges, so this is a subset of them.
+	bool IntersectsFrustumCorners(const Aabb& aabb, const XMFLOAT4X4& viewProj) {
+		double corners[8][4];
+		for (size_t iCorner = 0U; iCorner < 8U; ++iCorner) {
+			const double position[3] = { (iCorner & 1U) ? aabb.mMax.x : aabb.mMin.x, (iCorner & 2U) ? aabb.mMax.y : aabb.mMin.y, (iCorner & 4U) ? aabb.mMax.z : aabb.mMin.z };
+			for (size_t column = 0U; column < 4U; ++column) {
+				corners[iCorner][column] = position[0] * viewProj.m[0][column] + position[1] * viewProj.m[1][column] + position[2] * viewProj.m[2][column] + viewProj.m[3][column];
+			}
+		}
+		for (size_t iPlane = 0U; iPlane < 6U; ++iPlane) {
+			bool allOutside = true;
+			for (size_t iCorner = 0U; iCorner < 8U && allOutside; ++iCorner) {
+				const double* c = corners[iCorner];
+				const double distances[6] = { c[3] + c[0], c[3] - c[0], c[3] + c[1], c[3] - c[1], c[2], c[3] - c[2] };
+				allOutside = distances[iPlane] < 0.0;
+			}
+			if (allOutside) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	const unsigned int sNumThreads[] = { 0U, 3U };
+	const size_t sSizes[] = { 0U, 1U, 4U, 5U, 17U, 100U, 5000U, 40000U };
+}
+
+BRE_TEST(QueriesMatchBruteForce) {
+	std::mt19937 generator(3U);
+	std::uniform_real_distribution<float> position(-500.0f, 500.0f);
+	for (const unsigned int numThreads : sNumThreads) {
+		ScopedJobSystem jobSystem(numThreads);
+		for (const size_t size : sSizes) {
+			std::vector<Aabb> bounds(size);
+			for (Aabb& aabb : bounds) {
+				aabb = RandomSphereBounds(generator);
+			}
+			// Objects with the same bounds
+			for (size_t i = 1U; i < (std::min)(size, static_cast<size_t>(10U)); ++i) {
+				bounds[i] = bounds[0U];
+			}
+			BoundingVolumeHierarchy bvh;
+			bvh.Build(bounds);
+			BRE_CHECK(bvh.NumObjects() == size);
+
+			// Built, a third of the objects moved, and a few of them moved
+			for (unsigned int round = 0U; round < 3U; ++round) {
+				if (round > 0U) {
+					for (size_t i = 0U; i < size; i += (round == 1U ? 3U : 97U)) {
+						bounds[i] = RandomSphereBounds(generator);
+						bvh.SetBounds(i, bounds[i]);
+					}
+					bvh.Refit();
+				}
+				size_t numWrongBounds = 0U;
+				for (size_t i = 0U; i < size; ++i) {
+					numWrongBounds += memcmp(&bvh.Bounds(i), &bounds[i], sizeof(Aabb)) != 0 ? 1U : 0U;
+				}
+				BRE_CHECK(numWrongBounds == 0U);
+
+				for (unsigned int query = 0U; query < 20U; ++query) {
+					std::vector<std::uint32_t> objects;
+					std::vector<std::uint32_t> expectedObjects;
+
+					const XMFLOAT4 sphere(position(generator), position(generator), position(generator), std::fabs(position(generator)) * 0.3f);
+					bvh.QuerySphere(sphere, objects);
+					for (std::uint32_t i = 0U; i < size; ++i) {
+						if (IntersectsSphere(bounds[i], sphere)) {
+							expectedObjects.push_back(i);
+						}
+					}
+					BRE_CHECK(SameObjects(objects, expectedObjects));
+
+					objects.clear();
+					expectedObjects.clear();
+					Aabb aabb;
+					aabb.mMin = XMFLOAT3(position(generator), position(generator), position(generator));
+					aabb.mMax = XMFLOAT3(aabb.mMin.x + 200.0f, aabb.mMin.y + 100.0f, aabb.mMin.z + 300.0f);
+					bvh.QueryAabb(aabb, objects);
+					for (std::uint32_t i = 0U; i < size; ++i) {
+						if (IntersectsAabb(bounds[i], aabb)) {
+							expectedObjects.push_back(i);
+						}
+					}
+					BRE_CHECK(SameObjects(objects, expectedObjects));
+					BRE_CHECK(!HasDuplicates(objects));
+
+					// Some rays are parallel to the XY plane
+					objects.clear();
+					expectedObjects.clear();
+					const XMFLOAT3 origin(position(generator), position(generator), position(generator));
+					XMFLOAT3 direction(position(generator), position(generator), (query % 4U) == 0U ? 0.0f : position(generator));
+					const float length = std::sqrt(direction.x * direction.x + direction.y * direction.y + direction.z * direction.z);
+					direction = XMFLOAT3(direction.x / length, direction.y / length, direction.z / length);
+					bvh.QueryRay(origin, direction, 800.0f, objects);
+					for (std::uint32_t i = 0U; i < size; ++i) {
+						if (IntersectsRay(bounds[i], origin, direction, 800.0f)) {
+							expectedObjects.push_back(i);
+						}
+					}
+					BRE_CHECK(SameObjects(objects, expectedObjects));
+
+					// Camera at the ray origin looking down +Z
+					objects.clear();
+					const XMMATRIX viewProj = XMMatrixTranslation(-origin.x, -origin.y, -origin.z) * XMMatrixPerspectiveFovLH(0.8f + query * 0.05f, 1.5f, 1.0f, 300.0f + query * 20.0f);
+					XMFLOAT4X4 viewProjMatrix;
+					XMStoreFloat4x4(&viewProjMatrix, viewProj);
+					bvh.QueryFrustum(viewProj, objects);
+					BRE_CHECK(!HasDuplicates(objects));
+					std::vector<bool> found(size, false);
+					for (const std::uint32_t object : objects) {
+						found[object] = true;
+					}
+					size_t numMissedObjects = 0U;
+					size_t numPlaneObjects = 0U;
+					for (std::uint32_t i = 0U; i < size; ++i) {
+						numMissedObjects += (IntersectsFrustumCorners(bounds[i], viewProjMatrix) && !found[i]) ? 1U : 0U;
+						numPlaneObjects += IntersectsFrustumPlanes(bounds[i], viewProjMatrix) ? 1U : 0U;
+					}
+					BRE_CHECK(numMissedObjects == 0U);
+					BRE_CHECK(numPlaneObjects == objects.size());
+				}
+			}
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,189 @@
+#include "TestFramework.h"
+
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <utils/ConcurrentRegistry.h>
+
+using namespace BRE;
+
+namespace {
+	template<typename Function>
+	void RunThreads(const unsigned int numThreads, Function&& function) {
+		std::vector<std::thread> threads;
+		for (unsigned int thread = 0U; thread < numThreads; ++thread) {
+			threads.emplace_back(function, thread);
+		}
+		for (std::thread& thread : threads) {
+			thread.join();
+		}
+	}
+
+	// Path hashes are multiples of small primes more often than not
+	size_t IdOf(const size_t index) {
+		return index * 101U;
+	}
+}
+
+BRE_TEST(ValuesAreCreatedOnce) {
+	ConcurrentRegistry<size_t> registry(4U);
+	size_t value = 0U;
+	BRE_CHECK(!registry.Find(IdOf(1U), value));
+
+	bool created = false;
+	BRE_CHECK(registry.GetOrCreate(IdOf(1U), []() { return 11U; }, &created) == 11U);
+	BRE_CHECK(created);
+	BRE_CHECK(registry.GetOrCreate(IdOf(1U), []() { return 12U; }, &created) == 11U);
+	BRE_CHECK(!created);
+	BRE_CHECK(registry.Find(IdOf(1U), value));
+	BRE_CHECK(value == 11U);
+
+	BRE_CHECK(registry.Insert(IdOf(2U), 22U));
+	BRE_CHECK(!registry.Insert(IdOf(2U), 23U));
+	BRE_CHECK(!registry.Insert(IdOf(1U), 23U));
+	BRE_CHECK(registry.Find(IdOf(2U), value));
+	BRE_CHECK(value == 22U);
+	BRE_CHECK(registry.Size() == 2U);
+}
+
+BRE_TEST(TablesGrowWithoutLosingEntries) {
+	ConcurrentRegistry<size_t> registry(4U);
+	const size_t numIds = 5000U;
+	for (size_t i = 0U; i < numIds; ++i) {
+		BRE_CHECK(registry.Insert(IdOf(i), i));
+	}
+	BRE_CHECK(registry.Size() == numIds);
+	for (size_t i = 0U; i < numIds; ++i) {
+		size_t value = 0U;
+		BRE_CHECK(registry.Find(IdOf(i), value));
+		BRE_CHECK(value == i);
+	}
+	size_t numVisited = 0U;
+	registry.ForEach([&](const size_t id, const size_t value) {
+		BRE_CHECK(id == IdOf(value));
+		++numVisited;
+	});
+	BRE_CHECK(numVisited == numIds);
+}
+
+BRE_TEST(FailedCreationsAreRetried) {
+	ConcurrentRegistry<size_t> registry;
+	bool threw = false;
+	try {
+		registry.GetOrCreate(IdOf(3U), []() -> size_t { throw std::runtime_error("cannot create"); });
+	}
+	catch (const std::runtime_error&) {
+		threw = true;
+	}
+	BRE_CHECK(threw);
+	size_t value = 0U;
+	BRE_CHECK(!registry.Find(IdOf(3U), value));
+	BRE_CHECK(registry.Size() == 0U);
+	registry.ForEach([](const size_t, const size_t) { BRE_CHECK(false); });
+
+	bool created = false;
+	BRE_CHECK(registry.GetOrCreate(IdOf(3U), []() { return 33U; }, &created) == 33U);
+	BRE_CHECK(created);
+	BRE_CHECK(registry.Find(IdOf(3U), value));
+	BRE_CHECK(value == 33U);
+	BRE_CHECK(registry.Size() == 1U);
+
+	// Failed entries can be inserted too
+	try {
+		registry.GetOrCreate(IdOf(4U), []() -> size_t { throw std::runtime_error("cannot create"); });
+	}
+	catch (const std::runtime_error&) {
+	}
+	BRE_CHECK(registry.Insert(IdOf(4U), 44U));
+	BRE_CHECK(registry.Find(IdOf(4U), value));
+	BRE_CHECK(value == 44U);
+}
+
+BRE_TEST(WaitingRequestsRetryFailedCreations) {
+	for (unsigned int round = 0U; round < 20U; ++round) {
+		ConcurrentRegistry<size_t> registry;
+		std::atomic<unsigned int> numCreations(0U);
+		std::atomic<unsigned int> numFailures(0U);
+		std::atomic<unsigned int> numCreated(0U);
+		// The first creation waits for the others to queue up, then throws
+		RunThreads(8U, [&](const unsigned int) {
+			try {
+				bool created = false;
+				const size_t value = registry.GetOrCreate(IdOf(5U), [&]() -> size_t {
+					if (numCreations.fetch_add(1U) == 0U) {
+						std::this_thread::sleep_for(std::chrono::milliseconds(2));
+						throw std::runtime_error("cannot create");
+					}
+					return 55U;
+				}, &created);
+				BRE_CHECK(value == 55U);
+				if (created) {
+					++numCreated;
+				}
+			}
+			catch (const std::runtime_error&) {
+				++numFailures;
+			}
+		});
+		// Only the failed request sees the exception, and no request is left waiting
+		BRE_CHECK(numFailures.load() == 1U);
+		BRE_CHECK(numCreated.load() == 1U);
+		BRE_CHECK(numCreations.load() == 2U);
+		size_t value = 0U;
+		BRE_CHECK(registry.Find(IdOf(5U), value));
+		BRE_CHECK(value == 55U);
+	}
+}
+
+BRE_TEST(ConcurrentRequestsAreCoalesced) {
+	for (unsigned int round = 0U; round < 10U; ++round) {
+		ConcurrentRegistry<size_t> registry(4U);
+		const size_t numIds = 2000U;
+		std::atomic<unsigned int> numCreations(0U);
+		std::atomic<unsigned int> numBadValues(0U);
+		RunThreads(16U, [&](const unsigned int thread) {
+			std::mt19937 generator(thread * 77U + round);
+			for (unsigned int i = 0U; i < 5000U; ++i) {
+				const size_t id = IdOf(generator() % numIds);
+				const bool fail = (generator() % 16U) == 0U;
+				try {
+					const size_t value = registry.GetOrCreate(id, [&]() -> size_t {
+						if (fail) {
+							throw std::runtime_error("cannot create");
+						}
+						++numCreations;
+						if ((generator() % 8U) == 0U) {
+							std::this_thread::yield();
+						}
+						return id * 3U + 1U;
+					});
+					if (value != id * 3U + 1U) {
+						++numBadValues;
+					}
+				}
+				catch (const std::runtime_error&) {
+				}
+				size_t value;
+				if (registry.Find(id, value) && value != id * 3U + 1U) {
+					++numBadValues;
+				}
+			}
+		});
+		BRE_CHECK(numBadValues.load() == 0U);
+
+		size_t numFound = 0U;
+		for (size_t i = 0U; i < numIds; ++i) {
+			size_t value;
+			if (registry.Find(IdOf(i), value)) {
+				++numFound;
+			}
+		}
+		// Every created value is kept (no creation was lost or repeated)
+		BRE_CHECK(numCreations.load() == numFound);
+		BRE_CHECK(registry.Size() == numFound);
+	}
+}
\ No newline at end of file
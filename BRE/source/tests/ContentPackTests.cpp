@@ -0,0 +1,245 @@
+#include "TestFramework.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <common/FileUtils.h>
+#include <contentPacker/ContentPacker.h>
+#include <managers/VirtualFileSystem.h>
+#include <streaming/ContentPack.h>
+
+using namespace BRE;
+
+namespace {
+	// Content is written under the test working directory
+	const char* sRootDirectory = "ContentPackTestsRoot";
+	const char* sPlainPack = "plain.pack";
+	const char* sCompressedPack = "compressed.pack";
+	const unsigned int sBlockSize = 4096U;
+
+	struct File {
+		const char* mContentPath;
+		std::vector<std::uint8_t> mData;
+	};
+
+	void WriteFile(const File& file) {
+		const std::string path = FileUtils::NativePath(sRootDirectory, file.mContentPath);
+		FileUtils::CreateDirectories(FileUtils::Directory(path));
+		std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+		stream.write(reinterpret_cast<const char*>(file.mData.data()), static_cast<std::streamsize>(file.mData.size()));
+	}
+
+	// Text (compressible), noise (incompressible), a large compressible file
+	// split in many blocks, a duplicate and an empty file
+	const std::vector<File>& Files() {
+		static std::vector<File> files;
+		if (!files.empty()) {
+			return files;
+		}
+		std::mt19937 generator(13U);
+		File text = { "content\\configs\\settings.yml", {} };
+		for (unsigned int i = 0U; i < 200U; ++i) {
+			const std::string line = "key" + std::to_string(i % 17U) + ": value\n";
+			text.mData.insert(text.mData.end(), line.begin(), line.end());
+		}
+		File noise = { "content\\textures\\noise.dds", std::vector<std::uint8_t>(300000U) };
+		for (std::uint8_t& value : noise.mData) {
+			value = static_cast<std::uint8_t>(generator());
+		}
+		File gradient = { "content\\textures\\Gradient.DDS", std::vector<std::uint8_t>(200000U) };
+		for (size_t i = 0U; i < gradient.mData.size(); ++i) {
+			gradient.mData[i] = static_cast<std::uint8_t>((i / 64U) + ((generator() % 16U) == 0U ? 1U : 0U));
+		}
+		File duplicate = { "content\\dup\\settings.yml", text.mData };
+		File empty = { "content\\configs\\empty.yml", {} };
+		files = { text, noise, gradient, duplicate, empty };
+		return files;
+	}
+
+	void WritePacks() {
+		static bool written = false;
+		if (written) {
+			return;
+		}
+		written = true;
+		for (const File& file : Files()) {
+			WriteFile(file);
+		}
+
+		ContentPacker::Settings settings;
+		settings.mRootDirectory = sRootDirectory;
+		settings.mDirectories.push_back("content");
+		settings.mBlockSize = sBlockSize;
+		settings.mVerify = true;
+		std::ostringstream log;
+		ContentPacker::Result result;
+		BRE_CHECK(ContentPacker::Pack(settings, sPlainPack, log, result));
+		BRE_CHECK(result.mNumFiles == Files().size());
+		BRE_CHECK(result.mNumDuplicates == 1U);
+		BRE_CHECK(result.mNumCompressed == 0U);
+
+		settings.mCompress = true;
+		BRE_CHECK(ContentPacker::Pack(settings, sCompressedPack, log, result));
+		BRE_CHECK(result.mNumDuplicates == 1U);
+		// Text and gradient shrink, noise does not (and empty files are never compressed)
+		BRE_CHECK(result.mNumCompressed == 2U);
+		BRE_CHECK(result.mPackBytes < result.mInputBytes);
+	}
+
+	std::string PackPath(const char* pack) {
+		return FileUtils::NativePath(sRootDirectory, pack);
+	}
+}
+
+BRE_TEST(PathsAreNormalized) {
+	BRE_CHECK(ContentPack::NormalizePath(".\\Content\\Configs\\Settings.YML") == "content/configs/settings.yml");
+	BRE_CHECK(ContentPack::NormalizePath("content/configs/settings.yml") == "content/configs/settings.yml");
+	BRE_CHECK(ContentPack::HashPath("content/a") != ContentPack::HashPath("content/b"));
+	BRE_CHECK(ContentPack::NumBlocks(0U, sBlockSize) == 0U);
+	BRE_CHECK(ContentPack::NumBlocks(1U, sBlockSize) == 1U);
+	BRE_CHECK(ContentPack::NumBlocks(sBlockSize, sBlockSize) == 1U);
+	BRE_CHECK(ContentPack::NumBlocks(sBlockSize + 1U, sBlockSize) == 2U);
+}
+
+BRE_TEST(EntriesMatchTheirFiles) {
+	WritePacks();
+	for (const char* packName : { sPlainPack, sCompressedPack }) {
+		ContentPack pack;
+		std::string error;
+		BRE_CHECK(pack.Open(PackPath(packName), error));
+		BRE_CHECK(pack.NumEntries() == Files().size());
+		for (const File& file : Files()) {
+			size_t entry;
+			BRE_CHECK(pack.Find(file.mContentPath, entry));
+			const ContentPack::Entry& packEntry = pack.GetEntry(entry);
+			BRE_CHECK(packEntry.mSize == file.mData.size());
+			BRE_CHECK(packEntry.mOffset % 64U == 0U);
+			BRE_CHECK(ContentPack::NormalizePath(file.mContentPath) == pack.EntryName(entry));
+
+			std::vector<std::uint8_t> data(file.mData.size());
+			BRE_CHECK(pack.Read(entry, 0U, data.size(), data.data()));
+			BRE_CHECK(data == file.mData);
+
+			// Uncompressed entries are used in place
+			const bool compressed = (packEntry.mFlags & ContentPack::sCompressed) != 0U;
+			const std::uint8_t* mapped = pack.EntryData(entry);
+			BRE_CHECK(compressed == (mapped == nullptr));
+			if (mapped) {
+				BRE_CHECK(memcmp(mapped, file.mData.data(), file.mData.size()) == 0);
+			}
+		}
+
+		size_t text;
+		size_t duplicate;
+		BRE_CHECK(pack.Find(".\\CONTENT\\configs\\settings.yml", text));
+		BRE_CHECK(pack.Find("content/dup/settings.yml", duplicate));
+		BRE_CHECK(text != duplicate);
+		BRE_CHECK(pack.GetEntry(text).mOffset == pack.GetEntry(duplicate).mOffset);
+		size_t entry;
+		BRE_CHECK(!pack.Find("content\\configs\\missing.yml", entry));
+	}
+}
+
+BRE_TEST(RangesAreReadFromTheirBlocks) {
+	WritePacks();
+	std::mt19937 generator(17U);
+	for (const char* packName : { sPlainPack, sCompressedPack }) {
+		ContentPack pack;
+		std::string error;
+		BRE_CHECK(pack.Open(PackPath(packName), error));
+		for (const File& file : Files()) {
+			size_t entry;
+			BRE_CHECK(pack.Find(file.mContentPath, entry));
+			const size_t size = file.mData.size();
+			for (unsigned int i = 0U; i < 50U && size > 0U; ++i) {
+				// Ranges within a block, across blocks and ending at the end of the file
+				const size_t offset = generator() % size;
+				const size_t maxBytes = (i % 2U) == 0U ? sBlockSize : size;
+				const size_t bytes = generator() % (std::min(maxBytes, size - offset) + 1U);
+				std::vector<std::uint8_t> data(bytes);
+				BRE_CHECK(pack.Read(entry, offset, bytes, data.data()));
+				BRE_CHECK(std::equal(data.begin(), data.end(), file.mData.begin() + offset));
+			}
+			std::uint8_t value;
+			BRE_CHECK(!pack.Read(entry, size, 1U, &value));
+		}
+	}
+}
+
+BRE_TEST(FileSystemPrefersLaterPacksAndLooseFiles) {
+	WritePacks();
+	VirtualFileSystem fileSystem;
+	std::string error;
+	BRE_CHECK(!fileSystem.Mount(PackPath("missing.pack"), error));
+	BRE_CHECK(!error.empty());
+	BRE_CHECK(fileSystem.Mount(PackPath(sPlainPack), error));
+	BRE_CHECK(fileSystem.Mount(PackPath(sCompressedPack), error));
+	BRE_CHECK(fileSystem.NumPacks() == 2U);
+
+	const File& gradient = Files()[2U];
+	std::vector<std::uint8_t> data;
+	BRE_CHECK(fileSystem.ReadFile(gradient.mContentPath, data));
+	BRE_CHECK(data == gradient.mData);
+	size_t size = 0U;
+	BRE_CHECK(fileSystem.FileSize(gradient.mContentPath, size));
+	BRE_CHECK(size == gradient.mData.size());
+	// The compressed pack, mounted last, hides the plain one
+	BRE_CHECK(fileSystem.MappedData(gradient.mContentPath, size) == nullptr);
+
+	const File& noise = Files()[1U];
+	const std::uint8_t* mapped = fileSystem.MappedData(noise.mContentPath, size);
+	BRE_CHECK(mapped != nullptr);
+	BRE_CHECK(size == noise.mData.size());
+
+	// Paths in no pack are read from loose files
+	const std::string loosePath = std::string(sRootDirectory) + "\\content\\configs\\settings.yml";
+	BRE_CHECK(fileSystem.Exists(loosePath));
+	BRE_CHECK(fileSystem.ReadFile(loosePath, data));
+	BRE_CHECK(data == Files()[0U].mData);
+	BRE_CHECK(!fileSystem.Exists("content\\configs\\missing.yml"));
+	BRE_CHECK(!fileSystem.ReadFile("content\\configs\\missing.yml", data));
+}
+
+BRE_TEST(CorruptedPacksAreRejectedOrReadSafely) {
+	WritePacks();
+	std::vector<std::uint8_t> original;
+	BRE_CHECK(FileUtils::ReadFile(PackPath(sCompressedPack), original));
+	const std::string corruptedPath = PackPath("corrupted.pack");
+	std::mt19937 generator(19U);
+	for (unsigned int i = 0U; i < 40U; ++i) {
+		// Header, entry table and names are at the start and the end of the pack
+		std::vector<std::uint8_t> corrupted(original);
+		for (unsigned int j = 0U; j < 4U; ++j) {
+			corrupted[generator() % 256U] ^= static_cast<std::uint8_t>(1U + generator() % 255U);
+			corrupted[corrupted.size() - 1U - generator() % 512U] ^= static_cast<std::uint8_t>(1U + generator() % 255U);
+			corrupted[generator() % corrupted.size()] ^= static_cast<std::uint8_t>(1U + generator() % 255U);
+		}
+		if ((i % 4U) == 0U) {
+			corrupted.resize(generator() % corrupted.size());
+		}
+		{
+			std::ofstream stream(corruptedPath, std::ios::binary | std::ios::trunc);
+			stream.write(reinterpret_cast<const char*>(corrupted.data()), static_cast<std::streamsize>(corrupted.size()));
+		}
+
+		ContentPack pack;
+		std::string error;
+		if (!pack.Open(corruptedPath, error)) {
+			BRE_CHECK(!error.empty());
+			continue;
+		}
+		for (size_t entry = 0U; entry < pack.NumEntries(); ++entry) {
+			const ContentPack::Entry& packEntry = pack.GetEntry(entry);
+			if (packEntry.mSize <= original.size()) {
+				std::vector<std::uint8_t> data(static_cast<size_t>(packEntry.mSize));
+				pack.Read(entry, 0U, data.size(), data.data());
+			}
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,187 @@
+#include "TestFramework.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <managers/VirtualFileSystem.h>
+#include <streaming/DdsMipReader.h>
+
+using namespace BRE;
+
+namespace {
+	// DXGI_FORMAT values
+	const std::uint32_t sR8G8B8A8 = 28U;
+	const std::uint32_t sBC5 = 83U;
+	const std::uint32_t sBC7 = 98U;
+
+	void Write32(std::vector<std::uint8_t>& data, const size_t offset, const std::uint32_t value) {
+		for (size_t i = 0U; i < 4U; ++i) {
+			data[offset + i] = static_cast<std::uint8_t>(value >> (i * 8U));
+		}
+	}
+
+	std::uint32_t FourCC(const char* code) {
+		return static_cast<std::uint32_t>(code[0]) | (static_cast<std::uint32_t>(code[1]) << 8U) | (static_cast<std::uint32_t>(code[2]) << 16U) | (static_cast<std::uint32_t>(code[3]) << 24U);
+	}
+
+	// "DDS " and the header. Pixel format is legacy RGBA8 unless fourCC is given.
+	std::vector<std::uint8_t> MakeHeader(const unsigned int width, const unsigned int height, const unsigned int numMips, const char* fourCC) {
+		std::vector<std::uint8_t> data(4U + 124U, 0U);
+		Write32(data, 0U, FourCC("DDS "));
+		Write32(data, 4U, 124U);
+		Write32(data, 4U + 8U, height);
+		Write32(data, 4U + 12U, width);
+		Write32(data, 4U + 24U, numMips);
+		const size_t pixelFormat = 4U + 72U;
+		Write32(data, pixelFormat, 32U);
+		if (fourCC) {
+			Write32(data, pixelFormat + 4U, 0x4U);
+			Write32(data, pixelFormat + 8U, FourCC(fourCC));
+		}
+		else {
+			Write32(data, pixelFormat + 4U, 0x41U);
+			Write32(data, pixelFormat + 12U, 32U);
+			Write32(data, pixelFormat + 16U, 0x000000ffU);
+			Write32(data, pixelFormat + 20U, 0x0000ff00U);
+			Write32(data, pixelFormat + 24U, 0x00ff0000U);
+			Write32(data, pixelFormat + 28U, 0xff000000U);
+		}
+		return data;
+	}
+
+	void AppendDX10Header(std::vector<std::uint8_t>& data, const std::uint32_t format, const std::uint32_t dimension, const std::uint32_t arraySize) {
+		const size_t offset = data.size();
+		data.resize(offset + 20U, 0U);
+		Write32(data, offset, format);
+		Write32(data, offset + 4U, dimension);
+		Write32(data, offset + 12U, arraySize);
+	}
+
+	// Texel data numbered by byte, so every level has a distinct content
+	void AppendData(std::vector<std::uint8_t>& data, const size_t bytes) {
+		for (size_t i = 0U; i < bytes; ++i) {
+			data.push_back(static_cast<std::uint8_t>(i * 7U + data.size()));
+		}
+	}
+
+	std::string WriteFile(const char* name, const std::vector<std::uint8_t>& data) {
+		std::ofstream stream(name, std::ios::binary | std::ios::trunc);
+		stream.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+		return name;
+	}
+
+	// Loose files are read through the file system, with no pack mounted
+	struct FileSystemScope {
+		FileSystemScope() { VirtualFileSystem::gInstance = &mFileSystem; }
+		~FileSystemScope() { VirtualFileSystem::gInstance = nullptr; }
+
+		VirtualFileSystem mFileSystem;
+	};
+}
+
+BRE_TEST(UncompressedLevelsAreLaidOutTopFirst) {
+	FileSystemScope scope;
+	// 16x8, 5 levels
+	std::vector<std::uint8_t> data = MakeHeader(16U, 8U, 5U, nullptr);
+	const size_t dataOffset = data.size();
+	AppendData(data, (16U * 8U + 8U * 4U + 4U * 2U + 2U * 1U + 1U * 1U) * 4U);
+	const std::string filepath = WriteFile("rgba.dds", data);
+
+	DdsTextureInfo info;
+	std::string error;
+	BRE_CHECK(DdsMipReader::ReadInfo(filepath, info, error));
+	BRE_CHECK(info.mWidth == 16U && info.mHeight == 8U && info.mNumMips == 5U);
+	BRE_CHECK(info.mDxgiFormat == sR8G8B8A8);
+	BRE_CHECK(info.MipWidth(4U) == 1U && info.MipHeight(4U) == 1U);
+	BRE_CHECK(info.mMipOffsets[0] == dataOffset);
+	BRE_CHECK(info.mMipSizes[1] == 8U * 4U * 4U);
+	BRE_CHECK(info.mMipRowPitches[1] == 8U * 4U);
+	BRE_CHECK(info.mMipOffsets[2] == info.mMipOffsets[1] + info.mMipSizes[1]);
+	BRE_CHECK(info.Bytes(0U) == data.size() - dataOffset);
+
+	for (unsigned int topMip = 0U; topMip < info.mNumMips; ++topMip) {
+		std::vector<std::uint8_t> mips;
+		BRE_CHECK(DdsMipReader::ReadMips(filepath, info, topMip, mips, error));
+		BRE_CHECK(mips.size() == info.Bytes(topMip));
+		BRE_CHECK(std::equal(mips.begin(), mips.end(), data.begin() + info.mMipOffsets[topMip]));
+	}
+	std::vector<std::uint8_t> mips;
+	BRE_CHECK(!DdsMipReader::ReadMips(filepath, info, info.mNumMips, mips, error));
+}
+
+BRE_TEST(BlockCompressedLevelsAreAtLeastOneBlock) {
+	FileSystemScope scope;
+	// BC7 through a DX10 header: 8x8, 4x4, 2x2 and 1x1 are 4, 1, 1 and 1 blocks
+	std::vector<std::uint8_t> data = MakeHeader(8U, 8U, 4U, "DX10");
+	AppendDX10Header(data, sBC7, 3U, 1U);
+	const size_t dataOffset = data.size();
+	AppendData(data, (4U + 1U + 1U + 1U) * 16U);
+	const std::string filepath = WriteFile("bc7.dds", data);
+
+	DdsTextureInfo info;
+	std::string error;
+	BRE_CHECK(DdsMipReader::ReadInfo(filepath, info, error));
+	BRE_CHECK(info.mDxgiFormat == sBC7);
+	BRE_CHECK(info.mMipOffsets[0] == dataOffset);
+	BRE_CHECK(info.mMipSizes[0] == 64U);
+	BRE_CHECK(info.mMipRowPitches[0] == 32U);
+	BRE_CHECK(info.mMipSizes[2] == 16U);
+	BRE_CHECK(info.mMipSizes[3] == 16U);
+
+	std::vector<std::uint8_t> mips;
+	BRE_CHECK(DdsMipReader::ReadMips(filepath, info, 2U, mips, error));
+	BRE_CHECK(mips.size() == 32U);
+	BRE_CHECK(std::equal(mips.begin(), mips.end(), data.end() - 32));
+
+	// Legacy ATI2 is BC5
+	std::vector<std::uint8_t> legacy = MakeHeader(4U, 4U, 1U, "ATI2");
+	AppendData(legacy, 16U);
+	BRE_CHECK(DdsMipReader::ReadInfo(WriteFile("bc5.dds", legacy), info, error));
+	BRE_CHECK(info.mDxgiFormat == sBC5);
+	BRE_CHECK(info.mNumMips == 1U);
+}
+
+BRE_TEST(UnsupportedFilesAreRejected) {
+	FileSystemScope scope;
+	DdsTextureInfo info;
+	std::string error;
+	BRE_CHECK(!DdsMipReader::ReadInfo("missing.dds", info, error));
+	BRE_CHECK(!error.empty());
+
+	std::vector<std::uint8_t> valid = MakeHeader(4U, 4U, 3U, nullptr);
+	AppendData(valid, (16U + 4U + 1U) * 4U);
+
+	error.clear();
+	std::vector<std::uint8_t> truncated(valid.begin(), valid.end() - 1);
+	BRE_CHECK(!DdsMipReader::ReadInfo(WriteFile("truncated.dds", truncated), info, error));
+	BRE_CHECK(!error.empty());
+
+	std::vector<std::uint8_t> header(valid.begin(), valid.begin() + 64);
+	BRE_CHECK(!DdsMipReader::ReadInfo(WriteFile("header.dds", header), info, error));
+
+	std::vector<std::uint8_t> magic(valid);
+	magic[0] = 'X';
+	BRE_CHECK(!DdsMipReader::ReadInfo(WriteFile("magic.dds", magic), info, error));
+
+	std::vector<std::uint8_t> cube(valid);
+	Write32(cube, 4U + 108U, 0x200U);
+	BRE_CHECK(!DdsMipReader::ReadInfo(WriteFile("cube.dds", cube), info, error));
+
+	std::vector<std::uint8_t> empty(valid);
+	Write32(empty, 4U + 12U, 0U);
+	BRE_CHECK(!DdsMipReader::ReadInfo(WriteFile("empty.dds", empty), info, error));
+
+	std::vector<std::uint8_t> dxt5 = MakeHeader(4U, 4U, 1U, "DXT5");
+	AppendData(dxt5, 16U);
+	BRE_CHECK(!DdsMipReader::ReadInfo(WriteFile("dxt5.dds", dxt5), info, error));
+
+	std::vector<std::uint8_t> array = MakeHeader(4U, 4U, 1U, "DX10");
+	AppendDX10Header(array, sBC7, 3U, 2U);
+	AppendData(array, 32U);
+	BRE_CHECK(!DdsMipReader::ReadInfo(WriteFile("array.dds", array), info, error));
+
+	BRE_CHECK(DdsMipReader::ReadInfo(WriteFile("valid.dds", valid), info, error));
+}
\ No newline at end of file
@@ -0,0 +1,134 @@
+#include "TestFramework.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+#include <general/FramePipeline.h>
+#include <general/Profiler.h>
+
+using namespace BRE;
+
+namespace {
+	// Installs the profiler used by the pipeline waits while it lives
+	class ScopedProfiler {
+	public:
+		ScopedProfiler() { Profiler::gInstance = &mProfiler; }
+		~ScopedProfiler() { Profiler::gInstance = nullptr; }
+
+	private:
+		Profiler mProfiler;
+	};
+
+	// Frame number and light count identify what simulation wrote
+	void WriteFrame(FrameSnapshot& frame, const std::uint64_t number) {
+		frame.mFrameRate = static_cast<unsigned int>(number);
+		frame.mNearPlaneDistance = static_cast<float>(number);
+		for (std::uint64_t i = 0U; i < number % 3U; ++i) {
+			DirectionalLightData light;
+			light.mColor.x = static_cast<float>(number);
+			frame.mDirLights.push_back(light);
+		}
+	}
+
+	bool IsFrame(const FrameSnapshot& frame, const std::uint64_t number) {
+		bool valid = frame.mFrameRate == static_cast<unsigned int>(number) && frame.mNearPlaneDistance == static_cast<float>(number) && frame.mDirLights.size() == number % 3U;
+		for (const DirectionalLightData& light : frame.mDirLights) {
+			valid = valid && light.mColor.x == static_cast<float>(number);
+		}
+		return valid;
+	}
+}
+
+BRE_TEST(FramesAreSubmittedInOrderWithinTheLatency) {
+	ScopedProfiler profiler;
+	const std::uint64_t numFrames = 20000U;
+	for (unsigned int frameLatency = 0U; frameLatency <= FramePipeline::sMaxFrameLatency; ++frameLatency) {
+		std::uint64_t nextFrame = 0U;
+		std::atomic<unsigned int> numBadFrames(0U);
+		std::uint64_t maxFramesAhead = 0U;
+		{
+			FramePipeline pipeline(frameLatency, [&](const FrameSnapshot& frame) {
+				if (!IsFrame(frame, nextFrame)) {
+					++numBadFrames;
+				}
+				++nextFrame;
+			});
+			BRE_CHECK(pipeline.FrameLatency() == frameLatency);
+			for (std::uint64_t i = 0U; i < numFrames; ++i) {
+				FrameSnapshot& frame = pipeline.BeginFrame();
+				// Slots are reused, lists are cleared
+				BRE_CHECK(frame.mDirLights.empty());
+				BRE_CHECK(&frame == &pipeline.SimulationFrame());
+				const std::uint64_t framesAhead = pipeline.NumSimulatedFrames() - pipeline.NumSubmittedFrames();
+				maxFramesAhead = framesAhead > maxFramesAhead ? framesAhead : maxFramesAhead;
+				WriteFrame(frame, i);
+				pipeline.EndFrame();
+				if (frameLatency == 0U) {
+					BRE_CHECK(pipeline.NumSubmittedFrames() == i + 1U);
+				}
+			}
+			BRE_CHECK(pipeline.NumSimulatedFrames() == numFrames);
+		}
+		// Pending frames are submitted before destruction
+		BRE_CHECK(nextFrame == numFrames);
+		BRE_CHECK(numBadFrames.load() == 0U);
+		BRE_CHECK(maxFramesAhead <= frameLatency);
+	}
+}
+
+BRE_TEST(RenderThreadSubmitsFrames) {
+	ScopedProfiler profiler;
+	const std::thread::id mainThread = std::this_thread::get_id();
+	for (unsigned int frameLatency = 0U; frameLatency <= FramePipeline::sMaxFrameLatency; ++frameLatency) {
+		std::atomic<unsigned int> numMainThreadSubmits(0U);
+		{
+			FramePipeline pipeline(frameLatency, [&](const FrameSnapshot&) {
+				if (std::this_thread::get_id() == mainThread) {
+					++numMainThreadSubmits;
+				}
+			});
+			for (unsigned int i = 0U; i < 100U; ++i) {
+				pipeline.BeginFrame();
+				pipeline.EndFrame();
+			}
+		}
+		BRE_CHECK(numMainThreadSubmits.load() == (frameLatency == 0U ? 100U : 0U));
+	}
+}
+
+BRE_TEST(SlowStagesAreWaitedFor) {
+	ScopedProfiler profiler;
+	// Simulation waits for a slow submit stage, and the render thread for a
+	// slow simulation. Both wake up when the other stage is done.
+	for (unsigned int frameLatency = 1U; frameLatency <= FramePipeline::sMaxFrameLatency; ++frameLatency) {
+		std::atomic<unsigned int> numSubmitted(0U);
+		{
+			FramePipeline pipeline(frameLatency, [&](const FrameSnapshot&) {
+				std::this_thread::sleep_for(std::chrono::microseconds(500));
+				++numSubmitted;
+			});
+			for (unsigned int i = 0U; i < 40U; ++i) {
+				pipeline.BeginFrame();
+				BRE_CHECK(pipeline.NumSimulatedFrames() - pipeline.NumSubmittedFrames() <= frameLatency);
+				if ((i % 8U) == 0U) {
+					std::this_thread::sleep_for(std::chrono::milliseconds(2));
+				}
+				pipeline.EndFrame();
+			}
+		}
+		BRE_CHECK(numSubmitted.load() == 40U);
+	}
+}
+
+BRE_TEST(IdlePipelinesAreDestroyed) {
+	ScopedProfiler profiler;
+	for (unsigned int frameLatency = 0U; frameLatency <= FramePipeline::sMaxFrameLatency; ++frameLatency) {
+		unsigned int numSubmitted = 0U;
+		{
+			FramePipeline pipeline(frameLatency, [&](const FrameSnapshot&) { ++numSubmitted; });
+		}
+		BRE_CHECK(numSubmitted == 0U);
+	}
+}
\ No newline at end of file
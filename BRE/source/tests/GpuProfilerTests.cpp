@@ -0,0 +1,193 @@
+#include "TestFramework.h"
+
+#include <cstring>
+#include <vector>
+
+#include <rendering/GpuProfiler.h>
+
+using namespace BRE;
+
+namespace {
+	// Query source whose frames become readable a fixed number of polls after
+	// they end. Pass timestamps are derived from the slot and the pass.
+	class FakeQuerySource : public GpuQuerySource {
+	public:
+		FakeQuerySource(const size_t maxSlots, const size_t maxPasses, const unsigned int latency)
+			: mMaxSlots(maxSlots)
+			, mMaxPasses(maxPasses)
+			, mLatency(latency)
+			, mPollsLeft(maxSlots, 0U)
+			, mEnded(maxSlots, false)
+		{
+		}
+
+		size_t MaxSlots() const override { return mMaxSlots; }
+		size_t MaxPasses() const override { return mMaxPasses; }
+
+		void BeginFrame(const size_t slot) override {
+			BRE_CHECK(slot < mMaxSlots);
+			BRE_CHECK(!mInFrame);
+			mInFrame = true;
+			mEnded[slot] = false;
+			++mBegunFrames;
+		}
+
+		void EndFrame(const size_t slot) override {
+			BRE_CHECK(mInFrame);
+			mInFrame = false;
+			mEnded[slot] = true;
+			mPollsLeft[slot] = mLatency;
+		}
+
+		void BeginPass(const size_t /*slot*/, const size_t pass) override {
+			BRE_CHECK(mInFrame && pass < mMaxPasses);
+		}
+
+		void EndPass(const size_t /*slot*/, const size_t pass) override {
+			BRE_CHECK(mInFrame && pass < mMaxPasses);
+		}
+
+		bool ReadFrame(const size_t slot, const std::vector<bool>& recordedPasses, FrameData& frameData) override {
+			BRE_CHECK(mEnded[slot]);
+			if (mPollsLeft[slot] > 0U) {
+				--mPollsLeft[slot];
+				return false;
+			}
+			++mReadFrames;
+			frameData.mFrequency = mFrequency;
+			frameData.mDisjoint = mDisjoint;
+			for (size_t pass = 0U; pass < recordedPasses.size(); ++pass) {
+				if (!recordedPasses[pass]) {
+					continue;
+				}
+				GpuQuerySource::PassData& passData = frameData.mPasses[pass];
+				passData.mBegin = 1000U;
+				passData.mEnd = 1000U + (pass + 1U) * 100U;
+				std::memset(&passData.mStatistics, 0, sizeof(passData.mStatistics));
+				passData.mStatistics.mPSInvocations = pass + 1U;
+			}
+			return true;
+		}
+
+		std::uint64_t mFrequency = 100000U;
+		bool mDisjoint = false;
+		size_t mBegunFrames = 0U;
+		size_t mReadFrames = 0U;
+
+	private:
+		const size_t mMaxSlots;
+		const size_t mMaxPasses;
+		const unsigned int mLatency;
+		std::vector<unsigned int> mPollsLeft;
+		std::vector<bool> mEnded;
+		bool mInFrame = false;
+	};
+
+	void RecordFrame(GpuProfiler& profiler, const std::uint64_t frame, const size_t firstPass, const size_t numPasses) {
+		profiler.BeginFrame(frame);
+		for (size_t pass = firstPass; pass < firstPass + numPasses; ++pass) {
+			GpuProfileScope scope(profiler, pass);
+		}
+		profiler.EndFrame();
+	}
+}
+
+BRE_TEST(ResultsAreReadFramesLater) {
+	FakeQuerySource source(3U, 2U, 1U);
+	GpuProfiler profiler(source);
+	BRE_CHECK(profiler.RegisterPass("Geometry") == 0U);
+	BRE_CHECK(profiler.RegisterPass("Lighting") == 1U);
+
+	RecordFrame(profiler, 0U, 0U, 2U);
+	BRE_CHECK(profiler.ResolvedFrames() == 0U);
+	BRE_CHECK(profiler.PendingFrames() == 1U);
+	BRE_CHECK(!profiler.Passes()[0].mValid);
+
+	// First poll is not ready, second one is
+	RecordFrame(profiler, 1U, 0U, 2U);
+	BRE_CHECK(profiler.ResolvedFrames() == 0U);
+	RecordFrame(profiler, 2U, 0U, 2U);
+	BRE_CHECK(profiler.ResolvedFrames() == 1U);
+	BRE_CHECK(profiler.Frame() == 0U);
+
+	// 100 and 200 ticks at 100 kHz
+	const std::vector<GpuProfiler::PassStats>& passes = profiler.Passes();
+	BRE_CHECK(passes[0].mName == "Geometry" && passes[1].mName == "Lighting");
+	BRE_CHECK(passes[0].mValid && passes[1].mValid);
+	BRE_CHECK_NEAR(passes[0].mMs, 1.0, 1.0e-9);
+	BRE_CHECK_NEAR(passes[1].mMs, 2.0, 1.0e-9);
+	BRE_CHECK_NEAR(profiler.FrameMs(), 3.0, 1.0e-9);
+	BRE_CHECK(passes[1].mStatistics.mPSInvocations == 2U);
+	BRE_CHECK(profiler.SkippedFrames() == 0U);
+}
+
+BRE_TEST(FramesAreSkippedWhenEverySlotIsPending) {
+	FakeQuerySource source(2U, 1U, 100U);
+	GpuProfiler profiler(source);
+	profiler.RegisterPass("Pass");
+
+	for (int frame = 0; frame < 5; ++frame) {
+		RecordFrame(profiler, static_cast<std::uint64_t>(frame), 0U, 1U);
+	}
+	BRE_CHECK(source.mBegunFrames == 2U);
+	BRE_CHECK(profiler.PendingFrames() == 2U);
+	BRE_CHECK(profiler.SkippedFrames() == 3U);
+	BRE_CHECK(profiler.ResolvedFrames() == 0U);
+}
+
+BRE_TEST(SlotsAreResolvedInSubmissionOrder) {
+	FakeQuerySource source(4U, 1U, 0U);
+	GpuProfiler profiler(source);
+	profiler.RegisterPass("Pass");
+
+	for (int frame = 0; frame < 10; ++frame) {
+		RecordFrame(profiler, static_cast<std::uint64_t>(frame), 0U, 1U);
+		BRE_CHECK(profiler.PendingFrames() == 1U);
+	}
+	// Every frame but the last one was read while the next one began
+	BRE_CHECK(profiler.ResolvedFrames() == 9U);
+	BRE_CHECK(profiler.Frame() == 8U);
+	BRE_CHECK(source.mReadFrames == 9U);
+}
+
+BRE_TEST(PassesNotRecordedAreInvalid) {
+	FakeQuerySource source(2U, 2U, 0U);
+	GpuProfiler profiler(source);
+	profiler.RegisterPass("Always");
+	profiler.RegisterPass("Sometimes");
+
+	RecordFrame(profiler, 0U, 0U, 1U);
+	RecordFrame(profiler, 1U, 0U, 2U);
+	BRE_CHECK(profiler.ResolvedFrames() == 1U);
+	BRE_CHECK(profiler.Passes()[0].mValid);
+	BRE_CHECK(!profiler.Passes()[1].mValid);
+	BRE_CHECK_NEAR(profiler.FrameMs(), 1.0, 1.0e-9);
+
+	RecordFrame(profiler, 2U, 0U, 1U);
+	BRE_CHECK(profiler.Passes()[1].mValid);
+	BRE_CHECK_NEAR(profiler.FrameMs(), 3.0, 1.0e-9);
+}
+
+BRE_TEST(DisjointFramesAreDiscarded) {
+	FakeQuerySource source(2U, 1U, 0U);
+	GpuProfiler profiler(source);
+	profiler.RegisterPass("Pass");
+
+	RecordFrame(profiler, 0U, 0U, 1U);
+	source.mDisjoint = true;
+	RecordFrame(profiler, 1U, 0U, 1U);
+	BRE_CHECK(profiler.DisjointFrames() == 1U);
+	BRE_CHECK(profiler.ResolvedFrames() == 0U);
+	BRE_CHECK(!profiler.Passes()[0].mValid);
+
+	source.mDisjoint = false;
+	source.mFrequency = 0U;
+	RecordFrame(profiler, 2U, 0U, 1U);
+	BRE_CHECK(profiler.DisjointFrames() == 2U);
+
+	source.mFrequency = 1000U;
+	RecordFrame(profiler, 3U, 0U, 1U);
+	BRE_CHECK(profiler.ResolvedFrames() == 1U);
+	BRE_CHECK(profiler.Frame() == 2U);
+	BRE_CHECK_NEAR(profiler.FrameMs(), 100.0, 1.0e-9);
+}
@@ -0,0 +1,126 @@
+#include "TestFramework.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include <utils/ImpostorLayout.h>
+
+using namespace BRE;
+using namespace DirectX;
+
+namespace {
+	float Dot(const XMFLOAT3& a, const XMFLOAT3& b) {
+		return a.x * b.x + a.y * b.y + a.z * b.z;
+	}
+
+	XMFLOAT3 Cross(const XMFLOAT3& a, const XMFLOAT3& b) {
+		return XMFLOAT3(a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x);
+	}
+
+	// Unit direction, uniform in the cube directions
+	XMFLOAT3 RandomDirection(std::mt19937& generator) {
+		std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+		for (;;) {
+			const XMFLOAT3 direction(distribution(generator), distribution(generator), distribution(generator));
+			const float length = std::sqrt(Dot(direction, direction));
+			if (length > 1.0e-3f) {
+				return XMFLOAT3(direction.x / length, direction.y / length, direction.z / length);
+			}
+		}
+	}
+
+	bool Overlap(const ImpostorLayout::AtlasPacker::Rect& a, const ImpostorLayout::AtlasPacker::Rect& b) {
+		return a.mPage == b.mPage && a.mX < b.mX + b.mSize && b.mX < a.mX + a.mSize && a.mY < b.mY + b.mSize && b.mY < a.mY + a.mSize;
+	}
+}
+
+BRE_TEST(OctahedralEncodingRoundTrips) {
+	std::mt19937 generator(5U);
+	for (unsigned int i = 0U; i < 10000U; ++i) {
+		const XMFLOAT3 direction = RandomDirection(generator);
+		const XMFLOAT2 encoded = ImpostorLayout::OctahedralEncode(direction);
+		BRE_CHECK(encoded.x >= 0.0f && encoded.x <= 1.0f && encoded.y >= 0.0f && encoded.y <= 1.0f);
+		BRE_CHECK(Dot(ImpostorLayout::OctahedralDecode(encoded), direction) > 0.99999f);
+	}
+}
+
+BRE_TEST(NearestFrameIsTheNearest) {
+	std::mt19937 generator(7U);
+	for (const unsigned int framesPerSide : { 2U, 4U, 8U, 16U }) {
+		for (unsigned int i = 0U; i < 2000U; ++i) {
+			const XMFLOAT3 direction = RandomDirection(generator);
+			// The direction does not need to be normalized
+			unsigned int x;
+			unsigned int y;
+			ImpostorLayout::NearestFrame(XMFLOAT3(direction.x * 3.0f, direction.y * 3.0f, direction.z * 3.0f), framesPerSide, x, y);
+			BRE_CHECK(x < framesPerSide && y < framesPerSide);
+
+			float bestCosine = -1.0f;
+			for (unsigned int frameY = 0U; frameY < framesPerSide; ++frameY) {
+				for (unsigned int frameX = 0U; frameX < framesPerSide; ++frameX) {
+					bestCosine = (std::max)(bestCosine, Dot(ImpostorLayout::FrameDirection(frameX, frameY, framesPerSide), direction));
+				}
+			}
+			BRE_CHECK(Dot(ImpostorLayout::FrameDirection(x, y, framesPerSide), direction) >= bestCosine - 1.0e-5f);
+		}
+	}
+}
+
+BRE_TEST(FrameBasisIsLeftHanded) {
+	for (const unsigned int framesPerSide : { 2U, 8U }) {
+		for (unsigned int y = 0U; y < framesPerSide; ++y) {
+			for (unsigned int x = 0U; x < framesPerSide; ++x) {
+				const XMFLOAT3 direction = ImpostorLayout::FrameDirection(x, y, framesPerSide);
+				BRE_CHECK_NEAR(Dot(direction, direction), 1.0f, 1.0e-5f);
+				const ImpostorLayout::FrameBasis basis = ImpostorLayout::ComputeFrameBasis(direction);
+				BRE_CHECK_NEAR(Dot(basis.mRight, basis.mRight), 1.0f, 1.0e-5f);
+				BRE_CHECK_NEAR(Dot(basis.mUp, basis.mUp), 1.0f, 1.0e-5f);
+				BRE_CHECK_NEAR(Dot(basis.mRight, basis.mUp), 0.0f, 1.0e-5f);
+				BRE_CHECK_NEAR(Dot(basis.mRight, basis.mForward), 0.0f, 1.0e-5f);
+				// The camera looks at the model center
+				BRE_CHECK(Dot(basis.mForward, direction) < -0.99999f);
+				BRE_CHECK(Dot(Cross(basis.mRight, basis.mUp), basis.mForward) > 0.9999f);
+			}
+		}
+	}
+}
+
+BRE_TEST(AtlasRectsDoNotOverlap) {
+	const unsigned int pageSize = 2048U;
+	const unsigned int maxPages = 2U;
+	ImpostorLayout::AtlasPacker packer(pageSize, maxPages);
+	const unsigned int sizes[] = { 1024U, 512U, 256U, 1024U, 128U, 512U, 2048U, 256U, 1024U };
+	std::mt19937 generator(11U);
+	std::vector<ImpostorLayout::AtlasPacker::Rect> rects;
+	for (unsigned int i = 0U; i < 200U; ++i) {
+		ImpostorLayout::AtlasPacker::Rect rect;
+		const unsigned int size = sizes[generator() % (sizeof(sizes) / sizeof(sizes[0]))];
+		if (packer.Allocate(size, rect)) {
+			BRE_CHECK(rect.mSize == size);
+			rects.push_back(rect);
+		}
+	}
+	BRE_CHECK(!rects.empty());
+	BRE_CHECK(packer.NumPages() <= maxPages);
+	for (size_t i = 0U; i < rects.size(); ++i) {
+		const ImpostorLayout::AtlasPacker::Rect& rect = rects[i];
+		BRE_CHECK(rect.mX + rect.mSize <= pageSize && rect.mY + rect.mSize <= pageSize && rect.mPage < maxPages);
+		for (size_t j = i + 1U; j < rects.size(); ++j) {
+			BRE_CHECK(!Overlap(rect, rects[j]));
+		}
+	}
+}
+
+BRE_TEST(AtlasPacksEqualSizesTightly) {
+	ImpostorLayout::AtlasPacker packer(1024U, 1U);
+	ImpostorLayout::AtlasPacker::Rect rect;
+	BRE_CHECK(!packer.Allocate(2048U, rect));
+	unsigned int numRects = 0U;
+	while (packer.Allocate(256U, rect)) {
+		++numRects;
+	}
+	BRE_CHECK(numRects == 16U);
+	BRE_CHECK(packer.NumPages() == 1U);
+}
\ No newline at end of file
@@ -0,0 +1,167 @@
+#include "TestFramework.h"
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <general/JobSystem.h>
+#include <general/Profiler.h>
+
+using namespace BRE;
+
+namespace {
+	// Installs the profiler used by waits and named jobs while it lives
+	class ScopedProfiler {
+	public:
+		ScopedProfiler() { Profiler::gInstance = &mProfiler; }
+		~ScopedProfiler() { Profiler::gInstance = nullptr; }
+
+	private:
+		Profiler mProfiler;
+	};
+
+	const unsigned int sNumThreads[] = { 1U, 2U, 4U, 8U };
+}
+
+BRE_TEST(ParallelForCoversTheRangeOnce) {
+	ScopedProfiler profiler;
+	const size_t sizes[] = { 0U, 1U, 7U, 1000U, 100000U };
+	const size_t grainSizes[] = { 1U, 3U, 64U, 5000U };
+	for (const unsigned int numThreads : sNumThreads) {
+		JobSystem jobSystem(numThreads);
+		BRE_CHECK(jobSystem.NumThreads() == numThreads);
+		BRE_CHECK(jobSystem.WorkerIndex() == 0);
+		for (const size_t size : sizes) {
+			for (const size_t grainSize : grainSizes) {
+				std::vector<std::atomic<unsigned int>> hits(size);
+				for (std::atomic<unsigned int>& hit : hits) {
+					hit = 0U;
+				}
+				std::atomic<unsigned int> numLargeRanges(0U);
+				jobSystem.ParallelFor(0U, size, grainSize, [&](const size_t begin, const size_t end) {
+					if (end - begin > grainSize) {
+						++numLargeRanges;
+					}
+					for (size_t i = begin; i < end; ++i) {
+						++hits[i];
+					}
+				}, "ParallelForCoversTheRangeOnce");
+				BRE_CHECK(numLargeRanges.load() == 0U);
+				unsigned int numBadHits = 0U;
+				for (const std::atomic<unsigned int>& hit : hits) {
+					numBadHits += hit.load() != 1U ? 1U : 0U;
+				}
+				BRE_CHECK(numBadHits == 0U);
+			}
+		}
+	}
+}
+
+BRE_TEST(NestedParallelFors) {
+	ScopedProfiler profiler;
+	for (const unsigned int numThreads : sNumThreads) {
+		JobSystem jobSystem(numThreads);
+		std::atomic<size_t> total(0U);
+		jobSystem.ParallelFor(0U, 64U, 1U, [&](const size_t begin, const size_t end) {
+			for (size_t i = begin; i < end; ++i) {
+				jobSystem.ParallelFor(0U, 1000U, 10U, [&](const size_t innerBegin, const size_t innerEnd) { total += innerEnd - innerBegin; });
+			}
+		});
+		BRE_CHECK(total.load() == 64000U);
+	}
+}
+
+BRE_TEST(JobsStartAfterTheirDependencies) {
+	ScopedProfiler profiler;
+	for (const unsigned int numThreads : sNumThreads) {
+		JobSystem jobSystem(numThreads);
+		std::atomic<unsigned int> numBadOrders(0U);
+		for (unsigned int round = 0U; round < 200U; ++round) {
+			JobCounter first;
+			JobCounter second;
+			JobCounter third;
+			std::atomic<unsigned int> stage(0U);
+			std::atomic<unsigned int> numFirstJobs(0U);
+			for (unsigned int i = 0U; i < 10U; ++i) {
+				jobSystem.Run([&]() {
+					numBadOrders += stage.load() != 0U ? 1U : 0U;
+					++numFirstJobs;
+				}, &first);
+			}
+			jobSystem.Run([&]() {
+				numBadOrders += numFirstJobs.load() != 10U ? 1U : 0U;
+				stage = 1U;
+			}, &second, &first, "Second");
+			jobSystem.Run([&]() {
+				numBadOrders += stage.load() != 1U ? 1U : 0U;
+				stage = 2U;
+			}, &third, &second);
+			jobSystem.Wait(third);
+			BRE_CHECK(stage.load() == 2U);
+			// Counters are destroyed right after they are done
+			BRE_CHECK(first.IsDone() && second.IsDone());
+		}
+		BRE_CHECK(numBadOrders.load() == 0U);
+	}
+}
+
+BRE_TEST(OtherThreadsRunJobs) {
+	ScopedProfiler profiler;
+	for (const unsigned int numThreads : sNumThreads) {
+		JobSystem jobSystem(numThreads);
+		std::atomic<unsigned int> total(0U);
+		std::atomic<unsigned int> numWorkerThreads(0U);
+		std::vector<std::thread> threads;
+		for (unsigned int thread = 0U; thread < 4U; ++thread) {
+			threads.emplace_back([&]() {
+				numWorkerThreads += jobSystem.WorkerIndex() != -1 ? 1U : 0U;
+				for (unsigned int round = 0U; round < 50U; ++round) {
+					JobCounter counter;
+					for (unsigned int i = 0U; i < 20U; ++i) {
+						jobSystem.Run([&]() { ++total; }, &counter);
+					}
+					jobSystem.Wait(counter);
+				}
+				jobSystem.ParallelFor(0U, 1000U, 10U, [&](const size_t begin, const size_t end) { total += static_cast<unsigned int>(end - begin); });
+			});
+		}
+		for (std::thread& thread : threads) {
+			thread.join();
+		}
+		BRE_CHECK(numWorkerThreads.load() == 0U);
+		BRE_CHECK(total.load() == 4U * (50U * 20U + 1000U));
+	}
+}
+
+BRE_TEST(JobsReuseTheirPool) {
+	// Many more jobs than a pool block, with captures that own memory
+	ScopedProfiler profiler;
+	for (const unsigned int numThreads : sNumThreads) {
+		JobSystem jobSystem(numThreads);
+		std::atomic<size_t> totalLength(0U);
+		for (unsigned int round = 0U; round < 20U; ++round) {
+			JobCounter counter;
+			for (unsigned int i = 0U; i < 2000U; ++i) {
+				const std::string text(static_cast<size_t>(i % 64U), 'x');
+				jobSystem.Run([&totalLength, text]() { totalLength += text.size(); }, &counter);
+			}
+			jobSystem.Wait(counter);
+		}
+		size_t expectedLength = 0U;
+		for (unsigned int i = 0U; i < 2000U; ++i) {
+			expectedLength += i % 64U;
+		}
+		BRE_CHECK(totalLength.load() == 20U * expectedLength);
+	}
+}
+
+BRE_TEST(JobSystemsAreRecreated) {
+	ScopedProfiler profiler;
+	for (unsigned int round = 0U; round < 50U; ++round) {
+		JobSystem jobSystem(3U);
+		std::atomic<size_t> total(0U);
+		jobSystem.ParallelFor(0U, 100U, 1U, [&](const size_t begin, const size_t end) { total += end - begin; });
+		BRE_CHECK(total.load() == 100U);
+	}
+}
\ No newline at end of file
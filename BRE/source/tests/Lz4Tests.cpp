@@ -0,0 +1,99 @@
+#include "TestFramework.h"
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <utils/Lz4.h>
+
+using namespace BRE;
+
+namespace {
+	enum class Content {
+		Random,
+		Sparse,
+		Repeated,
+	};
+
+	std::vector<std::uint8_t> MakeData(const size_t size, const Content content, std::mt19937& generator) {
+		static const char sPattern[] = "abcabcabdxyz";
+		std::vector<std::uint8_t> data(size);
+		for (size_t i = 0U; i < size; ++i) {
+			switch (content) {
+			case Content::Random:
+				data[i] = static_cast<std::uint8_t>(generator());
+				break;
+			case Content::Sparse:
+				data[i] = (generator() % 4U) == 0U ? static_cast<std::uint8_t>(i % 37U) : 0U;
+				break;
+			case Content::Repeated:
+				data[i] = static_cast<std::uint8_t>(sPattern[i % (sizeof(sPattern) - 1U)]);
+				break;
+			}
+		}
+		return data;
+	}
+}
+
+BRE_TEST(BlocksRoundTrip) {
+	std::mt19937 generator(7U);
+	for (unsigned int i = 0U; i < 90U; ++i) {
+		// Tiny blocks (literals only) first, then up to 200 KB
+		const size_t size = i < 20U ? i : generator() % 200000U;
+		const std::vector<std::uint8_t> data = MakeData(size, static_cast<Content>(i % 3U), generator);
+		std::vector<std::uint8_t> compressed(Lz4::CompressBound(size));
+		const size_t compressedSize = Lz4::Compress(data.data(), size, compressed.data(), compressed.size());
+		BRE_CHECK(compressedSize > 0U);
+		BRE_CHECK(compressedSize <= compressed.size());
+
+		std::vector<std::uint8_t> decompressed(size);
+		BRE_CHECK(Lz4::Decompress(compressed.data(), compressedSize, decompressed.data(), size));
+		BRE_CHECK(decompressed == data);
+		if (size > 0U) {
+			// The decompressed size must be exact
+			BRE_CHECK(!Lz4::Decompress(compressed.data(), compressedSize, decompressed.data(), size - 1U));
+		}
+	}
+}
+
+BRE_TEST(RepeatedDataShrinks) {
+	std::mt19937 generator(3U);
+	const std::vector<std::uint8_t> data = MakeData(64U * 1024U, Content::Repeated, generator);
+	std::vector<std::uint8_t> compressed(Lz4::CompressBound(data.size()));
+	const size_t compressedSize = Lz4::Compress(data.data(), data.size(), compressed.data(), compressed.size());
+	BRE_CHECK(compressedSize > 0U);
+	BRE_CHECK(compressedSize < data.size() / 50U);
+}
+
+BRE_TEST(SmallCapacityFails) {
+	std::mt19937 generator(5U);
+	const std::vector<std::uint8_t> data = MakeData(4096U, Content::Sparse, generator);
+	std::vector<std::uint8_t> compressed(Lz4::CompressBound(data.size()));
+	const size_t compressedSize = Lz4::Compress(data.data(), data.size(), compressed.data(), compressed.size());
+	BRE_CHECK(compressedSize > 1U);
+	std::vector<std::uint8_t> small(compressedSize - 1U);
+	BRE_CHECK(Lz4::Compress(data.data(), data.size(), small.data(), small.size()) == 0U);
+}
+
+BRE_TEST(CorruptedBlocksStayInBounds) {
+	std::mt19937 generator(11U);
+	for (unsigned int i = 0U; i < 30U; ++i) {
+		const size_t size = 1U + generator() % 20000U;
+		const std::vector<std::uint8_t> data = MakeData(size, static_cast<Content>(i % 3U), generator);
+		std::vector<std::uint8_t> compressed(Lz4::CompressBound(size));
+		compressed.resize(Lz4::Compress(data.data(), size, compressed.data(), compressed.size()));
+
+		// Decoding must fail or succeed without touching memory out of the
+		// buffers (checked by sanitizers and by the guard bytes)
+		for (unsigned int j = 0U; j < 20U; ++j) {
+			std::vector<std::uint8_t> corrupted(compressed);
+			corrupted[generator() % corrupted.size()] ^= static_cast<std::uint8_t>(1U + generator() % 255U);
+			const size_t corruptedSize = (j % 2U) == 0U ? corrupted.size() : generator() % corrupted.size();
+			std::vector<std::uint8_t> decompressed(size + 16U, 0xCDU);
+			Lz4::Decompress(corrupted.data(), corruptedSize, decompressed.data(), size);
+			for (size_t k = size; k < decompressed.size(); ++k) {
+				BRE_CHECK(decompressed[k] == 0xCDU);
+			}
+		}
+	}
+}
\ No newline at end of file
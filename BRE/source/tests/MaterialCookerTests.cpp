@@ -0,0 +1,108 @@
+#include "TestFramework.h"
+
+#include <cstdint>
+
+#include <materialCooker/MaterialCooker.h>
+#include <textures/Image.h>
+
+using namespace BRE;
+
+namespace {
+	// Only R is used by the packing. G and B are set to values it must not copy.
+	Image MakeScalar(const unsigned int width, const unsigned int height, std::uint8_t(*value)(const unsigned int x, const unsigned int y)) {
+		Image image(width, height);
+		for (unsigned int y = 0U; y < height; ++y) {
+			for (unsigned int x = 0U; x < width; ++x) {
+				std::uint8_t* texel = image.Texel(x, y);
+				texel[0] = value(x, y);
+				texel[1] = 17U;
+				texel[2] = 33U;
+				texel[3] = 0U;
+			}
+		}
+		return image;
+	}
+
+	std::uint8_t SmoothnessValue(const unsigned int x, const unsigned int y) { return static_cast<std::uint8_t>(x * 10U + y); }
+	std::uint8_t MetalMaskValue(const unsigned int x, const unsigned int) { return static_cast<std::uint8_t>(100U + x); }
+	std::uint8_t CurvatureValue(const unsigned int, const unsigned int y) { return static_cast<std::uint8_t>(200U + y); }
+	std::uint8_t Uniform200(const unsigned int, const unsigned int) { return 200U; }
+	std::uint8_t Uniform50(const unsigned int, const unsigned int) { return 50U; }
+	// Black left column, white right one
+	std::uint8_t Edge(const unsigned int x, const unsigned int) { return x == 0U ? 0U : 255U; }
+}
+
+BRE_TEST(ChannelsArePlacedInRGB) {
+	const Image smoothness = MakeScalar(4U, 3U, &SmoothnessValue);
+	const Image metalMask = MakeScalar(4U, 3U, &MetalMaskValue);
+	const Image curvature = MakeScalar(4U, 3U, &CurvatureValue);
+	Image packed;
+	MaterialCooker::PackSmoothnessMetalMaskCurvature(smoothness, metalMask, curvature, false, packed);
+	BRE_CHECK(packed.mWidth == 4U && packed.mHeight == 3U);
+
+	bool texelsMatch = true;
+	for (unsigned int y = 0U; y < 3U; ++y) {
+		for (unsigned int x = 0U; x < 4U; ++x) {
+			const std::uint8_t* texel = packed.Texel(x, y);
+			texelsMatch = texelsMatch
+				&& texel[0] == SmoothnessValue(x, y)
+				&& texel[1] == MetalMaskValue(x, y)
+				&& texel[2] == CurvatureValue(x, y)
+				&& texel[3] == 255U;
+		}
+	}
+	BRE_CHECK(texelsMatch);
+}
+
+BRE_TEST(RoughnessIsInvertedToSmoothness) {
+	const Image roughness = MakeScalar(4U, 3U, &SmoothnessValue);
+	const Image metalMask = MakeScalar(4U, 3U, &MetalMaskValue);
+	const Image curvature = MakeScalar(4U, 3U, &CurvatureValue);
+	Image packed;
+	MaterialCooker::PackSmoothnessMetalMaskCurvature(roughness, metalMask, curvature, true, packed);
+
+	bool texelsMatch = true;
+	for (unsigned int y = 0U; y < 3U; ++y) {
+		for (unsigned int x = 0U; x < 4U; ++x) {
+			const std::uint8_t* texel = packed.Texel(x, y);
+			texelsMatch = texelsMatch
+				&& texel[0] == 255U - SmoothnessValue(x, y)
+				&& texel[1] == MetalMaskValue(x, y)
+				&& texel[2] == CurvatureValue(x, y);
+		}
+	}
+	BRE_CHECK(texelsMatch);
+
+	// Fully rough is fully matte and the other way around
+	Image edge = MakeScalar(2U, 1U, &Edge);
+	MaterialCooker::PackSmoothnessMetalMaskCurvature(edge, edge, edge, true, packed);
+	BRE_CHECK(packed.Texel(0U, 0U)[0] == 255U && packed.Texel(1U, 0U)[0] == 0U);
+	BRE_CHECK(packed.Texel(0U, 0U)[1] == 0U && packed.Texel(1U, 0U)[1] == 255U);
+}
+
+BRE_TEST(MismatchedSizesAreResizedToTheLargest) {
+	const Image smoothness = MakeScalar(4U, 4U, &Uniform200);
+	const Image metalMask = MakeScalar(2U, 8U, &Uniform50);
+	const Image curvature = MakeScalar(2U, 1U, &Edge);
+	Image packed;
+	MaterialCooker::PackSmoothnessMetalMaskCurvature(smoothness, metalMask, curvature, false, packed);
+	BRE_CHECK(packed.mWidth == 4U && packed.mHeight == 8U);
+	BRE_CHECK(packed.mData.size() == 4U * 8U * Image::sNumChannels);
+
+	// Uniform inputs stay uniform and the edge is resampled along X only
+	bool texelsMatch = true;
+	for (unsigned int y = 0U; y < 8U; ++y) {
+		for (unsigned int x = 0U; x < 4U; ++x) {
+			const std::uint8_t* texel = packed.Texel(x, y);
+			texelsMatch = texelsMatch
+				&& texel[0] == 200U
+				&& texel[1] == 50U
+				&& texel[2] == packed.Texel(x, 0U)[2]
+				&& texel[3] == 255U;
+		}
+	}
+	BRE_CHECK(texelsMatch);
+	BRE_CHECK(packed.Texel(0U, 0U)[2] == 0U);
+	BRE_CHECK(packed.Texel(3U, 0U)[2] == 255U);
+	BRE_CHECK(packed.Texel(1U, 0U)[2] > 0U && packed.Texel(1U, 0U)[2] < packed.Texel(2U, 0U)[2]);
+}
\ No newline at end of file
@@ -0,0 +1,111 @@
+#include "TestFramework.h"
+
+#include <cmath>
+#include <vector>
+
+#include <rendering/models/MeshLod.h>
+
+using namespace BRE;
+using namespace DirectX;
+
+namespace {
+	struct TestMesh {
+		std::vector<XMFLOAT3> mPositions;
+		std::vector<XMFLOAT3> mNormals;
+		std::vector<XMFLOAT3> mTextureCoordinates;
+		std::vector<unsigned int> mIndices;
+	};
+
+	// Unit UV sphere with a texture coordinates seam
+	TestMesh Sphere(const unsigned int rings, const unsigned int segments) {
+		const float pi = 3.14159265f;
+		TestMesh mesh;
+		for (unsigned int ring = 0U; ring <= rings; ++ring) {
+			for (unsigned int segment = 0U; segment <= segments; ++segment) {
+				const float theta = pi * ring / rings;
+				const float phi = 2.0f * pi * (segment % segments) / segments;
+				const XMFLOAT3 position(std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi));
+				mesh.mPositions.push_back(position);
+				mesh.mNormals.push_back(position);
+				mesh.mTextureCoordinates.push_back(XMFLOAT3(static_cast<float>(segment) / segments, static_cast<float>(ring) / rings, 0.0f));
+			}
+		}
+		for (unsigned int ring = 0U; ring < rings; ++ring) {
+			for (unsigned int segment = 0U; segment < segments; ++segment) {
+				const unsigned int a = ring * (segments + 1U) + segment;
+				const unsigned int b = a + 1U;
+				const unsigned int c = a + segments + 1U;
+				const unsigned int d = c + 1U;
+				mesh.mIndices.insert(mesh.mIndices.end(), { a, b, c, b, d, c });
+			}
+		}
+		return mesh;
+	}
+}
+
+BRE_TEST(LevelsFollowTheMeshIndices) {
+	const TestMesh sphere = Sphere(64U, 128U);
+	std::vector<MeshLod> lods;
+	std::vector<unsigned int> lodIndices;
+	MeshLod::Generate(sphere.mPositions, sphere.mNormals, sphere.mTextureCoordinates, sphere.mIndices, 1.0f, lods, lodIndices);
+	BRE_CHECK(lods.size() == 5U);
+	BRE_CHECK(lods[0].mStartIndex == 0U);
+	BRE_CHECK(lods[0].mIndexCount == sphere.mIndices.size());
+	for (size_t i = 1U; i < lods.size(); ++i) {
+		BRE_CHECK(lods[i].mStartIndex == lods[i - 1U].mStartIndex + lods[i - 1U].mIndexCount);
+		BRE_CHECK(lods[i].mIndexCount <= lods[i - 1U].mIndexCount / 2U);
+		BRE_CHECK(lods[i].mMaxScreenFraction <= lods[i - 1U].mMaxScreenFraction);
+	}
+	BRE_CHECK(lods.back().mStartIndex + lods.back().mIndexCount == sphere.mIndices.size() + lodIndices.size());
+	for (const unsigned int index : lodIndices) {
+		BRE_CHECK(index < sphere.mPositions.size());
+	}
+}
+
+BRE_TEST(SmallMeshesHaveOneLevel) {
+	const TestMesh sphere = Sphere(64U, 128U);
+	const std::vector<unsigned int> indices(sphere.mIndices.begin(), sphere.mIndices.begin() + 300U);
+	std::vector<MeshLod> lods;
+	std::vector<unsigned int> lodIndices;
+	MeshLod::Generate(sphere.mPositions, sphere.mNormals, sphere.mTextureCoordinates, indices, 1.0f, lods, lodIndices);
+	BRE_CHECK(lods.size() == 1U);
+	BRE_CHECK(lodIndices.empty());
+	BRE_CHECK(MeshLod::Select(lods, 0U, 0.0f) == 0U);
+}
+
+BRE_TEST(SelectionDoesNotFlicker) {
+	const TestMesh sphere = Sphere(64U, 128U);
+	std::vector<MeshLod> lods;
+	std::vector<unsigned int> lodIndices;
+	MeshLod::Generate(sphere.mPositions, sphere.mNormals, sphere.mTextureCoordinates, sphere.mIndices, 1.0f, lods, lodIndices);
+	BRE_CHECK(lods.size() > 2U);
+
+	// Moving away and back goes through every level once each way
+	unsigned int lod = 0U;
+	unsigned int numChanges = 0U;
+	float screenFraction = 1.0f;
+	for (unsigned int i = 0U; i < 2000U; ++i) {
+		screenFraction *= 0.995f;
+		const unsigned int nextLod = MeshLod::Select(lods, lod, screenFraction);
+		BRE_CHECK(nextLod >= lod);
+		numChanges += nextLod != lod ? 1U : 0U;
+		lod = nextLod;
+	}
+	BRE_CHECK(lod == lods.size() - 1U);
+	for (unsigned int i = 0U; i < 2000U; ++i) {
+		screenFraction /= 0.995f;
+		const unsigned int nextLod = MeshLod::Select(lods, lod, screenFraction);
+		BRE_CHECK(nextLod <= lod);
+		numChanges += nextLod != lod ? 1U : 0U;
+		lod = nextLod;
+	}
+	BRE_CHECK(lod == 0U);
+	BRE_CHECK(numChanges == 2U * (lods.size() - 1U));
+
+	// Small changes around a threshold keep the level
+	const float threshold = lods[2U].mMaxScreenFraction;
+	lod = MeshLod::Select(lods, 0U, threshold * 0.8f);
+	for (unsigned int i = 0U; i < 100U; ++i) {
+		BRE_CHECK(MeshLod::Select(lods, lod, threshold * ((i % 2U) == 1U ? 1.1f : 0.9f)) == lod);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,228 @@
+#include "TestFramework.h"
+
+#include <cmath>
+#include <map>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <utils/MeshSimplifier.h>
+
+using namespace BRE;
+using namespace DirectX;
+
+namespace {
+	struct TestMesh {
+		std::vector<XMFLOAT3> mPositions;
+		std::vector<XMFLOAT3> mNormals;
+		std::vector<XMFLOAT3> mTextureCoordinates;
+		std::vector<unsigned int> mIndices;
+	};
+
+	// Unit UV sphere with a texture coordinates seam. Each pole is a ring of
+	// vertices at the same position.
+	TestMesh Sphere(const unsigned int rings, const unsigned int segments) {
+		const float pi = 3.14159265f;
+		TestMesh mesh;
+		for (unsigned int ring = 0U; ring <= rings; ++ring) {
+			for (unsigned int segment = 0U; segment <= segments; ++segment) {
+				const float theta = pi * ring / rings;
+				const float phi = 2.0f * pi * (segment % segments) / segments;
+				XMFLOAT3 position(std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi));
+				if (ring == 0U) {
+					position = XMFLOAT3(0.0f, 1.0f, 0.0f);
+				}
+				else if (ring == rings) {
+					position = XMFLOAT3(0.0f, -1.0f, 0.0f);
+				}
+				mesh.mPositions.push_back(position);
+				mesh.mNormals.push_back(position);
+				mesh.mTextureCoordinates.push_back(XMFLOAT3(static_cast<float>(segment) / segments, static_cast<float>(ring) / rings, 0.0f));
+			}
+		}
+		for (unsigned int ring = 0U; ring < rings; ++ring) {
+			for (unsigned int segment = 0U; segment < segments; ++segment) {
+				const unsigned int a = ring * (segments + 1U) + segment;
+				const unsigned int b = a + 1U;
+				const unsigned int c = a + segments + 1U;
+				const unsigned int d = c + 1U;
+				if (ring != 0U) {
+					mesh.mIndices.insert(mesh.mIndices.end(), { a, b, c });
+				}
+				if (ring != rings - 1U) {
+					mesh.mIndices.insert(mesh.mIndices.end(), { b, d, c });
+				}
+			}
+		}
+		return mesh;
+	}
+
+	// Cube of side 2 whose faces are grids with their own vertices (normal seams on every edge)
+	TestMesh FlatShadedCube(const unsigned int gridSize) {
+		TestMesh mesh;
+		for (unsigned int face = 0U; face < 6U; ++face) {
+			const unsigned int axis = face / 2U;
+			const float sign = (face % 2U) == 1U ? 1.0f : -1.0f;
+			const unsigned int firstVertex = static_cast<unsigned int>(mesh.mPositions.size());
+			for (unsigned int y = 0U; y <= gridSize; ++y) {
+				for (unsigned int x = 0U; x <= gridSize; ++x) {
+					float position[3];
+					position[axis] = sign;
+					position[(axis + 1U) % 3U] = -1.0f + 2.0f * x / gridSize;
+					position[(axis + 2U) % 3U] = -1.0f + 2.0f * y / gridSize;
+					float normal[3] = { 0.0f, 0.0f, 0.0f };
+					normal[axis] = sign;
+					mesh.mPositions.push_back(XMFLOAT3(position[0], position[1], position[2]));
+					mesh.mNormals.push_back(XMFLOAT3(normal[0], normal[1], normal[2]));
+					mesh.mTextureCoordinates.push_back(XMFLOAT3(static_cast<float>(x) / gridSize, static_cast<float>(y) / gridSize, 0.0f));
+				}
+			}
+			for (unsigned int y = 0U; y < gridSize; ++y) {
+				for (unsigned int x = 0U; x < gridSize; ++x) {
+					const unsigned int a = firstVertex + y * (gridSize + 1U) + x;
+					const unsigned int b = a + 1U;
+					const unsigned int c = a + gridSize + 1U;
+					const unsigned int d = c + 1U;
+					if (sign > 0.0f) {
+						mesh.mIndices.insert(mesh.mIndices.end(), { a, b, c, b, d, c });
+					}
+					else {
+						mesh.mIndices.insert(mesh.mIndices.end(), { a, c, b, b, c, d });
+					}
+				}
+			}
+		}
+		return mesh;
+	}
+
+	// Triangles of a closed mesh around the origin that face inwards, plus
+	// edges (by position) not shared by exactly two triangles
+	size_t NumDefects(const std::vector<XMFLOAT3>& positions, const std::vector<unsigned int>& indices) {
+		typedef std::tuple<float, float, float> Position;
+		std::map<std::pair<Position, Position>, unsigned int> edgeTriangles;
+		size_t numDefects = 0U;
+		for (size_t i = 0U; i < indices.size(); i += 3U) {
+			const XMFLOAT3& a = positions[indices[i]];
+			const XMFLOAT3& b = positions[indices[i + 1U]];
+			const XMFLOAT3& c = positions[indices[i + 2U]];
+			const XMFLOAT3 ab(b.x - a.x, b.y - a.y, b.z - a.z);
+			const XMFLOAT3 ac(c.x - a.x, c.y - a.y, c.z - a.z);
+			const XMFLOAT3 normal(ab.y * ac.z - ab.z * ac.y, ab.z * ac.x - ab.x * ac.z, ab.x * ac.y - ab.y * ac.x);
+			const XMFLOAT3 center((a.x + b.x + c.x) / 3.0f, (a.y + b.y + c.y) / 3.0f, (a.z + b.z + c.z) / 3.0f);
+			numDefects += normal.x * center.x + normal.y * center.y + normal.z * center.z < 0.0f ? 1U : 0U;
+			for (size_t k = 0U; k < 3U; ++k) {
+				const XMFLOAT3& u = positions[indices[i + k]];
+				const XMFLOAT3& v = positions[indices[i + (k + 1U) % 3U]];
+				const Position pu(u.x, u.y, u.z);
+				const Position pv(v.x, v.y, v.z);
+				++edgeTriangles[pu < pv ? std::make_pair(pu, pv) : std::make_pair(pv, pu)];
+			}
+		}
+		for (const auto& edge : edgeTriangles) {
+			numDefects += edge.second != 2U ? 1U : 0U;
+		}
+		return numDefects;
+	}
+}
+
+BRE_TEST(ClosedMeshesStayClosed) {
+	const TestMesh sphere = Sphere(32U, 64U);
+	BRE_CHECK(NumDefects(sphere.mPositions, sphere.mIndices) == 0U);
+	std::vector<unsigned int> indices = sphere.mIndices;
+	float accumulatedError = 0.0f;
+	for (unsigned int level = 1U; level <= 4U; ++level) {
+		std::vector<unsigned int> result;
+		const float error = MeshSimplifier::Simplify(sphere.mPositions, sphere.mNormals, sphere.mTextureCoordinates, indices, indices.size() / 2U, MeshSimplifier::Settings(), result);
+		accumulatedError += error;
+		BRE_CHECK(result.size() <= indices.size() / 2U);
+		BRE_CHECK(result.size() % 3U == 0U);
+		BRE_CHECK(NumDefects(sphere.mPositions, result) == 0U);
+		// The error bounds the distance to the original surface
+		BRE_CHECK(MeshSimplifier::MaxDeviation(sphere.mPositions, sphere.mIndices, result) <= accumulatedError * 1.01f + 1.0e-6f);
+		indices = result;
+	}
+}
+
+BRE_TEST(MaxErrorStopsSimplification) {
+	const TestMesh sphere = Sphere(32U, 64U);
+	MeshSimplifier::Settings settings;
+	settings.mMaxError = 0.01f;
+	std::vector<unsigned int> result;
+	const float error = MeshSimplifier::Simplify(sphere.mPositions, sphere.mNormals, sphere.mTextureCoordinates, sphere.mIndices, 0U, settings, result);
+	BRE_CHECK(error <= 0.01f);
+	BRE_CHECK(!result.empty() && result.size() < sphere.mIndices.size());
+	BRE_CHECK(MeshSimplifier::MaxDeviation(sphere.mPositions, sphere.mIndices, result) <= 0.01f * 1.01f);
+}
+
+BRE_TEST(BordersAreLocked) {
+	// Flat grid: it has no error, its area and border vertices are kept
+	const unsigned int gridSize = 32U;
+	TestMesh grid;
+	for (unsigned int y = 0U; y <= gridSize; ++y) {
+		for (unsigned int x = 0U; x <= gridSize; ++x) {
+			grid.mPositions.push_back(XMFLOAT3(static_cast<float>(x), 0.0f, static_cast<float>(y)));
+			grid.mNormals.push_back(XMFLOAT3(0.0f, 1.0f, 0.0f));
+			grid.mTextureCoordinates.push_back(XMFLOAT3(static_cast<float>(x) / gridSize, static_cast<float>(y) / gridSize, 0.0f));
+		}
+	}
+	for (unsigned int y = 0U; y < gridSize; ++y) {
+		for (unsigned int x = 0U; x < gridSize; ++x) {
+			const unsigned int a = y * (gridSize + 1U) + x;
+			grid.mIndices.insert(grid.mIndices.end(), { a, a + gridSize + 1U, a + 1U, a + 1U, a + gridSize + 1U, a + gridSize + 2U });
+		}
+	}
+
+	std::vector<unsigned int> result;
+	const float error = MeshSimplifier::Simplify(grid.mPositions, grid.mNormals, grid.mTextureCoordinates, grid.mIndices, 0U, MeshSimplifier::Settings(), result);
+	BRE_CHECK(result.size() < grid.mIndices.size() / 4U);
+	BRE_CHECK(error <= 1.0e-4f);
+	BRE_CHECK(MeshSimplifier::MaxDeviation(grid.mPositions, grid.mIndices, result) <= 1.0e-4f);
+
+	std::vector<bool> used(grid.mPositions.size(), false);
+	for (const unsigned int index : result) {
+		used[index] = true;
+	}
+	unsigned int numMissingBorderVertices = 0U;
+	for (unsigned int y = 0U; y <= gridSize; ++y) {
+		for (unsigned int x = 0U; x <= gridSize; ++x) {
+			const bool border = x == 0U || y == 0U || x == gridSize || y == gridSize;
+			numMissingBorderVertices += (border && !used[y * (gridSize + 1U) + x]) ? 1U : 0U;
+		}
+	}
+	BRE_CHECK(numMissingBorderVertices == 0U);
+
+	double area = 0.0;
+	for (size_t i = 0U; i < result.size(); i += 3U) {
+		const XMFLOAT3& a = grid.mPositions[result[i]];
+		const XMFLOAT3& b = grid.mPositions[result[i + 1U]];
+		const XMFLOAT3& c = grid.mPositions[result[i + 2U]];
+		area += 0.5 * std::fabs((b.x - a.x) * (c.z - a.z) - (c.x - a.x) * (b.z - a.z));
+	}
+	BRE_CHECK_NEAR(area, static_cast<double>(gridSize * gridSize), 1.0e-3);
+}
+
+BRE_TEST(SeamsKeepTheirSides) {
+	const TestMesh cube = FlatShadedCube(8U);
+	BRE_CHECK(NumDefects(cube.mPositions, cube.mIndices) == 0U);
+	MeshSimplifier::Settings settings;
+	settings.mMaxError = 1.0e-3f;
+	std::vector<unsigned int> result;
+	MeshSimplifier::Simplify(cube.mPositions, cube.mNormals, cube.mTextureCoordinates, cube.mIndices, 0U, settings, result);
+	BRE_CHECK(result.size() < cube.mIndices.size());
+	BRE_CHECK(NumDefects(cube.mPositions, result) == 0U);
+	BRE_CHECK(MeshSimplifier::MaxDeviation(cube.mPositions, cube.mIndices, result) <= 1.0e-4f);
+
+	// Vertices of a triangle are on the same face (same normal)
+	unsigned int numMixedTriangles = 0U;
+	for (size_t i = 0U; i < result.size(); i += 3U) {
+		const XMFLOAT3& normal = cube.mNormals[result[i]];
+		for (size_t k = 1U; k < 3U; ++k) {
+			const XMFLOAT3& other = cube.mNormals[result[i + k]];
+			if (normal.x != other.x || normal.y != other.y || normal.z != other.z) {
+				++numMixedTriangles;
+				break;
+			}
+		}
+	}
+	BRE_CHECK(numMixedTriangles == 0U);
+}
\ No newline at end of file
@@ -0,0 +1,187 @@
+#include "TestFramework.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+#include <utils/MipGenerator.h>
+
+using namespace BRE;
+
+namespace {
+	typedef std::vector<std::vector<std::uint8_t>> Levels;
+
+	float Decode(const std::uint8_t value) {
+		return value / 255.0f * 2.0f - 1.0f;
+	}
+
+	std::uint8_t Encode(const float value) {
+		return static_cast<std::uint8_t>((value * 0.5f + 0.5f) * 255.0f + 0.5f);
+	}
+
+	// Tangent space normals tilted up to 60 degrees away from +z
+	std::vector<std::uint8_t> RandomNormals(const unsigned int width, const unsigned int height) {
+		std::srand(7U);
+		std::vector<std::uint8_t> texels(width * height * MipGenerator::sNumChannels);
+		for (size_t i = 0U; i < texels.size(); i += MipGenerator::sNumChannels) {
+			const float x = (std::rand() / static_cast<float>(RAND_MAX)) * 1.4f - 0.7f;
+			const float y = (std::rand() / static_cast<float>(RAND_MAX)) * 1.4f - 0.7f;
+			const float z = 1.0f;
+			const float length = std::sqrt(x * x + y * y + z * z);
+			texels[i] = Encode(x / length);
+			texels[i + 1U] = Encode(y / length);
+			texels[i + 2U] = Encode(z / length);
+			texels[i + 3U] = 255U;
+		}
+		return texels;
+	}
+}
+
+BRE_TEST(NumLevelsGoesDownTo1x1) {
+	BRE_CHECK(MipGenerator::NumLevels(1U, 1U) == 1U);
+	BRE_CHECK(MipGenerator::NumLevels(150U, 119U) == 8U);
+	BRE_CHECK(MipGenerator::NumLevels(256U, 1U) == 9U);
+}
+
+BRE_TEST(ConstantImageStaysConstant) {
+	const std::uint8_t texel[] = { 77U, 200U, 3U, 128U };
+	const unsigned int width = 37U;
+	const unsigned int height = 20U;
+	std::vector<std::uint8_t> data(width * height * MipGenerator::sNumChannels);
+	for (size_t i = 0U; i < data.size(); ++i) {
+		data[i] = texel[i % MipGenerator::sNumChannels];
+	}
+
+	for (unsigned int i = 0U; i < 8U; ++i) {
+		MipGenerator::Settings settings;
+		settings.mFilter = (i & 1U) ? MipGenerator::Filter::Kaiser : MipGenerator::Filter::Box;
+		settings.mSRGB = (i & 2U) != 0U;
+		settings.mWrap = (i & 4U) != 0U;
+		Levels levels;
+		MipGenerator::Generate(data.data(), width, height, settings, levels);
+		BRE_CHECK(levels.size() == 6U);
+		for (unsigned int level = 0U; level < levels.size(); ++level) {
+			const unsigned int levelWidth = (std::max)(1U, width >> level);
+			const unsigned int levelHeight = (std::max)(1U, height >> level);
+			BRE_CHECK(levels[level].size() == levelWidth * levelHeight * MipGenerator::sNumChannels);
+			for (size_t j = 0U; j < levels[level].size(); ++j) {
+				BRE_CHECK(levels[level][j] == texel[j % MipGenerator::sNumChannels]);
+			}
+		}
+	}
+}
+
+BRE_TEST(BoxFiltersSRGBInLinearSpace) {
+	const std::uint8_t data[] = { 0U, 0U, 0U, 0U, 255U, 255U, 255U, 255U, 255U, 255U, 255U, 255U, 0U, 0U, 0U, 0U };
+	MipGenerator::Settings settings;
+	Levels levels;
+	MipGenerator::Generate(data, 2U, 2U, settings, levels);
+	BRE_CHECK(levels.size() == 2U);
+	BRE_CHECK(levels[1][0] == 128U);
+	BRE_CHECK(levels[1][3] == 128U);
+
+	// Linear 0.5 is 188 in sRGB. Alpha is always linear.
+	settings.mSRGB = true;
+	MipGenerator::Generate(data, 2U, 2U, settings, levels);
+	BRE_CHECK(levels[1][0] == 188U);
+	BRE_CHECK(levels[1][3] == 128U);
+}
+
+BRE_TEST(BoxAveragesOddDimensions) {
+	const std::uint8_t data[] = { 0U, 0U, 0U, 0U, 90U, 90U, 90U, 90U, 210U, 210U, 210U, 210U };
+	Levels levels;
+	MipGenerator::Generate(data, 3U, 1U, MipGenerator::Settings(), levels);
+	BRE_CHECK(levels.size() == 2U);
+	BRE_CHECK(levels[1][0] == 100U);
+}
+
+BRE_TEST(KaiserKeepsMoreDetailThanBox) {
+	const unsigned int size = 64U;
+	std::vector<std::uint8_t> data(size * size * MipGenerator::sNumChannels);
+	for (unsigned int y = 0U; y < size; ++y) {
+		for (unsigned int x = 0U; x < size; ++x) {
+			const std::uint8_t value = static_cast<std::uint8_t>(128.0 + 100.0 * std::sin(x * 2.0 * 3.14159265 / 16.0));
+			for (unsigned int c = 0U; c < MipGenerator::sNumChannels; ++c) {
+				data[(y * size + x) * MipGenerator::sNumChannels + c] = value;
+			}
+		}
+	}
+
+	int ranges[2];
+	for (unsigned int i = 0U; i < 2U; ++i) {
+		MipGenerator::Settings settings;
+		settings.mFilter = i == 0U ? MipGenerator::Filter::Box : MipGenerator::Filter::Kaiser;
+		Levels levels;
+		MipGenerator::Generate(data.data(), size, size, settings, levels);
+		double mean = 0.0;
+		int minValue = 255;
+		int maxValue = 0;
+		for (unsigned int x = 0U; x < size / 2U; ++x) {
+			const int value = levels[1][x * MipGenerator::sNumChannels];
+			mean += value;
+			minValue = (std::min)(minValue, value);
+			maxValue = (std::max)(maxValue, value);
+		}
+		BRE_CHECK_NEAR(mean / (size / 2U), 128.0, 1.5);
+		ranges[i] = maxValue - minValue;
+	}
+	BRE_CHECK(ranges[1] > 160);
+	BRE_CHECK(ranges[1] > ranges[0]);
+}
+
+BRE_TEST(NormalMapLevelsAreUnitLength) {
+	const unsigned int width = 64U;
+	const unsigned int height = 32U;
+	const std::vector<std::uint8_t> data = RandomNormals(width, height);
+	for (unsigned int i = 0U; i < 2U; ++i) {
+		MipGenerator::Settings settings;
+		settings.mFilter = i == 0U ? MipGenerator::Filter::Box : MipGenerator::Filter::Kaiser;
+		settings.mNormalMap = true;
+		Levels levels;
+		MipGenerator::Generate(data.data(), width, height, settings, levels);
+		BRE_CHECK(levels.size() == 7U);
+		for (unsigned int level = 1U; level < levels.size(); ++level) {
+			const std::vector<std::uint8_t>& texels = levels[level];
+			for (size_t j = 0U; j < texels.size(); j += MipGenerator::sNumChannels) {
+				const float x = Decode(texels[j]);
+				const float y = Decode(texels[j + 1U]);
+				const float z = Decode(texels[j + 2U]);
+				// 8 bits quantization moves each component by up to 1/255
+				BRE_CHECK_NEAR(std::sqrt(x * x + y * y + z * z), 1.0f, 0.01f);
+				BRE_CHECK(z > 0.0f);
+				BRE_CHECK(texels[j + 3U] == 255U);
+			}
+		}
+	}
+}
+
+BRE_TEST(NormalMapAveragesVectors) {
+	const std::uint8_t right[] = { 255U, 128U, 128U, 255U };
+	const std::uint8_t up[] = { 128U, 128U, 255U, 255U };
+	const std::uint8_t left[] = { 0U, 128U, 128U, 255U };
+	MipGenerator::Settings settings;
+	settings.mNormalMap = true;
+	Levels levels;
+
+	// (1, 0, 0) and (0, 0, 1) average to (0.5, 0, 0.5), stored as (0.707, 0, 0.707).
+	// As colors they would average to (0.5, 0, 0.5) unnormalized.
+	std::vector<std::uint8_t> data;
+	data.insert(data.end(), right, right + 4U);
+	data.insert(data.end(), up, up + 4U);
+	MipGenerator::Generate(data.data(), 2U, 1U, settings, levels);
+	BRE_CHECK(levels.size() == 2U);
+	BRE_CHECK(levels[1][0] == Encode(0.70710678f));
+	BRE_CHECK(levels[1][1] == 128U);
+	BRE_CHECK(levels[1][2] == Encode(0.70710678f));
+
+	// Opposite normals cancel out, the unperturbed normal is stored
+	data.clear();
+	data.insert(data.end(), right, right + 4U);
+	data.insert(data.end(), left, left + 4U);
+	MipGenerator::Generate(data.data(), 2U, 1U, settings, levels);
+	BRE_CHECK(levels[1][0] == 128U);
+	BRE_CHECK(levels[1][1] == 128U);
+	BRE_CHECK(levels[1][2] == 255U);
+}
\ No newline at end of file
@@ -0,0 +1,165 @@
+#include "TestFramework.h"
+
+#include <random>
+
+#include <rendering/shaders/normalDisplacement/hs/NormalDisplacementTessellation.h>
+
+using namespace BRE;
+using namespace DirectX;
+
+namespace {
+	// 90 degrees of vertical field of view, so the side planes are x = +-z and y = +-z
+	const float sFov = 1.57079633f;
+	const float sNearZ = 1.0f;
+	const float sFarZ = 100.0f;
+	// Size of the triangles tested against a single plane
+	const float sTriangleSize = 1e-3f;
+
+	NormalDisplacementTessellation::Settings CreateSettings() {
+		NormalDisplacementTessellation::Settings settings;
+		settings.mMinFactor = 1.0f;
+		settings.mMaxFactor = 16.0f;
+		settings.mDisplacementScale = 0.1f;
+		// Edge factor scale is 1 / (2 * 0.05) = 10
+		NormalDisplacementTessellation::SetProjection(XMMatrixPerspectiveFovLH(sFov, 1.0f, sNearZ, sFarZ), 0.05f, settings);
+		return settings;
+	}
+
+	XMFLOAT3 Add(const XMFLOAT3& a, const XMFLOAT3& b) {
+		return XMFLOAT3(a.x + b.x, a.y + b.y, a.z + b.z);
+	}
+
+	// Small front facing (clockwise) triangle at center, parallel to the camera plane
+	bool IsCulled(const XMFLOAT3& center, const NormalDisplacementTessellation::Settings& settings) {
+		const XMFLOAT3 p1 = Add(center, XMFLOAT3(0.0f, sTriangleSize, 0.0f));
+		const XMFLOAT3 p2 = Add(center, XMFLOAT3(sTriangleSize, 0.0f, 0.0f));
+		return NormalDisplacementTessellation::IsCulled(center, p1, p2, settings);
+	}
+
+	// Point at distance from plane (negative is outside)
+	XMFLOAT3 PointAtDistance(const XMFLOAT4& plane, const float distance) {
+		// Projection of a point inside the frustum to the plane
+		const XMFLOAT3 inside(0.0f, 0.0f, 50.0f);
+		const float offset = distance - (plane.x * inside.x + plane.y * inside.y + plane.z * inside.z + plane.w);
+		return Add(inside, XMFLOAT3(plane.x * offset, plane.y * offset, plane.z * offset));
+	}
+}
+
+BRE_TEST(EdgeFactorIsSymmetric) {
+	const NormalDisplacementTessellation::Settings settings = CreateSettings();
+	std::mt19937 generator(5U);
+	std::uniform_real_distribution<float> xy(-20.0f, 20.0f);
+	std::uniform_real_distribution<float> z(-5.0f, 60.0f);
+	for (unsigned int i = 0U; i < 1000U; ++i) {
+		const XMFLOAT3 p0(xy(generator), xy(generator), z(generator));
+		const XMFLOAT3 p1(xy(generator), xy(generator), z(generator));
+		BRE_CHECK(NormalDisplacementTessellation::EdgeFactor(p0, p1, settings) == NormalDisplacementTessellation::EdgeFactor(p1, p0, settings));
+	}
+}
+
+BRE_TEST(EdgeFactorIsProportionalToProjectedLength) {
+	const NormalDisplacementTessellation::Settings settings = CreateSettings();
+	BRE_CHECK_NEAR(NormalDisplacementTessellation::EdgeFactor(XMFLOAT3(0.0f, 0.0f, 10.0f), XMFLOAT3(4.0f, 0.0f, 10.0f), settings), 4.0f, 1e-4f);
+	BRE_CHECK_NEAR(NormalDisplacementTessellation::EdgeFactor(XMFLOAT3(0.0f, 0.0f, 10.0f), XMFLOAT3(0.0f, 8.0f, 10.0f), settings), 8.0f, 1e-4f);
+	// Twice the depth
+	BRE_CHECK_NEAR(NormalDisplacementTessellation::EdgeFactor(XMFLOAT3(0.0f, 0.0f, 20.0f), XMFLOAT3(0.0f, 8.0f, 20.0f), settings), 4.0f, 1e-4f);
+	// The depth is the one of the middle of the edge
+	BRE_CHECK_NEAR(NormalDisplacementTessellation::EdgeFactor(XMFLOAT3(0.0f, 0.0f, 8.0f), XMFLOAT3(0.0f, 0.0f, 12.0f), settings), 4.0f, 1e-4f);
+}
+
+BRE_TEST(EdgeFactorIsClamped) {
+	const NormalDisplacementTessellation::Settings settings = CreateSettings();
+	// Short and far: 0.1 * 10 / 90
+	BRE_CHECK(NormalDisplacementTessellation::EdgeFactor(XMFLOAT3(0.0f, 0.0f, 90.0f), XMFLOAT3(0.1f, 0.0f, 90.0f), settings) == settings.mMinFactor);
+	// Long and near: 5 * 10 / 2
+	BRE_CHECK(NormalDisplacementTessellation::EdgeFactor(XMFLOAT3(0.0f, 0.0f, 2.0f), XMFLOAT3(5.0f, 0.0f, 2.0f), settings) == settings.mMaxFactor);
+	// Degenerate
+	BRE_CHECK(NormalDisplacementTessellation::EdgeFactor(XMFLOAT3(1.0f, 2.0f, 3.0f), XMFLOAT3(1.0f, 2.0f, 3.0f), settings) == settings.mMinFactor);
+}
+
+BRE_TEST(EdgesCrossingTheCameraPlaneGetTheMaxFactor) {
+	const NormalDisplacementTessellation::Settings settings = CreateSettings();
+	BRE_CHECK(NormalDisplacementTessellation::EdgeFactor(XMFLOAT3(0.0f, 0.0f, -1.0f), XMFLOAT3(0.1f, 0.0f, 1.0f), settings) == settings.mMaxFactor);
+	BRE_CHECK(NormalDisplacementTessellation::EdgeFactor(XMFLOAT3(0.0f, 0.0f, 1.0f), XMFLOAT3(0.1f, 0.0f, -1.0f), settings) == settings.mMaxFactor);
+	// Middle of the edge exactly on the camera plane
+	BRE_CHECK(NormalDisplacementTessellation::EdgeFactor(XMFLOAT3(0.0f, 0.0f, -0.5f), XMFLOAT3(0.1f, 0.0f, 0.5f), settings) == settings.mMaxFactor);
+}
+
+BRE_TEST(PatchesOutsideAFrustumPlaneAreCulled) {
+	const NormalDisplacementTessellation::Settings settings = CreateSettings();
+	const float displacement = settings.mDisplacementScale;
+	BRE_CHECK(!IsCulled(XMFLOAT3(0.0f, 0.0f, 50.0f), settings));
+	for (const XMFLOAT4& plane : settings.mFrustumPlanes) {
+		// Inside, on the plane, outside by less than the displacement, and outside by more
+		BRE_CHECK(!IsCulled(PointAtDistance(plane, 1.0f), settings));
+		BRE_CHECK(!IsCulled(PointAtDistance(plane, 0.0f), settings));
+		BRE_CHECK(!IsCulled(PointAtDistance(plane, -0.5f * displacement), settings));
+		BRE_CHECK(IsCulled(PointAtDistance(plane, -2.0f * displacement), settings));
+		BRE_CHECK(IsCulled(PointAtDistance(plane, -1.0f), settings));
+	}
+}
+
+BRE_TEST(PatchesCrossingAFrustumPlaneAreKept) {
+	const NormalDisplacementTessellation::Settings settings = CreateSettings();
+	// Only p0 is inside the left plane (x = -z)
+	BRE_CHECK(!NormalDisplacementTessellation::IsCulled(XMFLOAT3(-9.0f, 0.0f, 10.0f), XMFLOAT3(-20.0f, 0.0f, 10.0f), XMFLOAT3(-20.0f, 5.0f, 10.0f), settings));
+	// Every vertex outside a different plane, none outside all
+	BRE_CHECK(!NormalDisplacementTessellation::IsCulled(XMFLOAT3(-20.0f, 0.0f, 10.0f), XMFLOAT3(0.0f, 20.0f, 10.0f), XMFLOAT3(20.0f, 0.0f, 10.0f), settings));
+}
+
+BRE_TEST(BackFacingPatchesAreCulled) {
+	const NormalDisplacementTessellation::Settings settings = CreateSettings();
+	const XMFLOAT3 p0(0.0f, 0.0f, 10.0f);
+	const XMFLOAT3 p1(0.0f, 1.0f, 10.0f);
+	const XMFLOAT3 p2(1.0f, 0.0f, 10.0f);
+	BRE_CHECK(!NormalDisplacementTessellation::IsCulled(p0, p1, p2, settings));
+	// Counterclockwise
+	BRE_CHECK(NormalDisplacementTessellation::IsCulled(p0, p2, p1, settings));
+	// Degenerate patches are not back facing
+	BRE_CHECK(!NormalDisplacementTessellation::IsCulled(p0, p0, p1, settings));
+}
+
+BRE_TEST(BackFacingPatchesWithinTheDisplacementAreKept) {
+	const NormalDisplacementTessellation::Settings settings = CreateSettings();
+	const float displacement = settings.mDisplacementScale;
+	// Back facing patches of the plane x = distance, seen almost edge on.
+	// The camera is behind them by distance.
+	for (const float distance : { 0.5f * displacement, 2.0f * displacement }) {
+		const XMFLOAT3 p0(distance, 0.0f, 5.0f);
+		const XMFLOAT3 p1(distance, 1.0f, 5.0f);
+		const XMFLOAT3 p2(distance, 0.0f, 6.0f);
+		BRE_CHECK(NormalDisplacementTessellation::IsCulled(p0, p1, p2, settings) == (distance > displacement));
+		// Front facing
+		BRE_CHECK(!NormalDisplacementTessellation::IsCulled(p0, p2, p1, settings));
+	}
+}
+
+BRE_TEST(PatchFactorsOfCulledPatchesAreZero) {
+	const NormalDisplacementTessellation::Settings settings = CreateSettings();
+	float edgeFactors[3];
+	float insideFactor;
+
+	// Behind the camera
+	NormalDisplacementTessellation::PatchFactors(XMFLOAT3(0.0f, 0.0f, -10.0f), XMFLOAT3(0.0f, 1.0f, -10.0f), XMFLOAT3(1.0f, 0.0f, -10.0f), settings, edgeFactors, insideFactor);
+	BRE_CHECK(edgeFactors[0] == 0.0f && edgeFactors[1] == 0.0f && edgeFactors[2] == 0.0f && insideFactor == 0.0f);
+	// Back facing
+	NormalDisplacementTessellation::PatchFactors(XMFLOAT3(0.0f, 0.0f, 10.0f), XMFLOAT3(1.0f, 0.0f, 10.0f), XMFLOAT3(0.0f, 1.0f, 10.0f), settings, edgeFactors, insideFactor);
+	BRE_CHECK(edgeFactors[0] == 0.0f && edgeFactors[1] == 0.0f && edgeFactors[2] == 0.0f && insideFactor == 0.0f);
+}
+
+BRE_TEST(PatchFactorsOfVisiblePatches) {
+	const NormalDisplacementTessellation::Settings settings = CreateSettings();
+	const XMFLOAT3 p0(0.0f, 0.0f, 10.0f);
+	const XMFLOAT3 p1(0.0f, 1.0f, 10.0f);
+	const XMFLOAT3 p2(0.5f, 0.0f, 10.0f);
+	float edgeFactors[3];
+	float insideFactor;
+	NormalDisplacementTessellation::PatchFactors(p0, p1, p2, settings, edgeFactors, insideFactor);
+	// Edge i is opposite to vertex i
+	BRE_CHECK(edgeFactors[0] == NormalDisplacementTessellation::EdgeFactor(p1, p2, settings));
+	BRE_CHECK(edgeFactors[1] == NormalDisplacementTessellation::EdgeFactor(p2, p0, settings));
+	BRE_CHECK(edgeFactors[2] == NormalDisplacementTessellation::EdgeFactor(p0, p1, settings));
+	BRE_CHECK(edgeFactors[1] == settings.mMinFactor);
+	BRE_CHECK(edgeFactors[0] > edgeFactors[2]);
+	BRE_CHECK(insideFactor == edgeFactors[0]);
+}
\ No newline at end of file
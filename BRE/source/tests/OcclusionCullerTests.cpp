@@ -0,0 +1,316 @@
+#include "TestFramework.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include <general/JobSystem.h>
+#include <general/Profiler.h>
+#include <rendering/OcclusionCuller.h>
+#include <rendering/TransformArray.h>
+
+using namespace BRE;
+using namespace DirectX;
+
+namespace {
+	typedef BoundingVolumeHierarchy::Aabb Aabb;
+
+	// Installs the profiler (and a job system with threads) while they live
+	class ScopedJobSystem {
+	public:
+		explicit ScopedJobSystem(const unsigned int numThreads) {
+			Profiler::gInstance = &mProfiler;
+			if (numThreads > 0U) {
+				JobSystem::gInstance = new JobSystem(numThreads);
+			}
+		}
+
+		~ScopedJobSystem() {
+			delete JobSystem::gInstance;
+			JobSystem::gInstance = nullptr;
+			Profiler::gInstance = nullptr;
+		}
+
+	private:
+		Profiler mProfiler;
+	};
+
+	struct ClipVertex {
+		double mX;
+		double mY;
+		double mZ;
+		double mW;
+	};
+
+	ClipVertex Transform(const XMFLOAT3& position, const XMFLOAT4X4& m) {
+		ClipVertex vertex;
+		double* elements[4] = { &vertex.mX, &vertex.mY, &vertex.mZ, &vertex.mW };
+		for (size_t column = 0U; column < 4U; ++column) {
+			*elements[column] = position.x * m.m[0][column] + position.y * m.m[1][column] + position.z * m.m[2][column] + m.m[3][column];
+		}
+		return vertex;
+	}
+
+	// Rasterizer in doubles that tests every pixel center of every triangle
+	class ReferenceDepthBuffer {
+	public:
+		ReferenceDepthBuffer(const unsigned int width, const unsigned int height)
+			: mWidth(width)
+			, mHeight(height)
+			, mDepth(width * height, 1.0)
+		{
+		}
+
+		// Clipped by the near plane (z = 0)
+		void AddTriangle(const ClipVertex vertices[3]) {
+			ClipVertex clipped[4];
+			size_t numClipped = 0U;
+			for (size_t i = 0U; i < 3U; ++i) {
+				const ClipVertex& a = vertices[i];
+				const ClipVertex& b = vertices[(i + 1U) % 3U];
+				if (a.mZ >= 0.0) {
+					clipped[numClipped++] = a;
+				}
+				if ((a.mZ >= 0.0) != (b.mZ >= 0.0)) {
+					const double t = a.mZ / (a.mZ - b.mZ);
+					const ClipVertex vertex = { a.mX + (b.mX - a.mX) * t, a.mY + (b.mY - a.mY) * t, 0.0, a.mW + (b.mW - a.mW) * t };
+					clipped[numClipped++] = vertex;
+				}
+			}
+			for (size_t i = 2U; i < numClipped; ++i) {
+				AddScreenTriangle(clipped[0U], clipped[i - 1U], clipped[i]);
+			}
+		}
+
+		double Depth(const unsigned int x, const unsigned int y) const { return mDepth[y * mWidth + x]; }
+
+	private:
+		void AddScreenTriangle(const ClipVertex& a, const ClipVertex& b, const ClipVertex& c) {
+			const ClipVertex* vertices[3] = { &a, &b, &c };
+			double x[3];
+			double y[3];
+			double z[3];
+			for (size_t i = 0U; i < 3U; ++i) {
+				x[i] = (vertices[i]->mX / vertices[i]->mW * 0.5 + 0.5) * mWidth;
+				y[i] = (0.5 - vertices[i]->mY / vertices[i]->mW * 0.5) * mHeight;
+				z[i] = vertices[i]->mZ / vertices[i]->mW;
+			}
+			// Clockwise on screen (y down) is a positive area
+			const double area = (x[1] - x[0]) * (y[2] - y[0]) - (y[1] - y[0]) * (x[2] - x[0]);
+			if (!(area > 0.0)) {
+				return;
+			}
+			for (unsigned int pixelY = 0U; pixelY < mHeight; ++pixelY) {
+				for (unsigned int pixelX = 0U; pixelX < mWidth; ++pixelX) {
+					const double centerX = pixelX + 0.5;
+					const double centerY = pixelY + 0.5;
+					double weights[3];
+					for (size_t i = 0U; i < 3U; ++i) {
+						const size_t i1 = (i + 1U) % 3U;
+						const size_t i2 = (i + 2U) % 3U;
+						weights[i] = ((x[i2] - x[i1]) * (centerY - y[i1]) - (y[i2] - y[i1]) * (centerX - x[i1])) / area;
+					}
+					if (weights[0] >= 0.0 && weights[1] >= 0.0 && weights[2] >= 0.0) {
+						double& depth = mDepth[pixelY * mWidth + pixelX];
+						depth = (std::min)(depth, weights[0] * z[0] + weights[1] * z[1] + weights[2] * z[2]);
+					}
+				}
+			}
+		}
+
+		unsigned int mWidth;
+		unsigned int mHeight;
+		std::vector<double> mDepth;
+	};
+
+	// Bounds that cross the near plane, or with a pixel of their screen rectangle
+	// whose depth is not nearer than their nearest depth
+	bool IsVisible(const Aabb& bounds, const XMFLOAT4X4& viewProj, const ReferenceDepthBuffer& depth, const unsigned int width, const unsigned int height) {
+		double minX = 1.0e30;
+		double maxX = -1.0e30;
+		double minY = 1.0e30;
+		double maxY = -1.0e30;
+		double minZ = 1.0e30;
+		for (size_t iCorner = 0U; iCorner < 8U; ++iCorner) {
+			const XMFLOAT3 corner((iCorner & 1U) ? bounds.mMax.x : bounds.mMin.x, (iCorner & 2U) ? bounds.mMax.y : bounds.mMin.y, (iCorner & 4U) ? bounds.mMax.z : bounds.mMin.z);
+			const ClipVertex vertex = Transform(corner, viewProj);
+			if (vertex.mZ < 0.0) {
+				return true;
+			}
+			const double x = (vertex.mX / vertex.mW * 0.5 + 0.5) * width;
+			const double y = (0.5 - vertex.mY / vertex.mW * 0.5) * height;
+			minX = (std::min)(minX, x);
+			maxX = (std::max)(maxX, x);
+			minY = (std::min)(minY, y);
+			maxY = (std::max)(maxY, y);
+			minZ = (std::min)(minZ, vertex.mZ / vertex.mW);
+		}
+		if (maxX < 0.0 || maxY < 0.0 || minX >= width || minY >= height) {
+			return false;
+		}
+		const int lastX = (std::min)(static_cast<int>(width) - 1, static_cast<int>(maxX));
+		const int lastY = (std::min)(static_cast<int>(height) - 1, static_cast<int>(maxY));
+		for (int y = (std::max)(0, static_cast<int>(minY)); y <= lastY; ++y) {
+			for (int x = (std::max)(0, static_cast<int>(minX)); x <= lastX; ++x) {
+				if (depth.Depth(x, y) >= minZ - 1.0e-5) {
+					return true;
+				}
+			}
+		}
+		return false;
+	}
+
+	// Square wall of 200 x 200 at z = 0, clockwise seen from -z (front face) or not
+	void AddWall(OcclusionCuller& culler, const size_t transform, const bool front) {
+		const std::vector<XMFLOAT3> vertices = { XMFLOAT3(-100.0f, 100.0f, 0.0f), XMFLOAT3(100.0f, 100.0f, 0.0f), XMFLOAT3(-100.0f, -100.0f, 0.0f), XMFLOAT3(100.0f, -100.0f, 0.0f) };
+		const std::vector<unsigned int> frontIndices = { 0U, 1U, 2U, 1U, 3U, 2U };
+		const std::vector<unsigned int> backIndices = { 0U, 2U, 1U, 1U, 2U, 3U };
+		culler.AddOccluder(vertices, front ? frontIndices : backIndices, transform);
+	}
+
+	Aabb Box(const XMFLOAT3& min, const XMFLOAT3& max) {
+		Aabb box;
+		box.mMin = min;
+		box.mMax = max;
+		return box;
+	}
+
+	const unsigned int sNumThreads[] = { 0U, 3U };
+}
+
+BRE_TEST(DepthMatchesReferenceRasterizer) {
+	std::mt19937 generator(7U);
+	std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+	for (const unsigned int numThreads : sNumThreads) {
+		ScopedJobSystem jobSystem(numThreads);
+		for (unsigned int scene = 0U; scene < 6U; ++scene) {
+			const unsigned int requestedWidth = (scene % 2U) == 0U ? 64U : 100U;
+			const unsigned int requestedHeight = (scene % 2U) == 0U ? 40U : 50U;
+			OcclusionCuller culler(requestedWidth, requestedHeight);
+			const unsigned int width = culler.Width();
+			const unsigned int height = culler.Height();
+			BRE_CHECK(width % OcclusionCuller::sTileWidth == 0U && width >= requestedWidth);
+			BRE_CHECK(height % OcclusionCuller::sTileHeight == 0U && height >= requestedHeight);
+
+			// Triangle soups. Deep ones (last scenes) cross the near plane.
+			const size_t numOccluders = 1U + scene * 3U;
+			const float depthRange = scene >= 4U ? 60.0f : 10.0f;
+			TransformArray transforms;
+			std::vector<std::vector<XMFLOAT3>> vertices(numOccluders);
+			std::vector<XMFLOAT4X4> worlds(numOccluders);
+			for (size_t iOccluder = 0U; iOccluder < numOccluders; ++iOccluder) {
+				const XMMATRIX world = XMMatrixTranslation(distribution(generator) * 20.0f, distribution(generator) * 20.0f, 40.0f + distribution(generator) * 30.0f);
+				XMStoreFloat4x4(&worlds[iOccluder], world);
+				const size_t transform = transforms.Add(world);
+				std::vector<unsigned int> indices;
+				const unsigned int numTriangles = 3U + generator() % 10U;
+				for (unsigned int i = 0U; i < numTriangles * 3U; ++i) {
+					vertices[iOccluder].push_back(XMFLOAT3(distribution(generator) * 25.0f, distribution(generator) * 25.0f, distribution(generator) * depthRange));
+					indices.push_back(i);
+				}
+				culler.AddOccluder(vertices[iOccluder], indices, transform);
+			}
+			BRE_CHECK(culler.NumOccluders() == numOccluders);
+
+			const XMMATRIX viewProj = XMMatrixPerspectiveFovLH(1.0f, static_cast<float>(width) / height, 1.0f, 200.0f);
+			culler.RenderOccluders(viewProj, transforms);
+
+			ReferenceDepthBuffer reference(width, height);
+			for (size_t iOccluder = 0U; iOccluder < numOccluders; ++iOccluder) {
+				XMFLOAT4X4 worldViewProj;
+				XMStoreFloat4x4(&worldViewProj, XMLoadFloat4x4(&worlds[iOccluder]) * viewProj);
+				for (size_t i = 0U; i < vertices[iOccluder].size(); i += 3U) {
+					const ClipVertex triangle[3] = { Transform(vertices[iOccluder][i], worldViewProj), Transform(vertices[iOccluder][i + 1U], worldViewProj), Transform(vertices[iOccluder][i + 2U], worldViewProj) };
+					reference.AddTriangle(triangle);
+				}
+			}
+			// Pixel centers on triangle edges can go either way
+			unsigned int numWrongPixels = 0U;
+			for (unsigned int y = 0U; y < height; ++y) {
+				for (unsigned int x = 0U; x < width; ++x) {
+					numWrongPixels += std::fabs(culler.Depth(x, y) - reference.Depth(x, y)) > 1.0e-4 ? 1U : 0U;
+				}
+			}
+			BRE_CHECK(numWrongPixels <= 2U);
+
+			// Visibility of random boxes. Boxes hidden by the reference depth can be
+			// visible (conservative tests), the opposite is a wrong cull.
+			XMFLOAT4X4 viewProjMatrix;
+			XMStoreFloat4x4(&viewProjMatrix, viewProj);
+			unsigned int numDisagreements = 0U;
+			unsigned int numWrongCulls = 0U;
+			for (unsigned int query = 0U; query < 500U; ++query) {
+				const XMFLOAT3 min(distribution(generator) * 40.0f, distribution(generator) * 40.0f, 20.0f + std::fabs(distribution(generator)) * 150.0f);
+				const XMFLOAT3 max(min.x + std::fabs(distribution(generator)) * 6.0f, min.y + std::fabs(distribution(generator)) * 6.0f, min.z + std::fabs(distribution(generator)) * 6.0f);
+				const Aabb box = Box(min, max);
+				const bool visible = culler.IsVisible(box);
+				const bool expectedVisible = IsVisible(box, viewProjMatrix, reference, width, height);
+				numDisagreements += visible != expectedVisible ? 1U : 0U;
+				numWrongCulls += (!visible && expectedVisible) ? 1U : 0U;
+			}
+			BRE_CHECK(numDisagreements <= 3U);
+			BRE_CHECK(numWrongCulls <= 1U);
+		}
+	}
+}
+
+BRE_TEST(OnlyFrontFacesOcclude) {
+	ScopedJobSystem jobSystem(0U);
+	TransformArray transforms;
+	const size_t transform = transforms.Add(XMMatrixTranslation(0.0f, 0.0f, 50.0f));
+	const XMMATRIX viewProj = XMMatrixPerspectiveFovLH(1.0f, 2.0f, 1.0f, 200.0f);
+	const Aabb behind = Box(XMFLOAT3(-1.0f, -1.0f, 60.0f), XMFLOAT3(1.0f, 1.0f, 62.0f));
+
+	OcclusionCuller frontCuller(64U, 32U);
+	AddWall(frontCuller, transform, true);
+	frontCuller.RenderOccluders(viewProj, transforms);
+	BRE_CHECK(frontCuller.Depth(10U, 10U) < 1.0f);
+	BRE_CHECK(!frontCuller.IsVisible(behind));
+	BRE_CHECK(frontCuller.IsVisible(Box(XMFLOAT3(-1.0f, -1.0f, 30.0f), XMFLOAT3(1.0f, 1.0f, 32.0f))));
+	// Crossing the near plane and behind the camera
+	BRE_CHECK(frontCuller.IsVisible(Box(XMFLOAT3(-1.0f, -1.0f, 0.0f), XMFLOAT3(1.0f, 1.0f, 62.0f))));
+	BRE_CHECK(!frontCuller.IsVisible(Box(XMFLOAT3(-1.0f, -1.0f, -30.0f), XMFLOAT3(1.0f, 1.0f, -20.0f))));
+
+	OcclusionCuller backCuller(64U, 32U);
+	AddWall(backCuller, transform, false);
+	backCuller.RenderOccluders(viewProj, transforms);
+	BRE_CHECK(backCuller.Depth(10U, 10U) == 1.0f);
+	BRE_CHECK(backCuller.IsVisible(behind));
+}
+
+BRE_TEST(OccludedObjectsAreRemovedInOrder) {
+	for (const unsigned int numThreads : sNumThreads) {
+		ScopedJobSystem jobSystem(numThreads);
+		TransformArray transforms;
+		OcclusionCuller culler(128U, 64U);
+		AddWall(culler, transforms.Add(XMMatrixTranslation(0.0f, 0.0f, 50.0f)), true);
+		const XMMATRIX viewProj = XMMatrixPerspectiveFovLH(1.0f, 2.0f, 1.0f, 1000.0f);
+		culler.RenderOccluders(viewProj, transforms);
+
+		// Boxes in front of the wall and behind it, alternately
+		std::vector<Aabb> bounds;
+		for (unsigned int i = 0U; i < 5000U; ++i) {
+			const float x = static_cast<float>(i % 20U) - 10.0f;
+			const float z = (i % 2U) == 0U ? 20.0f : 80.0f + static_cast<float>(i % 7U);
+			bounds.push_back(Box(XMFLOAT3(x, -1.0f, z), XMFLOAT3(x + 1.0f, 1.0f, z + 1.0f)));
+		}
+		BoundingVolumeHierarchy bvh;
+		bvh.Build(bounds);
+
+		std::vector<std::uint32_t> objects;
+		for (std::uint32_t i = 0U; i < bounds.size(); ++i) {
+			objects.push_back(static_cast<std::uint32_t>(bounds.size()) - 1U - i);
+		}
+		culler.RemoveOccluded(bvh, objects);
+		BRE_CHECK(objects.size() == bounds.size() / 2U);
+		bool inOrder = true;
+		bool onlyFrontObjects = true;
+		for (size_t i = 0U; i < objects.size(); ++i) {
+			inOrder = inOrder && (i == 0U || objects[i] < objects[i - 1U]);
+			onlyFrontObjects = onlyFrontObjects && (objects[i] % 2U) == 0U;
+		}
+		BRE_CHECK(inOrder);
+		BRE_CHECK(onlyFrontObjects);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,217 @@
+#include "TestFramework.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include <general/Profiler.h>
+
+using namespace BRE;
+
+namespace {
+	const Profiler::ZoneStats* FindStats(const Profiler& profiler, const char* name) {
+		for (const Profiler::ZoneStats& stats : profiler.FrameStats()) {
+			if (std::strcmp(stats.mName, name) == 0) {
+				return &stats;
+			}
+		}
+		return nullptr;
+	}
+
+	// Installs a profiler as the global instance while it lives
+	class ScopedProfiler {
+	public:
+		explicit ScopedProfiler(const size_t eventsPerThread = 16384U)
+			: mProfiler(eventsPerThread)
+		{
+			Profiler::gInstance = &mProfiler;
+		}
+
+		~ScopedProfiler() { Profiler::gInstance = nullptr; }
+
+		Profiler& Get() { return mProfiler; }
+
+	private:
+		Profiler mProfiler;
+	};
+}
+
+BRE_TEST(NestedZonesAreSortedParentFirst) {
+	ScopedProfiler scopedProfiler;
+	Profiler& profiler = scopedProfiler.Get();
+	{
+		BRE_PROFILE_SCOPE("Frame");
+		for (int i = 0; i < 3; ++i) {
+			BRE_PROFILE_SCOPE("Child");
+			BRE_PROFILE_SCOPE("GrandChild");
+		}
+	}
+	profiler.EndFrame();
+
+	const std::vector<Profiler::ZoneStats>& stats = profiler.FrameStats();
+	BRE_CHECK(stats.size() == 3U);
+	BRE_CHECK(std::strcmp(stats[0].mName, "Frame") == 0);
+	BRE_CHECK(std::strcmp(stats[1].mName, "Child") == 0);
+	BRE_CHECK(std::strcmp(stats[2].mName, "GrandChild") == 0);
+	BRE_CHECK(stats[0].mDepth == 0U && stats[1].mDepth == 1U && stats[2].mDepth == 2U);
+	BRE_CHECK(stats[0].mCalls == 1U && stats[1].mCalls == 3U && stats[2].mCalls == 3U);
+	BRE_CHECK(stats[0].mTotalMs >= stats[1].mTotalMs);
+	BRE_CHECK(stats[1].mMaxMs <= stats[1].mTotalMs);
+}
+
+BRE_TEST(StatsOnlyCoverTheFrameThatEnds) {
+	ScopedProfiler scopedProfiler;
+	Profiler& profiler = scopedProfiler.Get();
+	{
+		BRE_PROFILE_SCOPE("First");
+	}
+	profiler.EndFrame();
+	BRE_CHECK(FindStats(profiler, "First") != nullptr);
+
+	{
+		BRE_PROFILE_SCOPE("Second");
+	}
+	profiler.EndFrame();
+	BRE_CHECK(FindStats(profiler, "First") == nullptr);
+	BRE_CHECK(FindStats(profiler, "Second") != nullptr);
+
+	profiler.EndFrame();
+	BRE_CHECK(profiler.FrameStats().empty());
+}
+
+BRE_TEST(ZonesOfOtherThreadsAreDrained) {
+	ScopedProfiler scopedProfiler;
+	Profiler& profiler = scopedProfiler.Get();
+	std::thread worker([]() {
+		for (int i = 0; i < 5; ++i) {
+			BRE_PROFILE_SCOPE("Worker");
+		}
+	});
+	worker.join();
+	{
+		BRE_PROFILE_SCOPE("Main");
+	}
+	profiler.EndFrame();
+
+	const Profiler::ZoneStats* workerStats = FindStats(profiler, "Worker");
+	BRE_CHECK(workerStats != nullptr && workerStats->mCalls == 5U);
+	BRE_CHECK(FindStats(profiler, "Main") != nullptr);
+}
+
+BRE_TEST(FullThreadBufferDropsZones) {
+	ScopedProfiler scopedProfiler(4U);
+	Profiler& profiler = scopedProfiler.Get();
+	for (int i = 0; i < 10; ++i) {
+		BRE_PROFILE_SCOPE("Zone");
+	}
+	profiler.EndFrame();
+
+	const Profiler::ZoneStats* stats = FindStats(profiler, "Zone");
+	BRE_CHECK(stats != nullptr && stats->mCalls == 4U);
+	BRE_CHECK(profiler.DroppedEvents() == 6U);
+
+	// The drain frees the buffer again
+	for (int i = 0; i < 4; ++i) {
+		BRE_PROFILE_SCOPE("Zone");
+	}
+	profiler.EndFrame();
+	stats = FindStats(profiler, "Zone");
+	BRE_CHECK(stats != nullptr && stats->mCalls == 4U);
+	BRE_CHECK(profiler.DroppedEvents() == 6U);
+}
+
+BRE_TEST(ZoneDurationMatchesTheClock) {
+	ScopedProfiler scopedProfiler;
+	Profiler& profiler = scopedProfiler.Get();
+	const std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+	{
+		BRE_PROFILE_SCOPE("Sleep");
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	}
+	const double clockMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+	profiler.EndFrame();
+
+	const Profiler::ZoneStats* stats = FindStats(profiler, "Sleep");
+	BRE_CHECK(stats != nullptr);
+	BRE_CHECK(stats->mTotalMs >= 9.0);
+	BRE_CHECK(stats->mTotalMs <= clockMs * 1.1 + 1.0);
+	BRE_CHECK(profiler.FrameMs() >= stats->mTotalMs);
+}
+
+BRE_TEST(OverheadMeasurementDoesNotPolluteTheFrame) {
+	ScopedProfiler scopedProfiler;
+	Profiler& profiler = scopedProfiler.Get();
+	{
+		BRE_PROFILE_SCOPE("BeforeMeasure");
+	}
+	const double overheadNs = profiler.MeasureZoneOverhead(10000U);
+	profiler.EndFrame();
+
+	BRE_CHECK(overheadNs > 0.0 && overheadNs < 10000.0);
+	BRE_CHECK(FindStats(profiler, "BeforeMeasure") != nullptr);
+	BRE_CHECK(FindStats(profiler, "ProfilerOverhead") == nullptr);
+	BRE_CHECK(profiler.DroppedEvents() == 0U);
+}
+
+BRE_TEST(CaptureWritesChromeTrace) {
+	const char* filepath = "profiler_capture_test.json";
+	std::remove(filepath);
+	{
+		ScopedProfiler scopedProfiler;
+		Profiler& profiler = scopedProfiler.Get();
+		profiler.RequestCapture(filepath, 2U);
+		BRE_CHECK(profiler.IsCapturing());
+		{
+			BRE_PROFILE_SCOPE("Captured");
+		}
+		profiler.EndFrame();
+		BRE_CHECK(profiler.IsCapturing());
+		{
+			BRE_PROFILE_SCOPE("Quoted\"Name");
+		}
+		profiler.EndFrame();
+		BRE_CHECK(!profiler.IsCapturing());
+		{
+			BRE_PROFILE_SCOPE("AfterCapture");
+		}
+		profiler.EndFrame();
+	}
+
+	std::ifstream stream(filepath);
+	BRE_CHECK(stream.is_open());
+	std::stringstream contents;
+	contents << stream.rdbuf();
+	const std::string json = contents.str();
+	BRE_CHECK(json.find("\"traceEvents\"") != std::string::npos);
+	BRE_CHECK(json.find("\"name\":\"Captured\"") != std::string::npos);
+	BRE_CHECK(json.find("\"name\":\"Quoted\\\"Name\"") != std::string::npos);
+	BRE_CHECK(json.find("AfterCapture") == std::string::npos);
+	BRE_CHECK(json.find("\"ph\":\"X\"") != std::string::npos);
+}
+
+BRE_TEST(CaptureCanBeRequestedFromAnotherThread) {
+	const char* filepath = "profiler_capture_thread_test.json";
+	std::remove(filepath);
+	ScopedProfiler scopedProfiler;
+	Profiler& profiler = scopedProfiler.Get();
+	std::thread requester([&profiler, filepath]() { profiler.RequestCapture(filepath, 1U); });
+	requester.join();
+	BRE_CHECK(profiler.IsCapturing());
+
+	// A second request while the first one is pending is ignored
+	profiler.RequestCapture("profiler_capture_ignored.json", 5U);
+	{
+		BRE_PROFILE_SCOPE("Captured");
+	}
+	profiler.EndFrame();
+	BRE_CHECK(!profiler.IsCapturing());
+
+	std::ifstream stream(filepath);
+	BRE_CHECK(stream.is_open());
+	std::ifstream ignoredStream("profiler_capture_ignored.json");
+	BRE_CHECK(!ignoredStream.is_open());
+}
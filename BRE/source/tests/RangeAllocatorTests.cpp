@@ -0,0 +1,172 @@
+#include "TestFramework.h"
+
+#include <iterator>
+#include <map>
+#include <random>
+#include <vector>
+
+#include <utils/RangeAllocator.h>
+
+using namespace BRE;
+
+namespace {
+	// Allocations (offset to size) and an owner id for each element, as a
+	// buffer whose ranges are moved by Defragment()
+	struct Buffer {
+		std::map<unsigned int, unsigned int> mAllocations;
+		std::vector<unsigned int> mOwners;
+		unsigned int mNextOwner = 1U;
+	};
+
+	bool IsConsistent(const RangeAllocator& allocator, const Buffer& buffer) {
+		unsigned int end = 0U;
+		unsigned int usedSize = 0U;
+		for (const std::pair<const unsigned int, unsigned int>& allocation : buffer.mAllocations) {
+			if (allocation.first < end) {
+				return false;
+			}
+			end = allocation.first + allocation.second;
+			usedSize += allocation.second;
+		}
+		return end <= allocator.Capacity() && usedSize == allocator.UsedSize() && buffer.mAllocations.size() == allocator.NumAllocations();
+	}
+
+	// Returns false if an element of the range is used
+	bool Own(Buffer& buffer, const unsigned int offset, const unsigned int size, const unsigned int owner) {
+		for (unsigned int i = offset; i < offset + size; ++i) {
+			if (buffer.mOwners[i] != 0U) {
+				return false;
+			}
+			buffer.mOwners[i] = owner;
+		}
+		return true;
+	}
+
+	// Returns false if the moved range is not an allocation, its destination is
+	// used or it overlaps its source
+	bool ApplyMove(Buffer& buffer, const RangeAllocator::Move& move) {
+		const std::map<unsigned int, unsigned int>::iterator allocationIt = buffer.mAllocations.find(move.mFrom);
+		if (allocationIt == buffer.mAllocations.end() || allocationIt->second != move.mSize || move.mTo + move.mSize > move.mFrom) {
+			return false;
+		}
+		const unsigned int owner = buffer.mOwners[move.mFrom];
+		for (unsigned int i = 0U; i < move.mSize; ++i) {
+			if (buffer.mOwners[move.mFrom + i] != owner) {
+				return false;
+			}
+			buffer.mOwners[move.mFrom + i] = 0U;
+		}
+		buffer.mAllocations.erase(allocationIt);
+		buffer.mAllocations[move.mTo] = move.mSize;
+		return Own(buffer, move.mTo, move.mSize, owner);
+	}
+}
+
+BRE_TEST(AllocationsDoNotOverlap) {
+	std::mt19937 generator(1U);
+	for (unsigned int trial = 0U; trial < 20U; ++trial) {
+		RangeAllocator allocator(1000U);
+		Buffer buffer;
+		buffer.mOwners.resize(allocator.Capacity(), 0U);
+		for (unsigned int step = 0U; step < 2000U; ++step) {
+			const unsigned int operation = generator() % 10U;
+			if (operation < 5U) {
+				const unsigned int size = 1U + generator() % (generator() % 4U == 0U ? 300U : 20U);
+				unsigned int offset = allocator.Allocate(size);
+				if (offset == RangeAllocator::sInvalidOffset) {
+					// Size classes are rounded up, so a free range of twice the size fits
+					BRE_CHECK(allocator.LargestFreeRange() < size * 2U);
+					allocator.Grow(allocator.Capacity() * 2U);
+					buffer.mOwners.resize(allocator.Capacity(), 0U);
+					offset = allocator.Allocate(size);
+				}
+				BRE_CHECK(offset != RangeAllocator::sInvalidOffset);
+				BRE_CHECK(Own(buffer, offset, size, buffer.mNextOwner++));
+				buffer.mAllocations[offset] = size;
+			}
+			else if (operation < 8U && !buffer.mAllocations.empty()) {
+				std::map<unsigned int, unsigned int>::iterator allocationIt = buffer.mAllocations.begin();
+				std::advance(allocationIt, generator() % buffer.mAllocations.size());
+				for (unsigned int i = allocationIt->first; i < allocationIt->first + allocationIt->second; ++i) {
+					buffer.mOwners[i] = 0U;
+				}
+				allocator.Free(allocationIt->first);
+				buffer.mAllocations.erase(allocationIt);
+			}
+			else {
+				std::vector<RangeAllocator::Move> moves;
+				allocator.Defragment(generator() % 500U, moves);
+				for (const RangeAllocator::Move& move : moves) {
+					BRE_CHECK(ApplyMove(buffer, move));
+				}
+			}
+			BRE_CHECK(IsConsistent(allocator, buffer));
+		}
+
+		// Freeing everything merges all the free ranges
+		for (const std::pair<const unsigned int, unsigned int>& allocation : buffer.mAllocations) {
+			allocator.Free(allocation.first);
+		}
+		BRE_CHECK(allocator.UsedSize() == 0U);
+		BRE_CHECK(allocator.NumFreeRanges() == 1U);
+		BRE_CHECK(allocator.LargestFreeRange() == allocator.Capacity());
+	}
+}
+
+BRE_TEST(DefragmentMovesFreeSpaceToTheEnd) {
+	RangeAllocator allocator(1024U);
+	Buffer buffer;
+	buffer.mOwners.resize(allocator.Capacity(), 0U);
+	for (unsigned int i = 0U; i < 32U; ++i) {
+		const unsigned int offset = allocator.Allocate(32U);
+		BRE_CHECK(Own(buffer, offset, 32U, buffer.mNextOwner++));
+		buffer.mAllocations[offset] = 32U;
+	}
+	BRE_CHECK(allocator.FreeSize() == 0U);
+	BRE_CHECK(allocator.FragmentedSize() == 0U);
+
+	// Every other range is freed
+	for (unsigned int offset = 0U; offset < 1024U; offset += 64U) {
+		allocator.Free(offset);
+		buffer.mAllocations.erase(offset);
+		for (unsigned int i = offset; i < offset + 32U; ++i) {
+			buffer.mOwners[i] = 0U;
+		}
+	}
+	BRE_CHECK(allocator.FreeSize() == 512U);
+	BRE_CHECK(allocator.FragmentedSize() == 512U);
+	BRE_CHECK(allocator.NumFreeRanges() == 16U);
+
+	// The budget is at least maxElements, in whole ranges
+	std::vector<RangeAllocator::Move> moves;
+	allocator.Defragment(40U, moves);
+	BRE_CHECK(moves.size() == 2U);
+	while (!moves.empty()) {
+		for (const RangeAllocator::Move& move : moves) {
+			BRE_CHECK(ApplyMove(buffer, move));
+		}
+		moves.clear();
+		allocator.Defragment(64U, moves);
+	}
+	BRE_CHECK(IsConsistent(allocator, buffer));
+	BRE_CHECK(allocator.FragmentedSize() == 0U);
+	BRE_CHECK(allocator.NumFreeRanges() == 1U);
+	BRE_CHECK(allocator.LargestFreeRange() == 512U);
+	BRE_CHECK(buffer.mAllocations.rbegin()->first + buffer.mAllocations.rbegin()->second == 512U);
+}
+
+BRE_TEST(GrowAddsFreeSpaceAtTheEnd) {
+	RangeAllocator allocator(100U);
+	BRE_CHECK(allocator.Allocate(100U) == 0U);
+	BRE_CHECK(allocator.Allocate(1U) == RangeAllocator::sInvalidOffset);
+	allocator.Grow(300U);
+	BRE_CHECK(allocator.FreeSize() == 200U);
+	BRE_CHECK(allocator.FragmentedSize() == 0U);
+	BRE_CHECK(allocator.Allocate(150U) == 100U);
+	allocator.Free(0U);
+	BRE_CHECK(allocator.FragmentedSize() == 100U);
+	// The free end merges with the growth
+	allocator.Grow(400U);
+	BRE_CHECK(allocator.NumFreeRanges() == 2U);
+	BRE_CHECK(allocator.LargestFreeRange() == 150U);
+}
\ No newline at end of file
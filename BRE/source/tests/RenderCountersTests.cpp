@@ -0,0 +1,240 @@
+#include "TestFramework.h"
+
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include <general/CountedContext.h>
+#include <general/FramePipeline.h>
+#include <general/Profiler.h>
+
+using namespace BRE;
+
+namespace {
+	// Installs the profiler and the counters as global instances while they live
+	class ScopedCounters {
+	public:
+		explicit ScopedCounters(const size_t historySize = 240U)
+			: mCounters(historySize)
+		{
+			Profiler::gInstance = &mProfiler;
+			RenderCounters::gInstance = &mCounters;
+		}
+
+		~ScopedCounters() {
+			Profiler::gInstance = nullptr;
+			RenderCounters::gInstance = nullptr;
+		}
+
+		RenderCounters& Get() { return mCounters; }
+
+	private:
+		Profiler mProfiler;
+		RenderCounters mCounters;
+	};
+
+	struct MockShader {};
+	struct MockBuffer {};
+	struct MockView {};
+	struct MockSampler {};
+
+	// Immediate context stand-in with the signatures of the calls that
+	// CountedContext forwards. It records the calls it receives and does
+	// not touch the counters, so they only count what goes through
+	// CountedContext as the shader data classes and managers use it.
+	class MockContext {
+	public:
+		struct Calls {
+			unsigned int mShaders = 0U;
+			unsigned int mConstantBuffers = 0U;
+			unsigned int mViews = 0U;
+			unsigned int mSamplers = 0U;
+			unsigned int mGeometryBuffers = 0U;
+			unsigned int mDraws = 0U;
+			unsigned int mIndices = 0U;
+		};
+
+		void VSSetShader(MockShader* shader, void* const* /*classInstances*/, const unsigned int /*numClassInstances*/) { mCalls.mShaders += shader ? 1U : 0U; }
+		void PSSetShader(MockShader* shader, void* const* /*classInstances*/, const unsigned int /*numClassInstances*/) { mCalls.mShaders += shader ? 1U : 0U; }
+		void VSSetConstantBuffers(const unsigned int /*startSlot*/, const unsigned int numBuffers, MockBuffer* const* /*buffers*/) { mCalls.mConstantBuffers += numBuffers; }
+		void PSSetShaderResources(const unsigned int /*startSlot*/, const unsigned int numViews, MockView* const* /*views*/) { mCalls.mViews += numViews; }
+		void PSSetSamplers(const unsigned int /*startSlot*/, const unsigned int numSamplers, MockSampler* const* /*samplers*/) { mCalls.mSamplers += numSamplers; }
+		void IASetVertexBuffers(const unsigned int /*startSlot*/, const unsigned int numBuffers, MockBuffer* const* /*buffers*/, const unsigned int* /*strides*/, const unsigned int* /*offsets*/) { mCalls.mGeometryBuffers += numBuffers; }
+		void IASetIndexBuffer(MockBuffer* buffer, const int /*format*/, const unsigned int /*offset*/) { mCalls.mGeometryBuffers += buffer ? 1U : 0U; }
+		void DrawIndexed(const unsigned int indexCount, const unsigned int /*startIndex*/, const int /*baseVertex*/) {
+			++mCalls.mDraws;
+			mCalls.mIndices += indexCount;
+		}
+
+		// Calls received since the previous TakeCalls()
+		Calls TakeCalls() {
+			const Calls calls = mCalls;
+			mCalls = Calls();
+			return calls;
+		}
+
+	private:
+		Calls mCalls;
+	};
+
+	// Frame i draws i % 7 + 1 objects of 36 indices with 3 textures
+	unsigned int NumDraws(const std::uint64_t frame) {
+		return static_cast<unsigned int>(frame % 7U) + 1U;
+	}
+
+	// Geometry buffers are bound once per frame, as GeometryPool::Bind()
+	// does for a single vertex format
+	void DrawFrame(MockContext& context, const unsigned int numDraws) {
+		MockShader vertexShader;
+		MockShader pixelShader;
+		MockBuffer vertexBuffer;
+		MockBuffer indexBuffer;
+		MockBuffer constantBuffer;
+		MockView view;
+		MockSampler sampler;
+		MockBuffer* const vertexBuffers[] = { &vertexBuffer };
+		MockBuffer* const constantBuffers[] = { &constantBuffer };
+		MockView* const views[] = { &view, &view, &view };
+		MockSampler* const samplers[] = { &sampler };
+		const unsigned int stride = 32U;
+		const unsigned int offset = 0U;
+		CountedContext::IASetVertexBuffers(context, 0U, 1U, vertexBuffers, &stride, &offset);
+		CountedContext::IASetIndexBuffer(context, &indexBuffer, 0, 0U);
+		for (unsigned int i = 0U; i < numDraws; ++i) {
+			CountedContext::VSSetShader(context, &vertexShader);
+			CountedContext::PSSetShader(context, &pixelShader);
+			CountedContext::VSSetConstantBuffers(context, 0U, 1U, constantBuffers);
+			CountedContext::PSSetShaderResources(context, 0U, 3U, views);
+			CountedContext::PSSetSamplers(context, 0U, 1U, samplers);
+			CountedContext::DrawIndexed(context, 36U, 0U, 0);
+			// Unbinding after the draw is not counted
+			context.PSSetShader(nullptr, nullptr, 0U);
+		}
+	}
+
+	bool CountersMatchCalls(const RenderCounters::Frame& frame, const MockContext::Calls& calls) {
+		return frame[RenderCounter::ShaderBinds] == calls.mShaders
+			&& frame[RenderCounter::ConstantBufferBinds] == calls.mConstantBuffers
+			&& frame[RenderCounter::SRVBinds] == calls.mViews
+			&& frame[RenderCounter::SamplerBinds] == calls.mSamplers
+			&& frame[RenderCounter::GeometryBufferBinds] == calls.mGeometryBuffers
+			&& frame[RenderCounter::DrawCalls] == calls.mDraws
+			&& frame[RenderCounter::Indices] == calls.mIndices;
+	}
+}
+
+BRE_TEST(EndFrameFoldsAndResets) {
+	ScopedCounters scopedCounters;
+	RenderCounters& counters = scopedCounters.Get();
+	BRE_CHECK(counters.HistorySize() == 0U);
+	BRE_CHECK(counters.Average(RenderCounter::DrawCalls) == 0.0);
+
+	BRE_COUNTER_ADD(RenderCounter::DrawCalls, 3U);
+	BRE_COUNTER_ADD(RenderCounter::DrawCalls, 2U);
+	BRE_COUNTER_ADD(RenderCounter::UploadBytes, 256U);
+	counters.EndFrame();
+	BRE_CHECK(counters.LastFrame()[RenderCounter::DrawCalls] == 5U);
+	BRE_CHECK(counters.LastFrame()[RenderCounter::UploadBytes] == 256U);
+	BRE_CHECK(counters.LastFrame()[RenderCounter::Lights] == 0U);
+
+	counters.EndFrame();
+	BRE_CHECK(counters.LastFrame()[RenderCounter::DrawCalls] == 0U);
+	BRE_CHECK(counters.HistorySize() == 2U);
+	BRE_CHECK(counters.History(1U)[RenderCounter::DrawCalls] == 5U);
+}
+
+BRE_TEST(HistoryKeepsTheLastFrames) {
+	ScopedCounters scopedCounters(4U);
+	RenderCounters& counters = scopedCounters.Get();
+	for (std::uint64_t frame = 1U; frame <= 6U; ++frame) {
+		BRE_COUNTER_ADD(RenderCounter::Indices, frame * 10U);
+		counters.EndFrame();
+	}
+	BRE_CHECK(counters.HistorySize() == 4U);
+	BRE_CHECK(counters.History(0U)[RenderCounter::Indices] == 60U);
+	BRE_CHECK(counters.History(3U)[RenderCounter::Indices] == 30U);
+	BRE_CHECK(counters.Max(RenderCounter::Indices) == 60U);
+	BRE_CHECK_NEAR(counters.Average(RenderCounter::Indices), 45.0, 1.0e-9);
+}
+
+BRE_TEST(CountsOfEveryThreadAreFolded) {
+	ScopedCounters scopedCounters;
+	RenderCounters& counters = scopedCounters.Get();
+	std::vector<std::thread> threads;
+	for (int i = 0; i < 4; ++i) {
+		threads.emplace_back([]() {
+			for (int j = 0; j < 1000; ++j) {
+				BRE_COUNTER_ADD(RenderCounter::SRVBinds, 1U);
+			}
+		});
+	}
+	for (std::thread& thread : threads) {
+		thread.join();
+	}
+	BRE_COUNTER_ADD(RenderCounter::SRVBinds, 1U);
+	counters.EndFrame();
+	BRE_CHECK(counters.LastFrame()[RenderCounter::SRVBinds] == 4001U);
+}
+
+BRE_TEST(ContextCallsAreCounted) {
+	ScopedCounters scopedCounters;
+	RenderCounters& counters = scopedCounters.Get();
+	MockContext context;
+	DrawFrame(context, 4U);
+	counters.EndFrame();
+	const MockContext::Calls calls = context.TakeCalls();
+	BRE_CHECK(calls.mDraws == 4U);
+	BRE_CHECK(calls.mShaders == 8U);
+	BRE_CHECK(CountersMatchCalls(counters.LastFrame(), calls));
+	BRE_CHECK(counters.LastFrame()[RenderCounter::GeometryBufferBinds] == 2U);
+	BRE_CHECK(counters.LastFrame()[RenderCounter::SamplerBinds] == 4U);
+}
+
+BRE_TEST(NamesMatchCounters) {
+	BRE_CHECK(std::strcmp(RenderCounters::Name(RenderCounter::PreDrawCalls), "PreDrawCalls") == 0);
+	BRE_CHECK(std::strcmp(RenderCounters::Name(RenderCounter::GeometryBufferBinds), "GeometryBufferBinds") == 0);
+}
+
+// Frames are folded at the end of submission, as Application::Submit() does,
+// so every history entry holds exactly the counts of one submitted frame
+// while simulation runs frames ahead on another thread.
+BRE_TEST(PipelinedFramesAreCountedWhole) {
+	for (unsigned int frameLatency = 0U; frameLatency <= FramePipeline::sMaxFrameLatency; ++frameLatency) {
+		const std::uint64_t numFrames = 200U;
+		ScopedCounters scopedCounters(static_cast<size_t>(numFrames));
+		RenderCounters& counters = scopedCounters.Get();
+		MockContext context;
+		std::vector<MockContext::Calls> submittedCalls;
+		{
+			FramePipeline pipeline(frameLatency, [&](const FrameSnapshot& frame) {
+				DrawFrame(context, NumDraws(frame.mFrameIndex));
+				counters.EndFrame();
+				submittedCalls.push_back(context.TakeCalls());
+			});
+			for (std::uint64_t i = 0U; i < numFrames; ++i) {
+				FrameSnapshot& frame = pipeline.BeginFrame();
+				BRE_CHECK(frame.mFrameIndex == i);
+				// Simulation work that is not counted
+				std::this_thread::yield();
+				pipeline.EndFrame();
+			}
+		}
+
+		BRE_CHECK(counters.HistorySize() == numFrames);
+		BRE_CHECK(submittedCalls.size() == numFrames);
+		bool framesMatch = true;
+		for (std::uint64_t i = 0U; i < numFrames && i < submittedCalls.size(); ++i) {
+			const RenderCounters::Frame& frame = counters.History(static_cast<size_t>(numFrames - 1U - i));
+			const std::uint64_t numDraws = NumDraws(i);
+			framesMatch = framesMatch
+				&& CountersMatchCalls(frame, submittedCalls[static_cast<size_t>(i)])
+				&& frame[RenderCounter::DrawCalls] == numDraws
+				&& frame[RenderCounter::Indices] == numDraws * 36U
+				&& frame[RenderCounter::ShaderBinds] == numDraws * 2U
+				&& frame[RenderCounter::SRVBinds] == numDraws * 3U
+				&& frame[RenderCounter::ConstantBufferBinds] == numDraws
+				&& frame[RenderCounter::GeometryBufferBinds] == 2U;
+		}
+		BRE_CHECK(framesMatch);
+	}
+}
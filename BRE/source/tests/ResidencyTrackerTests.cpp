@@ -0,0 +1,168 @@
+#include "TestFramework.h"
+
+#include <vector>
+
+#include <streaming/ResidencyTracker.h>
+
+using namespace BRE;
+
+namespace {
+	typedef ResidencyTracker::State State;
+}
+
+BRE_TEST(EntriesStartRegisteredOrResident) {
+	ResidencyTracker tracker(2U);
+	const size_t registered = tracker.Add();
+	const size_t resident = tracker.AddResident();
+	BRE_CHECK(tracker.NumEntries() == 2U);
+	BRE_CHECK(tracker.GetState(registered) == State::Registered);
+	BRE_CHECK(tracker.GetState(resident) == State::Resident);
+	BRE_CHECK(!tracker.IsResident(registered));
+	BRE_CHECK(tracker.IsResident(resident));
+	BRE_CHECK(tracker.NumResident() == 1U);
+	BRE_CHECK(tracker.NumQueued() == 0U);
+
+	// Nothing is loaded until it is requested
+	std::vector<size_t> loads;
+	tracker.Update(loads);
+	BRE_CHECK(loads.empty());
+	BRE_CHECK(tracker.GetState(registered) == State::Registered);
+}
+
+BRE_TEST(RequestedEntriesBecomeResident) {
+	ResidencyTracker tracker(2U);
+	const size_t entry = tracker.Add();
+	tracker.Request(entry);
+	BRE_CHECK(tracker.GetState(entry) == State::Queued);
+	BRE_CHECK(tracker.NumQueued() == 1U);
+
+	std::vector<size_t> loads;
+	tracker.Update(loads);
+	BRE_CHECK(loads.size() == 1U && loads[0] == entry);
+	BRE_CHECK(tracker.GetState(entry) == State::Loading);
+	BRE_CHECK(tracker.NumQueued() == 0U);
+	BRE_CHECK(tracker.NumResident() == 0U);
+
+	tracker.OnLoaded(entry, true);
+	BRE_CHECK(tracker.GetState(entry) == State::Resident);
+	BRE_CHECK(tracker.NumResident() == 1U);
+
+	// Loads are handed out once
+	tracker.Update(loads);
+	BRE_CHECK(loads.empty());
+}
+
+BRE_TEST(FailedLoadsAreNotRetried) {
+	ResidencyTracker tracker(2U);
+	const size_t entry = tracker.Add();
+	tracker.Request(entry);
+	std::vector<size_t> loads;
+	tracker.Update(loads);
+	tracker.OnLoaded(entry, false);
+	BRE_CHECK(tracker.GetState(entry) == State::Failed);
+	BRE_CHECK(!tracker.IsResident(entry));
+	BRE_CHECK(tracker.NumResident() == 0U);
+
+	tracker.Request(entry);
+	BRE_CHECK(tracker.GetState(entry) == State::Failed);
+	tracker.Update(loads);
+	BRE_CHECK(loads.empty());
+}
+
+BRE_TEST(RequestsAreIgnoredOutsideRegistered) {
+	ResidencyTracker tracker(1U);
+	const size_t queued = tracker.Add();
+	const size_t loading = tracker.Add();
+	const size_t resident = tracker.AddResident();
+
+	tracker.Request(loading);
+	std::vector<size_t> loads;
+	tracker.Update(loads);
+	tracker.Request(queued);
+	BRE_CHECK(tracker.GetState(queued) == State::Queued);
+	BRE_CHECK(tracker.GetState(loading) == State::Loading);
+
+	// Drawers request every frame the material is visible and not resident
+	for (int i = 0; i < 3; ++i) {
+		tracker.Request(queued);
+		tracker.Request(loading);
+		tracker.Request(resident);
+	}
+	BRE_CHECK(tracker.NumQueued() == 1U);
+	BRE_CHECK(tracker.GetState(queued) == State::Queued);
+	BRE_CHECK(tracker.GetState(loading) == State::Loading);
+	BRE_CHECK(tracker.GetState(resident) == State::Resident);
+
+	tracker.OnLoaded(loading, true);
+	tracker.Update(loads);
+	BRE_CHECK(loads.size() == 1U && loads[0] == queued);
+}
+
+// More requests than loads per update: the rest stay queued for the next
+// frames and are handed out in request order.
+BRE_TEST(LoadsPerUpdateAreBudgeted) {
+	ResidencyTracker tracker(3U);
+	std::vector<size_t> entries;
+	for (int i = 0; i < 8; ++i) {
+		entries.push_back(tracker.Add());
+	}
+	// Requested in reverse order
+	for (size_t i = entries.size(); i > 0U; --i) {
+		tracker.Request(entries[i - 1U]);
+	}
+	BRE_CHECK(tracker.NumQueued() == 8U);
+
+	std::vector<size_t> loads;
+	std::vector<size_t> loadOrder;
+	std::vector<size_t> loadsPerUpdate;
+	while (tracker.NumQueued() > 0U) {
+		tracker.Update(loads);
+		loadsPerUpdate.push_back(loads.size());
+		for (const size_t entry : loads) {
+			BRE_CHECK(tracker.GetState(entry) == State::Loading);
+			loadOrder.push_back(entry);
+		}
+		// Requested entries never go back to Registered
+		for (const size_t entry : entries) {
+			BRE_CHECK(tracker.GetState(entry) != State::Registered);
+		}
+		for (const size_t entry : loads) {
+			tracker.OnLoaded(entry, true);
+		}
+	}
+	BRE_CHECK(loadsPerUpdate == std::vector<size_t>({ 3U, 3U, 2U }));
+	BRE_CHECK(loadOrder.size() == 8U);
+	bool inRequestOrder = loadOrder.size() == 8U;
+	for (size_t i = 0U; i < loadOrder.size() && inRequestOrder; ++i) {
+		inRequestOrder = loadOrder[i] == entries[entries.size() - 1U - i];
+	}
+	BRE_CHECK(inRequestOrder);
+	BRE_CHECK(tracker.NumResident() == 8U);
+}
+
+// Loads handed out in one update can end in a later frame, while new
+// requests keep being queued behind the budget.
+BRE_TEST(LoadsCanEndInLaterFrames) {
+	ResidencyTracker tracker(2U);
+	const size_t a = tracker.Add();
+	const size_t b = tracker.Add();
+	const size_t c = tracker.Add();
+	tracker.Request(a);
+	tracker.Request(b);
+	std::vector<size_t> loads;
+	tracker.Update(loads);
+	BRE_CHECK(loads.size() == 2U);
+
+	tracker.Request(c);
+	tracker.OnLoaded(b, false);
+	tracker.Update(loads);
+	BRE_CHECK(loads.size() == 1U && loads[0] == c);
+	BRE_CHECK(tracker.GetState(a) == State::Loading);
+	BRE_CHECK(tracker.GetState(b) == State::Failed);
+	BRE_CHECK(tracker.GetState(c) == State::Loading);
+
+	tracker.OnLoaded(c, true);
+	tracker.OnLoaded(a, true);
+	BRE_CHECK(tracker.NumResident() == 2U);
+	BRE_CHECK(tracker.IsResident(a) && !tracker.IsResident(b) && tracker.IsResident(c));
+}
\ No newline at end of file
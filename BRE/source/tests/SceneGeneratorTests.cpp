@@ -0,0 +1,141 @@
+#include "TestFramework.h"
+
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include <yaml-cpp/yaml.h>
+
+#include <rendering/shaders/DrawerSettings.h>
+#include <sceneGenerator/SceneGenerator.h>
+#include <utils/YamlUtils.h>
+
+using namespace BRE;
+
+namespace {
+	const char* sModelsFilepath = "scene_generator_test_models.yml";
+	const char* sMaterialsFilepath = "scene_generator_test_materials.yml";
+	const char* sLightsFilepath = "scene_generator_test_lights.yml";
+
+	SceneGenerator::Settings SmallSceneSettings(const char* renderType) {
+		SceneGenerator::Settings settings = SceneGenerator::DefaultSettings();
+		settings.mNumObjects = 50U;
+		settings.mNumMaterials = 7U;
+		settings.mNumLights = 20U;
+		settings.mRenderType = renderType;
+		return settings;
+	}
+
+	std::string ReadText(const char* filepath) {
+		std::ifstream stream(filepath);
+		std::stringstream contents;
+		contents << stream.rdbuf();
+		return contents.str();
+	}
+}
+
+// Every generated model is read as DrawManager reads it before it creates
+// the drawers of the node.
+BRE_TEST(GeneratedModelsHaveTheKeysOfTheirRenderType) {
+	const char* renderTypes[] = { "Basic", "Normal", "Normal_Displacement" };
+	for (const char* renderType : renderTypes) {
+		const SceneGenerator::Settings settings = SmallSceneSettings(renderType);
+		SceneGenerator::Result result;
+		BRE_CHECK(SceneGenerator::Generate(settings, sModelsFilepath, sMaterialsFilepath, sLightsFilepath, result));
+		BRE_CHECK(result.mNumObjects == settings.mNumObjects);
+
+		const YAML::Node models = YAML::LoadFile(sModelsFilepath)["models"];
+		BRE_CHECK(models.IsSequence() && models.size() == settings.mNumObjects);
+		for (const YAML::Node& node : models) {
+			DrawerSettings drawerSettings;
+			BRE_CHECK(DrawerSettings::Read(node, drawerSettings));
+			BRE_CHECK(drawerSettings.mRenderType == renderType);
+			BRE_CHECK(drawerSettings.mMaterial.find("generated_material_") == 0U);
+			BRE_CHECK(drawerSettings.mNormalMapTexture.empty());
+			if (drawerSettings.mRenderType == "Normal_Displacement") {
+				BRE_CHECK(drawerSettings.mDisplacementMapTexture.find("_height.dds") != std::string::npos);
+				BRE_CHECK(drawerSettings.mDisplacementScale == settings.mDisplacementScale);
+				BRE_CHECK(drawerSettings.mMinTessellationFactor == settings.mMinTessellationFactor);
+				BRE_CHECK(drawerSettings.mMaxTessellationFactor == settings.mMaxTessellationFactor);
+			}
+			if (drawerSettings.mRenderType != "Basic") {
+				BRE_CHECK(drawerSettings.mTextureScaleFactor == settings.mTextureScaleFactor);
+			}
+			float translation[3];
+			YamlUtils::GetSequence<float>(node, "translation", translation, 3U);
+			BRE_CHECK(translation[0] >= -settings.mExtent && translation[0] <= settings.mExtent);
+		}
+	}
+}
+
+BRE_TEST(FloatsAreReadBackExactly) {
+	SceneGenerator::Settings settings = SmallSceneSettings("Normal_Displacement");
+	settings.mTextureScaleFactor = 1.0f / 3.0f;
+	settings.mDisplacementScale = 0.123456789f;
+	settings.mMaxTessellationFactor = 16.0f + 1.0f / 7.0f;
+	settings.mLightPower = 123456.789f;
+	SceneGenerator::Result result;
+	BRE_CHECK(SceneGenerator::Generate(settings, sModelsFilepath, sMaterialsFilepath, sLightsFilepath, result));
+
+	const YAML::Node models = YAML::LoadFile(sModelsFilepath)["models"];
+	DrawerSettings drawerSettings;
+	BRE_CHECK(DrawerSettings::Read(models[0], drawerSettings));
+	BRE_CHECK(drawerSettings.mTextureScaleFactor == settings.mTextureScaleFactor);
+	BRE_CHECK(drawerSettings.mDisplacementScale == settings.mDisplacementScale);
+	BRE_CHECK(drawerSettings.mMaxTessellationFactor == settings.mMaxTessellationFactor);
+
+	const YAML::Node lights = YAML::LoadFile(sLightsFilepath)["pointLights"];
+	BRE_CHECK(lights.IsSequence() && lights.size() == settings.mNumLights);
+	BRE_CHECK(YamlUtils::GetScalar<float>(lights[0], "power") == settings.mLightPower);
+}
+
+BRE_TEST(SameSettingsGenerateTheSameScene) {
+	const SceneGenerator::Settings settings = SmallSceneSettings("Normal");
+	SceneGenerator::Result result;
+	BRE_CHECK(SceneGenerator::Generate(settings, sModelsFilepath, sMaterialsFilepath, sLightsFilepath, result));
+	const std::string models = ReadText(sModelsFilepath);
+	const std::string lights = ReadText(sLightsFilepath);
+	BRE_CHECK(SceneGenerator::Generate(settings, sModelsFilepath, sMaterialsFilepath, sLightsFilepath, result));
+	BRE_CHECK(ReadText(sModelsFilepath) == models);
+	BRE_CHECK(ReadText(sLightsFilepath) == lights);
+
+	SceneGenerator::Settings otherSeed = settings;
+	otherSeed.mSeed = settings.mSeed + 1U;
+	BRE_CHECK(SceneGenerator::Generate(otherSeed, sModelsFilepath, sMaterialsFilepath, sLightsFilepath, result));
+	BRE_CHECK(ReadText(sModelsFilepath) != models);
+}
+
+BRE_TEST(MaterialsHaveEveryTexture) {
+	const SceneGenerator::Settings settings = SmallSceneSettings("Normal");
+	SceneGenerator::Result result;
+	BRE_CHECK(SceneGenerator::Generate(settings, sModelsFilepath, sMaterialsFilepath, sLightsFilepath, result));
+	const YAML::Node materials = YAML::LoadFile(sMaterialsFilepath)["materials"];
+	BRE_CHECK(materials.IsSequence() && materials.size() == settings.mNumMaterials);
+	const char* keys[] = { "name", "normal", "baseColor", "smoothness", "metalMask", "curvature" };
+	for (const YAML::Node& material : materials) {
+		for (const char* key : keys) {
+			BRE_CHECK(YamlUtils::IsDefined(material, key));
+		}
+	}
+}
+
+BRE_TEST(InvalidSettingsAreRejected) {
+	SceneGenerator::Result result;
+	SceneGenerator::Settings settings = SmallSceneSettings("Unknown");
+	BRE_CHECK(!SceneGenerator::Generate(settings, sModelsFilepath, sMaterialsFilepath, sLightsFilepath, result));
+	settings = SmallSceneSettings("Normal_Displacement");
+	settings.mMinTessellationFactor = 32.0f;
+	BRE_CHECK(!SceneGenerator::Generate(settings, sModelsFilepath, sMaterialsFilepath, sLightsFilepath, result));
+}
+
+BRE_TEST(MissingKeysAreReported) {
+	DrawerSettings drawerSettings;
+	BRE_CHECK(DrawerSettings::Read(YAML::Load("{renderType: Basic, path: a.obj, material: m}"), drawerSettings));
+	BRE_CHECK(!DrawerSettings::Read(YAML::Load("{renderType: Normal, path: a.obj, material: m}"), drawerSettings));
+	BRE_CHECK(DrawerSettings::Read(YAML::Load("{renderType: Normal, path: a.obj, material: m, textureScaleFactor: 2.0}"), drawerSettings));
+	BRE_CHECK(drawerSettings.mTextureScaleFactor == 2.0f);
+	BRE_CHECK(!DrawerSettings::Read(YAML::Load("{renderType: Normal_Displacement, path: a.obj, material: m, textureScaleFactor: 1.0, displacementScale: 1.0}"), drawerSettings));
+	BRE_CHECK(DrawerSettings::Read(YAML::Load("{renderType: Normal_Displacement, path: a.obj, material: m, textureScaleFactor: 1.0, displacementMapTexture: h.dds, displacementScale: 1.0, tessellationFactor: 4.0}"), drawerSettings));
+	BRE_CHECK(drawerSettings.mMinTessellationFactor == 4.0f && drawerSettings.mMaxTessellationFactor == 4.0f);
+	BRE_CHECK(!DrawerSettings::Read(YAML::Load("{renderType: Other, path: a.obj, material: m}"), drawerSettings));
+}
\ No newline at end of file
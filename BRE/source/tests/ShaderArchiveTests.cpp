@@ -0,0 +1,162 @@
+#include "TestFramework.h"
+
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <utils/ShaderArchive.h>
+
+using namespace BRE;
+
+namespace {
+	// Two render types sharing a pixel shader, one vertex shader with an input layout
+	void MakeShaders(std::vector<ShaderArchive::ShaderDesc>& shaders, std::vector<ShaderArchive::RenderTypeDesc>& renderTypes) {
+		shaders.resize(3U);
+		shaders[0].mName = "content\\shaders\\A_VS.cso";
+		shaders[0].mType = ShaderArchive::ShaderType::Vertex;
+		shaders[0].mByteCode.assign(37U, 1U);
+		ShaderArchive::InputElementDesc element;
+		element.mSemanticName = "POSITION";
+		// DXGI_FORMAT_R32G32B32_FLOAT
+		element.mFormat = 6U;
+		element.mAlignedByteOffset = 0U;
+		shaders[0].mInputLayout.push_back(element);
+		element.mSemanticName = "TEXCOORD";
+		// DXGI_FORMAT_R32G32_FLOAT
+		element.mFormat = 16U;
+		element.mAlignedByteOffset = ShaderArchive::sAppendAligned;
+		shaders[0].mInputLayout.push_back(element);
+
+		shaders[1].mName = "content\\shaders\\A_PS.cso";
+		shaders[1].mType = ShaderArchive::ShaderType::Pixel;
+		shaders[1].mByteCode.assign(5U, 2U);
+
+		shaders[2].mName = "content\\shaders\\B_VS.cso";
+		shaders[2].mType = ShaderArchive::ShaderType::Vertex;
+		shaders[2].mByteCode.assign(100U, 3U);
+
+		renderTypes.resize(2U);
+		renderTypes[0].mName = "A";
+		renderTypes[0].mShaders = { 0U, 1U };
+		renderTypes[1].mName = "B";
+		renderTypes[1].mShaders = { 2U, 1U };
+	}
+}
+
+BRE_TEST(BuiltArchivesOpen) {
+	std::vector<ShaderArchive::ShaderDesc> shaders;
+	std::vector<ShaderArchive::RenderTypeDesc> renderTypes;
+	MakeShaders(shaders, renderTypes);
+	std::vector<std::uint8_t> data;
+	std::string error;
+	BRE_CHECK(ShaderArchive::Build(shaders, renderTypes, data, error));
+
+	ShaderArchive archive;
+	BRE_CHECK(!archive.IsOpen());
+	BRE_CHECK(archive.Open(data.data(), data.size(), error));
+	BRE_CHECK(archive.IsOpen());
+	BRE_CHECK(archive.NumShaders() == 3U);
+	for (size_t i = 0U; i < shaders.size(); ++i) {
+		size_t shader;
+		BRE_CHECK(archive.Find(shaders[i].mName.c_str(), shader));
+		BRE_CHECK(shader == i);
+		BRE_CHECK(shaders[i].mName == archive.ShaderName(i));
+		const ShaderArchive::Shader& archiveShader = archive.GetShader(i);
+		BRE_CHECK(archiveShader.mType == shaders[i].mType);
+		BRE_CHECK(archiveShader.mByteCodeSize == shaders[i].mByteCode.size());
+		BRE_CHECK(archiveShader.mNumInputElements == shaders[i].mInputLayout.size());
+		// Bytecode is used in place and 16 bytes aligned
+		BRE_CHECK(reinterpret_cast<std::uintptr_t>(archive.ByteCode(i)) % 16U == 0U);
+		BRE_CHECK(memcmp(archive.ByteCode(i), shaders[i].mByteCode.data(), shaders[i].mByteCode.size()) == 0);
+	}
+	size_t shader;
+	BRE_CHECK(!archive.Find("content\\shaders\\C_VS.cso", shader));
+
+	const ShaderArchive::InputElement& texCoord = archive.GetInputElement(0U, 1U);
+	BRE_CHECK(std::string(archive.SemanticName(texCoord)) == "TEXCOORD");
+	BRE_CHECK(texCoord.mFormat == 16U);
+	BRE_CHECK(texCoord.mAlignedByteOffset == ShaderArchive::sAppendAligned);
+
+	BRE_CHECK(archive.NumRenderTypes() == 2U);
+	BRE_CHECK(std::string(archive.RenderTypeName(1U)) == "B");
+	size_t numShaders;
+	const std::uint32_t* renderTypeShaders = archive.RenderTypeShaders(1U, numShaders);
+	BRE_CHECK(numShaders == 2U);
+	BRE_CHECK(renderTypeShaders[0] == 2U);
+	BRE_CHECK(renderTypeShaders[1] == 1U);
+}
+
+BRE_TEST(InvalidDescriptionsAreNotBuilt) {
+	std::vector<ShaderArchive::ShaderDesc> shaders;
+	std::vector<ShaderArchive::RenderTypeDesc> renderTypes;
+	MakeShaders(shaders, renderTypes);
+	std::vector<std::uint8_t> data;
+	std::string error;
+
+	std::vector<ShaderArchive::ShaderDesc> repeatedNames(shaders);
+	repeatedNames[1].mName = repeatedNames[0].mName;
+	BRE_CHECK(!ShaderArchive::Build(repeatedNames, renderTypes, data, error));
+	BRE_CHECK(!error.empty());
+
+	std::vector<ShaderArchive::ShaderDesc> emptyByteCode(shaders);
+	emptyByteCode[2].mByteCode.clear();
+	BRE_CHECK(!ShaderArchive::Build(emptyByteCode, renderTypes, data, error));
+
+	std::vector<ShaderArchive::ShaderDesc> pixelLayout(shaders);
+	pixelLayout[1].mInputLayout = shaders[0].mInputLayout;
+	BRE_CHECK(!ShaderArchive::Build(pixelLayout, renderTypes, data, error));
+
+	std::vector<ShaderArchive::RenderTypeDesc> outOfRange(renderTypes);
+	outOfRange[0].mShaders.push_back(shaders.size());
+	BRE_CHECK(!ShaderArchive::Build(shaders, outOfRange, data, error));
+
+	BRE_CHECK(ShaderArchive::Build(shaders, renderTypes, data, error));
+}
+
+BRE_TEST(CorruptedArchivesAreRejectedOrReadSafely) {
+	std::vector<ShaderArchive::ShaderDesc> shaders;
+	std::vector<ShaderArchive::RenderTypeDesc> renderTypes;
+	MakeShaders(shaders, renderTypes);
+	std::vector<std::uint8_t> data;
+	std::string error;
+	BRE_CHECK(ShaderArchive::Build(shaders, renderTypes, data, error));
+
+	ShaderArchive archive;
+	BRE_CHECK(!archive.Open(data.data(), sizeof(ShaderArchive::Header) - 1U, error));
+	BRE_CHECK(!error.empty());
+
+	std::mt19937 generator(3U);
+	for (unsigned int i = 0U; i < 5000U; ++i) {
+		std::vector<std::uint8_t> corrupted(data);
+		for (unsigned int j = 0U; j <= i % 4U; ++j) {
+			corrupted[generator() % corrupted.size()] ^= static_cast<std::uint8_t>(1U + generator() % 255U);
+		}
+		const size_t size = (i % 5U) == 0U ? generator() % corrupted.size() : corrupted.size();
+		// Every accessor of an opened archive stays in its memory
+		ShaderArchive corruptedArchive;
+		if (!corruptedArchive.Open(corrupted.data(), size, error)) {
+			continue;
+		}
+		volatile std::uint8_t sink = 0U;
+		for (size_t shader = 0U; shader < corruptedArchive.NumShaders(); ++shader) {
+			const ShaderArchive::Shader& archiveShader = corruptedArchive.GetShader(shader);
+			sink = sink + static_cast<std::uint8_t>(*corruptedArchive.ShaderName(shader));
+			if (archiveShader.mByteCodeSize > 0U) {
+				sink = sink + corruptedArchive.ByteCode(shader)[archiveShader.mByteCodeSize - 1U];
+			}
+			for (size_t element = 0U; element < archiveShader.mNumInputElements; ++element) {
+				sink = sink + static_cast<std::uint8_t>(*corruptedArchive.SemanticName(corruptedArchive.GetInputElement(shader, element)));
+			}
+		}
+		for (size_t renderType = 0U; renderType < corruptedArchive.NumRenderTypes(); ++renderType) {
+			size_t numShaders;
+			const std::uint32_t* renderTypeShaders = corruptedArchive.RenderTypeShaders(renderType, numShaders);
+			for (size_t j = 0U; j < numShaders; ++j) {
+				BRE_CHECK(renderTypeShaders[j] < corruptedArchive.NumShaders());
+			}
+			sink = sink + static_cast<std::uint8_t>(*corruptedArchive.RenderTypeName(renderType));
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,97 @@
+#include "TestFramework.h"
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include <utils/SnapshotRing.h>
+
+using namespace BRE;
+
+namespace {
+	struct Snapshot {
+		std::uint64_t mFrame = 0U;
+		std::vector<std::uint64_t> mValues;
+	};
+}
+
+BRE_TEST(SlotsAreHandedInOrder) {
+	SnapshotRing<Snapshot> ring(3U);
+	BRE_CHECK(ring.NumSlots() == 3U);
+	BRE_CHECK(ring.NumPending() == 0U);
+	BRE_CHECK(ring.TryBeginRead() == nullptr);
+
+	// The producer can publish every slot
+	for (std::uint64_t frame = 0U; frame < 3U; ++frame) {
+		Snapshot* snapshot = ring.TryBeginWrite();
+		BRE_CHECK(snapshot != nullptr);
+		snapshot->mFrame = frame;
+		ring.EndWrite();
+	}
+	BRE_CHECK(ring.NumPending() == 3U);
+	BRE_CHECK(ring.TryBeginWrite() == nullptr);
+
+	const Snapshot* snapshot = ring.TryBeginRead();
+	BRE_CHECK(snapshot != nullptr && snapshot->mFrame == 0U);
+	// A slot being read is not free yet
+	BRE_CHECK(ring.TryBeginWrite() == nullptr);
+	ring.EndRead();
+	BRE_CHECK(ring.NumPending() == 2U);
+
+	Snapshot* reused = ring.TryBeginWrite();
+	BRE_CHECK(reused != nullptr);
+	BRE_CHECK(reused == snapshot);
+	BRE_CHECK(reused->mFrame == 0U);
+	reused->mFrame = 3U;
+	ring.EndWrite();
+
+	for (std::uint64_t frame = 1U; frame <= 3U; ++frame) {
+		snapshot = ring.TryBeginRead();
+		BRE_CHECK(snapshot != nullptr && snapshot->mFrame == frame);
+		ring.EndRead();
+	}
+	BRE_CHECK(ring.TryBeginRead() == nullptr);
+	BRE_CHECK(ring.NumPending() == 0U);
+}
+
+BRE_TEST(ThreadsSeeWholeSnapshots) {
+	const std::uint64_t numFrames = 100000U;
+	for (size_t numSlots = 1U; numSlots <= 3U; ++numSlots) {
+		SnapshotRing<Snapshot> ring(numSlots);
+		std::atomic<unsigned int> numBadSnapshots(0U);
+		std::thread consumer([&]() {
+			for (std::uint64_t frame = 0U; frame < numFrames;) {
+				const Snapshot* snapshot = ring.TryBeginRead();
+				if (snapshot == nullptr) {
+					std::this_thread::yield();
+					continue;
+				}
+				bool valid = snapshot->mFrame == frame && snapshot->mValues.size() == frame % 5U;
+				for (const std::uint64_t value : snapshot->mValues) {
+					valid = valid && value == frame;
+				}
+				if (!valid) {
+					++numBadSnapshots;
+				}
+				ring.EndRead();
+				++frame;
+			}
+		});
+
+		for (std::uint64_t frame = 0U; frame < numFrames;) {
+			Snapshot* snapshot = ring.TryBeginWrite();
+			if (snapshot == nullptr) {
+				std::this_thread::yield();
+				continue;
+			}
+			snapshot->mFrame = frame;
+			snapshot->mValues.assign(static_cast<size_t>(frame % 5U), frame);
+			ring.EndWrite();
+			++frame;
+		}
+		consumer.join();
+		BRE_CHECK(numBadSnapshots.load() == 0U);
+		BRE_CHECK(ring.NumPending() == 0U);
+	}
+}
\ No newline at end of file
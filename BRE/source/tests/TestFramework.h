@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cmath>
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Minimal test registration for the portable RenderingLib components.
+// BRE_TEST(Name) defines a test function registered before main().
+// BRE_CHECK(condition) reports a failed condition and lets the test go on.
+// BRE_CHECK_NEAR(a, b, epsilon) compares floating point values.
+// Every test executable runs all its tests (or the ones whose name is
+// given in the command line) and returns non zero if a check failed.
+//
+//////////////////////////////////////////////////////////////////////////
+
+namespace BRE {
+	namespace Test {
+		typedef void(*TestFunction)();
+
+		class Registrar {
+		public:
+			Registrar(const char* name, const TestFunction function);
+		};
+
+		void ReportFailure(const char* file, const int line, const char* condition);
+		int RunAll(const int argc, char** argv);
+	}
+}
+
+#define BRE_TEST(name) \
+	static void name(); \
+	static const BRE::Test::Registrar name##Registrar(#name, &name); \
+	static void name()
+
+#define BRE_CHECK(condition) \
+	do { \
+		if (!(condition)) { \
+			BRE::Test::ReportFailure(__FILE__, __LINE__, #condition); \
+		} \
+	} while (false)
+
+#define BRE_CHECK_NEAR(a, b, epsilon) \
+	BRE_CHECK(std::fabs(static_cast<double>(a) - static_cast<double>(b)) <= static_cast<double>(epsilon))
@@ -0,0 +1,72 @@
+#include "TestFramework.h"
+
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+namespace {
+	struct RegisteredTest {
+		const char* mName;
+		BRE::Test::TestFunction mFunction;
+	};
+
+	// Function local, so registrars of any translation unit can use it
+	std::vector<RegisteredTest>& Tests() {
+		static std::vector<RegisteredTest> tests;
+		return tests;
+	}
+
+	unsigned int sFailures = 0U;
+
+	bool IsSelected(const char* name, const int argc, char** argv) {
+		if (argc < 2) {
+			return true;
+		}
+		for (int i = 1; i < argc; ++i) {
+			if (std::strcmp(argv[i], name) == 0) {
+				return true;
+			}
+		}
+		return false;
+	}
+}
+
+namespace BRE {
+	namespace Test {
+		Registrar::Registrar(const char* name, const TestFunction function) {
+			RegisteredTest test;
+			test.mName = name;
+			test.mFunction = function;
+			Tests().push_back(test);
+		}
+
+		void ReportFailure(const char* file, const int line, const char* condition) {
+			++sFailures;
+			std::cerr << file << "(" << line << "): check failed: " << condition << std::endl;
+		}
+
+		int RunAll(const int argc, char** argv) {
+			unsigned int failedTests = 0U;
+			unsigned int runTests = 0U;
+			for (const RegisteredTest& test : Tests()) {
+				if (!IsSelected(test.mName, argc, argv)) {
+					continue;
+				}
+				const unsigned int failuresBefore = sFailures;
+				test.mFunction();
+				++runTests;
+				const bool passed = sFailures == failuresBefore;
+				if (!passed) {
+					++failedTests;
+				}
+				std::cout << (passed ? "[ PASSED ] " : "[ FAILED ] ") << test.mName << std::endl;
+			}
+			std::cout << runTests - failedTests << "/" << runTests << " tests passed" << std::endl;
+			return failedTests == 0U && runTests > 0U ? 0 : 1;
+		}
+	}
+}
+
+int main(int argc, char** argv) {
+	return BRE::Test::RunAll(argc, argv);
+}
@@ -0,0 +1,88 @@
+#include "TestFramework.h"
+
+#include <utils/TextureArrayPacker.h>
+
+using namespace BRE;
+
+namespace {
+	// DXGI_FORMAT_BC5_UNORM and DXGI_FORMAT_BC7_UNORM_SRGB
+	const unsigned int sBC5 = 83U;
+	const unsigned int sBC7SRGB = 99U;
+
+	TextureArrayPacker::Key MakeKey(const unsigned int size, const unsigned int format) {
+		unsigned int numMips = 1U;
+		while ((size >> numMips) != 0U) {
+			++numMips;
+		}
+		const TextureArrayPacker::Key key = { size, size, numMips, format };
+		return key;
+	}
+}
+
+BRE_TEST(SameKeysShareAPool) {
+	TextureArrayPacker packer(4U, 4U, 16U);
+	for (unsigned int i = 0U; i < 3U; ++i) {
+		TextureArrayPacker::Slot slot;
+		BRE_CHECK(packer.Allocate(MakeKey(512U, sBC5), slot));
+		BRE_CHECK(slot.mPool == 0U);
+		BRE_CHECK(slot.mSlice == i);
+	}
+	BRE_CHECK(packer.NumPools() == 1U);
+	BRE_CHECK(packer.PoolSize(0U) == 3U);
+	BRE_CHECK(packer.PoolCapacity(0U) == 4U);
+	BRE_CHECK(packer.PoolKey(0U) == MakeKey(512U, sBC5));
+}
+
+BRE_TEST(EveryKeyFieldSelectsAPool) {
+	TextureArrayPacker packer(8U, 4U, 16U);
+	TextureArrayPacker::Key keys[4] = { MakeKey(512U, sBC5), MakeKey(512U, sBC7SRGB), MakeKey(256U, sBC5), MakeKey(512U, sBC5) };
+	keys[3].mNumMips = 1U;
+	for (unsigned int i = 0U; i < 4U; ++i) {
+		TextureArrayPacker::Slot slot;
+		BRE_CHECK(packer.Allocate(keys[i], slot));
+		BRE_CHECK(slot.mPool == i);
+		BRE_CHECK(slot.mSlice == 0U);
+	}
+	BRE_CHECK(packer.NumPools() == 4U);
+
+	// Existing pools are found again whatever the allocation order
+	for (unsigned int i = 4U; i > 0U; --i) {
+		TextureArrayPacker::Slot slot;
+		BRE_CHECK(packer.Allocate(keys[i - 1U], slot));
+		BRE_CHECK(slot.mPool == i - 1U);
+		BRE_CHECK(slot.mSlice == 1U);
+	}
+	BRE_CHECK(packer.NumPools() == 4U);
+}
+
+BRE_TEST(FullPoolsDoubleUpToMaxSlices) {
+	TextureArrayPacker packer(1U, 3U, 10U);
+	const TextureArrayPacker::Key key = MakeKey(128U, sBC5);
+	const unsigned int expectedCapacities[] = { 3U, 3U, 3U, 6U, 6U, 6U, 10U, 10U, 10U, 10U };
+	for (unsigned int i = 0U; i < 10U; ++i) {
+		TextureArrayPacker::Slot slot;
+		BRE_CHECK(packer.Allocate(key, slot));
+		BRE_CHECK(slot.mSlice == i);
+		BRE_CHECK(packer.PoolCapacity(0U) == expectedCapacities[i]);
+	}
+
+	TextureArrayPacker::Slot slot = { 7U, 7U };
+	BRE_CHECK(!packer.Allocate(key, slot));
+	BRE_CHECK(packer.PoolSize(0U) == 10U);
+	BRE_CHECK(packer.PoolCapacity(0U) == 10U);
+}
+
+BRE_TEST(NoPoolIsAddedPastMaxPools) {
+	TextureArrayPacker packer(2U, 1U, 4U);
+	TextureArrayPacker::Slot slot;
+	BRE_CHECK(packer.Allocate(MakeKey(64U, sBC5), slot));
+	BRE_CHECK(packer.Allocate(MakeKey(128U, sBC5), slot));
+	BRE_CHECK(!packer.Allocate(MakeKey(256U, sBC5), slot));
+	BRE_CHECK(packer.NumPools() == 2U);
+
+	// Existing pools still grow
+	BRE_CHECK(packer.Allocate(MakeKey(64U, sBC5), slot));
+	BRE_CHECK(slot.mPool == 0U);
+	BRE_CHECK(slot.mSlice == 1U);
+	BRE_CHECK(packer.PoolCapacity(0U) == 2U);
+}
\ No newline at end of file
@@ -0,0 +1,255 @@
+#include "TestFramework.h"
+
+#include <random>
+#include <vector>
+
+#include <streaming/TextureStreamingScheduler.h>
+
+using namespace BRE;
+
+namespace {
+	typedef std::vector<TextureStreamingScheduler::Decision> Decisions;
+
+	// Bytes of each level of a square RGBA8 texture
+	std::vector<size_t> MipSizes(const unsigned int size) {
+		std::vector<size_t> mipSizes;
+		for (unsigned int mipSize = size; ; mipSize >>= 1U) {
+			mipSizes.push_back(static_cast<size_t>(mipSize) * mipSize * 4U);
+			if (mipSize == 1U) {
+				return mipSizes;
+			}
+		}
+	}
+
+	size_t Bytes(const std::vector<size_t>& mipSizes, const unsigned int topMip) {
+		size_t bytes = 0U;
+		for (size_t mip = topMip; mip < mipSizes.size(); ++mip) {
+			bytes += mipSizes[mip];
+		}
+		return bytes;
+	}
+
+	bool HasDecision(const Decisions& decisions, const size_t texture, const unsigned int topMip, const bool load) {
+		for (const TextureStreamingScheduler::Decision& decision : decisions) {
+			if (decision.mTexture == texture && decision.mTopMip == topMip && decision.mLoad == load) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	// 256x256 textures whose tail starts at mip 2 (64x64)
+	const unsigned int sTailTopMip = 2U;
+}
+
+BRE_TEST(TopMipMatchesScreenSize) {
+	BRE_CHECK(TextureStreamingScheduler::TopMipForScreenSize(1024U, 1024U, 11U, 1024.0f) == 0U);
+	BRE_CHECK(TextureStreamingScheduler::TopMipForScreenSize(1024U, 1024U, 11U, 2048.0f) == 0U);
+	BRE_CHECK(TextureStreamingScheduler::TopMipForScreenSize(1024U, 1024U, 11U, 300.0f) == 1U);
+	BRE_CHECK(TextureStreamingScheduler::TopMipForScreenSize(1024U, 1024U, 11U, 256.0f) == 2U);
+	BRE_CHECK(TextureStreamingScheduler::TopMipForScreenSize(1024U, 512U, 11U, 256.0f) == 2U);
+	BRE_CHECK(TextureStreamingScheduler::TopMipForScreenSize(1024U, 1024U, 11U, 0.01f) == 10U);
+	BRE_CHECK(TextureStreamingScheduler::TopMipForScreenSize(1024U, 512U, 11U, 0.0f) == 10U);
+}
+
+BRE_TEST(TailsAreResidentFromTheStart) {
+	const std::vector<size_t> mipSizes = MipSizes(256U);
+	TextureStreamingScheduler scheduler(1U << 30U, 2U);
+	const size_t texture = scheduler.AddTexture(mipSizes, sTailTopMip);
+	BRE_CHECK(scheduler.NumTextures() == 1U);
+	BRE_CHECK(scheduler.ResidentTopMip(texture) == sTailTopMip);
+	BRE_CHECK(!scheduler.IsLoading(texture));
+	BRE_CHECK(scheduler.ResidentBytes() == Bytes(mipSizes, sTailTopMip));
+	BRE_CHECK(scheduler.CommittedBytes() == scheduler.ResidentBytes());
+
+	// Requests below the tail need no load
+	Decisions decisions;
+	scheduler.Request(texture, 5U, 1.0f);
+	scheduler.Update(decisions);
+	BRE_CHECK(decisions.empty());
+}
+
+BRE_TEST(LoadsFitTheBudget) {
+	const std::vector<size_t> mipSizes = MipSizes(256U);
+	const size_t tail = Bytes(mipSizes, sTailTopMip);
+	// Room for one texture at mip 0 and one at mip 1
+	TextureStreamingScheduler scheduler(tail * 3U + mipSizes[0] + mipSizes[1] * 2U, 2U);
+	const size_t a = scheduler.AddTexture(mipSizes, sTailTopMip);
+	const size_t b = scheduler.AddTexture(mipSizes, sTailTopMip);
+	scheduler.AddTexture(mipSizes, sTailTopMip);
+
+	// Several requests keep the highest detail and priority
+	Decisions decisions;
+	scheduler.Request(a, 0U, 10.0f);
+	scheduler.Request(b, 1U, 5.0f);
+	scheduler.Request(b, 0U, 1.0f);
+	scheduler.Update(decisions);
+	BRE_CHECK(decisions.size() == 2U);
+	// The most important request first. b gets less detail than requested.
+	BRE_CHECK(decisions[0].mTexture == a && decisions[0].mTopMip == 0U && decisions[0].mLoad);
+	BRE_CHECK(decisions[1].mTexture == b && decisions[1].mTopMip == 1U && decisions[1].mLoad);
+	BRE_CHECK(scheduler.CommittedBytes() == scheduler.BudgetBytes());
+	BRE_CHECK(scheduler.ResidentBytes() == tail * 3U);
+	BRE_CHECK(scheduler.LoadsInFlight() == 2U);
+	BRE_CHECK(scheduler.IsLoading(a));
+
+	scheduler.OnLoaded(a, true);
+	scheduler.OnLoaded(b, true);
+	BRE_CHECK(scheduler.ResidentTopMip(a) == 0U);
+	BRE_CHECK(scheduler.ResidentTopMip(b) == 1U);
+	BRE_CHECK(scheduler.ResidentBytes() == scheduler.CommittedBytes());
+	BRE_CHECK(scheduler.LoadsInFlight() == 0U);
+}
+
+BRE_TEST(LeastRecentlyUsedTexturesAreEvicted) {
+	const std::vector<size_t> mipSizes = MipSizes(256U);
+	const size_t tail = Bytes(mipSizes, sTailTopMip);
+	TextureStreamingScheduler scheduler(tail * 3U + mipSizes[0] + mipSizes[1] * 2U, 2U);
+	const size_t a = scheduler.AddTexture(mipSizes, sTailTopMip);
+	const size_t b = scheduler.AddTexture(mipSizes, sTailTopMip);
+	const size_t c = scheduler.AddTexture(mipSizes, sTailTopMip);
+
+	Decisions decisions;
+	scheduler.Request(a, 0U, 10.0f);
+	scheduler.Request(b, 1U, 5.0f);
+	scheduler.Update(decisions);
+	scheduler.OnLoaded(a, true);
+	scheduler.OnLoaded(b, true);
+
+	// a is not used anymore, so it gives its room to c. b is used and keeps its levels.
+	scheduler.Request(c, 0U, 1.0f);
+	scheduler.Request(b, 1U, 5.0f);
+	scheduler.Update(decisions);
+	BRE_CHECK(decisions.size() == 2U);
+	BRE_CHECK(HasDecision(decisions, a, sTailTopMip, false));
+	BRE_CHECK(HasDecision(decisions, c, 0U, true));
+	BRE_CHECK(scheduler.ResidentTopMip(a) == sTailTopMip);
+	BRE_CHECK(scheduler.ResidentTopMip(b) == 1U);
+	BRE_CHECK(scheduler.CommittedBytes() <= scheduler.BudgetBytes());
+
+	// Textures used this frame only give room to more important ones
+	scheduler.OnLoaded(c, true);
+	scheduler.Request(a, 0U, 2.0f);
+	scheduler.Request(b, 1U, 5.0f);
+	scheduler.Request(c, 0U, 1.0f);
+	scheduler.Update(decisions);
+	BRE_CHECK(decisions.size() == 2U);
+	BRE_CHECK(HasDecision(decisions, c, sTailTopMip, false));
+	BRE_CHECK(HasDecision(decisions, a, 0U, true));
+	BRE_CHECK(scheduler.ResidentTopMip(b) == 1U);
+	BRE_CHECK(scheduler.CommittedBytes() <= scheduler.BudgetBytes());
+}
+
+BRE_TEST(FailedLoadsReleaseTheirBytes) {
+	const std::vector<size_t> mipSizes = MipSizes(256U);
+	TextureStreamingScheduler scheduler(1U << 30U, 2U);
+	const size_t texture = scheduler.AddTexture(mipSizes, sTailTopMip);
+	const size_t residentBytes = scheduler.ResidentBytes();
+
+	Decisions decisions;
+	scheduler.Request(texture, 0U, 1.0f);
+	scheduler.Update(decisions);
+	BRE_CHECK(scheduler.CommittedBytes() == Bytes(mipSizes, 0U));
+	scheduler.OnLoaded(texture, false);
+	BRE_CHECK(scheduler.ResidentTopMip(texture) == sTailTopMip);
+	BRE_CHECK(!scheduler.IsLoading(texture));
+	BRE_CHECK(scheduler.ResidentBytes() == residentBytes);
+	BRE_CHECK(scheduler.CommittedBytes() == residentBytes);
+
+	// It is requested again on the next frame
+	scheduler.Request(texture, 0U, 1.0f);
+	scheduler.Update(decisions);
+	BRE_CHECK(HasDecision(decisions, texture, 0U, true));
+}
+
+BRE_TEST(ShrinkingTheBudgetEvicts) {
+	const std::vector<size_t> mipSizes = MipSizes(256U);
+	const size_t tail = Bytes(mipSizes, sTailTopMip);
+	TextureStreamingScheduler scheduler(1U << 30U, 4U);
+	for (unsigned int i = 0U; i < 3U; ++i) {
+		scheduler.AddTexture(mipSizes, sTailTopMip);
+	}
+	Decisions decisions;
+	for (size_t i = 0U; i < 3U; ++i) {
+		scheduler.Request(i, 0U, 1.0f);
+	}
+	scheduler.Update(decisions);
+	for (const TextureStreamingScheduler::Decision& decision : decisions) {
+		scheduler.OnLoaded(decision.mTexture, true);
+	}
+	BRE_CHECK(scheduler.ResidentBytes() == Bytes(mipSizes, 0U) * 3U);
+
+	// Tails are never evicted
+	scheduler.SetBudgetBytes(tail * 3U);
+	scheduler.Update(decisions);
+	BRE_CHECK(decisions.size() == 3U);
+	for (size_t i = 0U; i < 3U; ++i) {
+		BRE_CHECK(HasDecision(decisions, i, sTailTopMip, false));
+	}
+	BRE_CHECK(scheduler.ResidentBytes() == tail * 3U);
+	BRE_CHECK(scheduler.CommittedBytes() == tail * 3U);
+}
+
+BRE_TEST(LoadsInFlightAreLimited) {
+	const std::vector<size_t> mipSizes = MipSizes(256U);
+	TextureStreamingScheduler scheduler(1U << 30U, 1U);
+	const size_t a = scheduler.AddTexture(mipSizes, sTailTopMip);
+	const size_t b = scheduler.AddTexture(mipSizes, sTailTopMip);
+
+	Decisions decisions;
+	scheduler.Request(a, 0U, 1.0f);
+	scheduler.Request(b, 0U, 2.0f);
+	scheduler.Update(decisions);
+	BRE_CHECK(decisions.size() == 1U);
+	BRE_CHECK(HasDecision(decisions, b, 0U, true));
+
+	scheduler.Request(a, 0U, 1.0f);
+	scheduler.Update(decisions);
+	BRE_CHECK(decisions.empty());
+
+	scheduler.OnLoaded(b, true);
+	scheduler.Request(a, 0U, 1.0f);
+	scheduler.Update(decisions);
+	BRE_CHECK(HasDecision(decisions, a, 0U, true));
+}
+
+BRE_TEST(RandomFramesStayWithinTheBudget) {
+	std::mt19937 generator(23U);
+	const std::vector<size_t> small = MipSizes(128U);
+	const std::vector<size_t> large = MipSizes(512U);
+	const size_t tails = (Bytes(small, sTailTopMip) + Bytes(large, sTailTopMip)) * 8U;
+	TextureStreamingScheduler scheduler(tails + Bytes(large, 0U) * 2U, 3U);
+	for (unsigned int i = 0U; i < 16U; ++i) {
+		scheduler.AddTexture((i % 2U) == 0U ? small : large, sTailTopMip);
+	}
+
+	Decisions decisions;
+	std::vector<size_t> loading;
+	for (unsigned int frame = 0U; frame < 2000U; ++frame) {
+		// Loads finish one or more frames later, some of them fail
+		for (size_t i = 0U; i < loading.size();) {
+			if ((generator() % 3U) == 0U) {
+				scheduler.OnLoaded(loading[i], (generator() % 8U) != 0U);
+				loading[i] = loading.back();
+				loading.pop_back();
+			}
+			else {
+				++i;
+			}
+		}
+		for (unsigned int i = 0U; i < 6U; ++i) {
+			scheduler.Request(generator() % scheduler.NumTextures(), generator() % 4U, static_cast<float>(generator() % 100U));
+		}
+
+		scheduler.Update(decisions);
+		for (const TextureStreamingScheduler::Decision& decision : decisions) {
+			if (decision.mLoad) {
+				loading.push_back(decision.mTexture);
+			}
+		}
+		BRE_CHECK(scheduler.CommittedBytes() <= scheduler.BudgetBytes());
+		BRE_CHECK(scheduler.ResidentBytes() <= scheduler.CommittedBytes());
+		BRE_CHECK(scheduler.LoadsInFlight() == loading.size());
+		BRE_CHECK(scheduler.LoadsInFlight() <= 3U);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,181 @@
+#include "TestFramework.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include <general/JobSystem.h>
+#include <general/Profiler.h>
+#include <rendering/TransformArray.h>
+
+using namespace BRE;
+using namespace DirectX;
+
+namespace {
+	// Installs the profiler (and a job system with threads) while they live
+	class ScopedJobSystem {
+	public:
+		explicit ScopedJobSystem(const unsigned int numThreads) {
+			Profiler::gInstance = &mProfiler;
+			if (numThreads > 0U) {
+				JobSystem::gInstance = new JobSystem(numThreads);
+			}
+		}
+
+		~ScopedJobSystem() {
+			delete JobSystem::gInstance;
+			JobSystem::gInstance = nullptr;
+			Profiler::gInstance = nullptr;
+		}
+
+	private:
+		Profiler mProfiler;
+	};
+
+	XMFLOAT4X4 RandomMatrix(std::mt19937& generator) {
+		std::uniform_real_distribution<float> distribution(-10.0f, 10.0f);
+		XMFLOAT4X4 m;
+		for (size_t element = 0U; element < 16U; ++element) {
+			m.m[element / 4U][element % 4U] = distribution(generator);
+		}
+		return m;
+	}
+
+	void Multiply(const XMFLOAT4X4& a, const XMFLOAT4X4& b, double result[4][4]) {
+		for (size_t row = 0U; row < 4U; ++row) {
+			for (size_t column = 0U; column < 4U; ++column) {
+				double sum = 0.0;
+				for (size_t k = 0U; k < 4U; ++k) {
+					sum += static_cast<double>(a.m[row][k]) * b.m[k][column];
+				}
+				result[row][column] = sum;
+			}
+		}
+	}
+
+	// Largest error of the draw transforms of index, relative to the largest element
+	double DrawTransformsError(const TransformArray& transforms, const size_t index, const XMFLOAT4X4& world, const XMFLOAT4X4& view, const XMFLOAT4X4& proj) {
+		double worldView[4][4];
+		Multiply(world, view, worldView);
+		// View * projection is computed in floats first, as ComputeDrawTransforms() does
+		double viewProjDouble[4][4];
+		Multiply(view, proj, viewProjDouble);
+		XMFLOAT4X4 viewProj;
+		for (size_t element = 0U; element < 16U; ++element) {
+			viewProj.m[element / 4U][element % 4U] = static_cast<float>(viewProjDouble[element / 4U][element % 4U]);
+		}
+		double worldViewProj[4][4];
+		Multiply(world, viewProj, worldViewProj);
+
+		double worldViewScale = 1.0;
+		double worldViewProjScale = 1.0;
+		for (size_t element = 0U; element < 16U; ++element) {
+			worldViewScale = (std::max)(worldViewScale, std::fabs(worldView[element / 4U][element % 4U]));
+			worldViewProjScale = (std::max)(worldViewProjScale, std::fabs(worldViewProj[element / 4U][element % 4U]));
+		}
+
+		// Stored transposed
+		const TransformArray::DrawTransforms& drawTransforms = transforms.GetDrawTransforms(index);
+		double error = 0.0;
+		for (size_t row = 0U; row < 4U; ++row) {
+			for (size_t column = 0U; column < 4U; ++column) {
+				error = (std::max)(error, std::fabs(drawTransforms.mWorldView.m[column][row] - worldView[row][column]) / worldViewScale);
+				error = (std::max)(error, std::fabs(drawTransforms.mWorldViewProjection.m[column][row] - worldViewProj[row][column]) / worldViewProjScale);
+			}
+		}
+		return error;
+	}
+
+	const unsigned int sNumThreads[] = { 0U, 1U, 4U };
+	const size_t sSizes[] = { 0U, 1U, 3U, 4U, 5U, 1023U, 5000U };
+}
+
+BRE_TEST(WorldMatricesAreStored) {
+	std::mt19937 generator(1U);
+	TransformArray transforms;
+	std::vector<XMFLOAT4X4> worlds;
+	for (size_t i = 0U; i < 9U; ++i) {
+		worlds.push_back(RandomMatrix(generator));
+		BRE_CHECK(transforms.Add(XMLoadFloat4x4(&worlds.back())) == i);
+	}
+	BRE_CHECK(transforms.Size() == 9U);
+	worlds[5U] = RandomMatrix(generator);
+	transforms.Set(5U, XMLoadFloat4x4(&worlds[5U]));
+	for (size_t i = 0U; i < worlds.size(); ++i) {
+		XMFLOAT4X4 world;
+		XMStoreFloat4x4(&world, transforms.World(i));
+		BRE_CHECK(memcmp(&world, &worlds[i], sizeof(world)) == 0);
+	}
+}
+
+BRE_TEST(AllDrawTransformsAreComputed) {
+	std::mt19937 generator(2U);
+	for (const unsigned int numThreads : sNumThreads) {
+		ScopedJobSystem jobSystem(numThreads);
+		for (const size_t size : sSizes) {
+			TransformArray transforms;
+			std::vector<XMFLOAT4X4> worlds;
+			for (size_t i = 0U; i < size; ++i) {
+				worlds.push_back(RandomMatrix(generator));
+				transforms.Add(XMLoadFloat4x4(&worlds.back()));
+			}
+			const XMFLOAT4X4 view = RandomMatrix(generator);
+			const XMFLOAT4X4 proj = RandomMatrix(generator);
+			transforms.ComputeDrawTransforms(XMLoadFloat4x4(&view), XMLoadFloat4x4(&proj));
+			double error = 0.0;
+			for (size_t i = 0U; i < size; ++i) {
+				error = (std::max)(error, DrawTransformsError(transforms, i, worlds[i], view, proj));
+			}
+			BRE_CHECK(error < 1.0e-5);
+		}
+	}
+}
+
+BRE_TEST(OnlyBlocksOfTheIndicesAreComputed) {
+	std::mt19937 generator(3U);
+	for (const unsigned int numThreads : sNumThreads) {
+		ScopedJobSystem jobSystem(numThreads);
+		for (const size_t size : sSizes) {
+			TransformArray transforms;
+			std::vector<XMFLOAT4X4> worlds;
+			for (size_t i = 0U; i < size; ++i) {
+				worlds.push_back(RandomMatrix(generator));
+				transforms.Add(XMLoadFloat4x4(&worlds.back()));
+			}
+			const XMFLOAT4X4 view = RandomMatrix(generator);
+			const XMFLOAT4X4 proj = RandomMatrix(generator);
+			transforms.ComputeDrawTransforms(XMLoadFloat4x4(&view), XMLoadFloat4x4(&proj));
+
+			// Indices are unsorted and repeated
+			std::vector<size_t> indices;
+			for (size_t i = 0U; i < size; ++i) {
+				if (generator() % 3U == 0U) {
+					indices.push_back(i);
+					indices.push_back(i);
+				}
+			}
+			std::shuffle(indices.begin(), indices.end(), generator);
+			const XMFLOAT4X4 newView = RandomMatrix(generator);
+			transforms.ComputeDrawTransforms(XMLoadFloat4x4(&newView), XMLoadFloat4x4(&proj), indices);
+
+			std::vector<bool> blockComputed((size + 3U) / 4U, false);
+			for (const size_t index : indices) {
+				blockComputed[index / 4U] = true;
+			}
+			double newError = 0.0;
+			double oldError = 0.0;
+			for (size_t i = 0U; i < size; ++i) {
+				if (blockComputed[i / 4U]) {
+					newError = (std::max)(newError, DrawTransformsError(transforms, i, worlds[i], newView, proj));
+				}
+				else {
+					oldError = (std::max)(oldError, DrawTransformsError(transforms, i, worlds[i], view, proj));
+				}
+			}
+			BRE_CHECK(newError < 1.0e-5);
+			BRE_CHECK(oldError < 1.0e-5);
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,198 @@
+#include "TestFramework.h"
+
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <set>
+#include <vector>
+
+#include <general/Profiler.h>
+#include <general/TransformHierarchy.h>
+
+using namespace BRE;
+using namespace DirectX;
+
+namespace {
+	typedef TransformHierarchy::LocalTransform LocalTransform;
+
+	// Installs the profiler used by Update() while it lives
+	class ScopedProfiler {
+	public:
+		ScopedProfiler() { Profiler::gInstance = &mProfiler; }
+		~ScopedProfiler() { Profiler::gInstance = nullptr; }
+
+	private:
+		Profiler mProfiler;
+	};
+
+	LocalTransform RandomLocal(std::mt19937& generator) {
+		std::uniform_real_distribution<float> distribution(-5.0f, 5.0f);
+		std::uniform_real_distribution<float> scalingDistribution(0.5f, 2.0f);
+		LocalTransform local;
+		local.mTranslation = XMFLOAT3(distribution(generator), distribution(generator), distribution(generator));
+		// Rotation around the Y axis
+		const float angle = distribution(generator);
+		local.mRotation = XMFLOAT4(0.0f, std::sin(angle * 0.5f), 0.0f, std::cos(angle * 0.5f));
+		local.mScaling = XMFLOAT3(scalingDistribution(generator), scalingDistribution(generator), scalingDistribution(generator));
+		return local;
+	}
+
+	// Nodes with their parent and local transform. World matrices are computed recursively.
+	class ReferenceHierarchy {
+	public:
+		void AddNode(const LocalTransform& local, const size_t parent) {
+			mLocals.push_back(local);
+			mParents.push_back(parent);
+		}
+
+		XMMATRIX World(const size_t node) const {
+			const LocalTransform& local = mLocals[node];
+			XMMATRIX world = XMMatrixScaling(local.mScaling.x, local.mScaling.y, local.mScaling.z);
+			world *= XMMatrixRotationQuaternion(XMLoadFloat4(&local.mRotation));
+			world *= XMMatrixTranslation(local.mTranslation.x, local.mTranslation.y, local.mTranslation.z);
+			if (mParents[node] != TransformHierarchy::sNoNode) {
+				world *= World(mParents[node]);
+			}
+			return world;
+		}
+
+		// The node or one of its ancestors is in nodes
+		bool IsUnder(const size_t node, const std::set<size_t>& nodes) const {
+			for (size_t ancestor = node; ancestor != TransformHierarchy::sNoNode; ancestor = mParents[ancestor]) {
+				if (nodes.count(ancestor) > 0U) {
+					return true;
+				}
+			}
+			return false;
+		}
+
+		std::vector<LocalTransform> mLocals;
+		std::vector<size_t> mParents;
+	};
+
+	void AddRandomNodes(const size_t count, std::mt19937& generator, TransformHierarchy& hierarchy, ReferenceHierarchy& reference) {
+		for (size_t i = 0U; i < count; ++i) {
+			const size_t node = hierarchy.NumNodes();
+			const size_t parent = (node == 0U || generator() % 5U == 0U) ? TransformHierarchy::sNoNode : generator() % node;
+			const LocalTransform local = RandomLocal(generator);
+			BRE_CHECK(hierarchy.AddNode(local, parent) == node);
+			BRE_CHECK(hierarchy.Parent(node) == parent);
+			reference.AddNode(local, parent);
+		}
+	}
+
+	// Number of nodes whose world matrix is not the reference one (bit for bit)
+	size_t NumWrongWorlds(const TransformHierarchy& hierarchy, const ReferenceHierarchy& reference) {
+		size_t numWrongWorlds = 0U;
+		for (size_t node = 0U; node < hierarchy.NumNodes(); ++node) {
+			XMFLOAT4X4 world;
+			XMStoreFloat4x4(&world, hierarchy.World(node));
+			XMFLOAT4X4 referenceWorld;
+			XMStoreFloat4x4(&referenceWorld, reference.World(node));
+			numWrongWorlds += memcmp(&world, &referenceWorld, sizeof(world)) != 0 ? 1U : 0U;
+		}
+		return numWrongWorlds;
+	}
+}
+
+BRE_TEST(ChildrenFollowTheirParents) {
+	ScopedProfiler profiler;
+	TransformHierarchy hierarchy;
+	hierarchy.Update();
+	BRE_CHECK(hierarchy.ChangedNodes().empty());
+
+	LocalTransform parentLocal;
+	parentLocal.mTranslation = XMFLOAT3(10.0f, 0.0f, 0.0f);
+	const size_t parent = hierarchy.AddNode(parentLocal);
+	LocalTransform childLocal;
+	childLocal.mTranslation = XMFLOAT3(0.0f, 5.0f, 0.0f);
+	childLocal.mScaling = XMFLOAT3(2.0f, 2.0f, 2.0f);
+	const size_t child = hierarchy.AddNode(childLocal, parent);
+	BRE_CHECK(hierarchy.NumNodes() == 2U);
+	BRE_CHECK(hierarchy.Parent(parent) == TransformHierarchy::sNoNode);
+	BRE_CHECK(hierarchy.Parent(child) == parent);
+
+	hierarchy.Update();
+	BRE_CHECK(hierarchy.ChangedNodes().size() == 2U);
+	XMFLOAT4X4 world;
+	XMStoreFloat4x4(&world, hierarchy.World(child));
+	BRE_CHECK(world._11 == 2.0f && world._22 == 2.0f && world._33 == 2.0f);
+	BRE_CHECK(world._41 == 10.0f && world._42 == 5.0f && world._43 == 0.0f);
+
+	// Moving the parent moves the child
+	parentLocal.mTranslation = XMFLOAT3(0.0f, 0.0f, -3.0f);
+	hierarchy.SetLocal(parent, parentLocal);
+	hierarchy.Update();
+	BRE_CHECK(hierarchy.ChangedNodes().size() == 2U);
+	BRE_CHECK(hierarchy.ChangedNodes()[0U] == parent);
+	XMStoreFloat4x4(&world, hierarchy.World(child));
+	BRE_CHECK(world._41 == 0.0f && world._42 == 5.0f && world._43 == -3.0f);
+
+	// Moving the child does not change its parent
+	childLocal.mTranslation = XMFLOAT3(1.0f, 0.0f, 0.0f);
+	hierarchy.SetLocal(child, childLocal);
+	hierarchy.Update();
+	BRE_CHECK(hierarchy.ChangedNodes().size() == 1U);
+	BRE_CHECK(hierarchy.ChangedNodes()[0U] == child);
+
+	hierarchy.Update();
+	BRE_CHECK(hierarchy.ChangedNodes().empty());
+}
+
+BRE_TEST(OnlyDirtyNodesAndDescendantsChange) {
+	ScopedProfiler profiler;
+	std::mt19937 generator(3U);
+	TransformHierarchy hierarchy;
+	ReferenceHierarchy reference;
+	AddRandomNodes(500U, generator, hierarchy, reference);
+	hierarchy.Update();
+	BRE_CHECK(hierarchy.ChangedNodes().size() == 500U);
+	BRE_CHECK(NumWrongWorlds(hierarchy, reference) == 0U);
+
+	for (unsigned int round = 0U; round < 300U; ++round) {
+		// Some rounds add nodes, which updates every node
+		const bool addNodes = (round % 37U) == 0U;
+		if (addNodes) {
+			AddRandomNodes(generator() % 20U, generator, hierarchy, reference);
+		}
+		// Some rounds make more nodes dirty than the heap update handles, so they are swept
+		const size_t numDirtyNodes = (round % 10U) == 0U ? 200U : generator() % 5U;
+		std::set<size_t> dirtyNodes;
+		for (size_t i = 0U; i < numDirtyNodes; ++i) {
+			const size_t node = generator() % hierarchy.NumNodes();
+			const LocalTransform local = RandomLocal(generator);
+			hierarchy.SetLocal(node, local);
+			BRE_CHECK(memcmp(&hierarchy.Local(node), &local, sizeof(local)) == 0);
+			reference.mLocals[node] = local;
+			dirtyNodes.insert(node);
+		}
+
+		hierarchy.Update();
+		BRE_CHECK(NumWrongWorlds(hierarchy, reference) == 0U);
+		const std::vector<size_t>& changedNodes = hierarchy.ChangedNodes();
+		const std::set<size_t> changedSet(changedNodes.begin(), changedNodes.end());
+		BRE_CHECK(changedSet.size() == changedNodes.size());
+		if (addNodes) {
+			BRE_CHECK(changedNodes.size() == hierarchy.NumNodes());
+		}
+		else {
+			size_t numWrongChanges = 0U;
+			for (size_t node = 0U; node < hierarchy.NumNodes(); ++node) {
+				numWrongChanges += (changedSet.count(node) > 0U) != reference.IsUnder(node, dirtyNodes) ? 1U : 0U;
+			}
+			BRE_CHECK(numWrongChanges == 0U);
+		}
+
+		// Parents before children
+		std::set<size_t> seenNodes;
+		size_t numWrongOrders = 0U;
+		for (const size_t node : changedNodes) {
+			const size_t parent = reference.mParents[node];
+			if (parent != TransformHierarchy::sNoNode && changedSet.count(parent) > 0U && seenNodes.count(parent) == 0U) {
+				++numWrongOrders;
+			}
+			seenNodes.insert(node);
+		}
+		BRE_CHECK(numWrongOrders == 0U);
+	}
+}
\ No newline at end of file
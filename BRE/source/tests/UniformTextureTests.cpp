@@ -0,0 +1,141 @@
+#include "TestFramework.h"
+
+#include <cstdint>
+#include <random>
+
+#include <general/JobSystem.h>
+#include <general/Profiler.h>
+#include <textures/Image.h>
+#include <textures/UniformTexture.h>
+
+using namespace BRE;
+
+namespace {
+	// Installs the profiler (and a job system with threads) while they live
+	class ScopedJobSystem {
+	public:
+		explicit ScopedJobSystem(const unsigned int numThreads) {
+			Profiler::gInstance = &mProfiler;
+			if (numThreads > 0U) {
+				JobSystem::gInstance = new JobSystem(numThreads);
+			}
+		}
+
+		~ScopedJobSystem() {
+			delete JobSystem::gInstance;
+			JobSystem::gInstance = nullptr;
+			Profiler::gInstance = nullptr;
+		}
+
+	private:
+		Profiler mProfiler;
+	};
+
+	const std::uint8_t sTexel[] = { 100U, 20U, 200U, 255U };
+
+	Image SolidImage(const unsigned int width, const unsigned int height) {
+		Image image(width, height);
+		for (size_t i = 0U; i < image.mData.size(); ++i) {
+			image.mData[i] = sTexel[i % Image::sNumChannels];
+		}
+		return image;
+	}
+
+	bool Detect(const Image& image, const unsigned int channelMask, const unsigned int tolerance) {
+		std::uint8_t value[Image::sNumChannels];
+		return UniformTexture::Detect(image, channelMask, tolerance, value);
+	}
+}
+
+BRE_TEST(UniformImagesAreDetected) {
+	const Image image = SolidImage(64U, 64U);
+	std::uint8_t value[Image::sNumChannels];
+	BRE_CHECK(UniformTexture::Detect(image, 0xFU, 0U, value));
+	BRE_CHECK(value[0] == 100U && value[1] == 20U && value[2] == 200U && value[3] == 255U);
+
+	// Channels out of the mask are 0
+	BRE_CHECK(UniformTexture::Detect(image, 0x5U, 0U, value));
+	BRE_CHECK(value[0] == 100U && value[1] == 0U && value[2] == 200U && value[3] == 0U);
+}
+
+BRE_TEST(ToleranceIsInclusive) {
+	const unsigned int tolerance = 2U;
+	Image image = SolidImage(64U, 40U);
+	// Just inside: the range of R is [100, 102]
+	image.Texel(13U, 7U)[0] = 102U;
+	std::uint8_t value[Image::sNumChannels];
+	BRE_CHECK(UniformTexture::Detect(image, 0xFU, tolerance, value));
+	// Middle of the range
+	BRE_CHECK(value[0] == 101U);
+
+	// Just outside: [99, 102]
+	image.Texel(50U, 39U)[0] = 99U;
+	BRE_CHECK(!UniformTexture::Detect(image, 0xFU, tolerance, value));
+	BRE_CHECK(UniformTexture::Detect(image, 0xFU, tolerance + 1U, value));
+	BRE_CHECK(value[0] == 101U);
+}
+
+BRE_TEST(NoisyImagesAreNotUniform) {
+	std::mt19937 generator(3U);
+	Image noisy = SolidImage(48U, 48U);
+	for (std::uint8_t& channel : noisy.mData) {
+		channel = static_cast<std::uint8_t>(generator());
+	}
+	BRE_CHECK(!Detect(noisy, 0xFU, 16U));
+	BRE_CHECK(!Detect(noisy, 0x8U, 16U));
+
+	// Noise within the tolerance is uniform
+	Image quiet = SolidImage(48U, 48U);
+	for (std::uint8_t& channel : quiet.mData) {
+		channel = static_cast<std::uint8_t>(channel - generator() % 4U);
+	}
+	BRE_CHECK(Detect(quiet, 0xFU, 3U));
+	BRE_CHECK(!Detect(quiet, 0xFU, 1U));
+}
+
+BRE_TEST(OnlyMaskedChannelsAreChecked) {
+	std::mt19937 generator(11U);
+	Image image = SolidImage(33U, 17U);
+	// Noise in B and A only
+	for (size_t i = 0U; i < image.mData.size(); i += Image::sNumChannels) {
+		image.mData[i + 2U] = static_cast<std::uint8_t>(generator());
+		image.mData[i + 3U] = static_cast<std::uint8_t>(generator());
+	}
+	std::uint8_t value[Image::sNumChannels];
+	BRE_CHECK(UniformTexture::Detect(image, 0x3U, 0U, value));
+	BRE_CHECK(value[0] == 100U && value[1] == 20U && value[2] == 0U && value[3] == 0U);
+	BRE_CHECK(!Detect(image, 0x7U, 0U));
+	BRE_CHECK(!Detect(image, 0x8U, 0U));
+	BRE_CHECK(Detect(image, 0x1U, 0U));
+}
+
+// SSE2 scans 4 texels at once. Texels after the last multiple of 4 are
+// scanned one by one, so an outlier there must be found too.
+BRE_TEST(TexelsAfterTheLastVectorAreScanned) {
+	for (unsigned int width = 1U; width <= 13U; ++width) {
+		Image image = SolidImage(width, 3U);
+		BRE_CHECK(Detect(image, 0xFU, 0U));
+		image.Texel(width - 1U, 2U)[1] = 21U;
+		BRE_CHECK(!Detect(image, 0xFU, 0U));
+		BRE_CHECK(Detect(image, 0xFU, 1U));
+		image.Texel(width - 1U, 2U)[1] = 20U;
+		image.Texel(0U, 1U)[3] = 254U;
+		BRE_CHECK(!Detect(image, 0x8U, 0U));
+	}
+}
+
+// Rows are scanned by tasks of 32 rows. Outliers in any of them are found
+// with and without a job system.
+BRE_TEST(EveryTaskIsScanned) {
+	for (unsigned int numThreads = 0U; numThreads <= 4U; numThreads += 4U) {
+		ScopedJobSystem jobSystem(numThreads);
+		const unsigned int rows[] = { 0U, 31U, 32U, 100U, 199U };
+		for (const unsigned int row : rows) {
+			Image image = SolidImage(19U, 200U);
+			BRE_CHECK(Detect(image, 0xFU, 0U));
+			image.Texel(18U, row)[2] = 190U;
+			BRE_CHECK(!Detect(image, 0xFU, 9U));
+			BRE_CHECK(Detect(image, 0xFU, 10U));
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,84 @@
+// Contention of manager registries.
+// 1 to 64 threads request ids from a registry with 4096 entries: 95% of the
+// requests find an existing entry and 5% create a new one. It compares
+// ConcurrentRegistry with a mutex locked std::unordered_map (what managers
+// used before) in millions of requests per second.
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <utils/ConcurrentRegistry.h>
+
+using namespace BRE;
+
+namespace {
+	const size_t sNumRequests = 4000000U;
+	const size_t sNumEntries = 4096U;
+
+	class LockedMap {
+	public:
+		template<typename Create>
+		size_t GetOrCreate(const size_t id, Create&& create) {
+			std::lock_guard<std::mutex> lock(mMutex);
+			const auto findIt = mMap.find(id);
+			if (findIt != mMap.end()) {
+				return findIt->second;
+			}
+			const size_t value = create();
+			mMap[id] = value;
+			return value;
+		}
+
+	private:
+		std::mutex mMutex;
+		std::unordered_map<size_t, size_t> mMap;
+	};
+
+	template<typename Registry>
+	double RequestsPerSecond(Registry& registry, const unsigned int numThreads) {
+		for (size_t i = 0U; i < sNumEntries; ++i) {
+			registry.GetOrCreate(i * 101U, [i]() { return i; });
+		}
+
+		const size_t requestsPerThread = sNumRequests / numThreads;
+		std::atomic<size_t> sink(0U);
+		const std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+		std::vector<std::thread> threads;
+		for (unsigned int thread = 0U; thread < numThreads; ++thread) {
+			threads.emplace_back([&, thread]() {
+				std::mt19937 generator(thread);
+				size_t sum = 0U;
+				for (size_t i = 0U; i < requestsPerThread; ++i) {
+					const bool isNew = (generator() % 20U) == 0U;
+					const size_t id = isNew ? (sNumEntries + thread * requestsPerThread + i) * 101U : (generator() % sNumEntries) * 101U;
+					sum += registry.GetOrCreate(id, [id]() { return id; });
+				}
+				sink += sum;
+			});
+		}
+		for (std::thread& thread : threads) {
+			thread.join();
+		}
+		const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+		return (sink.load() == 1U ? 0.0 : 1.0) * requestsPerThread * numThreads / seconds;
+	}
+}
+
+int main() {
+	std::printf("hardware threads: %u\n", std::thread::hardware_concurrency());
+	std::printf("threads  ConcurrentRegistry (M/s)  mutex + unordered_map (M/s)\n");
+	for (unsigned int numThreads = 1U; numThreads <= 64U; numThreads *= 2U) {
+		ConcurrentRegistry<size_t> registry;
+		LockedMap lockedMap;
+		const double registryRate = RequestsPerSecond(registry, numThreads);
+		const double lockedRate = RequestsPerSecond(lockedMap, numThreads);
+		std::printf("%7u  %24.1f  %27.1f\n", numThreads, registryRate * 1.0e-6, lockedRate * 1.0e-6);
+	}
+	return 0;
+}
\ No newline at end of file
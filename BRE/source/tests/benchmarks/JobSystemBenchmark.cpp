@@ -0,0 +1,65 @@
+// Scaling of the job system from 1 to 64 threads.
+// A ParallelFor streams over 4M floats in chunks of 16K elements (the
+// compute kernels of culling and transforms are split like that), then
+// 100000 empty jobs measure the cost of creating, running and freeing a
+// job. Threads beyond the hardware threads show the cost of oversubscription.
+
+#include <chrono>
+#include <cstdio>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+#include <general/JobSystem.h>
+#include <general/Profiler.h>
+
+using namespace BRE;
+
+namespace {
+	const size_t sNumElements = 4U * 1024U * 1024U;
+	const size_t sGrainSize = 16U * 1024U;
+	const unsigned int sNumRounds = 10U;
+	const unsigned int sNumEmptyJobs = 100000U;
+}
+
+int main() {
+	// Benchmarks are built with profiling zones, which need a profiler
+	Profiler profiler;
+	Profiler::gInstance = &profiler;
+
+	std::vector<float> data(sNumElements);
+	std::iota(data.begin(), data.end(), 0.0f);
+
+	std::printf("hardware threads: %u\n", std::thread::hardware_concurrency());
+	std::printf("threads  ParallelFor (ms)  speedup  empty job (ns)\n");
+	double oneThreadTime = 0.0;
+	for (unsigned int numThreads = 1U; numThreads <= 64U; numThreads *= 2U) {
+		JobSystem jobSystem(numThreads);
+
+		std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+		for (unsigned int round = 0U; round < sNumRounds; ++round) {
+			jobSystem.ParallelFor(0U, data.size(), sGrainSize, [&data](const size_t rangeBegin, const size_t rangeEnd) {
+				for (size_t i = rangeBegin; i < rangeEnd; ++i) {
+					data[i] = data[i] * 0.999f + 1.0f;
+				}
+			});
+		}
+		const double parallelForTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count() / sNumRounds;
+		if (numThreads == 1U) {
+			oneThreadTime = parallelForTime;
+		}
+
+		begin = std::chrono::steady_clock::now();
+		JobCounter counter;
+		for (unsigned int i = 0U; i < sNumEmptyJobs; ++i) {
+			jobSystem.Run([]() {}, &counter);
+		}
+		jobSystem.Wait(counter);
+		const double jobTime = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin).count() / sNumEmptyJobs;
+
+		std::printf("%7u  %16.3f  %7.2f  %14.0f\n", numThreads, parallelForTime, oneThreadTime / parallelForTime, jobTime);
+	}
+	std::printf("checksum: %f\n", static_cast<double>(data[data.size() / 2U]));
+	Profiler::gInstance = nullptr;
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,38 @@
+// Cost of profiler zones.
+// Reports the cost of one time stamp read and of an empty zone (begin + end,
+// as MeasureZoneOverhead() times it). A zone reads the time stamp twice, so
+// the first number bounds what the rest of the zone can save.
+
+#include <algorithm>
+#include <cstdio>
+
+#include <general/Profiler.h>
+
+using namespace BRE;
+
+namespace {
+	double TimeStampNs(const unsigned int iterations) {
+		double minNs = 1.0e9;
+		for (int run = 0; run < 5; ++run) {
+			std::uint64_t sink = 0U;
+			const std::uint64_t begin = Profiler::Now();
+			for (unsigned int i = 0U; i < iterations; ++i) {
+				sink += Profiler::Now();
+			}
+			const std::uint64_t end = Profiler::Now();
+			minNs = std::min(minNs, Profiler::TicksToMs(end - begin) * 1.0e6 / iterations + (sink == 0U ? 1.0 : 0.0));
+		}
+		return minNs;
+	}
+}
+
+int main() {
+	Profiler profiler;
+	Profiler::gInstance = &profiler;
+
+	std::printf("time stamp read: %.1f ns\n", TimeStampNs(1000000U));
+	std::printf("empty zone: %.1f ns\n", profiler.MeasureZoneOverhead(1000000U));
+
+	Profiler::gInstance = nullptr;
+	return 0;
+}
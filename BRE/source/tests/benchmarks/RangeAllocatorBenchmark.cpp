@@ -0,0 +1,114 @@
+// Fragmentation of a geometry pool under streaming: each frame allocates
+// and frees mesh sized ranges (most of them small, some large) while the
+// pool stays about 70% full. Policies: no defragmentation, Defragment()
+// every frame with a budget, and Defragment() with the same budget only
+// after a free and while the free space below the highest allocation is
+// more than 1/16 of the capacity (as GeometryPool does).
+// Fragmentation is the highest allocation end over the used size, and the
+// largest free range over the free space.
+
+#include <chrono>
+#include <cstdio>
+#include <map>
+#include <random>
+#include <vector>
+
+#include <utils/RangeAllocator.h>
+
+using namespace BRE;
+
+namespace {
+	const unsigned int sCapacity = 1U << 24U;
+	const unsigned int sNumFrames = 20000U;
+	const unsigned int sOperationsPerFrame = 8U;
+	const unsigned int sMinFragmentationDivisor = 16U;
+
+	enum class Policy {
+		None = 0,
+		EveryFrame,
+		WhenFragmented
+	};
+
+	void Run(const Policy policy, const unsigned int budget) {
+		std::mt19937 generator(7U);
+		RangeAllocator allocator(sCapacity);
+		std::map<unsigned int, unsigned int> allocations;
+		std::vector<RangeAllocator::Move> moves;
+		double allocateNanoseconds = 0.0;
+		double defragmentNanoseconds = 0.0;
+		size_t numAllocations = 0U;
+		size_t numFailures = 0U;
+		size_t numDefragmentations = 0U;
+		size_t movedElements = 0U;
+		bool fragmented = false;
+		for (unsigned int frame = 0U; frame < sNumFrames; ++frame) {
+			for (unsigned int operation = 0U; operation < sOperationsPerFrame; ++operation) {
+				if (allocator.UsedSize() < sCapacity / 10U * 7U || generator() % 2U == 0U) {
+					const unsigned int size = 64U + generator() % (generator() % 8U == 0U ? 60000U : 4000U);
+					const std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+					const unsigned int offset = allocator.Allocate(size);
+					allocateNanoseconds += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin).count();
+					++numAllocations;
+					if (offset == RangeAllocator::sInvalidOffset) {
+						++numFailures;
+						continue;
+					}
+					allocations[offset] = size;
+				}
+				else if (!allocations.empty()) {
+					std::map<unsigned int, unsigned int>::iterator allocationIt = allocations.lower_bound(generator() % sCapacity);
+					if (allocationIt == allocations.end()) {
+						allocationIt = allocations.begin();
+					}
+					allocator.Free(allocationIt->first);
+					allocations.erase(allocationIt);
+					fragmented = true;
+				}
+			}
+
+			const std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+			moves.clear();
+			if (policy == Policy::EveryFrame) {
+				allocator.Defragment(budget, moves);
+				++numDefragmentations;
+			}
+			else if (policy == Policy::WhenFragmented && fragmented) {
+				if (allocator.FragmentedSize() <= allocator.Capacity() / sMinFragmentationDivisor) {
+					fragmented = false;
+				}
+				else {
+					allocator.Defragment(budget, moves);
+					fragmented = !moves.empty();
+					++numDefragmentations;
+				}
+			}
+			defragmentNanoseconds += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin).count();
+			for (const RangeAllocator::Move& move : moves) {
+				allocations.erase(move.mFrom);
+				allocations[move.mTo] = move.mSize;
+				movedElements += move.mSize;
+			}
+		}
+
+		const unsigned int highestEnd = allocations.empty() ? 0U : allocations.rbegin()->first + allocations.rbegin()->second;
+		const char* policyNames[] = { "none", "every frame", "when fragmented" };
+		std::printf("%-15s %7u %8zu %6.1f%% %8zu %9.3f %9.3f %8.0f %10.2f %9.0f %8.1f%%\n",
+			policyNames[static_cast<size_t>(policy)], budget, numFailures, 100.0 * allocator.UsedSize() / sCapacity,
+			allocator.NumFreeRanges(), static_cast<double>(highestEnd) / allocator.UsedSize(),
+			static_cast<double>(allocator.LargestFreeRange()) / allocator.FreeSize(), allocateNanoseconds / numAllocations,
+			defragmentNanoseconds / sNumFrames / 1000.0, static_cast<double>(movedElements) / sNumFrames,
+			100.0 * numDefragmentations / sNumFrames);
+	}
+}
+
+int main() {
+	std::printf("policy           budget failures   used  free    highest   largest alloc ns  defrag us     moved   frames\n");
+	std::printf("                                         ranges  end/used  free/free         per frame per frame  defrag\n");
+	Run(Policy::None, 0U);
+	const unsigned int budgets[] = { 16384U, 65536U, 262144U };
+	for (const unsigned int budget : budgets) {
+		Run(Policy::EveryFrame, budget);
+		Run(Policy::WhenFragmented, budget);
+	}
+	return 0;
+}
\ No newline at end of file
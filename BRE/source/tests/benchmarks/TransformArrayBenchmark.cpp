@@ -0,0 +1,104 @@
+// Draw transforms of every draw against those of the draws left after culling.
+// 100000 draws; a fraction of them is visible, either scattered at random or
+// in runs of 64 draws (nearby objects of a scene are added together). The
+// culled version includes building the visible indices, as DrawManager does.
+// Times are in milliseconds, without a job system and with one thread per
+// hardware thread.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include <general/JobSystem.h>
+#include <general/Profiler.h>
+#include <rendering/TransformArray.h>
+
+using namespace BRE;
+using namespace DirectX;
+
+namespace {
+	const size_t sNumDraws = 100000U;
+	const size_t sRunLength = 64U;
+	const unsigned int sNumRounds = 20U;
+
+	template<typename Function>
+	double Milliseconds(const Function& function) {
+		function();
+		const std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+		for (unsigned int round = 0U; round < sNumRounds; ++round) {
+			function();
+		}
+		return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count() / sNumRounds;
+	}
+
+	std::vector<size_t> VisibleDraws(const double fraction, const bool runs, std::mt19937& generator) {
+		std::uniform_real_distribution<double> distribution(0.0, 1.0);
+		std::vector<size_t> visibleDraws;
+		if (runs) {
+			for (size_t first = 0U; first < sNumDraws; first += sRunLength) {
+				if (distribution(generator) < fraction) {
+					for (size_t draw = first; draw < (std::min)(first + sRunLength, sNumDraws); ++draw) {
+						visibleDraws.push_back(draw);
+					}
+				}
+			}
+		}
+		else {
+			for (size_t draw = 0U; draw < sNumDraws; ++draw) {
+				if (distribution(generator) < fraction) {
+					visibleDraws.push_back(draw);
+				}
+			}
+		}
+		return visibleDraws;
+	}
+}
+
+int main() {
+	// Benchmarks are built with profiling zones, which need a profiler
+	Profiler profiler;
+	Profiler::gInstance = &profiler;
+
+	std::mt19937 generator(1U);
+	std::uniform_real_distribution<float> distribution(-10.0f, 10.0f);
+	TransformArray transforms;
+	for (size_t i = 0U; i < sNumDraws; ++i) {
+		transforms.Add(XMMatrixTranslation(distribution(generator), distribution(generator), distribution(generator)));
+	}
+	const XMMATRIX view = XMMatrixTranslation(1.0f, 2.0f, 3.0f);
+	const XMMATRIX proj = XMMatrixPerspectiveFovLH(0.8f, 1.5f, 1.0f, 1000.0f);
+	const double fractions[] = { 1.0, 0.5, 0.25, 0.1, 0.01 };
+
+	std::printf("hardware threads: %u\n", std::thread::hardware_concurrency());
+	for (unsigned int numThreads = 0U; numThreads <= 1U; ++numThreads) {
+		if (numThreads > 0U) {
+			JobSystem::gInstance = new JobSystem();
+		}
+		std::printf("\n%s\n", numThreads > 0U ? "job system" : "no job system");
+		const double allTime = Milliseconds([&]() { transforms.ComputeDrawTransforms(view, proj); });
+		std::printf("all draws: %.3f ms\n", allTime);
+		std::printf("visible  scattered (ms)  runs of %zu (ms)\n", sRunLength);
+		for (const double fraction : fractions) {
+			double times[2];
+			for (size_t runs = 0U; runs < 2U; ++runs) {
+				const std::vector<size_t> visibleDraws = VisibleDraws(fraction, runs == 1U, generator);
+				std::vector<size_t> indices;
+				times[runs] = Milliseconds([&]() {
+					indices.clear();
+					for (const size_t draw : visibleDraws) {
+						indices.push_back(draw);
+					}
+					transforms.ComputeDrawTransforms(view, proj, indices);
+				});
+			}
+			std::printf("%6.0f%%  %14.3f  %15.3f\n", fraction * 100.0, times[0], times[1]);
+		}
+		delete JobSystem::gInstance;
+		JobSystem::gInstance = nullptr;
+	}
+	Profiler::gInstance = nullptr;
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,173 @@
+#pragma once
+
+#include <cmath>
+#include <emmintrin.h>
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Portable subset of DirectXMath used to build the tests where the
+// Windows SDK is not available (see BRE_DIRECTXMATH_INCLUDE_DIR).
+// Only the types and functions the tested components use are here,
+// with the same conventions: row vectors, row major matrices and
+// left handed projections.
+//
+//////////////////////////////////////////////////////////////////////////
+
+namespace DirectX {
+	typedef __m128 XMVECTOR;
+	typedef const XMVECTOR FXMVECTOR;
+
+	struct XMFLOAT2 {
+		XMFLOAT2() {}
+		XMFLOAT2(const float x_, const float y_) : x(x_), y(y_) {}
+		float x;
+		float y;
+	};
+
+	struct XMFLOAT3 {
+		XMFLOAT3() {}
+		XMFLOAT3(const float x_, const float y_, const float z_) : x(x_), y(y_), z(z_) {}
+		float x;
+		float y;
+		float z;
+	};
+
+	struct XMFLOAT4 {
+		XMFLOAT4() {}
+		XMFLOAT4(const float x_, const float y_, const float z_, const float w_) : x(x_), y(y_), z(z_), w(w_) {}
+		float x;
+		float y;
+		float z;
+		float w;
+	};
+
+	struct XMFLOAT4X4 {
+		union {
+			struct {
+				float _11, _12, _13, _14;
+				float _21, _22, _23, _24;
+				float _31, _32, _33, _34;
+				float _41, _42, _43, _44;
+			};
+			float m[4][4];
+		};
+	};
+
+	struct XMMATRIX {
+		XMMATRIX() {}
+		XMMATRIX(FXMVECTOR r0, FXMVECTOR r1, FXMVECTOR r2, FXMVECTOR r3) {
+			r[0] = r0;
+			r[1] = r1;
+			r[2] = r2;
+			r[3] = r3;
+		}
+		XMVECTOR r[4];
+	};
+
+	inline XMVECTOR XMVectorSet(const float x, const float y, const float z, const float w) { return _mm_setr_ps(x, y, z, w); }
+	inline XMVECTOR XMVectorReplicate(const float value) { return _mm_set1_ps(value); }
+	inline XMVECTOR XMVectorZero() { return _mm_setzero_ps(); }
+	inline XMVECTOR XMVectorTrueInt() { return _mm_castsi128_ps(_mm_set1_epi32(-1)); }
+
+	inline XMVECTOR XMVectorAdd(FXMVECTOR a, FXMVECTOR b) { return _mm_add_ps(a, b); }
+	inline XMVECTOR XMVectorSubtract(FXMVECTOR a, FXMVECTOR b) { return _mm_sub_ps(a, b); }
+	inline XMVECTOR XMVectorMultiply(FXMVECTOR a, FXMVECTOR b) { return _mm_mul_ps(a, b); }
+	inline XMVECTOR XMVectorMultiplyAdd(FXMVECTOR a, FXMVECTOR b, FXMVECTOR c) { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+	inline XMVECTOR XMVectorMax(FXMVECTOR a, FXMVECTOR b) { return _mm_max_ps(a, b); }
+	inline XMVECTOR XMVectorMin(FXMVECTOR a, FXMVECTOR b) { return _mm_min_ps(a, b); }
+
+	inline XMVECTOR XMVectorLessOrEqual(FXMVECTOR a, FXMVECTOR b) { return _mm_cmple_ps(a, b); }
+	inline XMVECTOR XMVectorGreaterOrEqual(FXMVECTOR a, FXMVECTOR b) { return _mm_cmpge_ps(a, b); }
+	inline XMVECTOR XMVectorGreater(FXMVECTOR a, FXMVECTOR b) { return _mm_cmpgt_ps(a, b); }
+	inline XMVECTOR XMVectorAndInt(FXMVECTOR a, FXMVECTOR b) { return _mm_and_ps(a, b); }
+	// Components of b where control is set, components of a elsewhere
+	inline XMVECTOR XMVectorSelect(FXMVECTOR a, FXMVECTOR b, FXMVECTOR control) { return _mm_or_ps(_mm_andnot_ps(control, a), _mm_and_ps(control, b)); }
+
+	inline XMVECTOR XMLoadFloat3(const XMFLOAT3* source) { return _mm_setr_ps(source->x, source->y, source->z, 0.0f); }
+	inline XMVECTOR XMLoadFloat4(const XMFLOAT4* source) { return _mm_loadu_ps(&source->x); }
+	inline void XMStoreFloat3(XMFLOAT3* destination, FXMVECTOR v) {
+		float f[4];
+		_mm_storeu_ps(f, v);
+		destination->x = f[0];
+		destination->y = f[1];
+		destination->z = f[2];
+	}
+	inline void XMStoreFloat4(XMFLOAT4* destination, FXMVECTOR v) { _mm_storeu_ps(&destination->x, v); }
+	inline void XMStoreInt4(unsigned int* destination, FXMVECTOR v) { _mm_storeu_si128(reinterpret_cast<__m128i*>(destination), _mm_castps_si128(v)); }
+
+	inline XMMATRIX XMLoadFloat4x4(const XMFLOAT4X4* source) {
+		return XMMATRIX(_mm_loadu_ps(source->m[0]), _mm_loadu_ps(source->m[1]), _mm_loadu_ps(source->m[2]), _mm_loadu_ps(source->m[3]));
+	}
+	inline void XMStoreFloat4x4(XMFLOAT4X4* destination, const XMMATRIX& m) {
+		for (int i = 0; i < 4; ++i) {
+			_mm_storeu_ps(destination->m[i], m.r[i]);
+		}
+	}
+
+	inline XMVECTOR XMVector4Transform(FXMVECTOR v, const XMMATRIX& m) {
+		const XMVECTOR x = _mm_shuffle_ps(v, v, 0x00);
+		const XMVECTOR y = _mm_shuffle_ps(v, v, 0x55);
+		const XMVECTOR z = _mm_shuffle_ps(v, v, 0xAA);
+		const XMVECTOR w = _mm_shuffle_ps(v, v, 0xFF);
+		return _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, m.r[0]), _mm_mul_ps(y, m.r[1])), _mm_add_ps(_mm_mul_ps(z, m.r[2]), _mm_mul_ps(w, m.r[3])));
+	}
+	// w is taken as 1
+	inline XMVECTOR XMVector3Transform(FXMVECTOR v, const XMMATRIX& m) {
+		const XMVECTOR x = _mm_shuffle_ps(v, v, 0x00);
+		const XMVECTOR y = _mm_shuffle_ps(v, v, 0x55);
+		const XMVECTOR z = _mm_shuffle_ps(v, v, 0xAA);
+		return _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, m.r[0]), _mm_mul_ps(y, m.r[1])), _mm_add_ps(_mm_mul_ps(z, m.r[2]), m.r[3]));
+	}
+	inline XMVECTOR XMPlaneNormalize(FXMVECTOR plane) {
+		float f[4];
+		_mm_storeu_ps(f, plane);
+		const float length = std::sqrt(f[0] * f[0] + f[1] * f[1] + f[2] * f[2]);
+		return _mm_mul_ps(plane, _mm_set1_ps(length > 0.0f ? 1.0f / length : 0.0f));
+	}
+
+	inline XMMATRIX XMMatrixIdentity() {
+		return XMMATRIX(_mm_setr_ps(1.0f, 0.0f, 0.0f, 0.0f), _mm_setr_ps(0.0f, 1.0f, 0.0f, 0.0f), _mm_setr_ps(0.0f, 0.0f, 1.0f, 0.0f), _mm_setr_ps(0.0f, 0.0f, 0.0f, 1.0f));
+	}
+	inline XMMATRIX XMMatrixMultiply(const XMMATRIX& a, const XMMATRIX& b) {
+		XMMATRIX result;
+		for (int i = 0; i < 4; ++i) {
+			result.r[i] = XMVector4Transform(a.r[i], b);
+		}
+		return result;
+	}
+	inline XMMATRIX operator*(const XMMATRIX& a, const XMMATRIX& b) { return XMMatrixMultiply(a, b); }
+	inline XMMATRIX& operator*=(XMMATRIX& a, const XMMATRIX& b) {
+		a = XMMatrixMultiply(a, b);
+		return a;
+	}
+	inline XMMATRIX XMMatrixTranspose(const XMMATRIX& m) {
+		XMMATRIX result = m;
+		_MM_TRANSPOSE4_PS(result.r[0], result.r[1], result.r[2], result.r[3]);
+		return result;
+	}
+	inline XMMATRIX XMMatrixScaling(const float x, const float y, const float z) {
+		return XMMATRIX(_mm_setr_ps(x, 0.0f, 0.0f, 0.0f), _mm_setr_ps(0.0f, y, 0.0f, 0.0f), _mm_setr_ps(0.0f, 0.0f, z, 0.0f), _mm_setr_ps(0.0f, 0.0f, 0.0f, 1.0f));
+	}
+	inline XMMATRIX XMMatrixTranslation(const float x, const float y, const float z) {
+		return XMMATRIX(_mm_setr_ps(1.0f, 0.0f, 0.0f, 0.0f), _mm_setr_ps(0.0f, 1.0f, 0.0f, 0.0f), _mm_setr_ps(0.0f, 0.0f, 1.0f, 0.0f), _mm_setr_ps(x, y, z, 1.0f));
+	}
+	inline XMMATRIX XMMatrixRotationQuaternion(FXMVECTOR quaternion) {
+		float q[4];
+		_mm_storeu_ps(q, quaternion);
+		const float x = q[0];
+		const float y = q[1];
+		const float z = q[2];
+		const float w = q[3];
+		return XMMATRIX(
+			_mm_setr_ps(1.0f - 2.0f * (y * y + z * z), 2.0f * (x * y + z * w), 2.0f * (x * z - y * w), 0.0f),
+			_mm_setr_ps(2.0f * (x * y - z * w), 1.0f - 2.0f * (x * x + z * z), 2.0f * (y * z + x * w), 0.0f),
+			_mm_setr_ps(2.0f * (x * z + y * w), 2.0f * (y * z - x * w), 1.0f - 2.0f * (x * x + y * y), 0.0f),
+			_mm_setr_ps(0.0f, 0.0f, 0.0f, 1.0f));
+	}
+	inline XMMATRIX XMMatrixPerspectiveFovLH(const float fovAngleY, const float aspectRatio, const float nearZ, const float farZ) {
+		const float height = 1.0f / std::tan(fovAngleY * 0.5f);
+		const float width = height / aspectRatio;
+		const float range = farZ / (farZ - nearZ);
+		return XMMATRIX(_mm_setr_ps(width, 0.0f, 0.0f, 0.0f), _mm_setr_ps(0.0f, height, 0.0f, 0.0f), _mm_setr_ps(0.0f, 0.0f, range, 1.0f), _mm_setr_ps(0.0f, 0.0f, -range * nearZ, 0.0f));
+	}
+}